@@ -28,6 +28,30 @@ void AdcClose(DevHandle handle);
 
 int32_t AdcRead(DevHandle handle, uint32_t channel, uint32_t *val);
 
+#define ADC_SCAN_CHANNEL_MAX 32
+
+/*
+ * Continuous scan: every 1/rateHz second the channels in chanMask are sampled into one frame,
+ * and the frames are kept in a ring of frameNum (a power of two) frames until they are read.
+ */
+struct AdcScanCfg {
+    uint32_t chanMask;    /* bit n for channel n */
+    uint32_t rateHz;      /* frames per second */
+    uint32_t frameNum;
+};
+
+int32_t AdcScanStart(DevHandle handle, const struct AdcScanCfg *cfg);
+
+/*
+ * Drain up to count frames without blocking. A frame is one value per channel of chanMask in channel order,
+ * vals must hold count frames and timestamps (in us, may be NULL) count entries.
+ * Returns the number of frames read on success, or a negative value on failure.
+ */
+int32_t AdcScanRead(DevHandle handle, uint32_t *vals, uint64_t *timestamps, uint32_t count);
+
+/* A scan started through a user space handle is also stopped when that handle is closed. */
+int32_t AdcScanStop(DevHandle handle);
+
 /**
  * @brief Enumerates ADC I/O commands.
  *
@@ -37,6 +61,9 @@ enum AdcIoCmd {
     ADC_IO_READ = 0,    /**< Read the A/D data. */
     ADC_IO_OPEN,        /**< Open the ADC device. */
     ADC_IO_CLOSE,       /**< Close the ADC device. */
+    ADC_IO_SCAN_START,  /**< Start continuous scan. */
+    ADC_IO_SCAN_READ,   /**< Read the scanned frames. */
+    ADC_IO_SCAN_STOP,   /**< Stop continuous scan. */
 };
 #ifdef __cplusplus
 #if __cplusplus
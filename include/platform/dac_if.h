@@ -78,6 +78,40 @@ void DacClose(DevHandle handle);
  */
 int32_t DacWrite(DevHandle handle, uint32_t channel, uint32_t val);
 
+/*
+ * Streaming: samples queued by DacStreamWrite are kept in a ring of sampleNum (a power of two) samples
+ * and output on channel at rateHz by the controller. Whenever the queued samples drop to lowWatermark,
+ * a waiter in DacStreamWait is woken to refill the ring.
+ */
+struct DacStreamCfg {
+    uint32_t channel;
+    uint32_t rateHz;        /* samples per second */
+    uint32_t sampleNum;
+    uint32_t lowWatermark;
+};
+
+struct DacStreamStatus {
+    uint32_t queued;        /* samples in the ring not output yet */
+    uint32_t underruns;     /* output slots missed because the ring was empty, counted from the first sample */
+    uint64_t played;        /* samples output since the stream started */
+};
+
+int32_t DacStreamStart(DevHandle handle, const struct DacStreamCfg *cfg);
+
+/*
+ * Queue up to count samples without blocking.
+ * Returns the number of samples queued on success, or a negative value on failure.
+ */
+int32_t DacStreamWrite(DevHandle handle, const uint32_t *vals, uint32_t count);
+
+/*
+ * Wait up to timeoutMs until the queued samples drop to the low watermark, then fill status (may be NULL).
+ * Returns HDF_ERR_TIMEOUT with status filled if the ring stayed above the watermark.
+ */
+int32_t DacStreamWait(DevHandle handle, uint32_t timeoutMs, struct DacStreamStatus *status);
+
+int32_t DacStreamStop(DevHandle handle);
+
 /**
  * @brief Enumerates DAC I/O commands.
  *
@@ -88,6 +122,10 @@ enum DacIoCmd {
     DAC_IO_OPEN,
     DAC_IO_CLOSE,
     DAC_IO_WRITE,
+    DAC_IO_STREAM_START,
+    DAC_IO_STREAM_WRITE,
+    DAC_IO_STREAM_WAIT,
+    DAC_IO_STREAM_STOP,
 };
 #ifdef __cplusplus
 #if __cplusplus
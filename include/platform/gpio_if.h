@@ -95,6 +95,21 @@ enum GpioIrqType {
  */
 typedef int32_t (*GpioIrqFunc)(uint16_t gpio, void *data);
 
+/**
+ * @brief Describes the interrupts a GPIO pin took before its threaded ISR ran.
+ *
+ * Interrupts that arrive while the ISR is queued or running are coalesced into the next event.
+ *
+ * @see GpioGetIrqEvent
+ * @since 1.0
+ */
+struct GpioIrqEvent {
+    uint16_t gpio;       /**< GPIO pin number */
+    uint32_t count;      /**< Interrupts coalesced into this event */
+    uint64_t firstUs;    /**< Monotonic time of the first of them, in microseconds */
+    uint64_t lastUs;     /**< Monotonic time of the latest of them, in microseconds */
+};
+
 /**
  * @brief Reads the level value of a GPIO pin.
  *
@@ -121,6 +136,37 @@ int32_t GpioRead(uint16_t gpio, uint16_t *val);
  */
 int32_t GpioWrite(uint16_t gpio, uint16_t val);
 
+/**
+ * @brief Reads the level values of several GPIO pins in one call.
+ *
+ * Adjacent pins of the same controller are read together, by a single controller hook if it supports.
+ * Before using this function, you need to call {@link GpioSetDir} to set the GPIO pins direction to input.
+ *
+ * @param gpios Indicates the array of the GPIO pin numbers.
+ * @param vals Indicates the array to receive the level values. For details, see {@link GpioValue}.
+ * @param count Indicates the number of the GPIO pins.
+ *
+ * @return Returns <b>0</b> if all the level values are successfully read; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t GpioReadMulti(const uint16_t *gpios, uint16_t *vals, uint16_t count);
+
+/**
+ * @brief Writes the level values for several GPIO pins in one call.
+ *
+ * The values are written in the order of the array, adjacent pins of the same controller are written together,
+ * by a single controller hook if it supports. It stops at the first failure, the pins before it are written.
+ * Before using this function, you need to call {@link GpioSetDir} to set the GPIO pins direction to output.
+ *
+ * @param gpios Indicates the array of the GPIO pin numbers.
+ * @param vals Indicates the array of the level values to be written. For details, see {@link GpioValue}.
+ * @param count Indicates the number of the GPIO pins.
+ *
+ * @return Returns <b>0</b> if all the level values are successfully written; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t GpioWriteMulti(const uint16_t *gpios, const uint16_t *vals, uint16_t count);
+
 /**
  * @brief Sets the input/output direction for a GPIO pin.
  *
@@ -204,6 +250,20 @@ int32_t GpioEnableIrq(uint16_t gpio);
  */
 int32_t GpioDisableIrq(uint16_t gpio);
 
+/**
+ * @brief Gets the interrupt event being handled by the threaded ISR of a GPIO pin.
+ *
+ * Call this function from an ISR set with {@link GPIO_IRQ_USING_THREAD} to learn how many interrupts the current
+ * run stands for and when they happened.
+ *
+ * @param gpio Indicates the GPIO pin number.
+ * @param event Indicates the pointer to the event to fill in.
+ *
+ * @return Returns <b>0</b> if the event is obtained; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t GpioGetIrqEvent(uint16_t gpio, struct GpioIrqEvent *event);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
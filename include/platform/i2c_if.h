@@ -136,6 +136,27 @@ void I2cClose(DevHandle handle);
  */
 int32_t I2cTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t count);
 
+#ifndef __USER__
+/**
+ * @brief Launches a custom transfer to an I2C device at the priority of the caller.
+ *
+ * Callers waiting for the same controller are served in the order of priority. While a caller of higher
+ * priority is waiting, the transfer is split after each message with <b>I2C_FLAG_STOP</b> and that caller
+ * uses the bus in between.
+ *
+ * @param handle Indicates the pointer to the device handle of the I2C controller obtained via {@link I2cOpen}.
+ * @param msgs Indicates the pointer to the I2C transfer message structure array.
+ * @param count Indicates the length of the message structure array.
+ * @param prio Indicates the priority of the caller, see {@link PlatformPriority}.
+ *
+ * @return Returns the number of transferred message structures if the operation is successful;
+ * returns a negative value otherwise.
+ * @see I2cTransfer
+ * @since 1.0
+ */
+int32_t I2cTransferPrio(DevHandle handle, struct I2cMsg *msgs, int16_t count, enum PlatformPriority prio);
+#endif
+
 /**
  * @brief Enumerates I2C I/O commands.
  *
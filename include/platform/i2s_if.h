@@ -175,6 +175,53 @@ struct I2sMsg {
     uint32_t *pRlen;
 };
 
+/**
+ * @brief Enumerates the directions of an I2S stream.
+ *
+ * @since 1.0
+ */
+enum I2sStreamDir {
+    I2S_STREAM_READ,     /**< Capture, the controller fills the ring */
+    I2S_STREAM_WRITE,    /**< Playback, the controller drains the ring */
+    I2S_STREAM_DIR_MAX,
+};
+
+/**
+ * @brief Called once per elapsed period with the number of periods elapsed since the stream started.
+ *
+ * It runs in the context that services the stream, which may be an interrupt, so it must not block.
+ *
+ * @since 1.0
+ */
+typedef void (*I2sPeriodNotify)(void *priv, uint64_t periods);
+
+/**
+ * @brief Defines the ring buffer of an I2S stream.
+ *
+ * The ring is made of <b>periodCount</b> periods of <b>periodSize</b> bytes each. Once set, the
+ * controller services it continuously between {@link I2sStartRead} and {@link I2sStopRead}
+ * (or the write pair), and the data is exchanged through {@link I2sStreamRead} and {@link I2sStreamWrite}.
+ *
+ * @since 1.0
+ */
+struct I2sStreamCfg {
+    uint32_t periodSize;      /**< Bytes per period, the unit of notification */
+    uint32_t periodCount;     /**< Periods in the ring, at least 2 */
+    I2sPeriodNotify notify;   /**< Optional period-elapsed notification */
+    void *priv;               /**< Passed back to <b>notify</b> */
+};
+
+/**
+ * @brief Defines the counters of an I2S stream.
+ *
+ * @since 1.0
+ */
+struct I2sStreamStat {
+    uint64_t periods;         /**< Periods elapsed since the stream started */
+    uint32_t xruns;           /**< Periods overwritten before being read, or played without new data */
+    uint32_t avail;           /**< Bytes that can be read or written right now */
+};
+
 
 /**
  * @brief Obtains the handle of an I2S controller.
@@ -211,6 +258,59 @@ void I2sStopRead(DevHandle handle);
 void I2sSetCfg(DevHandle handle, struct I2sCfg *cfg);
 void I2sGetCfg(DevHandle handle, struct I2sCfg *cfg);
 
+/**
+ * @brief Sets up or releases the ring buffer of an I2S stream.
+ *
+ * @param handle Indicates the pointer to the device handle of the I2S controller.
+ * @param dir Indicates the stream direction.
+ * @param cfg Indicates the ring layout, or <b>NULL</b> to return to per-call transfers.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * The ring cannot be changed while the stream is running.
+ * @since 1.0
+ */
+int32_t I2sSetStream(DevHandle handle, enum I2sStreamDir dir, const struct I2sStreamCfg *cfg);
+
+/**
+ * @brief Copies captured data out of the read ring without waiting.
+ *
+ * @param handle Indicates the pointer to the device handle of the I2S controller.
+ * @param buf Indicates the pointer to the buffer for receiving the data.
+ * @param len Indicates the size of the buffer.
+ * @param pRlen Returns the number of bytes copied, which is <b>0</b> if no period has elapsed yet.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I2sStreamRead(DevHandle handle, uint8_t *buf, uint32_t len, uint32_t *pRlen);
+
+/**
+ * @brief Queues data into the write ring without waiting.
+ *
+ * The ring may be prefilled before {@link I2sStartWrite}.
+ *
+ * @param handle Indicates the pointer to the device handle of the I2S controller.
+ * @param buf Indicates the pointer to the data to play.
+ * @param len Indicates the length of the data.
+ * @param pWlen Returns the number of bytes queued, which is less than <b>len</b> when the ring is full.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I2sStreamWrite(DevHandle handle, const uint8_t *buf, uint32_t len, uint32_t *pWlen);
+
+/**
+ * @brief Obtains the counters of an I2S stream.
+ *
+ * @param handle Indicates the pointer to the device handle of the I2S controller.
+ * @param dir Indicates the stream direction.
+ * @param stat Indicates the pointer to the counters to fill.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I2sGetStreamStat(DevHandle handle, enum I2sStreamDir dir, struct I2sStreamStat *stat);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
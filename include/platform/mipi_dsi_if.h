@@ -265,6 +265,23 @@ void MipiDsiSetHsMode(DevHandle handle);
  */
 int32_t MipiDsiTx(DevHandle handle, struct DsiCmdDesc *cmd);
 
+/**
+ * @brief Sends a sequence of DCS commands, such as the initialization sequence of a peripheral.
+ *
+ * Controllers that can burst commands get the whole sequence in one call and schedule the delays
+ * themselves. Otherwise the commands are sent one by one, and the delay of each is waited out
+ * without holding the device, so other users are not blocked during the sequence.
+ *
+ * @param handle Indicates the MIPI DSI device handle obtained via {@link MipiDsiOpen}.
+ * @param cmds Indicates the pointer to the commands to be sent in order.
+ * @param count Indicates the number of commands.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t MipiDsiTxList(DevHandle handle, struct DsiCmdDesc *cmds, uint32_t count);
+
 /**
 * @brief Receives a DCS command used for reading data, such as the status and parameters of a peripheral
  *
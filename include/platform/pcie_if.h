@@ -13,7 +13,8 @@
  * @brief Declares standard APIs of basic Peripheral Component Interconnect Express (PCIE) capabilities.
  *
  * You can use this module to access the PCIE and enable the driver to operate an PCIE device.
- * These capabilities include read and write the PCIE configuration Space.
+ * These capabilities include read and write the PCIE configuration Space, mapping the BARs of the
+ * device and bulk DMA transfers.
  *
  * @since 1.0
  */
@@ -37,6 +38,49 @@ extern "C" {
 #endif
 #endif /* __cplusplus */
 
+/**
+ * @brief Indicates the number of base address registers (BARs) of a PCIE device.
+ *
+ * @since 1.0
+ */
+#define PCIE_BAR_NUM 6
+
+/**
+ * @brief Enumerates the directions of a PCIE DMA transfer.
+ *
+ * @since 1.0
+ */
+enum PcieDmaDir {
+    PCIE_DMA_FROM_DEVICE = 0, /**< Copies device memory into the host buffer */
+    PCIE_DMA_TO_DEVICE,       /**< Copies the host buffer into device memory */
+};
+
+/**
+ * @brief Called when an asynchronous PCIE DMA transfer ends.
+ *
+ * @param priv Indicates the <b>priv</b> of the transfer.
+ * @param status Indicates the result of the transfer, <b>0</b> on success.
+ *
+ * @attention This function may be called in interrupt context.
+ *
+ * @since 1.0
+ */
+typedef void (*PcieDmaCallback)(void *priv, int32_t status);
+
+/**
+ * @brief Describes a PCIE DMA transfer.
+ *
+ * @since 1.0
+ */
+struct PcieDmaXfer {
+    uint8_t dir;          /**< Transfer direction, see {@link PcieDmaDir} */
+    uint64_t devAddr;     /**< Address on the device side */
+    uint8_t *buf;         /**< Host buffer */
+    uint32_t len;         /**< Length of the transfer in bytes */
+    PcieDmaCallback cb;   /**< Completion callback, <b>NULL</b> to wait for the transfer to end */
+    void *priv;           /**< Private data passed to <b>cb</b> */
+};
+
 /**
  * @brief Opens an PCIE controller with a specified bus number.
  *
@@ -80,6 +124,53 @@ int32_t PcieRead(DevHandle handle, uint32_t pos, uint8_t *data, uint32_t len);
  */
 int32_t PcieWrite(DevHandle handle, uint32_t pos, uint8_t *data, uint32_t len);
 
+/**
+ * @brief Maps a base address register (BAR) region of the PCIE device.
+ *
+ * The region is mapped once and shared by all the users of the controller, the registers are then
+ * accessed through {@link OSAL_READL}/{@link OSAL_WRITEL} on the returned address without taking
+ * the controller lock. This function is used in pair with {@link PcieUnmapBar}.
+ *
+ * @param handle Indicates the pointer to the device handle of the PCIE controller obtained by {@link PcieOpen}.
+ * @param bar Indicates the index of the BAR, smaller than {@link PCIE_BAR_NUM}.
+ * @param addr Indicates the pointer to the mapped address.
+ * @param size Indicates the pointer to the size of the region in bytes.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value if the operation fails.
+ * @attention Not supported in user space.
+ *
+ * @since 1.0
+ */
+int32_t PcieMapBar(DevHandle handle, uint32_t bar, volatile uint8_t **addr, uint32_t *size);
+
+/**
+ * @brief Releases a BAR region mapped by {@link PcieMapBar}.
+ *
+ * @param handle Indicates the pointer to the device handle of the PCIE controller obtained by {@link PcieOpen}.
+ * @param bar Indicates the index of the BAR.
+ *
+ * @since 1.0
+ */
+void PcieUnmapBar(DevHandle handle, uint32_t bar);
+
+/**
+ * @brief Starts a bulk DMA transfer between the host and the PCIE device.
+ *
+ * If <b>cb</b> of the transfer is set, this function returns once the transfer is started and <b>cb</b>
+ * is called when it ends; the transfer and its buffer must stay valid until then. Otherwise this function
+ * waits for the transfer to end.
+ *
+ * @param handle Indicates the pointer to the device handle of the PCIE controller obtained by {@link PcieOpen}.
+ * @param xfer Indicates the pointer to the transfer.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns {@link HDF_ERR_DEVICE_BUSY} if another
+ * transfer is in flight; returns a negative value in other failure cases.
+ * @attention Only waiting transfers are supported in user space.
+ *
+ * @since 1.0
+ */
+int32_t PcieDmaTransfer(DevHandle handle, struct PcieDmaXfer *xfer);
+
 /**
  * @brief Closes an PCIE controller.
  *
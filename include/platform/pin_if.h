@@ -35,6 +35,30 @@ enum PinPullType {
     PIN_PULL_UP =  1,       /**< SET PIN RESISTANCE UP. */
     PIN_PULL_DOWN = 2,      /**< SET PIN RESISTANCE DOWN. */
 };
+
+/**
+ * @brief Enumerates the settings carried by a {@link PinCfg}.
+ *
+ * @since 1.0
+ */
+enum PinCfgMask {
+    PIN_CFG_PULL = 0x1,         /**< Apply the pullType. */
+    PIN_CFG_STRENGTH = 0x2,     /**< Apply the strength. */
+    PIN_CFG_FUNC = 0x4,         /**< Apply the funcName. */
+};
+
+/**
+ * @brief Describes the configuration of one pin for {@link PinSetCfgBatch}.
+ *
+ * @since 1.0
+ */
+struct PinCfg {
+    DevHandle handle;              /**< Pin handle obtained through {@link PinGet} */
+    uint32_t mask;                 /**< Settings to apply, see {@link PinCfgMask} */
+    enum PinPullType pullType;
+    uint32_t strength;
+    const char *funcName;
+};
 /**
  * @brief Obtains the handle of a pin.
  *
@@ -139,6 +163,22 @@ int32_t PinSetFunc(DevHandle handle, const char *funcName);
  */
 int32_t PinGetFunc(DevHandle handle, const char **funcName);
 
+/**
+ * @brief Apply the configurations of a list of pins.
+ *
+ * Consecutive entries whose pins belong to the same controller are applied under one
+ * acquisition of the controller lock. For every pin the function is set first, then
+ * the pull type and the strength.
+ *
+ * @param cfgs Indicates the pointer to the pin configurations.
+ * @param count Indicates the number of configurations.
+ * @return Returns <b>0</b> if all configurations are applied successfully;
+ * returns a negative value otherwise.
+ * @attention The batch stops at the first failure, the configurations before it stay applied.
+ * @since 1.0
+ */
+int32_t PinSetCfgBatch(const struct PinCfg *cfgs, uint32_t count);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
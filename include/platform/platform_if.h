@@ -46,6 +46,21 @@ extern "C" {
  */
 typedef void* DevHandle;
 
+/**
+ * @brief Enumerates the priorities of the callers sharing a bus controller.
+ *
+ * When several callers wait for the same controller, the one with the highest priority is served first.
+ *
+ * @since 1.0
+ */
+enum PlatformPriority {
+    PLATFORM_PRIORITY_BULK = 0,    /**< Background traffic, served only when nothing else waits */
+    PLATFORM_PRIORITY_NORMAL,      /**< Default priority of the plain transfer APIs */
+    PLATFORM_PRIORITY_HIGH,        /**< Latency sensitive traffic */
+    PLATFORM_PRIORITY_RT,          /**< Real-time traffic, such as sensor sampling */
+    PLATFORM_PRIORITY_NUM,         /**< Number of priorities, not a valid priority */
+};
+
 #ifdef __cplusplus
 #if __cplusplus
 }
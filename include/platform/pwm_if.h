@@ -78,8 +78,17 @@ enum PwmIoCmd {
     PWM_IO_PUT,             /**< Put the PWM device. */
     PWM_IO_SET_CONFIG,      /**< Set config. */
     PWM_IO_GET_CONFIG,      /**< Get config. */
+    PWM_IO_SET_CONFIG_GROUP, /**< Set the config of several devices at once. */
+    PWM_IO_JOIN_GROUP,       /**< Let the opener of another device put this one into its groups. */
 };
 
+/**
+ * @brief Indicates the maximum number of PWM devices in one {@link PwmSetConfigGroup} call.
+ *
+ * @since 1.0
+ */
+#define PWM_GROUP_MAX 16
+
 /**
  * @brief Defines the PWM device configuration parameters.
  *
@@ -106,6 +115,16 @@ struct PwmConfig {
                        */
 };
 
+/**
+ * @brief Describes one device of a PWM configuration group.
+ *
+ * @since 1.0
+ */
+struct PwmGroupItem {
+    DevHandle handle;        /**< PWM device handle obtained via {@link PwmOpen} */
+    struct PwmConfig config; /**< Configuration to apply to this device */
+};
+
 /**
  * @brief Obtains the PWM device handle.
  *
@@ -211,6 +230,22 @@ int32_t PwmSetConfig(DevHandle handle, struct PwmConfig *config);
  */
 int32_t PwmGetConfig(DevHandle handle, struct PwmConfig *config);
 
+/**
+ * @brief Sets the configuration parameters of several PWM devices in one transaction.
+ *
+ * Where the controller latches its channels through shadow registers, all new configurations take effect on the
+ * same period boundary. Otherwise they are applied back to back, and the devices already changed are restored if
+ * one of them fails.
+ *
+ * @param items Indicates the pointer to the {@link PwmGroupItem} array, each device may appear only once.
+ * @param count Indicates the number of items, at most {@link PWM_GROUP_MAX}.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t PwmSetConfigGroup(const struct PwmGroupItem *items, uint32_t count);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
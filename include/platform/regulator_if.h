@@ -29,6 +29,27 @@ enum RegulatorChangeMode {
     REGULATOR_CHANGE_VOLTAGE = 1,
     REGULATOR_CHANGE_CURRENT,
 };
+
+/* operations that can be batched by {@link RegulatorBatchApply} */
+enum RegulatorBatchOp {
+    REGULATOR_BATCH_ENABLE = 1,
+    REGULATOR_BATCH_DISABLE,
+    REGULATOR_BATCH_SET_VOLTAGE,
+    REGULATOR_BATCH_SET_CURRENT,
+};
+
+/**
+ * @brief Describes one step of a regulator batch.
+ *
+ * @since 1.0
+ */
+struct RegulatorBatchStep {
+    DevHandle handle;    /**< Regulator handle obtained through {@link RegulatorOpen} */
+    uint8_t op;          /**< Operation, see {@link RegulatorBatchOp} */
+    uint32_t min;        /**< Minimum voltage (uV) or current (uA), only for the set operations */
+    uint32_t max;        /**< Maximum voltage (uV) or current (uA), only for the set operations */
+    int32_t ret;         /**< Result of this step, filled in by {@link RegulatorBatchApply} */
+};
 /**
  * @brief Gets a regulator.
  *
@@ -141,6 +162,22 @@ int32_t RegulatorGetCurrent(DevHandle handle, uint32_t *regCurrent);
  * @since 1.0
  */
 int32_t RegulatorGetStatus(DevHandle handle, uint32_t *status);
+/**
+ * @brief Apply a set of regulator changes as one batch.
+ *
+ * The steps are applied in supply order rather than array order: disables go first from the leaves up,
+ * then voltage and current changes and last the enables, both from the roots down. The whole batch
+ * runs under a single acquisition of the regulator tree lock.
+ *
+ * @param steps Indicates the steps to apply, the <b>ret</b> of every step is filled in.
+ * @param count Indicates the number of steps.
+ * @return <b>0</b> If all steps succeed; Otherwise, a negative value is returned.
+ *
+ * @attention The batch stops at the first failed step; steps not applied keep a <b>ret</b> of HDF_FAILURE.
+ *
+ * @since 1.0
+ */
+int32_t RegulatorBatchApply(struct RegulatorBatchStep *steps, uint32_t count);
 #ifdef __cplusplus
 #if __cplusplus
 }
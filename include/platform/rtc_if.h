@@ -93,6 +93,42 @@ enum RtcIoCmd {
     RTC_IO_RESET,                           /**< Reset the RTC device. */
     RTC_IO_READREG,                         /**< Reads the configuration of a custom RTC register. */
     RTC_IO_WRITEREG,                        /**< Writes the configuration of a custom RTC register. */
+    RTC_IO_READTIME_SYNC,                   /**< Read time together with the monotonic time it belongs to. */
+    RTC_IO_WRITEALARM_GROUP,                /**< Program a group of alarms in one call. */
+};
+
+/**
+ * @brief Indicates the maximum number of alarms in one call of {@link RtcWriteAlarmGroup}.
+ *
+ * @since 1.0
+ */
+#define RTC_ALARM_GROUP_MAX 8
+
+/**
+ * @brief Defines an RTC time correlated with the monotonic clock.
+ *
+ * <b>monoUs</b> is the time on the monotonic clock of the kernel, which is <b>CLOCK_MONOTONIC</b> in user space,
+ * at which the RTC showed <b>time</b>.
+ * The correlation is exact up to <b>errorUs</b> in either direction, on top of the resolution of the RTC itself.
+ *
+ * @since 1.0
+ */
+struct RtcTimeSync {
+    struct RtcTime time;  /**< Wall time read from the RTC */
+    uint64_t monoUs;      /**< Monotonic time in microseconds that <b>time</b> corresponds to */
+    uint32_t errorUs;     /**< Maximum error of <b>monoUs</b> in microseconds */
+};
+
+/**
+ * @brief Describes one alarm of an alarm group.
+ *
+ * @since 1.0
+ */
+struct RtcAlarmItem {
+    enum RtcAlarmIndex alarmIndex;  /**< Alarm index. For details, see {@link RtcAlarmIndex} */
+    struct RtcTime time;            /**< Alarm time */
+    uint8_t enable;                 /**< <b>1</b> to enable the alarm interrupt after writing, <b>0</b> to disable it */
+    int32_t ret;                    /**< Result of this alarm, filled in by {@link RtcWriteAlarmGroup} */
 };
 
 /**
@@ -275,6 +311,39 @@ int32_t RtcReadReg(DevHandle handle, uint8_t usrDefIndex, uint8_t *value);
  */
 int32_t RtcWriteReg(DevHandle handle, uint8_t usrDefIndex, uint8_t value);
 
+/**
+ * @brief Reads time from the RTC driver together with the monotonic time it corresponds to.
+ *
+ * The wall time and the monotonic timestamp are taken in a single call, so the result can be used to
+ * measure the offset between the two clocks without the latency of a separate call in between.
+ *
+ * @param handle Indicates the pointer to the RTC device handle, which is obtained via {@link RtcGetHandle}.
+ * @param sync Indicates the pointer to the correlated time. For details, see {@link RtcTimeSync}.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value if the operation fails.
+ * For details, see {@link HDF_STATUS}.
+ * @since 1.0
+ */
+int32_t RtcReadTimeSync(DevHandle handle, struct RtcTimeSync *sync);
+
+/**
+ * @brief Programs a group of alarms in one call.
+ *
+ * Every alarm is written and has its interrupt enabled or disabled according to its <b>enable</b>.
+ * All times are checked before any alarm is touched, and no other group is programmed in between.
+ *
+ * @param handle Indicates the pointer to the RTC device handle, which is obtained via {@link RtcGetHandle}.
+ * @param items Indicates the alarms to program, the <b>ret</b> of every item is filled in.
+ * @param count Indicates the number of alarms, at most {@link RTC_ALARM_GROUP_MAX}.
+ *
+ * @return Returns <b>0</b> if all alarms are programmed; returns a negative value if the operation fails.
+ * For details, see {@link HDF_STATUS}.
+ * @attention The group stops at the first failed alarm; alarms not programmed keep a <b>ret</b> of
+ * <b>HDF_FAILURE</b>.
+ * @since 1.0
+ */
+int32_t RtcWriteAlarmGroup(DevHandle handle, struct RtcAlarmItem *items, uint32_t count);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
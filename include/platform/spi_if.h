@@ -142,6 +142,33 @@ struct SpiMsg {
                           */
 };
 
+/**
+ * @brief Defines one segment of a scatter-gather SPI message.
+ *
+ * @since 1.0
+ */
+struct SpiSgSeg {
+    uint8_t *wbuf;       /**< Address of the write buffer of this segment, may be NULL */
+    uint8_t *rbuf;       /**< Address of the read buffer of this segment, may be NULL */
+    uint32_t len;        /**< Length of the read and write buffers of this segment */
+};
+
+/**
+ * @brief Defines a scatter-gather SPI message.
+ *
+ * All the segments of a message are transferred back to back with the CS kept active, so a large frame
+ * can be sent from several separate buffers without copying it into one bounce buffer first.
+ *
+ * @since 1.0
+ */
+struct SpiSgMsg {
+    struct SpiSgSeg *segs;    /**< Array of the segments of this message */
+    uint32_t segNum;          /**< Number of the segments */
+    uint32_t speed;           /**< Current message transfer speed */
+    uint16_t delayUs;         /**< Delay (in microseconds) after the last segment, see {@link SpiMsg} */
+    uint8_t csChange;         /**< Whether to switch off the CS after the last segment, see {@link SpiMsg} */
+};
+
 /**
  * @brief Defines the configuration of an SPI device.
  *
@@ -200,6 +227,19 @@ void SpiClose(DevHandle handle);
  */
 int32_t SpiTransfer(DevHandle handle, struct SpiMsg *msgs, uint32_t count);
 
+/**
+ * @brief Launches a scatter-gather transfer to an SPI device.
+ *
+ * @param handle Indicates the pointer to the SPI device handle obtained via {@link SpiOpen}.
+ * @param msgs Indicates the pointer to the scatter-gather messages to transfer.
+ * @param count Indicates the length of the message structure array.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * @see SpiSgMsg
+ * @since 1.0
+ */
+int32_t SpiTransferSg(DevHandle handle, struct SpiSgMsg *msgs, uint32_t count);
+
 /**
  * @brief Reads data of a specified length from an SPI device.
  *
@@ -250,6 +290,59 @@ int32_t SpiSetCfg(DevHandle handle, struct SpiCfg *cfg);
  */
 int32_t SpiGetCfg(DevHandle handle, struct SpiCfg *cfg);
 
+#ifndef __USER__
+/**
+ * @brief Called when an asynchronous SPI transfer completes.
+ *
+ * The callback runs in the transfer queue thread of the SPI controller and must not block for long.
+ *
+ * @param msgs Indicates the messages passed to {@link SpiTransferAsync}.
+ * @param count Indicates the number of the messages.
+ * @param result Indicates the result of the transfer, <b>0</b> on success and a negative value otherwise.
+ * @param priv Indicates the private data passed to {@link SpiTransferAsync}.
+ *
+ * @since 1.0
+ */
+typedef void (*SpiTransferCallback)(struct SpiSgMsg *msgs, uint32_t count, int32_t result, void *priv);
+
+/**
+ * @brief Queues a scatter-gather transfer to an SPI device and returns without waiting for it.
+ *
+ * Transfers of one controller are executed in submission order. The messages and their buffers must stay valid
+ * until the callback is called, and the handle must not be closed before then.
+ *
+ * @param handle Indicates the pointer to the SPI device handle obtained via {@link SpiOpen}.
+ * @param msgs Indicates the pointer to the scatter-gather messages to transfer.
+ * @param count Indicates the length of the message structure array.
+ * @param callback Indicates the completion callback, may be NULL.
+ * @param priv Indicates the private data passed to the callback.
+ *
+ * @return Returns <b>0</b> if the transfer is queued; returns a negative value otherwise, in which case
+ * the callback is not called.
+ * @since 1.0
+ */
+int32_t SpiTransferAsync(DevHandle handle, struct SpiSgMsg *msgs, uint32_t count,
+    SpiTransferCallback callback, void *priv);
+
+/**
+ * @brief Launches a custom transfer to an SPI device at the priority of the caller.
+ *
+ * Callers waiting for the same controller are served in the order of priority. While a caller of higher
+ * priority is waiting, the transfer is split after each message with <b>csChange</b> set and that caller uses
+ * the bus in between.
+ *
+ * @param handle Indicates the pointer to the SPI device handle obtained via {@link SpiOpen}.
+ * @param msgs Indicates the pointer to the data to transfer.
+ * @param count Indicates the length of the message structure array.
+ * @param prio Indicates the priority of the caller, see {@link PlatformPriority}.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ * @see SpiTransfer
+ * @since 1.0
+ */
+int32_t SpiTransferPrio(DevHandle handle, struct SpiMsg *msgs, uint32_t count, enum PlatformPriority prio);
+#endif
+
 /**
  * @brief Enumerates SPI I/O commands.
  *
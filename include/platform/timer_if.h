@@ -65,6 +65,8 @@ int32_t HwTimerStop(DevHandle handle);
  * @param useconds Represents the timer interval.
  * @param cb Represents the timer callback function.
  * @return success or fail
+ * @attention In user space the callback runs on a dispatcher thread fed by the timer interrupt. A callback
+ * that falls behind is called once for all expirations since its previous call.
  * @since 1.0
  */
 int32_t HwTimerSet(DevHandle handle, uint32_t useconds, TimerHandleCb cb);
@@ -103,6 +105,7 @@ enum TimerIoCmd {
     TIMER_IO_SET,          /**< Set the period TIMER info. */
     TIMER_IO_SETONCE,      /**< Set the once TIMER info. */
     TIMER_IO_GET,          /**< Get the TIMER info. */
+    TIMER_IO_WAIT,         /**< Wait for the TIMER expirations. */
 };
 
 struct TimerConfig {
@@ -111,6 +114,11 @@ struct TimerConfig {
     bool isPeriod;
 };
 
+struct TimerEvent {
+    uint32_t count;          /**< Expirations coalesced into this event */
+    uint64_t timestampUs;    /**< Time of the latest of them, on a monotonic clock */
+};
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -241,6 +241,22 @@ enum UartTransMode {
     UART_MODE_DMA_TX_DIS,    /**< DMA disabled for data transmitting */
 };
 
+/**
+ * @brief Defines the statistics of the receive ring of a UART device.
+ *
+ * The average number of bytes a reader gets per wakeup is <b>wakeupBytes / wakeups</b>.
+ *
+ * @since 1.0
+ */
+struct UartRxStat {
+    uint32_t ringSize;       /**< Size of the receive ring, <b>0</b> if the device does not use one */
+    uint32_t pushes;         /**< Number of times data was filled in from the interrupt or DMA side */
+    uint32_t rxBytes;        /**< Number of bytes put into the ring */
+    uint32_t overruns;       /**< Number of bytes dropped because the ring was full */
+    uint32_t wakeups;        /**< Number of times a blocked reader was woken up */
+    uint32_t wakeupBytes;    /**< Number of bytes found in the ring by the woken up readers */
+};
+
 /**
  * @brief Enumerates UART I/O commands.
  *
@@ -256,6 +272,7 @@ enum UartIoCmd {
     UART_IO_GET_ATTRIBUTE,   /**< Obtain the device attributes. */
     UART_IO_SET_ATTRIBUTE,   /**< Set the device attributes. */
     UART_IO_SET_TRANSMODE,   /**< Set the transmission mode. */
+    UART_IO_GET_RX_STAT,     /**< Obtain the receive ring statistics. */
 };
 
 /**
@@ -364,6 +381,17 @@ int32_t UartSetAttribute(DevHandle handle, struct UartAttribute *attribute);
  */
 int32_t UartSetTransMode(DevHandle handle, enum UartTransMode mode);
 
+/**
+ * @brief Obtains the statistics of the receive ring of the UART device.
+ *
+ * @param handle Indicates the pointer to the UART device handle, which is obtained via {@link UartOpen}.
+ * @param stat Indicates the pointer to the obtained statistics.
+ *
+ * @return Returns <b>0</b> if the statistics are obtained; returns a negative number otherwise.
+ * @since 1.0
+ */
+int32_t UartGetRxStat(DevHandle handle, struct UartRxStat *stat);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
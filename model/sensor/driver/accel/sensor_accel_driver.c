@@ -18,8 +18,6 @@
 
 #define HDF_LOG_TAG    hdf_sensor_accel_driver
 
-#define HDF_ACCEL_WORK_QUEUE_NAME    "hdf_accel_work_queue"
-
 static struct AccelDrvData *g_accelDrvData = NULL;
 
 static struct AccelDrvData *AccelGetDrvData(void)
@@ -89,7 +87,7 @@ static void AccelTimerEntry(uintptr_t arg)
     struct AccelDrvData *drvData = (struct AccelDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->accelWorkQueue, &drvData->accelWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->accelWork)) {
         HDF_LOGE("%s: Accel add work queue failed", __func__);
     }
 
@@ -103,12 +101,14 @@ static void AccelTimerEntry(uintptr_t arg)
 
 static int32_t InitAccelData(struct AccelDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->accelWorkQueue, HDF_ACCEL_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: Accel init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: Accel get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->accelWork, AccelDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->accelWork, AccelDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: Accel create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -387,8 +387,7 @@ void AccelReleaseDriver(struct HdfDeviceObject *device)
     OsalMemFree(drvData->accelCfg);
     drvData->accelCfg = NULL;
 
-    HdfWorkDestroy(&drvData->accelWork);
-    HdfWorkQueueDestroy(&drvData->accelWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->accelWork);
     OsalMemFree(drvData);
 }
 
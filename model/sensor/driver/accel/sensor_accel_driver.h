@@ -9,7 +9,7 @@
 #ifndef SENSOR_ACCEL_DRIVER_H
 #define SENSOR_ACCEL_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_mutex.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
@@ -48,8 +48,8 @@ struct AccelOpsCall {
 struct AccelDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue accelWorkQueue;
-    HdfWork accelWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork accelWork;
     OsalTimer accelTimer;
     bool detectFlag;
     bool enable;
@@ -19,8 +19,6 @@
 
 #define HDF_LOG_TAG    hdf_sensor_gravity_driver
 
-#define HDF_GRAVITY_WORK_QUEUE_NAME    "hdf_gravity_work_queue"
-
 static struct GravityDrvData *g_gravityDrvData = NULL;
 static int32_t g_accelRawData[GRAVITY_AXIS_NUM];
 
@@ -83,7 +81,7 @@ static void GravityTimerEntry(uintptr_t arg)
     struct GravityDrvData *drvData = (struct GravityDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->gravityWorkQueue, &drvData->gravityWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->gravityWork)) {
         HDF_LOGE("%s: Gravity add work queue failed", __func__);
     }
 
@@ -95,12 +93,14 @@ static void GravityTimerEntry(uintptr_t arg)
 
 static int32_t InitGravityData(struct GravityDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->gravityWorkQueue, HDF_GRAVITY_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: Gravity init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: Gravity get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->gravityWork, GravityDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->gravityWork, GravityDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: Gravity create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -319,8 +319,7 @@ void GravityReleaseDriver(struct HdfDeviceObject *device)
         drvData->gravityCfg = NULL;
     }
 
-    HdfWorkDestroy(&drvData->gravityWork);
-    HdfWorkQueueDestroy(&drvData->gravityWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->gravityWork);
     OsalMemFree(drvData);
 }
 
@@ -9,7 +9,7 @@
 #ifndef SENSOR_GRAVITY_DRIVER_H
 #define SENSOR_GRAVITY_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
 #include "sensor_platform_if.h"
@@ -34,8 +34,8 @@ struct GravityData {
 struct GravityDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue gravityWorkQueue;
-    HdfWork gravityWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork gravityWork;
     OsalTimer gravityTimer;
     struct SensorCfgData *gravityCfg;
     int64_t interval;
@@ -17,8 +17,6 @@
 
 #define HDF_LOG_TAG    hdf_sensor_als_driver
 
-#define HDF_ALS_WORK_QUEUE_NAME    "hdf_als_work_queue"
-
 static struct AlsDrvData *g_alsDrvData = NULL;
 
 static struct AlsDrvData *AlsGetDrvData(void)
@@ -190,7 +188,7 @@ static void AlsTimerEntry(uintptr_t arg)
     struct AlsDrvData *drvData = (struct AlsDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->alsWorkQueue, &drvData->alsWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->alsWork)) {
         HDF_LOGE("%s: Als add work queue failed", __func__);
     }
 
@@ -204,12 +202,14 @@ static void AlsTimerEntry(uintptr_t arg)
 
 static int32_t InitAlsData(struct AlsDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->alsWorkQueue, HDF_ALS_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: Als init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: Als get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->alsWork, AlsDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->alsWork, AlsDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: Als create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -492,8 +492,7 @@ void AlsReleaseDriver(struct HdfDeviceObject *device)
     OsalMemFree(drvData->alsCfg);
     drvData->alsCfg = NULL;
 
-    HdfWorkDestroy(&drvData->alsWork);
-    HdfWorkQueueDestroy(&drvData->alsWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->alsWork);
     OsalMemFree(drvData);
 }
 
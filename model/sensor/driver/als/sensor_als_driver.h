@@ -9,7 +9,7 @@
 #ifndef SENSOR_ALS_DRIVER_H
 #define SENSOR_ALS_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
 #include "sensor_platform_if.h"
@@ -75,8 +75,8 @@ struct AlsOpsCall {
 struct AlsDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue alsWorkQueue;
-    HdfWork alsWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork alsWork;
     OsalTimer alsTimer;
     bool detectFlag;
     bool enable;
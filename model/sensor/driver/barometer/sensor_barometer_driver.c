@@ -18,8 +18,6 @@
 
 #define HDF_LOG_TAG    hdf_sensor_barometer_driver
 
-#define HDF_BAROMETER_WORK_QUEUE_NAME    "hdf_barometer_work_queue"
-
 static struct BarometerDrvData *g_barometerDrvData = NULL;
 
 static struct BarometerDrvData *BarometerGetDrvData(void)
@@ -64,7 +62,7 @@ static void BarometerTimerEntry(uintptr_t arg)
     struct BarometerDrvData *drvData = (struct BarometerDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->barometerWorkQueue, &drvData->barometerWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->barometerWork)) {
         HDF_LOGE("%s: barometer add work queue failed", __func__);
     }
 
@@ -78,12 +76,14 @@ static void BarometerTimerEntry(uintptr_t arg)
 
 static int32_t InitBarometerData(struct BarometerDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->barometerWorkQueue, HDF_BAROMETER_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: barometer init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: barometer get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->barometerWork, BarometerDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->barometerWork, BarometerDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: barometer create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -354,8 +354,7 @@ void BarometerReleaseDriver(struct HdfDeviceObject *device)
     OsalMemFree(drvData->barometerCfg);
     drvData->barometerCfg = NULL;
 
-    HdfWorkDestroy(&drvData->barometerWork);
-    HdfWorkQueueDestroy(&drvData->barometerWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->barometerWork);
     OsalMemFree(drvData);
 }
 
@@ -9,7 +9,7 @@
 #ifndef SENSOR_BAROMETER_DRIVER_H
 #define SENSOR_BAROMETER_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
 #include "sensor_platform_if.h"
@@ -102,8 +102,8 @@ struct BarometerOpsCall {
 struct BarometerDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue barometerWorkQueue;
-    HdfWork barometerWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork barometerWork;
     OsalTimer barometerTimer;
     bool detectFlag;
     bool enable;
@@ -11,12 +11,16 @@
 
 #include "hdf_base.h"
 #include "hdf_device_desc.h"
+#include "hdf_work_pool.h"
 #include "hdf_workqueue.h"
 #include "osal_mutex.h"
 #include "sensor_device_type.h"
 #include "sensor_device_if.h"
 
 #define HDF_SENSOR_EVENT_QUEUE_NAME    "hdf_sensor_event_queue"
+#define HDF_SENSOR_WORK_POOL_NAME      "hdf_sensor_pool"
+#define HDF_SENSOR_REALTIME_WORKER_NUM 2
+#define HDF_SENSOR_BACKGROUND_WORKER_NUM 1
 
 enum SensorCmd {
     SENSOR_CMD_GET_INFO_LIST = 0,
@@ -50,6 +54,9 @@ struct SensorDevMgrData {
     struct DListHead sensorDevInfoHead;
     struct OsalMutex mutex;
     struct OsalMutex eventMutex;
+    struct HdfWorkPool workPool;
 };
 
+struct HdfWorkPool *GetSensorWorkPool(void);
+
 #endif /* SENSOR_DEVICE_MANAGER_H */
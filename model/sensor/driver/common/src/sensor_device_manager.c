@@ -19,11 +19,28 @@
 
 struct SensorDevMgrData *g_sensorDeviceManager = NULL;
 
+/* timer driven sensors share the realtime workers, so one slow bus read does not stall the others */
+static const struct HdfWorkPoolConfig g_sensorWorkPoolConfig = {
+    .name = HDF_SENSOR_WORK_POOL_NAME,
+    .classes = {
+        [HDF_WORK_CLASS_REALTIME] = { .workerNum = HDF_SENSOR_REALTIME_WORKER_NUM },
+        [HDF_WORK_CLASS_BACKGROUND] = { .workerNum = HDF_SENSOR_BACKGROUND_WORKER_NUM },
+    },
+};
+
 static struct SensorDevMgrData *GetSensorDeviceManager(void)
 {
     return g_sensorDeviceManager;
 }
 
+struct HdfWorkPool *GetSensorWorkPool(void)
+{
+    struct SensorDevMgrData *manager = GetSensorDeviceManager();
+
+    CHECK_NULL_PTR_RETURN_VALUE(manager, NULL);
+    return &manager->workPool;
+}
+
 int32_t AddSensorDevice(const struct SensorDeviceInfo *deviceInfo)
 {
     struct SensorDevInfoNode *pos = NULL;
@@ -345,8 +362,14 @@ int32_t InitSensorDevManager(struct HdfDeviceObject *device)
         return HDF_FAILURE;
     }
 
+    if (HdfWorkPoolInit(&manager->workPool, &g_sensorWorkPoolConfig) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init sensor work pool failed", __func__);
+        return HDF_FAILURE;
+    }
+
     if (!HdfDeviceSetClass(device, DEVICE_CLASS_SENSOR)) {
         HDF_LOGE("%s: init sensor set class failed", __func__);
+        HdfWorkPoolDestroy(&manager->workPool);
         return HDF_FAILURE;
     }
 
@@ -370,6 +393,8 @@ void ReleaseSensorDevManager(struct HdfDeviceObject *device)
         OsalMemFree(pos);
     }
 
+    /* unbinds the works of the sensor drivers, so their later cancel doesn't reach the freed pool */
+    HdfWorkPoolDestroy(&manager->workPool);
     OsalMutexDestroy(&manager->mutex);
     OsalMutexDestroy(&manager->eventMutex);
     OsalMemFree(manager);
@@ -18,8 +18,6 @@
 
 #define HDF_LOG_TAG    hdf_sensor_gyro_driver_c
 
-#define HDF_GYRO_WORK_QUEUE_NAME    "hdf_gyro_work_queue"
-
 static struct GyroDrvData *g_gyroDrvData = NULL;
 
 static struct GyroDrvData *GyroGetDrvData(void)
@@ -64,7 +62,7 @@ static void GyroTimerEntry(uintptr_t arg)
     struct GyroDrvData *drvData = (struct GyroDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->gyroWorkQueue, &drvData->gyroWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->gyroWork)) {
         HDF_LOGE("%s: Gyro add work queue failed", __func__);
     }
 
@@ -78,12 +76,14 @@ static void GyroTimerEntry(uintptr_t arg)
 
 static int32_t InitGyroData(struct GyroDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->gyroWorkQueue, HDF_GYRO_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: Gyro init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: Gyro get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->gyroWork, GyroDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->gyroWork, GyroDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: Gyro create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -361,8 +361,7 @@ void GyroReleaseDriver(struct HdfDeviceObject *device)
     OsalMemFree(drvData->gyroCfg);
     drvData->gyroCfg = NULL;
 
-    HdfWorkDestroy(&drvData->gyroWork);
-    HdfWorkQueueDestroy(&drvData->gyroWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->gyroWork);
     OsalMemFree(drvData);
 }
 
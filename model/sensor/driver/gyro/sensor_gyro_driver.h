@@ -9,7 +9,7 @@
 #ifndef SENSOR_GYRO_DRIVER_H
 #define SENSOR_GYRO_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_mutex.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
@@ -46,8 +46,8 @@ struct GyroOpsCall {
 struct GyroDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue gyroWorkQueue;
-    HdfWork gyroWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork gyroWork;
     OsalTimer gyroTimer;
     bool detectFlag;
     bool enable;
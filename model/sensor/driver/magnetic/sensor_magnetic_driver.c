@@ -18,8 +18,6 @@
 
 #define HDF_LOG_TAG    sensor_magnetic_driver_c
 
-#define HDF_MAGNETIC_WORK_QUEUE_NAME    "hdf_magnetic_work_queue"
-
 static struct MagneticDrvData *g_magneticDrvData = NULL;
 
 static struct MagneticDrvData *MagneticGetDrvData(void)
@@ -64,7 +62,7 @@ static void MagneticTimerEntry(uintptr_t arg)
     struct MagneticDrvData *drvData = (struct MagneticDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->magneticWorkQueue, &drvData->magneticWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->magneticWork)) {
         HDF_LOGE("%s: Magnetic add work queue failed", __func__);
     }
 
@@ -78,12 +76,14 @@ static void MagneticTimerEntry(uintptr_t arg)
 
 static int32_t InitMagneticData(struct MagneticDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->magneticWorkQueue, HDF_MAGNETIC_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: Magnetic init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: Magnetic get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->magneticWork, MagneticDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->magneticWork, MagneticDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: Magnetic create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -370,8 +370,7 @@ void MagneticReleaseDriver(struct HdfDeviceObject *device)
     OsalMemFree(drvData->magneticCfg);
     drvData->magneticCfg = NULL;
 
-    HdfWorkDestroy(&drvData->magneticWork);
-    HdfWorkQueueDestroy(&drvData->magneticWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->magneticWork);
     OsalMemFree(drvData);
 }
 
@@ -9,7 +9,7 @@
 #ifndef SENSOR_MAGNETIC_DRIVER_H
 #define SENSOR_MAGNETIC_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
 #include "sensor_platform_if.h"
@@ -48,8 +48,8 @@ struct MagneticOpsCall {
 struct MagneticDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue magneticWorkQueue;
-    HdfWork magneticWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork magneticWork;
     OsalTimer magneticTimer;
     bool detectFlag;
     bool enable;
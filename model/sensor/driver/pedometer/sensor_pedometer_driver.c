@@ -18,8 +18,6 @@
 
 #define HDF_LOG_TAG    hdf_sensor_pedometer_driver
 
-#define HDF_PEDOMETER_WORK_QUEUE_NAME    "hdf_pedometer_work_queue"
-
 static struct PedometerDrvData *g_pedometerDrvData = NULL;
 
 static struct PedometerDrvData *PedometerGetDrvData(void)
@@ -66,7 +64,7 @@ static void PedometerTimerEntry(uintptr_t arg)
     struct PedometerDrvData *drvData = (struct PedometerDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->pedometerWorkQueue, &drvData->pedometerWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->pedometerWork)) {
         HDF_LOGE("%s: Pedometer add work queue failed", __func__);
     }
 
@@ -80,12 +78,14 @@ static void PedometerTimerEntry(uintptr_t arg)
 
 static int32_t InitPedometerData(struct PedometerDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->pedometerWorkQueue, HDF_PEDOMETER_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: Pedometer init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: Pedometer get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->pedometerWork, PedometerDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->pedometerWork, PedometerDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: Pedometer create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -359,8 +359,7 @@ void PedometerReleaseDriver(struct HdfDeviceObject *device)
     OsalMemFree(drvData->pedometerCfg);
     drvData->pedometerCfg = NULL;
 
-    HdfWorkDestroy(&drvData->pedometerWork);
-    HdfWorkQueueDestroy(&drvData->pedometerWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->pedometerWork);
     OsalMemFree(drvData);
 }
 
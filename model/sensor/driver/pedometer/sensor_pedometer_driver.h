@@ -9,7 +9,7 @@
 #ifndef SENSOR_PEDOMETER_DRIVER_H
 #define SENSOR_PEDOMETER_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
 #include "sensor_platform_if.h"
@@ -32,8 +32,8 @@ struct PedometerOpsCall {
 struct PedometerDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue pedometerWorkQueue;
-    HdfWork pedometerWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork pedometerWork;
     OsalTimer pedometerTimer;
     bool detectFlag;
     bool enable;
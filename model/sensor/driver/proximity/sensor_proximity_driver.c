@@ -18,8 +18,6 @@
 
 #define HDF_LOG_TAG    sensor_proximity_driver_c
 
-#define HDF_PROXIMITY_WORK_QUEUE_NAME    "hdf_proximity_work_queue"
-
 static struct ProximityDrvData *g_proximityDrvData = NULL;
 
 static struct ProximityDrvData *ProximityGetDrvData(void)
@@ -63,7 +61,7 @@ static void ProximityTimerEntry(uintptr_t arg)
     struct ProximityDrvData *drvData = (struct ProximityDrvData *)arg;
     CHECK_NULL_PTR_RETURN(drvData);
 
-    if (!HdfAddWork(&drvData->proximityWorkQueue, &drvData->proximityWork)) {
+    if (!HdfWorkPoolAdd(drvData->workPool, &drvData->proximityWork)) {
         HDF_LOGE("%s: proximity add work queue failed", __func__);
     }
 
@@ -77,12 +75,14 @@ static void ProximityTimerEntry(uintptr_t arg)
 
 static int32_t InitProximityData(struct ProximityDrvData *drvData)
 {
-    if (HdfWorkQueueInit(&drvData->proximityWorkQueue, HDF_PROXIMITY_WORK_QUEUE_NAME) != HDF_SUCCESS) {
-        HDF_LOGE("%s: proximity init work queue failed", __func__);
+    drvData->workPool = GetSensorWorkPool();
+    if (drvData->workPool == NULL) {
+        HDF_LOGE("%s: proximity get work pool failed", __func__);
         return HDF_FAILURE;
     }
 
-    if (HdfWorkInit(&drvData->proximityWork, ProximityDataWorkEntry, drvData) != HDF_SUCCESS) {
+    if (HdfPoolWorkInit(&drvData->proximityWork, ProximityDataWorkEntry, drvData,
+        HDF_WORK_CLASS_REALTIME) != HDF_SUCCESS) {
         HDF_LOGE("%s: proximity create thread failed", __func__);
         return HDF_FAILURE;
     }
@@ -358,8 +358,7 @@ void ProximityReleaseDriver(struct HdfDeviceObject *device)
     OsalMemFree(drvData->proximityCfg);
     drvData->proximityCfg = NULL;
 
-    HdfWorkDestroy(&drvData->proximityWork);
-    HdfWorkQueueDestroy(&drvData->proximityWorkQueue);
+    (void)HdfPoolWorkCancelSync(&drvData->proximityWork);
     OsalMemFree(drvData);
 }
 
@@ -9,7 +9,7 @@
 #ifndef SENSOR_PROXIMITY_DRIVER_H
 #define SENSOR_PROXIMITY_DRIVER_H
 
-#include "hdf_workqueue.h"
+#include "hdf_work_pool.h"
 #include "osal_timer.h"
 #include "sensor_config_parser.h"
 #include "sensor_platform_if.h"
@@ -26,8 +26,8 @@ struct ProximityOpsCall {
 struct ProximityDrvData {
     struct IDeviceIoService ioService;
     struct HdfDeviceObject *device;
-    HdfWorkQueue proximityWorkQueue;
-    HdfWork proximityWork;
+    struct HdfWorkPool *workPool;
+    struct HdfPoolWork proximityWork;
     OsalTimer proximityTimer;
     bool detectFlag;
     bool enable;
@@ -138,6 +138,11 @@ struct UartDevice {
 #define UART_PL011_CR_RTSE_MASK             (0x1u << 0xEu)  /* RTS hardware flow control enable bit mask */
 #define UART_PL011_CR_CTSE_MASK             (0x1u << 0xFu)  /* CTS hardware flow control enable bit mask */
 
+/* Interrupt Mask Set/Clear Register */
+#define UART_PL011_IMSC_RXIM_MASK           (0x1u << 0x4u)  /* Receive interrupt mask */
+#define UART_PL011_IMSC_RTIM_MASK           (0x1u << 0x6u)  /* Receive timeout interrupt mask */
+#define UART_PL011_IMSC_RX_MASK             (UART_PL011_IMSC_RXIM_MASK | UART_PL011_IMSC_RTIM_MASK)
+#define UART_PL011_DR_DATA_MASK             (0xFFu)
 
 /* Interrupt FIFO Level Select Register Transmit bit offset */
 #define UART_PL011_IFLS_TX_BIT_OFFSET           0x0u
@@ -224,6 +229,25 @@ static inline void UartPl011Write(struct UartRegisterMap *regMap, uint8_t byte)
     regMap->dr = byte;
 }
 
+static inline bool UartPl011RxEmpty(struct UartRegisterMap *regMap)
+{
+    return (bool)(regMap->fr & UART_PL011_FR_RX_FIFO_EMPTY_MASK);
+}
+
+static inline uint8_t UartPl011Read(struct UartRegisterMap *regMap)
+{
+    return (uint8_t)(regMap->dr & UART_PL011_DR_DATA_MASK);
+}
+
+static inline void UartPl011EnableRxIrq(struct UartRegisterMap *regMap, bool enable)
+{
+    if (enable) {
+        regMap->imsc |= UART_PL011_IMSC_RX_MASK;
+    } else {
+        regMap->imsc &= ~UART_PL011_IMSC_RX_MASK;
+    }
+}
+
 UartPl011Error UartPl011SetBaudrate(struct UartRegisterMap *regMap, uint32_t clk, uint32_t baudrate);
 
 void UartPl011SetDataFormat(struct UartRegisterMap *regMap, uint32_t wordLen, uint32_t parity, uint32_t stopBits);
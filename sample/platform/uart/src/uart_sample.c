@@ -12,6 +12,7 @@
 #include "hdf_log.h"
 #include "hisoc/uart.h"
 #include "osal_io.h"
+#include "osal_irq.h"
 #include "osal_mem.h"
 #include "uart_core.h"
 #include "uart_dev_sample.h"
@@ -20,6 +21,8 @@
 
 #define HDF_LOG_TAG uart_sample
 #define UART_RX_FIFO_SIZE 128
+#define UART_RX_RING_SIZE 1024
+#define UART_RX_BURST     16
 
 static uint8_t g_fifoBuffer[UART_RX_FIFO_SIZE] = {0};
 
@@ -152,6 +155,60 @@ static int32_t SampleUartHostGetBaud(struct UartHost *host, uint32_t *baudRate)
     return HDF_SUCCESS;
 }
 
+/* drains the hardware fifo into the receive ring of the core, which serves UartHostRead */
+static uint32_t SampleUartIrqHandler(uint32_t irqId, void *data)
+{
+    uint32_t len;
+    uint8_t burst[UART_RX_BURST];
+    struct UartHost *host = (struct UartHost *)data;
+    struct UartDevice *device = (struct UartDevice *)host->priv;
+    struct UartRegisterMap *regMap = (struct UartRegisterMap *)device->resource.physBase;
+
+    (void)irqId;
+    do {
+        for (len = 0; len < UART_RX_BURST && !UartPl011RxEmpty(regMap); len++) {
+            burst[len] = UartPl011Read(regMap);
+        }
+        if (len > 0) {
+            (void)UartHostRxPush(host, burst, len);
+        }
+    } while (len == UART_RX_BURST);
+    regMap->icr = UART_PL011_IMSC_RX_MASK;
+    return HDF_SUCCESS;
+}
+
+static int32_t SampleUartRxStart(struct UartHost *host)
+{
+    int32_t ret;
+    struct UartDevice *device = (struct UartDevice *)host->priv;
+
+    ret = UartHostRxRingInit(host, UART_RX_RING_SIZE);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: init rx ring fail:%d", __func__, ret);
+        return ret;
+    }
+    ret = OsalRegisterIrq(device->resource.irqNum, 0, SampleUartIrqHandler, "uart_sample", host);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: register irq %u fail:%d", __func__, device->resource.irqNum, ret);
+        UartHostRxRingDeinit(host);
+        return ret;
+    }
+    UartPl011EnableRxIrq((struct UartRegisterMap *)device->resource.physBase, true);
+    return HDF_SUCCESS;
+}
+
+static void SampleUartRxStop(struct UartHost *host)
+{
+    struct UartDevice *device = (struct UartDevice *)host->priv;
+
+    if (host->rxRing == NULL) {
+        return;
+    }
+    UartPl011EnableRxIrq((struct UartRegisterMap *)device->resource.physBase, false);
+    (void)OsalUnregisterIrq(device->resource.irqNum, host);
+    UartHostRxRingDeinit(host);
+}
+
 static int InitUartDevice(struct UartDevice *device)
 {
     UartPl011Error err;
@@ -252,7 +309,11 @@ static int32_t AttachUartDevice(struct UartHost *host, struct HdfDeviceObject *d
     host->num = uartDevice->resource.num;
     host->priv = uartDevice;
     AddUartDevice(host);
-    return InitUartDevice(uartDevice);
+    ret = InitUartDevice(uartDevice);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    return SampleUartRxStart(host);
 }
 
 static void DeinitUartDevice(struct UartDevice *device)
@@ -275,6 +336,7 @@ static void DetachUartDevice(struct UartHost *host)
         return;
     }
     uartDevice = host->priv;
+    SampleUartRxStop(host);
     DeinitUartDevice(uartDevice);
     (void)OsalMemFree(uartDevice);
     host->priv = NULL;
@@ -12,6 +12,10 @@
 #include "osal_spinlock.h"
 #include "hdf_base.h"
 #include "adc_if.h"
+#include "osal_atomic.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_thread.h"
 #include "platform_core.h"
 
 #ifdef __cplusplus
@@ -26,6 +30,28 @@ struct AdcDevice;
 struct AdcMethod;
 struct AdcLockMethod;
 
+/*
+ * Frame ring of a continuous scan, the controller is the only producer and the reader the only consumer.
+ * Frame n holds chanCnt values at vals + (n & sizeMask) * chanCnt and its timestamp at timestamps[n & sizeMask].
+ * The pushes and the reader pin the ring through device->scanUsers, and it is freed after they left.
+ */
+struct AdcScan {
+    struct AdcDevice *device;
+    struct AdcScanCfg cfg;
+    uint32_t chanCnt;
+    uint32_t sizeMask;
+    volatile uint32_t readPosition;
+    volatile uint32_t writePosition;
+    uint32_t *vals;
+    uint64_t *timestamps;
+    uint32_t overruns;      /* frames dropped because the ring was full */
+    OsalAtomic sync;        /* value returning operations on it are used as full barriers */
+    /* software scan, for controllers without scanStart */
+    struct OsalThread thread;
+    struct OsalSem exitSem;
+    volatile bool stopping;
+};
+
 struct AdcDevice {
     const struct AdcMethod *ops;
     OsalSpinlock spin;
@@ -33,12 +59,21 @@ struct AdcDevice {
     uint32_t chanNum;
     const struct AdcLockMethod *lockOps;
     void *priv;
+    struct AdcScan *scan;
+    OsalAtomic scanUsers;
+    struct OsalMutex scanLock;  /* serializes starting and stopping the scan */
 };
 
 struct AdcMethod {
     int32_t (*read)(struct AdcDevice *device, uint32_t channel, uint32_t *val);
     int32_t (*start)(struct AdcDevice *device);
     int32_t (*stop)(struct AdcDevice *device);
+    /*
+     * Optional, start filling device->scan with AdcDeviceScanPush or AdcDeviceScanPrepare/AdcDeviceScanCommit,
+     * e.g. from the dma done interrupt. Without it the core samples the channels by read in a thread.
+     */
+    int32_t (*scanStart)(struct AdcDevice *device, const struct AdcScanCfg *cfg);
+    int32_t (*scanStop)(struct AdcDevice *device);
 };
 
 struct AdcLockMethod {
@@ -60,6 +95,24 @@ int32_t AdcDeviceStart(struct AdcDevice *device);
 
 int32_t AdcDeviceStop(struct AdcDevice *device);
 
+int32_t AdcDeviceScanStart(struct AdcDevice *device, const struct AdcScanCfg *cfg);
+
+int32_t AdcDeviceScanStop(struct AdcDevice *device);
+
+int32_t AdcDeviceScanRead(struct AdcDevice *device, uint32_t *vals, uint64_t *timestamps, uint32_t count);
+
+/* put one frame of chanCnt values, returns false if the ring is full and the frame is dropped */
+bool AdcDeviceScanPush(struct AdcDevice *device, const uint32_t *vals, uint64_t timestamp);
+
+/* get the contiguous free frames of the ring, for a dma transfer to fill in place */
+uint32_t AdcDeviceScanPrepare(struct AdcDevice *device, uint32_t **vals);
+
+/* publish frames filled at the prepared buffer, timestamp is of the last frame and the others are spaced by rate */
+void AdcDeviceScanCommit(struct AdcDevice *device, uint32_t frames, uint64_t timestamp);
+
+/* the monotonic clock of the scan timestamps */
+uint64_t AdcScanTimeUs(void);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
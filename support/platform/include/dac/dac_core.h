@@ -12,6 +12,10 @@
 #include "osal_spinlock.h"
 #include "hdf_base.h"
 #include "dac_if.h"
+#include "osal_atomic.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_thread.h"
 #include "platform_core.h"
 
 #ifdef __cplusplus
@@ -26,6 +30,28 @@ struct DacDevice;
 struct DacMethod;
 struct DacLockMethod;
 
+/*
+ * Sample ring of a stream, the client is the only producer and the controller the only consumer.
+ * Sample n is at vals[n & sizeMask].
+ * The controller callbacks pin the ring through device->streamUsers, and it is freed after they left.
+ */
+struct DacStream {
+    struct DacDevice *device;
+    struct DacStreamCfg cfg;
+    uint32_t sizeMask;
+    volatile uint32_t readPosition;
+    volatile uint32_t writePosition;
+    uint32_t *vals;
+    uint32_t underruns;
+    uint64_t played;
+    volatile bool lowSignaled;  /* the watermark was crossed and the waiter woken, cleared by a refill */
+    OsalAtomic sync;            /* value returning operations on it are used as full barriers */
+    /* software stream, for controllers without streamStart */
+    struct OsalThread thread;
+    struct OsalSem exitSem;
+    volatile bool stopping;
+};
+
 struct DacDevice {
     const struct DacMethod *ops;
     OsalSpinlock spin;
@@ -33,12 +59,23 @@ struct DacDevice {
     uint32_t chanNum;
     const struct DacLockMethod *lockOps;
     void *priv;
+    struct DacStream *stream;
+    struct OsalSem streamSem;   /* posted at the low watermark and on stop, outlives the streams */
+    OsalAtomic streamUsers;
+    struct OsalMutex streamLock;  /* serializes starting and stopping the stream */
 };
 
 struct DacMethod {
     int32_t (*write)(struct DacDevice *device, uint32_t channel, uint32_t val);
     int32_t (*start)(struct DacDevice *device);
     int32_t (*stop)(struct DacDevice *device);
+    /*
+     * Optional, start draining device->stream with DacDeviceStreamPop from a timer interrupt or with
+     * DacDeviceStreamPrepare/DacDeviceStreamCommit from the dma done interrupt.
+     * Without it the core outputs the samples by write in a thread.
+     */
+    int32_t (*streamStart)(struct DacDevice *device, const struct DacStreamCfg *cfg);
+    int32_t (*streamStop)(struct DacDevice *device);
 };
 
 struct DacLockMethod {
@@ -60,6 +97,23 @@ int32_t DacDeviceStart(struct DacDevice *device);
 
 int32_t DacDeviceStop(struct DacDevice *device);
 
+int32_t DacDeviceStreamStart(struct DacDevice *device, const struct DacStreamCfg *cfg);
+
+int32_t DacDeviceStreamStop(struct DacDevice *device);
+
+int32_t DacDeviceStreamWrite(struct DacDevice *device, const uint32_t *vals, uint32_t count);
+
+int32_t DacDeviceStreamWait(struct DacDevice *device, uint32_t timeoutMs, struct DacStreamStatus *status);
+
+/* take the next sample to output, returns false and counts an underrun if the ring is empty */
+bool DacDeviceStreamPop(struct DacDevice *device, uint32_t *val);
+
+/* get the contiguous queued samples of the ring, for a dma transfer to output in place */
+uint32_t DacDeviceStreamPrepare(struct DacDevice *device, const uint32_t **vals);
+
+/* give back samples output from the prepared buffer, missed is the output slots the ring could not fill */
+void DacDeviceStreamCommit(struct DacDevice *device, uint32_t samples, uint32_t missed);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
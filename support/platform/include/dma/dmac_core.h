@@ -81,6 +81,16 @@ struct DmacMsg {
     void *para;
 };
 
+/*
+ * One contiguous piece of a scatter-gather transfer. For peripheral transfers the peripheral side
+ * repeats the address given in the DmacMsg, only the memory side moves from segment to segment.
+ */
+struct DmacSgSeg {
+    uintptr_t srcAddr;
+    uintptr_t destAddr;
+    size_t len;
+};
+
 static inline uintptr_t DmacMsgGetPeriphAddr(struct DmacMsg *msg)
 {
     return (msg->transType == TRASFER_TYPE_M2P) ? msg->destAddr :
@@ -118,6 +128,7 @@ struct DmacChanInfo {
     unsigned long config;     // cpu width expected
     uintptr_t lliEnFlag;
     DmacEvent waitEvent;
+    bool async;               // m2m completion goes to callback from irq instead of waitEvent
     DmacCallback *callback;
     void *callbackData;
     uint16_t lliCnt;
@@ -141,6 +152,8 @@ struct DmaCntlr {
     int32_t (*dmaChanEnable)(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo);
     int32_t (*dmaM2mChanEnable)(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo,
         uintptr_t src, uintptr_t dest, size_t length);
+    /* optional: start a prebuilt m2m lli chain, without it m2m is issued one maxTransSize chunk at a time */
+    int32_t (*dmaM2mLliEnable)(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo);
     void (*dmacChanDisable)(struct DmaCntlr *cntlr, uint16_t channel);
     void (*dmacCacheInv)(uintptr_t vaddr, uintptr_t vend);
     void (*dmacCacheFlush)(uintptr_t vaddr, uintptr_t vend);
@@ -162,6 +175,14 @@ void DmacCntlrRemove(struct DmaCntlr *cntlr);
 
 int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg);
 
+/*
+ * Builds one lli chain over all segments and starts it, returning without waiting. msg gives the
+ * type, widths, peripheral address and callback; its transLen is ignored. msg->cb reports the result
+ * from irq context, msg and segs may be released as soon as this returns.
+ */
+int32_t DmaCntlrTransferSg(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgSeg *segs, uint16_t segNum);
+
 uintptr_t DmaGetCurrChanDestAddr(struct DmaCntlr *cntlr, uint16_t chan);
 #else
 static inline struct DmaCntlr *DmaCntlrCreate(struct HdfDeviceObject *dev)
@@ -195,6 +216,16 @@ static inline int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *m
     return HDF_ERR_NOT_SUPPORT;
 }
 
+static inline int32_t DmaCntlrTransferSg(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgSeg *segs, uint16_t segNum)
+{
+    (void)cntlr;
+    (void)msg;
+    (void)segs;
+    (void)segNum;
+    return HDF_ERR_NOT_SUPPORT;
+}
+
 static inline uintptr_t DmaGetCurrChanDestAddr(struct DmaCntlr *cntlr, uint16_t chan)
 {
     (void)cntlr;
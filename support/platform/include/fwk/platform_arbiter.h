@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef PLATFORM_ARBITER_H
+#define PLATFORM_ARBITER_H
+
+#include "hdf_base.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "platform_if.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
+/* queueing statistics of an arbiter, per caller priority */
+struct PlatformArbiterStat {
+    uint32_t grants[PLATFORM_PRIORITY_NUM];
+    uint32_t waitLastUs[PLATFORM_PRIORITY_NUM];   /* from asking to being granted, of the last grant */
+    uint32_t waitMaxUs[PLATFORM_PRIORITY_NUM];
+    uint64_t waitTotalUs[PLATFORM_PRIORITY_NUM];  /* divided by grants for the average */
+    uint32_t yields;                              /* times a holder stepped aside for a higher priority */
+    uint32_t timeouts;
+};
+
+/*
+ * Grants exclusive access to a shared bus, like a mutex, but on release the bus is handed directly
+ * to the waiter of the highest priority. Waiters of the same priority are not ordered.
+ */
+struct PlatformArbiter {
+    OsalSpinlock spin;
+    bool busy;
+    uint32_t holderPrio;
+    uint32_t waiting[PLATFORM_PRIORITY_NUM];
+    struct OsalSem sems[PLATFORM_PRIORITY_NUM];
+    struct PlatformArbiterStat stat;
+};
+
+int32_t PlatformArbiterInit(struct PlatformArbiter *arbiter);
+void PlatformArbiterUninit(struct PlatformArbiter *arbiter);
+
+/**
+ * @brief Wait for the bus at the priority of the caller.
+ *
+ * @param arbiter Indicates the arbiter of the bus.
+ * @param prio Indicates the priority of the caller, see {@link PlatformPriority}.
+ * @param timeoutMs Indicates the time to wait in milliseconds, or HDF_WAIT_FOREVER.
+ *
+ * @return Returns 0 once the bus is granted; returns HDF_ERR_TIMEOUT if it's not granted in time.
+ * @since 1.0
+ */
+int32_t PlatformArbiterAcquire(struct PlatformArbiter *arbiter, uint32_t prio, uint32_t timeoutMs);
+void PlatformArbiterRelease(struct PlatformArbiter *arbiter);
+
+/**
+ * @brief Step aside at a transaction boundary if a caller of higher priority is waiting.
+ *
+ * The bus is handed to that caller and the function returns after it has been granted back to this one.
+ * The holder must be at a point where another transaction may safely run on the bus.
+ *
+ * @param arbiter Indicates the arbiter of the bus, which must be held by the caller.
+ *
+ * @return Returns true if the bus was handed over in between; returns false otherwise.
+ * @since 1.0
+ */
+bool PlatformArbiterYield(struct PlatformArbiter *arbiter);
+
+/* whether a caller of higher priority than the holder is waiting, a hint that may be stale on return */
+bool PlatformArbiterHasHigherWaiter(struct PlatformArbiter *arbiter);
+
+int32_t PlatformArbiterGetStat(struct PlatformArbiter *arbiter, struct PlatformArbiterStat *stat);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+#endif /* PLATFORM_ARBITER_H */
@@ -10,6 +10,7 @@
 #define PLATFORM_CORE_H
 
 #include "hdf_base.h"
+#include "osal_atomic.h"
 
 #include "platform_log.h"
 #include "platform_errno.h"
@@ -68,6 +69,27 @@ int32_t PlatformModuleInfoCount(void);
 void PlatformGlobalLock(void);
 void PlatformGlobalUnlock(void);
 
+/* microseconds on a monotonic clock, for intervals and timestamps which mustn't jump with the wall time */
+uint64_t PlatformMonoTimeUs(void);
+
+/* BKDR hash of a name, callers reduce it to their own bucket count */
+static inline uint32_t PlatformNameHash(const char *name)
+{
+    uint32_t hash = 0;
+
+    while (*name != '\0') {
+        hash = hash * 131 + (uint8_t)(*name++); // 131: BKDR seed
+    }
+    return hash;
+}
+
+/* a full memory barrier, made of a value returning operation on an atomic the caller keeps for it */
+static inline void PlatformMemBarrier(OsalAtomic *sync)
+{
+    // value returning atomic operations are fully ordered
+    (void)OsalAtomicIncReturn(sync);
+}
+
 /* Os adapt */
 bool PlatInIrqContext(void);
 
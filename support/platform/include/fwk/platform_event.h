@@ -21,13 +21,19 @@ extern "C" {
 #endif
 #endif /* __cplusplus */
 
+#define PLAT_EVENT_BITS 32
+
 struct PlatformEvent {
     OsalSpinlock spin;
     struct OsalSem sem;
-    struct DListHead waiters;
+    struct DListHead waiters;                        /**< OR-mode waiters interested in more than one bit */
+    struct DListHead bitWaiters[PLAT_EVENT_BITS];    /**< other waiters, indexed by the lowest bit of their mask */
+    struct DListHead pendingListeners;               /**< async listeners with events not delivered yet */
+    uint32_t bitWaiterMask;                          /**< bit n set if bitWaiters[n] is not empty */
     int32_t waiterCnt;
     uint32_t irqSave;
     uint32_t eventsWord;
+    uint32_t wakePolicy;
 };
 
 enum PlatformEventType {
@@ -42,6 +48,11 @@ enum PlatformEventMode {
     PLAT_EVENT_MODE_ASYNC   = 0x1 << 3,
 };
 
+enum PlatformEventWakePolicy {
+    PLAT_EVENT_WAKE_ONE = 0,    /**< wake the first matching waiter per post */
+    PLAT_EVENT_WAKE_ALL = 1,    /**< wake every matching waiter per post */
+};
+
 struct PlatformEventListener {
     /** Private data passed to the callback function. */
     void *data;
@@ -85,6 +96,32 @@ int32_t PlatformEventUninit(struct PlatformEvent *pe);
  */
 int32_t PlatformEventPost(struct PlatformEvent *pe, uint32_t events);
 
+/**
+ * @brief Write the events to a platform event instace and wake all the matching waiters.
+ *
+ * Every matching waiter receives the events it is interested in, regardless of the wake policy.
+ *
+ * @param pe Indicates the pointer to the the platform event instance
+ * @param events The events to write.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t PlatformEventBroadcast(struct PlatformEvent *pe, uint32_t events);
+
+/**
+ * @brief Set the wake policy used by {@link PlatformEventPost}.
+ *
+ * @param pe Indicates the pointer to the the platform event instance
+ * @param policy The wake policy, see {@link PlatformEventWakePolicy}.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t PlatformEventSetWakePolicy(struct PlatformEvent *pe, uint32_t policy);
+
 /**
  * @brief Listen for CAN bus events.
  *
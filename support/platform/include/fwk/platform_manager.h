@@ -11,6 +11,8 @@
 
 #include "hdf_base.h"
 #include "hdf_dlist.h"
+#include "osal_atomic.h"
+#include "osal_mutex.h"
 #include "osal_spinlock.h"
 #include "platform_device.h"
 
@@ -20,10 +22,18 @@ extern "C" {
 #endif
 #endif /* __cplusplus */
 
+#define PLATFORM_MANAGER_READER_SLOTS 2
+
 enum PlatformModuleType;
+struct PlatformDeviceTable;
 struct PlatformManager {
     struct PlatformDevice device;
     struct DListHead devices;  /* list to keep all it's device instances */
+    struct PlatformDeviceTable *table;  /* devices indexed by number, looked up without lock */
+    OsalAtomic readers[PLATFORM_MANAGER_READER_SLOTS];  /* lock free lookups in progress, per epoch */
+    OsalAtomic version;  /* bumped on every table update */
+    uint32_t epoch;
+    struct OsalMutex syncLock;  /* serializes the epoch flips of the updaters */
     int32_t (*add)(struct PlatformManager *manager, struct PlatformDevice *device);
     int32_t (*del)(struct PlatformManager *manager, struct PlatformDevice *device);
 };
@@ -107,6 +117,7 @@ struct PlatformDevice *PlatformManagerFindDevice(struct PlatformManager *manager
  * @brief Get a platform device from the manager by number.
  *
  * The device got will be returned with reference count increased.
+ * Devices with a small number are found through an index table without taking the manager lock.
  *
  * @param manager Indicates the pointer to the platform manager.
  * @param number Indicates the number of the target platform device.
@@ -129,6 +140,43 @@ struct PlatformDevice *PlatformManagerGetDeviceByNumber(struct PlatformManager *
  */
 struct PlatformDevice *PlatformManagerGetDeviceByName(struct PlatformManager *manager, const char *name);
 
+/**
+ * @brief Enter a lock free read section of the manager.
+ *
+ * Lookup tables published by the manager or its module may be read without the manager lock
+ * inside the section, an object found must be got before leaving the section.
+ * The reader is counted before any table is loaded, so an updater syncing after unpublishing a table
+ * either waits for the reader or the reader sees the new table.
+ *
+ * @param manager Indicates the pointer to the platform manager.
+ *
+ * @return Returns the reader slot which should be passed to PlatformManagerReadExit.
+ * @since 1.0
+ */
+uint32_t PlatformManagerReadEnter(struct PlatformManager *manager);
+
+/**
+ * @brief Leave a lock free read section of the manager.
+ *
+ * @param manager Indicates the pointer to the platform manager.
+ * @param slot Indicates the reader slot returned by PlatformManagerReadEnter.
+ *
+ * @since 1.0
+ */
+void PlatformManagerReadExit(struct PlatformManager *manager, uint32_t slot);
+
+/**
+ * @brief Wait for all the lock free readers which may see an unpublished object to leave.
+ *
+ * Call it after an object is unpublished under the manager lock and before it is freed or put.
+ * Concurrent updaters sync one after another. It may sleep, so never call it with a lock held.
+ *
+ * @param manager Indicates the pointer to the platform manager.
+ *
+ * @since 1.0
+ */
+void PlatformManagerSyncReaders(struct PlatformManager *manager);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
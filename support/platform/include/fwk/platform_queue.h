@@ -43,6 +43,7 @@ struct PlatformQueue {
     void *data;
 };
 
+/* may be called from interrupt context, the queue is guarded by an irq safe spinlock */
 int32_t PlatformQueueAddMsg(struct PlatformQueue *queue, struct PlatformMsg *msg);
 struct PlatformQueue *PlatformQueueCreate(PlatformMsgHandle handle, const char *name, void *data);
 void PlatformQueueDestroy(struct PlatformQueue *queue);
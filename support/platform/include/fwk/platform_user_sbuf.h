@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef PLATFORM_USER_SBUF_H
+#define PLATFORM_USER_SBUF_H
+
+#include "hdf_base.h"
+#include "hdf_sbuf.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
+#define PLATFORM_USER_SBUF_REPLY_SIZE 256
+
+/**
+ * @brief Get the request and reply sbufs of the calling thread for a call into a platform service.
+ *
+ * The user space platform libraries use these instead of obtaining and recycling a pair of sbufs per call.
+ * Both are flushed before they are handed out, and they are recycled when the thread exits.
+ * A caller must be done with them before it makes another call, the next one takes the same sbufs.
+ *
+ * @param data Returns the request sbuf.
+ * @param reply Returns the reply sbuf.
+ * @param replySize Indicates the reply capacity needed, the reply only ever grows.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t PlatformUserSbufGet(struct HdfSBuf **data, struct HdfSBuf **reply, size_t replySize);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+#endif /* PLATFORM_USER_SBUF_H */
@@ -13,6 +13,7 @@
 #include "hdf_base.h"
 #include "hdf_device_desc.h"
 #include "hdf_dlist.h"
+#include "hdf_work_pool.h"
 #include "osal_mem.h"
 #include "osal_spinlock.h"
 #include "platform_core.h"
@@ -80,35 +81,39 @@ struct GpioIrqRecord {
     void *irqData;
     uint16_t global;
     OsalSpinlock spin;
-    struct OsalSem sem;
-    struct OsalThread thread;
+    struct HdfWorkPool *pool;
+    struct HdfPoolWork work;
+    struct GpioIrqEvent pending;  /* interrupts taken since the bottom half was last run */
+    struct GpioIrqEvent event;    /* interrupts handed to the running bottom half */
+    bool running;
     bool removed;
+    struct DListHead node;
 };
 
 static inline void GpioIrqRecordTrigger(struct GpioIrqRecord *irqRecord)
 {
+    uint32_t irqSave;
+    uint64_t nowUs;
+
     if (irqRecord->irqFunc != NULL) {
         (void)irqRecord->irqFunc(irqRecord->global, irqRecord->irqData);
     }
     if (irqRecord->btmFunc != NULL) {
-        (void)OsalSemPost(&irqRecord->sem);
-    }
-}
-
-static inline void GpioIrqRecordDestroy(struct GpioIrqRecord *irqRecord)
-{
-    uint32_t irqSave;
-
-    if (irqRecord->btmFunc == NULL) {
-        OsalMemFree(irqRecord);  // the last access to this record
-    } else {
+        nowUs = PlatformMonoTimeUs();
         (void)OsalSpinLockIrqSave(&irqRecord->spin, &irqSave);
-        irqRecord->removed = true;
-        (void)OsalSemPost(&irqRecord->sem); // this is the last post ...
+        if (irqRecord->pending.count == 0) {
+            irqRecord->pending.firstUs = nowUs;
+        }
+        irqRecord->pending.count++;
+        irqRecord->pending.lastUs = nowUs;
         (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave);
+        // fails only if the bottom half is already queued, which will then take this interrupt as well
+        (void)HdfWorkPoolAdd(irqRecord->pool, &irqRecord->work);
     }
 }
 
+void GpioIrqRecordDestroy(struct GpioIrqRecord *irqRecord);
+
 /**
  * @brief Defines the struct which contains the hooks which a GPIO driver need to implement.
  *
@@ -137,6 +142,10 @@ struct GpioMethod {
     int32_t (*enableIrq)(struct GpioCntlr *cntlr, uint16_t local);
     /** disable a GPIO pin interrupt */
     int32_t (*disableIrq)(struct GpioCntlr *cntlr, uint16_t local);
+    /** write the level values into several GPIO pins in order, optional */
+    int32_t (*writeMulti)(struct GpioCntlr *cntlr, const uint16_t *locals, const uint16_t *vals, uint16_t count);
+    /** read the level values of several GPIO pins, optional */
+    int32_t (*readMulti)(struct GpioCntlr *cntlr, const uint16_t *locals, uint16_t *vals, uint16_t count);
 };
 
 /**
@@ -175,6 +184,10 @@ int32_t GpioCntlrWrite(struct GpioCntlr *cntlr, uint16_t local, uint16_t val);
 
 int32_t GpioCntlrRead(struct GpioCntlr *cntlr, uint16_t local, uint16_t *val);
 
+int32_t GpioCntlrWriteMulti(struct GpioCntlr *cntlr, const uint16_t *locals, const uint16_t *vals, uint16_t count);
+
+int32_t GpioCntlrReadMulti(struct GpioCntlr *cntlr, const uint16_t *locals, uint16_t *vals, uint16_t count);
+
 int32_t GpioCntlrSetDir(struct GpioCntlr *cntlr, uint16_t local, uint16_t dir);
 
 int32_t GpioCntlrGetDir(struct GpioCntlr *cntlr, uint16_t local, uint16_t *dir);
@@ -189,12 +202,48 @@ int32_t GpioCntlrEnableIrq(struct GpioCntlr *cntlr, uint16_t local);
 
 int32_t GpioCntlrDisableIrq(struct GpioCntlr *cntlr, uint16_t local);
 
+int32_t GpioCntlrGetIrqEvent(struct GpioCntlr *cntlr, uint16_t local, struct GpioIrqEvent *event);
+
 void GpioCntlrIrqCallback(struct GpioCntlr *cntlr, uint16_t local);
 
 struct PlatformManager *GpioManagerGet(void);
 
+/**
+ * @brief Get the worker pool shared by the bottom halves of all threaded GPIO interrupts.
+ *
+ * The pool is started on first use.
+ *
+ * @return Returns the pool on success; returns NULL otherwise.
+ * @since 1.0
+ */
+struct HdfWorkPool *GpioManagerGetIrqPool(void);
+
+/**
+ * @brief Hand over an irq record whose bottom half is still running, it is freed once the pool is done with it.
+ *
+ * A reaper queued on the pool frees the record right after its bottom half returns.
+ *
+ * @param irqRecord Indicates the irq record, already detached from its pin.
+ *
+ * @since 1.0
+ */
+void GpioManagerRetireIrqRecord(struct GpioIrqRecord *irqRecord);
+
+/**
+ * @brief Wait for the bottom halves of the retired irq records to return, then free the records.
+ *
+ * Once this returns, no handler of a pin unset before the call is running any more, so its data may be freed.
+ * Must not be called from a bottom half.
+ *
+ * @since 1.0
+ */
+void GpioManagerReapIrqRecords(void);
+
 struct GpioCntlr *GpioCntlrGetByGpio(uint16_t gpio);
 
+/* looks in the range table only, which may miss a controller GpioCntlrGetByGpio still finds by scanning */
+struct GpioCntlr *GpioCntlrGetByRange(uint16_t gpio);
+
 static inline void GpioCntlrPut(struct GpioCntlr *cntlr)
 {
     if (cntlr != NULL) {
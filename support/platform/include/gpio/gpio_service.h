@@ -15,6 +15,9 @@ extern "C" {
 #endif
 #endif /* __cplusplus */
 
+/* the most pins one client may set irqs on, so also the most events one GPIO_IO_WAIT_EVENTS call hands back */
+#define GPIO_SERVICE_EVENT_MAX 32
+
 enum GpioIoCmd {
     GPIO_IO_READ = 0,
     GPIO_IO_WRITE = 1,
@@ -24,6 +27,9 @@ enum GpioIoCmd {
     GPIO_IO_UNSETIRQ = 5,
     GPIO_IO_ENABLEIRQ = 6,
     GPIO_IO_DISABLEIRQ = 7,
+    GPIO_IO_READ_MULTI = 8,
+    GPIO_IO_WRITE_MULTI = 9,
+    GPIO_IO_WAIT_EVENTS = 10,
 };
 
 #ifdef __cplusplus
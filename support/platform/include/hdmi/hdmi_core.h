@@ -211,6 +211,7 @@ struct HdmiCntlr {
     struct HdmiInfoFrame infoFrame;
     struct HdmiScdc *scdc;
     struct HdmiDdc ddc;
+    struct HdmiEdidCache edidCache;
     struct HdmiFrl *frl;
     struct HdmiHdcp *hdcp;
     struct HdmiCec *cec;
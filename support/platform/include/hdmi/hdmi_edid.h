@@ -616,6 +616,16 @@ struct HdmiSinkDeviceCapability {
     struct HdmiEdidVsvdbDolbyCap dolbyCap;
 };
 
+/*
+ * A rarely used data block, phased on first use.
+ * sinkCap.hdrCap and sinkCap.dolbyCap are only valid through HdmiEdidGetHdrCap/HdmiEdidGetDolbyCap.
+ */
+struct HdmiEdidLazyBlock {
+    uint16_t offset;    /* offset of the block payload in raw, 0 if the sink has none. */
+    uint8_t len;
+    bool phased;
+};
+
 /*
  * EDID(Extended Display Identification Data).
  * The Source read the Sink's EDID in order to discover the Sink's configuration and/or capabilities.
@@ -625,6 +635,37 @@ struct HdmiEdid {
     uint32_t rawLen;
     uint8_t raw[HDMI_EDID_TOTAL_SIZE];
     struct HdmiSinkDeviceCapability sinkCap;
+    struct HdmiEdidLazyBlock vsvdb;
+    struct HdmiEdidLazyBlock hdrSmdb;
+};
+
+/* edid cache */
+#define HDMI_EDID_CACHE_NUM 4
+#define HDMI_EDID_CACHE_ID_OFFSET HDMI_EDID_BLOCK_HEADER_FIELD_LEN
+#define HDMI_EDID_CACHE_ID_LEN 10   /* manufacturer, product code, serial number, week and year. */
+#define HDMI_EDID_BLOCKS_PER_SEGMENT 2
+
+/*
+ * A sink is identified by its manufacturer/product fields and the checksum of every block, so the EDID of
+ * a sink seen before is known after reading block0 and one checksum byte per extension block.
+ */
+struct HdmiEdidCacheKey {
+    uint8_t id[HDMI_EDID_CACHE_ID_LEN];
+    uint8_t extBlockNum;
+    uint8_t checkSum[HDMI_EDID_MAX_BLOCK_NUM];
+};
+
+struct HdmiEdidCacheEntry {
+    bool valid;
+    uint32_t lastUse;
+    struct HdmiEdidCacheKey key;
+    struct HdmiEdid edid;
+};
+
+struct HdmiEdidCache {
+    uint32_t useCount;
+    uint32_t hits;
+    struct HdmiEdidCacheEntry entry[HDMI_EDID_CACHE_NUM];
 };
 
 typedef int32_t (*HdmiEdidPhaseFunc)(struct HdmiEdid *edid);
@@ -633,6 +674,9 @@ int32_t HdmiEdidReset(struct HdmiEdid *edid);
 int32_t HdmiEdidPhase(struct HdmiEdid *edid);
 int32_t HdmiEdidGetRaw(struct HdmiEdid *edid, uint8_t *raw, uint32_t len);
 int32_t HdmiEdidRawDataRead(struct HdmiEdid *edid, struct HdmiDdc *ddc);
+int32_t HdmiEdidCachedRead(struct HdmiEdid *edid, struct HdmiDdc *ddc, struct HdmiEdidCache *cache);
+struct HdmiEdidHdrCap *HdmiEdidGetHdrCap(struct HdmiEdid *edid);
+struct HdmiEdidVsvdbDolbyCap *HdmiEdidGetDolbyCap(struct HdmiEdid *edid);
 
 #ifdef __cplusplus
 #if __cplusplus
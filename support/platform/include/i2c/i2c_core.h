@@ -10,8 +10,9 @@
 #define I2C_CORE_H
 
 #include "hdf_base.h"
+#include "hdf_dlist.h"
 #include "i2c_if.h"
-#include "osal_mutex.h"
+#include "platform_arbiter.h"
 #include "platform_core.h"
 
 #ifdef __cplusplus
@@ -25,14 +26,52 @@ extern "C" {
 struct I2cCntlr;
 struct I2cMethod;
 struct I2cLockMethod;
+struct I2cTransferQueue;
 
 struct I2cCntlr {
-    struct OsalMutex lock;
+    struct PlatformArbiter arbiter;  /* serves the callers by priority, used by the default lock methods */
     void *owner;
     int16_t busId;
     void *priv;
     const struct I2cMethod *ops;
     const struct I2cLockMethod *lockOps;
+    struct I2cTransferQueue *queue;  /* created on the first asynchronous transfer */
+    bool removed;                    /* set under the manager lock on removing, the queue is not created again */
+    uint8_t *stageBuf;               /* reused for the read msgs from user space, under the controller lock */
+    uint32_t stageSize;
+};
+
+struct I2cTransfer;
+typedef void (*I2cTransferCallback)(struct I2cTransfer *xfer);
+
+/**
+ * @brief Defines an asynchronous I2C transfer.
+ *
+ * The transfer and its messages are owned by the controller from submitting until the callback is called.
+ *
+ * @since 1.0
+ */
+struct I2cTransfer {
+    struct DListHead node;
+    struct I2cMsg *msgs;
+    int16_t count;
+    int32_t result;                 /* number of messages transferred, or a negative value on failure */
+    I2cTransferCallback callback;   /* called in the queue thread, without the controller lock held */
+    void *priv;
+    uint64_t submitTime;            /* monotonic time in microseconds */
+};
+
+/**
+ * @brief Defines the statistics of the asynchronous transfer queue of an I2C controller.
+ *
+ * @since 1.0
+ */
+struct I2cQueueStat {
+    uint32_t depth;           /* transfers waiting for dispatching */
+    uint32_t depthMax;        /* the max depth ever reached */
+    uint32_t completed;
+    uint32_t latencyLastUs;   /* from submitting to dispatching, of the last transfer */
+    uint32_t latencyMaxUs;
 };
 
 struct I2cMethod {
@@ -123,6 +162,62 @@ void I2cCntlrPut(struct I2cCntlr *cntlr);
  */
 int32_t I2cCntlrTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count);
 
+/**
+ * @brief Execute one or more I2C messages at the priority of the caller.
+ *
+ * Callers waiting for the controller are served by priority. The messages go to the driver at once, unless a
+ * caller of higher priority is waiting: then they are split after each message with I2C_FLAG_STOP and the
+ * controller is handed over in between. A controller with custom lock methods transfers all the messages at
+ * once and ignores the priority.
+ *
+ * @param cntlr Indicates the I2C controller device.
+ * @param msgs Indicates the {@link I2cMsg} message array.
+ * @param count Indicates the length of the message array.
+ * @param prio Indicates the priority of the caller, see {@link PlatformPriority}.
+ *
+ * @return Returns the number of transferred message structures if the operation is successful;
+ * returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I2cCntlrTransferPrio(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count, uint32_t prio);
+
+/**
+ * @brief Submit I2C messages to the queue of the controller and return immediately.
+ *
+ * Transfers of a controller are dispatched in submitting order by a queue thread, which takes the controller
+ * lock once for several back-to-back transfers. The callback of the transfer is called on completion, with
+ * result set as {@link I2cCntlrTransfer} returns.
+ *
+ * @param cntlr Indicates the I2C controller device.
+ * @param xfer Indicates the transfer to submit, msgs, count and callback must be set.
+ *
+ * @return Returns 0 if the transfer is queued; returns a negative value otherwise, and the callback won't be called.
+ * @since 1.0
+ */
+int32_t I2cCntlrTransferAsync(struct I2cCntlr *cntlr, struct I2cTransfer *xfer);
+
+/**
+ * @brief Get the statistics of the asynchronous transfer queue of an I2C controller.
+ *
+ * @param cntlr Indicates the I2C controller device.
+ * @param stat Indicates the pointer to receive the statistics.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I2cCntlrGetQueueStat(struct I2cCntlr *cntlr, struct I2cQueueStat *stat);
+
+/**
+ * @brief Get the statistics of the time the callers waited for an I2C controller, per priority.
+ *
+ * @param cntlr Indicates the I2C controller device.
+ * @param stat Indicates the pointer to receive the statistics.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I2cCntlrGetArbiterStat(struct I2cCntlr *cntlr, struct PlatformArbiterStat *stat);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
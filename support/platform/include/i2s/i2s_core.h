@@ -14,9 +14,12 @@
 #include "hdf_dlist.h"
 #include "i2s_if.h"
 #include "osal_mutex.h"
-
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "osal_thread.h"
 
 struct I2sCntlr;
+struct I2sStream;
 
 struct I2sCntlrMethod {
     int32_t (*GetCfg)(struct I2sCntlr *, struct I2sCfg *);
@@ -30,6 +33,36 @@ struct I2sCntlrMethod {
     int32_t (*StopWrite)(struct I2sCntlr *);
     int32_t (*StartRead)(struct I2sCntlr *);
     int32_t (*StopRead)(struct I2sCntlr *);
+    /* optional: run the ring cyclically and call I2sCntlrStreamPeriodElapsed once per period */
+    int32_t (*StartStream)(struct I2sCntlr *, enum I2sStreamDir, struct I2sStream *);
+    int32_t (*StopStream)(struct I2sCntlr *, enum I2sStreamDir);
+};
+
+/*
+ * hwPtr and applPtr count bytes since the stream was set up and never wrap, the ring offset is
+ * their value modulo bufferSize. The controller owns the period at hwPtr, the user side the rest.
+ * Controllers without StartStream are serviced by a core thread issuing Transfer period by period.
+ * The user side accesses a stream with the controller lock held, so it isn't freed or moved under it.
+ */
+struct I2sStream {
+    struct I2sCntlr *cntlr;
+    enum I2sStreamDir dir;
+    uint8_t *buffer;
+    uint32_t periodSize;
+    uint32_t periodCount;
+    uint32_t bufferSize;
+    uint64_t hwPtr;
+    uint64_t applPtr;
+    uint64_t periods;
+    uint32_t xruns;
+    I2sPeriodNotify notify;
+    void *priv;
+    OsalSpinlock spin;
+    volatile bool running;
+    bool stopping;          /* the controller lock is dropped to join the pump, keep the stream in place */
+    bool soft;
+    struct OsalThread thread;
+    struct OsalSem exitSem;
 };
 
 struct I2sCntlr {
@@ -39,6 +72,7 @@ struct I2sCntlr {
     uint32_t irqNum;
     struct OsalMutex lock;
     struct I2sCntlrMethod *method;
+    struct I2sStream *stream[I2S_STREAM_DIR_MAX];
     void *priv; // private data
 };
 
@@ -68,4 +102,19 @@ int32_t I2sCntlrDisable(struct I2sCntlr *cntlr);
 int32_t I2sCntlrSetCfg(struct I2sCntlr *cntlr, struct I2sCfg *cfg);
 int32_t I2sCntlrGetCfg(struct I2sCntlr *cntlr, struct I2sCfg *cfg);
 int32_t I2sCntlrTransfer(struct I2sCntlr *cntlr, struct I2sMsg *msg);
+int32_t I2sCntlrSetStream(struct I2sCntlr *cntlr, enum I2sStreamDir dir, const struct I2sStreamCfg *cfg);
+int32_t I2sCntlrStreamRead(struct I2sCntlr *cntlr, uint8_t *buf, uint32_t len, uint32_t *pRlen);
+int32_t I2sCntlrStreamWrite(struct I2sCntlr *cntlr, const uint8_t *buf, uint32_t len, uint32_t *pWlen);
+int32_t I2sCntlrGetStreamStat(struct I2sCntlr *cntlr, enum I2sStreamDir dir, struct I2sStreamStat *stat);
+
+/**
+ * @brief Reports that the controller completed the period at the stream's hardware pointer.
+ *
+ * Called by controller drivers, typically from the dma interrupt, once per period of a running stream.
+ *
+ * @param cntlr Indicates the I2S controller.
+ * @param dir Indicates the stream direction.
+ * @since 1.0
+ */
+void I2sCntlrStreamPeriodElapsed(struct I2sCntlr *cntlr, enum I2sStreamDir dir);
 #endif /* I2S_CORE_H */
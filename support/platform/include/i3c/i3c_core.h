@@ -13,7 +13,9 @@
 #include "hdf_base.h"
 #include "hdf_dlist.h"
 #include "osal_spinlock.h"
+#include "platform_arbiter.h"
 #include "platform_core.h"
+#include "platform_queue.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -24,6 +26,7 @@ extern "C" {
 #define I3C_CNTLR_MAX   20
 #define I3C_ADDR_MAX             127
 #define I3C_IBI_MAX              10
+#define I3C_IBI_SLOT_NUM         4
 #define ADDRS_STATUS_BITS        2
 #define BITS_PER_UINT16          16
 #define ADDRS_PER_UINT16         8
@@ -68,12 +71,16 @@ enum I3cDeviceType {
 };
 
 struct I3cCntlr {
-    OsalSpinlock lock;
+    struct PlatformArbiter arbiter;  /* taken by the default lock methods, serving the callers by priority */
     void *owner;
     int16_t busId;
     struct I3cConfig config;
     uint16_t addrSlot[(I3C_ADDR_MAX + 1) / ADDRS_PER_UINT16];
-    struct I3cIbiInfo *ibiSlot[I3C_IBI_MAX];
+    struct I3cDevice *devices[I3C_ADDR_MAX + 1];   /* lookup cache, indexed by dynamic or static address */
+    struct I3cIbiInfo *ibiSlot[I3C_ADDR_MAX + 1];  /* indexed by the address the IBI was requested for */
+    uint16_t ibiNum;
+    OsalSpinlock ibiLock;                          /* irq safe, guards device->ibi against the IBI callback */
+    struct PlatformQueue *ibiQueue;
     const struct I3cMethod *ops;
     const struct I3cLockMethod *lockOps;
     void *priv;
@@ -86,11 +93,31 @@ struct I3cVendor {
     uint32_t vendorProductId;
 };
 
-/* In-bind Interrupt infomation */
+/* One preallocated IBI payload, queued to the dispatch thread once the controller has filled it */
+struct I3cIbiSlot {
+    struct PlatformMsg msg;
+    uint8_t *data;
+};
+
+/*
+ * In-bind Interrupt infomation
+ *
+ * The controller fills data with the payload and then calls I3cCntlrIbiCallback, which hands the slot
+ * to the dispatch thread and points data at the next free slot. data is NULL while every slot is still
+ * waiting for its handler, IBIs arriving then are counted in dropped.
+ */
 struct I3cIbiInfo {
     I3cIbiFunc ibiFunc;
     uint32_t payload;
     uint8_t *data;
+    struct I3cDevice *device;
+    OsalSpinlock lock;
+    uint16_t cur;
+    uint16_t busyMask;
+    bool stopping;
+    uint32_t dropped;
+    uint8_t *buffer;
+    struct I3cIbiSlot slots[I3C_IBI_SLOT_NUM];
 };
 
 struct I3cDevice {
@@ -259,6 +286,19 @@ int32_t I3cCntlrSetConfig(struct I3cCntlr *cntlr, struct I3cConfig *config);
  */
 int32_t I3cCntlrGetConfig(struct I3cCntlr *cntlr, struct I3cConfig *config);
 
+/**
+ * @brief Get the statistics of the time the callers waited for an I3C controller, per priority.
+ *
+ * Only a controller with the default lock methods keeps them.
+ *
+ * @param cntlr Indicates the I3C controller device.
+ * @param stat Indicates the pointer to receive the statistics.
+ *
+ * @return Returns <b>0</b> on success; Returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t I3cCntlrGetArbiterStat(struct I3cCntlr *cntlr, struct PlatformArbiterStat *stat);
+
 /**
  * @brief Requeset an IBI(in-bind interrupt) for an I3C device which is supported.
  *
@@ -396,6 +436,10 @@ struct I3cDevice *GetDeviceByAddr(struct I3cCntlr *cntlr, uint16_t addr);
 /**
  * @brief IBI(In-bind Interrupt) callback function.
  *
+ * Safe to call from interrupt context: it neither allocates nor sleeps, only irq safe spinlocks are taken,
+ * and the user's handler is invoked later from the controller's IBI dispatch thread.
+ * The controller driver must not call it any more once its freeIbi method has returned.
+ *
  * @param device Indicates the device that generated the IBI.
  *
  * @return Returns an I3C device object on success; Returns <b>NULL</b> otherwise.
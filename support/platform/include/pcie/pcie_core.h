@@ -11,7 +11,10 @@
 
 #include "hdf_base.h"
 #include "hdf_device_desc.h"
-#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "pcie_if.h"
+#include "platform_arbiter.h"
 #include "platform_core.h"
 
 #ifdef __cplusplus
@@ -20,11 +23,25 @@ extern "C" {
 #endif
 #endif /* __cplusplus */
 
+#define PCIE_DMA_TIMEOUT_MS 5000
+
 struct PcieCntlr;
 
+/*
+ * mapBar/unmapBar, dmaTransfer and dmaAbort are optional.
+ * dmaTransfer only starts the transfer, the driver reports its end through PcieCntlrDmaDone,
+ * which may be called from interrupt context or even before dmaTransfer returns.
+ * dmaAbort stops the transfer in flight; once it returns the engine no longer touches the buffer and
+ * PcieCntlrDmaDone is not called for that transfer. Without it a waiting transfer which times out
+ * keeps waiting for its completion, as only then the buffer can be handed back to the caller.
+ */
 struct PcieCntlrOps {
     int32_t (*read)(struct PcieCntlr *cntlr, uint32_t pos, uint8_t *data, uint32_t len);
     int32_t (*write)(struct PcieCntlr *cntlr, uint32_t pos, uint8_t *data, uint32_t len);
+    int32_t (*mapBar)(struct PcieCntlr *cntlr, uint32_t bar, volatile uint8_t **addr, uint32_t *size);
+    void (*unmapBar)(struct PcieCntlr *cntlr, uint32_t bar, volatile uint8_t *addr);
+    int32_t (*dmaTransfer)(struct PcieCntlr *cntlr, const struct PcieDmaXfer *xfer);
+    void (*dmaAbort)(struct PcieCntlr *cntlr);
 };
 
 struct PcieDevCfgInfo {
@@ -33,27 +50,38 @@ struct PcieDevCfgInfo {
     uint32_t devId;
 };
 
+struct PcieBarMap {
+    volatile uint8_t *addr;
+    uint32_t size;
+    uint32_t refCount;
+};
+
 struct PcieCntlr {
     struct IDeviceIoService service;
     struct HdfDeviceObject *hdfDevObj;
     struct PlatformDevice device;
-    struct OsalMutex mutex;
+    struct PlatformArbiter arbiter;       /* guards the config and bar accesses, serving the callers by priority */
     struct PcieCntlrOps *ops;
     struct PcieDevCfgInfo devInfo;
+    struct PcieBarMap bars[PCIE_BAR_NUM];
+    OsalSpinlock dmaSpin;
+    const struct PcieDmaXfer *dmaXfer;    /* the transfer in flight, NULL when the dma engine is idle */
+    struct OsalSem dmaSem;
+    int32_t dmaStatus;
     void *priv;
 };
 
 static inline void PcieCntlrLock(struct PcieCntlr *cntlr)
 {
     if (cntlr != NULL) {
-        (void)OsalMutexLock(&cntlr->mutex);
+        (void)PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
     }
 }
 
 static inline void PcieCntlrUnlock(struct PcieCntlr *cntlr)
 {
     if (cntlr != NULL) {
-        (void)OsalMutexUnlock(&cntlr->mutex);
+        PlatformArbiterRelease(&cntlr->arbiter);
     }
 }
 
@@ -73,6 +101,11 @@ void PcieCntlrRemove(struct PcieCntlr *cntlr);
 
 int32_t PcieCntlrRead(struct PcieCntlr *cntlr, uint32_t pos, uint8_t *data, uint32_t len);
 int32_t PcieCntlrWrite(struct PcieCntlr *cntlr, uint32_t pos, uint8_t *data, uint32_t len);
+int32_t PcieCntlrMapBar(struct PcieCntlr *cntlr, uint32_t bar, volatile uint8_t **addr, uint32_t *size);
+void PcieCntlrUnmapBar(struct PcieCntlr *cntlr, uint32_t bar);
+int32_t PcieCntlrDmaTransfer(struct PcieCntlr *cntlr, const struct PcieDmaXfer *xfer);
+void PcieCntlrDmaDone(struct PcieCntlr *cntlr, int32_t status);
+int32_t PcieCntlrGetArbiterStat(struct PcieCntlr *cntlr, struct PlatformArbiterStat *stat);
 
 #ifdef __cplusplus
 #if __cplusplus
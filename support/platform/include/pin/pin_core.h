@@ -28,6 +28,8 @@ struct PinDesc;
 struct PinDesc {
     const char *pinName;
     void *priv;
+    struct DListHead hashNode;    /* filled in by PinCntlrAdd */
+    struct PinCntlr *cntlr;       /* filled in by PinCntlrAdd */
 };
 
 struct PinCntlr {
@@ -75,6 +77,8 @@ int32_t PinCntlrSetPinFunc(struct PinCntlr *cntlr, struct PinDesc *desc, const c
 
 int32_t PinCntlrGetPinFunc(struct PinCntlr *cntlr, struct PinDesc *desc, const char **funcName);
 
+int32_t PinCntlrSetPinCfgBatch(const struct PinCfg *cfgs, uint32_t count);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
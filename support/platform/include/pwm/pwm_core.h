@@ -22,11 +22,18 @@ extern "C" {
 
 struct PwmMethod;
 struct PwmDev;
+struct PwmUserClient;
 
 struct PwmMethod {
     int32_t (*setConfig)(struct PwmDev *pwm, struct PwmConfig *config);
     int32_t (*open)(struct PwmDev *pwm);
     int32_t (*close)(struct PwmDev *pwm);
+    /*
+     * Optional. Writes the configs into the shadow registers of all channels and latches them on one period
+     * boundary. Returns HDF_ERR_NOT_SUPPORT to fall back to per channel setConfig, e.g. if the channels
+     * are on different controllers.
+     */
+    int32_t (*setConfigGroup)(struct PwmDev **pwms, struct PwmConfig *configs, uint32_t count);
 };
 
 struct PwmDev {
@@ -35,6 +42,8 @@ struct PwmDev {
     struct PwmConfig cfg;
     struct PwmMethod *method;
     bool busy;
+    struct PwmUserClient *owner;    /* the user space client that opened the device, NULL if none */
+    uint32_t openSeq;               /* counts the user space opens, tells a current open from an earlier one */
     uint32_t num;
     OsalSpinlock lock;
     void *priv;
@@ -44,6 +53,7 @@ int32_t PwmDeviceGet(struct PwmDev *pwm);
 int32_t PwmDevicePut(struct PwmDev *pwm);
 int32_t PwmDeviceSetConfig(struct PwmDev *pwm, struct PwmConfig *config);
 int32_t PwmDeviceGetConfig(struct PwmDev *pwm, struct PwmConfig *config);
+int32_t PwmDeviceSetConfigGroup(struct PwmDev **pwms, struct PwmConfig *configs, uint32_t count);
 void *PwmGetPriv(struct PwmDev *pwm);
 int32_t PwmSetPriv(struct PwmDev *pwm, void *priv);
 int32_t PwmDeviceAdd(struct HdfDeviceObject *obj, struct PwmDev *pwm);
@@ -12,6 +12,7 @@
 #include "hdf_base.h"
 #include "hdf_device_desc.h"
 #include "osal_mutex.h"
+#include "platform_core.h"
 #include "regulator_if.h"
 
 
@@ -55,6 +56,14 @@ dprintf("[HDF]-[REGULATOR]:[%s][%d]---" fmt "\r\n", __func__, __LINE__, ##arg)
     } \
 } while (0)
 
+#define REGULATOR_HASH_BUCKETS 32
+
+/* the node and tree indexes are both keyed by the regulator name */
+static inline uint32_t RegulatorNameHash(const char *name)
+{
+    return PlatformNameHash(name) % REGULATOR_HASH_BUCKETS;
+}
+
 struct RegulatorStatusChangeInfo {
     const char *name;
     uint32_t status;
@@ -91,6 +100,7 @@ struct RegulatorDesc {
 struct RegulatorNode {
     struct RegulatorDesc regulatorInfo;
     struct DListHead node;
+    struct DListHead hashNode;       /* link in the manager's name index */
     struct RegulatorMethod *ops;
     void *priv;
     struct OsalMutex lock;
@@ -194,6 +204,13 @@ int32_t RegulatorNodeGetStatus(struct RegulatorNode *node, uint32_t *status);
  */
 int32_t RegulatorNodeRegisterStatusChangeCb(struct RegulatorNode *node, RegulatorStatusChangecb cb);
 int32_t RegulatorNodeStatusCb(struct RegulatorNode *node);
+/**
+ * @brief apply a batch of enable/disable/voltage/current steps in supply order under one tree lock
+ * @param steps the steps, see {@link RegulatorBatchApply}
+ * @param count number of steps
+ * @return success or fail
+ */
+int32_t RegulatorNodeBatchApply(struct RegulatorBatchStep *steps, uint32_t count);
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -29,11 +29,15 @@ struct RegulatorTreeInfo {
     const char *name;                  /* regulator name */
     struct RegulatorNode *parent;    /* regulator parent info */
     struct DListHead node;
+    struct DListHead hashNode;       /* link in the manager's name index */
     struct DListHead childHead;      /* next level child regulator list */
 };
 
+#define REGULATOR_TREE_DEPTH_MAX 32
+
 struct RegulatorTreeManager {
     struct DListHead treeMgrHead;
+    struct DListHead hashHead[REGULATOR_HASH_BUCKETS];
     struct OsalMutex lock;
 };
 
@@ -49,6 +53,17 @@ bool RegulatorTreeIsChildAlwayson(const char *name);
 bool RegulatorTreeIsChildStatusOn(const char *name);
 bool RegulatorTreeIsUpNodeComplete(const char *name);
 
+/*
+ * The *Locked helpers expect the caller to hold the tree lock, so a chain of lookups (a whole enable
+ * walking up the supply chain, or a batch) costs one lock acquisition. Lock order: tree, then node.
+ */
+int32_t RegulatorTreeLock(void);
+void RegulatorTreeUnlock(void);
+struct RegulatorNode *RegulatorTreeGetParentLocked(const char *name);
+bool RegulatorTreeIsAllChildDisableLocked(const char *name);
+int32_t RegulatorTreeChildForceDisableLocked(struct RegulatorNode *node);
+uint32_t RegulatorTreeGetDepthLocked(const char *name);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -27,6 +27,7 @@ struct RtcHost {
     struct IDeviceIoService service;
     struct HdfDeviceObject *device;
     struct RtcMethod *method;
+    struct OsalMutex lock;
     void *data;
 };
 
@@ -42,6 +43,10 @@ struct RtcMethod {
     int32_t (*Reset)(struct RtcHost *host);
     int32_t (*ReadReg)(struct RtcHost *host, uint8_t usrDefIndex, uint8_t *value);
     int32_t (*WriteReg)(struct RtcHost *host, uint8_t usrDefIndex, uint8_t value);
+    /* optional, for hardware able to latch the time against a timestamp; bracketed ReadTime otherwise */
+    int32_t (*ReadTimeSync)(struct RtcHost *host, struct RtcTimeSync *sync);
+    /* optional, for hardware able to program several alarms at once; WriteAlarm one by one otherwise */
+    int32_t (*WriteAlarmGroup)(struct RtcHost *host, struct RtcAlarmItem *items, uint32_t count);
 };
 
 struct RtcHost *RtcHostCreate(struct HdfDeviceObject *device);
@@ -74,6 +79,13 @@ int32_t RtcHostReadReg(struct RtcHost *host, uint8_t usrDefIndex, uint8_t *value
 
 int32_t RtcHostWriteReg(struct RtcHost *host, uint8_t usrDefIndex, uint8_t value);
 
+/* the monotonic clock of RtcTimeSync.monoUs */
+uint64_t RtcHostMonoTimeUs(void);
+
+int32_t RtcHostReadTimeSync(struct RtcHost *host, struct RtcTimeSync *sync);
+
+int32_t RtcHostWriteAlarmGroup(struct RtcHost *host, struct RtcAlarmItem *items, uint32_t count);
+
 int32_t RtcIoDispatch(struct HdfDeviceIoClient *client, int cmd, struct HdfSBuf *data, struct HdfSBuf *reply);
 
 #ifdef __cplusplus
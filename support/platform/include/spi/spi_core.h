@@ -13,7 +13,12 @@
 #include "hdf_device_desc.h"
 #include "hdf_dlist.h"
 #include "spi_if.h"
+#include "osal_atomic.h"
 #include "osal_mutex.h"
+#include "platform_arbiter.h"
+#include "platform_queue.h"
+
+#define SPI_QUEUE_NAME_LEN 32
 
 struct SpiCntlr;
 struct SpiCntlrMethod;
@@ -22,6 +27,8 @@ struct SpiCntlrMethod {
     int32_t (*GetCfg)(struct SpiCntlr *, struct SpiCfg *);
     int32_t (*SetCfg)(struct SpiCntlr *, struct SpiCfg *);
     int32_t (*Transfer)(struct SpiCntlr *, struct SpiMsg *, uint32_t);
+    /* optional, for controllers that can chain the segments into one dma transfer */
+    int32_t (*TransferSg)(struct SpiCntlr *, struct SpiSgMsg *, uint32_t);
     int32_t (*Open)(struct SpiCntlr *);
     int32_t (*Close)(struct SpiCntlr *);
 };
@@ -32,10 +39,27 @@ struct SpiCntlr {
     uint32_t busNum;
     uint32_t numCs;
     uint32_t curCs;
-    struct OsalMutex lock;
+    struct PlatformArbiter arbiter; /* serializes the methods, serving the callers by priority */
+    struct OsalMutex lock;          /* guards stopping and the creation of the queue */
     struct SpiCntlrMethod *method;
     struct DListHead list;
     void *priv;
+    struct PlatformQueue *queue; /* created on the first asynchronous transfer */
+    char queueName[SPI_QUEUE_NAME_LEN];
+    OsalAtomic pending;
+    bool stopping;
+    struct SpiMsg *sgMsgs;       /* scratch for running scatter-gather msgs on Transfer, under arbiter */
+    uint32_t sgMsgNum;
+};
+
+struct SpiTransferReq {
+    struct PlatformMsg msg;
+    struct SpiCntlr *cntlr;
+    uint32_t csNum;
+    struct SpiSgMsg *msgs;
+    uint32_t count;
+    SpiTransferCallback callback;
+    void *priv;
 };
 
 struct SpiDev {
@@ -76,6 +100,46 @@ static inline struct SpiCntlr *SpiCntlrFromDevice(struct HdfDeviceObject *device
 }
 
 int32_t SpiCntlrTransfer(struct SpiCntlr *, uint32_t, struct SpiMsg *, uint32_t);
+
+/**
+ * @brief Run msgs on the SPI cntlr at the priority of the caller.
+ *
+ * Callers waiting for the cntlr are served by priority. The msgs go to the driver at once, unless a caller of
+ * higher priority is waiting: then they are split after each msg with csChange set and the cntlr is handed
+ * over in between.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise, the segments after the failed one are not run.
+ * @since 1.0
+ */
+int32_t SpiCntlrTransferPrio(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiMsg *msgs, uint32_t count,
+    uint32_t prio);
+
+/**
+ * @brief Get the statistics of the time the callers waited for the SPI cntlr, per priority.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t SpiCntlrGetArbiterStat(struct SpiCntlr *cntlr, struct PlatformArbiterStat *stat);
+
+/**
+ * @brief Run scatter-gather msgs on the SPI cntlr.
+ *
+ * Uses the TransferSg method if the cntlr has one, otherwise the segments are run as plain msgs on Transfer.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t SpiCntlrTransferSg(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiSgMsg *msgs, uint32_t count);
+
+/**
+ * @brief Queue scatter-gather msgs to the transfer thread of the SPI cntlr.
+ *
+ * @return Returns 0 if queued, and the callback will be called exactly once; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t SpiCntlrTransferAsync(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiSgMsg *msgs, uint32_t count,
+    SpiTransferCallback callback, void *priv);
 int32_t SpiCntlrSetCfg(struct SpiCntlr *, uint32_t, struct SpiCfg *);
 int32_t SpiCntlrGetCfg(struct SpiCntlr *, uint32_t, struct SpiCfg *);
 int32_t SpiCntlrOpen(struct SpiCntlr *, uint32_t);
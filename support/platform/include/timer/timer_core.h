@@ -12,6 +12,8 @@
 #include "hdf_base.h"
 #include "hdf_device_desc.h"
 #include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
 #include "timer_if.h"
 
 #ifdef __cplusplus
@@ -48,12 +50,31 @@ struct TimerInfo {
     bool isPeriod;
 };
 
+/*
+ * Expirations seen by the core. TimerHandleCb carries no context, so the core hands the driver one of a
+ * fixed set of per-slot callbacks; a controller added when all slots are taken gets the client callback
+ * directly and can not be waited on.
+ */
+#define TIMER_EVENT_SLOT_NUM 16
+
+struct TimerEventChan {
+    OsalSpinlock spin;
+    struct OsalSem sem;
+    uint32_t pending;            /* expirations not taken by a waiter yet */
+    uint64_t lastUs;             /* time of the latest expiration */
+    bool waiting;
+    TimerHandleCb clientCb;      /* kernel client callback, NULL for user space clients */
+    int16_t slot;                /* callback slot, -1 if none */
+};
+
 struct TimerCntrl {
     struct TimerInfo info;
     struct DListHead node;
+    struct DListHead hashNode;
     struct TimerCntrlMethod *ops;
     void *priv;
     struct OsalMutex lock;
+    struct TimerEventChan event;
 };
 
 struct TimerCntrlMethod {
@@ -124,6 +145,15 @@ int32_t TimerCntrlSetOnce(struct TimerCntrl *cntrl, uint32_t useconds, TimerHand
  */
 int32_t TimerCntrlGet(struct TimerCntrl *cntrl, uint32_t *useconds, bool *isPeriod);
 
+/**
+ * @brief wait for the expirations of a timer controller, one waiter at a time
+ * @param cntrl Indicates a timer controller.
+ * @param timeoutMs Indicates the time to wait in ms.
+ * @param event Returns the number of expirations since the previous wait and the time of the latest.
+ * @return success, HDF_ERR_TIMEOUT, or fail
+ */
+int32_t TimerCntrlWaitEvent(struct TimerCntrl *cntrl, uint32_t timeoutMs, struct TimerEvent *event);
+
 /**
  * @brief start a timer controller
  * @param cntrl Indicates a timer controller.
@@ -13,12 +13,38 @@
 #include "hdf_device_desc.h"
 #include "hdf_sbuf.h"
 #include "osal_atomic.h"
+#include "osal_sem.h"
 #include "uart_if.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+struct UartHost;
+
+typedef void (*UartRxNotify)(struct UartHost *host, void *priv);
+
+/*
+ * Receive ring of a uart host, modeled on the power-of-two BufferFifo of the uart sample.
+ * The interrupt or dma side is the only producer and the reader of the host is the only consumer,
+ * so the positions run free and are masked on access, and no lock is taken on either side.
+ * A blocked reader is woken by new data, by switching to UART_MODE_RD_NONBLOCK and by closing the host.
+ */
+struct UartRxRing {
+    volatile uint32_t readPosition;
+    volatile uint32_t writePosition;
+    uint32_t sizeMask;
+    uint8_t *buffer;
+    OsalAtomic sync;        /* value returning operations on it are used as full barriers */
+    OsalAtomic waiting;     /* a reader is blocked on sem */
+    struct OsalSem sem;
+    volatile bool block;
+    volatile bool stopped;  /* the host is closed or the ring removed, readers don't block */
+    UartRxNotify notify;    /* readiness hook, e.g. wakes the poll waiters of a vendor driver */
+    void *notifyPriv;
+    struct UartRxStat stat;
+};
+
 /**
  * @brief uart device operations.
  */
@@ -29,6 +55,8 @@ struct UartHost {
     OsalAtomic atom;
     void *priv;
     struct UartHostMethod *method;
+    struct UartRxRing *rxRing;
+    OsalAtomic rxUsers;     /* readers of rxRing, waited for before the ring is removed */
 };
 
 struct UartHostMethod {
@@ -77,8 +105,82 @@ int32_t UartHostInit(struct UartHost *host);
 
 int32_t UartHostDeinit(struct UartHost *host);
 
+/**
+ * @brief Let the core buffer the received data of the host in a ring.
+ *
+ * Called by a vendor driver before it starts receiving. Once the ring is set up, UartHostRead is served from
+ * the ring and the driver fills it with {@link UartHostRxPush}, or {@link UartHostRxPrepare} and
+ * {@link UartHostRxCommit} for dma, instead of implementing Read.
+ *
+ * @param host Indicates the Uart host device.
+ * @param size Indicates the ring size, must be a power of two.
+ *
+ * @return Returns 0 on success; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t UartHostRxRingInit(struct UartHost *host, uint32_t size);
+
+/**
+ * @brief Remove the receive ring, after the driver stopped filling it.
+ *
+ * A reader blocked on the ring is woken up, and the ring is freed once the readers left it.
+ * @since 1.0
+ */
+void UartHostRxRingDeinit(struct UartHost *host);
+
+/**
+ * @brief Register the hook called when data arrives in the receive ring.
+ *
+ * The hook is called in the context of the producer, so it must not sleep.
+ * @since 1.0
+ */
+void UartHostRxSetNotify(struct UartHost *host, UartRxNotify notify, void *priv);
+
+/**
+ * @brief Put received data into the ring, for the interrupt side.
+ *
+ * @return Returns the number of bytes put in, the rest is counted as overrun.
+ * @since 1.0
+ */
+uint32_t UartHostRxPush(struct UartHost *host, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Get the contiguous free space of the ring, for a dma transfer to fill in place.
+ *
+ * @return Returns the number of bytes can be filled at *buf.
+ * @since 1.0
+ */
+uint32_t UartHostRxPrepare(struct UartHost *host, uint8_t **buf);
+
+/**
+ * @brief Publish size bytes filled at the buffer returned by UartHostRxPrepare, and wake up the reader.
+ * @since 1.0
+ */
+void UartHostRxCommit(struct UartHost *host, uint32_t size);
+
+/**
+ * @brief Get the number of bytes can be read from the ring without blocking, e.g. for pollEvent.
+ * @since 1.0
+ */
+uint32_t UartHostRxReadable(struct UartHost *host);
+
+int32_t UartHostRxRingRead(struct UartHost *host, uint8_t *data, uint32_t size);
+
+/**
+ * @brief Switch the reader of the receive ring between blocking and not, waking it up if it's blocked.
+ *
+ * @return Returns true if the host has a receive ring; returns false otherwise.
+ * @since 1.0
+ */
+bool UartHostRxSetBlock(struct UartHost *host, bool block);
+
+int32_t UartHostGetRxStat(struct UartHost *host, struct UartRxStat *stat);
+
 static inline int32_t UartHostRead(struct UartHost *host, uint8_t *data, uint32_t size)
 {
+    if (host != NULL && host->rxRing != NULL) {
+        return UartHostRxRingRead(host, data, size);
+    }
     if (host == NULL || host->method == NULL || host->method->Read == NULL) {
         return HDF_ERR_NOT_SUPPORT;
     }
@@ -127,6 +229,12 @@ static inline int32_t UartHostSetAttribute(struct UartHost *host, struct UartAtt
 
 static inline int32_t UartHostSetTransMode(struct UartHost *host, enum UartTransMode mode)
 {
+    if ((mode == UART_MODE_RD_BLOCK || mode == UART_MODE_RD_NONBLOCK) &&
+        UartHostRxSetBlock(host, mode == UART_MODE_RD_BLOCK)) {
+        if (host->method == NULL || host->method->SetTransMode == NULL) {
+            return HDF_SUCCESS;
+        }
+    }
     if (host == NULL || host->method == NULL || host->method->SetTransMode == NULL) {
         return HDF_ERR_NOT_SUPPORT;
     }
@@ -13,11 +13,18 @@
 #include "osal_spinlock.h"
 #include "osal_time.h"
 #include "platform_core.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG adc_core_c
 #define LOCK_WAIT_SECONDS_M 1
 #define ADC_BUFF_SIZE 4
 
+#define ADC_SCAN_FRAME_MAX      65536
+#define ADC_SCAN_SOFT_RATE_MAX  1000
+#define ADC_SCAN_THREAD_STACK   (1024 * 16)
+#define ADC_US_PER_SECOND       1000000
+#define ADC_SCAN_DRAIN_WAIT_MS  1
+
 #define ADC_HANDLE_SHIFT    0xFF00U
 
 struct AdcManager {
@@ -260,9 +267,16 @@ int32_t AdcDeviceAdd(struct AdcDevice *device)
         HDF_LOGE("%s: init lock failed", __func__);
         return HDF_FAILURE;
     }
+    if (OsalMutexInit(&device->scanLock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init scan lock failed", __func__);
+        (void)OsalSpinDestroy(&device->spin);
+        return HDF_FAILURE;
+    }
+    OsalAtomicSet(&device->scanUsers, 0);
 
     ret = AdcManagerAddDevice(device);
     if (ret != HDF_SUCCESS) {
+        (void)OsalMutexDestroy(&device->scanLock);
         (void)OsalSpinDestroy(&device->spin);
     }
     return ret;
@@ -273,7 +287,9 @@ void AdcDeviceRemove(struct AdcDevice *device)
     if (device == NULL) {
         return;
     }
+    (void)AdcDeviceScanStop(device);
     AdcManagerRemoveDevice(device);
+    (void)OsalMutexDestroy(&device->scanLock);
     (void)OsalSpinDestroy(&device->spin);
 }
 
@@ -306,6 +322,416 @@ int32_t AdcDeviceRead(struct AdcDevice *device, uint32_t channel, uint32_t *val)
     return ret;
 }
 
+static inline uint32_t AdcScanPeriodUs(const struct AdcScan *scan)
+{
+    return ADC_US_PER_SECOND / scan->cfg.rateHz;
+}
+
+uint64_t AdcScanTimeUs(void)
+{
+    return PlatformMonoTimeUs();
+}
+
+/* pins the ring of the device for a producer, which may run in interrupt context */
+static struct AdcScan *AdcScanGet(struct AdcDevice *device)
+{
+    struct AdcScan *scan = NULL;
+
+    (void)OsalAtomicIncReturn(&device->scanUsers);
+    scan = *(struct AdcScan * volatile *)&device->scan;
+    if (scan == NULL) {
+        (void)OsalAtomicDecReturn(&device->scanUsers);
+    }
+    return scan;
+}
+
+static inline void AdcScanPut(struct AdcDevice *device)
+{
+    (void)OsalAtomicDecReturn(&device->scanUsers);
+}
+
+static bool AdcScanPushFrame(struct AdcScan *scan, const uint32_t *vals, uint64_t timestamp)
+{
+    uint32_t offset;
+
+    if (scan->writePosition - scan->readPosition > scan->sizeMask) {
+        scan->overruns++;
+        return false;
+    }
+    PlatformMemBarrier(&scan->sync);  // the reader has copied the frame out before it moved readPosition
+    offset = scan->writePosition & scan->sizeMask;
+    (void)memcpy_s(scan->vals + offset * scan->chanCnt, scan->chanCnt * sizeof(uint32_t),
+        vals, scan->chanCnt * sizeof(uint32_t));
+    scan->timestamps[offset] = timestamp;
+    PlatformMemBarrier(&scan->sync);  // frame written before it is published
+    scan->writePosition++;
+    return true;
+}
+
+bool AdcDeviceScanPush(struct AdcDevice *device, const uint32_t *vals, uint64_t timestamp)
+{
+    bool ret;
+    struct AdcScan *scan = NULL;
+
+    if (device == NULL || vals == NULL || (scan = AdcScanGet(device)) == NULL) {
+        return false;
+    }
+    ret = AdcScanPushFrame(scan, vals, timestamp);
+    AdcScanPut(device);
+    return ret;
+}
+
+uint32_t AdcDeviceScanPrepare(struct AdcDevice *device, uint32_t **vals)
+{
+    uint32_t size;
+    uint32_t offset;
+    uint32_t space;
+    struct AdcScan *scan = NULL;
+
+    if (device == NULL || vals == NULL || (scan = AdcScanGet(device)) == NULL) {
+        return 0;
+    }
+    size = scan->sizeMask + 1;
+    space = size - (scan->writePosition - scan->readPosition);
+    PlatformMemBarrier(&scan->sync);
+    offset = scan->writePosition & scan->sizeMask;
+    *vals = scan->vals + offset * scan->chanCnt;
+    space = (space < size - offset) ? space : (size - offset);
+    AdcScanPut(device);
+    return space;
+}
+
+void AdcDeviceScanCommit(struct AdcDevice *device, uint32_t frames, uint64_t timestamp)
+{
+    uint32_t i;
+    uint32_t period;
+    struct AdcScan *scan = NULL;
+
+    if (device == NULL || frames == 0 || (scan = AdcScanGet(device)) == NULL) {
+        return;
+    }
+    period = AdcScanPeriodUs(scan);
+    for (i = 0; i < frames; i++) {
+        scan->timestamps[(scan->writePosition + i) & scan->sizeMask] =
+            timestamp - (uint64_t)(frames - 1 - i) * period;
+    }
+    PlatformMemBarrier(&scan->sync);
+    scan->writePosition += frames;
+    AdcScanPut(device);
+}
+
+static int32_t AdcScanSoftThread(void *data)
+{
+    uint32_t ch;
+    uint32_t cnt;
+    uint64_t next;
+    uint64_t now;
+    uint32_t frame[ADC_SCAN_CHANNEL_MAX];
+    struct AdcScan *scan = (struct AdcScan *)data;
+
+    next = AdcScanTimeUs();
+    while (!scan->stopping) {
+        for (ch = 0, cnt = 0; ch < ADC_SCAN_CHANNEL_MAX && cnt < scan->chanCnt; ch++) {
+            if ((scan->cfg.chanMask & (1U << ch)) == 0) {
+                continue;
+            }
+            if (AdcDeviceRead(scan->device, ch, &frame[cnt]) != HDF_SUCCESS) {
+                frame[cnt] = 0;
+            }
+            cnt++;
+        }
+        // the thread owns the ring until it exits, whether it's still published or not
+        (void)AdcScanPushFrame(scan, frame, AdcScanTimeUs());
+
+        next += AdcScanPeriodUs(scan);
+        now = AdcScanTimeUs();
+        if (next > now) {
+            OsalUSleep((uint32_t)(next - now));
+        } else {
+            next = now;  // fell behind, do not burst to catch up
+        }
+    }
+    (void)OsalSemPost(&scan->exitSem);
+    return HDF_SUCCESS;
+}
+
+static int32_t AdcScanSoftStart(struct AdcScan *scan)
+{
+    int32_t ret;
+    struct OsalThreadParam param;
+
+    if (scan->device->ops->read == NULL || scan->cfg.rateHz > ADC_SCAN_SOFT_RATE_MAX) {
+        HDF_LOGE("%s: rate %u not support without scanStart", __func__, scan->cfg.rateHz);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    ret = OsalSemInit(&scan->exitSem, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: init sem fail:%d", __func__, ret);
+        return ret;
+    }
+    scan->stopping = false;
+    ret = OsalThreadCreate(&scan->thread, AdcScanSoftThread, scan);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: create thread fail:%d", __func__, ret);
+        (void)OsalSemDestroy(&scan->exitSem);
+        return ret;
+    }
+    param.name = "adc_scan";
+    param.priority = OSAL_THREAD_PRI_HIGH;
+    param.stackSize = ADC_SCAN_THREAD_STACK;
+    ret = OsalThreadStart(&scan->thread, &param);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start thread fail:%d", __func__, ret);
+        (void)OsalThreadDestroy(&scan->thread);
+        (void)OsalSemDestroy(&scan->exitSem);
+    }
+    return ret;
+}
+
+static void AdcScanSoftStop(struct AdcScan *scan)
+{
+    scan->stopping = true;
+    (void)OsalSemWait(&scan->exitSem, HDF_WAIT_FOREVER);
+    (void)OsalThreadDestroy(&scan->thread);
+    (void)OsalSemDestroy(&scan->exitSem);
+}
+
+static void AdcScanFree(struct AdcScan *scan)
+{
+    if (scan == NULL) {
+        return;
+    }
+    OsalMemFree(scan->vals);
+    OsalMemFree(scan->timestamps);
+    OsalMemFree(scan);
+}
+
+static struct AdcScan *AdcScanCreate(struct AdcDevice *device, const struct AdcScanCfg *cfg)
+{
+    uint32_t ch;
+    uint32_t cnt = 0;
+    struct AdcScan *scan = NULL;
+
+    for (ch = 0; ch < ADC_SCAN_CHANNEL_MAX; ch++) {
+        cnt += (cfg->chanMask >> ch) & 1U;
+    }
+    if (cnt == 0 || (device->chanNum != 0 && device->chanNum < ADC_SCAN_CHANNEL_MAX &&
+        (cfg->chanMask >> device->chanNum) != 0)) {
+        HDF_LOGE("%s: invalid chanMask:0x%x", __func__, cfg->chanMask);
+        return NULL;
+    }
+    if (cfg->rateHz == 0 || cfg->rateHz > ADC_US_PER_SECOND || cfg->frameNum == 0 ||
+        cfg->frameNum > ADC_SCAN_FRAME_MAX || (cfg->frameNum & (cfg->frameNum - 1)) != 0) {
+        HDF_LOGE("%s: invalid rate:%u or frameNum:%u", __func__, cfg->rateHz, cfg->frameNum);
+        return NULL;
+    }
+
+    scan = (struct AdcScan *)OsalMemCalloc(sizeof(*scan));
+    if (scan == NULL) {
+        return NULL;
+    }
+    scan->vals = (uint32_t *)OsalMemCalloc(sizeof(uint32_t) * cnt * cfg->frameNum);
+    scan->timestamps = (uint64_t *)OsalMemCalloc(sizeof(uint64_t) * cfg->frameNum);
+    if (scan->vals == NULL || scan->timestamps == NULL) {
+        HDF_LOGE("%s: alloc ring fail", __func__);
+        AdcScanFree(scan);
+        return NULL;
+    }
+    scan->device = device;
+    scan->cfg = *cfg;
+    scan->chanCnt = cnt;
+    scan->sizeMask = cfg->frameNum - 1;
+    OsalAtomicSet(&scan->sync, 0);
+    return scan;
+}
+
+static int32_t AdcDeviceScanPublish(struct AdcDevice *device, struct AdcScan *scan)
+{
+    if (AdcDeviceLock(device) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    PlatformMemBarrier(&scan->sync);  // ring set up before it is published
+    device->scan = scan;
+    AdcDeviceUnlock(device);
+    return HDF_SUCCESS;
+}
+
+/* takes the ring away from the readers and the producers, and waits for the pinned ones to leave */
+static struct AdcScan *AdcDeviceScanDetach(struct AdcDevice *device)
+{
+    struct AdcScan *scan = NULL;
+
+    if (AdcDeviceLock(device) != HDF_SUCCESS) {
+        return NULL;
+    }
+    scan = device->scan;
+    device->scan = NULL;
+    AdcDeviceUnlock(device);
+    while (scan != NULL && OsalAtomicRead(&device->scanUsers) != 0) {
+        OsalMSleep(ADC_SCAN_DRAIN_WAIT_MS);
+    }
+    return scan;
+}
+
+/* takes over the ring, which is freed here on failure */
+static int32_t AdcDeviceScanStartLocked(struct AdcDevice *device, struct AdcScan *scan)
+{
+    int32_t ret;
+
+    if (device->scan != NULL) {
+        HDF_LOGE("%s: device %u is already scanning", __func__, device->devNum);
+        AdcScanFree(scan);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    if (device->ops->scanStart == NULL) {
+        // the thread gets the ring as its argument, so it's published only once it runs
+        ret = AdcScanSoftStart(scan);
+        if (ret == HDF_SUCCESS && (ret = AdcDeviceScanPublish(device, scan)) != HDF_SUCCESS) {
+            AdcScanSoftStop(scan);
+        }
+        if (ret != HDF_SUCCESS) {
+            AdcScanFree(scan);
+        }
+        return ret;
+    }
+
+    // the driver fills device->scan, so it's published before the driver starts, may sleep to set up the dma
+    ret = AdcDeviceScanPublish(device, scan);
+    if (ret != HDF_SUCCESS) {
+        AdcScanFree(scan);
+        return ret;
+    }
+    ret = device->ops->scanStart(device, &scan->cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start scan fail:%d", __func__, ret);
+        // stopping is serialized by scanLock, so what is detached here is the ring published above
+        AdcScanFree(AdcDeviceScanDetach(device));
+    }
+    return ret;
+}
+
+int32_t AdcDeviceScanStart(struct AdcDevice *device, const struct AdcScanCfg *cfg)
+{
+    int32_t ret;
+    struct AdcScan *scan = NULL;
+
+    if (device == NULL || device->ops == NULL || cfg == NULL) {
+        HDF_LOGE("%s: device or cfg is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    scan = AdcScanCreate(device, cfg);
+    if (scan == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalMutexLock(&device->scanLock);
+    ret = AdcDeviceScanStartLocked(device, scan);
+    (void)OsalMutexUnlock(&device->scanLock);
+    return ret;
+}
+
+int32_t AdcDeviceScanStop(struct AdcDevice *device)
+{
+    int32_t ret = HDF_SUCCESS;
+    struct AdcScan *scan = NULL;
+
+    if (device == NULL || device->ops == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    (void)OsalMutexLock(&device->scanLock);
+    // take the ring away from the readers and the later pushes first, it is freed once the producer stops
+    scan = AdcDeviceScanDetach(device);
+    if (scan == NULL) {
+        (void)OsalMutexUnlock(&device->scanLock);
+        return HDF_SUCCESS;
+    }
+    if (device->ops->scanStart != NULL) {
+        ret = (device->ops->scanStop != NULL) ? device->ops->scanStop(device) : HDF_SUCCESS;
+    } else {
+        AdcScanSoftStop(scan);
+    }
+    (void)OsalMutexUnlock(&device->scanLock);
+    if (scan->overruns != 0) {
+        HDF_LOGW("%s: device %u dropped %u frames", __func__, device->devNum, scan->overruns);
+    }
+    AdcScanFree(scan);
+    return ret;
+}
+
+static int32_t AdcDeviceScanGetShape(struct AdcDevice *device, uint32_t *chanCnt, uint32_t *frameNum)
+{
+    int32_t ret = HDF_SUCCESS;
+
+    if (device == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (AdcDeviceLock(device) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    if (device->scan == NULL) {
+        ret = HDF_ERR_NOT_SUPPORT;
+    } else {
+        *chanCnt = device->scan->chanCnt;
+        *frameNum = device->scan->sizeMask + 1;
+    }
+    AdcDeviceUnlock(device);
+    return ret;
+}
+
+/* chanCnt is the frame size vals is sized by, 0 to trust the caller */
+static int32_t AdcDeviceScanReadFrames(struct AdcDevice *device, uint32_t *vals, uint64_t *timestamps,
+    uint32_t count, uint32_t chanCnt)
+{
+    uint32_t n;
+    uint32_t first;
+    uint32_t offset;
+    struct AdcScan *scan = NULL;
+
+    if (device == NULL || vals == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (AdcDeviceLock(device) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    scan = device->scan;
+    if (scan == NULL || (chanCnt != 0 && chanCnt != scan->chanCnt)) {
+        AdcDeviceUnlock(device);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    n = scan->writePosition - scan->readPosition;
+    n = (n < count) ? n : count;
+    if (n == 0) {
+        AdcDeviceUnlock(device);
+        return 0;
+    }
+    PlatformMemBarrier(&scan->sync);  // frames read after writePosition
+    offset = scan->readPosition & scan->sizeMask;
+    first = scan->sizeMask + 1 - offset;
+    first = (first < n) ? first : n;
+    (void)memcpy_s(vals, n * scan->chanCnt * sizeof(uint32_t),
+        scan->vals + offset * scan->chanCnt, first * scan->chanCnt * sizeof(uint32_t));
+    if (first < n) {
+        (void)memcpy_s(vals + first * scan->chanCnt, (n - first) * scan->chanCnt * sizeof(uint32_t),
+            scan->vals, (n - first) * scan->chanCnt * sizeof(uint32_t));
+    }
+    if (timestamps != NULL) {
+        (void)memcpy_s(timestamps, n * sizeof(uint64_t), scan->timestamps + offset, first * sizeof(uint64_t));
+        if (first < n) {
+            (void)memcpy_s(timestamps + first, (n - first) * sizeof(uint64_t),
+                scan->timestamps, (n - first) * sizeof(uint64_t));
+        }
+    }
+    PlatformMemBarrier(&scan->sync);  // frames copied out before the space is given back
+    scan->readPosition += n;
+    AdcDeviceUnlock(device);
+    return (int32_t)n;
+}
+
+int32_t AdcDeviceScanRead(struct AdcDevice *device, uint32_t *vals, uint64_t *timestamps, uint32_t count)
+{
+    return AdcDeviceScanReadFrames(device, vals, timestamps, count, 0);
+}
+
 static int32_t AdcManagerIoOpen(struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     uint32_t number;
@@ -400,6 +826,83 @@ static int32_t AdcManagerIoRead(struct HdfSBuf *data, struct HdfSBuf *reply)
     return ret;
 }
 
+static int32_t AdcManagerIoScanStart(struct HdfSBuf *data)
+{
+    uint32_t number;
+    uint32_t len;
+    const struct AdcScanCfg *cfg = NULL;
+
+    if (data == NULL || !HdfSbufReadUint32(data, &number)) {
+        HDF_LOGE("%s: read handle failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (!HdfSbufReadBuffer(data, (const void **)&cfg, &len) || cfg == NULL || len != sizeof(*cfg)) {
+        HDF_LOGE("%s: read cfg failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    number = (uint32_t)(number - ADC_HANDLE_SHIFT);
+    return AdcDeviceScanStart(AdcManagerFindDevice(number), cfg);
+}
+
+static int32_t AdcManagerIoScanRead(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint32_t number;
+    uint32_t count;
+    uint32_t chanCnt;
+    uint32_t frameNum;
+    uint32_t *vals = NULL;
+    uint64_t *timestamps = NULL;
+    struct AdcDevice *device = NULL;
+
+    if (data == NULL || reply == NULL || !HdfSbufReadUint32(data, &number) || !HdfSbufReadUint32(data, &count)) {
+        HDF_LOGE("%s: read handle or count failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    device = AdcManagerFindDevice((uint32_t)(number - ADC_HANDLE_SHIFT));
+    ret = AdcDeviceScanGetShape(device, &chanCnt, &frameNum);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    // no more than the ring holds
+    count = (count < frameNum) ? count : frameNum;
+    if (count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    vals = (uint32_t *)OsalMemAlloc(count * chanCnt * sizeof(uint32_t) + count * sizeof(uint64_t));
+    if (vals == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    timestamps = (uint64_t *)(vals + count * chanCnt);
+    ret = AdcDeviceScanReadFrames(device, vals, timestamps, count, chanCnt);
+    if (ret < 0) {
+        OsalMemFree(vals);
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(reply, (uint32_t)ret) ||
+        !HdfSbufWriteBuffer(reply, vals, (uint32_t)ret * chanCnt * sizeof(uint32_t)) ||
+        !HdfSbufWriteBuffer(reply, timestamps, (uint32_t)ret * sizeof(uint64_t))) {
+        HDF_LOGE("%s: write reply failed!", __func__);
+        OsalMemFree(vals);
+        return HDF_ERR_IO;
+    }
+    OsalMemFree(vals);
+    return HDF_SUCCESS;
+}
+
+static int32_t AdcManagerIoScanStop(struct HdfSBuf *data)
+{
+    uint32_t number;
+
+    if (data == NULL || !HdfSbufReadUint32(data, &number)) {
+        HDF_LOGE("%s: read handle failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    number = (uint32_t)(number - ADC_HANDLE_SHIFT);
+    return AdcDeviceScanStop(AdcManagerFindDevice(number));
+}
+
 static int32_t AdcManagerDispatch(struct HdfDeviceIoClient *client, int cmd,
     struct HdfSBuf *data, struct HdfSBuf *reply)
 {
@@ -410,6 +913,12 @@ static int32_t AdcManagerDispatch(struct HdfDeviceIoClient *client, int cmd,
             return AdcManagerIoClose(data, reply);
         case ADC_IO_READ:
             return AdcManagerIoRead(data, reply);
+        case ADC_IO_SCAN_START:
+            return AdcManagerIoScanStart(data);
+        case ADC_IO_SCAN_READ:
+            return AdcManagerIoScanRead(data, reply);
+        case ADC_IO_SCAN_STOP:
+            return AdcManagerIoScanStop(data);
         default:
             return HDF_ERR_NOT_SUPPORT;
     }
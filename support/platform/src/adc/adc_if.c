@@ -52,3 +52,30 @@ int32_t AdcRead(DevHandle handle, uint32_t channel, uint32_t *val)
     }
     return AdcDeviceRead((struct AdcDevice *)handle, channel, val);
 }
+
+int32_t AdcScanStart(DevHandle handle, const struct AdcScanCfg *cfg)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: invalid handle!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return AdcDeviceScanStart((struct AdcDevice *)handle, cfg);
+}
+
+int32_t AdcScanRead(DevHandle handle, uint32_t *vals, uint64_t *timestamps, uint32_t count)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: invalid handle!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return AdcDeviceScanRead((struct AdcDevice *)handle, vals, timestamps, count);
+}
+
+int32_t AdcScanStop(DevHandle handle)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: invalid handle!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return AdcDeviceScanStop((struct AdcDevice *)handle);
+}
@@ -9,9 +9,21 @@
 #include "hdf_io_service_if.h"
 #include "hdf_log.h"
 #include "adc_if.h"
+#include "osal_mem.h"
+#include "osal_mutex.h"
+#include "platform_user_sbuf.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG adc_if_u_c
 #define ADC_SERVICE_NAME "HDF_PLATFORM_ADC_MANAGER"
+#define ADC_SCAN_REPLY_HEAD 16
+
+/* the scan started through a handle, its channels per frame are the size the caller gives vals by */
+struct AdcClient {
+    uint32_t handle;
+    struct OsalMutex lock;    /* serializes the scan calls on the handle */
+    uint32_t scanChanCnt;     /* 0 if no scan was started through the handle */
+};
 
 static void *AdcManagerGetService(void)
 {
@@ -27,6 +39,43 @@ static void *AdcManagerGetService(void)
     return manager;
 }
 
+static int32_t AdcServiceCall(struct HdfIoService *service, uint32_t handle, int cmd)
+{
+    int32_t ret;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    ret = PlatformUserSbufGet(&data, &reply, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to obtain sbuf!", __func__);
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(data, handle)) {
+        HDF_LOGE("%s: write handle fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    ret = service->dispatcher->Dispatch(&service->object, cmd, data, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: service call %d fail:%d", __func__, cmd, ret);
+    }
+    return ret;
+}
+
+static DevHandle AdcClientCreate(struct HdfIoService *service, uint32_t handle)
+{
+    struct AdcClient *client = NULL;
+
+    client = (struct AdcClient *)OsalMemCalloc(sizeof(*client));
+    if (client == NULL || OsalMutexInit(&client->lock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: create client fail!", __func__);
+        OsalMemFree(client);
+        (void)AdcServiceCall(service, handle, ADC_IO_CLOSE);
+        return NULL;
+    }
+    client->handle = handle;
+    return (DevHandle)client;
+}
+
 DevHandle AdcOpen(uint32_t number)
 {
     int32_t ret;
@@ -39,120 +88,247 @@ DevHandle AdcOpen(uint32_t number)
     if (service == NULL) {
         return NULL;
     }
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: malloc data fail!", __func__);
-        return NULL;
-    }
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: malloc reply fail!", __func__);
-        HdfSbufRecycle(data);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: obtain sbuf fail!", __func__);
         return NULL;
     }
 
     if (!HdfSbufWriteUint32(data, (uint32_t)number)) {
         HDF_LOGE("%s: write number fail!", __func__);
-        goto ERR;
+        return NULL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, ADC_IO_OPEN, data, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call open fail:%d", __func__, ret);
-        goto ERR;
+        return NULL;
     }
 
     if (!HdfSbufReadUint32(reply, &handle)) {
         HDF_LOGE("%s: read handle fail!", __func__);
-        goto ERR;
-    }
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
-    return (DevHandle)(uintptr_t)handle;
-ERR:
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
-    return NULL;
+        return NULL;
+    }
+    return AdcClientCreate(service, handle);
 }
 
 void AdcClose(DevHandle handle)
 {
-    int32_t ret;
     struct HdfIoService *service = NULL;
+    struct AdcClient *client = (struct AdcClient *)handle;
+
+    if (client == NULL) {
+        return;
+    }
+    service = (struct HdfIoService *)AdcManagerGetService();
+    if (service != NULL) {
+        // a scan left running by the handle would keep sampling for nobody
+        if (client->scanChanCnt != 0) {
+            (void)AdcServiceCall(service, client->handle, ADC_IO_SCAN_STOP);
+        }
+        (void)AdcServiceCall(service, client->handle, ADC_IO_CLOSE);
+    }
+    (void)OsalMutexDestroy(&client->lock);
+    OsalMemFree(client);
+}
+
+int32_t AdcRead(DevHandle handle, uint32_t channel, uint32_t *val)
+{
+    int32_t ret;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+    struct HdfIoService *service = NULL;
+    struct AdcClient *client = (struct AdcClient *)handle;
 
+    if (client == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
     service = (struct HdfIoService *)AdcManagerGetService();
     if (service == NULL) {
-        return;
+        return HDF_PAL_ERR_DEV_CREATE;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        return;
+    ret = PlatformUserSbufGet(&data, &reply, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to obtain sbuf!", __func__);
+        return ret;
     }
 
-    if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
+    if (!HdfSbufWriteUint32(data, client->handle)) {
         HDF_LOGE("%s: write handle fail!", __func__);
-        HdfSbufRecycle(data);
-        return;
+        return HDF_ERR_IO;
     }
-
-    ret = service->dispatcher->Dispatch(&service->object, ADC_IO_CLOSE, data, NULL);
+    if (!HdfSbufWriteUint32(data, (uint32_t)channel)) {
+        HDF_LOGE("%s: write adc number failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    ret = service->dispatcher->Dispatch(&service->object, ADC_IO_READ, data, reply);
     if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s: close handle fail:%d", __func__, ret);
+        HDF_LOGE("%s: failed to send service call:%d", __func__, ret);
+        return ret;
     }
-    HdfSbufRecycle(data);
+
+    if (!HdfSbufReadUint32(reply, val)) {
+        HDF_LOGE("%s: read sbuf failed", __func__);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
 }
 
-int32_t AdcRead(DevHandle handle, uint32_t channel, uint32_t *val)
+static int32_t AdcClientScanStart(struct AdcClient *client, struct HdfIoService *service,
+    const struct AdcScanCfg *cfg)
 {
     int32_t ret;
+    uint32_t ch;
+    uint32_t chanCnt = 0;
     struct HdfSBuf *data = NULL;
     struct HdfSBuf *reply = NULL;
+
+    ret = PlatformUserSbufGet(&data, &reply, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to obtain sbuf!", __func__);
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(data, client->handle) || !HdfSbufWriteBuffer(data, cfg, sizeof(*cfg))) {
+        HDF_LOGE("%s: write handle or cfg fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    ret = service->dispatcher->Dispatch(&service->object, ADC_IO_SCAN_START, data, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to send service call:%d", __func__, ret);
+        return ret;
+    }
+    for (ch = 0; ch < ADC_SCAN_CHANNEL_MAX; ch++) {
+        chanCnt += (cfg->chanMask >> ch) & 1U;
+    }
+    client->scanChanCnt = chanCnt;
+    return HDF_SUCCESS;
+}
+
+int32_t AdcScanStart(DevHandle handle, const struct AdcScanCfg *cfg)
+{
+    int32_t ret;
     struct HdfIoService *service = NULL;
-	
+    struct AdcClient *client = (struct AdcClient *)handle;
+
+    if (client == NULL || cfg == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
     service = (struct HdfIoService *)AdcManagerGetService();
     if (service == NULL) {
         return HDF_PAL_ERR_DEV_CREATE;
     }
-
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: failed to obtain data!", __func__);
-        return HDF_ERR_MALLOC_FAIL;
+    if (OsalMutexLock(&client->lock) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
     }
+    ret = AdcClientScanStart(client, service, cfg);
+    (void)OsalMutexUnlock(&client->lock);
+    return ret;
+}
 
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HdfSbufRecycle(data);
-        return HDF_ERR_MALLOC_FAIL;
+static int32_t AdcScanReadReply(struct HdfSBuf *reply, uint32_t *vals, uint64_t *timestamps, uint32_t count,
+    uint32_t chanCnt)
+{
+    uint32_t frames;
+    uint32_t len;
+    const void *buf = NULL;
+    size_t capacity = (size_t)count * chanCnt * sizeof(uint32_t);
+
+    if (!HdfSbufReadUint32(reply, &frames) || frames > count) {
+        HDF_LOGE("%s: read frames fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (frames == 0) {
+        return 0;
+    }
+    // a frame holds one value per scanned channel, vals is sized by the caller for count frames
+    if (!HdfSbufReadBuffer(reply, &buf, &len) || buf == NULL || len != frames * chanCnt * sizeof(uint32_t) ||
+        memcpy_s(vals, capacity, buf, len) != EOK) {
+        HDF_LOGE("%s: read vals fail, len:%u, frames:%u, chanCnt:%u!", __func__, len, frames, chanCnt);
+        return HDF_ERR_IO;
     }
+    if (!HdfSbufReadBuffer(reply, &buf, &len) || len != frames * sizeof(uint64_t)) {
+        HDF_LOGE("%s: read timestamps fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (timestamps != NULL && memcpy_s(timestamps, count * sizeof(uint64_t), buf, len) != EOK) {
+        return HDF_ERR_IO;
+    }
+    return (int32_t)frames;
+}
 
-    if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
-        HDF_LOGE("%s: write handle fail!", __func__);
-        ret = HDF_ERR_IO;
-        goto EXIT;
+static int32_t AdcClientScanRead(struct AdcClient *client, struct HdfIoService *service,
+    uint32_t *vals, uint64_t *timestamps, uint32_t count)
+{
+    int32_t ret;
+    size_t replySize;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    if (client->scanChanCnt == 0) {
+        HDF_LOGE("%s: no scan started through this handle!", __func__);
+        return HDF_ERR_NOT_SUPPORT;
     }
-    if (!HdfSbufWriteUint32(data, (uint32_t)channel)) {
-        HDF_LOGE("%s: write adc number failed!", __func__);
-        ret = HDF_ERR_IO;
-        goto EXIT;
+    // room for count frames, the service hands back no more than that
+    replySize = (size_t)count * (sizeof(uint32_t) * client->scanChanCnt + sizeof(uint64_t)) + ADC_SCAN_REPLY_HEAD;
+    ret = PlatformUserSbufGet(&data, &reply, replySize);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to obtain sbuf!", __func__);
+        return ret;
     }
-    ret = service->dispatcher->Dispatch(&service->object, ADC_IO_READ, data, reply);
+
+    if (!HdfSbufWriteUint32(data, client->handle) || !HdfSbufWriteUint32(data, count)) {
+        HDF_LOGE("%s: write handle or count fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    ret = service->dispatcher->Dispatch(&service->object, ADC_IO_SCAN_READ, data, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: failed to send service call:%d", __func__, ret);
-        goto EXIT;
+        return ret;
     }
+    return AdcScanReadReply(reply, vals, timestamps, count, client->scanChanCnt);
+}
 
-    if (!HdfSbufReadUint32(reply, val)) {
-        HDF_LOGE("%s: read sbuf failed", __func__);
-        ret = HDF_ERR_IO;
-        goto EXIT;
+int32_t AdcScanRead(DevHandle handle, uint32_t *vals, uint64_t *timestamps, uint32_t count)
+{
+    int32_t ret;
+    struct HdfIoService *service = NULL;
+    struct AdcClient *client = (struct AdcClient *)handle;
+
+    if (client == NULL || vals == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    service = (struct HdfIoService *)AdcManagerGetService();
+    if (service == NULL) {
+        return HDF_PAL_ERR_DEV_CREATE;
     }
+    if (OsalMutexLock(&client->lock) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    ret = AdcClientScanRead(client, service, vals, timestamps, count);
+    (void)OsalMutexUnlock(&client->lock);
+    return ret;
+}
+
+int32_t AdcScanStop(DevHandle handle)
+{
+    int32_t ret;
+    struct HdfIoService *service = NULL;
+    struct AdcClient *client = (struct AdcClient *)handle;
 
-    goto EXIT;
-EXIT:
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
+    if (client == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    service = (struct HdfIoService *)AdcManagerGetService();
+    if (service == NULL) {
+        return HDF_PAL_ERR_DEV_CREATE;
+    }
+    if (OsalMutexLock(&client->lock) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    ret = AdcServiceCall(service, client->handle, ADC_IO_SCAN_STOP);
+    if (ret == HDF_SUCCESS) {
+        client->scanChanCnt = 0;
+    }
+    (void)OsalMutexUnlock(&client->lock);
     return ret;
 }
@@ -13,10 +13,17 @@
 #include "osal_spinlock.h"
 #include "osal_time.h"
 #include "platform_core.h"
+#include "securec.h"
 
 #define DAC_HANDLE_SHIFT    0xFF00U
 #define HDF_LOG_TAG dac_core_c
 
+#define DAC_STREAM_SAMPLE_MAX     65536
+#define DAC_STREAM_SOFT_RATE_MAX  1000
+#define DAC_STREAM_THREAD_STACK   (1024 * 16)
+#define DAC_US_PER_SECOND         1000000
+#define DAC_STREAM_DRAIN_WAIT_MS  1
+
 struct DacManager {
     struct IDeviceIoService service;
     struct HdfDeviceObject *device;
@@ -189,9 +196,23 @@ int32_t DacDeviceAdd(struct DacDevice *device)
         HDF_LOGE("%s: init lock failed", __func__);
         return HDF_FAILURE;
     }
+    if (OsalSemInit(&device->streamSem, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init stream sem failed", __func__);
+        (void)OsalSpinDestroy(&device->spin);
+        return HDF_FAILURE;
+    }
+    if (OsalMutexInit(&device->streamLock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init stream lock failed", __func__);
+        (void)OsalSemDestroy(&device->streamSem);
+        (void)OsalSpinDestroy(&device->spin);
+        return HDF_FAILURE;
+    }
+    OsalAtomicSet(&device->streamUsers, 0);
 
     ret = DacManagerAddDevice(device);
     if (ret != HDF_SUCCESS) {
+        (void)OsalMutexDestroy(&device->streamLock);
+        (void)OsalSemDestroy(&device->streamSem);
         (void)OsalSpinDestroy(&device->spin);
     }
     return ret;
@@ -203,7 +224,10 @@ void DacDeviceRemove(struct DacDevice *device)
         HDF_LOGE("%s: device is null", __func__);
         return;
     }
+    (void)DacDeviceStreamStop(device);
     DacManagerRemoveDevice(device);
+    (void)OsalMutexDestroy(&device->streamLock);
+    (void)OsalSemDestroy(&device->streamSem);
     (void)OsalSpinDestroy(&device->spin);
 }
 
@@ -320,6 +344,419 @@ int32_t DacDeviceStop(struct DacDevice *device)
     return ret;
 }
 
+static inline uint32_t DacStreamPeriodUs(const struct DacStream *stream)
+{
+    return DAC_US_PER_SECOND / stream->cfg.rateHz;
+}
+
+/* pins the ring of the device for the consumer, which may run in interrupt context */
+static struct DacStream *DacStreamGet(struct DacDevice *device)
+{
+    struct DacStream *stream = NULL;
+
+    (void)OsalAtomicIncReturn(&device->streamUsers);
+    stream = *(struct DacStream * volatile *)&device->stream;
+    if (stream == NULL) {
+        (void)OsalAtomicDecReturn(&device->streamUsers);
+    }
+    return stream;
+}
+
+static inline void DacStreamPut(struct DacDevice *device)
+{
+    (void)OsalAtomicDecReturn(&device->streamUsers);
+}
+
+// consumer side: wake the waiter once per crossing of the low watermark
+static void DacStreamCheckLow(struct DacStream *stream)
+{
+    if (stream->lowSignaled || stream->writePosition - stream->readPosition > stream->cfg.lowWatermark) {
+        return;
+    }
+    stream->lowSignaled = true;
+    (void)OsalSemPost(&stream->device->streamSem);
+}
+
+static bool DacStreamPopSample(struct DacStream *stream, uint32_t *val)
+{
+    if (stream->writePosition == stream->readPosition) {
+        // an empty ring before the first sample is not an underrun, the client is still priming it
+        stream->underruns += (stream->played != 0) ? 1 : 0;
+        DacStreamCheckLow(stream);
+        return false;
+    }
+    PlatformMemBarrier(&stream->sync);  // sample read after writePosition
+    *val = stream->vals[stream->readPosition & stream->sizeMask];
+    PlatformMemBarrier(&stream->sync);  // sample copied out before the space is given back
+    stream->readPosition++;
+    stream->played++;
+    DacStreamCheckLow(stream);
+    return true;
+}
+
+bool DacDeviceStreamPop(struct DacDevice *device, uint32_t *val)
+{
+    bool ret;
+    struct DacStream *stream = NULL;
+
+    if (device == NULL || val == NULL || (stream = DacStreamGet(device)) == NULL) {
+        return false;
+    }
+    ret = DacStreamPopSample(stream, val);
+    DacStreamPut(device);
+    return ret;
+}
+
+uint32_t DacDeviceStreamPrepare(struct DacDevice *device, const uint32_t **vals)
+{
+    uint32_t queued;
+    uint32_t offset;
+    struct DacStream *stream = NULL;
+
+    if (device == NULL || vals == NULL || (stream = DacStreamGet(device)) == NULL) {
+        return 0;
+    }
+    queued = stream->writePosition - stream->readPosition;
+    PlatformMemBarrier(&stream->sync);
+    offset = stream->readPosition & stream->sizeMask;
+    *vals = stream->vals + offset;
+    queued = (queued < stream->sizeMask + 1 - offset) ? queued : (stream->sizeMask + 1 - offset);
+    DacStreamPut(device);
+    return queued;
+}
+
+void DacDeviceStreamCommit(struct DacDevice *device, uint32_t samples, uint32_t missed)
+{
+    struct DacStream *stream = NULL;
+
+    if (device == NULL || (stream = DacStreamGet(device)) == NULL) {
+        return;
+    }
+    if (stream->played != 0) {
+        stream->underruns += missed;
+    }
+    PlatformMemBarrier(&stream->sync);
+    stream->readPosition += samples;
+    stream->played += samples;
+    DacStreamCheckLow(stream);
+    DacStreamPut(device);
+}
+
+static int32_t DacStreamSoftThread(void *data)
+{
+    uint32_t val;
+    uint64_t next;
+    uint64_t now;
+    struct DacStream *stream = (struct DacStream *)data;
+
+    next = PlatformMonoTimeUs();
+    while (!stream->stopping) {
+        // the thread owns the ring until it exits, whether it's still published or not
+        if (DacStreamPopSample(stream, &val)) {
+            (void)DacDeviceWrite(stream->device, stream->cfg.channel, val);
+        }
+
+        next += DacStreamPeriodUs(stream);
+        now = PlatformMonoTimeUs();
+        if (next > now) {
+            OsalUSleep((uint32_t)(next - now));
+        } else {
+            next = now;  // fell behind, do not burst to catch up
+        }
+    }
+    (void)OsalSemPost(&stream->exitSem);
+    return HDF_SUCCESS;
+}
+
+static int32_t DacStreamSoftStart(struct DacStream *stream)
+{
+    int32_t ret;
+    struct OsalThreadParam param;
+
+    if (stream->device->ops->write == NULL || stream->cfg.rateHz > DAC_STREAM_SOFT_RATE_MAX) {
+        HDF_LOGE("%s: rate %u not support without streamStart", __func__, stream->cfg.rateHz);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    ret = OsalSemInit(&stream->exitSem, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: init sem fail:%d", __func__, ret);
+        return ret;
+    }
+    stream->stopping = false;
+    ret = OsalThreadCreate(&stream->thread, DacStreamSoftThread, stream);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: create thread fail:%d", __func__, ret);
+        (void)OsalSemDestroy(&stream->exitSem);
+        return ret;
+    }
+    param.name = "dac_stream";
+    param.priority = OSAL_THREAD_PRI_HIGH;
+    param.stackSize = DAC_STREAM_THREAD_STACK;
+    ret = OsalThreadStart(&stream->thread, &param);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start thread fail:%d", __func__, ret);
+        (void)OsalThreadDestroy(&stream->thread);
+        (void)OsalSemDestroy(&stream->exitSem);
+    }
+    return ret;
+}
+
+static void DacStreamSoftStop(struct DacStream *stream)
+{
+    stream->stopping = true;
+    (void)OsalSemWait(&stream->exitSem, HDF_WAIT_FOREVER);
+    (void)OsalThreadDestroy(&stream->thread);
+    (void)OsalSemDestroy(&stream->exitSem);
+}
+
+static void DacStreamFree(struct DacStream *stream)
+{
+    if (stream == NULL) {
+        return;
+    }
+    OsalMemFree(stream->vals);
+    OsalMemFree(stream);
+}
+
+static struct DacStream *DacStreamCreate(struct DacDevice *device, const struct DacStreamCfg *cfg)
+{
+    struct DacStream *stream = NULL;
+
+    if (device->chanNum != 0 && cfg->channel >= device->chanNum) {
+        HDF_LOGE("%s: invalid channel:%u", __func__, cfg->channel);
+        return NULL;
+    }
+    if (cfg->rateHz == 0 || cfg->rateHz > DAC_US_PER_SECOND || cfg->sampleNum == 0 ||
+        cfg->sampleNum > DAC_STREAM_SAMPLE_MAX || (cfg->sampleNum & (cfg->sampleNum - 1)) != 0 ||
+        cfg->lowWatermark >= cfg->sampleNum) {
+        HDF_LOGE("%s: invalid rate:%u, sampleNum:%u or lowWatermark:%u", __func__,
+            cfg->rateHz, cfg->sampleNum, cfg->lowWatermark);
+        return NULL;
+    }
+
+    stream = (struct DacStream *)OsalMemCalloc(sizeof(*stream));
+    if (stream == NULL) {
+        return NULL;
+    }
+    stream->vals = (uint32_t *)OsalMemCalloc(sizeof(uint32_t) * cfg->sampleNum);
+    if (stream->vals == NULL) {
+        HDF_LOGE("%s: alloc ring fail", __func__);
+        OsalMemFree(stream);
+        return NULL;
+    }
+    stream->device = device;
+    stream->cfg = *cfg;
+    stream->sizeMask = cfg->sampleNum - 1;
+    OsalAtomicSet(&stream->sync, 0);
+    return stream;
+}
+
+static int32_t DacDeviceStreamPublish(struct DacDevice *device, struct DacStream *stream)
+{
+    if (DacDeviceLock(device) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    PlatformMemBarrier(&stream->sync);  // ring set up before it is published
+    device->stream = stream;
+    DacDeviceUnlock(device);
+    return HDF_SUCCESS;
+}
+
+/* takes the ring away from the writers and the controller, and waits for the pinned callbacks to leave */
+static struct DacStream *DacDeviceStreamDetach(struct DacDevice *device)
+{
+    struct DacStream *stream = NULL;
+
+    if (DacDeviceLock(device) != HDF_SUCCESS) {
+        return NULL;
+    }
+    stream = device->stream;
+    device->stream = NULL;
+    DacDeviceUnlock(device);
+    while (stream != NULL && OsalAtomicRead(&device->streamUsers) != 0) {
+        OsalMSleep(DAC_STREAM_DRAIN_WAIT_MS);
+    }
+    return stream;
+}
+
+/* takes over the ring, which is freed here on failure */
+static int32_t DacDeviceStreamStartLocked(struct DacDevice *device, struct DacStream *stream)
+{
+    int32_t ret;
+
+    if (device->stream != NULL) {
+        HDF_LOGE("%s: device %u is already streaming", __func__, device->devNum);
+        DacStreamFree(stream);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    if (device->ops->streamStart == NULL) {
+        // the thread gets the ring as its argument, so it's published only once it runs
+        ret = DacStreamSoftStart(stream);
+        if (ret == HDF_SUCCESS && (ret = DacDeviceStreamPublish(device, stream)) != HDF_SUCCESS) {
+            DacStreamSoftStop(stream);
+        }
+        if (ret != HDF_SUCCESS) {
+            DacStreamFree(stream);
+        }
+        return ret;
+    }
+
+    // the driver drains device->stream, so it's published before the driver starts, may sleep to set up the dma
+    ret = DacDeviceStreamPublish(device, stream);
+    if (ret != HDF_SUCCESS) {
+        DacStreamFree(stream);
+        return ret;
+    }
+    ret = device->ops->streamStart(device, &stream->cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start stream fail:%d", __func__, ret);
+        // stopping is serialized by streamLock, so what is detached here is the ring published above
+        DacStreamFree(DacDeviceStreamDetach(device));
+    }
+    return ret;
+}
+
+int32_t DacDeviceStreamStart(struct DacDevice *device, const struct DacStreamCfg *cfg)
+{
+    int32_t ret;
+    struct DacStream *stream = NULL;
+
+    if (device == NULL || device->ops == NULL || cfg == NULL) {
+        HDF_LOGE("%s: device or cfg is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    stream = DacStreamCreate(device, cfg);
+    if (stream == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalMutexLock(&device->streamLock);
+    ret = DacDeviceStreamStartLocked(device, stream);
+    (void)OsalMutexUnlock(&device->streamLock);
+    return ret;
+}
+
+int32_t DacDeviceStreamStop(struct DacDevice *device)
+{
+    int32_t ret = HDF_SUCCESS;
+    struct DacStream *stream = NULL;
+
+    if (device == NULL || device->ops == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    (void)OsalMutexLock(&device->streamLock);
+    // take the ring away from the writers and the later callbacks first, it is freed once the consumer stops
+    stream = DacDeviceStreamDetach(device);
+    if (stream == NULL) {
+        (void)OsalMutexUnlock(&device->streamLock);
+        return HDF_SUCCESS;
+    }
+    if (device->ops->streamStart != NULL) {
+        ret = (device->ops->streamStop != NULL) ? device->ops->streamStop(device) : HDF_SUCCESS;
+    } else {
+        DacStreamSoftStop(stream);
+    }
+    (void)OsalMutexUnlock(&device->streamLock);
+    (void)OsalSemPost(&device->streamSem);  // a waiter finds the stream gone
+    if (stream->underruns != 0) {
+        HDF_LOGW("%s: device %u missed %u samples", __func__, device->devNum, stream->underruns);
+    }
+    DacStreamFree(stream);
+    return ret;
+}
+
+int32_t DacDeviceStreamWrite(struct DacDevice *device, const uint32_t *vals, uint32_t count)
+{
+    uint32_t n;
+    uint32_t first;
+    uint32_t offset;
+    struct DacStream *stream = NULL;
+
+    if (device == NULL || vals == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (DacDeviceLock(device) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    stream = device->stream;
+    if (stream == NULL) {
+        DacDeviceUnlock(device);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    n = stream->sizeMask + 1 - (stream->writePosition - stream->readPosition);
+    n = (n < count) ? n : count;
+    if (n == 0) {
+        DacDeviceUnlock(device);
+        return 0;
+    }
+    PlatformMemBarrier(&stream->sync);  // the consumer has output the samples before it moved readPosition
+    offset = stream->writePosition & stream->sizeMask;
+    first = stream->sizeMask + 1 - offset;
+    first = (first < n) ? first : n;
+    (void)memcpy_s(stream->vals + offset, first * sizeof(uint32_t), vals, first * sizeof(uint32_t));
+    if (first < n) {
+        (void)memcpy_s(stream->vals, (n - first) * sizeof(uint32_t), vals + first, (n - first) * sizeof(uint32_t));
+    }
+    PlatformMemBarrier(&stream->sync);  // samples written before they are published
+    stream->writePosition += n;
+    if (stream->writePosition - stream->readPosition > stream->cfg.lowWatermark) {
+        stream->lowSignaled = false;
+    }
+    DacDeviceUnlock(device);
+    return (int32_t)n;
+}
+
+static int32_t DacDeviceStreamGetStatus(struct DacDevice *device, struct DacStreamStatus *status, bool *low)
+{
+    struct DacStream *stream = NULL;
+
+    if (DacDeviceLock(device) != HDF_SUCCESS) {
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    stream = device->stream;
+    if (stream == NULL) {
+        DacDeviceUnlock(device);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    status->queued = stream->writePosition - stream->readPosition;
+    status->underruns = stream->underruns;
+    status->played = stream->played;
+    *low = status->queued <= stream->cfg.lowWatermark;
+    DacDeviceUnlock(device);
+    return HDF_SUCCESS;
+}
+
+int32_t DacDeviceStreamWait(struct DacDevice *device, uint32_t timeoutMs, struct DacStreamStatus *status)
+{
+    int32_t ret;
+    bool low = false;
+    uint64_t now;
+    uint64_t deadline;
+    struct DacStreamStatus tmp;
+
+    if (device == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    status = (status != NULL) ? status : &tmp;
+    deadline = OsalGetSysTimeMs() + timeoutMs;
+    while (true) {
+        ret = DacDeviceStreamGetStatus(device, status, &low);
+        if (ret != HDF_SUCCESS || low) {
+            return ret;
+        }
+        // the sem may hold stale posts of earlier crossings, so the watermark is checked again after each
+        now = OsalGetSysTimeMs();
+        if (timeoutMs != HDF_WAIT_FOREVER && now >= deadline) {
+            return HDF_ERR_TIMEOUT;
+        }
+        ret = OsalSemWait(&device->streamSem,
+            (timeoutMs == HDF_WAIT_FOREVER) ? HDF_WAIT_FOREVER : (uint32_t)(deadline - now));
+        if (ret != HDF_SUCCESS && ret != HDF_ERR_TIMEOUT) {
+            return ret;
+        }
+    }
+}
+
 static int32_t DacManagerIoOpen(struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     uint32_t number;
@@ -418,6 +855,89 @@ static int32_t DacManagerIoWrite(struct HdfSBuf *data, struct HdfSBuf *reply)
     return HDF_SUCCESS;
 }
 
+static int32_t DacManagerIoStreamStart(struct HdfSBuf *data)
+{
+    uint32_t number;
+    uint32_t len;
+    const struct DacStreamCfg *cfg = NULL;
+
+    if (data == NULL || !HdfSbufReadUint32(data, &number)) {
+        HDF_LOGE("%s: read handle failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (!HdfSbufReadBuffer(data, (const void **)&cfg, &len) || cfg == NULL || len != sizeof(*cfg)) {
+        HDF_LOGE("%s: read cfg failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    number = (uint32_t)(number - DAC_HANDLE_SHIFT);
+    return DacDeviceStreamStart(DacManagerFindDevice(number), cfg);
+}
+
+static int32_t DacManagerIoStreamWrite(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint32_t number;
+    uint32_t len;
+    const uint32_t *vals = NULL;
+
+    if (data == NULL || reply == NULL || !HdfSbufReadUint32(data, &number)) {
+        HDF_LOGE("%s: read handle failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (!HdfSbufReadBuffer(data, (const void **)&vals, &len) || vals == NULL || len % sizeof(uint32_t) != 0) {
+        HDF_LOGE("%s: read samples failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    number = (uint32_t)(number - DAC_HANDLE_SHIFT);
+    // queued straight from the sbuf
+    ret = DacDeviceStreamWrite(DacManagerFindDevice(number), vals, len / sizeof(uint32_t));
+    if (ret < 0) {
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(reply, (uint32_t)ret)) {
+        HDF_LOGE("%s: write reply failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t DacManagerIoStreamWait(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint32_t number;
+    uint32_t timeoutMs;
+    struct DacStreamStatus status;
+
+    if (data == NULL || reply == NULL || !HdfSbufReadUint32(data, &number) ||
+        !HdfSbufReadUint32(data, &timeoutMs)) {
+        HDF_LOGE("%s: read handle or timeout failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    number = (uint32_t)(number - DAC_HANDLE_SHIFT);
+    ret = DacDeviceStreamWait(DacManagerFindDevice(number), timeoutMs, &status);
+    if (ret != HDF_SUCCESS && ret != HDF_ERR_TIMEOUT) {
+        return ret;
+    }
+    // a timeout still carries the status, so it travels in the reply rather than as the dispatch result
+    if (!HdfSbufWriteInt32(reply, ret) || !HdfSbufWriteBuffer(reply, &status, sizeof(status))) {
+        HDF_LOGE("%s: write reply failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t DacManagerIoStreamStop(struct HdfSBuf *data)
+{
+    uint32_t number;
+
+    if (data == NULL || !HdfSbufReadUint32(data, &number)) {
+        HDF_LOGE("%s: read handle failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    number = (uint32_t)(number - DAC_HANDLE_SHIFT);
+    return DacDeviceStreamStop(DacManagerFindDevice(number));
+}
+
 static int32_t DacManagerDispatch(struct HdfDeviceIoClient *client, int cmd,
     struct HdfSBuf *data, struct HdfSBuf *reply)
 {
@@ -428,6 +948,14 @@ static int32_t DacManagerDispatch(struct HdfDeviceIoClient *client, int cmd,
             return DacManagerIoClose(data, reply);
         case DAC_IO_WRITE:
             return DacManagerIoWrite(data, reply);
+        case DAC_IO_STREAM_START:
+            return DacManagerIoStreamStart(data);
+        case DAC_IO_STREAM_WRITE:
+            return DacManagerIoStreamWrite(data, reply);
+        case DAC_IO_STREAM_WAIT:
+            return DacManagerIoStreamWait(data, reply);
+        case DAC_IO_STREAM_STOP:
+            return DacManagerIoStreamStop(data);
         default:
             return HDF_ERR_NOT_SUPPORT;
     }
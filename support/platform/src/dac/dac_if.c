@@ -52,3 +52,39 @@ int32_t DacWrite(DevHandle handle, uint32_t channel, uint32_t val)
     }
     return DacDeviceWrite((struct DacDevice *)handle, channel, val);
 }
+
+int32_t DacStreamStart(DevHandle handle, const struct DacStreamCfg *cfg)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: invalid handle!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return DacDeviceStreamStart((struct DacDevice *)handle, cfg);
+}
+
+int32_t DacStreamWrite(DevHandle handle, const uint32_t *vals, uint32_t count)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: invalid handle!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return DacDeviceStreamWrite((struct DacDevice *)handle, vals, count);
+}
+
+int32_t DacStreamWait(DevHandle handle, uint32_t timeoutMs, struct DacStreamStatus *status)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: invalid handle!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return DacDeviceStreamWait((struct DacDevice *)handle, timeoutMs, status);
+}
+
+int32_t DacStreamStop(DevHandle handle)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: invalid handle!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return DacDeviceStreamStop((struct DacDevice *)handle);
+}
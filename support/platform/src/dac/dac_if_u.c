@@ -11,6 +11,7 @@
 #include "platform_core.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "platform_user_sbuf.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG dac_if_c
@@ -164,3 +165,142 @@ int32_t DacWrite(DevHandle handle, uint32_t channel, uint32_t val)
     HdfSbufRecycle(data);
     return ret;
 }
+
+// takes the per thread sbufs and puts the handle first, as every stream command expects
+static int32_t DacStreamPrepareCall(DevHandle handle, struct HdfIoService **service,
+    struct HdfSBuf **data, struct HdfSBuf **reply)
+{
+    int32_t ret;
+
+    if (handle == NULL) {
+        HDF_LOGE("%s: handle is invalid", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *service = (struct HdfIoService *)DacManagerServiceGet();
+    if (*service == NULL || (*service)->dispatcher == NULL || (*service)->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: service is invalid", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = PlatformUserSbufGet(data, reply, 0);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(*data, (uint32_t)(uintptr_t)handle)) {
+        HDF_LOGE("%s: write handle failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t DacStreamStart(DevHandle handle, const struct DacStreamCfg *cfg)
+{
+    int32_t ret;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    if (cfg == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ret = DacStreamPrepareCall(handle, &service, &data, &reply);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (!HdfSbufWriteBuffer(data, cfg, sizeof(*cfg))) {
+        HDF_LOGE("DacStreamStart: write cfg failed!");
+        return HDF_ERR_IO;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, DAC_IO_STREAM_START, data, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("DacStreamStart: start stream failed:%d", ret);
+    }
+    return ret;
+}
+
+int32_t DacStreamWrite(DevHandle handle, const uint32_t *vals, uint32_t count)
+{
+    int32_t ret;
+    uint32_t queued;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    if (vals == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ret = DacStreamPrepareCall(handle, &service, &data, &reply);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (!HdfSbufWriteBuffer(data, vals, count * sizeof(uint32_t))) {
+        HDF_LOGE("DacStreamWrite: write samples failed!");
+        return HDF_ERR_IO;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, DAC_IO_STREAM_WRITE, data, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("DacStreamWrite: write stream failed:%d", ret);
+        return ret;
+    }
+    if (!HdfSbufReadUint32(reply, &queued)) {
+        HDF_LOGE("DacStreamWrite: read queued failed!");
+        return HDF_ERR_IO;
+    }
+    return (int32_t)queued;
+}
+
+int32_t DacStreamWait(DevHandle handle, uint32_t timeoutMs, struct DacStreamStatus *status)
+{
+    int32_t ret;
+    int32_t result;
+    uint32_t len;
+    const void *buf = NULL;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    ret = DacStreamPrepareCall(handle, &service, &data, &reply);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(data, timeoutMs)) {
+        HDF_LOGE("DacStreamWait: write timeout failed!");
+        return HDF_ERR_IO;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, DAC_IO_STREAM_WAIT, data, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("DacStreamWait: wait stream failed:%d", ret);
+        return ret;
+    }
+    if (!HdfSbufReadInt32(reply, &result) || !HdfSbufReadBuffer(reply, &buf, &len) ||
+        buf == NULL || len != sizeof(struct DacStreamStatus)) {
+        HDF_LOGE("DacStreamWait: read status failed!");
+        return HDF_ERR_IO;
+    }
+    if (status != NULL && memcpy_s(status, sizeof(*status), buf, len) != EOK) {
+        return HDF_ERR_IO;
+    }
+    return result;
+}
+
+int32_t DacStreamStop(DevHandle handle)
+{
+    int32_t ret;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    ret = DacStreamPrepareCall(handle, &service, &data, &reply);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, DAC_IO_STREAM_STOP, data, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("DacStreamStop: stop stream failed:%d", ret);
+    }
+    return ret;
+}
@@ -167,11 +167,14 @@ static void DmacEventCallback(struct DmacChanInfo *chanInfo)
     }
 }
 
-static void DmacCallbackHandle(struct DmacChanInfo *chanInfo)
+static void DmacCallbackHandle(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo)
 {
     if (chanInfo->transType == TRASFER_TYPE_M2M) {
-        DmacEventCallback(chanInfo);
-        return;
+        if (!chanInfo->async) {
+            DmacEventCallback(chanInfo);
+            return;
+        }
+        cntlr->dmacChanDisable(cntlr, chanInfo->channel);
     }
     if (chanInfo->callback != NULL) {
         chanInfo->callback(chanInfo->callbackData, chanInfo->status);
@@ -253,6 +256,7 @@ static struct DmacChanInfo *DmacRequestChannel(struct DmaCntlr *cntlr, struct Dm
     chanInfo = &(cntlr->channelList[chan]);
     chanInfo->channel = (unsigned int)chan;
     chanInfo->transType = msg->transType;
+    chanInfo->async = false;
     ret = cntlr->getChanInfo(cntlr, chanInfo, msg);
     if (ret < 0) {
         DmacFreeChannel(cntlr, chan);
@@ -287,16 +291,28 @@ static inline size_t DmacAlignedTransMax(size_t maxSize, uint8_t srcWidth, uint8
     return ret;
 }
 
-static int32_t DmacFillLli(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo,
-    uintptr_t srcaddr, uintptr_t dstaddr, size_t length)
+static size_t DmacSgLliNum(const struct DmacSgSeg *segs, uint16_t segNum, size_t maxSize)
 {
-    int32_t ret = HDF_SUCCESS;
     uint16_t i;
-    uint16_t lliNum;
-    struct DmacLli  *plli = NULL;
-    size_t alignedMax;
-    uintptr_t srcDummy = 0;
-    uintptr_t dstDummy = 0;
+    size_t lliNum = 0;
+
+    for (i = 0; i < segNum; i++) {
+        lliNum += (segs[i].len / maxSize) + ((segs[i].len % maxSize) > 0 ? 1 : 0);
+    }
+    return lliNum;
+}
+
+static int32_t DmacFillLli(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo,
+    const struct DmacSgSeg *segs, uint16_t segNum, size_t alignedMax)
+{
+    uint16_t i = 0;
+    uint16_t seg;
+    size_t left;
+    bool srcInc = false;
+    bool dstInc = false;
+    uintptr_t srcaddr;
+    uintptr_t dstaddr;
+    struct DmacLli *plli = NULL;
 
     if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
         return HDF_ERR_INVALID_OBJECT;
@@ -305,58 +321,51 @@ static int32_t DmacFillLli(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo
         HDF_LOGE("%s: chanInfo or lli is null", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
-    alignedMax = DmacAlignedTransMax(cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth);
-    if (alignedMax == 0) {
-        HDF_LOGE("%s: maxTransSize:%zu srcWidth:%u dstWidth:%u", __func__,
-            cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth);
-        return HDF_ERR_INVALID_PARAM;
-    }
     plli = chanInfo->lli;
 
-    if (srcaddr == 0) {
-        srcaddr = srcDummy = DmacGetDummyBuf(cntlr, chanInfo);
-    }
-    if (dstaddr == 0) {
-        dstaddr = dstDummy = DmacGetDummyBuf(cntlr, chanInfo);
-    }
-    if (srcaddr == 0 || dstaddr == 0) {
-        return HDF_ERR_MALLOC_FAIL;
-    }
-
-    for (i = 0, lliNum = chanInfo->lliCnt; i < lliNum; i++, plli++) {
-        plli->nextLli = (uintptr_t)cntlr->dmacVaddrToPaddr((void *)plli) + (uintptr_t)sizeof(struct DmacLli);
-        plli->nextLli = (i < lliNum - 1) ? (plli->nextLli + chanInfo->lliEnFlag) : 0;
-        plli->count = ((i < lliNum - 1) || ((length % alignedMax) == 0)) ? alignedMax : (length % alignedMax);
-
-        plli->srcAddr = srcaddr;
-        plli->destAddr = dstaddr;
-        plli->config = chanInfo->config;
+    for (seg = 0; seg < segNum; seg++) {
+        srcaddr = (segs[seg].srcAddr != 0) ? segs[seg].srcAddr : DmacGetDummyBuf(cntlr, chanInfo);
+        dstaddr = (segs[seg].destAddr != 0) ? segs[seg].destAddr : DmacGetDummyBuf(cntlr, chanInfo);
+        if (srcaddr == 0 || dstaddr == 0) {
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        /* the peripheral side and a dummy side stay put, memory sides walk with the data */
+        srcInc = (chanInfo->transType != TRASFER_TYPE_P2M && segs[seg].srcAddr != 0);
+        dstInc = (chanInfo->transType != TRASFER_TYPE_M2P && segs[seg].destAddr != 0);
+        for (left = segs[seg].len; left > 0; i++, plli++) {
+            plli->nextLli = (uintptr_t)cntlr->dmacVaddrToPaddr((void *)plli) + (uintptr_t)sizeof(struct DmacLli);
+            plli->nextLli = (i < chanInfo->lliCnt - 1) ? (plli->nextLli + chanInfo->lliEnFlag) : 0;
+            plli->count = (left >= alignedMax) ? alignedMax : left;
+
+            plli->srcAddr = srcaddr;
+            plli->destAddr = dstaddr;
+            plli->config = chanInfo->config;
 
 #ifdef DMA_CORE_DEBUG
-        HDF_LOGD("plli=0x%lx, next=0x%lx, count=0x%lx, src=0x%lx, dst=0x%lx, cfg=0x%lx",
-            (uintptr_t)cntlr->dmacVaddrToPaddr(plli), plli->nextLli,
-            plli->count, plli->srcAddr, plli->destAddr, plli->config);
+            HDF_LOGD("plli=0x%lx, next=0x%lx, count=0x%lx, src=0x%lx, dst=0x%lx, cfg=0x%lx",
+                (uintptr_t)cntlr->dmacVaddrToPaddr(plli), plli->nextLli,
+                plli->count, plli->srcAddr, plli->destAddr, plli->config);
 #endif
-        dstaddr += (chanInfo->transType == TRASFER_TYPE_P2M && dstDummy == 0) ? plli->count : 0;
-        srcaddr += (chanInfo->transType == TRASFER_TYPE_M2P && srcDummy == 0) ? plli->count : 0;
+            srcaddr += srcInc ? plli->count : 0;
+            dstaddr += dstInc ? plli->count : 0;
+            left -= plli->count;
+        }
     }
     plli = chanInfo->lli;
-    cntlr->dmacCacheFlush((uintptr_t)plli, (uintptr_t)plli + (uintptr_t)(sizeof(struct DmacLli) * lliNum));
-    return ret;
+    cntlr->dmacCacheFlush((uintptr_t)plli, (uintptr_t)plli + (uintptr_t)(sizeof(struct DmacLli) * chanInfo->lliCnt));
+    return HDF_SUCCESS;
 }
 
-static int32_t DmacAllocLli(struct DmacChanInfo *chanInfo, size_t length, size_t maxSize)
+static int32_t DmacAllocLli(struct DmacChanInfo *chanInfo, size_t lliNum)
 {
-    size_t lliNum;
     size_t allocLength;
     void *allocAddr = NULL;
 
-    if (chanInfo == NULL || maxSize == 0) {
+    if (chanInfo == NULL || lliNum == 0) {
         return HDF_ERR_INVALID_PARAM;
     }
-    lliNum = (length / maxSize) + ((length % maxSize) > 0 ? 1 : 0);
     if (lliNum > 2048) {  /* 2048: lliNum is not more than 2048 */
-        HDF_LOGE("%s: lliNum %u is bigger than 2048", __func__, lliNum);
+        HDF_LOGE("%s: lliNum %zu is bigger than 2048", __func__, lliNum);
         return HDF_ERR_INVALID_PARAM;
     }
 
@@ -377,9 +386,39 @@ static int32_t DmacAllocLli(struct DmacChanInfo *chanInfo, size_t length, size_t
     return HDF_SUCCESS;
 }
 
-static int32_t DmacPeriphTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
+static int32_t DmacBuildLli(struct DmaCntlr *cntlr, struct DmacChanInfo *chanInfo,
+    const struct DmacSgSeg *segs, uint16_t segNum)
 {
     int32_t ret;
+    size_t alignedMax;
+
+    alignedMax = DmacAlignedTransMax(cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth);
+    if (alignedMax == 0) {
+        HDF_LOGE("%s: maxTransSize:%zu srcWidth:%u dstWidth:%u", __func__,
+            cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ret = DmacAllocLli(chanInfo, DmacSgLliNum(segs, segNum, alignedMax));
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    ret = DmacFillLli(cntlr, chanInfo, segs, segNum, alignedMax);
+    if (ret != HDF_SUCCESS) {
+        DmacFreeLli(chanInfo);
+    }
+    return ret;
+}
+
+/*
+ * The whole transfer is described once as an lli chain and handed to the channel in one go, so the
+ * engine walks every chunk and segment without a cpu round trip in between.
+ */
+static int32_t DmacChainTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgSeg *segs, uint16_t segNum, bool async)
+{
+    int32_t ret;
+    DmacCallback *callback = NULL;
+    void *callbackData = NULL;
     struct DmacChanInfo *chanInfo = NULL;
 
     chanInfo = DmacRequestChannel(cntlr, msg);
@@ -387,32 +426,55 @@ static int32_t DmacPeriphTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
         HDF_LOGE("%s: request channel failed", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
-    if (msg->srcAddr == 0 && msg->destAddr == 0) {
-        HDF_LOGE("%s: src addr & dest addr both null", __func__);
-        return HDF_ERR_INVALID_PARAM;
-    }
     chanInfo->callbackData = msg->para;
     chanInfo->callback = (DmacCallback *)msg->cb;
-    ret = DmacAllocLli(chanInfo, msg->transLen,
-        DmacAlignedTransMax(cntlr->maxTransSize, chanInfo->srcWidth, chanInfo->destWidth));
-    if (ret != HDF_SUCCESS) {
-        DmacFreeChannel(cntlr, chanInfo->channel);
-        return ret;
-    }
-    ret = DmacFillLli(cntlr, chanInfo, msg->srcAddr, msg->destAddr, msg->transLen);
+    chanInfo->async = async;
+    ret = DmacBuildLli(cntlr, chanInfo, segs, segNum);
     if (ret != HDF_SUCCESS) {
-        DmacFreeLli(chanInfo);
         DmacFreeChannel(cntlr, chanInfo->channel);
         return ret;
     }
-    ret = cntlr->dmaChanEnable(cntlr, chanInfo);
+    callback = chanInfo->callback;
+    callbackData = chanInfo->callbackData;
+    ret = (msg->transType == TRASFER_TYPE_M2M) ? cntlr->dmaM2mLliEnable(cntlr, chanInfo) :
+        cntlr->dmaChanEnable(cntlr, chanInfo);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: enable channel failed", __func__);
-        DmacFreeLli(chanInfo);
         DmacFreeChannel(cntlr, chanInfo->channel);
+        // the irq never comes for a chain that didn't start, report it like the per-chunk m2m path does
+        if (callback != NULL) {
+            callback(callbackData, DMAC_CHN_ERROR);
+        }
         return HDF_FAILURE;
     }
-    return HDF_SUCCESS;
+    if (msg->transType != TRASFER_TYPE_M2M || async) {
+        return HDF_SUCCESS; // the channel belongs to the irq from here on
+    }
+
+    ret = DmacWaitM2mSendComplete(cntlr, chanInfo);
+    if (ret != DMAC_CHN_SUCCESS) {
+        HDF_LOGE("%s: m2m transfer failed, ret = %d", __func__, ret);
+        cntlr->dmacChanDisable(cntlr, chanInfo->channel);
+    }
+    DmacFreeChannel(cntlr, chanInfo->channel);
+    if (callback != NULL) {
+        callback(callbackData, ret);
+    }
+    return (ret == DMAC_CHN_SUCCESS) ? HDF_SUCCESS : HDF_FAILURE;
+}
+
+static int32_t DmacPeriphTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
+{
+    struct DmacSgSeg seg;
+
+    if (msg->srcAddr == 0 && msg->destAddr == 0) {
+        HDF_LOGE("%s: src addr & dest addr both null", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    seg.srcAddr = msg->srcAddr;
+    seg.destAddr = msg->destAddr;
+    seg.len = msg->transLen;
+    return DmacChainTransfer(cntlr, msg, &seg, 1, true);
 }
 
 static int32_t DmacM2mTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
@@ -421,11 +483,18 @@ static int32_t DmacM2mTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
     size_t leftSize;
     size_t dmaSize;
     size_t dmaCount = 0;
+    struct DmacSgSeg seg;
     struct DmacChanInfo *chanInfo = NULL;
 
     if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
         return HDF_ERR_INVALID_OBJECT;
     }
+    if (cntlr->dmaM2mLliEnable != NULL) {
+        seg.srcAddr = msg->srcAddr;
+        seg.destAddr = msg->destAddr;
+        seg.len = msg->transLen;
+        return DmacChainTransfer(cntlr, msg, &seg, 1, false);
+    }
 
     chanInfo = DmacRequestChannel(cntlr, msg);
     if (chanInfo == NULL) {
@@ -434,8 +503,6 @@ static int32_t DmacM2mTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
     }
     chanInfo->callback = msg->cb;
     chanInfo->callbackData = msg->para;
-    cntlr->dmacCacheFlush((uintptr_t)msg->srcAddr, (uintptr_t)(msg->srcAddr + msg->transLen));
-    cntlr->dmacCacheInv((uintptr_t)msg->destAddr, (uintptr_t)(msg->destAddr + msg->transLen));
     leftSize = msg->transLen;
     while (leftSize > 0) {
         dmaSize = (leftSize >= cntlr->maxTransSize) ? cntlr->maxTransSize : leftSize;
@@ -468,35 +535,80 @@ static int32_t DmacM2mTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
     return HDF_SUCCESS;
 }
 
-int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
+static void DmacSyncCache(struct DmaCntlr *cntlr, uint8_t transType, uintptr_t srcAddr, uintptr_t destAddr,
+    size_t len)
 {
     uintptr_t phyAddr;
 
+    if (transType == TRASFER_TYPE_P2M) {
+        if (destAddr != 0) {
+            phyAddr = (uintptr_t)cntlr->dmacPaddrToVaddr((paddr_t)destAddr);
+            cntlr->dmacCacheInv(phyAddr, (uintptr_t)(phyAddr + len));
+        }
+    } else if (transType == TRASFER_TYPE_M2P) {
+        if (srcAddr != 0) {
+            phyAddr = (uintptr_t)cntlr->dmacPaddrToVaddr((paddr_t)srcAddr);
+            cntlr->dmacCacheFlush(phyAddr, (uintptr_t)(phyAddr + len));
+        }
+    } else if (transType == TRASFER_TYPE_M2M) {
+        cntlr->dmacCacheFlush(srcAddr, (uintptr_t)(srcAddr + len));
+        cntlr->dmacCacheInv(destAddr, (uintptr_t)(destAddr + len));
+    }
+}
+
+int32_t DmaCntlrTransfer(struct DmaCntlr *cntlr, struct DmacMsg *msg)
+{
     if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
         return HDF_ERR_INVALID_OBJECT;
     }
     if (msg == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
-    if (msg->transType == TRASFER_TYPE_P2M) {
-        if (msg->destAddr != 0) {
-            phyAddr = (uintptr_t)cntlr->dmacPaddrToVaddr((paddr_t)msg->destAddr);
-            cntlr->dmacCacheInv(phyAddr, (uintptr_t)(phyAddr + msg->transLen));
-        }
-    } else if (msg->transType == TRASFER_TYPE_M2P) {
-        if (msg->srcAddr != 0) {
-            phyAddr = (uintptr_t)cntlr->dmacPaddrToVaddr((paddr_t)msg->srcAddr);
-            cntlr->dmacCacheFlush(phyAddr, (uintptr_t)(phyAddr + msg->transLen));
-        }
-    } else if (msg->transType == TRASFER_TYPE_M2M) {
-        return DmacM2mTransfer(cntlr, msg);
-    } else {
+    if (msg->transType != TRASFER_TYPE_M2M && msg->transType != TRASFER_TYPE_P2M &&
+        msg->transType != TRASFER_TYPE_M2P) {
         HDF_LOGE("%s: invalid transType %d", __func__, msg->transType);
         return HDF_FAILURE;
     }
+    DmacSyncCache(cntlr, msg->transType, msg->srcAddr, msg->destAddr, msg->transLen);
+    if (msg->transType == TRASFER_TYPE_M2M) {
+        return DmacM2mTransfer(cntlr, msg);
+    }
     return DmacPeriphTransfer(cntlr, msg);
 }
 
+int32_t DmaCntlrTransferSg(struct DmaCntlr *cntlr, struct DmacMsg *msg,
+    const struct DmacSgSeg *segs, uint16_t segNum)
+{
+    uint16_t i;
+
+    if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (msg == NULL || segs == NULL || segNum == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (msg->transType != TRASFER_TYPE_M2M && msg->transType != TRASFER_TYPE_P2M &&
+        msg->transType != TRASFER_TYPE_M2P) {
+        HDF_LOGE("%s: invalid transType %d", __func__, msg->transType);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (msg->transType == TRASFER_TYPE_M2M && cntlr->dmaM2mLliEnable == NULL) {
+        HDF_LOGE("%s: m2m lli chain not supported", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    for (i = 0; i < segNum; i++) {
+        if (segs[i].len == 0 || (segs[i].srcAddr == 0 && segs[i].destAddr == 0) ||
+            (msg->transType == TRASFER_TYPE_M2M && (segs[i].srcAddr == 0 || segs[i].destAddr == 0))) {
+            HDF_LOGE("%s: invalid segment %u", __func__, i);
+            return HDF_ERR_INVALID_PARAM;
+        }
+    }
+    for (i = 0; i < segNum; i++) {
+        DmacSyncCache(cntlr, msg->transType, segs[i].srcAddr, segs[i].destAddr, segs[i].len);
+    }
+    return DmacChainTransfer(cntlr, msg, segs, segNum, true);
+}
+
 uintptr_t DmaGetCurrChanDestAddr(struct DmaCntlr *cntlr, uint16_t chan)
 {
     if (DmacCntlrCheck(cntlr) != HDF_SUCCESS) {
@@ -523,7 +635,7 @@ static uint32_t DmacIsr(uint32_t irq, void *dev)
         channelStatus = cntlr->dmacGetChanStatus(cntlr, i);
         if (channelStatus == DMAC_CHN_SUCCESS || channelStatus == DMAC_CHN_ERROR) {
             cntlr->channelList[i].status = channelStatus;
-            DmacCallbackHandle(&(cntlr->channelList[i]));
+            DmacCallbackHandle(cntlr, &(cntlr->channelList[i]));
             DmacFreeChannel(cntlr, cntlr->channelList[i].channel);
         }
     }
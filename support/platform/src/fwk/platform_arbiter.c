@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "platform_arbiter.h"
+#include "platform_core.h"
+#include "platform_log.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG platform_arbiter
+
+int32_t PlatformArbiterInit(struct PlatformArbiter *arbiter)
+{
+    uint32_t i;
+
+    if (arbiter == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    (void)memset_s(arbiter, sizeof(*arbiter), 0, sizeof(*arbiter));
+    if (OsalSpinInit(&arbiter->spin) != HDF_SUCCESS) {
+        PLAT_LOGE("PlatformArbiterInit: init spin fail!");
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < PLATFORM_PRIORITY_NUM; i++) {
+        if (OsalSemInit(&arbiter->sems[i], 0) != HDF_SUCCESS) {
+            PLAT_LOGE("PlatformArbiterInit: init sem %u fail!", i);
+            while (i > 0) {
+                (void)OsalSemDestroy(&arbiter->sems[--i]);
+            }
+            (void)OsalSpinDestroy(&arbiter->spin);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+void PlatformArbiterUninit(struct PlatformArbiter *arbiter)
+{
+    uint32_t i;
+
+    if (arbiter == NULL) {
+        return;
+    }
+    for (i = 0; i < PLATFORM_PRIORITY_NUM; i++) {
+        (void)OsalSemDestroy(&arbiter->sems[i]);
+    }
+    (void)OsalSpinDestroy(&arbiter->spin);
+}
+
+static uint32_t PlatformArbiterWaitUs(uint64_t startUs)
+{
+    uint64_t us = PlatformMonoTimeUs() - startUs;
+
+    return (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
+
+/* must be called with the spin locked */
+static void PlatformArbiterAccount(struct PlatformArbiter *arbiter, uint32_t prio, uint32_t waitUs)
+{
+    struct PlatformArbiterStat *stat = &arbiter->stat;
+
+    stat->grants[prio]++;
+    stat->waitLastUs[prio] = waitUs;
+    stat->waitTotalUs[prio] += waitUs;
+    if (waitUs > stat->waitMaxUs[prio]) {
+        stat->waitMaxUs[prio] = waitUs;
+    }
+}
+
+/* must be called with the spin locked, picks the highest waiting priority above the floor */
+static int32_t PlatformArbiterPickWaiter(const struct PlatformArbiter *arbiter, uint32_t floor)
+{
+    uint32_t prio;
+
+    for (prio = PLATFORM_PRIORITY_NUM; prio > floor; prio--) {
+        if (arbiter->waiting[prio - 1] > 0) {
+            return (int32_t)(prio - 1);
+        }
+    }
+    return -1;
+}
+
+int32_t PlatformArbiterAcquire(struct PlatformArbiter *arbiter, uint32_t prio, uint32_t timeoutMs)
+{
+    int32_t ret;
+    uint64_t startUs;
+
+    if (arbiter == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (prio >= PLATFORM_PRIORITY_NUM) {
+        PLAT_LOGE("PlatformArbiterAcquire: invalid prio:%u", prio);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalSpinLock(&arbiter->spin);
+    if (!arbiter->busy) {
+        arbiter->busy = true;
+        arbiter->holderPrio = prio;
+        PlatformArbiterAccount(arbiter, prio, 0);
+        (void)OsalSpinUnlock(&arbiter->spin);
+        return HDF_SUCCESS;
+    }
+    arbiter->waiting[prio]++;
+    (void)OsalSpinUnlock(&arbiter->spin);
+
+    startUs = PlatformMonoTimeUs();
+    ret = OsalSemWait(&arbiter->sems[prio], timeoutMs);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalSpinLock(&arbiter->spin);
+        if (arbiter->waiting[prio] > 0) {
+            arbiter->waiting[prio]--;
+            arbiter->stat.timeouts++;
+            (void)OsalSpinUnlock(&arbiter->spin);
+            return HDF_ERR_TIMEOUT;
+        }
+        (void)OsalSpinUnlock(&arbiter->spin);
+        // the bus was handed to this priority right after the timeout, the post is on its way
+        (void)OsalSemWait(&arbiter->sems[prio], HDF_WAIT_FOREVER);
+    }
+
+    (void)OsalSpinLock(&arbiter->spin);
+    PlatformArbiterAccount(arbiter, prio, PlatformArbiterWaitUs(startUs));
+    (void)OsalSpinUnlock(&arbiter->spin);
+    return HDF_SUCCESS;
+}
+
+void PlatformArbiterRelease(struct PlatformArbiter *arbiter)
+{
+    int32_t next;
+
+    if (arbiter == NULL) {
+        return;
+    }
+
+    (void)OsalSpinLock(&arbiter->spin);
+    next = PlatformArbiterPickWaiter(arbiter, 0);
+    if (next < 0) {
+        arbiter->busy = false;
+        (void)OsalSpinUnlock(&arbiter->spin);
+        return;
+    }
+    // hand over directly, the bus stays busy so a newcomer can't overtake the waiter
+    arbiter->waiting[next]--;
+    arbiter->holderPrio = (uint32_t)next;
+    (void)OsalSpinUnlock(&arbiter->spin);
+    (void)OsalSemPost(&arbiter->sems[next]);
+}
+
+bool PlatformArbiterYield(struct PlatformArbiter *arbiter)
+{
+    int32_t next;
+    uint32_t own;
+
+    if (arbiter == NULL) {
+        return false;
+    }
+
+    (void)OsalSpinLock(&arbiter->spin);
+    own = arbiter->holderPrio;
+    next = PlatformArbiterPickWaiter(arbiter, own + 1);
+    if (next < 0) {
+        (void)OsalSpinUnlock(&arbiter->spin);
+        return false;
+    }
+    arbiter->waiting[next]--;
+    arbiter->holderPrio = (uint32_t)next;
+    arbiter->waiting[own]++;
+    arbiter->stat.yields++;
+    (void)OsalSpinUnlock(&arbiter->spin);
+
+    (void)OsalSemPost(&arbiter->sems[next]);
+    // queued again at the own priority, get the bus back once the higher ones are done
+    (void)OsalSemWait(&arbiter->sems[own], HDF_WAIT_FOREVER);
+    return true;
+}
+
+bool PlatformArbiterHasHigherWaiter(struct PlatformArbiter *arbiter)
+{
+    bool higher = false;
+
+    if (arbiter == NULL) {
+        return false;
+    }
+
+    (void)OsalSpinLock(&arbiter->spin);
+    if (arbiter->busy) {
+        higher = PlatformArbiterPickWaiter(arbiter, arbiter->holderPrio + 1) >= 0;
+    }
+    (void)OsalSpinUnlock(&arbiter->spin);
+    return higher;
+}
+
+int32_t PlatformArbiterGetStat(struct PlatformArbiter *arbiter, struct PlatformArbiterStat *stat)
+{
+    if (arbiter == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalSpinLock(&arbiter->spin);
+    *stat = arbiter->stat;
+    (void)OsalSpinUnlock(&arbiter->spin);
+    return HDF_SUCCESS;
+}
@@ -6,10 +6,18 @@
  * See the LICENSE file in the root of this repository for complete details.
  */
 
+#ifdef __KERNEL__
+#include <linux/ktime.h>
+#else
+#include <time.h>
+#endif
 #include "hdf_log.h"
 #include "osal_spinlock.h"
 #include "platform_core.h"
 
+#define PLATFORM_US_PER_SECOND 1000000ULL
+#define PLATFORM_NS_PER_US     1000
+
 static struct PlatformModuleInfo g_platformModules[] = {
 #if defined(LOSCFG_DRIVERS_HDF_PLATFORM_GPIO) || defined(CONFIG_DRIVERS_HDF_PLATFORM_GPIO)
     {
@@ -184,6 +192,20 @@ void PlatformGlobalUnlock(void)
     (void)OsalSpinUnlock(&g_platformSpin);
 }
 
+uint64_t PlatformMonoTimeUs(void)
+{
+#ifdef __KERNEL__
+    return (uint64_t)ktime_to_us(ktime_get());
+#else
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+    return (uint64_t)ts.tv_sec * PLATFORM_US_PER_SECOND + (uint64_t)ts.tv_nsec / PLATFORM_NS_PER_US;
+#endif
+}
+
 struct PlatformModuleInfo *PlatformModuleInfoGet(enum PlatformModuleType moduleType)
 {
     int32_t i;
@@ -21,21 +21,34 @@ extern "C" {
 
 struct PlatformEventWaiter {
     struct DListHead node;
+    struct DListHead pendingNode;
     struct OsalSem sem;
     uint32_t mask;
     uint32_t mode;
+    uint32_t events;
+    int32_t bucket;
     void *data;
     int32_t (*cb)(struct PlatformEventWaiter *waiter, int32_t events);
 };
 
+#define PLAT_EVENT_BUCKET_NONE (-1)
+
 int32_t PlatformEventInit(struct PlatformEvent *pe)
 {
+    int32_t i;
+
     if (pe == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
     pe->eventsWord = 0;
     pe->waiterCnt = 0;
+    pe->bitWaiterMask = 0;
+    pe->wakePolicy = PLAT_EVENT_WAKE_ONE;
     DListHeadInit(&pe->waiters);
+    DListHeadInit(&pe->pendingListeners);
+    for (i = 0; i < PLAT_EVENT_BITS; i++) {
+        DListHeadInit(&pe->bitWaiters[i]);
+    }
     (void)OsalSpinInit(&pe->spin);
     (void)OsalSemInit(&pe->sem, 0);
     return HDF_SUCCESS;
@@ -51,18 +64,73 @@ static void PlatformEventUnlock(struct PlatformEvent *pe)
     (void)OsalSpinUnlockIrqRestore(&pe->spin, &pe->irqSave);
 }
 
-static void PlatformEventClearWaiters(struct PlatformEvent *pe)
+static int32_t PlatformEventLowestBit(uint32_t word)
+{
+    int32_t bit;
+
+    for (bit = 0; bit < PLAT_EVENT_BITS; bit++) {
+        if ((word & (0x1U << (uint32_t)bit)) != 0) {
+            return bit;
+        }
+    }
+    return PLAT_EVENT_BUCKET_NONE;
+}
+
+/*
+ * A waiter can only be satisfied when the lowest bit of its mask is set, unless it waits in OR mode
+ * for several bits. So we index all the others by that bit, and a post only visits the buckets of the
+ * bits currently set in the events word.
+ */
+static void PlatformEventAddWaiter(struct PlatformEvent *pe, struct PlatformEventWaiter *waiter)
+{
+    bool multiBits = (waiter->mask & (waiter->mask - 1)) != 0;
+
+    if (multiBits && (waiter->mode & PLAT_EVENT_MODE_AND) == 0) {
+        waiter->bucket = PLAT_EVENT_BUCKET_NONE;
+        DListInsertTail(&waiter->node, &pe->waiters);
+    } else {
+        waiter->bucket = PlatformEventLowestBit(waiter->mask);
+        DListInsertTail(&waiter->node, &pe->bitWaiters[waiter->bucket]);
+        pe->bitWaiterMask |= (0x1U << (uint32_t)waiter->bucket);
+    }
+    pe->waiterCnt++;
+}
+
+static void PlatformEventDelWaiter(struct PlatformEvent *pe, struct PlatformEventWaiter *waiter)
+{
+    DListRemove(&waiter->node);
+    if (waiter->bucket != PLAT_EVENT_BUCKET_NONE && DListIsEmpty(&pe->bitWaiters[waiter->bucket])) {
+        pe->bitWaiterMask &= ~(0x1U << (uint32_t)waiter->bucket);
+    }
+    if (waiter->pendingNode.next != NULL) {
+        DListRemove(&waiter->pendingNode);
+    }
+    pe->waiterCnt--;
+}
+
+static void PlatformEventClearWaiterList(struct PlatformEvent *pe, struct DListHead *list)
 {
     struct PlatformEventWaiter *waiter = NULL;
     struct PlatformEventWaiter *tmp = NULL;
 
-    PlatformEventLock(pe);
-    DLIST_FOR_EACH_ENTRY_SAFE(waiter, tmp, &pe->waiters, struct PlatformEventWaiter, node) {
-        DListRemove(&waiter->node);
+    DLIST_FOR_EACH_ENTRY_SAFE(waiter, tmp, list, struct PlatformEventWaiter, node) {
+        PlatformEventDelWaiter(pe, waiter);
         if ((waiter->mode & PLAT_EVENT_MODE_ASYNC) != 0) {
             OsalMemFree(waiter);
         }
     }
+}
+
+static void PlatformEventClearWaiters(struct PlatformEvent *pe)
+{
+    int32_t i;
+
+    PlatformEventLock(pe);
+    PlatformEventClearWaiterList(pe, &pe->waiters);
+    for (i = 0; i < PLAT_EVENT_BITS; i++) {
+        PlatformEventClearWaiterList(pe, &pe->bitWaiters[i]);
+    }
+    pe->bitWaiterMask = 0;
     PlatformEventUnlock(pe);
 }
 
@@ -77,58 +145,137 @@ int32_t PlatformEventUninit(struct PlatformEvent *pe)
     return HDF_SUCCESS;
 }
 
-int32_t PlatformEventPost(struct PlatformEvent *pe, uint32_t events)
+int32_t PlatformEventSetWakePolicy(struct PlatformEvent *pe, uint32_t policy)
 {
-    int32_t ret;
-    uint32_t masked;
-    struct PlatformEventWaiter *waiter = NULL;
-    struct PlatformEventWaiter *pos = NULL;
-    struct PlatformEventWaiter *tmp = NULL;
-
     if (pe == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    if (events == 0) {
+    if (policy != PLAT_EVENT_WAKE_ONE && policy != PLAT_EVENT_WAKE_ALL) {
         return HDF_ERR_INVALID_PARAM;
     }
 
     PlatformEventLock(pe);
-    pe->eventsWord |= events;
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &pe->waiters, struct PlatformEventWaiter, node) {
-        if (((pos->mode & PLAT_EVENT_MODE_AND) == 0) &&
-            ((pe->eventsWord & pos->mask) != 0)) {
-            waiter = pos;
-            break;
+    pe->wakePolicy = policy;
+    PlatformEventUnlock(pe);
+    return HDF_SUCCESS;
+}
+
+static inline bool PlatformEventWaiterMatch(const struct PlatformEventWaiter *waiter, uint32_t eventsWord)
+{
+    if ((waiter->mode & PLAT_EVENT_MODE_AND) != 0) {
+        return (eventsWord & waiter->mask) == waiter->mask;
+    }
+    return (eventsWord & waiter->mask) != 0;
+}
+
+/*
+ * Deliver the events to one waiter, must be called with the lock held.
+ * Sync waiters are removed and woken here, so a timed out waiter can tell whether it was delivered.
+ * Async listeners are queued and called back after the lock is released.
+ */
+static void PlatformEventDeliver(struct PlatformEvent *pe, struct PlatformEventWaiter *waiter, uint32_t masked)
+{
+    waiter->events |= masked;
+    if ((waiter->mode & PLAT_EVENT_MODE_ASYNC) == 0) {
+        PlatformEventDelWaiter(pe, waiter);
+        (void)OsalSemPost(&waiter->sem);
+    } else if (waiter->pendingNode.next == NULL) {
+        DListInsertTail(&waiter->pendingNode, &pe->pendingListeners);
+    }
+}
+
+static uint32_t PlatformEventWakeList(struct PlatformEvent *pe, struct DListHead *list, bool wakeAll,
+    uint32_t eventsWord)
+{
+    uint32_t masked;
+    uint32_t consumed = 0;
+    struct PlatformEventWaiter *pos = NULL;
+    struct PlatformEventWaiter *tmp = NULL;
+
+    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, list, struct PlatformEventWaiter, node) {
+        if (!PlatformEventWaiterMatch(pos, eventsWord)) {
+            continue;
         }
-        if (((pos->mode & PLAT_EVENT_MODE_AND) != 0) &&
-            ((pe->eventsWord & pos->mask) == pos->mask)) {
-            waiter = pos;
+        masked = eventsWord & pos->mask;
+        PlatformEventDeliver(pe, pos, masked);
+        consumed |= masked;
+        if (!wakeAll) {
             break;
         }
     }
-    if (waiter != NULL) {
-        masked = pe->eventsWord & waiter->mask;
-        if ((waiter->mode & PLAT_EVENT_MODE_ASYNC) != 0) {
-            pe->eventsWord &= ~masked;
-        } else {
-            DListRemove(&waiter->node);
+    return consumed;
+}
+
+static uint32_t PlatformEventWakeWaiters(struct PlatformEvent *pe, bool wakeAll)
+{
+    int32_t bit;
+    uint32_t consumed = 0;
+    uint32_t buckets = pe->bitWaiterMask & pe->eventsWord;
+
+    // all the matching waiters see the same events word, the delivered bits are consumed at last
+    while (buckets != 0) {
+        bit = PlatformEventLowestBit(buckets);
+        buckets &= ~(0x1U << (uint32_t)bit);
+        consumed |= PlatformEventWakeList(pe, &pe->bitWaiters[bit], wakeAll, pe->eventsWord);
+        if (!wakeAll && consumed != 0) {
+            return consumed;
         }
     }
-    PlatformEventUnlock(pe);
+    consumed |= PlatformEventWakeList(pe, &pe->waiters, wakeAll, pe->eventsWord);
+    return consumed;
+}
 
-    if (waiter == NULL) {
-        return HDF_SUCCESS;
+static int32_t PlatformEventNotifyListeners(struct PlatformEvent *pe)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t events;
+    struct PlatformEventWaiter *waiter = NULL;
+
+    while (true) {
+        PlatformEventLock(pe);
+        if (DListIsEmpty(&pe->pendingListeners)) {
+            PlatformEventUnlock(pe);
+            break;
+        }
+        waiter = DLIST_FIRST_ENTRY(&pe->pendingListeners, struct PlatformEventWaiter, pendingNode);
+        DListRemove(&waiter->pendingNode);
+        events = waiter->events;
+        waiter->events = 0;
+        PlatformEventUnlock(pe);
+
+        ret = (waiter->cb != NULL) ? waiter->cb(waiter, (int32_t)events) : HDF_ERR_INVALID_PARAM;
     }
+    return ret;
+}
 
-    if ((waiter->mode & PLAT_EVENT_MODE_ASYNC) == 0) {
-        ret = OsalSemPost(&waiter->sem);
-    } else if (waiter->cb != NULL) {
-        ret = waiter->cb(waiter, masked);
-    } else {
-        ret = HDF_ERR_INVALID_PARAM;
+static int32_t PlatformEventPostInner(struct PlatformEvent *pe, uint32_t events, bool wakeAll)
+{
+    if (pe == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (events == 0) {
+        return HDF_ERR_INVALID_PARAM;
     }
 
-    return ret;
+    PlatformEventLock(pe);
+    pe->eventsWord |= events;
+    pe->eventsWord &= ~PlatformEventWakeWaiters(pe, wakeAll);
+    PlatformEventUnlock(pe);
+
+    return PlatformEventNotifyListeners(pe);
+}
+
+int32_t PlatformEventPost(struct PlatformEvent *pe, uint32_t events)
+{
+    if (pe == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return PlatformEventPostInner(pe, events, pe->wakePolicy == PLAT_EVENT_WAKE_ALL);
+}
+
+int32_t PlatformEventBroadcast(struct PlatformEvent *pe, uint32_t events)
+{
+    return PlatformEventPostInner(pe, events, true);
 }
 
 static int32_t PlatformEventRead(struct PlatformEvent *pe, uint32_t *events, uint32_t mask, int32_t mode)
@@ -159,31 +306,37 @@ static int32_t PlatformEventReadSlowlly(struct PlatformEvent *pe,
     uint32_t *events, uint32_t mask, int32_t mode, uint32_t tms)
 {
     int32_t ret;
+    bool delivered = false;
     struct PlatformEventWaiter waiter;
 
     waiter.mask = mask;
     waiter.mode = (uint32_t)mode & (uint32_t)(~PLAT_EVENT_MODE_ASYNC);
+    waiter.events = 0;
+    waiter.pendingNode.next = NULL;
+    waiter.pendingNode.prev = NULL;
     (void)OsalSemInit(&waiter.sem, 0);
     DListHeadInit(&waiter.node);
 
     PlatformEventLock(pe);
-    DListInsertTail(&waiter.node, &pe->waiters);
+    PlatformEventAddWaiter(pe, &waiter);
     PlatformEventUnlock(pe);
 
     ret = OsalSemWait(&waiter.sem, tms);
-    if (ret == HDF_SUCCESS) {
-        (void)OsalSemDestroy(&waiter.sem);
-        return PlatformEventRead(pe, events, mask, mode);
-    }
 
     PlatformEventLock(pe);
-    // the waiter may be still in the list, we need to check...
-    if (waiter.node.next != NULL && !DListIsEmpty(&waiter.node)) {
-        DListRemove(&waiter.node);
+    // the waiter may be still in the list, or be delivered right after the timeout, we need to check...
+    if (waiter.node.next != NULL) {
+        PlatformEventDelWaiter(pe, &waiter);
+    } else {
+        delivered = true;
     }
     PlatformEventUnlock(pe);
 
     (void)OsalSemDestroy(&waiter.sem);
+    if (delivered) {
+        *events = waiter.events;
+        return HDF_SUCCESS;
+    }
     return ret;
 }
 
@@ -250,32 +403,44 @@ int32_t PlatformEventListen(struct PlatformEvent *pe, const struct PlatformEvent
 
     PlatformEventLock(pe);
     DListHeadInit(&waiter->node);
-    DListInsertTail(&waiter->node, &pe->waiters);
+    PlatformEventAddWaiter(pe, waiter);
     PlatformEventUnlock(pe);
 
     return HDF_SUCCESS;
 }
 
-void PlatformEventUnlisten(struct PlatformEvent *pe, const struct PlatformEventListener *listener)
+static bool PlatformEventUnlistenList(struct PlatformEvent *pe, struct DListHead *list,
+    const struct PlatformEventListener *listener)
 {
     struct PlatformEventWaiter *waiter = NULL;
     struct PlatformEventWaiter *tmp = NULL;
 
-    if (pe == NULL || listener == NULL) {
-        return;
-    }
-
-    PlatformEventLock(pe);
-    DLIST_FOR_EACH_ENTRY_SAFE(waiter, tmp, &pe->waiters, struct PlatformEventWaiter, node) {
+    DLIST_FOR_EACH_ENTRY_SAFE(waiter, tmp, list, struct PlatformEventWaiter, node) {
         if ((waiter->mode & PLAT_EVENT_MODE_ASYNC) == 0) {
             continue;
         }
         if (waiter->data == (void *)listener) {
-            DListRemove(&waiter->node);
+            PlatformEventDelWaiter(pe, waiter);
             OsalMemFree(waiter);
-            break;
+            return true;
         }
     }
+    return false;
+}
+
+void PlatformEventUnlisten(struct PlatformEvent *pe, const struct PlatformEventListener *listener)
+{
+    int32_t bucket;
+
+    if (pe == NULL || listener == NULL || listener->mask == 0) {
+        return;
+    }
+
+    PlatformEventLock(pe);
+    bucket = PlatformEventLowestBit(listener->mask);
+    if (!PlatformEventUnlistenList(pe, &pe->bitWaiters[bucket], listener)) {
+        (void)PlatformEventUnlistenList(pe, &pe->waiters, listener);
+    }
     PlatformEventUnlock(pe);
 }
 
@@ -10,9 +10,18 @@
 #include "hdf_log.h"
 #include "osal_mem.h"
 #include "osal_sem.h"
+#include "osal_time.h"
 #include "platform_core.h"
 
 #define PLATFORM_MANAGER_NAME_DEFAULT "PlatformManagerDefault"
+#define PLATFORM_MANAGER_TABLE_MIN    8
+#define PLATFORM_MANAGER_TABLE_MAX    1024
+#define PLATFORM_MANAGER_SYNC_WAIT_MS 1
+
+struct PlatformDeviceTable {
+    uint32_t size;
+    struct PlatformDevice **slots;
+};
 
 static inline void PlatformManagerLock(struct PlatformManager *manager)
 {
@@ -24,13 +33,173 @@ static inline void PlatformManagerUnlock(struct PlatformManager *manager)
     (void)OsalSpinUnlockIrqRestore(&manager->device.spin, &manager->device.irqSave);
 }
 
+/*
+ * The number index is read without the manager lock:
+ * a reader registers itself in the readers slot of current epoch before it loads the table, and rechecks
+ * the epoch after that, so the registration can't slip past an updater which already found the slot empty.
+ * An updater unpublishes the table or device under the manager lock, then flips the epoch and waits for the
+ * readers of the old epoch to leave before it puts a device or frees a table. The updaters sync one by one,
+ * so the readers of an older epoch have always drained when the epoch flips.
+ */
+uint32_t PlatformManagerReadEnter(struct PlatformManager *manager)
+{
+    uint32_t epoch;
+    uint32_t slot;
+
+    while (true) {
+        epoch = *(volatile uint32_t *)&manager->epoch;
+        slot = epoch % PLATFORM_MANAGER_READER_SLOTS;
+        (void)OsalAtomicIncReturn(&manager->readers[slot]);
+        // an epoch flipped in between may have waited on the slot before the registration, try again
+        if (*(volatile uint32_t *)&manager->epoch == epoch) {
+            return slot;
+        }
+        (void)OsalAtomicDecReturn(&manager->readers[slot]);
+    }
+}
+
+void PlatformManagerReadExit(struct PlatformManager *manager, uint32_t slot)
+{
+    (void)OsalAtomicDecReturn(&manager->readers[slot % PLATFORM_MANAGER_READER_SLOTS]);
+}
+
+void PlatformManagerSyncReaders(struct PlatformManager *manager)
+{
+    uint32_t slot;
+
+    if (manager == NULL) {
+        return;
+    }
+
+    (void)OsalMutexLock(&manager->syncLock);
+    PlatformManagerLock(manager);
+    slot = manager->epoch % PLATFORM_MANAGER_READER_SLOTS;
+    manager->epoch++;
+    PlatformManagerUnlock(manager);
+
+    PlatformMemBarrier(&manager->version);
+    while (OsalAtomicRead(&manager->readers[slot]) != 0) {
+        OsalMSleep(PLATFORM_MANAGER_SYNC_WAIT_MS);
+    }
+    (void)OsalMutexUnlock(&manager->syncLock);
+}
+
+static struct PlatformDeviceTable *PlatformDeviceTableCreate(uint32_t size)
+{
+    struct PlatformDeviceTable *table = NULL;
+
+    table = (struct PlatformDeviceTable *)OsalMemCalloc(sizeof(*table) + sizeof(struct PlatformDevice *) * size);
+    if (table == NULL) {
+        return NULL;
+    }
+    table->size = size;
+    table->slots = (struct PlatformDevice **)(table + 1);
+    return table;
+}
+
+static inline bool PlatformManagerNumberIndexed(uint32_t number)
+{
+    return number < PLATFORM_MANAGER_TABLE_MAX;
+}
+
+static struct PlatformDeviceTable *PlatformManagerPrepareTable(struct PlatformManager *manager, uint32_t number)
+{
+    uint32_t size = PLATFORM_MANAGER_TABLE_MIN;
+
+    if (!PlatformManagerNumberIndexed(number)) {
+        return NULL;
+    }
+    if (manager->table != NULL && number < manager->table->size) {
+        return NULL;
+    }
+    while (size <= number) {
+        size <<= 1;
+    }
+    return PlatformDeviceTableCreate(size);
+}
+
+/* must be called with manager lock held, returns the table replaced which should be freed after sync */
+static struct PlatformDeviceTable *PlatformManagerIndexDevice(struct PlatformManager *manager,
+    struct PlatformDevice *device, struct PlatformDeviceTable **newTable)
+{
+    uint32_t i;
+    uint32_t number = (uint32_t)device->number;
+    struct PlatformDeviceTable *oldTable = NULL;
+    struct PlatformDeviceTable *table = *newTable;
+
+    if (table != NULL && (manager->table == NULL || manager->table->size < table->size)) {
+        oldTable = manager->table;
+        for (i = 0; oldTable != NULL && i < oldTable->size; i++) {
+            table->slots[i] = oldTable->slots[i];
+        }
+        PlatformMemBarrier(&manager->version);  // slots copied before the table is published
+        manager->table = table;
+        *newTable = NULL;
+    }
+
+    table = manager->table;
+    if (table != NULL && number < table->size && table->slots[number] == NULL) {
+        table->slots[number] = device;
+    }
+    return oldTable;
+}
+
+/* must be called with manager lock held, after the device removed from the list */
+static void PlatformManagerUnindexDevice(struct PlatformManager *manager, struct PlatformDevice *device)
+{
+    uint32_t number = (uint32_t)device->number;
+    struct PlatformDevice *pos = NULL;
+    struct PlatformDeviceTable *table = manager->table;
+
+    if (table == NULL || number >= table->size || table->slots[number] != device) {
+        return;
+    }
+    table->slots[number] = NULL;
+    // a customized add may allow repeated numbers, let the next one take over the slot
+    DLIST_FOR_EACH_ENTRY(pos, &manager->devices, struct PlatformDevice, node) {
+        if ((uint32_t)pos->number == number) {
+            table->slots[number] = pos;
+            break;
+        }
+    }
+}
+
+static struct PlatformDevice *PlatformManagerIndexGet(struct PlatformManager *manager, uint32_t number)
+{
+    uint32_t slot;
+    struct PlatformDeviceTable *table = NULL;
+    struct PlatformDevice *device = NULL;
+
+    slot = PlatformManagerReadEnter(manager);
+    table = *(struct PlatformDeviceTable * volatile *)&manager->table;
+    if (table != NULL && number < table->size) {
+        device = *(struct PlatformDevice * volatile *)&table->slots[number];
+        if (device != NULL && PlatformDeviceGet(device) != HDF_SUCCESS) {
+            device = NULL;
+        }
+    }
+    PlatformManagerReadExit(manager, slot);
+    return device;
+}
+
 static int32_t PlatformManagerInit(struct PlatformManager *manager)
 {
     int32_t ret;
+    int32_t i;
 
     DListHeadInit(&manager->devices);
+    manager->table = NULL;
+    manager->epoch = 0;
+    OsalAtomicSet(&manager->version, 0);
+    for (i = 0; i < PLATFORM_MANAGER_READER_SLOTS; i++) {
+        OsalAtomicSet(&manager->readers[i], 0);
+    }
 
+    if ((ret = OsalMutexInit(&manager->syncLock)) != HDF_SUCCESS) {
+        return ret;
+    }
     if ((ret = PlatformDeviceInit(&manager->device)) != HDF_SUCCESS) {
+        (void)OsalMutexDestroy(&manager->syncLock);
         return ret;
     }
 
@@ -43,6 +212,7 @@ static void PlatformManagerClearDevice(struct PlatformManager *manager)
 {
     struct PlatformDevice *tmp = NULL;
     struct PlatformDevice *pos = NULL;
+    struct PlatformDeviceTable *table = NULL;
 
     if (manager == NULL) {
         return;
@@ -53,13 +223,19 @@ static void PlatformManagerClearDevice(struct PlatformManager *manager)
         DListRemove(&pos->node);
         PlatformDevicePut(pos);  // put the reference hold by manager
     }
+    table = manager->table;
+    manager->table = NULL;
     PlatformManagerUnlock(manager);
+
+    PlatformManagerSyncReaders(manager);
+    OsalMemFree(table);
 }
 
 static void PlatformManagerUninit(struct PlatformManager *manager)
 {
     PlatformManagerClearDevice(manager);
     PlatformDeviceUninit(&manager->device);
+    (void)OsalMutexDestroy(&manager->syncLock);
     manager->add = NULL;
     manager->del = NULL;
 }
@@ -156,6 +332,8 @@ int32_t PlatformManagerAddDevice(struct PlatformManager *manager, struct Platfor
 {
     int32_t ret;
     struct PlatformDevice *pos = NULL;
+    struct PlatformDeviceTable *newTable = NULL;
+    struct PlatformDeviceTable *oldTable = NULL;
 
     if (manager == NULL || device == NULL) {
         return HDF_ERR_INVALID_OBJECT;
@@ -165,6 +343,9 @@ int32_t PlatformManagerAddDevice(struct PlatformManager *manager, struct Platfor
         return HDF_PLT_ERR_DEV_GET;
     }
 
+    // the table can't be allocated with the spinlock held, prepare a bigger one if needed
+    newTable = PlatformManagerPrepareTable(manager, (uint32_t)device->number);
+
     PlatformManagerLock(manager);
     DLIST_FOR_EACH_ENTRY(pos, &manager->devices, struct PlatformDevice, node) {
         if (pos == device) {
@@ -172,6 +353,7 @@ int32_t PlatformManagerAddDevice(struct PlatformManager *manager, struct Platfor
             PLAT_LOGE("%s: device:%s(%d) already in manager:%s", __func__,
                 device->name, device->number, manager->device.name);
             PlatformDevicePut(device);
+            OsalMemFree(newTable);
             return HDF_PLT_ERR_OBJ_REPEAT;
         }
     }
@@ -180,8 +362,17 @@ int32_t PlatformManagerAddDevice(struct PlatformManager *manager, struct Platfor
     } else {
         ret = PlatformManagerAddDeviceDefault(manager, device);
     }
+    if (ret == HDF_SUCCESS) {
+        oldTable = PlatformManagerIndexDevice(manager, device, &newTable);
+    }
     PlatformManagerUnlock(manager);
 
+    OsalMemFree(newTable);
+    if (oldTable != NULL) {
+        PlatformManagerSyncReaders(manager);
+        OsalMemFree(oldTable);
+    }
+
     if (ret == HDF_SUCCESS) {
         PLAT_LOGD("%s: add dev:%s(%d) to %s success", __func__,
             device->name, device->number, manager->device.name);
@@ -235,9 +426,13 @@ int32_t PlatformManagerDelDevice(struct PlatformManager *manager, struct Platfor
     } else {
         ret = PlatformManagerDelDeviceDefault(manager, device);
     }
+    if (ret == HDF_SUCCESS) {
+        PlatformManagerUnindexDevice(manager, device);
+    }
     PlatformManagerUnlock(manager);
 
     if (ret == HDF_SUCCESS) {
+        PlatformManagerSyncReaders(manager);  // no lock free reader may still get it after this
         PlatformDevicePut(device);  // put the reference hold by manager
         PLAT_LOGD("%s: remove %s(%d) from %s success", __func__,
             device->name, device->number, manager->device.name);
@@ -286,9 +481,18 @@ static bool PlatformDeviceMatchByNumber(struct PlatformDevice *device, void *dat
 
 struct PlatformDevice *PlatformManagerGetDeviceByNumber(struct PlatformManager *manager, uint32_t number)
 {
+    struct PlatformDevice *device = NULL;
+
     if (manager == NULL) {
         return NULL;
     }
+    if (PlatformManagerNumberIndexed(number)) {
+        device = PlatformManagerIndexGet(manager, number);
+        if (device != NULL) {
+            return device;
+        }
+    }
+    // not indexed, or left out of the index when a bigger table couldn't be allocated
     return PlatformManagerFindDevice(manager, (void *)(uintptr_t)number, PlatformDeviceMatchByNumber);
 }
 
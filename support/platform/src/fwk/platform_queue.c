@@ -26,6 +26,7 @@ static void PlatformQueueDoDestroy(struct PlatformQueue *queue)
 static int32_t PlatformQueueThreadWorker(void *data)
 {
     int32_t ret;
+    uint32_t flags;
     struct PlatformQueue *queue = (struct PlatformQueue *)data;
     struct PlatformMsg *msg = NULL;
 
@@ -41,14 +42,14 @@ static int32_t PlatformQueueThreadWorker(void *data)
             break;
         }
 
-        (void)OsalSpinLock(&queue->spin);
+        (void)OsalSpinLockIrqSave(&queue->spin, &flags);
         if (DListIsEmpty(&queue->msgs)) {
             msg = NULL;
         } else {
             msg = DLIST_FIRST_ENTRY(&queue->msgs, struct PlatformMsg, node);
             DListRemove(&msg->node);
         }
-        (void)OsalSpinUnlock(&queue->spin);
+        (void)OsalSpinUnlockIrqRestore(&queue->spin, &flags);
         /* message process */
         if (msg != NULL) {
             (void)(queue->handle(queue, msg));
@@ -127,15 +128,17 @@ void PlatformQueueDestroy(struct PlatformQueue *queue)
 
 int32_t PlatformQueueAddMsg(struct PlatformQueue *queue, struct PlatformMsg *msg)
 {
+    uint32_t flags;
+
     if (queue == NULL || msg == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
 
     DListHeadInit(&msg->node);
     msg->error = HDF_SUCCESS;
-    (void)OsalSpinLock(&queue->spin);
+    (void)OsalSpinLockIrqSave(&queue->spin, &flags);
     DListInsertTail(&msg->node, &queue->msgs);
-    (void)OsalSpinUnlock(&queue->spin);
+    (void)OsalSpinUnlockIrqRestore(&queue->spin, &flags);
     /* notify the worker thread */
     (void)OsalSemPost(&queue->sem);
     return HDF_SUCCESS;
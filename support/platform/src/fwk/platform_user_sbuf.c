@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "platform_user_sbuf.h"
+#include <pthread.h>
+#include "hdf_log.h"
+#include "osal_mem.h"
+
+#define HDF_LOG_TAG platform_user_sbuf
+
+struct PlatformUserSbuf {
+    struct HdfSBuf *data;
+    struct HdfSBuf *reply;
+};
+
+static pthread_key_t g_userSbufKey;
+static pthread_once_t g_userSbufOnce = PTHREAD_ONCE_INIT;
+static bool g_userSbufKeyReady = false;
+
+static void PlatformUserSbufFree(void *arg)
+{
+    struct PlatformUserSbuf *sbuf = (struct PlatformUserSbuf *)arg;
+
+    HdfSbufRecycle(sbuf->data);
+    HdfSbufRecycle(sbuf->reply);
+    OsalMemFree(sbuf);
+}
+
+static void PlatformUserSbufKeyCreate(void)
+{
+    g_userSbufKeyReady = (pthread_key_create(&g_userSbufKey, PlatformUserSbufFree) == 0);
+}
+
+static struct PlatformUserSbuf *PlatformUserSbufOfThread(void)
+{
+    struct PlatformUserSbuf *sbuf = NULL;
+
+    (void)pthread_once(&g_userSbufOnce, PlatformUserSbufKeyCreate);
+    if (!g_userSbufKeyReady) {
+        HDF_LOGE("%s: create thread key fail", __func__);
+        return NULL;
+    }
+
+    sbuf = (struct PlatformUserSbuf *)pthread_getspecific(g_userSbufKey);
+    if (sbuf != NULL) {
+        return sbuf;
+    }
+    sbuf = (struct PlatformUserSbuf *)OsalMemCalloc(sizeof(*sbuf));
+    if (sbuf == NULL) {
+        HDF_LOGE("%s: alloc sbuf pair fail", __func__);
+        return NULL;
+    }
+    if (pthread_setspecific(g_userSbufKey, sbuf) != 0) {
+        HDF_LOGE("%s: set thread sbuf fail", __func__);
+        OsalMemFree(sbuf);
+        return NULL;
+    }
+    return sbuf;
+}
+
+int32_t PlatformUserSbufGet(struct HdfSBuf **data, struct HdfSBuf **reply, size_t replySize)
+{
+    struct PlatformUserSbuf *sbuf = NULL;
+
+    if (data == NULL || reply == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    sbuf = PlatformUserSbufOfThread();
+    if (sbuf == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    if (sbuf->data == NULL) {
+        sbuf->data = HdfSbufObtainDefaultSize();
+        if (sbuf->data == NULL) {
+            HDF_LOGE("%s: obtain data fail", __func__);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+    }
+    HdfSbufFlush(sbuf->data);
+
+    // the reply capacity bounds what the service can hand back
+    replySize = (replySize < PLATFORM_USER_SBUF_REPLY_SIZE) ? PLATFORM_USER_SBUF_REPLY_SIZE : replySize;
+    if (sbuf->reply != NULL && HdfSbufGetCapacity(sbuf->reply) < replySize) {
+        HdfSbufRecycle(sbuf->reply);
+        sbuf->reply = NULL;
+    }
+    if (sbuf->reply == NULL) {
+        sbuf->reply = HdfSbufObtain(replySize);
+        if (sbuf->reply == NULL) {
+            HDF_LOGE("%s: obtain reply fail", __func__);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+    }
+    HdfSbufFlush(sbuf->reply);
+
+    *data = sbuf->data;
+    *reply = sbuf->reply;
+    return HDF_SUCCESS;
+}
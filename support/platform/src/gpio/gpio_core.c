@@ -12,8 +12,6 @@
 
 #define HDF_LOG_TAG gpio_core
 
-#define GPIO_IRQ_STACK_SIZE        10000
-
 static inline void GpioInfoLock(struct GpioInfo *ginfo)
 {
     (void)OsalSpinLockIrqSave(&ginfo->spin, &ginfo->irqSave);
@@ -51,6 +49,66 @@ int32_t GpioCntlrRead(struct GpioCntlr *cntlr, uint16_t local, uint16_t *val)
     return cntlr->ops->read(cntlr, local, val);
 }
 
+int32_t GpioCntlrWriteMulti(struct GpioCntlr *cntlr, const uint16_t *locals, const uint16_t *vals, uint16_t count)
+{
+    int32_t ret;
+    uint16_t i;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (locals == NULL || vals == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cntlr->ops == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (cntlr->ops->writeMulti != NULL) {
+        return cntlr->ops->writeMulti(cntlr, locals, vals, count);
+    }
+    if (cntlr->ops->write == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    for (i = 0; i < count; i++) {
+        ret = cntlr->ops->write(cntlr, locals[i], vals[i]);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t GpioCntlrReadMulti(struct GpioCntlr *cntlr, const uint16_t *locals, uint16_t *vals, uint16_t count)
+{
+    int32_t ret;
+    uint16_t i;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (locals == NULL || vals == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cntlr->ops == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (cntlr->ops->readMulti != NULL) {
+        return cntlr->ops->readMulti(cntlr, locals, vals, count);
+    }
+    if (cntlr->ops->read == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    for (i = 0; i < count; i++) {
+        ret = cntlr->ops->read(cntlr, locals[i], &vals[i]);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
 int32_t GpioCntlrSetDir(struct GpioCntlr *cntlr, uint16_t local, uint16_t dir)
 {
     if (cntlr == NULL) {
@@ -117,32 +175,47 @@ void GpioCntlrIrqCallback(struct GpioCntlr *cntlr, uint16_t local)
     GpioInfoUnlock(ginfo);
 }
 
-static int32_t GpioCntlrIrqThreadHandler(void *data)
+static void GpioIrqRecordWork(void *data)
 {
-    int32_t ret;
     uint32_t irqSave;
     struct GpioIrqRecord *irqRecord = (struct GpioIrqRecord *)data;
 
-    while (true) {
-        ret = OsalSemWait(&irqRecord->sem, HDF_WAIT_FOREVER);
-        if (irqRecord->removed) {
-            break;
-        }
-        if (ret != HDF_SUCCESS) {
-            continue;
-        }
-        if (irqRecord->btmFunc != NULL) {
-            (void)irqRecord->btmFunc(irqRecord->global, irqRecord->irqData);
-        }
+    (void)OsalSpinLockIrqSave(&irqRecord->spin, &irqSave);
+    if (irqRecord->removed || irqRecord->pending.count == 0) {
+        (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave);
+        return;
     }
+    irqRecord->event = irqRecord->pending;
+    irqRecord->pending.count = 0;
+    irqRecord->running = true;
+    (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave);
+
+    (void)irqRecord->btmFunc(irqRecord->global, irqRecord->irqData);
+
     (void)OsalSpinLockIrqSave(&irqRecord->spin, &irqSave);
-    (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave); // last post done
-    PLAT_LOGI("GpioCntlrIrqThreadHandler: gpio(%u) thread exit", irqRecord->global);
-    (void)OsalSemDestroy(&irqRecord->sem);
+    irqRecord->running = false;
+    (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave);
+}
+
+void GpioIrqRecordDestroy(struct GpioIrqRecord *irqRecord)
+{
+    bool running = false;
+    uint32_t irqSave;
+
+    if (irqRecord->btmFunc != NULL) {
+        (void)OsalSpinLockIrqSave(&irqRecord->spin, &irqSave);
+        irqRecord->removed = true;
+        running = irqRecord->running;
+        (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave);
+        if (running) {
+            // maybe unset from its own bottom half, so waiting for it here could never return
+            GpioManagerRetireIrqRecord(irqRecord);
+            return;
+        }
+        (void)HdfPoolWorkCancelSync(&irqRecord->work);
+    }
     (void)OsalSpinDestroy(&irqRecord->spin);
-    (void)OsalThreadDestroy(&irqRecord->thread);
-    OsalMemFree(irqRecord);
-    return HDF_SUCCESS;
+    OsalMemFree(irqRecord);  // the last access to this record
 }
 
 static int32_t GpioCntlrSetIrqInner(struct GpioInfo *ginfo, struct GpioIrqRecord *irqRecord)
@@ -176,9 +249,7 @@ static int32_t GpioCntlrSetIrqInner(struct GpioInfo *ginfo, struct GpioIrqRecord
 static int32_t GpioIrqRecordCreate(struct GpioInfo *ginfo, uint16_t mode, GpioIrqFunc func, void *arg,
     struct GpioIrqRecord **new)
 {
-    int32_t ret;
     struct GpioIrqRecord *irqRecord = NULL;
-    struct OsalThreadParam cfg;
 
     irqRecord = (struct GpioIrqRecord *)OsalMemCalloc(sizeof(*irqRecord));
     if (irqRecord == NULL) {
@@ -186,33 +257,25 @@ static int32_t GpioIrqRecordCreate(struct GpioInfo *ginfo, uint16_t mode, GpioIr
         return HDF_ERR_MALLOC_FAIL;
     }
     irqRecord->removed = false;
+    irqRecord->running = false;
     irqRecord->mode = mode;
     irqRecord->irqFunc = ((mode & GPIO_IRQ_USING_THREAD) == 0) ? func : NULL;
     irqRecord->btmFunc = ((mode & GPIO_IRQ_USING_THREAD) != 0) ? func : NULL;
     irqRecord->irqData = arg;
     irqRecord->global = GpioInfoToGlobal(ginfo);
+    irqRecord->pending.gpio = irqRecord->global;
+    irqRecord->event.gpio = irqRecord->global;
+    DListHeadInit(&irqRecord->node);
+    (void)OsalSpinInit(&irqRecord->spin);
     if (irqRecord->btmFunc != NULL) {
-        ret = OsalThreadCreate(&irqRecord->thread, GpioCntlrIrqThreadHandler, irqRecord);
-        if (ret != HDF_SUCCESS) {
-            OsalMemFree(irqRecord);
-            PLAT_LOGE("GpioIrqRecordCreate: create irq thread failed:%d", ret);
-            return ret;
-        }
-        (void)OsalSpinInit(&irqRecord->spin);
-        (void)OsalSemInit(&irqRecord->sem, 0);
-        cfg.name = (char *)ginfo->name;
-        cfg.priority = OSAL_THREAD_PRI_HIGHEST;
-        cfg.stackSize = GPIO_IRQ_STACK_SIZE;
-        ret = OsalThreadStart(&irqRecord->thread, &cfg);
-        if (ret != HDF_SUCCESS) {
-            (void)OsalSemDestroy(&irqRecord->sem);
+        irqRecord->pool = GpioManagerGetIrqPool();
+        if (irqRecord->pool == NULL) {
             (void)OsalSpinDestroy(&irqRecord->spin);
-            (void)OsalThreadDestroy(&irqRecord->thread);
             OsalMemFree(irqRecord);
-            PLAT_LOGE("GpioIrqRecordCreate: start irq thread failed:%d", ret);
-            return ret;
+            PLAT_LOGE("GpioIrqRecordCreate: no irq worker pool for gpio(%u)", GpioInfoToGlobal(ginfo));
+            return HDF_PLT_ERR_OS_API;
         }
-        PLAT_LOGI("GpioIrqRecordCreate: gpio(%u) thread started", GpioInfoToGlobal(ginfo));
+        (void)HdfPoolWorkInit(&irqRecord->work, GpioIrqRecordWork, irqRecord, HDF_WORK_CLASS_REALTIME);
     }
 
     *new = irqRecord;
@@ -313,3 +376,30 @@ int32_t GpioCntlrDisableIrq(struct GpioCntlr *cntlr, uint16_t local)
 
     return cntlr->ops->disableIrq(cntlr, local);
 }
+
+int32_t GpioCntlrGetIrqEvent(struct GpioCntlr *cntlr, uint16_t local, struct GpioIrqEvent *event)
+{
+    uint32_t irqSave;
+    struct GpioInfo *ginfo = NULL;
+    struct GpioIrqRecord *irqRecord = NULL;
+
+    if (cntlr == NULL || cntlr->ginfos == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (local >= cntlr->count || event == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ginfo = &cntlr->ginfos[local];
+    GpioInfoLock(ginfo);
+    irqRecord = ginfo->irqRecord;
+    if (irqRecord == NULL || irqRecord->btmFunc == NULL) {
+        GpioInfoUnlock(ginfo);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    (void)OsalSpinLockIrqSave(&irqRecord->spin, &irqSave);
+    *event = irqRecord->event;
+    (void)OsalSpinUnlockIrqRestore(&irqRecord->spin, &irqSave);
+    GpioInfoUnlock(ginfo);
+    return HDF_SUCCESS;
+}
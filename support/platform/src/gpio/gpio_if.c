@@ -14,6 +14,8 @@
 
 #define HDF_LOG_TAG gpio_if
 
+#define GPIO_MULTI_BATCH_MAX 32
+
 int32_t GpioRead(uint16_t gpio, uint16_t *val)
 {
     int32_t ret;
@@ -36,6 +38,59 @@ int32_t GpioWrite(uint16_t gpio, uint16_t val)
     return ret;
 }
 
+/* pins adjacent in the array and on the same controller are passed to the controller as one batch */
+static int32_t GpioTransferMulti(const uint16_t *gpios, uint16_t *vals, uint16_t count, bool isWrite)
+{
+    int32_t ret;
+    uint16_t i = 0;
+    uint16_t n;
+    uint16_t locals[GPIO_MULTI_BATCH_MAX];
+    struct GpioCntlr *cntlr = NULL;
+
+    while (i < count) {
+        cntlr = GpioCntlrGetByGpio(gpios[i]);
+        if (cntlr == NULL) {
+            return HDF_ERR_INVALID_OBJECT;
+        }
+        for (n = 0; (i + n) < count && n < GPIO_MULTI_BATCH_MAX; n++) {
+            if (gpios[i + n] < cntlr->start || gpios[i + n] >= (cntlr->start + cntlr->count)) {
+                break;
+            }
+            locals[n] = GpioCntlrGetLocal(cntlr, gpios[i + n]);
+        }
+
+        if (isWrite) {
+            ret = GpioCntlrWriteMulti(cntlr, locals, &vals[i], n);
+        } else {
+            ret = GpioCntlrReadMulti(cntlr, locals, &vals[i], n);
+        }
+        GpioCntlrPut(cntlr);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: transfer gpio %u fail:%d", __func__, gpios[i], ret);
+            return ret;
+        }
+        i += n;
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t GpioReadMulti(const uint16_t *gpios, uint16_t *vals, uint16_t count)
+{
+    if (gpios == NULL || vals == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return GpioTransferMulti(gpios, vals, count, false);
+}
+
+int32_t GpioWriteMulti(const uint16_t *gpios, const uint16_t *vals, uint16_t count)
+{
+    if (gpios == NULL || vals == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    // the values are only read when writing
+    return GpioTransferMulti(gpios, (uint16_t *)vals, count, true);
+}
+
 int32_t GpioSetDir(uint16_t gpio, uint16_t dir)
 {
     int32_t ret;
@@ -101,3 +156,14 @@ int32_t GpioDisableIrq(uint16_t gpio)
     GpioCntlrPut(cntlr);
     return ret;
 }
+
+int32_t GpioGetIrqEvent(uint16_t gpio, struct GpioIrqEvent *event)
+{
+    int32_t ret;
+    struct GpioCntlr *cntlr = GpioCntlrGetByGpio(gpio);
+
+    ret = GpioCntlrGetIrqEvent(cntlr, GpioCntlrGetLocal(cntlr, gpio), event);
+
+    GpioCntlrPut(cntlr);
+    return ret;
+}
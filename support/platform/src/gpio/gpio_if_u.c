@@ -10,10 +10,46 @@
 #include "gpio/gpio_service.h"
 #include "hdf_base.h"
 #include "hdf_io_service_if.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_thread.h"
 #include "platform_core.h"
+#include "platform_user_sbuf.h"
+#include "securec.h"
 
 #define PLAT_LOG_TAG gpio_if_u
 
+#define GPIO_USER_IRQ_MAX         32
+#define GPIO_USER_POLL_MS         100
+#define GPIO_USER_THREAD_STACK    (1024 * 16)
+/* room for the event array plus the length header the sbuf puts in front of a buffer */
+#define GPIO_WAIT_EVENTS_REPLY_SIZE (sizeof(struct GpioIrqEvent) * GPIO_SERVICE_EVENT_MAX + 16)
+
+struct GpioUserIrq {
+    bool used;
+    uint16_t gpio;
+    GpioIrqFunc func;
+    void *arg;
+    struct GpioIrqEvent event;   /* the event being delivered, see GpioGetIrqEvent */
+};
+
+/*
+ * One dispatcher thread serves every pin set in this process: it takes the edge events of all of them
+ * in one call and runs the ISRs. The service queues events per client, so only the pins of this process
+ * show up here. It exits on its own once no pin is left or the service fails.
+ */
+struct GpioUser {
+    struct OsalMutex lock;
+    struct GpioUserIrq irqs[GPIO_USER_IRQ_MAX];
+    uint16_t irqCount;
+    struct OsalThread thread;
+    struct OsalSem exitSem;
+    bool started;
+    bool running;
+};
+
+static struct GpioUser g_gpioUser;
+
 static void *GpioManagerServiceGet(void)
 {
     static void *manager = NULL;
@@ -24,7 +60,10 @@ static void *GpioManagerServiceGet(void)
     manager = (void *)HdfIoServiceBind("HDF_PLATFORM_GPIO_MANAGER");
     if (manager == NULL) {
         HDF_LOGE("%s: fail to get gpio manager service!", __func__);
+        return NULL;
     }
+    (void)OsalMutexInit(&g_gpioUser.lock);
+    (void)OsalSemInit(&g_gpioUser.exitSem, 0);
     return manager;
 }
 
@@ -41,43 +80,27 @@ int32_t GpioRead(uint16_t gpio, uint16_t *val)
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
-        return HDF_ERR_MALLOC_FAIL;
-    }
-
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: fail to obtain reply", __func__);
-        HdfSbufRecycle(data);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)gpio)) {
         HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_READ, data, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return ret;
     }
 
     if (!HdfSbufReadUint16(reply, val)) {
         HDF_LOGE("%s: read sbuf fail", __func__);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
 
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
     return HDF_SUCCESS;
 }
 
@@ -86,6 +109,7 @@ int32_t GpioWrite(uint16_t gpio, uint16_t val)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
 
     service = (struct HdfIoService *)GpioManagerServiceGet();
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
@@ -93,32 +117,120 @@ int32_t GpioWrite(uint16_t gpio, uint16_t val)
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)gpio)) {
         HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)val)) {
         HDF_LOGE("%s: write gpio value fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_WRITE, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
+    return HDF_SUCCESS;
+}
+
+int32_t GpioReadMulti(const uint16_t *gpios, uint16_t *vals, uint16_t count)
+{
+    int32_t ret;
+    uint32_t size = sizeof(*gpios) * count;
+    uint32_t valSize;
+    const void *valBuf = NULL;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    if (gpios == NULL || vals == NULL || count == 0) {
+        HDF_LOGE("%s: invalid gpios or vals", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    service = (struct HdfIoService *)GpioManagerServiceGet();
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: get gpio manager service fail!", __func__);
+        return HDF_PLT_ERR_DEV_GET;
+    }
+
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    if (!HdfSbufWriteBuffer(data, gpios, size)) {
+        HDF_LOGE("%s: write gpio numbers fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_READ_MULTI, data, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: service call fail:%d", __func__, ret);
+        return ret;
+    }
+
+    if (!HdfSbufReadBuffer(reply, &valBuf, &valSize) || valBuf == NULL || valSize != size) {
+        HDF_LOGE("%s: read sbuf fail", __func__);
+        return HDF_ERR_IO;
+    }
+
+    if (memcpy_s(vals, size, valBuf, valSize) != EOK) {
+        HDF_LOGE("%s: copy vals fail", __func__);
+        ret = HDF_ERR_IO;
+    }
+    return ret;
+}
+
+int32_t GpioWriteMulti(const uint16_t *gpios, const uint16_t *vals, uint16_t count)
+{
+    int32_t ret;
+    uint32_t size = sizeof(*gpios) * count;
+    struct HdfIoService *service = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+
+    if (gpios == NULL || vals == NULL || count == 0) {
+        HDF_LOGE("%s: invalid gpios or vals", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    service = (struct HdfIoService *)GpioManagerServiceGet();
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: get gpio manager service fail!", __func__);
+        return HDF_PLT_ERR_DEV_GET;
+    }
+
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    if (!HdfSbufWriteBuffer(data, gpios, size)) {
+        HDF_LOGE("%s: write gpio numbers fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    if (!HdfSbufWriteBuffer(data, vals, size)) {
+        HDF_LOGE("%s: write gpio values fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    // all the pins are written by one dispatch
+    ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_WRITE_MULTI, data, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: service call fail:%d", __func__, ret);
+        return ret;
+    }
+
     return HDF_SUCCESS;
 }
 
@@ -140,43 +252,27 @@ int32_t GpioGetDir(uint16_t gpio, uint16_t *dir)
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
-        return HDF_ERR_MALLOC_FAIL;
-    }
-
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: fail to obtain reply", __func__);
-        HdfSbufRecycle(data);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)gpio)) {
         HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_GETDIR, data, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return ret;
     }
 
     if (!HdfSbufReadUint16(reply, dir)) {
         HDF_LOGE("%s: read sbuf fail", __func__);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
 
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
     return HDF_SUCCESS;
 }
 
@@ -185,6 +281,7 @@ int32_t GpioSetDir(uint16_t gpio, uint16_t dir)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
 
     service = (struct HdfIoService *)GpioManagerServiceGet();
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
@@ -192,41 +289,233 @@ int32_t GpioSetDir(uint16_t gpio, uint16_t dir)
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)gpio)) {
         HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)dir)) {
         HDF_LOGE("%s: write gpio value fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_SETDIR, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
+
+static int32_t GpioWaitEvents(uint32_t timeoutMs, struct GpioIrqEvent *events, uint32_t *count)
+{
+    int32_t ret;
+    uint32_t len;
+    const void *buf = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+    struct HdfIoService *service = (struct HdfIoService *)GpioManagerServiceGet();
+
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        return HDF_PLT_ERR_DEV_GET;
+    }
+    ret = PlatformUserSbufGet(&data, &reply, GPIO_WAIT_EVENTS_REPLY_SIZE);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(data, timeoutMs)) {
+        ret = HDF_ERR_IO;
+        goto __EXIT;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_WAIT_EVENTS, data, reply);
+    if (ret != HDF_SUCCESS) {
+        goto __EXIT;
+    }
+    if (!HdfSbufReadBuffer(reply, &buf, &len) || buf == NULL || len == 0 ||
+        len > sizeof(*events) * GPIO_SERVICE_EVENT_MAX || len % sizeof(*events) != 0) {
+        HDF_LOGE("%s: read events fail", __func__);
+        ret = HDF_ERR_IO;
+        goto __EXIT;
+    }
+    if (memcpy_s(events, sizeof(*events) * GPIO_SERVICE_EVENT_MAX, buf, len) != EOK) {
+        ret = HDF_ERR_IO;
+        goto __EXIT;
+    }
+    *count = len / sizeof(*events);
+
+__EXIT:
+    return ret;
+}
+
+// caller holds g_gpioUser.lock
+static struct GpioUserIrq *GpioUserFind(uint16_t gpio)
+{
+    uint16_t i;
+
+    for (i = 0; i < GPIO_USER_IRQ_MAX; i++) {
+        if (g_gpioUser.irqs[i].used && g_gpioUser.irqs[i].gpio == gpio) {
+            return &g_gpioUser.irqs[i];
+        }
+    }
+    return NULL;
+}
+
+static void GpioUserDeliver(const struct GpioIrqEvent *event)
+{
+    GpioIrqFunc func = NULL;
+    void *arg = NULL;
+    struct GpioUserIrq *irq = NULL;
+
+    (void)OsalMutexLock(&g_gpioUser.lock);
+    irq = GpioUserFind(event->gpio);
+    if (irq != NULL) {
+        irq->event = *event;
+        func = irq->func;
+        arg = irq->arg;
+    }
+    (void)OsalMutexUnlock(&g_gpioUser.lock);
+
+    // a pin unset in the meantime has no one to deliver to
+    if (func != NULL) {
+        (void)func(event->gpio, arg);
+    }
+}
+
+static int32_t GpioUserThread(void *data)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t count = 0;
+    struct GpioIrqEvent events[GPIO_SERVICE_EVENT_MAX];
+    (void)data;
+
+    while (true) {
+        (void)OsalMutexLock(&g_gpioUser.lock);
+        if (g_gpioUser.irqCount == 0) {
+            g_gpioUser.running = false;
+            (void)OsalMutexUnlock(&g_gpioUser.lock);
+            break;
+        }
+        (void)OsalMutexUnlock(&g_gpioUser.lock);
+
+        ret = GpioWaitEvents(GPIO_USER_POLL_MS, events, &count);
+        if (ret == HDF_ERR_TIMEOUT) {
+            continue;
+        }
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: wait events failed:%d", __func__, ret);
+            (void)OsalMutexLock(&g_gpioUser.lock);
+            g_gpioUser.running = false;  // the next GpioSetIrq tries again
+            (void)OsalMutexUnlock(&g_gpioUser.lock);
+            break;
+        }
+        for (i = 0; i < count; i++) {
+            GpioUserDeliver(&events[i]);
+        }
+    }
+    (void)OsalSemPost(&g_gpioUser.exitSem);
+    return HDF_SUCCESS;
+}
+
+// caller holds g_gpioUser.lock
+static int32_t GpioUserStart(void)
+{
+    int32_t ret;
+    struct OsalThreadParam param;
+
+    if (g_gpioUser.running) {
+        return HDF_SUCCESS;
+    }
+    if (g_gpioUser.started) {
+        // the previous dispatcher found no pin left and is on its way out
+        (void)OsalSemWait(&g_gpioUser.exitSem, HDF_WAIT_FOREVER);
+        (void)OsalThreadDestroy(&g_gpioUser.thread);
+        g_gpioUser.started = false;
+    }
+
+    ret = OsalThreadCreate(&g_gpioUser.thread, GpioUserThread, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: create dispatcher failed:%d", __func__, ret);
+        return ret;
+    }
+    param.name = "gpio_user";
+    param.priority = OSAL_THREAD_PRI_HIGHEST;
+    param.stackSize = GPIO_USER_THREAD_STACK;
+    g_gpioUser.running = true;
+    ret = OsalThreadStart(&g_gpioUser.thread, &param);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start dispatcher failed:%d", __func__, ret);
+        g_gpioUser.running = false;
+        (void)OsalThreadDestroy(&g_gpioUser.thread);
+        return ret;
+    }
+    g_gpioUser.started = true;
+    return HDF_SUCCESS;
+}
+
+static int32_t GpioUserAdd(uint16_t gpio, GpioIrqFunc func, void *arg)
+{
+    uint16_t i;
+    struct GpioUserIrq *irq = NULL;
+
+    (void)OsalMutexLock(&g_gpioUser.lock);
+    if (GpioUserFind(gpio) != NULL) {
+        (void)OsalMutexUnlock(&g_gpioUser.lock);
+        HDF_LOGE("%s: gpio(%u) irq already set", __func__, gpio);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    for (i = 0; i < GPIO_USER_IRQ_MAX && irq == NULL; i++) {
+        if (!g_gpioUser.irqs[i].used) {
+            irq = &g_gpioUser.irqs[i];
+        }
+    }
+    if (irq == NULL) {
+        (void)OsalMutexUnlock(&g_gpioUser.lock);
+        HDF_LOGE("%s: too many gpio irqs set", __func__);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    (void)memset_s(irq, sizeof(*irq), 0, sizeof(*irq));
+    irq->used = true;
+    irq->gpio = gpio;
+    irq->func = func;
+    irq->arg = arg;
+    irq->event.gpio = gpio;
+    g_gpioUser.irqCount++;
+    (void)OsalMutexUnlock(&g_gpioUser.lock);
+    return HDF_SUCCESS;
+}
+
+static void GpioUserDel(uint16_t gpio)
+{
+    struct GpioUserIrq *irq = NULL;
+
+    (void)OsalMutexLock(&g_gpioUser.lock);
+    irq = GpioUserFind(gpio);
+    if (irq != NULL) {
+        irq->used = false;
+        g_gpioUser.irqCount--;
+    }
+    (void)OsalMutexUnlock(&g_gpioUser.lock);
+}
+
 int32_t GpioSetIrq(uint16_t gpio, uint16_t mode, GpioIrqFunc func, void *arg)
 {
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
-    (void) func;
-    (void) arg;
+    struct HdfSBuf *reply = NULL;
+
+    if (func == NULL) {
+        HDF_LOGE("%s: func is NULL", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
 
     service = (struct HdfIoService *)GpioManagerServiceGet();
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
@@ -234,33 +523,36 @@ int32_t GpioSetIrq(uint16_t gpio, uint16_t mode, GpioIrqFunc func, void *arg)
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
-        return HDF_ERR_MALLOC_FAIL;
+    ret = GpioUserAdd(gpio, func, arg);
+    if (ret != HDF_SUCCESS) {
+        return ret;
     }
 
-    if (!HdfSbufWriteUint16(data, gpio)) {
-        HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
-        return HDF_ERR_IO;
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
     }
 
-    if (!HdfSbufWriteUint16(data, mode)) {
-        HDF_LOGE("%s: write gpio mode fail!", __func__);
-        HdfSbufRecycle(data);
+    if (!HdfSbufWriteUint16(data, gpio) || !HdfSbufWriteUint16(data, mode)) {
+        HDF_LOGE("%s: write gpio number or mode fail!", __func__);
+        GpioUserDel(gpio);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_SETIRQ, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
+        GpioUserDel(gpio);
         return ret;
     }
 
-    HdfSbufRecycle(data);
-    return HDF_SUCCESS;
+    (void)OsalMutexLock(&g_gpioUser.lock);
+    ret = GpioUserStart();
+    (void)OsalMutexUnlock(&g_gpioUser.lock);
+    if (ret != HDF_SUCCESS) {
+        (void)GpioUnsetIrq(gpio, arg);
+    }
+    return ret;
 }
 
 int32_t GpioUnsetIrq(uint16_t gpio, void *arg)
@@ -268,33 +560,64 @@ int32_t GpioUnsetIrq(uint16_t gpio, void *arg)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
-    (void) arg;
+    struct HdfSBuf *reply = NULL;
+    struct GpioUserIrq *irq = NULL;
+
     service = (struct HdfIoService *)GpioManagerServiceGet();
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: get gpio manager service fail!", __func__);
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    (void)OsalMutexLock(&g_gpioUser.lock);
+    irq = GpioUserFind(gpio);
+    if (irq == NULL || irq->arg != arg) {
+        (void)OsalMutexUnlock(&g_gpioUser.lock);
+        HDF_LOGE("%s: gpio(%u) irq not set or arg not match", __func__, gpio);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    (void)OsalMutexUnlock(&g_gpioUser.lock);
+
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint16(data, gpio)) {
         HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_UNSETIRQ, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
+    // the dispatcher exits by itself after the last pin, so this is safe from within an ISR
+    GpioUserDel(gpio);
+    return HDF_SUCCESS;
+}
+
+int32_t GpioGetIrqEvent(uint16_t gpio, struct GpioIrqEvent *event)
+{
+    struct GpioUserIrq *irq = NULL;
+
+    if (event == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (GpioManagerServiceGet() == NULL) {
+        return HDF_PLT_ERR_DEV_GET;
+    }
+
+    (void)OsalMutexLock(&g_gpioUser.lock);
+    irq = GpioUserFind(gpio);
+    if (irq == NULL) {
+        (void)OsalMutexUnlock(&g_gpioUser.lock);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    *event = irq->event;
+    (void)OsalMutexUnlock(&g_gpioUser.lock);
     return HDF_SUCCESS;
 }
 
@@ -303,6 +626,7 @@ int32_t GpioEnableIrq(uint16_t gpio)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
 
     service = (struct HdfIoService *)GpioManagerServiceGet();
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
@@ -310,26 +634,22 @@ int32_t GpioEnableIrq(uint16_t gpio)
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)gpio)) {
         HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_ENABLEIRQ, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
 
@@ -338,6 +658,7 @@ int32_t GpioDisableIrq(uint16_t gpio)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
 
     service = (struct HdfIoService *)GpioManagerServiceGet();
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
@@ -345,25 +666,21 @@ int32_t GpioDisableIrq(uint16_t gpio)
         return HDF_PLT_ERR_DEV_GET;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)gpio)) {
         HDF_LOGE("%s: write gpio number fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, GPIO_IO_DISABLEIRQ, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service call fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
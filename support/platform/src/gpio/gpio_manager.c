@@ -8,80 +8,182 @@
 
 #include "gpio/gpio_core.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
 #include "platform_core.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG gpio_manager
 
 #define MAX_CNT_PER_CNTLR          1024
-
-static int32_t GpioCntlrCheckStart(struct GpioCntlr *cntlr, struct DListHead *list)
+#define GPIO_IRQ_WORKER_NUM        2
+#define GPIO_IRQ_STACK_SIZE        10000
+
+struct GpioRange {
+    uint32_t start;
+    uint32_t end;  /* exclusive */
+    struct GpioCntlr *cntlr;
+};
+
+/* controllers sorted by start, searched without the manager lock */
+struct GpioRangeTable {
+    uint16_t count;
+    struct GpioRange *ranges;
+};
+
+static struct GpioRangeTable *g_gpioRanges = NULL;
+
+/* the bottom halves of all threaded GPIO interrupts share a few workers instead of a thread per pin */
+static struct HdfWorkPool g_gpioIrqPool;
+static bool g_gpioIrqPoolReady = false;
+static struct OsalMutex g_gpioIrqPoolLock;
+/* records unset while their bottom half was running, freed once the pool is done with them */
+static struct DListHead g_gpioIrqRetired;
+/* held while the retired records are waited for, so a reaper returns only after the ones in flight are gone */
+static struct OsalMutex g_gpioIrqReapLock;
+static struct HdfPoolWork g_gpioIrqReapWork;
+
+/* find the node before which the controller should be inserted to keep the list sorted by start */
+static int32_t GpioCntlrCheckStart(struct GpioCntlr *cntlr, struct DListHead *list, struct DListHead **next)
 {
-    uint16_t freeStart;
-    uint16_t freeCount;
-    struct PlatformDevice *iterLast = NULL;
+    uint32_t freeStart = 0;
     struct PlatformDevice *iterCur = NULL;
-    struct PlatformDevice *tmp = NULL;
     struct GpioCntlr *cntlrCur = NULL;
-    struct GpioCntlr *cntlrLast = NULL;
 
-    DLIST_FOR_EACH_ENTRY_SAFE(iterCur, tmp, list, struct PlatformDevice, node) {
+    DLIST_FOR_EACH_ENTRY(iterCur, list, struct PlatformDevice, node) {
         cntlrCur = CONTAINER_OF(iterCur, struct GpioCntlr, device);
-        cntlrLast = CONTAINER_OF(iterLast, struct GpioCntlr, device);
-        if (cntlrLast == NULL) {
-            freeStart = 0;
-            freeCount = cntlrCur->start;
-        } else {
-            freeStart = cntlrLast->start + cntlrLast->count;
-            freeCount = cntlrCur->start - freeStart;
+        if ((uint32_t)cntlr->start + cntlr->count <= cntlrCur->start) {
+            break;
         }
-
+        freeStart = (uint32_t)cntlrCur->start + cntlrCur->count;
         if (cntlr->start < freeStart) {
-            PLAT_LOGE("GpioCntlrCheckStart: start:%u not available(freeStart:%u, freeCount:%u)",
-                cntlr->start, freeStart, freeCount);
+            PLAT_LOGE("GpioCntlrCheckStart: start:%u(%u) not available(lastStart:%u, lastCount:%u)",
+                cntlr->start, cntlr->count, cntlrCur->start, cntlrCur->count);
             return HDF_PLT_RSC_NOT_AVL;
         }
-
-        if ((cntlr->start + cntlr->count) <= (freeStart + freeCount)) {
-            return HDF_SUCCESS;
-        }
-        cntlrLast = cntlrCur;
     }
-    if (cntlrLast == NULL) { // empty list
-        return HDF_SUCCESS;
-    }
-    if (cntlr->start >= (cntlrLast->start + cntlrLast->count)) {
-        return HDF_SUCCESS;
-    }
-    PLAT_LOGE("GpioCntlrCheckStart: start:%u(%u) not available(lastStart:%u, lastCount:%u)",
-        cntlr->start, cntlr->count, cntlrLast->start, cntlrLast->count);
-    return GPIO_NUM_MAX;
+    *next = &iterCur->node;
+    return HDF_SUCCESS;
 }
 
 static int32_t GpioManagerAdd(struct PlatformManager *manager, struct PlatformDevice *device)
 {
     int32_t ret;
+    struct DListHead *next = NULL;
     struct GpioCntlr *cntlr = CONTAINER_OF(device, struct GpioCntlr, device);
 
-    ret = GpioCntlrCheckStart(cntlr, &manager->devices);
+    ret = GpioCntlrCheckStart(cntlr, &manager->devices, &next);
     if (ret != HDF_SUCCESS) {
         PLAT_LOGE("GpioManagerAdd: start:%u(%u) invalid:%d", cntlr->start, cntlr->count, ret);
         return HDF_ERR_INVALID_PARAM;
     }
 
-    DListInsertTail(&device->node, &manager->devices);
+    DListInsertTail(&device->node, next);
     PLAT_LOGI("GpioManagerAdd: start:%u count:%u added success", cntlr->start, cntlr->count);
     return HDF_SUCCESS;
 }
 
 static int32_t GpioManagerDel(struct PlatformManager *manager, struct PlatformDevice *device)
 {
+    uint16_t i;
+    struct GpioCntlr *cntlr = CONTAINER_OF(device, struct GpioCntlr, device);
+    struct GpioRangeTable *table = g_gpioRanges;
+
+    (void)manager;
     if (!DListIsEmpty(&device->node)) {
         DListRemove(&device->node);
     }
+    // readers miss it from now on, the table is compacted after the device deleted
+    for (i = 0; table != NULL && i < table->count; i++) {
+        if (table->ranges[i].cntlr == cntlr) {
+            table->ranges[i].cntlr = NULL;
+        }
+    }
     return HDF_SUCCESS;
 }
 
+static uint16_t GpioManagerCountCntlrs(struct PlatformManager *manager)
+{
+    uint16_t count = 0;
+    struct PlatformDevice *pos = NULL;
+
+    DLIST_FOR_EACH_ENTRY(pos, &manager->devices, struct PlatformDevice, node) {
+        count++;
+    }
+    return count;
+}
+
+static struct GpioRangeTable *GpioRangeTableCreate(uint16_t count)
+{
+    struct GpioRangeTable *table = NULL;
+
+    table = (struct GpioRangeTable *)OsalMemCalloc(sizeof(*table) + sizeof(struct GpioRange) * count);
+    if (table == NULL) {
+        return NULL;
+    }
+    table->count = count;
+    table->ranges = (struct GpioRange *)(table + 1);
+    return table;
+}
+
+/* must be called with manager lock held, returns false if the table size doesn't match the controllers */
+static bool GpioRangeTableFill(struct PlatformManager *manager, struct GpioRangeTable *table)
+{
+    uint16_t i = 0;
+    struct PlatformDevice *pos = NULL;
+    struct GpioCntlr *cntlr = NULL;
+
+    DLIST_FOR_EACH_ENTRY(pos, &manager->devices, struct PlatformDevice, node) {
+        if (i >= table->count) {
+            return false;
+        }
+        cntlr = CONTAINER_OF(pos, struct GpioCntlr, device);
+        table->ranges[i].start = cntlr->start;
+        table->ranges[i].end = (uint32_t)cntlr->start + cntlr->count;
+        table->ranges[i].cntlr = cntlr;
+        i++;
+    }
+    return i == table->count;
+}
+
+static void GpioManagerRebuildRanges(struct PlatformManager *manager)
+{
+    uint16_t count;
+    bool filled = false;
+    struct GpioRangeTable *table = NULL;
+    struct GpioRangeTable *oldTable = NULL;
+
+    while (!filled) {
+        (void)OsalSpinLockIrqSave(&manager->device.spin, &manager->device.irqSave);
+        count = GpioManagerCountCntlrs(manager);
+        (void)OsalSpinUnlockIrqRestore(&manager->device.spin, &manager->device.irqSave);
+
+        // the table can't be allocated with the spinlock held
+        table = (count == 0) ? NULL : GpioRangeTableCreate(count);
+        if (count != 0 && table == NULL) {
+            PLAT_LOGW("GpioManagerRebuildRanges: alloc table fail, lookup by scanning");
+        }
+
+        (void)OsalSpinLockIrqSave(&manager->device.spin, &manager->device.irqSave);
+        // without a table the old one is dropped too, it would miss the controllers added since
+        filled = (table == NULL) ? (count != 0 || DListIsEmpty(&manager->devices)) :
+            GpioRangeTableFill(manager, table);
+        if (filled) {
+            (void)OsalAtomicIncReturn(&manager->version);  // ranges filled before the table is published
+            oldTable = g_gpioRanges;
+            g_gpioRanges = table;
+            table = NULL;
+        }
+        (void)OsalSpinUnlockIrqRestore(&manager->device.spin, &manager->device.irqSave);
+        OsalMemFree(table);  // controllers changed in between, try again
+    }
+
+    if (oldTable != NULL) {
+        // lookups pin the table in a read section, it's freed after those which could have seen it left
+        PlatformManagerSyncReaders(manager);
+        OsalMemFree(oldTable);
+    }
+}
+
 struct PlatformManager *GpioManagerGet(void)
 {
     static struct PlatformManager *manager = NULL;
@@ -89,6 +191,9 @@ struct PlatformManager *GpioManagerGet(void)
     if (manager == NULL) {
         manager = PlatformManagerGet(PLATFORM_MODULE_GPIO);
         if (manager != NULL) {
+            (void)OsalMutexInit(&g_gpioIrqPoolLock);
+            (void)OsalMutexInit(&g_gpioIrqReapLock);
+            DListHeadInit(&g_gpioIrqRetired);
             manager->add = GpioManagerAdd;
             manager->del = GpioManagerDel;
         }
@@ -96,6 +201,72 @@ struct PlatformManager *GpioManagerGet(void)
     return manager;
 }
 
+void GpioManagerReapIrqRecords(void)
+{
+    struct DListHead retired;
+    struct GpioIrqRecord *pos = NULL;
+    struct GpioIrqRecord *tmp = NULL;
+
+    DListHeadInit(&retired);
+    (void)OsalMutexLock(&g_gpioIrqReapLock);
+    (void)OsalMutexLock(&g_gpioIrqPoolLock);
+    if (!DListIsEmpty(&g_gpioIrqRetired)) {
+        DListMerge(&g_gpioIrqRetired, &retired);
+    }
+    (void)OsalMutexUnlock(&g_gpioIrqPoolLock);
+
+    // waited for without the pool lock, a bottom half still running may unset another pin meanwhile
+    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &retired, struct GpioIrqRecord, node) {
+        DListRemove(&pos->node);
+        (void)HdfPoolWorkCancelSync(&pos->work);
+        (void)OsalSpinDestroy(&pos->spin);
+        OsalMemFree(pos);
+    }
+    (void)OsalMutexUnlock(&g_gpioIrqReapLock);
+}
+
+static void GpioManagerReapWork(void *data)
+{
+    (void)data;
+    GpioManagerReapIrqRecords();
+}
+
+struct HdfWorkPool *GpioManagerGetIrqPool(void)
+{
+    struct HdfWorkPool *pool = NULL;
+    struct HdfWorkPoolConfig config;
+
+    if (GpioManagerGet() == NULL) {
+        return NULL;
+    }
+
+    (void)OsalMutexLock(&g_gpioIrqPoolLock);
+    if (!g_gpioIrqPoolReady) {
+        (void)memset_s(&config, sizeof(config), 0, sizeof(config));
+        config.name = "gpio_irq";
+        config.stackSize = GPIO_IRQ_STACK_SIZE;
+        config.classes[HDF_WORK_CLASS_REALTIME].workerNum = GPIO_IRQ_WORKER_NUM;
+        if (HdfWorkPoolInit(&g_gpioIrqPool, &config) == HDF_SUCCESS) {
+            (void)HdfPoolWorkInit(&g_gpioIrqReapWork, GpioManagerReapWork, NULL, HDF_WORK_CLASS_BACKGROUND);
+            g_gpioIrqPoolReady = true;
+        } else {
+            PLAT_LOGE("GpioManagerGetIrqPool: start irq workers failed");
+        }
+    }
+    pool = g_gpioIrqPoolReady ? &g_gpioIrqPool : NULL;
+    (void)OsalMutexUnlock(&g_gpioIrqPoolLock);
+    return pool;
+}
+
+void GpioManagerRetireIrqRecord(struct GpioIrqRecord *irqRecord)
+{
+    (void)OsalMutexLock(&g_gpioIrqPoolLock);
+    DListInsertTail(&irqRecord->node, &g_gpioIrqRetired);
+    (void)OsalMutexUnlock(&g_gpioIrqPoolLock);
+    // fails only if the reaper is already queued, which then takes this record as well
+    (void)HdfWorkPoolAdd(&g_gpioIrqPool, &g_gpioIrqReapWork);
+}
+
 static int32_t GpioCntlrCreateGpioInfos(struct GpioCntlr *cntlr)
 {
     int32_t ret;
@@ -169,6 +340,7 @@ int32_t GpioCntlrAdd(struct GpioCntlr *cntlr)
         GpioCntlrDestroyGpioInfos(cntlr);
         return ret;
     }
+    GpioManagerRebuildRanges(cntlr->device.manager);
 
     return HDF_SUCCESS;
 }
@@ -180,6 +352,9 @@ void GpioCntlrRemove(struct GpioCntlr *cntlr)
     }
 
     PlatformDeviceDel(&cntlr->device);
+    if (cntlr->device.manager != NULL) {
+        GpioManagerRebuildRanges(cntlr->device.manager);
+    }
 
     if (cntlr->ginfos == NULL) {
         return;
@@ -199,10 +374,54 @@ static bool GpioCntlrFindMatch(struct PlatformDevice *device, void *data)
     return false;
 }
 
+static struct GpioCntlr *GpioCntlrLookupRange(struct PlatformManager *manager, uint16_t gpio)
+{
+    uint32_t slot;
+    uint16_t low = 0;
+    uint16_t high;
+    uint16_t mid;
+    struct GpioRange *range = NULL;
+    struct GpioRangeTable *table = NULL;
+    struct GpioCntlr *cntlr = NULL;
+
+    slot = PlatformManagerReadEnter(manager);
+    table = *(struct GpioRangeTable * volatile *)&g_gpioRanges;
+    high = (table == NULL) ? 0 : table->count;
+    while (low < high) {
+        mid = low + (high - low) / 2;  // 2: binary search
+        range = &table->ranges[mid];
+        if (gpio < range->start) {
+            high = mid;
+        } else if (gpio >= range->end) {
+            low = mid + 1;
+        } else {
+            cntlr = *(struct GpioCntlr * volatile *)&range->cntlr;
+            break;
+        }
+    }
+    if (cntlr != NULL && PlatformDeviceGet(&cntlr->device) != HDF_SUCCESS) {
+        cntlr = NULL;
+    }
+    PlatformManagerReadExit(manager, slot);
+    return cntlr;
+}
+
+struct GpioCntlr *GpioCntlrGetByRange(uint16_t gpio)
+{
+    struct PlatformManager *gpioMgr = GpioManagerGet();
+
+    if (gpioMgr == NULL) {
+        PLAT_LOGE("GpioCntlrGetByRange: get gpio manager failed");
+        return NULL;
+    }
+    return GpioCntlrLookupRange(gpioMgr, gpio);
+}
+
 struct GpioCntlr *GpioCntlrGetByGpio(uint16_t gpio)
 {
     struct PlatformManager *gpioMgr = NULL;
     struct PlatformDevice *device = NULL;
+    struct GpioCntlr *cntlr = NULL;
 
     gpioMgr = GpioManagerGet();
     if (gpioMgr == NULL) {
@@ -210,6 +429,11 @@ struct GpioCntlr *GpioCntlrGetByGpio(uint16_t gpio)
         return NULL;
     }
 
+    cntlr = GpioCntlrLookupRange(gpioMgr, gpio);
+    if (cntlr != NULL) {
+        return cntlr;
+    }
+    // the range table may be not rebuilt yet, fall back to scanning the controllers
     device = PlatformManagerFindDevice(gpioMgr, (void *)(uintptr_t)gpio, GpioCntlrFindMatch);
     if (device == NULL) {
         PLAT_LOGE("GpioCntlrGetByGpio: gpio %u not in any controllers!", gpio);
@@ -11,9 +11,58 @@
 #include "gpio_if.h"
 #include "gpio/gpio_core.h"
 #include "gpio/gpio_service.h"
+#include "osal_mem.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG gpio_service
 
+/*
+ * One per user process: the edge events of the pins it set, merged per pin until GPIO_IO_WAIT_EVENTS
+ * drains them, so a slow reader gets counts instead of losing edges. A client holds at most
+ * GPIO_SERVICE_EVENT_MAX pins, so every pending pin has a slot, and only the client that set a pin may unset it.
+ */
+struct GpioServiceClient {
+    struct OsalMutex lock;      /* serializes set and unset, guards gpios */
+    uint16_t gpios[GPIO_SERVICE_EVENT_MAX];
+    uint16_t gpioCount;
+    OsalSpinlock spin;          /* guards the events, taken by the bottom halves */
+    struct OsalSem sem;
+    uint16_t count;
+    struct GpioIrqEvent events[GPIO_SERVICE_EVENT_MAX];
+};
+
+// threaded ISR of every pin set from user space
+static int32_t GpioServiceIrqHandler(uint16_t gpio, void *data)
+{
+    uint16_t i;
+    uint32_t irqSave;
+    struct GpioIrqEvent event;
+    struct GpioServiceClient *client = (struct GpioServiceClient *)data;
+
+    if (GpioGetIrqEvent(gpio, &event) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+
+    (void)OsalSpinLockIrqSave(&client->spin, &irqSave);
+    for (i = 0; i < client->count; i++) {
+        if (client->events[i].gpio == gpio) {
+            client->events[i].count += event.count;
+            client->events[i].lastUs = event.lastUs;
+            break;
+        }
+    }
+    if (i == client->count && client->count < GPIO_SERVICE_EVENT_MAX) {
+        client->events[client->count++] = event;
+    }
+    (void)OsalSpinUnlockIrqRestore(&client->spin, &irqSave);
+
+    (void)OsalSemPost(&client->sem);
+    return HDF_SUCCESS;
+}
+
 static int32_t GpioServiceIoRead(struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     int32_t ret;
@@ -133,13 +182,32 @@ static int32_t GpioServiceIoSetDir(struct HdfSBuf *data, struct HdfSBuf *reply)
     return ret;
 }
 
-static int32_t GpioServiceIoSetIrq(struct HdfSBuf *data, struct HdfSBuf *reply)
+// caller holds client->lock
+static int32_t GpioServiceClientFind(const struct GpioServiceClient *client, uint16_t gpio)
 {
+    uint16_t i;
+
+    for (i = 0; i < client->gpioCount; i++) {
+        if (client->gpios[i] == gpio) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int32_t GpioServiceIoSetIrq(struct GpioServiceClient *client, struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
     uint16_t gpio;
     uint16_t mode;
+    (void)reply;
 
-    if (data == NULL || reply == NULL) {
-        HDF_LOGE("%s: data or reply is NULL", __func__);
+    if (client == NULL) {
+        HDF_LOGE("%s: client not opened", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (data == NULL) {
+        HDF_LOGE("%s: data is NULL", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
 
@@ -153,14 +221,36 @@ static int32_t GpioServiceIoSetIrq(struct HdfSBuf *data, struct HdfSBuf *reply)
         return HDF_ERR_IO;
     }
 
+    (void)OsalMutexLock(&client->lock);
+    if (client->gpioCount >= GPIO_SERVICE_EVENT_MAX) {
+        (void)OsalMutexUnlock(&client->lock);
+        HDF_LOGE("%s: client already set %u gpio irqs", __func__, client->gpioCount);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    // the edges reach this client through GPIO_IO_WAIT_EVENTS, the client is also the key to unset the pin
+    ret = GpioSetIrq(gpio, mode | GPIO_IRQ_USING_THREAD, GpioServiceIrqHandler, client);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalMutexUnlock(&client->lock);
+        HDF_LOGE("%s: set gpio irq fail:%d", __func__, ret);
+        return ret;
+    }
+    client->gpios[client->gpioCount++] = gpio;
+    (void)OsalMutexUnlock(&client->lock);
+
     return HDF_SUCCESS;
 }
 
-static int32_t GpioServiceIoUnsetIrq(struct HdfSBuf *data, struct HdfSBuf *reply)
+static int32_t GpioServiceIoUnsetIrq(struct GpioServiceClient *client, struct HdfSBuf *data, struct HdfSBuf *reply)
 {
+    int32_t ret;
+    int32_t index;
     uint16_t gpio;
     (void)reply;
 
+    if (client == NULL) {
+        HDF_LOGE("%s: client not opened", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
     if (data == NULL) {
         HDF_LOGE("%s: data is NULL", __func__);
         return HDF_ERR_INVALID_PARAM;
@@ -171,6 +261,73 @@ static int32_t GpioServiceIoUnsetIrq(struct HdfSBuf *data, struct HdfSBuf *reply
         return HDF_ERR_IO;
     }
 
+    (void)OsalMutexLock(&client->lock);
+    index = GpioServiceClientFind(client, gpio);
+    if (index < 0) {
+        (void)OsalMutexUnlock(&client->lock);
+        HDF_LOGE("%s: gpio(%u) irq not set by this client", __func__, gpio);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    ret = GpioUnsetIrq(gpio, client);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalMutexUnlock(&client->lock);
+        HDF_LOGE("%s: unset gpio irq fail:%d", __func__, ret);
+        return ret;
+    }
+    client->gpios[index] = client->gpios[--client->gpioCount];
+    (void)OsalMutexUnlock(&client->lock);
+
+    return HDF_SUCCESS;
+}
+
+static int32_t GpioServiceIoWaitEvents(struct GpioServiceClient *pending, struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint16_t count;
+    uint32_t irqSave;
+    uint32_t timeoutMs;
+    struct GpioIrqEvent events[GPIO_SERVICE_EVENT_MAX];
+
+    if (pending == NULL) {
+        HDF_LOGE("%s: client not opened", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (data == NULL || reply == NULL) {
+        HDF_LOGE("%s: data or reply is NULL", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (!HdfSbufReadUint32(data, &timeoutMs)) {
+        HDF_LOGE("%s: read timeout fail", __func__);
+        return HDF_ERR_IO;
+    }
+
+    (void)OsalSpinLockIrqSave(&pending->spin, &irqSave);
+    count = pending->count;
+    (void)OsalSpinUnlockIrqRestore(&pending->spin, &irqSave);
+    if (count == 0) {
+        ret = OsalSemWait(&pending->sem, timeoutMs);
+        if (ret != HDF_SUCCESS) {
+            return ret;
+        }
+    }
+
+    // posts outnumber the drains, so a wakeup may find the events already taken
+    (void)OsalSpinLockIrqSave(&pending->spin, &irqSave);
+    count = pending->count;
+    if (count > 0 && memcpy_s(events, sizeof(events), pending->events, sizeof(events[0]) * count) != EOK) {
+        count = 0;
+    }
+    pending->count = 0;
+    (void)OsalSpinUnlockIrqRestore(&pending->spin, &irqSave);
+
+    if (count == 0) {
+        return HDF_ERR_TIMEOUT;
+    }
+    if (!HdfSbufWriteBuffer(reply, events, sizeof(events[0]) * count)) {
+        HDF_LOGE("%s: write events fail", __func__);
+        return HDF_ERR_IO;
+    }
     return HDF_SUCCESS;
 }
 
@@ -224,11 +381,102 @@ static int32_t GpioServiceIoDisableIrq(struct HdfSBuf *data, struct HdfSBuf *rep
     return ret;
 }
 
+static int32_t GpioServiceReadArray(struct HdfSBuf *data, const uint16_t **array, uint16_t *count)
+{
+    uint32_t size;
+
+    if (!HdfSbufReadBuffer(data, (const void **)array, &size)) {
+        HDF_LOGE("%s: read gpio array fail", __func__);
+        return HDF_ERR_IO;
+    }
+    if (*array == NULL || size == 0 || (size % sizeof(uint16_t)) != 0 || (size / sizeof(uint16_t)) > UINT16_MAX) {
+        HDF_LOGE("%s: invalid gpio array size:%u", __func__, size);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *count = (uint16_t)(size / sizeof(uint16_t));
+    return HDF_SUCCESS;
+}
+
+static int32_t GpioServiceIoReadMulti(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint16_t count;
+    const uint16_t *gpios = NULL;
+    uint16_t *vals = NULL;
+
+    if (data == NULL || reply == NULL) {
+        HDF_LOGE("%s: data or reply is NULL", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = GpioServiceReadArray(data, &gpios, &count);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    vals = (uint16_t *)OsalMemCalloc(sizeof(*vals) * count);
+    if (vals == NULL) {
+        HDF_LOGE("%s: alloc vals fail", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = GpioReadMulti(gpios, vals, count);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read gpios fail:%d", __func__, ret);
+        OsalMemFree(vals);
+        return ret;
+    }
+
+    if (!HdfSbufWriteBuffer(reply, vals, sizeof(*vals) * count)) {
+        HDF_LOGE("%s: write vals fail", __func__);
+        ret = HDF_ERR_IO;
+    }
+    OsalMemFree(vals);
+    return ret;
+}
+
+static int32_t GpioServiceIoWriteMulti(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint16_t count;
+    uint16_t valCount;
+    const uint16_t *gpios = NULL;
+    const uint16_t *vals = NULL;
+    (void)reply;
+
+    if (data == NULL) {
+        HDF_LOGE("%s: data is NULL", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = GpioServiceReadArray(data, &gpios, &count);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    ret = GpioServiceReadArray(data, &vals, &valCount);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (valCount != count) {
+        HDF_LOGE("%s: %u gpios but %u vals", __func__, count, valCount);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = GpioWriteMulti(gpios, vals, count);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: write gpios fail:%d", __func__, ret);
+        return ret;
+    }
+
+    return ret;
+}
+
 
 static int32_t GpioServiceDispatch(struct HdfDeviceIoClient *client, int cmd,
     struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     int32_t ret;
+    struct GpioServiceClient *gpioClient = (client == NULL) ? NULL : (struct GpioServiceClient *)client->priv;
 
     switch (cmd) {
         case GPIO_IO_READ:
@@ -240,13 +488,19 @@ static int32_t GpioServiceDispatch(struct HdfDeviceIoClient *client, int cmd,
         case GPIO_IO_SETDIR:
             return GpioServiceIoSetDir(data, reply);
         case GPIO_IO_SETIRQ:
-            return GpioServiceIoSetIrq(data, reply);
+            return GpioServiceIoSetIrq(gpioClient, data, reply);
         case GPIO_IO_UNSETIRQ:
-            return GpioServiceIoUnsetIrq(data, reply);
+            return GpioServiceIoUnsetIrq(gpioClient, data, reply);
         case GPIO_IO_ENABLEIRQ:
             return GpioServiceIoEnableIrq(data, reply);
         case GPIO_IO_DISABLEIRQ:
             return GpioServiceIoDisableIrq(data, reply);
+        case GPIO_IO_READ_MULTI:
+            return GpioServiceIoReadMulti(data, reply);
+        case GPIO_IO_WRITE_MULTI:
+            return GpioServiceIoWriteMulti(data, reply);
+        case GPIO_IO_WAIT_EVENTS:
+            return GpioServiceIoWaitEvents(gpioClient, data, reply);
         default:
             ret = HDF_ERR_NOT_SUPPORT;
             break;
@@ -254,6 +508,56 @@ static int32_t GpioServiceDispatch(struct HdfDeviceIoClient *client, int cmd,
     return ret;
 }
 
+static int32_t GpioServiceOpen(struct HdfDeviceIoClient *client)
+{
+    struct GpioServiceClient *gpioClient = NULL;
+
+    if (client == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    gpioClient = (struct GpioServiceClient *)OsalMemCalloc(sizeof(*gpioClient));
+    if (gpioClient == NULL) {
+        HDF_LOGE("%s: alloc client fail", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    if (OsalMutexInit(&gpioClient->lock) != HDF_SUCCESS) {
+        OsalMemFree(gpioClient);
+        return HDF_FAILURE;
+    }
+    (void)OsalSpinInit(&gpioClient->spin);
+    (void)OsalSemInit(&gpioClient->sem, 0);
+    client->priv = gpioClient;
+    return HDF_SUCCESS;
+}
+
+static void GpioServiceClientRelease(struct HdfDeviceIoClient *client)
+{
+    uint16_t i;
+    struct GpioServiceClient *gpioClient = NULL;
+
+    if (client == NULL || client->priv == NULL) {
+        return;
+    }
+    gpioClient = (struct GpioServiceClient *)client->priv;
+    client->priv = NULL;
+
+    // the pins a process left set when it went away
+    (void)OsalMutexLock(&gpioClient->lock);
+    for (i = 0; i < gpioClient->gpioCount; i++) {
+        (void)GpioUnsetIrq(gpioClient->gpios[i], gpioClient);
+    }
+    gpioClient->gpioCount = 0;
+    (void)OsalMutexUnlock(&gpioClient->lock);
+    // a bottom half caught running by the unset may still be in the handler with this client
+    GpioManagerReapIrqRecords();
+
+    (void)OsalSemDestroy(&gpioClient->sem);
+    (void)OsalSpinDestroy(&gpioClient->spin);
+    (void)OsalMutexDestroy(&gpioClient->lock);
+    OsalMemFree(gpioClient);
+}
+
 static int32_t GpioServiceBind(struct HdfDeviceObject *device)
 {
     int32_t ret;
@@ -276,6 +580,8 @@ static int32_t GpioServiceBind(struct HdfDeviceObject *device)
         HDF_LOGE("GpioServiceBind: create gpio service fail:%d", ret);
         return ret;
     }
+    gpioMgr->device.service->Open = GpioServiceOpen;
+    gpioMgr->device.service->Release = GpioServiceClientRelease;
 
     ret = PlatformDeviceBind(&gpioMgr->device, device);
     if (ret != HDF_SUCCESS) {
@@ -542,16 +542,12 @@ int32_t HdmiCntlrGetSinkEdid(struct HdmiCntlr *cntlr, uint8_t *buffer, uint32_t
         return ret;
     }
 
-    ret = HdmiEdidRawDataRead(&(cntlr->hdmi->edid), &(cntlr->ddc));
+    // an EDID that fails to phase still has its raw data returned
+    ret = HdmiEdidCachedRead(&(cntlr->hdmi->edid), &(cntlr->ddc), &(cntlr->edidCache));
     if (ret != HDF_SUCCESS) {
         HdmiCntlrFreeDev(cntlr);
         return ret;
     }
-
-    if (cntlr->hdmi->edid.edidPhase != true) {
-        (void)HdmiEdidPhase(&(cntlr->hdmi->edid));
-        cntlr->hdmi->edid.edidPhase = true;
-    }
     return HdmiEdidGetRaw(&(cntlr->hdmi->edid), buffer, len);
 }
 
@@ -1175,6 +1175,27 @@ static int32_t HdmiEdidExtDataBlockPhase(struct HdmiSinkDeviceCapability *sinkCa
     return ret;
 }
 
+/* Dolby VSVDB and HDR SMDB are only noted here and phased when first asked for. */
+static bool HdmiEdidExtLazyDataBlock(struct HdmiEdid *edid, uint8_t *data, uint8_t len, uint8_t tag)
+{
+    struct HdmiEdidLazyBlock *lazy = NULL;
+
+    if (tag != HDMI_EDID_USE_EXT_DATA_BLOCK || len == 0) {
+        return false;
+    }
+    if (data[UINT8_ARRAY_TElEMENT_0] == HDMI_EDID_EXT_VSVDB) {
+        lazy = &(edid->vsvdb);
+    } else if (data[UINT8_ARRAY_TElEMENT_0] == HDMI_EDID_EXT_HDR_SMDB) {
+        lazy = &(edid->hdrSmdb);
+    } else {
+        return false;
+    }
+    lazy->offset = (uint16_t)(data - edid->raw);
+    lazy->len = len;
+    lazy->phased = false;
+    return true;
+}
+
 static void HdmiEdidExtSeveralDataBlockPhase(struct HdmiEdid *edid, uint8_t blockNum)
 {
     uint8_t *data = edid->raw + (blockNum * HDMI_EDID_SINGLE_BLOCK_SIZE);
@@ -1192,6 +1213,9 @@ static void HdmiEdidExtSeveralDataBlockPhase(struct HdmiEdid *edid, uint8_t bloc
         dbTagCode = (data[UINT8_ARRAY_TElEMENT_0] & HDMI_EDID_EXTENSION_DATA_BLOCK_TAG_CODE_MARK) >>
             HDMI_EDID_EXTENSION_DATA_BLOCK_TAG_CODE_SHIFT;
         data++;
+        if (HdmiEdidExtLazyDataBlock(edid, data, blkLen, dbTagCode)) {
+            continue;
+        }
         ret = HdmiEdidExtDataBlockPhase(sinkCap, data, blkLen, dbTagCode);
         if (ret != HDF_SUCCESS) {
             HDF_LOGE("data block %d phase fail", dbTagCode);
@@ -1283,17 +1307,11 @@ int32_t HdmiEdidPhase(struct HdmiEdid *edid)
     return HDF_SUCCESS;
 }
 
-int32_t HdmiEdidRawDataRead(struct HdmiEdid *edid, struct HdmiDdc *ddc)
+static int32_t HdmiEdidBlock0Read(struct HdmiEdid *edid, struct HdmiDdc *ddc)
 {
     struct HdmiDdcCfg cfg = {0};
     int32_t ret;
-    uint8_t extBlkNum;
-
-    if (edid == NULL || ddc == NULL) {
-        return HDF_ERR_INVALID_PARAM;
-    }
 
-    /* read block0 */
     cfg.type = HDMI_DDC_DEV_EDID;
     cfg.mode = HDMI_DDC_MODE_READ_MUTIL_NO_ACK;
     cfg.data = edid->raw;
@@ -1306,19 +1324,38 @@ int32_t HdmiEdidRawDataRead(struct HdmiEdid *edid, struct HdmiDdc *ddc)
         return ret;
     }
     edid->rawLen += HDMI_EDID_SINGLE_BLOCK_SIZE;
+    return HDF_SUCCESS;
+}
+
+static uint8_t HdmiEdidRawExtBlockNum(struct HdmiEdid *edid)
+{
+    uint8_t extBlkNum = edid->raw[HDMI_EDID_EXTENSION_BLOCK_ADDR];
 
-    extBlkNum = edid->raw[HDMI_EDID_EXTENSION_BLOCK_ADDR];
     if (extBlkNum > (HDMI_EDID_MAX_BLOCK_NUM - 1)) {
         extBlkNum = (HDMI_EDID_MAX_BLOCK_NUM - 1);
         HDF_LOGD("extBlkNum > max, use max.");
     }
+    return extBlkNum;
+}
+
+static int32_t HdmiEdidExtBlocksRead(struct HdmiEdid *edid, struct HdmiDdc *ddc, uint8_t extBlkNum)
+{
+    struct HdmiDdcCfg cfg = {0};
+    int32_t ret;
+
     if (extBlkNum == 0) {
         HDF_LOGD("edid only has block0");
         return HDF_SUCCESS;
     }
 
     /* read block1 */
-    cfg.data += HDMI_EDID_SINGLE_BLOCK_SIZE;
+    cfg.type = HDMI_DDC_DEV_EDID;
+    cfg.mode = HDMI_DDC_MODE_READ_MUTIL_NO_ACK;
+    cfg.readFlag = true;
+    cfg.devAddr = HDMI_DDC_EDID_DEV_ADDRESS;
+    cfg.offset = HDMI_EDID_SINGLE_BLOCK_SIZE;
+    cfg.data = edid->raw + HDMI_EDID_SINGLE_BLOCK_SIZE;
+    cfg.dataLen = HDMI_EDID_SINGLE_BLOCK_SIZE;
     ret = HdmiDdcTransfer(ddc, &cfg);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("edid block1 read fail");
@@ -1334,6 +1371,7 @@ int32_t HdmiEdidRawDataRead(struct HdmiEdid *edid, struct HdmiDdc *ddc)
     cfg.data += HDMI_EDID_SINGLE_BLOCK_SIZE;
     cfg.dataLen = (extBlkNum - 1) * HDMI_EDID_SINGLE_BLOCK_SIZE;
     cfg.mode = HDMI_DDC_MODE_READ_SEGMENT_NO_ACK;
+    cfg.offset = 0;
     cfg.segment = 1;
     ret = HdmiDdcTransfer(ddc, &cfg);
     if (ret != HDF_SUCCESS) {
@@ -1344,6 +1382,194 @@ int32_t HdmiEdidRawDataRead(struct HdmiEdid *edid, struct HdmiDdc *ddc)
     return HDF_SUCCESS;
 }
 
+int32_t HdmiEdidRawDataRead(struct HdmiEdid *edid, struct HdmiDdc *ddc)
+{
+    int32_t ret;
+
+    if (edid == NULL || ddc == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = HdmiEdidBlock0Read(edid, ddc);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    return HdmiEdidExtBlocksRead(edid, ddc, HdmiEdidRawExtBlockNum(edid));
+}
+
+/* read only the checksum byte of an extension block. */
+static int32_t HdmiEdidCheckSumRead(struct HdmiDdc *ddc, uint8_t blockNum, uint8_t *checkSum)
+{
+    struct HdmiDdcCfg cfg = {0};
+
+    cfg.type = HDMI_DDC_DEV_EDID;
+    cfg.mode = (blockNum < HDMI_EDID_BLOCKS_PER_SEGMENT) ? HDMI_DDC_MODE_READ_SINGLE_NO_ACK :
+        HDMI_DDC_MODE_READ_SEGMENT_NO_ACK;
+    cfg.segment = blockNum / HDMI_EDID_BLOCKS_PER_SEGMENT;
+    cfg.offset = (blockNum % HDMI_EDID_BLOCKS_PER_SEGMENT) * HDMI_EDID_SINGLE_BLOCK_SIZE + HDMI_EDID_CHECKSUM_ADDR;
+    cfg.data = checkSum;
+    cfg.dataLen = 1;
+    cfg.readFlag = true;
+    cfg.devAddr = HDMI_DDC_EDID_DEV_ADDRESS;
+    return HdmiDdcTransfer(ddc, &cfg);
+}
+
+/* the part of the key held by block0 */
+static int32_t HdmiEdidCacheKeyInit(struct HdmiEdid *edid, struct HdmiEdidCacheKey *key)
+{
+    if (memset_s(key, sizeof(*key), 0, sizeof(*key)) != EOK ||
+        memcpy_s(key->id, sizeof(key->id), edid->raw + HDMI_EDID_CACHE_ID_OFFSET, HDMI_EDID_CACHE_ID_LEN) != EOK) {
+        return HDF_ERR_IO;
+    }
+    key->extBlockNum = HdmiEdidRawExtBlockNum(edid);
+    key->checkSum[0] = edid->raw[HDMI_EDID_CHECKSUM_ADDR];
+    return HDF_SUCCESS;
+}
+
+/* probes the checksums of the extension blocks on the bus, without reading the blocks */
+static int32_t HdmiEdidCacheKeyGet(struct HdmiEdid *edid, struct HdmiDdc *ddc, struct HdmiEdidCacheKey *key)
+{
+    uint8_t i;
+    int32_t ret;
+
+    ret = HdmiEdidCacheKeyInit(edid, key);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    for (i = 1; i <= key->extBlockNum; i++) {
+        ret = HdmiEdidCheckSumRead(ddc, i, &(key->checkSum[i]));
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("edid block%d checksum read fail", i);
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+/* the same key taken from the blocks already read into the raw data */
+static int32_t HdmiEdidCacheKeyFromRaw(struct HdmiEdid *edid, struct HdmiEdidCacheKey *key)
+{
+    uint8_t i;
+    int32_t ret;
+
+    ret = HdmiEdidCacheKeyInit(edid, key);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    for (i = 1; i <= key->extBlockNum; i++) {
+        key->checkSum[i] = edid->raw[i * HDMI_EDID_SINGLE_BLOCK_SIZE + HDMI_EDID_CHECKSUM_ADDR];
+    }
+    return HDF_SUCCESS;
+}
+
+static struct HdmiEdidCacheEntry *HdmiEdidCacheFind(struct HdmiEdidCache *cache, const struct HdmiEdidCacheKey *key)
+{
+    uint32_t i;
+
+    for (i = 0; i < HDMI_EDID_CACHE_NUM; i++) {
+        if (cache->entry[i].valid && memcmp(&(cache->entry[i].key), key, sizeof(*key)) == 0) {
+            return &(cache->entry[i]);
+        }
+    }
+    return NULL;
+}
+
+static void HdmiEdidCacheStore(struct HdmiEdidCache *cache, const struct HdmiEdidCacheKey *key,
+    const struct HdmiEdid *edid)
+{
+    uint32_t i;
+    struct HdmiEdidCacheEntry *victim = &(cache->entry[0]);
+
+    for (i = 0; i < HDMI_EDID_CACHE_NUM; i++) {
+        if (!cache->entry[i].valid) {
+            victim = &(cache->entry[i]);
+            break;
+        }
+        if (cache->entry[i].lastUse < victim->lastUse) {
+            victim = &(cache->entry[i]);
+        }
+    }
+    victim->key = *key;
+    victim->edid = *edid;
+    victim->lastUse = ++cache->useCount;
+    victim->valid = true;
+}
+
+/*
+ * Same as HdmiEdidRawDataRead followed by HdmiEdidPhase, but a sink found in the cache skips the
+ * extension block reads and the phasing. A phase failure leaves edidPhase false with the raw data
+ * still read, such an EDID is not cached.
+ */
+int32_t HdmiEdidCachedRead(struct HdmiEdid *edid, struct HdmiDdc *ddc, struct HdmiEdidCache *cache)
+{
+    struct HdmiEdidCacheEntry *entry = NULL;
+    struct HdmiEdidCacheKey key;
+    struct HdmiEdidCacheKey readKey;
+    int32_t probed;
+    int32_t ret;
+
+    if (edid == NULL || ddc == NULL || cache == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = HdmiEdidBlock0Read(edid, ddc);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    probed = HdmiEdidCacheKeyGet(edid, ddc, &key);
+    if (probed == HDF_SUCCESS) {
+        entry = HdmiEdidCacheFind(cache, &key);
+    }
+    if (entry != NULL) {
+        *edid = entry->edid;
+        entry->lastUse = ++cache->useCount;
+        cache->hits++;
+        HDF_LOGD("edid cache hit, product code 0x%x.", edid->sinkCap.vendorInfo.productCode);
+        return HDF_SUCCESS;
+    }
+
+    ret = HdmiEdidExtBlocksRead(edid, ddc, HdmiEdidRawExtBlockNum(edid));
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    edid->edidPhase = (HdmiEdidPhase(edid) == HDF_SUCCESS);
+    if (!edid->edidPhase) {
+        HDF_LOGW("edid phase fail, only the raw data is valid.");
+        return HDF_SUCCESS;
+    }
+    // a sink swapped between the probe and the read doesn't match the probed key and is not cached
+    if (probed == HDF_SUCCESS && HdmiEdidCacheKeyFromRaw(edid, &readKey) == HDF_SUCCESS &&
+        memcmp(&readKey, &key, sizeof(key)) == 0) {
+        HdmiEdidCacheStore(cache, &key, edid);
+    }
+    return HDF_SUCCESS;
+}
+
+struct HdmiEdidHdrCap *HdmiEdidGetHdrCap(struct HdmiEdid *edid)
+{
+    if (edid == NULL) {
+        return NULL;
+    }
+    if (!edid->hdrSmdb.phased && edid->hdrSmdb.offset != 0) {
+        HdmiEdidExtUseExtDataBlockHdrSmdbPhase(&(edid->sinkCap), edid->raw + edid->hdrSmdb.offset,
+            edid->hdrSmdb.len);
+    }
+    edid->hdrSmdb.phased = true;
+    return &(edid->sinkCap.hdrCap);
+}
+
+struct HdmiEdidVsvdbDolbyCap *HdmiEdidGetDolbyCap(struct HdmiEdid *edid)
+{
+    if (edid == NULL) {
+        return NULL;
+    }
+    if (!edid->vsvdb.phased && edid->vsvdb.offset != 0) {
+        HdmiEdidExtUseExtDataBlockVsvdbPhase(&(edid->sinkCap), edid->raw + edid->vsvdb.offset, edid->vsvdb.len);
+    }
+    edid->vsvdb.phased = true;
+    return &(edid->sinkCap.dolbyCap);
+}
+
 bool HdmiEdidSupportFrl(struct HdmiDevice *hdmi)
 {
     if (hdmi == NULL) {
@@ -111,12 +111,13 @@ static int32_t HdmiEventHotPlugHandleComm(struct HdmiCntlr *cntlr)
         ret = HDF_ERR_IO;
         goto __END;
     }
-    ret = HdmiEdidRawDataRead(&(cntlr->hdmi->edid), &(cntlr->ddc));
+    ret = HdmiEdidCachedRead(&(cntlr->hdmi->edid), &(cntlr->ddc), &(cntlr->edidCache));
     if (ret != HDF_SUCCESS) {
         goto __END;
     }
-    ret = HdmiEdidPhase(&(cntlr->hdmi->edid));
-    if (ret != HDF_SUCCESS) {
+    // the mode select needs the sink capability, the raw data alone is no use here
+    if (!cntlr->hdmi->edid.edidPhase) {
+        ret = HDF_ERR_IO;
         goto __END;
     }
 
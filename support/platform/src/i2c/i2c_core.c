@@ -10,13 +10,35 @@
 #include "hdf_device_desc.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "osal_thread.h"
 #include "osal_time.h"
 #include "platform_core.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG i2c_core
 #define LOCK_WAIT_SECONDS_M 1
 #define I2C_HANDLE_SHIFT    ((uintptr_t)(-1) << 16)
 
+#define I2C_QUEUE_DEPTH_MAX   64
+#define I2C_QUEUE_BATCH_MAX   8
+#define I2C_QUEUE_STACK_SIZE  10000
+#define I2C_QUEUE_NAME_LEN    16
+
+struct I2cTransferQueue {
+    struct I2cCntlr *cntlr;
+    struct DListHead head;
+    OsalSpinlock spin;
+    struct OsalSem sem;
+    struct OsalSem exitSem;
+    struct OsalThread thread;
+    bool stopping;
+    struct I2cQueueStat stat;
+    char name[I2C_QUEUE_NAME_LEN];
+};
+
 struct I2cManager {
     struct IDeviceIoService service;
     struct HdfDeviceObject *device;
@@ -31,7 +53,7 @@ static int32_t I2cCntlrLockDefault(struct I2cCntlr *cntlr)
     if (cntlr == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
-    return OsalMutexLock(&cntlr->lock);
+    return PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
 }
 
 static void I2cCntlrUnlockDefault(struct I2cCntlr *cntlr)
@@ -39,7 +61,7 @@ static void I2cCntlrUnlockDefault(struct I2cCntlr *cntlr)
     if (cntlr == NULL) {
         return;
     }
-    (void)OsalMutexUnlock(&cntlr->lock);
+    PlatformArbiterRelease(&cntlr->arbiter);
 }
 
 static const struct I2cLockMethod g_i2cLockOpsDefault = {
@@ -101,6 +123,7 @@ static void I2cManagerRemoveCntlr(struct I2cCntlr *cntlr)
     } else {
         manager->cntlrs[cntlr->busId] = NULL;
     }
+    cntlr->removed = true;
 
     (void)OsalMutexUnlock(&manager->lock);
 }
@@ -161,31 +184,44 @@ int32_t I2cCntlrAdd(struct I2cCntlr *cntlr)
         return HDF_ERR_INVALID_OBJECT;
     }
 
+    cntlr->queue = NULL;
+    cntlr->removed = false;
+    cntlr->stageBuf = NULL;
+    cntlr->stageSize = 0;
     if (cntlr->lockOps == NULL) {
         HDF_LOGI("I2cCntlrAdd: use default lock methods!");
         cntlr->lockOps = &g_i2cLockOpsDefault;
     }
 
-    if (OsalMutexInit(&cntlr->lock) != HDF_SUCCESS) {
-        HDF_LOGE("I2cCntlrAdd: init lock fail!");
+    if (PlatformArbiterInit(&cntlr->arbiter) != HDF_SUCCESS) {
+        HDF_LOGE("I2cCntlrAdd: init arbiter fail!");
         return HDF_FAILURE;
     }
 
     ret = I2cManagerAddCntlr(cntlr);
     if (ret != HDF_SUCCESS) {
-        (void)OsalMutexDestroy(&cntlr->lock);
+        PlatformArbiterUninit(&cntlr->arbiter);
         return ret;
     }
     return HDF_SUCCESS;
 }
 
+static void I2cTransferQueueDestroy(struct I2cTransferQueue *queue);
+
 void I2cCntlrRemove(struct I2cCntlr *cntlr)
 {
     if (cntlr == NULL) {
         return;
     }
     I2cManagerRemoveCntlr(cntlr);
-    (void)OsalMutexDestroy(&cntlr->lock);
+    if (cntlr->queue != NULL) {
+        I2cTransferQueueDestroy(cntlr->queue);
+        cntlr->queue = NULL;
+    }
+    OsalMemFree(cntlr->stageBuf);
+    cntlr->stageBuf = NULL;
+    cntlr->stageSize = 0;
+    PlatformArbiterUninit(&cntlr->arbiter);
 }
 
 static inline int32_t I2cCntlrLock(struct I2cCntlr *cntlr)
@@ -203,36 +239,385 @@ static inline void I2cCntlrUnlock(struct I2cCntlr *cntlr)
     }
 }
 
-int32_t I2cCntlrTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count)
+/* hand the controller over to a caller of higher priority, only the default lock methods know the priorities */
+static inline void I2cCntlrYield(struct I2cCntlr *cntlr)
+{
+    if (cntlr->lockOps == &g_i2cLockOpsDefault) {
+        (void)PlatformArbiterYield(&cntlr->arbiter);
+    }
+}
+
+/* a segment ends with the first msg that issues a STOP, or with the last msg */
+static int16_t I2cMsgSegmentLen(const struct I2cMsg *msgs, int16_t count)
+{
+    int16_t i;
+
+    for (i = 0; i < count - 1; i++) {
+        if ((msgs[i].flags & I2C_FLAG_STOP) != 0) {
+            break;
+        }
+    }
+    return i + 1;
+}
+
+/*
+ * must be called with the arbiter held, the msgs go to the driver in one call unless a caller of higher
+ * priority is waiting, then only up to the next STOP before the controller is handed over
+ */
+static int32_t I2cCntlrTransferSegments(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count)
+{
+    int32_t ret;
+    int16_t seg;
+    int16_t done = 0;
+
+    while (done < count) {
+        seg = count - done;
+        if (PlatformArbiterHasHigherWaiter(&cntlr->arbiter)) {
+            seg = I2cMsgSegmentLen(msgs + done, seg);
+        }
+        ret = cntlr->ops->transfer(cntlr, msgs + done, seg);
+        if (ret < 0) {
+            return (done > 0) ? done : ret;
+        }
+        done += (int16_t)ret;
+        if (ret < seg) {
+            break;
+        }
+        if (done < count) {
+            I2cCntlrYield(cntlr);
+        }
+    }
+    return done;
+}
+
+int32_t I2cCntlrTransferPrio(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count, uint32_t prio)
 {
     int32_t ret;
 
     if (cntlr == NULL) {
-        HDF_LOGE("I2cCntlrTransfer: cntlr is null");
+        HDF_LOGE("I2cCntlrTransferPrio: cntlr is null");
         return HDF_ERR_INVALID_OBJECT;
     }
 
     if (cntlr->ops == NULL || cntlr->ops->transfer == NULL) {
-        HDF_LOGE("I2cCntlrTransfer: ops or transfer is null");
+        HDF_LOGE("I2cCntlrTransferPrio: ops or transfer is null");
         return HDF_ERR_NOT_SUPPORT;
     }
 
-    if (I2cCntlrLock(cntlr) != HDF_SUCCESS) {
-        HDF_LOGE("I2cCntlrTransfer: lock controller fail!");
+    if (cntlr->lockOps != &g_i2cLockOpsDefault) {
+        if (I2cCntlrLock(cntlr) != HDF_SUCCESS) {
+            HDF_LOGE("I2cCntlrTransferPrio: lock controller fail!");
+            return HDF_ERR_DEVICE_BUSY;
+        }
+        ret = cntlr->ops->transfer(cntlr, msgs, count);
+        I2cCntlrUnlock(cntlr);
+        return ret;
+    }
+
+    if (PlatformArbiterAcquire(&cntlr->arbiter, prio, HDF_WAIT_FOREVER) != HDF_SUCCESS) {
+        HDF_LOGE("I2cCntlrTransferPrio: acquire controller fail!");
         return HDF_ERR_DEVICE_BUSY;
     }
-    ret = cntlr->ops->transfer(cntlr, msgs, count);
-    I2cCntlrUnlock(cntlr);
+    ret = I2cCntlrTransferSegments(cntlr, msgs, count);
+    PlatformArbiterRelease(&cntlr->arbiter);
+    return ret;
+}
+
+int32_t I2cCntlrTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count)
+{
+    return I2cCntlrTransferPrio(cntlr, msgs, count, PLATFORM_PRIORITY_NORMAL);
+}
+
+static uint32_t I2cTransferLatencyUs(const struct I2cTransfer *xfer)
+{
+    uint64_t now = PlatformMonoTimeUs();
+    uint64_t us;
+
+    if (now < xfer->submitTime) {
+        return 0;
+    }
+    us = now - xfer->submitTime;
+    return (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
+
+static struct I2cTransfer *I2cTransferQueuePop(struct I2cTransferQueue *queue)
+{
+    uint32_t irqSave;
+    struct I2cTransfer *xfer = NULL;
+
+    (void)OsalSpinLockIrqSave(&queue->spin, &irqSave);
+    if (!DListIsEmpty(&queue->head)) {
+        xfer = DLIST_FIRST_ENTRY(&queue->head, struct I2cTransfer, node);
+        DListRemove(&xfer->node);
+        queue->stat.depth--;
+        queue->stat.latencyLastUs = I2cTransferLatencyUs(xfer);
+        if (queue->stat.latencyLastUs > queue->stat.latencyMaxUs) {
+            queue->stat.latencyMaxUs = queue->stat.latencyLastUs;
+        }
+    }
+    (void)OsalSpinUnlockIrqRestore(&queue->spin, &irqSave);
+    return xfer;
+}
+
+static void I2cTransferComplete(struct I2cTransferQueue *queue, struct DListHead *done)
+{
+    uint32_t irqSave;
+    struct I2cTransfer *xfer = NULL;
+    struct I2cTransfer *tmp = NULL;
+
+    DLIST_FOR_EACH_ENTRY_SAFE(xfer, tmp, done, struct I2cTransfer, node) {
+        DListRemove(&xfer->node);
+        (void)OsalSpinLockIrqSave(&queue->spin, &irqSave);
+        queue->stat.completed++;
+        (void)OsalSpinUnlockIrqRestore(&queue->spin, &irqSave);
+        // the transfer belongs to the caller again, it may be resubmitted in the callback
+        xfer->callback(xfer);
+    }
+}
+
+/*
+ * dispatch a batch of transfers back-to-back with the controller locked once, stepping aside between them
+ * for callers of higher priority, returns false if the queue is empty
+ */
+static bool I2cTransferQueueDispatch(struct I2cTransferQueue *queue)
+{
+    int32_t ret;
+    uint32_t n;
+    struct DListHead done;
+    struct I2cTransfer *xfer = NULL;
+    struct I2cCntlr *cntlr = queue->cntlr;
+
+    xfer = I2cTransferQueuePop(queue);
+    if (xfer == NULL) {
+        return false;
+    }
+    DListHeadInit(&done);
+
+    ret = I2cCntlrLock(cntlr);
+    for (n = 0; xfer != NULL; n++) {
+        if (ret != HDF_SUCCESS) {
+            xfer->result = HDF_ERR_DEVICE_BUSY;
+        } else {
+            xfer->result = cntlr->ops->transfer(cntlr, xfer->msgs, xfer->count);
+        }
+        DListInsertTail(&xfer->node, &done);
+        xfer = (n + 1 < I2C_QUEUE_BATCH_MAX) ? I2cTransferQueuePop(queue) : NULL;
+        if (xfer != NULL && ret == HDF_SUCCESS) {
+            I2cCntlrYield(cntlr);
+        }
+    }
+    if (ret == HDF_SUCCESS) {
+        I2cCntlrUnlock(cntlr);
+    } else {
+        HDF_LOGE("I2cTransferQueueDispatch: lock controller fail!");
+    }
+
+    I2cTransferComplete(queue, &done);
+    return true;
+}
+
+static int32_t I2cTransferQueueThread(void *data)
+{
+    uint32_t irqSave;
+    struct DListHead done;
+    struct I2cTransfer *xfer = NULL;
+    struct I2cTransferQueue *queue = (struct I2cTransferQueue *)data;
+
+    while (!queue->stopping) {
+        if (!I2cTransferQueueDispatch(queue)) {
+            (void)OsalSemWait(&queue->sem, HDF_WAIT_FOREVER);
+        }
+    }
+
+    // the controller is going away, fail the transfers still waiting
+    DListHeadInit(&done);
+    (void)OsalSpinLockIrqSave(&queue->spin, &irqSave);
+    if (!DListIsEmpty(&queue->head)) {
+        DListMerge(&queue->head, &done);
+    }
+    queue->stat.depth = 0;
+    (void)OsalSpinUnlockIrqRestore(&queue->spin, &irqSave);
+    DLIST_FOR_EACH_ENTRY(xfer, &done, struct I2cTransfer, node) {
+        xfer->result = HDF_PLT_ERR_NO_DEV;
+    }
+    I2cTransferComplete(queue, &done);
+
+    HDF_LOGI("I2cTransferQueueThread: %s exit", queue->name);
+    (void)OsalSemPost(&queue->exitSem);
+    return HDF_SUCCESS;
+}
+
+static void I2cTransferQueueUninit(struct I2cTransferQueue *queue)
+{
+    (void)OsalSemDestroy(&queue->exitSem);
+    (void)OsalSemDestroy(&queue->sem);
+    (void)OsalSpinDestroy(&queue->spin);
+    OsalMemFree(queue);
+}
+
+static struct I2cTransferQueue *I2cTransferQueueCreate(struct I2cCntlr *cntlr)
+{
+    int32_t ret;
+    struct OsalThreadParam cfg;
+    struct I2cTransferQueue *queue = NULL;
+
+    queue = (struct I2cTransferQueue *)OsalMemCalloc(sizeof(*queue));
+    if (queue == NULL) {
+        HDF_LOGE("I2cTransferQueueCreate: alloc queue fail!");
+        return NULL;
+    }
+    queue->cntlr = cntlr;
+    queue->stopping = false;
+    DListHeadInit(&queue->head);
+    (void)OsalSpinInit(&queue->spin);
+    (void)OsalSemInit(&queue->sem, 0);
+    (void)OsalSemInit(&queue->exitSem, 0);
+    if (snprintf_s(queue->name, I2C_QUEUE_NAME_LEN, I2C_QUEUE_NAME_LEN - 1, "i2c_queue%d", cntlr->busId) < 0) {
+        HDF_LOGE("I2cTransferQueueCreate: format queue name fail!");
+        I2cTransferQueueUninit(queue);
+        return NULL;
+    }
+
+    ret = OsalThreadCreate(&queue->thread, I2cTransferQueueThread, queue);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("I2cTransferQueueCreate: create thread fail:%d", ret);
+        I2cTransferQueueUninit(queue);
+        return NULL;
+    }
+    cfg.name = queue->name;
+    cfg.priority = OSAL_THREAD_PRI_HIGH;
+    cfg.stackSize = I2C_QUEUE_STACK_SIZE;
+    ret = OsalThreadStart(&queue->thread, &cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("I2cTransferQueueCreate: start thread fail:%d", ret);
+        (void)OsalThreadDestroy(&queue->thread);
+        I2cTransferQueueUninit(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+static void I2cTransferQueueDestroy(struct I2cTransferQueue *queue)
+{
+    uint32_t irqSave;
+
+    (void)OsalSpinLockIrqSave(&queue->spin, &irqSave);
+    queue->stopping = true;
+    (void)OsalSpinUnlockIrqRestore(&queue->spin, &irqSave);
+    (void)OsalSemPost(&queue->sem);
+    (void)OsalSemWait(&queue->exitSem, HDF_WAIT_FOREVER);
+    (void)OsalThreadDestroy(&queue->thread);
+    I2cTransferQueueUninit(queue);
+}
+
+static struct I2cTransferQueue *I2cCntlrGetQueue(struct I2cCntlr *cntlr)
+{
+    struct I2cManager *manager = g_i2cManager;
+    struct I2cTransferQueue *queue = NULL;
+
+    if (cntlr->queue != NULL) {
+        return cntlr->queue;
+    }
+    if (manager == NULL || OsalMutexLock(&manager->lock) != HDF_SUCCESS) {
+        HDF_LOGE("I2cCntlrGetQueue: lock i2c manager fail!");
+        return NULL;
+    }
+    /* never bring the queue back once the controller is being removed */
+    if (cntlr->queue == NULL && !cntlr->removed) {
+        cntlr->queue = I2cTransferQueueCreate(cntlr);
+    }
+    queue = cntlr->queue;
+    (void)OsalMutexUnlock(&manager->lock);
+    return queue;
+}
+
+int32_t I2cCntlrTransferAsync(struct I2cCntlr *cntlr, struct I2cTransfer *xfer)
+{
+    uint32_t irqSave;
+    int32_t ret = HDF_SUCCESS;
+    struct I2cTransferQueue *queue = NULL;
+
+    if (cntlr == NULL) {
+        HDF_LOGE("I2cCntlrTransferAsync: cntlr is null");
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (cntlr->ops == NULL || cntlr->ops->transfer == NULL) {
+        HDF_LOGE("I2cCntlrTransferAsync: ops or transfer is null");
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (xfer == NULL || xfer->msgs == NULL || xfer->count <= 0 || xfer->callback == NULL) {
+        HDF_LOGE("I2cCntlrTransferAsync: invalid transfer!");
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    queue = I2cCntlrGetQueue(cntlr);
+    if (queue == NULL) {
+        return cntlr->removed ? HDF_PLT_ERR_NO_DEV : HDF_ERR_THREAD_CREATE_FAIL;
+    }
+
+    xfer->result = HDF_FAILURE;
+    xfer->submitTime = PlatformMonoTimeUs();
+    (void)OsalSpinLockIrqSave(&queue->spin, &irqSave);
+    if (queue->stopping) {
+        ret = HDF_PLT_ERR_NO_DEV;
+    } else if (queue->stat.depth >= I2C_QUEUE_DEPTH_MAX) {
+        ret = HDF_ERR_QUEUE_FULL;
+    } else {
+        DListInsertTail(&xfer->node, &queue->head);
+        queue->stat.depth++;
+        if (queue->stat.depth > queue->stat.depthMax) {
+            queue->stat.depthMax = queue->stat.depth;
+        }
+    }
+    (void)OsalSpinUnlockIrqRestore(&queue->spin, &irqSave);
+
+    if (ret == HDF_SUCCESS) {
+        (void)OsalSemPost(&queue->sem);
+    }
     return ret;
 }
 
-static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, struct I2cMsg **ppmsgs, int16_t *pcount, uint8_t **ppbuf)
+int32_t I2cCntlrGetQueueStat(struct I2cCntlr *cntlr, struct I2cQueueStat *stat)
+{
+    uint32_t irqSave;
+    struct I2cTransferQueue *queue = NULL;
+
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    queue = cntlr->queue;
+    if (queue == NULL) {
+        (void)memset_s(stat, sizeof(*stat), 0, sizeof(*stat));
+        return HDF_SUCCESS;
+    }
+    (void)OsalSpinLockIrqSave(&queue->spin, &irqSave);
+    *stat = queue->stat;
+    (void)OsalSpinUnlockIrqRestore(&queue->spin, &irqSave);
+    return HDF_SUCCESS;
+}
+
+int32_t I2cCntlrGetArbiterStat(struct I2cCntlr *cntlr, struct PlatformArbiterStat *stat)
+{
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (cntlr->lockOps != &g_i2cLockOpsDefault) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    return PlatformArbiterGetStat(&cntlr->arbiter, stat);
+}
+
+static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, struct I2cMsg **ppmsgs, int16_t *pcount,
+    uint32_t *pLenReply)
 {
     int16_t count, i;
     uint32_t len;
     uint32_t lenReply = 0;
     uint8_t *buf = NULL;
-    uint8_t *bufReply = NULL;
     struct I2cMsg *msgs = NULL;
 
     if (!HdfSbufReadBuffer(data, (const void **)&msgs, &len) || msgs == NULL) {
@@ -249,27 +634,40 @@ static int32_t I2cTransferRebuildMsgs(struct HdfSBuf *data, struct I2cMsg **ppms
         } else if (!HdfSbufReadBuffer(data, (const void **)&buf, &len)) {
             HDF_LOGE("I2cTransferRebuildMsgs: read msg[%d] buf fail!", i);
         } else {
+            // write msgs are transferred from the data buffer directly
             msgs[i].buf = buf;
             msgs[i].len = len;
         }
     }
 
-    if (lenReply > 0) {
-        bufReply = OsalMemCalloc(lenReply);
-        if (bufReply == NULL) {
+    *ppmsgs = msgs;
+    *pcount = count;
+    *pLenReply = lenReply;
+    return HDF_SUCCESS;
+}
+
+/* must be called with the controller locked, the staging buffer only grows so it's reused in steady state */
+static int32_t I2cCntlrStageReply(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count, uint32_t lenReply)
+{
+    int16_t i;
+    uint8_t *buf = NULL;
+
+    if (lenReply > cntlr->stageSize) {
+        buf = OsalMemCalloc(lenReply);
+        if (buf == NULL) {
             return HDF_ERR_MALLOC_FAIL;
         }
-        for (i = 0, buf = bufReply; i < count && buf < (bufReply + lenReply); i++) {
-            if ((msgs[i].flags & I2C_FLAG_READ) != 0) {
-                msgs[i].buf = buf;
-                buf += msgs[i].len;
-            }
-        }
+        OsalMemFree(cntlr->stageBuf);
+        cntlr->stageBuf = buf;
+        cntlr->stageSize = lenReply;
     }
 
-    *ppmsgs = msgs;
-    *pcount = count;
-    *ppbuf = bufReply;
+    for (i = 0, buf = cntlr->stageBuf; i < count && lenReply > 0; i++) {
+        if ((msgs[i].flags & I2C_FLAG_READ) != 0) {
+            msgs[i].buf = buf;
+            buf += msgs[i].len;
+        }
+    }
     return HDF_SUCCESS;
 }
 
@@ -296,8 +694,9 @@ static int32_t I2cManagerIoTransfer(struct HdfSBuf *data, struct HdfSBuf *reply)
     int16_t count;
     int16_t number;
     uint32_t handle;
-    uint8_t *bufReply = NULL;
+    uint32_t lenReply;
     struct I2cMsg *msgs = NULL;
+    struct I2cCntlr *cntlr = NULL;
 
     if (data == NULL || reply == NULL) {
         return HDF_ERR_INVALID_PARAM;
@@ -309,23 +708,36 @@ static int32_t I2cManagerIoTransfer(struct HdfSBuf *data, struct HdfSBuf *reply)
     }
     number = (int16_t)(handle - I2C_HANDLE_SHIFT);
 
-    ret = I2cTransferRebuildMsgs(data, &msgs, &count, &bufReply);
+    ret = I2cTransferRebuildMsgs(data, &msgs, &count, &lenReply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("I2cManagerIoTransfer: rebuild msgs fail:%d", ret);
         return ret;
     }
 
-    ret = I2cCntlrTransfer(I2cManagerFindCntlr(number), msgs, count);
-    if (ret != count) {
-        goto __EXIT__;
+    cntlr = I2cManagerFindCntlr(number);
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (cntlr->ops == NULL || cntlr->ops->transfer == NULL) {
+        HDF_LOGE("I2cManagerIoTransfer: ops or transfer is null");
+        return HDF_ERR_NOT_SUPPORT;
     }
 
-    ret = I2cTransferWriteBackMsgs(reply, msgs, count);
-
-__EXIT__:
-    if (bufReply != NULL) {
-        OsalMemFree(bufReply);
+    // read msgs share the staging buffer of the controller, keep it locked until the data are written back
+    if (I2cCntlrLock(cntlr) != HDF_SUCCESS) {
+        HDF_LOGE("I2cManagerIoTransfer: lock controller fail!");
+        return HDF_ERR_DEVICE_BUSY;
     }
+    ret = I2cCntlrStageReply(cntlr, msgs, count, lenReply);
+    if (ret != HDF_SUCCESS) {
+        I2cCntlrUnlock(cntlr);
+        return ret;
+    }
+    ret = cntlr->ops->transfer(cntlr, msgs, count);
+    if (ret == count) {
+        ret = I2cTransferWriteBackMsgs(reply, msgs, count);
+    }
+    I2cCntlrUnlock(cntlr);
     return ret;
 }
 
@@ -45,3 +45,17 @@ int32_t I2cTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t count)
     return I2cCntlrTransfer((struct I2cCntlr *)handle, msgs, count);
 }
 
+int32_t I2cTransferPrio(DevHandle handle, struct I2cMsg *msgs, int16_t count, enum PlatformPriority prio)
+{
+    if (handle == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (msgs == NULL || count <= 0 || prio >= PLATFORM_PRIORITY_NUM) {
+        HDF_LOGE("I2cTransferPrio: err params! msgs:%s, count:%d, prio:%d",
+            (msgs == NULL) ? "0" : "x", count, prio);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    return I2cCntlrTransferPrio((struct I2cCntlr *)handle, msgs, count, (uint32_t)prio);
+}
@@ -11,12 +11,21 @@
 #include "hdf_io_service_if.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG i2c_if_u
 
 #define I2C_SERVICE_NAME "HDF_PLATFORM_I2C_MANAGER"
 
+/* the sbufs of a client are reused by its transfers, and only grow when a transfer needs more */
+struct I2cClient {
+    uint32_t handle;
+    struct OsalMutex lock;
+    struct HdfSBuf *data;
+    struct HdfSBuf *reply;
+};
+
 static void *I2cManagerGetService(void)
 {
     static void *manager = NULL;
@@ -31,6 +40,63 @@ static void *I2cManagerGetService(void)
     return manager;
 }
 
+static DevHandle I2cClientCreate(uint32_t handle)
+{
+    struct I2cClient *client = NULL;
+
+    client = (struct I2cClient *)OsalMemCalloc(sizeof(*client));
+    if (client == NULL) {
+        HDF_LOGE("I2cClientCreate: alloc client fail!");
+        return NULL;
+    }
+    if (OsalMutexInit(&client->lock) != HDF_SUCCESS) {
+        HDF_LOGE("I2cClientCreate: init lock fail!");
+        OsalMemFree(client);
+        return NULL;
+    }
+    client->handle = handle;
+    return (DevHandle)client;
+}
+
+static void I2cClientDestroy(struct I2cClient *client)
+{
+    if (client->data != NULL) {
+        HdfSbufRecycle(client->data);
+    }
+    if (client->reply != NULL) {
+        HdfSbufRecycle(client->reply);
+    }
+    (void)OsalMutexDestroy(&client->lock);
+    OsalMemFree(client);
+}
+
+/* must be called with the client locked */
+static int32_t I2cClientPrepareSbuf(struct I2cClient *client, uint32_t recvLen)
+{
+    if (client->data == NULL) {
+        client->data = HdfSbufObtainDefaultSize();
+        if (client->data == NULL) {
+            HDF_LOGE("I2cClientPrepareSbuf: failed to obtain data!");
+            return HDF_ERR_MALLOC_FAIL;
+        }
+    }
+    HdfSbufFlush(client->data);
+
+    if (client->reply != NULL && HdfSbufGetCapacity(client->reply) < recvLen) {
+        HdfSbufRecycle(client->reply);
+        client->reply = NULL;
+    }
+    if (client->reply == NULL) {
+        client->reply = (recvLen == 0) ? HdfSbufObtainDefaultSize() : HdfSbufObtain(recvLen);
+        if (client->reply == NULL) {
+            HDF_LOGE("I2cClientPrepareSbuf: failed to obtain reply!");
+            return HDF_ERR_MALLOC_FAIL;
+        }
+    }
+    HdfSbufFlush(client->reply);
+    return HDF_SUCCESS;
+}
+
 DevHandle I2cOpen(int16_t number)
 {
     int32_t ret;
@@ -74,7 +140,7 @@ DevHandle I2cOpen(int16_t number)
 EXIT:
     HdfSbufRecycle(data);
     HdfSbufRecycle(reply);
-    return (handle == 0) ? NULL : (DevHandle)(uintptr_t)handle;
+    return (handle == 0) ? NULL : I2cClientCreate(handle);
 }
 
 void I2cClose(DevHandle handle)
@@ -82,21 +148,29 @@ void I2cClose(DevHandle handle)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct I2cClient *client = (struct I2cClient *)handle;
+
+    if (client == NULL) {
+        return;
+    }
 
     service = (struct HdfIoService *)I2cManagerGetService();
     if (service == NULL ||service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("I2cOpen: service is invalid!");
+        I2cClientDestroy(client);
         return;
     }
 
     data = HdfSbufObtainDefaultSize();
     if (data == NULL) {
+        I2cClientDestroy(client);
         return;
     }
 
-    if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
+    if (!HdfSbufWriteUint32(data, client->handle)) {
         HDF_LOGE("I2cClose: write handle fail!");
         HdfSbufRecycle(data);
+        I2cClientDestroy(client);
         return;
     }
 
@@ -105,13 +179,14 @@ void I2cClose(DevHandle handle)
         HDF_LOGE("I2cClose: close handle fail:%d", ret);
     }
     HdfSbufRecycle(data);
+    I2cClientDestroy(client);
 }
 
-static int32_t I2cMsgWriteArray(DevHandle handle, struct HdfSBuf *data, struct I2cMsg *msgs, int16_t count)
+static int32_t I2cMsgWriteArray(uint32_t handle, struct HdfSBuf *data, struct I2cMsg *msgs, int16_t count)
 {
     int16_t i;
 
-    if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
+    if (!HdfSbufWriteUint32(data, handle)) {
         HDF_LOGE("I2cMsgWriteArray: write handle fail!");
         return HDF_ERR_IO;
     }
@@ -175,61 +250,51 @@ static inline int32_t I2cMsgReadArray(struct HdfSBuf *reply, struct I2cMsg *msgs
     return HDF_SUCCESS;
 }
 
-static int32_t I2cServiceTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t count)
+static int32_t I2cServiceTransfer(struct I2cClient *client, struct I2cMsg *msgs, int16_t count)
 {
     int16_t i;
     int32_t ret;
     uint32_t recvLen = 0;
-    struct HdfSBuf *data = NULL;
-    struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("I2cServiceTransfer: failed to obtain data!");
-        return HDF_ERR_MALLOC_FAIL;
-    }
-
-    ret = I2cMsgWriteArray(handle, data, msgs, count);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("I2cServiceTransfer: failed to write msgs!");
-        goto EXIT;
+    service = (struct HdfIoService *)I2cManagerGetService();
+    if (service == NULL ||service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
     }
 
     for (i = 0; i < count; i++) {
         recvLen += ((msgs[i].flags & I2C_FLAG_READ) == 0) ? 0 : (msgs[i].len + sizeof(uint64_t));
     }
-    reply = (recvLen == 0) ? HdfSbufObtainDefaultSize() : HdfSbufObtain(recvLen);
-    if (reply == NULL) {
-        HDF_LOGE("I2cServiceTransfer: failed to obtain reply!");
-        ret = HDF_ERR_MALLOC_FAIL;
+
+    if (OsalMutexLock(&client->lock) != HDF_SUCCESS) {
+        HDF_LOGE("I2cServiceTransfer: lock client fail!");
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    ret = I2cClientPrepareSbuf(client, recvLen);
+    if (ret != HDF_SUCCESS) {
         goto EXIT;
     }
 
-    service = (struct HdfIoService *)I2cManagerGetService();
-    if (service == NULL ||service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
-        ret = HDF_ERR_NOT_SUPPORT;
+    ret = I2cMsgWriteArray(client->handle, client->data, msgs, count);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("I2cServiceTransfer: failed to write msgs!");
         goto EXIT;
     }
-    ret = service->dispatcher->Dispatch(&service->object, I2C_IO_TRANSFER, data, reply);
+
+    ret = service->dispatcher->Dispatch(&service->object, I2C_IO_TRANSFER, client->data, client->reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("I2cServiceTransfer: failed to send service call:%d", ret);
         goto EXIT;
     }
 
-    ret = I2cMsgReadArray(reply, msgs, count);
+    ret = I2cMsgReadArray(client->reply, msgs, count);
     if (ret != HDF_SUCCESS) {
         goto EXIT;
     }
 
     ret = count;
 EXIT:
-    if (data != NULL) {
-        HdfSbufRecycle(data);
-    }
-    if (reply != NULL) {
-        HdfSbufRecycle(reply);
-    }
+    (void)OsalMutexUnlock(&client->lock);
     return ret;
 }
 
@@ -245,6 +310,6 @@ int32_t I2cTransfer(DevHandle handle, struct I2cMsg *msgs, int16_t count)
         return HDF_ERR_INVALID_PARAM;
     }
 
-    return I2cServiceTransfer(handle, msgs, count);
+    return I2cServiceTransfer((struct I2cClient *)handle, msgs, count);
 }
 
@@ -9,9 +9,18 @@
 #include "i2s_core.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_time.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG i2s_core
 
+#define I2S_STREAM_PERIOD_MIN      2
+#define I2S_STREAM_PUMP_IDLE_MS    2
+#define I2S_STREAM_PUMP_STACK_SIZE (1024 * 8)
+
+static int32_t I2sStreamStart(struct I2sCntlr *cntlr, enum I2sStreamDir dir);
+static int32_t I2sStreamStop(struct I2sCntlr *cntlr, enum I2sStreamDir dir);
+
 int32_t I2sCntlrOpen(struct I2sCntlr *cntlr)
 {
     int32_t ret;
@@ -92,6 +101,9 @@ int32_t I2sCntlrStartRead(struct I2sCntlr *cntlr)
         HDF_LOGE("%s: invalid parameter", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    if (cntlr->stream[I2S_STREAM_READ] != NULL) {
+        return I2sStreamStart(cntlr, I2S_STREAM_READ);
+    }
     if (cntlr->method == NULL || cntlr->method->StartRead == NULL) {
         HDF_LOGE("%s: Open not support", __func__);
         return HDF_ERR_NOT_SUPPORT;
@@ -111,6 +123,9 @@ int32_t I2sCntlrStopRead(struct I2sCntlr *cntlr)
         HDF_LOGE("%s: invalid parameter", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    if (cntlr->stream[I2S_STREAM_READ] != NULL) {
+        return I2sStreamStop(cntlr, I2S_STREAM_READ);
+    }
     if (cntlr->method == NULL || cntlr->method->StopRead == NULL) {
         HDF_LOGE("%s: Open not support", __func__);
         return HDF_ERR_NOT_SUPPORT;
@@ -129,6 +144,9 @@ int32_t I2sCntlrStartWrite(struct I2sCntlr *cntlr)
         HDF_LOGE("%s: invalid parameter", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    if (cntlr->stream[I2S_STREAM_WRITE] != NULL) {
+        return I2sStreamStart(cntlr, I2S_STREAM_WRITE);
+    }
     if (cntlr->method == NULL || cntlr->method->StartWrite == NULL) {
         HDF_LOGE("%s: Open not support", __func__);
         return HDF_ERR_NOT_SUPPORT;
@@ -147,6 +165,9 @@ int32_t I2sCntlrStopWrite(struct I2sCntlr *cntlr)
         HDF_LOGE("%s: invalid parameter", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    if (cntlr->stream[I2S_STREAM_WRITE] != NULL) {
+        return I2sStreamStop(cntlr, I2S_STREAM_WRITE);
+    }
     if (cntlr->method == NULL || cntlr->method->StopWrite == NULL) {
         HDF_LOGE("%s: Open not support", __func__);
         return HDF_ERR_NOT_SUPPORT;
@@ -216,6 +237,383 @@ int32_t I2sCntlrTransfer(struct I2sCntlr *cntlr, struct I2sMsg *msg)
     return ret;
 }
 
+void I2sCntlrStreamPeriodElapsed(struct I2sCntlr *cntlr, enum I2sStreamDir dir)
+{
+    uint32_t flags;
+    uint64_t periods;
+    uint32_t silence = 0;
+    uint32_t offset;
+    struct I2sStream *stream = NULL;
+
+    if (cntlr == NULL || dir >= I2S_STREAM_DIR_MAX || cntlr->stream[dir] == NULL) {
+        return;
+    }
+    stream = cntlr->stream[dir];
+    if (!stream->running) {
+        return;
+    }
+
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    stream->hwPtr += stream->periodSize;
+    stream->periods++;
+    if (dir == I2S_STREAM_READ) {
+        /* the period the controller moves on to still holds data nobody read */
+        if (stream->hwPtr - stream->applPtr > stream->bufferSize - stream->periodSize) {
+            stream->xruns++;
+        }
+    } else if (stream->applPtr < stream->hwPtr + stream->periodSize) {
+        /* nothing queued for the period the controller moves on to: play silence and restart after it */
+        stream->xruns++;
+        stream->applPtr = stream->hwPtr + stream->periodSize;
+        silence = stream->periodSize;
+    }
+    offset = (uint32_t)(stream->hwPtr % stream->bufferSize);
+    periods = stream->periods;
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+
+    if (silence != 0) {
+        (void)memset_s(stream->buffer + offset, silence, 0, silence);
+    }
+    if (stream->notify != NULL) {
+        stream->notify(stream->priv, periods);
+    }
+}
+
+static int32_t I2sStreamPump(void *data)
+{
+    int32_t ret;
+    uint32_t done = 0;
+    uint32_t len;
+    uint32_t offset;
+    struct I2sMsg msg;
+    struct I2sStream *stream = (struct I2sStream *)data;
+    struct I2sCntlr *cntlr = stream->cntlr;
+
+    while (stream->running) {
+        /* only this thread advances hwPtr of a soft stream */
+        offset = (uint32_t)(stream->hwPtr % stream->bufferSize) + done;
+        len = 0;
+        msg.wbuf = (stream->dir == I2S_STREAM_WRITE) ? stream->buffer + offset : NULL;
+        msg.rbuf = (stream->dir == I2S_STREAM_READ) ? stream->buffer + offset : NULL;
+        msg.len = stream->periodSize - done;
+        msg.pRlen = &len;
+        (void)OsalMutexLock(&(cntlr->lock));
+        ret = cntlr->method->Transfer(cntlr, &msg);
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        if (ret != HDF_SUCCESS || len == 0) {
+            OsalMSleep(I2S_STREAM_PUMP_IDLE_MS);
+            continue;
+        }
+        done += (len < msg.len) ? len : msg.len;
+        if (done == stream->periodSize) {
+            done = 0;
+            I2sCntlrStreamPeriodElapsed(cntlr, stream->dir);
+        }
+    }
+    (void)OsalSemPost(&stream->exitSem);
+    return HDF_SUCCESS;
+}
+
+static int32_t I2sStreamPumpStart(struct I2sStream *stream)
+{
+    int32_t ret;
+    struct OsalThreadParam param;
+
+    (void)OsalSemInit(&stream->exitSem, 0);
+    ret = OsalThreadCreate(&stream->thread, I2sStreamPump, stream);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: create pump thread fail:%d", __func__, ret);
+        (void)OsalSemDestroy(&stream->exitSem);
+        return ret;
+    }
+    param.name = (stream->dir == I2S_STREAM_READ) ? "i2s_stream_rx" : "i2s_stream_tx";
+    param.priority = OSAL_THREAD_PRI_HIGH;
+    param.stackSize = I2S_STREAM_PUMP_STACK_SIZE;
+    ret = OsalThreadStart(&stream->thread, &param);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start pump thread fail:%d", __func__, ret);
+        (void)OsalThreadDestroy(&stream->thread);
+        (void)OsalSemDestroy(&stream->exitSem);
+    }
+    return ret;
+}
+
+static int32_t I2sStreamStart(struct I2sCntlr *cntlr, enum I2sStreamDir dir)
+{
+    int32_t ret;
+    uint32_t flags;
+    struct I2sStream *stream = NULL;
+    struct I2sCntlrMethod *method = cntlr->method;
+
+    if (method == NULL || (method->StartStream == NULL &&
+        (method->Transfer == NULL || (dir == I2S_STREAM_READ ? method->StartRead : method->StartWrite) == NULL))) {
+        HDF_LOGE("%s: stream not support", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    (void)OsalMutexLock(&(cntlr->lock));
+    stream = cntlr->stream[dir];
+    if (stream == NULL) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (stream->running || stream->stopping) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    stream->periods = 0;
+    stream->xruns = 0;
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+    stream->soft = (method->StartStream == NULL);
+    if (!stream->soft) {
+        stream->running = true;
+        ret = method->StartStream(cntlr, dir, stream);
+    } else {
+        ret = (dir == I2S_STREAM_READ) ? method->StartRead(cntlr) : method->StartWrite(cntlr);
+        if (ret == HDF_SUCCESS) {
+            stream->running = true;
+            ret = I2sStreamPumpStart(stream);
+            if (ret != HDF_SUCCESS) {
+                (void)((dir == I2S_STREAM_READ) ? method->StopRead(cntlr) : method->StopWrite(cntlr));
+            }
+        }
+    }
+    if (ret != HDF_SUCCESS) {
+        stream->running = false;
+    }
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    return ret;
+}
+
+static int32_t I2sStreamStop(struct I2sCntlr *cntlr, enum I2sStreamDir dir)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t flags;
+    struct I2sStream *stream = NULL;
+    struct I2sCntlrMethod *method = cntlr->method;
+
+    (void)OsalMutexLock(&(cntlr->lock));
+    stream = cntlr->stream[dir];
+    if (stream == NULL || !stream->running || stream->stopping) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        return HDF_SUCCESS;
+    }
+    stream->running = false;
+    stream->stopping = true;
+    (void)OsalMutexUnlock(&(cntlr->lock));
+
+    /* the pump takes the controller lock for every transfer, so it is joined outside of it */
+    if (stream->soft) {
+        (void)OsalSemWait(&stream->exitSem, HDF_WAIT_FOREVER);
+        (void)OsalThreadDestroy(&stream->thread);
+        (void)OsalSemDestroy(&stream->exitSem);
+    }
+
+    (void)OsalMutexLock(&(cntlr->lock));
+    if (!stream->soft) {
+        ret = method->StopStream(cntlr, dir);
+    } else if (dir == I2S_STREAM_READ && method->StopRead != NULL) {
+        ret = method->StopRead(cntlr);
+    } else if (dir == I2S_STREAM_WRITE && method->StopWrite != NULL) {
+        ret = method->StopWrite(cntlr);
+    }
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    stream->hwPtr = 0;
+    stream->applPtr = 0;
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+    (void)memset_s(stream->buffer, stream->bufferSize, 0, stream->bufferSize);
+    stream->stopping = false;
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    return ret;
+}
+
+static void I2sStreamFree(struct I2sStream *stream)
+{
+    (void)OsalSpinDestroy(&stream->spin);
+    OsalMemFree(stream->buffer);
+    OsalMemFree(stream);
+}
+
+int32_t I2sCntlrSetStream(struct I2sCntlr *cntlr, enum I2sStreamDir dir, const struct I2sStreamCfg *cfg)
+{
+    struct I2sStream *stream = NULL;
+
+    if (cntlr == NULL || dir >= I2S_STREAM_DIR_MAX) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cfg != NULL && (cfg->periodSize == 0 || cfg->periodCount < I2S_STREAM_PERIOD_MIN ||
+        cfg->periodSize > UINT32_MAX / cfg->periodCount)) {
+        HDF_LOGE("%s: invalid ring %u x %u", __func__, cfg->periodSize, cfg->periodCount);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cfg != NULL) {
+        stream = (struct I2sStream *)OsalMemCalloc(sizeof(*stream));
+        if (stream == NULL) {
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        stream->bufferSize = cfg->periodSize * cfg->periodCount;
+        stream->buffer = (uint8_t *)OsalMemCalloc(stream->bufferSize);
+        if (stream->buffer == NULL) {
+            HDF_LOGE("%s: alloc %u bytes ring fail", __func__, stream->bufferSize);
+            OsalMemFree(stream);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        stream->cntlr = cntlr;
+        stream->dir = dir;
+        stream->periodSize = cfg->periodSize;
+        stream->periodCount = cfg->periodCount;
+        stream->notify = cfg->notify;
+        stream->priv = cfg->priv;
+        (void)OsalSpinInit(&stream->spin);
+    }
+
+    (void)OsalMutexLock(&(cntlr->lock));
+    if (cntlr->stream[dir] != NULL && (cntlr->stream[dir]->running || cntlr->stream[dir]->stopping)) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        HDF_LOGE("%s: stream %d is running", __func__, dir);
+        if (stream != NULL) {
+            I2sStreamFree(stream);
+        }
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    if (cntlr->stream[dir] != NULL) {
+        I2sStreamFree(cntlr->stream[dir]);
+    }
+    cntlr->stream[dir] = stream;
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    return HDF_SUCCESS;
+}
+
+static void I2sStreamCopy(uint8_t *dst, uint32_t dstOffset, const uint8_t *src, uint32_t srcOffset,
+    uint32_t len)
+{
+    if (len != 0) {
+        (void)memcpy_s(dst + dstOffset, len, src + srcOffset, len);
+    }
+}
+
+int32_t I2sCntlrStreamRead(struct I2sCntlr *cntlr, uint8_t *buf, uint32_t len, uint32_t *pRlen)
+{
+    uint32_t flags;
+    uint32_t avail;
+    uint32_t offset;
+    uint32_t first;
+    uint32_t safe;
+    struct I2sStream *stream = NULL;
+
+    if (cntlr == NULL || buf == NULL || pRlen == NULL) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    (void)OsalMutexLock(&(cntlr->lock));
+    stream = cntlr->stream[I2S_STREAM_READ];
+    if (stream == NULL) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        HDF_LOGE("%s: no read stream", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    safe = stream->bufferSize - stream->periodSize;
+
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    if (stream->hwPtr - stream->applPtr > safe) {
+        stream->applPtr = stream->hwPtr - safe; // overrun: skip to the oldest period still intact
+    }
+    avail = (uint32_t)(stream->hwPtr - stream->applPtr);
+    offset = (uint32_t)(stream->applPtr % stream->bufferSize);
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+
+    avail = (avail < len) ? avail : len;
+    first = (avail < stream->bufferSize - offset) ? avail : stream->bufferSize - offset;
+    I2sStreamCopy(buf, 0, stream->buffer, offset, first);
+    I2sStreamCopy(buf, first, stream->buffer, 0, avail - first);
+
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    stream->applPtr += avail;
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    *pRlen = avail;
+    return HDF_SUCCESS;
+}
+
+int32_t I2sCntlrStreamWrite(struct I2sCntlr *cntlr, const uint8_t *buf, uint32_t len, uint32_t *pWlen)
+{
+    uint32_t flags;
+    uint32_t room;
+    uint32_t offset;
+    uint32_t first;
+    uint64_t appl;
+    struct I2sStream *stream = NULL;
+
+    if (cntlr == NULL || buf == NULL || pWlen == NULL) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    (void)OsalMutexLock(&(cntlr->lock));
+    stream = cntlr->stream[I2S_STREAM_WRITE];
+    if (stream == NULL) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        HDF_LOGE("%s: no write stream", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    appl = stream->applPtr;
+    room = (uint32_t)(stream->hwPtr + stream->bufferSize - appl);
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+
+    room = (room < len) ? room : len;
+    offset = (uint32_t)(appl % stream->bufferSize);
+    first = (room < stream->bufferSize - offset) ? room : stream->bufferSize - offset;
+    I2sStreamCopy(stream->buffer, offset, buf, 0, first);
+    I2sStreamCopy(stream->buffer, 0, buf, first, room - first);
+
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    if (stream->applPtr == appl) {
+        stream->applPtr += room;
+    } else {
+        room = 0; // an underrun moved the stream past what was just written
+    }
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    *pWlen = room;
+    return HDF_SUCCESS;
+}
+
+int32_t I2sCntlrGetStreamStat(struct I2sCntlr *cntlr, enum I2sStreamDir dir, struct I2sStreamStat *stat)
+{
+    uint32_t flags;
+    uint64_t used;
+    struct I2sStream *stream = NULL;
+
+    if (cntlr == NULL || dir >= I2S_STREAM_DIR_MAX || stat == NULL) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    (void)OsalMutexLock(&(cntlr->lock));
+    stream = cntlr->stream[dir];
+    if (stream == NULL) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        HDF_LOGE("%s: no stream %d", __func__, dir);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalSpinLockIrqSave(&stream->spin, &flags);
+    stat->periods = stream->periods;
+    stat->xruns = stream->xruns;
+    if (dir == I2S_STREAM_READ) {
+        used = stream->hwPtr - stream->applPtr;
+        stat->avail = (uint32_t)((used < stream->bufferSize - stream->periodSize) ?
+            used : stream->bufferSize - stream->periodSize);
+    } else {
+        stat->avail = (uint32_t)(stream->hwPtr + stream->bufferSize - stream->applPtr);
+    }
+    (void)OsalSpinUnlockIrqRestore(&stream->spin, &flags);
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    return HDF_SUCCESS;
+}
+
 struct I2sCntlr *I2sCntlrCreate(struct HdfDeviceObject *device)
 {
     struct I2sCntlr *cntlr = NULL;
@@ -240,11 +638,20 @@ struct I2sCntlr *I2sCntlrCreate(struct HdfDeviceObject *device)
 
 void I2sCntlrDestroy(struct I2sCntlr *cntlr)
 {
+    int dir;
+
     if (cntlr == NULL) {
         HDF_LOGE("%s: invalid parameter", __func__);
         return;
     }
 
+    for (dir = I2S_STREAM_READ; dir < I2S_STREAM_DIR_MAX; dir++) {
+        if (cntlr->stream[dir] != NULL) {
+            (void)I2sStreamStop(cntlr, dir);
+            I2sStreamFree(cntlr->stream[dir]);
+            cntlr->stream[dir] = NULL;
+        }
+    }
     (void)OsalMutexDestroy(&(cntlr->lock));
     cntlr->device = NULL;
     cntlr->method = NULL;
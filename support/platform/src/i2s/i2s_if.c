@@ -231,3 +231,39 @@ void I2sGetCfg(DevHandle handle, struct I2sCfg *cfg)
         HDF_LOGE("%s: I2sCntlrSetCfg fail", __func__);
     }
 }
+
+int32_t I2sSetStream(DevHandle handle, enum I2sStreamDir dir, const struct I2sStreamCfg *cfg)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: cntlr is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return I2sCntlrSetStream((struct I2sCntlr *)handle, dir, cfg);
+}
+
+int32_t I2sStreamRead(DevHandle handle, uint8_t *buf, uint32_t len, uint32_t *pRlen)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: cntlr is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return I2sCntlrStreamRead((struct I2sCntlr *)handle, buf, len, pRlen);
+}
+
+int32_t I2sStreamWrite(DevHandle handle, const uint8_t *buf, uint32_t len, uint32_t *pWlen)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: cntlr is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return I2sCntlrStreamWrite((struct I2sCntlr *)handle, buf, len, pWlen);
+}
+
+int32_t I2sGetStreamStat(DevHandle handle, enum I2sStreamDir dir, struct I2sStreamStat *stat)
+{
+    if (handle == NULL) {
+        HDF_LOGE("%s: cntlr is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return I2sCntlrGetStreamStat((struct I2sCntlr *)handle, dir, stat);
+}
@@ -11,8 +11,10 @@
 #include "hdf_log.h"
 #include "osal_mem.h"
 #include "osal_mutex.h"
+#include "osal_time.h"
 
 #define I3C_SERVICE_NAME "HDF_PLATFORM_I3C_MANAGER"
+#define I3C_IBI_FREE_WAIT_MS 1
 
 struct I3cManager {
     struct IDeviceIoService service;
@@ -45,7 +47,7 @@ static inline int32_t I3cCntlrLockDefault(struct I3cCntlr *cntlr)
     if (cntlr == NULL) {
         return HDF_ERR_DEVICE_BUSY;
     }
-    return OsalSpinLock(&cntlr->lock);
+    return PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
 }
 
 static inline void I3cCntlrUnlockDefault(struct I3cCntlr *cntlr)
@@ -53,7 +55,7 @@ static inline void I3cCntlrUnlockDefault(struct I3cCntlr *cntlr)
     if (cntlr == NULL) {
         return;
     }
-    (void)OsalSpinUnlock(&cntlr->lock);
+    PlatformArbiterRelease(&cntlr->arbiter);
 }
 
 static const struct I3cLockMethod g_i3cLockOpsDefault = {
@@ -91,6 +93,11 @@ static void I3cDeviceListPut(void)
     (void)OsalSpinUnlock(&g_listLock);
 }
 
+static inline uint16_t I3cDeviceGetAddr(const struct I3cDevice *device)
+{
+    return (device->dynaAddr != 0) ? device->dynaAddr : device->addr;
+}
+
 static int32_t GetAddrStatus(struct I3cCntlr *cntlr, uint16_t addr)
 {
     int32_t status;
@@ -169,6 +176,7 @@ static int32_t GetFreeAddr(struct I3cCntlr *cntlr)
     for (count = 0; count <= I3C_ADDR_MAX; count++) {
         status = (enum I3cAddrStatus)GetAddrStatus(cntlr, count);
         if (status == I3C_ADDR_FREE) {
+            I3cCntlrUnlock(cntlr);
             return (int32_t)count;
         }
     }
@@ -226,17 +234,26 @@ struct I3cDevice *GetDeviceByAddr(struct I3cCntlr *cntlr, uint16_t addr)
 
     if (addrStatus == I3C_ADDR_I2C_DEVICE || addrStatus == I3C_ADDR_I3C_DEVICE) {
         head = I3cDeviceListGet();
+        /* dynamic addresses may be assigned after the device was added, so a cache entry is checked before use */
+        pos = cntlr->devices[addr];
+        if (pos != NULL && I3cDeviceGetAddr(pos) == addr) {
+            I3cDeviceListPut();
+            return pos;
+        }
         DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, head, struct I3cDevice, list) {
             if ((pos->dynaAddr == addr) && (pos->cntlr == cntlr)) {
+                cntlr->devices[addr] = pos;
                 I3cDeviceListPut();
                 HDF_LOGI("%s: found by dynaAddr,done!", __func__);
                 return pos;
             } else if ((!pos->dynaAddr) && (pos->addr == addr) && (pos->cntlr == cntlr)) {
+                cntlr->devices[addr] = pos;
                 HDF_LOGI("%s: found by Addr,done!", __func__);
                 I3cDeviceListPut();
                 return pos;
             }
         }
+        I3cDeviceListPut();
     }
     HDF_LOGE("%s: No such device found! addr: 0x%x", __func__, addr);
 
@@ -302,6 +319,7 @@ int32_t I3cDeviceAdd(struct I3cDevice *device)
     }
     DListHeadInit(&device->list);
     DListInsertTail(&device->list, head);
+    device->cntlr->devices[I3cDeviceGetAddr(device)] = device;
     I3cDeviceListPut();
     HDF_LOGI("%s: done!", __func__);
 
@@ -311,6 +329,8 @@ int32_t I3cDeviceAdd(struct I3cDevice *device)
 void I3cDeviceRemove(struct I3cDevice *device)
 {
     int32_t ret;
+    uint16_t addr;
+
     if (device == NULL) {
         return;
     }
@@ -321,6 +341,11 @@ void I3cDeviceRemove(struct I3cDevice *device)
     }
     (void)I3cDeviceListGet();
     DListRemove(&device->list);
+    for (addr = 0; addr <= I3C_ADDR_MAX; addr++) {
+        if (device->cntlr->devices[addr] == device) {
+            device->cntlr->devices[addr] = NULL;
+        }
+    }
     I3cDeviceListPut();
 }
 
@@ -413,6 +438,41 @@ void I3cCntlrPut(struct I3cCntlr *cntlr)
     (void)cntlr;
 }
 
+static uint16_t I3cIbiNextFreeSlot(const struct I3cIbiInfo *ibi)
+{
+    uint16_t i;
+
+    for (i = 0; i < I3C_IBI_SLOT_NUM; i++) {
+        if ((ibi->busyMask & (1U << i)) == 0) {
+            return i;
+        }
+    }
+    return I3C_IBI_SLOT_NUM;
+}
+
+static int32_t I3cIbiDispatch(struct PlatformQueue *queue, struct PlatformMsg *msg)
+{
+    uint32_t flags;
+    struct I3cIbiData data;
+    struct I3cIbiInfo *ibi = (struct I3cIbiInfo *)msg->data;
+    struct I3cDevice *device = ibi->device;
+    uint16_t index = (uint16_t)msg->code;
+
+    (void)queue;
+    data.payload = ibi->payload;
+    data.buf = ibi->slots[index].data;
+    (void)ibi->ibiFunc(device->cntlr, I3cDeviceGetAddr(device), data);
+
+    (void)OsalSpinLockIrqSave(&ibi->lock, &flags);
+    ibi->busyMask &= ~(1U << index);
+    if (ibi->cur >= I3C_IBI_SLOT_NUM) {
+        ibi->cur = index;
+        ibi->data = ibi->slots[index].data;
+    }
+    (void)OsalSpinUnlockIrqRestore(&ibi->lock, &flags);
+    return HDF_SUCCESS;
+}
+
 int32_t I3cCntlrAdd(struct I3cCntlr *cntlr)
 {
     int32_t ret;
@@ -431,19 +491,42 @@ int32_t I3cCntlrAdd(struct I3cCntlr *cntlr)
         cntlr->lockOps = &g_i3cLockOpsDefault;
     }
 
-    if (OsalSpinInit(&cntlr->lock) != HDF_SUCCESS) {
-        HDF_LOGE("%s: init lock fail!", __func__);
+    if (PlatformArbiterInit(&cntlr->arbiter) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init arbiter fail!", __func__);
+        return HDF_FAILURE;
+    }
+
+    if (OsalSpinInit(&cntlr->ibiLock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init ibi lock fail!", __func__);
+        PlatformArbiterUninit(&cntlr->arbiter);
         return HDF_FAILURE;
     }
 
     I3cInitAddrStatus(cntlr);
+    cntlr->ibiQueue = PlatformQueueCreate(I3cIbiDispatch, "PlatformI3cIbiThread", cntlr);
+    if (cntlr->ibiQueue == NULL) {
+        HDF_LOGE("%s: create ibi queue fail!", __func__);
+        ret = HDF_FAILURE;
+        goto __ERR_QUEUE;
+    }
+    ret = PlatformQueueStart(cntlr->ibiQueue);
+    if (ret != HDF_SUCCESS) {
+        goto __ERR_START;
+    }
     ret = I3cManagerAddCntlr(cntlr);
     if (ret != HDF_SUCCESS) {
-        (void)OsalSpinDestroy(&cntlr->lock);
-        return ret;
+        goto __ERR_START;
     }
 
     return HDF_SUCCESS;
+
+__ERR_START:
+    PlatformQueueDestroy(cntlr->ibiQueue);
+    cntlr->ibiQueue = NULL;
+__ERR_QUEUE:
+    (void)OsalSpinDestroy(&cntlr->ibiLock);
+    PlatformArbiterUninit(&cntlr->arbiter);
+    return ret;
 }
 
 void I3cCntlrRemove(struct I3cCntlr *cntlr)
@@ -452,7 +535,12 @@ void I3cCntlrRemove(struct I3cCntlr *cntlr)
         return;
     }
     I3cManagerRemoveCntlr(cntlr);
-    (void)OsalSpinDestroy(&cntlr->lock);
+    if (cntlr->ibiQueue != NULL) {
+        PlatformQueueDestroy(cntlr->ibiQueue);
+        cntlr->ibiQueue = NULL;
+    }
+    (void)OsalSpinDestroy(&cntlr->ibiLock);
+    PlatformArbiterUninit(&cntlr->arbiter);
 }
 
 int32_t I3cCntlrTransfer(struct I3cCntlr *cntlr, struct I3cMsg *msgs, int16_t count)
@@ -566,11 +654,70 @@ int32_t I3cCntlrGetConfig(struct I3cCntlr *cntlr, struct I3cConfig *config)
     return ret;
 }
 
+int32_t I3cCntlrGetArbiterStat(struct I3cCntlr *cntlr, struct PlatformArbiterStat *stat)
+{
+    if (cntlr == NULL) {
+        HDF_LOGE("%s: cntlr is NULL!", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return PlatformArbiterGetStat(&cntlr->arbiter, stat);
+}
+
+static struct I3cIbiInfo *I3cIbiInfoCreate(struct I3cDevice *device, I3cIbiFunc func, uint32_t payload)
+{
+    uint16_t i;
+    struct I3cIbiInfo *ibi = NULL;
+
+    if (payload > UINT32_MAX / I3C_IBI_SLOT_NUM) {
+        return NULL;
+    }
+    ibi = (struct I3cIbiInfo *)OsalMemCalloc(sizeof(*ibi));
+    if (ibi == NULL) {
+        return NULL;
+    }
+    if (payload != 0) {
+        ibi->buffer = (uint8_t *)OsalMemCalloc(payload * I3C_IBI_SLOT_NUM);
+        if (ibi->buffer == NULL) {
+            OsalMemFree(ibi);
+            return NULL;
+        }
+    }
+    for (i = 0; i < I3C_IBI_SLOT_NUM; i++) {
+        ibi->slots[i].data = (ibi->buffer == NULL) ? NULL : ibi->buffer + (size_t)i * payload;
+        ibi->slots[i].msg.code = i;
+        ibi->slots[i].msg.data = ibi;
+    }
+    (void)OsalSpinInit(&ibi->lock);
+    ibi->ibiFunc = func;
+    ibi->payload = payload;
+    ibi->device = device;
+    ibi->cur = 0;
+    ibi->data = ibi->slots[0].data;
+    return ibi;
+}
+
+static void I3cIbiInfoDestroy(struct I3cIbiInfo *ibi)
+{
+    (void)OsalSpinDestroy(&ibi->lock);
+    if (ibi->buffer != NULL) {
+        OsalMemFree(ibi->buffer);
+    }
+    OsalMemFree(ibi);
+}
+
+static void I3cCntlrSetDeviceIbi(struct I3cCntlr *cntlr, struct I3cDevice *device, struct I3cIbiInfo *ibi)
+{
+    uint32_t flags;
+
+    (void)OsalSpinLockIrqSave(&cntlr->ibiLock, &flags);
+    device->ibi = ibi;
+    (void)OsalSpinUnlockIrqRestore(&cntlr->ibiLock, &flags);
+}
+
 int32_t I3cCntlrRequestIbi(struct I3cCntlr *cntlr, uint16_t addr, I3cIbiFunc func, uint32_t payload)
 {
     struct I3cDevice *device = NULL;
     struct I3cIbiInfo *ibi = NULL;
-    uint16_t ptr;
     int32_t ret;
 
     if (cntlr == NULL) {
@@ -593,38 +740,50 @@ int32_t I3cCntlrRequestIbi(struct I3cCntlr *cntlr, uint16_t addr, I3cIbiFunc fun
         HDF_LOGE("%s: not support!", __func__);
         return HDF_ERR_NOT_SUPPORT;
     }
+    if (cntlr->ibiQueue == NULL) {
+        HDF_LOGE("%s: no ibi dispatch queue!", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    /* all payload slots are allocated here, so the interrupt path never has to */
+    ibi = I3cIbiInfoCreate(device, func, payload);
+    if (ibi == NULL) {
+        HDF_LOGE("func:%s ibi is NULL!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
     if (I3cCntlrLock(cntlr) != HDF_SUCCESS) {
         HDF_LOGE("%s: lock controller fail!", __func__);
+        I3cIbiInfoDestroy(ibi);
         return HDF_ERR_DEVICE_BUSY;
     }
 
-    for (ptr = 0; ptr < I3C_IBI_MAX; ptr++) {
-        if (cntlr->ibiSlot[ptr] != NULL) {
-            continue;
-        }
-        ibi = (struct I3cIbiInfo *)OsalMemCalloc(sizeof(*ibi));
-        if (ibi == NULL) {
-            HDF_LOGE("func:%s ibi is NULL!", __func__);
-            return HDF_ERR_MALLOC_FAIL;
-        }
-        ibi->ibiFunc = func;
-        ibi->payload = payload;
-        ibi->data = (uint8_t *)OsalMemCalloc(sizeof(uint8_t) * payload);
-        device->ibi = ibi;
-        cntlr->ibiSlot[ptr] = device->ibi;
-        ret = cntlr->ops->requestIbi(device);
+    if (cntlr->ibiSlot[addr] != NULL || device->ibi != NULL || cntlr->ibiNum >= I3C_IBI_MAX) {
+        I3cCntlrUnlock(cntlr);
+        I3cIbiInfoDestroy(ibi);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    I3cCntlrSetDeviceIbi(cntlr, device, ibi);
+    cntlr->ibiSlot[addr] = ibi;
+    cntlr->ibiNum++;
+    ret = cntlr->ops->requestIbi(device);
+    if (ret != HDF_SUCCESS) {
+        cntlr->ibiSlot[addr] = NULL;
+        cntlr->ibiNum--;
+        I3cCntlrSetDeviceIbi(cntlr, device, NULL);
         I3cCntlrUnlock(cntlr);
+        I3cIbiInfoDestroy(ibi);
         return ret;
     }
     I3cCntlrUnlock(cntlr);
 
-    return HDF_ERR_DEVICE_BUSY;
+    return HDF_SUCCESS;
 }
 
 int32_t I3cCntlrFreeIbi(struct I3cCntlr *cntlr, uint16_t addr)
 {
     struct I3cDevice *device = NULL;
-    uint16_t ptr;
+    struct I3cIbiInfo *ibi = NULL;
+    uint32_t flags;
+    uint16_t busyMask;
 
     if (cntlr == NULL) {
         return HDF_ERR_INVALID_OBJECT;
@@ -641,57 +800,84 @@ int32_t I3cCntlrFreeIbi(struct I3cCntlr *cntlr, uint16_t addr)
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    for (ptr = 0; ptr < I3C_IBI_MAX; ptr++) {
-        if (cntlr->ibiSlot[ptr] == NULL || device->ibi == NULL) {
-            break;
-        }
-        if (cntlr->ibiSlot[ptr] != device->ibi) {
-            break;
-        }
-        cntlr->ibiSlot[ptr] = NULL;
-        if (device->ibi->data != NULL) {
-            OsalMemFree(device->ibi->data);
+    if (I3cCntlrLock(cntlr) != HDF_SUCCESS) {
+        HDF_LOGE("%s: lock controller fail!", __func__);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    ibi = cntlr->ibiSlot[addr];
+    if (ibi == NULL || device->ibi != ibi) {
+        I3cCntlrUnlock(cntlr);
+        return HDF_SUCCESS;
+    }
+    /* claim the slot first, a concurrent free finds it empty and leaves the info to this one */
+    cntlr->ibiSlot[addr] = NULL;
+    cntlr->ibiNum--;
+    (void)OsalSpinLockIrqSave(&ibi->lock, &flags);
+    ibi->stopping = true;
+    (void)OsalSpinUnlockIrqRestore(&ibi->lock, &flags);
+    /* a callback still racing in holds the ibi lock, so it's done with the info once this returns */
+    I3cCntlrSetDeviceIbi(cntlr, device, NULL);
+    I3cCntlrUnlock(cntlr);
+
+    /* no new IBIs get in now, wait for the handlers already queued; must not be called from the handler */
+    if (cntlr->ops != NULL && cntlr->ops->freeIbi != NULL) {
+        cntlr->ops->freeIbi(device);
+    }
+    do {
+        (void)OsalSpinLockIrqSave(&ibi->lock, &flags);
+        busyMask = ibi->busyMask;
+        (void)OsalSpinUnlockIrqRestore(&ibi->lock, &flags);
+        if (busyMask != 0) {
+            OsalMSleep(I3C_IBI_FREE_WAIT_MS);
         }
-        OsalMemFree(device->ibi);
-        device->ibi = NULL;
-        break;
+    } while (busyMask != 0);
+
+    if (ibi->dropped != 0) {
+        HDF_LOGW("%s: %u IBIs of addr 0x%x dropped with all slots pending", __func__, ibi->dropped, addr);
     }
+    I3cIbiInfoDestroy(ibi);
 
     return HDF_SUCCESS;
 }
 
 int32_t I3cCntlrIbiCallback(struct I3cDevice *device)
 {
-    struct I3cIbiData *ibiData = NULL;
+    uint32_t flags;
+    uint32_t ibiFlags;
+    uint16_t index;
+    struct I3cCntlr *cntlr = NULL;
+    struct I3cIbiInfo *ibi = NULL;
 
-    if (device == NULL) {
+    if (device == NULL || device->cntlr == NULL) {
             HDF_LOGW("%s: invalid device!", __func__);
             return HDF_ERR_INVALID_PARAM;
     }
+    cntlr = device->cntlr;
 
-    ibiData = (struct I3cIbiData *)OsalMemCalloc(sizeof(*ibiData));
-    if (ibiData == NULL) {
-        HDF_LOGE("%s: Memcalloc failed", __func__);
-        return HDF_ERR_MALLOC_FAIL;
-    }
-
-    ibiData->buf = device->ibi->data;
-    ibiData->payload = device->ibi->payload;
-
-    if (device->ibi->ibiFunc == NULL) {
+    (void)OsalSpinLockIrqSave(&cntlr->ibiLock, &flags);
+    ibi = device->ibi;
+    if (ibi == NULL || ibi->ibiFunc == NULL) {
+        (void)OsalSpinUnlockIrqRestore(&cntlr->ibiLock, &flags);
         HDF_LOGW("%s: device->ibi or ibiFunc is NULL!", __func__);
         return HDF_ERR_NOT_SUPPORT;
     }
 
-    if (device->dynaAddr != 0) {
-        (void)device->ibi->ibiFunc(device->cntlr, device->dynaAddr, *ibiData);
-        OsalMemFree(ibiData);
-    } else {
-        (void)device->ibi->ibiFunc(device->cntlr, device->addr, *ibiData);
-        OsalMemFree(ibiData);
+    (void)OsalSpinLockIrqSave(&ibi->lock, &ibiFlags);
+    index = ibi->cur;
+    if (ibi->stopping || index >= I3C_IBI_SLOT_NUM) {
+        ibi->dropped++;
+        (void)OsalSpinUnlockIrqRestore(&ibi->lock, &ibiFlags);
+        (void)OsalSpinUnlockIrqRestore(&cntlr->ibiLock, &flags);
+        return HDF_ERR_DEVICE_BUSY;
     }
+    ibi->busyMask |= (uint16_t)(1U << index);
+    ibi->cur = I3cIbiNextFreeSlot(ibi);
+    ibi->data = (ibi->cur < I3C_IBI_SLOT_NUM) ? ibi->slots[ibi->cur].data : NULL;
+    (void)OsalSpinUnlockIrqRestore(&ibi->lock, &ibiFlags);
+    (void)OsalSpinUnlockIrqRestore(&cntlr->ibiLock, &flags);
 
-    return HDF_SUCCESS;
+    /* the busy slot keeps FreeIbi waiting, so the info outlives the queued message */
+    return PlatformQueueAddMsg(cntlr->ibiQueue, &ibi->slots[index].msg);
 }
 
 static int32_t I3cManagerBind(struct HdfDeviceObject *device)
@@ -251,9 +251,68 @@ int32_t MipiDsiCntlrTx(struct MipiDsiCntlr *cntlr, struct DsiCmdDesc *cmd)
 
     (void)OsalMutexLock(&(cntlr->lock));
     ret = cntlr->ops->setCmd(cntlr, cmd);
-    if (cmd->delay > 0) {
+    (void)OsalMutexUnlock(&(cntlr->lock));
+
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed!", __func__);
+    } else if (cmd->delay > 0) {
         OsalMSleep(cmd->delay);
     }
+
+    return ret;
+}
+
+static int32_t MipiDsiCntlrTxEach(struct MipiDsiCntlr *cntlr, struct DsiCmdDesc *cmds, uint32_t count)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i = 0;
+
+    while (i < count) {
+        // commands without a delay go out back to back under one hold of the lock
+        (void)OsalMutexLock(&(cntlr->lock));
+        for (; i < count; i++) {
+            ret = cntlr->ops->setCmd(cntlr, &cmds[i]);
+            if ((ret != HDF_SUCCESS) || (cmds[i].delay > 0)) {
+                break;
+            }
+        }
+        (void)OsalMutexUnlock(&(cntlr->lock));
+
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: cmd %u failed!", __func__, i);
+            return ret;
+        }
+        if (i < count) {
+            OsalMSleep(cmds[i].delay);
+            i++;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t MipiDsiCntlrTxList(struct MipiDsiCntlr *cntlr, struct DsiCmdDesc *cmds, uint32_t count)
+{
+    int32_t ret;
+
+    if ((cntlr == NULL) || (cntlr->ops == NULL)) {
+        HDF_LOGE("%s: cntlr or ops is NULL.", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if ((cmds == NULL) || (count == 0)) {
+        HDF_LOGE("%s: cmds is NULL or count is 0.", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (cntlr->ops->setCmdList == NULL) {
+        if (cntlr->ops->setCmd == NULL) {
+            HDF_LOGE("%s: setCmd is NULL.", __func__);
+            return HDF_ERR_NOT_SUPPORT;
+        }
+        return MipiDsiCntlrTxEach(cntlr, cmds, count);
+    }
+
+    (void)OsalMutexLock(&(cntlr->lock));
+    ret = cntlr->ops->setCmdList(cntlr, cmds, count);
     (void)OsalMutexUnlock(&(cntlr->lock));
 
     if (ret != HDF_SUCCESS) {
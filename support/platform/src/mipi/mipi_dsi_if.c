@@ -46,6 +46,11 @@ int32_t MipiDsiTx(DevHandle handle, struct DsiCmdDesc *cmd)
     return MipiDsiCntlrTx((struct MipiDsiCntlr *)handle, cmd);
 }
 
+int32_t MipiDsiTxList(DevHandle handle, struct DsiCmdDesc *cmds, uint32_t count)
+{
+    return MipiDsiCntlrTxList((struct MipiDsiCntlr *)handle, cmds, count);
+}
+
 int32_t MipiDsiRx(DevHandle handle, struct DsiCmdDesc *cmd, int32_t readLen, uint8_t *out)
 {
     return MipiDsiCntlrRx((struct MipiDsiCntlr *)handle, cmd, readLen, out);
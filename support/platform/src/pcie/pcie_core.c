@@ -29,11 +29,25 @@ static int32_t PcieCntlrInit(struct PcieCntlr *cntlr)
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    ret = OsalMutexInit(&cntlr->mutex);
+    ret = PlatformArbiterInit(&cntlr->arbiter);
     if (ret != HDF_SUCCESS) {
-        HDF_LOGE("PcieCntlrInit: mutex init fail!");
+        HDF_LOGE("PcieCntlrInit: arbiter init fail!");
         return ret;
     }
+    ret = OsalSpinInit(&cntlr->dmaSpin);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("PcieCntlrInit: spin init fail!");
+        PlatformArbiterUninit(&cntlr->arbiter);
+        return ret;
+    }
+    ret = OsalSemInit(&cntlr->dmaSem, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("PcieCntlrInit: sem init fail!");
+        (void)OsalSpinDestroy(&cntlr->dmaSpin);
+        PlatformArbiterUninit(&cntlr->arbiter);
+        return ret;
+    }
+    cntlr->dmaXfer = NULL;
 
     cntlr->service.Dispatch = PcieIoDispatch;
     cntlr->hdfDevObj->service = &(cntlr->service);
@@ -44,8 +58,18 @@ static int32_t PcieCntlrInit(struct PcieCntlr *cntlr)
 
 static void PcieCntlrUninit(struct PcieCntlr *cntlr)
 {
+    uint32_t bar;
+
     if (cntlr != NULL) {
-        (void)OsalMutexDestroy(&cntlr->mutex);
+        for (bar = 0; bar < PCIE_BAR_NUM; bar++) {
+            if (cntlr->bars[bar].refCount > 0 && cntlr->ops != NULL && cntlr->ops->unmapBar != NULL) {
+                cntlr->ops->unmapBar(cntlr, bar, cntlr->bars[bar].addr);
+            }
+            cntlr->bars[bar].refCount = 0;
+        }
+        (void)OsalSemDestroy(&cntlr->dmaSem);
+        (void)OsalSpinDestroy(&cntlr->dmaSpin);
+        PlatformArbiterUninit(&cntlr->arbiter);
     }
 }
 
@@ -154,3 +178,155 @@ int32_t PcieCntlrWrite(struct PcieCntlr *cntlr, uint32_t pos, uint8_t *data, uin
     PcieCntlrUnlock(cntlr);
     return ret;
 }
+
+int32_t PcieCntlrMapBar(struct PcieCntlr *cntlr, uint32_t bar, volatile uint8_t **addr, uint32_t *size)
+{
+    int32_t ret = HDF_SUCCESS;
+    struct PcieBarMap *map = NULL;
+
+    if (cntlr == NULL || cntlr->ops == NULL || cntlr->ops->mapBar == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (bar >= PCIE_BAR_NUM || addr == NULL || size == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    map = &cntlr->bars[bar];
+    PcieCntlrLock(cntlr);
+    if (map->refCount == 0) {
+        ret = cntlr->ops->mapBar(cntlr, bar, &map->addr, &map->size);
+    }
+    if (ret == HDF_SUCCESS && map->addr == NULL) {
+        ret = HDF_ERR_IO;
+    }
+    if (ret == HDF_SUCCESS) {
+        map->refCount++;
+        *addr = map->addr;
+        *size = map->size;
+    }
+    PcieCntlrUnlock(cntlr);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("PcieCntlrMapBar: map bar%u fail, ret %d!", bar, ret);
+    }
+    return ret;
+}
+
+void PcieCntlrUnmapBar(struct PcieCntlr *cntlr, uint32_t bar)
+{
+    struct PcieBarMap *map = NULL;
+
+    if (cntlr == NULL || cntlr->ops == NULL || bar >= PCIE_BAR_NUM) {
+        return;
+    }
+
+    map = &cntlr->bars[bar];
+    PcieCntlrLock(cntlr);
+    if (map->refCount > 0 && --map->refCount == 0) {
+        if (cntlr->ops->unmapBar != NULL) {
+            cntlr->ops->unmapBar(cntlr, bar, map->addr);
+        }
+        map->addr = NULL;
+        map->size = 0;
+    }
+    PcieCntlrUnlock(cntlr);
+}
+
+static int32_t PcieCntlrDmaStart(struct PcieCntlr *cntlr, const struct PcieDmaXfer *xfer)
+{
+    int32_t ret;
+    uint32_t flags;
+
+    (void)OsalSpinLockIrqSave(&cntlr->dmaSpin, &flags);
+    if (cntlr->dmaXfer != NULL) {
+        (void)OsalSpinUnlockIrqRestore(&cntlr->dmaSpin, &flags);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    cntlr->dmaXfer = xfer;
+    (void)OsalSpinUnlockIrqRestore(&cntlr->dmaSpin, &flags);
+
+    ret = cntlr->ops->dmaTransfer(cntlr, xfer);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalSpinLockIrqSave(&cntlr->dmaSpin, &flags);
+        cntlr->dmaXfer = NULL;
+        (void)OsalSpinUnlockIrqRestore(&cntlr->dmaSpin, &flags);
+        HDF_LOGE("PcieCntlrDmaStart: start dma fail, ret %d!", ret);
+    }
+    return ret;
+}
+
+int32_t PcieCntlrDmaTransfer(struct PcieCntlr *cntlr, const struct PcieDmaXfer *xfer)
+{
+    int32_t ret;
+    uint32_t flags;
+
+    if (cntlr == NULL || cntlr->ops == NULL || cntlr->ops->dmaTransfer == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (xfer == NULL || xfer->buf == NULL || xfer->len == 0 || xfer->dir > PCIE_DMA_TO_DEVICE) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    ret = PcieCntlrDmaStart(cntlr, xfer);
+    if (ret != HDF_SUCCESS || xfer->cb != NULL) {
+        return ret;
+    }
+
+    ret = OsalSemWait(&cntlr->dmaSem, PCIE_DMA_TIMEOUT_MS);
+    if (ret == HDF_SUCCESS) {
+        return cntlr->dmaStatus;
+    }
+    if (cntlr->ops->dmaAbort == NULL) {
+        /* the engine may still write the buffer, it can't go back to the caller before the completion */
+        HDF_LOGW("PcieCntlrDmaTransfer: dma not done in %d ms, no abort, keep waiting!", PCIE_DMA_TIMEOUT_MS);
+        (void)OsalSemWait(&cntlr->dmaSem, HDF_WAIT_FOREVER);
+        return cntlr->dmaStatus;
+    }
+    cntlr->ops->dmaAbort(cntlr);
+
+    /* the caller owns xfer again once this returns, the engine busy until now is free for the next one */
+    (void)OsalSpinLockIrqSave(&cntlr->dmaSpin, &flags);
+    if (cntlr->dmaXfer == xfer) {
+        cntlr->dmaXfer = NULL;
+        (void)OsalSpinUnlockIrqRestore(&cntlr->dmaSpin, &flags);
+        HDF_LOGE("PcieCntlrDmaTransfer: wait dma fail, ret %d!", ret);
+        return ret;
+    }
+    (void)OsalSpinUnlockIrqRestore(&cntlr->dmaSpin, &flags);
+    /* completed before the abort took effect, its post is on the way */
+    (void)OsalSemWait(&cntlr->dmaSem, HDF_WAIT_FOREVER);
+    return cntlr->dmaStatus;
+}
+
+void PcieCntlrDmaDone(struct PcieCntlr *cntlr, int32_t status)
+{
+    uint32_t flags;
+    const struct PcieDmaXfer *xfer = NULL;
+
+    if (cntlr == NULL) {
+        return;
+    }
+
+    (void)OsalSpinLockIrqSave(&cntlr->dmaSpin, &flags);
+    xfer = cntlr->dmaXfer;
+    cntlr->dmaXfer = NULL;
+    (void)OsalSpinUnlockIrqRestore(&cntlr->dmaSpin, &flags);
+    if (xfer == NULL) {
+        HDF_LOGW("PcieCntlrDmaDone: no dma in flight!");
+        return;
+    }
+
+    if (xfer->cb != NULL) {
+        xfer->cb(xfer->priv, status);
+        return;
+    }
+    cntlr->dmaStatus = status;
+    (void)OsalSemPost(&cntlr->dmaSem);
+}
+
+int32_t PcieCntlrGetArbiterStat(struct PcieCntlr *cntlr, struct PlatformArbiterStat *stat)
+{
+    if (cntlr == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return PlatformArbiterGetStat(&cntlr->arbiter, stat);
+}
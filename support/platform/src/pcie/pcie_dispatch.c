@@ -14,9 +14,14 @@
 
 #define HDF_LOG_TAG pcie_dispatch_c
 
+/* a user dma goes through an sbuf in one round trip, staged in a kernel buffer on the read side */
+#define PCIE_DMA_USER_MAX_LEN (64 * 1024)
+
 enum PcieIoCmd {
     PCIE_CMD_READ,
     PCIE_CMD_WRITE,
+    PCIE_CMD_DMA_READ,
+    PCIE_CMD_DMA_WRITE,
     PCIE_CMD_BUTT,
 };
 
@@ -82,6 +87,57 @@ static int32_t PcieCmdWrite(struct PcieCntlr *cntlr, struct HdfSBuf *data, struc
     return PcieCntlrWrite(cntlr, pos, buf, size);
 }
 
+static int32_t PcieCmdDmaRead(struct PcieCntlr *cntlr, struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    struct PcieDmaXfer xfer = {0};
+    int32_t ret;
+
+    if (!HdfSbufReadUint64(data, &xfer.devAddr) || !HdfSbufReadUint32(data, &xfer.len)) {
+        HDF_LOGE("PcieCmdDmaRead: read dma cfg fail");
+        return HDF_ERR_IO;
+    }
+    if (xfer.len == 0 || xfer.len > PCIE_DMA_USER_MAX_LEN) {
+        HDF_LOGE("PcieCmdDmaRead: invalid len %u", xfer.len);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    xfer.buf = (uint8_t *)OsalMemCalloc(xfer.len);
+    if (xfer.buf == NULL) {
+        HDF_LOGE("PcieCmdDmaRead: OsalMemCalloc error");
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    xfer.dir = PCIE_DMA_FROM_DEVICE;
+    ret = PcieCntlrDmaTransfer(cntlr, &xfer);
+    if (ret == HDF_SUCCESS && !HdfSbufWriteBuffer(reply, xfer.buf, xfer.len)) {
+        HDF_LOGE("PcieCmdDmaRead: sbuf write buffer failed");
+        ret = HDF_ERR_IO;
+    }
+    OsalMemFree(xfer.buf);
+    return ret;
+}
+
+static int32_t PcieCmdDmaWrite(struct PcieCntlr *cntlr, struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    struct PcieDmaXfer xfer = {0};
+    uint32_t size;
+    (void)reply;
+
+    if (!HdfSbufReadUint64(data, &xfer.devAddr) || !HdfSbufReadUint32(data, &xfer.len)) {
+        HDF_LOGE("PcieCmdDmaWrite: read dma cfg fail");
+        return HDF_ERR_IO;
+    }
+    if (xfer.len == 0 || xfer.len > PCIE_DMA_USER_MAX_LEN) {
+        HDF_LOGE("PcieCmdDmaWrite: invalid len %u", xfer.len);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!HdfSbufReadBuffer(data, (const void **)&xfer.buf, &size) || size != xfer.len) {
+        HDF_LOGE("PcieCmdDmaWrite: sbuf read buffer failed");
+        return HDF_ERR_IO;
+    }
+    xfer.dir = PCIE_DMA_TO_DEVICE;
+    return PcieCntlrDmaTransfer(cntlr, &xfer);
+}
+
 int32_t PcieIoDispatch(struct HdfDeviceIoClient *client, int32_t cmd, struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     struct PcieCntlr *cntlr = NULL;
@@ -90,6 +146,8 @@ int32_t PcieIoDispatch(struct HdfDeviceIoClient *client, int32_t cmd, struct Hdf
     struct PcieDispatchFunc dispatchFunc[] = {
         { PCIE_CMD_READ, PcieCmdRead },
         { PCIE_CMD_WRITE, PcieCmdWrite },
+        { PCIE_CMD_DMA_READ, PcieCmdDmaRead },
+        { PCIE_CMD_DMA_WRITE, PcieCmdDmaWrite },
     };
 
     if (client == NULL || client->device == NULL) {
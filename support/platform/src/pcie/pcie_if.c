@@ -27,6 +27,8 @@
 enum PcieIoCmd {
     PCIE_CMD_READ,
     PCIE_CMD_WRITE,
+    PCIE_CMD_DMA_READ,
+    PCIE_CMD_DMA_WRITE,
     PCIE_CMD_BUTT,
 };
 
@@ -143,6 +145,68 @@ EXIT:
     HdfSbufRecycle(buf);
     return ret;
 }
+
+/* the whole transfer is one round trip, the dma runs in the kernel while the call waits */
+static int32_t PcieUserDmaTransfer(DevHandle handle, struct PcieDmaXfer *xfer)
+{
+    int32_t ret;
+    int32_t cmd;
+    struct HdfSBuf *reply = NULL;
+    struct HdfSBuf *buf = NULL;
+    struct HdfIoService *service = (struct HdfIoService *)handle;
+
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("PcieUserDmaTransfer: service is invalid");
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (xfer == NULL || xfer->buf == NULL || xfer->len == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (xfer->cb != NULL) {
+        HDF_LOGE("PcieUserDmaTransfer: async dma not support in user space");
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    buf = HdfSbufObtainDefaultSize();
+    if (buf == NULL) {
+        HDF_LOGE("PcieUserDmaTransfer: failed to obtain buf");
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    if (!HdfSbufWriteUint64(buf, xfer->devAddr) || !HdfSbufWriteUint32(buf, xfer->len)) {
+        HDF_LOGE("PcieUserDmaTransfer: sbuf write failed");
+        ret = HDF_ERR_IO;
+        goto EXIT;
+    }
+    if (xfer->dir == PCIE_DMA_TO_DEVICE) {
+        cmd = PCIE_CMD_DMA_WRITE;
+        if (!HdfSbufWriteBuffer(buf, xfer->buf, xfer->len)) {
+            HDF_LOGE("PcieUserDmaTransfer: sbuf write buffer failed");
+            ret = HDF_ERR_IO;
+            goto EXIT;
+        }
+    } else {
+        cmd = PCIE_CMD_DMA_READ;
+        reply = HdfSbufObtainDefaultSize();
+        if (reply == NULL) {
+            HDF_LOGE("PcieUserDmaTransfer: failed to obtain reply");
+            ret = HDF_ERR_MALLOC_FAIL;
+            goto EXIT;
+        }
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, cmd, buf, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("PcieUserDmaTransfer: failed to transfer, ret %d", ret);
+    } else if (reply != NULL) {
+        ret = PcieGetDataFromReply(reply, xfer->buf, xfer->len);
+    }
+EXIT:
+    if (reply != NULL) {
+        HdfSbufRecycle(reply);
+    }
+    HdfSbufRecycle(buf);
+    return ret;
+}
 #endif
 
 static void *PcieCntlrObjGet(uint16_t busNum)
@@ -193,6 +257,38 @@ int32_t PcieWrite(DevHandle handle, uint32_t pos, uint8_t *data, uint32_t len)
 #endif
 }
 
+int32_t PcieMapBar(DevHandle handle, uint32_t bar, volatile uint8_t **addr, uint32_t *size)
+{
+#ifdef __USER__
+    (void)handle;
+    (void)bar;
+    (void)addr;
+    (void)size;
+    return HDF_ERR_NOT_SUPPORT;
+#else
+    return PcieCntlrMapBar((struct PcieCntlr *)handle, bar, addr, size);
+#endif
+}
+
+void PcieUnmapBar(DevHandle handle, uint32_t bar)
+{
+#ifdef __USER__
+    (void)handle;
+    (void)bar;
+#else
+    PcieCntlrUnmapBar((struct PcieCntlr *)handle, bar);
+#endif
+}
+
+int32_t PcieDmaTransfer(DevHandle handle, struct PcieDmaXfer *xfer)
+{
+#ifdef __USER__
+    return PcieUserDmaTransfer(handle, xfer);
+#else
+    return PcieCntlrDmaTransfer((struct PcieCntlr *)handle, xfer);
+#endif
+}
+
 void PcieClose(DevHandle handle)
 {
     if (handle != NULL) {
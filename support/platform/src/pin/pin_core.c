@@ -8,22 +8,33 @@
 
 #include "pin_core.h"
 #include "hdf_log.h"
+#include "platform_core.h"
 
 #define HDF_LOG_TAG pin_core
 
-#define MAX_CNT_PER_CNTLR    20
+#define PIN_HASH_BUCKETS     256
 
 static struct DListHead g_cntlrListHead;
+static struct DListHead g_pinHash[PIN_HASH_BUCKETS];   /* pins of all controllers, keyed by name */
 static OsalSpinlock g_listLock;
 static uint32_t g_irqSave;
 
+static inline uint32_t PinNameHash(const char *name)
+{
+    return PlatformNameHash(name) % PIN_HASH_BUCKETS;
+}
+
 static struct DListHead *PinCntlrListGet(void)
 {
     static struct DListHead *head = NULL;
     uint32_t irqSave;
+    uint32_t i;
     if (head == NULL) {
         head = &g_cntlrListHead;
         DListHeadInit(head);
+        for (i = 0; i < PIN_HASH_BUCKETS; i++) {
+            DListHeadInit(&g_pinHash[i]);
+        }
         OsalSpinInit(&g_listLock);
     }
     while (OsalSpinLockIrqSave(&g_listLock, &irqSave) != HDF_SUCCESS);
@@ -39,6 +50,7 @@ static void PinCntlrListPut(void)
 int32_t PinCntlrAdd(struct PinCntlr *cntlr)
 {
     struct DListHead *head = NULL;
+    uint16_t num;
 
     if (cntlr == NULL) {
         HDF_LOGE("%s: invalid object cntlr is NULL!", __func__);
@@ -51,7 +63,7 @@ int32_t PinCntlrAdd(struct PinCntlr *cntlr)
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    if (cntlr->pinCount >= MAX_CNT_PER_CNTLR) {
+    if (cntlr->pinCount == 0 || cntlr->pins == NULL) {
         HDF_LOGE("%s: invalid pinCount:%u", __func__, cntlr->pinCount);
         return HDF_ERR_INVALID_PARAM;
     }
@@ -60,6 +72,14 @@ int32_t PinCntlrAdd(struct PinCntlr *cntlr)
 
     head = PinCntlrListGet();
     DListInsertTail(&cntlr->node, head);
+    for (num = 0; num < cntlr->pinCount; num++) {
+        cntlr->pins[num].cntlr = cntlr;
+        DListHeadInit(&cntlr->pins[num].hashNode);
+        if (cntlr->pins[num].pinName != NULL) {
+            // tail insertion keeps the first registered pin of a name the one found
+            DListInsertTail(&cntlr->pins[num].hashNode, &g_pinHash[PinNameHash(cntlr->pins[num].pinName)]);
+        }
+    }
     PinCntlrListPut();
     return HDF_SUCCESS;
 }
@@ -71,36 +91,32 @@ void PinCntlrRemove(struct PinCntlr *cntlr)
         return;
     }
 
+    uint16_t num;
+
     (void)PinCntlrListGet();
     DListRemove(&cntlr->node);
+    for (num = 0; num < cntlr->pinCount; num++) {
+        DListRemove(&cntlr->pins[num].hashNode);
+        cntlr->pins[num].cntlr = NULL;
+    }
     PinCntlrListPut();
     (void)OsalSpinDestroy(&cntlr->spin);
 }
 
 struct PinDesc *PinCntlrGetPinDescByName(const char *pinName)
 {
-    struct DListHead *head = NULL;
-    struct PinCntlr *cntlr = NULL;
-    struct PinCntlr *tmp = NULL;
-    uint16_t num;
+    struct PinDesc *desc = NULL;
 
     if (pinName == NULL) {
         HDF_LOGE("%s: pinName is NULL!", __func__);
         return NULL;
     }
 
-    head = PinCntlrListGet();
-
-    DLIST_FOR_EACH_ENTRY_SAFE(cntlr, tmp, head, struct PinCntlr, node) {
-        for (num = 0; num < cntlr->pinCount; num++) {
-            if (cntlr->pins[num].pinName == NULL) {
-                continue;
-            }
-            if (!strcmp(cntlr->pins[num].pinName, pinName)) {
-                PinCntlrListPut();
-                HDF_LOGI("%s: cntlr->pins[%d].pinName is %s!", __func__, num, cntlr->pins[num].pinName);
-                return &cntlr->pins[num];
-            }
+    (void)PinCntlrListGet();
+    DLIST_FOR_EACH_ENTRY(desc, &g_pinHash[PinNameHash(pinName)], struct PinDesc, hashNode) {
+        if (strcmp(desc->pinName, pinName) == 0) {
+            PinCntlrListPut();
+            return desc;
         }
     }
     PinCntlrListPut();
@@ -119,7 +135,6 @@ struct PinCntlr *PinCntlrGetByNumber(uint16_t number)
     DLIST_FOR_EACH_ENTRY_SAFE(cntlr, tmp, head, struct PinCntlr, node) {
         if (cntlr->number == number) {
             PinCntlrListPut();
-            HDF_LOGI("%s: get cntlr by number success!", __func__);
             return cntlr;
         }
     }
@@ -130,45 +145,28 @@ struct PinCntlr *PinCntlrGetByNumber(uint16_t number)
 
 struct PinCntlr *PinCntlrGetByPin(struct PinDesc *desc)
 {
-    struct DListHead *head = NULL;
     struct PinCntlr *cntlr = NULL;
-    struct PinCntlr *tmp = NULL;
-    int32_t num;
 
-    head = PinCntlrListGet();
+    if (desc == NULL) {
+        HDF_LOGE("%s: desc is NULL!", __func__);
+        return NULL;
+    }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(cntlr, tmp, head, struct PinCntlr, node) {
-        for (num = 0; num <cntlr->pinCount; num++) {
-            if (desc == &cntlr->pins[num]) {
-            PinCntlrListPut();
-            HDF_LOGI("%s: get cntlr by desc success!", __func__);
-            return cntlr;
-            }
-        }
+    cntlr = desc->cntlr;
+    if (cntlr == NULL || desc < cntlr->pins || desc >= cntlr->pins + cntlr->pinCount) {
+        HDF_LOGE("%s: pinCtrl:%s not in any controllers!", __func__, desc->pinName);
+        return NULL;
     }
-    PinCntlrListPut();
-    HDF_LOGE("%s: pinCtrl:%s not in any controllers!", __func__, desc->pinName);
-    return NULL;
+    return cntlr;
 }
 
 static int32_t GetPinIndex(struct PinCntlr *cntlr, struct PinDesc *desc)
 {
-    uint16_t index;
-    int32_t ret;
-
-    for (index = 0; index < cntlr->pinCount; index++) {
-        if (cntlr->pins[index].pinName == NULL) {
-            HDF_LOGE("%s: cntlr->pin[index].pinName is NULL!", __func__);
-            break;
-        }
-        ret = strcmp(cntlr->pins[index].pinName, desc->pinName);
-        if (ret == 0) {
-            HDF_LOGI("%s: get pin index:%d success!", __func__, index);
-            return (int32_t)index;
-        }
+    if (desc < cntlr->pins || desc >= cntlr->pins + cntlr->pinCount) {
+        HDF_LOGE("%s:  get pin index failed!", __func__);
+        return HDF_ERR_INVALID_PARAM;
     }
-    HDF_LOGE("%s:  get pin index failed!", __func__);
-    return HDF_ERR_INVALID_PARAM;
+    return (int32_t)(desc - cntlr->pins);
 }
 
 void PinCntlrPutPin(struct PinDesc *desc)
@@ -197,11 +195,12 @@ int32_t PinCntlrSetPinPull(struct PinCntlr *cntlr, struct PinDesc *desc, enum Pi
         return HDF_ERR_INVALID_PARAM;
     }
 
-    index = (uint32_t)GetPinIndex(cntlr, desc);
-    if (index < HDF_SUCCESS) {
+    ret = GetPinIndex(cntlr, desc);
+    if (ret < 0) {
         HDF_LOGE("%s: get pin index fail!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    index = (uint32_t)ret;
 
     (void)OsalSpinLockIrqSave(&cntlr->spin, &irqSave);
     ret = cntlr->method->SetPinPull(cntlr, index, pullType);
@@ -234,11 +233,12 @@ int32_t PinCntlrGetPinPull(struct PinCntlr *cntlr, struct PinDesc *desc, enum Pi
         return HDF_ERR_INVALID_PARAM;
     }
 
-    index = (uint32_t)GetPinIndex(cntlr, desc);
-    if (index < HDF_SUCCESS) {
+    ret = GetPinIndex(cntlr, desc);
+    if (ret < 0) {
         HDF_LOGE("%s: get pin index failed!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    index = (uint32_t)ret;
 
     (void)OsalSpinLockIrqSave(&cntlr->spin, &irqSave);
     ret = cntlr->method->GetPinPull(cntlr, index, pullType);
@@ -268,11 +268,12 @@ int32_t PinCntlrSetPinStrength(struct PinCntlr *cntlr, struct PinDesc *desc, uin
         return HDF_ERR_INVALID_PARAM;
     }
 
-    index = (uint32_t)GetPinIndex(cntlr, desc);
-    if (index < HDF_SUCCESS) {
+    ret = GetPinIndex(cntlr, desc);
+    if (ret < 0) {
         HDF_LOGE("%s: get pin index fail!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    index = (uint32_t)ret;
 
     (void)OsalSpinLockIrqSave(&cntlr->spin, &irqSave);
     ret = cntlr->method->SetPinStrength(cntlr, index, strength);
@@ -305,11 +306,12 @@ int32_t PinCntlrGetPinStrength(struct PinCntlr *cntlr, struct PinDesc *desc, uin
         return HDF_ERR_INVALID_PARAM;
     }
 
-    index = (uint32_t)GetPinIndex(cntlr, desc);
-    if (index < HDF_SUCCESS) {
+    ret = GetPinIndex(cntlr, desc);
+    if (ret < 0) {
         HDF_LOGE("%s: get pin index failed!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    index = (uint32_t)ret;
 
     (void)OsalSpinLockIrqSave(&cntlr->spin, &irqSave);
     ret = cntlr->method->GetPinStrength(cntlr, index, strength);
@@ -339,11 +341,12 @@ int32_t PinCntlrSetPinFunc(struct PinCntlr *cntlr, struct PinDesc *desc, const c
         return HDF_ERR_INVALID_PARAM;
     }
 
-    index = (uint32_t)GetPinIndex(cntlr, desc);
-    if (index < HDF_SUCCESS) {
+    ret = GetPinIndex(cntlr, desc);
+    if (ret < 0) {
         HDF_LOGE("%s: get pin index failed!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    index = (uint32_t)ret;
 
     if (funcName == NULL) {
         HDF_LOGE("%s: invalid funcName pointer", __func__);
@@ -377,14 +380,94 @@ int32_t PinCntlrGetPinFunc(struct PinCntlr *cntlr, struct PinDesc *desc, const c
         return HDF_ERR_INVALID_PARAM;
     }
 
-    index = (uint32_t)GetPinIndex(cntlr, desc);
-    if (index < HDF_SUCCESS) {
+    ret = GetPinIndex(cntlr, desc);
+    if (ret < 0) {
         HDF_LOGE("%s: get pin index failed!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    index = (uint32_t)ret;
 
     (void)OsalSpinLockIrqSave(&cntlr->spin, &irqSave);
     ret = cntlr->method->GetPinFunc(cntlr, index, funcName);
     (void)OsalSpinUnlockIrqRestore(&cntlr->spin, &irqSave);
     return ret;
 }
+
+// caller holds cntlr->spin, the methods needed by cfg are checked
+static int32_t PinCntlrApplyCfg(struct PinCntlr *cntlr, uint32_t index, const struct PinCfg *cfg)
+{
+    int32_t ret = HDF_SUCCESS;
+
+    if ((cfg->mask & PIN_CFG_FUNC) != 0) {
+        ret = cntlr->method->SetPinFunc(cntlr, index, cfg->funcName);
+    }
+    if ((ret == HDF_SUCCESS) && ((cfg->mask & PIN_CFG_PULL) != 0)) {
+        ret = cntlr->method->SetPinPull(cntlr, index, cfg->pullType);
+    }
+    if ((ret == HDF_SUCCESS) && ((cfg->mask & PIN_CFG_STRENGTH) != 0)) {
+        ret = cntlr->method->SetPinStrength(cntlr, index, cfg->strength);
+    }
+    return ret;
+}
+
+static int32_t PinCntlrCheckCfg(struct PinCntlr *cntlr, const struct PinCfg *cfg)
+{
+    if (cntlr == NULL || cntlr->method == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (((cfg->mask & PIN_CFG_FUNC) != 0) && (cntlr->method->SetPinFunc == NULL || cfg->funcName == NULL)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (((cfg->mask & PIN_CFG_PULL) != 0) && (cntlr->method->SetPinPull == NULL)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    if (((cfg->mask & PIN_CFG_STRENGTH) != 0) && (cntlr->method->SetPinStrength == NULL)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t PinCntlrSetPinCfgBatch(const struct PinCfg *cfgs, uint32_t count)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i;
+    uint32_t end;
+    uint32_t irqSave;
+    struct PinCntlr *cntlr = NULL;
+    struct PinDesc *desc = NULL;
+
+    if (cfgs == NULL || count == 0) {
+        HDF_LOGE("%s: cfgs is NULL or count is 0", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    for (i = 0; i < count; i = end) {
+        // validate the run of pins sharing a controller before taking its lock
+        cntlr = PinCntlrGetByPin((struct PinDesc *)cfgs[i].handle);
+        for (end = i; end < count; end++) {
+            if ((end > i) && (cfgs[end].handle == NULL || ((struct PinDesc *)cfgs[end].handle)->cntlr != cntlr)) {
+                break;
+            }
+            ret = PinCntlrCheckCfg(cntlr, &cfgs[end]);
+            if (ret != HDF_SUCCESS) {
+                HDF_LOGE("%s: cfg %u invalid:%d", __func__, end, ret);
+                return ret;
+            }
+        }
+
+        (void)OsalSpinLockIrqSave(&cntlr->spin, &irqSave);
+        for (; i < end; i++) {
+            desc = (struct PinDesc *)cfgs[i].handle;
+            ret = PinCntlrApplyCfg(cntlr, (uint32_t)(desc - cntlr->pins), &cfgs[i]);
+            if (ret != HDF_SUCCESS) {
+                break;
+            }
+        }
+        (void)OsalSpinUnlockIrqRestore(&cntlr->spin, &irqSave);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: apply cfg %u failed:%d", __func__, i, ret);
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
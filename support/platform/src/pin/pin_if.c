@@ -102,4 +102,9 @@ int32_t PinGetFunc(DevHandle handle, const char **funcName)
 
     cntlr = PinCntlrGetByPin((struct PinDesc *)handle);
     return PinCntlrGetPinFunc(cntlr, (struct PinDesc *)handle, funcName);
-}
\ No newline at end of file
+}
+
+int32_t PinSetCfgBatch(const struct PinCfg *cfgs, uint32_t count)
+{
+    return PinCntlrSetPinCfgBatch(cfgs, count);
+}
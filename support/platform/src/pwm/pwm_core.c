@@ -8,9 +8,21 @@
 
 #include "pwm_core.h"
 #include "hdf_log.h"
+#include "osal_mem.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG pwm_core
+#define PWM_NAME_LEN 32
+
+/*
+ * The state of one user space client of a device node, guarded by the lock of that device.
+ * The client that opened the device is its owner, and only the owner may let the opener of
+ * another device put this one into the groups of that open.
+ */
+struct PwmUserClient {
+    struct PwmDev *groupPwm;    /* the device whose opener may carry groups with this one, NULL if none */
+    uint32_t groupSeq;          /* the open of groupPwm that was joined */
+};
 
 int32_t PwmDeviceGet(struct PwmDev *pwm)
 {
@@ -59,6 +71,7 @@ int32_t PwmDevicePut(struct PwmDev *pwm)
     }
     (void)OsalSpinLock(&(pwm->lock));
     pwm->busy = false;
+    pwm->owner = NULL;
     (void)OsalSpinUnlock(&(pwm->lock));
     return HDF_SUCCESS;
 }
@@ -107,6 +120,110 @@ int32_t PwmDeviceGetConfig(struct PwmDev *pwm, struct PwmConfig *config)
     return HDF_SUCCESS;
 }
 
+static int32_t PwmGroupCheck(struct PwmDev **pwms, struct PwmConfig *configs, uint32_t count)
+{
+    uint32_t i;
+    uint32_t j;
+
+    if (pwms == NULL || configs == NULL || count == 0 || count > PWM_GROUP_MAX) {
+        HDF_LOGE("%s: invalid group, count:%u", __func__, count);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    for (i = 0; i < count; i++) {
+        if (pwms[i] == NULL || pwms[i]->method == NULL || pwms[i]->method->setConfig == NULL) {
+            HDF_LOGE("%s: pwm of item %u is invalid", __func__, i);
+            return HDF_ERR_INVALID_OBJECT;
+        }
+        for (j = 0; j < i; j++) {
+            if (pwms[j] == pwms[i]) {
+                HDF_LOGE("%s: pwm%u appears twice", __func__, pwms[i]->num);
+                return HDF_ERR_INVALID_PARAM;
+            }
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static bool PwmGroupSameMethod(struct PwmDev **pwms, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 1; i < count; i++) {
+        if (pwms[i]->method != pwms[0]->method) {
+            return false;
+        }
+    }
+    return pwms[0]->method->setConfigGroup != NULL;
+}
+
+// applies the channels back to back and puts the changed ones back if one fails
+static int32_t PwmGroupSetEach(struct PwmDev **pwms, struct PwmConfig *configs, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        ret = pwms[i]->method->setConfig(pwms[i], &configs[i]);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: pwm%u failed, ret %d", __func__, pwms[i]->num, ret);
+            break;
+        }
+    }
+    if (i == count) {
+        return HDF_SUCCESS;
+    }
+    while (i > 0) {
+        i--;
+        if (pwms[i]->method->setConfig(pwms[i], &pwms[i]->cfg) != HDF_SUCCESS) {
+            HDF_LOGE("%s: restore pwm%u failed", __func__, pwms[i]->num);
+        }
+    }
+    return ret;
+}
+
+int32_t PwmDeviceSetConfigGroup(struct PwmDev **pwms, struct PwmConfig *configs, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t changed = 0;
+    struct PwmDev *pwmChanged[PWM_GROUP_MAX];
+    struct PwmConfig cfgChanged[PWM_GROUP_MAX];
+
+    ret = PwmGroupCheck(pwms, configs, count);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    for (i = 0; i < count; i++) {
+        if (memcmp(&configs[i], &(pwms[i]->cfg), sizeof(configs[i])) != 0) {
+            pwmChanged[changed] = pwms[i];
+            cfgChanged[changed] = configs[i];
+            changed++;
+        }
+    }
+    if (changed == 0) {
+        return HDF_SUCCESS;
+    }
+
+    ret = HDF_ERR_NOT_SUPPORT;
+    if (PwmGroupSameMethod(pwmChanged, changed)) {
+        ret = pwmChanged[0]->method->setConfigGroup(pwmChanged, cfgChanged, changed);
+    }
+    if (ret == HDF_ERR_NOT_SUPPORT) {
+        ret = PwmGroupSetEach(pwmChanged, cfgChanged, changed);
+    }
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed, ret %d", __func__, ret);
+        return ret;
+    }
+
+    for (i = 0; i < changed; i++) {
+        (void)OsalSpinLock(&(pwmChanged[i]->lock));
+        pwmChanged[i]->cfg = cfgChanged[i];
+        (void)OsalSpinUnlock(&(pwmChanged[i]->lock));
+    }
+    return HDF_SUCCESS;
+}
+
 int32_t PwmSetPriv(struct PwmDev *pwm, void *priv)
 {
     if (pwm == NULL) {
@@ -129,6 +246,60 @@ void *PwmGetPriv(struct PwmDev *pwm)
     return pwm->priv;
 }
 
+static int32_t PwmUserGet(struct PwmDev *pwm, struct PwmUserClient *client)
+{
+    int32_t ret;
+
+    if (client == NULL) {
+        HDF_LOGE("%s: client is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    ret = PwmDeviceGet(pwm);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    (void)OsalSpinLock(&(pwm->lock));
+    pwm->owner = client;
+    pwm->openSeq++;
+    client->groupPwm = NULL;
+    (void)OsalSpinUnlock(&(pwm->lock));
+    return HDF_SUCCESS;
+}
+
+static bool PwmUserOwns(struct PwmDev *pwm, const struct PwmUserClient *client)
+{
+    bool owns = false;
+
+    (void)OsalSpinLock(&(pwm->lock));
+    owns = pwm->busy && client != NULL && pwm->owner == client;
+    (void)OsalSpinUnlock(&(pwm->lock));
+    return owns;
+}
+
+static int32_t PwmUserPut(struct PwmDev *pwm, struct PwmUserClient *client)
+{
+    if (!PwmUserOwns(pwm, client)) {
+        HDF_LOGE("%s: pwm%u is not opened by the caller", __func__, pwm->num);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return PwmDevicePut(pwm);
+}
+
+// a member joined to the current open of the carrier, or the carrier itself
+static bool PwmUserGroupMember(struct PwmDev *pwm, struct PwmDev *carrier, uint32_t carrierSeq)
+{
+    bool joined = false;
+
+    if (pwm == carrier) {
+        return true;
+    }
+    (void)OsalSpinLock(&(pwm->lock));
+    joined = pwm->busy && pwm->owner != NULL && pwm->owner->groupPwm == carrier &&
+        pwm->owner->groupSeq == carrierSeq;
+    (void)OsalSpinUnlock(&(pwm->lock));
+    return joined;
+}
+
 static int32_t PwmUserSetConfig(struct PwmDev *pwm, struct HdfSBuf *data)
 {
     size_t size;
@@ -172,10 +343,103 @@ static int32_t PwmUserGetConfig(struct PwmDev *pwm, struct HdfSBuf *reply)
     return HDF_SUCCESS;
 }
 
+static struct PwmDev *PwmDeviceFind(uint32_t num)
+{
+    char name[PWM_NAME_LEN + 1] = {0};
+
+    if (snprintf_s(name, PWM_NAME_LEN + 1, PWM_NAME_LEN, "HDF_PLATFORM_PWM_%u", num) < 0) {
+        HDF_LOGE("%s: snprintf_s failed", __func__);
+        return NULL;
+    }
+    return (struct PwmDev *)DevSvcManagerClntGetService(name);
+}
+
+// the owner of pwm lets the current opener of the carrier put pwm into its groups
+static int32_t PwmUserJoinGroup(struct PwmDev *pwm, struct PwmUserClient *client, struct HdfSBuf *data)
+{
+    uint32_t num;
+    uint32_t carrierSeq;
+    struct PwmDev *carrier = NULL;
+
+    if (data == NULL || !HdfSbufReadUint32(data, &num)) {
+        HDF_LOGE("%s: read carrier failed", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!PwmUserOwns(pwm, client)) {
+        HDF_LOGE("%s: pwm%u is not opened by the caller", __func__, pwm->num);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    carrier = PwmDeviceFind(num);
+    if (carrier == NULL) {
+        HDF_LOGE("%s: pwm%u not found", __func__, num);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    (void)OsalSpinLock(&(carrier->lock));
+    if (carrier->owner == NULL) {
+        (void)OsalSpinUnlock(&(carrier->lock));
+        HDF_LOGE("%s: pwm%u is not opened in user space", __func__, num);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    carrierSeq = carrier->openSeq;
+    (void)OsalSpinUnlock(&(carrier->lock));
+
+    (void)OsalSpinLock(&(pwm->lock));
+    client->groupPwm = carrier;
+    client->groupSeq = carrierSeq;
+    (void)OsalSpinUnlock(&(pwm->lock));
+    return HDF_SUCCESS;
+}
+
+static int32_t PwmUserSetConfigGroup(struct PwmDev *carrier, struct PwmUserClient *client, struct HdfSBuf *data)
+{
+    uint32_t size;
+    uint32_t i;
+    uint32_t num;
+    uint32_t count;
+    uint32_t carrierSeq;
+    struct PwmConfig *config = NULL;
+    struct PwmDev *pwms[PWM_GROUP_MAX];
+    struct PwmConfig configs[PWM_GROUP_MAX];
+
+    if (data == NULL || !HdfSbufReadUint32(data, &count) || count == 0 || count > PWM_GROUP_MAX) {
+        HDF_LOGE("%s: read count failed", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!PwmUserOwns(carrier, client)) {
+        HDF_LOGE("%s: pwm%u is not opened by the caller", __func__, carrier->num);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    (void)OsalSpinLock(&(carrier->lock));
+    carrierSeq = carrier->openSeq;
+    (void)OsalSpinUnlock(&(carrier->lock));
+
+    for (i = 0; i < count; i++) {
+        if (!HdfSbufReadUint32(data, &num) ||
+            !HdfSbufReadBuffer(data, (const void **)&config, &size) ||
+            config == NULL || size != sizeof(struct PwmConfig)) {
+            HDF_LOGE("%s: read item %u failed", __func__, i);
+            return HDF_ERR_IO;
+        }
+        pwms[i] = PwmDeviceFind(num);
+        if (pwms[i] == NULL) {
+            HDF_LOGE("%s: pwm%u not found", __func__, num);
+            return HDF_ERR_INVALID_OBJECT;
+        }
+        // the other devices must have been joined to this open by their own openers
+        if (!PwmUserGroupMember(pwms[i], carrier, carrierSeq)) {
+            HDF_LOGE("%s: pwm%u is not joined to the group of pwm%u", __func__, num, carrier->num);
+            return HDF_ERR_INVALID_OBJECT;
+        }
+        configs[i] = *config;
+    }
+    return PwmDeviceSetConfigGroup(pwms, configs, count);
+}
+
 static int32_t PwmIoDispatch(struct HdfDeviceIoClient *client, int cmd,
     struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     struct PwmDev *pwm = NULL;
+    struct PwmUserClient *userClient = NULL;
 
     if (client == NULL || client->device == NULL || client->device->service == NULL) {
         HDF_LOGE("%s: client info is NULL", __func__);
@@ -183,21 +447,65 @@ static int32_t PwmIoDispatch(struct HdfDeviceIoClient *client, int cmd,
     }
 
     pwm = (struct PwmDev *)client->device->service;
+    userClient = (struct PwmUserClient *)client->priv;
     switch (cmd) {
         case PWM_IO_GET:
-            return PwmDeviceGet(pwm);
+            return PwmUserGet(pwm, userClient);
         case PWM_IO_PUT:
-            return PwmDevicePut(pwm);
+            return PwmUserPut(pwm, userClient);
         case PWM_IO_SET_CONFIG:
             return PwmUserSetConfig(pwm, data);
         case PWM_IO_GET_CONFIG:
             return PwmUserGetConfig(pwm, reply);
+        case PWM_IO_SET_CONFIG_GROUP:
+            return PwmUserSetConfigGroup(pwm, userClient, data);
+        case PWM_IO_JOIN_GROUP:
+            return PwmUserJoinGroup(pwm, userClient, data);
         default:
             HDF_LOGE("%s: cmd %d not support", __func__, cmd);
             return HDF_ERR_NOT_SUPPORT;
     }
 }
 
+static int32_t PwmIoOpen(struct HdfDeviceIoClient *client)
+{
+    struct PwmUserClient *userClient = NULL;
+
+    if (client == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    userClient = (struct PwmUserClient *)OsalMemCalloc(sizeof(*userClient));
+    if (userClient == NULL) {
+        HDF_LOGE("%s: alloc client fail", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    client->priv = userClient;
+    return HDF_SUCCESS;
+}
+
+// a client that goes away without closing its device closes it here
+static void PwmIoRelease(struct HdfDeviceIoClient *client)
+{
+    struct PwmDev *pwm = NULL;
+    struct PwmUserClient *userClient = NULL;
+
+    if (client == NULL || client->priv == NULL) {
+        return;
+    }
+    userClient = (struct PwmUserClient *)client->priv;
+    client->priv = NULL;
+    if (client->device != NULL && client->device->service != NULL) {
+        pwm = (struct PwmDev *)client->device->service;
+        if (PwmUserOwns(pwm, userClient) && PwmDevicePut(pwm) != HDF_SUCCESS) {
+            HDF_LOGE("%s: put pwm%u fail", __func__, pwm->num);
+            (void)OsalSpinLock(&(pwm->lock));
+            pwm->owner = NULL;
+            (void)OsalSpinUnlock(&(pwm->lock));
+        }
+    }
+    OsalMemFree(userClient);
+}
+
 int32_t PwmDeviceAdd(struct HdfDeviceObject *obj, struct PwmDev *pwm)
 {
     if (obj == NULL || pwm == NULL) {
@@ -215,6 +523,8 @@ int32_t PwmDeviceAdd(struct HdfDeviceObject *obj, struct PwmDev *pwm)
     pwm->device = obj;
     obj->service = &(pwm->service);
     pwm->device->service->Dispatch = PwmIoDispatch;
+    pwm->device->service->Open = PwmIoOpen;
+    pwm->device->service->Release = PwmIoRelease;
     return HDF_SUCCESS;
 }
 
@@ -204,3 +204,30 @@ int32_t PwmGetConfig(DevHandle handle, struct PwmConfig *config)
 
     return HDF_SUCCESS;
 }
+
+int32_t PwmSetConfigGroup(const struct PwmGroupItem *items, uint32_t count)
+{
+    uint32_t i;
+    int32_t ret;
+    struct PwmDev *pwms[PWM_GROUP_MAX];
+    struct PwmConfig configs[PWM_GROUP_MAX];
+
+    if (items == NULL || count == 0 || count > PWM_GROUP_MAX) {
+        HDF_LOGE("%s: invalid items, count:%u", __func__, count);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    for (i = 0; i < count; i++) {
+        if (items[i].handle == NULL) {
+            HDF_LOGE("%s: handle of item %u is NULL", __func__, i);
+            return HDF_ERR_INVALID_OBJECT;
+        }
+        pwms[i] = (struct PwmDev *)items[i].handle;
+        configs[i] = items[i].config;
+    }
+
+    ret = PwmDeviceSetConfigGroup(pwms, configs, count);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: PwmDeviceSetConfigGroup failed, ret: %d", __func__, ret);
+    }
+    return ret;
+}
@@ -10,16 +10,23 @@
 #include "hdf_log.h"
 #include "hdf_io_service_if.h"
 #include "osal_mem.h"
+#include "platform_user_sbuf.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG pwm_if_u_c
 #define PWM_NAME_LEN 32
 
-static void *PwmGetDevByNum(uint32_t num)
+// a user handle keeps the device number next to the service so a group can name its devices
+struct PwmUserHandle {
+    struct HdfIoService *service;
+    uint32_t num;
+};
+
+static struct HdfIoService *PwmGetDevByNum(uint32_t num)
 {
     int32_t ret;
     char name[PWM_NAME_LEN + 1] = {0};
-    void *pwm = NULL;
+    struct HdfIoService *pwm = NULL;
 
     ret = snprintf_s(name, PWM_NAME_LEN + 1, PWM_NAME_LEN, "HDF_PLATFORM_PWM_%u", num);
     if (ret < 0) {
@@ -27,7 +34,7 @@ static void *PwmGetDevByNum(uint32_t num)
         return NULL;
     }
 
-    pwm = (void *)HdfIoServiceBind(name);
+    pwm = HdfIoServiceBind(name);
     if (pwm == NULL) {
         HDF_LOGE("%s: HdfIoServiceBind failed", __func__);
         return NULL;
@@ -36,40 +43,56 @@ static void *PwmGetDevByNum(uint32_t num)
     return pwm;
 }
 
-static void PwmPutObjByPointer(const void *obj)
+static struct HdfIoService *PwmUserGetService(DevHandle handle)
 {
-    if (obj == NULL) {
-        return;
-    }
+    struct HdfIoService *service = NULL;
 
-    HdfIoServiceRecycle((struct HdfIoService *)obj);
+    if (handle == NULL) {
+        return NULL;
+    }
+    service = ((struct PwmUserHandle *)handle)->service;
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: service is invalid", __func__);
+        return NULL;
+    }
+    return service;
 }
 
 DevHandle PwmOpen(uint32_t num)
 {
     int32_t ret;
-    void *pwm = PwmGetDevByNum(num);
+    struct PwmUserHandle *handle = NULL;
+    struct HdfIoService *service = PwmGetDevByNum(num);
 
-    if (pwm == NULL) {
+    if (service == NULL) {
         HDF_LOGE("%s: dev is null", __func__);
         return NULL;
     }
 
-    struct HdfIoService *service = (struct HdfIoService *)pwm;
     if (service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: service is invalid", __func__);
-        PwmPutObjByPointer(pwm);
+        HdfIoServiceRecycle(service);
+        return NULL;
+    }
+
+    handle = (struct PwmUserHandle *)OsalMemCalloc(sizeof(*handle));
+    if (handle == NULL) {
+        HDF_LOGE("%s: malloc handle failed", __func__);
+        HdfIoServiceRecycle(service);
         return NULL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, PWM_IO_GET, NULL, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: PwmDeviceGet error, ret %d", __func__, ret);
-        PwmPutObjByPointer(pwm);
+        OsalMemFree(handle);
+        HdfIoServiceRecycle(service);
         return NULL;
     }
 
-    return (DevHandle)pwm;
+    handle->service = service;
+    handle->num = num;
+    return (DevHandle)handle;
 }
 
 void PwmClose(DevHandle handle)
@@ -82,25 +105,23 @@ void PwmClose(DevHandle handle)
         return;
     }
 
-    service = (struct HdfIoService *)handle;
-    if (service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
-        HDF_LOGE("%s: service is invalid", __func__);
-        PwmPutObjByPointer(handle);
-        return;
-    }
-
-    ret = service->dispatcher->Dispatch(&service->object, PWM_IO_PUT, NULL, NULL);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s: PwmDevicePut error, ret %d", __func__, ret);
+    service = PwmUserGetService(handle);
+    if (service != NULL) {
+        ret = service->dispatcher->Dispatch(&service->object, PWM_IO_PUT, NULL, NULL);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: PwmDevicePut error, ret %d", __func__, ret);
+        }
     }
 
-    PwmPutObjByPointer(handle);
+    HdfIoServiceRecycle(((struct PwmUserHandle *)handle)->service);
+    OsalMemFree(handle);
 }
 
 int32_t PwmSetConfig(DevHandle handle, struct PwmConfig *config)
 {
     int32_t ret;
     struct HdfSBuf *buf = NULL;
+    struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
     if (handle == NULL || config == NULL) {
@@ -108,20 +129,18 @@ int32_t PwmSetConfig(DevHandle handle, struct PwmConfig *config)
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    service = (struct HdfIoService *)handle;
-    if (service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
-        HDF_LOGE("%s: service is invalid", __func__);
+    service = PwmUserGetService(handle);
+    if (service == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    buf = HdfSbufObtainDefaultSize();
-    if (buf == NULL) {
+    ret = PlatformUserSbufGet(&buf, &reply, 0);
+    if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: failed to obtain buf", __func__);
-        return HDF_ERR_MALLOC_FAIL;
+        return ret;
     }
     if (!HdfSbufWriteBuffer(buf, config, sizeof(struct PwmConfig))) {
         HDF_LOGE("%s: sbuf write cfg failed", __func__);
-        HdfSbufRecycle(buf);
         return HDF_ERR_IO;
     }
 
@@ -130,13 +149,13 @@ int32_t PwmSetConfig(DevHandle handle, struct PwmConfig *config)
         HDF_LOGE("%s: service PWM_IO_SET_CONFIG error, ret %d", __func__, ret);
     }
 
-    HdfSbufRecycle(buf);
     return ret;
 }
 
 int32_t PwmGetConfig(DevHandle handle, struct PwmConfig *config)
 {
     int32_t ret;
+    struct HdfSBuf *data = NULL;
     struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
     const void *rBuf = NULL;
@@ -147,45 +166,126 @@ int32_t PwmGetConfig(DevHandle handle, struct PwmConfig *config)
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    service = (struct HdfIoService *)handle;
-    if (service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
-        HDF_LOGE("%s: service is invalid", __func__);
+    service = PwmUserGetService(handle);
+    if (service == NULL) {
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
+    ret = PlatformUserSbufGet(&data, &reply, 0);
+    if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: failed to obtain reply", __func__);
-        return HDF_ERR_MALLOC_FAIL;
+        return ret;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, PWM_IO_GET_CONFIG, NULL, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: service PWM_IO_GET_CONFIG error, ret %d", __func__, ret);
-        HdfSbufRecycle(reply);
         return ret;
     }
 
     if (!HdfSbufReadBuffer(reply, &rBuf, &rLen)) {
         HDF_LOGE("%s: sbuf read buffer failed", __func__);
-        HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
     if (rLen != sizeof(struct PwmConfig)) {
         HDF_LOGE("%s: sbuf read buffer len error %u != %zu", __func__, rLen, sizeof(struct PwmConfig));
-        HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
     if (memcpy_s(config, sizeof(struct PwmConfig), rBuf, rLen) != EOK) {
         HDF_LOGE("%s: memcpy rBuf failed", __func__);
-        HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
 
-    HdfSbufRecycle(reply);
     return HDF_SUCCESS;
 }
 
+// each member is joined through its own handle, so only a device the caller opened can be put into the group
+static int32_t PwmUserJoinGroup(const struct PwmGroupItem *items, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+    struct HdfIoService *service = NULL;
+
+    for (i = 1; i < count; i++) {
+        if (items[i].handle == items[0].handle) {
+            continue;
+        }
+        service = PwmUserGetService(items[i].handle);
+        if (service == NULL) {
+            HDF_LOGE("%s: handle of item %u is invalid", __func__, i);
+            return HDF_ERR_INVALID_OBJECT;
+        }
+        ret = PlatformUserSbufGet(&data, &reply, 0);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: failed to obtain buf", __func__);
+            return ret;
+        }
+        if (!HdfSbufWriteUint32(data, ((struct PwmUserHandle *)items[0].handle)->num)) {
+            HDF_LOGE("%s: sbuf write carrier failed", __func__);
+            return HDF_ERR_IO;
+        }
+        ret = service->dispatcher->Dispatch(&service->object, PWM_IO_JOIN_GROUP, data, NULL);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: service PWM_IO_JOIN_GROUP error, ret %d", __func__, ret);
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t PwmSetConfigGroup(const struct PwmGroupItem *items, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+    struct HdfIoService *service = NULL;
+
+    if (items == NULL || count == 0 || count > PWM_GROUP_MAX) {
+        HDF_LOGE("%s: invalid items, count:%u", __func__, count);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    // the first member's service carries the whole group, the core looks the others up by number
+    service = PwmUserGetService(items[0].handle);
+    if (service == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    ret = PwmUserJoinGroup(items, count);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    ret = PlatformUserSbufGet(&data, &reply, 0);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to obtain buf", __func__);
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(data, count)) {
+        HDF_LOGE("%s: sbuf write count failed", __func__);
+        return HDF_ERR_IO;
+    }
+    for (i = 0; i < count; i++) {
+        if (items[i].handle == NULL) {
+            HDF_LOGE("%s: handle of item %u is NULL", __func__, i);
+            return HDF_ERR_INVALID_OBJECT;
+        }
+        if (!HdfSbufWriteUint32(data, ((struct PwmUserHandle *)items[i].handle)->num) ||
+            !HdfSbufWriteBuffer(data, &items[i].config, sizeof(struct PwmConfig))) {
+            HDF_LOGE("%s: sbuf write item %u failed", __func__, i);
+            return HDF_ERR_IO;
+        }
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, PWM_IO_SET_CONFIG_GROUP, data, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: service PWM_IO_SET_CONFIG_GROUP error, ret %d", __func__, ret);
+    }
+
+    return ret;
+}
+
 enum PwmSetConfigType {
     PWM_SET_CONFIG_PERIOD = 1,
     PWM_SET_CONFIG_DUTY,
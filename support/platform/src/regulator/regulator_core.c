@@ -18,16 +18,30 @@ struct RegulatorManager {
     struct IDeviceIoService service;
     struct HdfDeviceObject *device;
     struct DListHead regulatorHead;
+    struct DListHead nodeHash[REGULATOR_HASH_BUCKETS];
     struct OsalMutex lock;
 };
 
 static struct RegulatorManager *g_regulatorManager = NULL;
 
+// caller holds manager->lock
+static struct RegulatorNode *RegulatorNodeFind(struct RegulatorManager *manager, const char *name)
+{
+    struct RegulatorNode *pos = NULL;
+    struct DListHead *bucket = &manager->nodeHash[RegulatorNameHash(name)];
+
+    DLIST_FOR_EACH_ENTRY(pos, bucket, struct RegulatorNode, hashNode) {
+        if (strcmp(name, pos->regulatorInfo.name) == 0) {
+            return pos;
+        }
+    }
+    return NULL;
+}
+
 struct RegulatorNode *RegulatorNodeOpen(const char *name)
 {
     CHECK_NULL_PTR_RETURN_VALUE(name, NULL);
     struct RegulatorNode *pos = NULL;
-    struct RegulatorNode *tmp = NULL;
 
     struct RegulatorManager *manager = g_regulatorManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, NULL);
@@ -37,16 +51,15 @@ struct RegulatorNode *RegulatorNodeOpen(const char *name)
         return NULL;
     }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->regulatorHead, struct RegulatorNode, node) {
-        if (strcmp(name, pos->regulatorInfo.name) == 0) {
-            if ((pos->ops->open != NULL) && pos->ops->open(pos) != HDF_SUCCESS) {
-                (void)OsalMutexUnlock(&manager->lock);
-                HDF_LOGE("RegulatorNodeOpen: open regulator[%s] fail!", name);
-                return NULL;
-            }
+    pos = RegulatorNodeFind(manager, name);
+    if (pos != NULL) {
+        if ((pos->ops->open != NULL) && pos->ops->open(pos) != HDF_SUCCESS) {
             (void)OsalMutexUnlock(&manager->lock);
-            return pos;
+            HDF_LOGE("RegulatorNodeOpen: open regulator[%s] fail!", name);
+            return NULL;
         }
+        (void)OsalMutexUnlock(&manager->lock);
+        return pos;
     }
 
     (void)OsalMutexUnlock(&manager->lock);
@@ -92,7 +105,6 @@ int32_t RegulatorNodeSetParent(struct RegulatorNode *node)
 {
     CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
     struct RegulatorNode *pos = NULL;
-    struct RegulatorNode *tmp = NULL;
     struct RegulatorManager *manager = g_regulatorManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
@@ -103,18 +115,16 @@ int32_t RegulatorNodeSetParent(struct RegulatorNode *node)
     // parent set
     if ((node->regulatorInfo.parentName != NULL)
         && (strlen(node->regulatorInfo.parentName) > 0)) {
-        DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->regulatorHead, struct RegulatorNode, node) {
-            if (strcmp(node->regulatorInfo.parentName, pos->regulatorInfo.name) == 0) {
-                if (RegulatorTreeSet(node->regulatorInfo.name, node, pos) != HDF_SUCCESS) {
-                    HDF_LOGE("%s: RegulatorTreeSet failed", __func__);
-                    (void)OsalMutexUnlock(&manager->lock);
-                    return HDF_FAILURE;
-                } else {
-                    HDF_LOGI("%s:regulator [%s] RegulatorTreeSet success", __func__, node->regulatorInfo.name);
-                    (void)OsalMutexUnlock(&manager->lock);
-                    return HDF_SUCCESS;
-                }
+        pos = RegulatorNodeFind(manager, node->regulatorInfo.parentName);
+        if (pos != NULL) {
+            if (RegulatorTreeSet(node->regulatorInfo.name, node, pos) != HDF_SUCCESS) {
+                HDF_LOGE("%s: RegulatorTreeSet failed", __func__);
+                (void)OsalMutexUnlock(&manager->lock);
+                return HDF_FAILURE;
             }
+            HDF_LOGI("%s:regulator [%s] RegulatorTreeSet success", __func__, node->regulatorInfo.name);
+            (void)OsalMutexUnlock(&manager->lock);
+            return HDF_SUCCESS;
         }
 
         HDF_LOGE("%s: RegulatorTreeSet find %s parent %s error",
@@ -230,18 +240,10 @@ int32_t RegulatorNodeAdd(struct RegulatorNode *node)
 {
     CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
     CHECK_NULL_PTR_RETURN_VALUE(node->ops, HDF_ERR_INVALID_PARAM);
-    struct RegulatorNode *pos = NULL;
-    struct RegulatorNode *tmp = NULL;
+    CHECK_NULL_PTR_RETURN_VALUE(node->regulatorInfo.name, HDF_ERR_INVALID_PARAM);
     struct RegulatorManager *manager = g_regulatorManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->regulatorHead, struct RegulatorNode, node) {
-        if (strcmp(node->regulatorInfo.name, pos->regulatorInfo.name) == 0) {
-            HDF_LOGE("%s: regulatorInfo[%s] existed", __func__, node->regulatorInfo.name);
-            return HDF_FAILURE;
-        }
-    }
-
     // init node info
     node->regulatorInfo.cb = NULL;
     node->regulatorInfo.useCount = 0;
@@ -254,9 +256,17 @@ int32_t RegulatorNodeAdd(struct RegulatorNode *node)
 
     if (OsalMutexLock(&manager->lock) != HDF_SUCCESS) {
         HDF_LOGE("RegulatorManagerAddNode: lock regulator manager fail!");
+        (void)OsalMutexDestroy(&node->lock);
         return HDF_ERR_DEVICE_BUSY;
     }
+    if (RegulatorNodeFind(manager, node->regulatorInfo.name) != NULL) {
+        (void)OsalMutexUnlock(&manager->lock);
+        (void)OsalMutexDestroy(&node->lock);
+        HDF_LOGE("%s: regulatorInfo[%s] existed", __func__, node->regulatorInfo.name);
+        return HDF_FAILURE;
+    }
     DListInsertTail(&node->node, &manager->regulatorHead);
+    DListInsertTail(&node->hashNode, &manager->nodeHash[RegulatorNameHash(node->regulatorInfo.name)]);
     (void)OsalMutexUnlock(&manager->lock);
 
     if (RegulatorNodeInitProcess(node) != HDF_SUCCESS) {
@@ -274,7 +284,6 @@ int32_t RegulatorNodeRemove(const char *name)
     CHECK_NULL_PTR_RETURN_VALUE(name, HDF_ERR_INVALID_PARAM);
 
     struct RegulatorNode *pos = NULL;
-    struct RegulatorNode *tmp = NULL;
     struct RegulatorManager *manager = g_regulatorManager;
     if (manager == NULL) {
         HDF_LOGE("RegulatorNodeRemoveAll: regulator manager null!");
@@ -286,16 +295,15 @@ int32_t RegulatorNodeRemove(const char *name)
         return HDF_ERR_DEVICE_BUSY;
     }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->regulatorHead, struct RegulatorNode, node) {
-        if (strcmp(pos->regulatorInfo.name, name) == 0) {
-            if ((pos->ops->release != NULL) && pos->ops->release(pos) != HDF_SUCCESS) {
-                HDF_LOGE("RegulatorNodeRemoveAll: release regulator[%s] fail!", pos->regulatorInfo.name);
-            }
-            DListRemove(&pos->node);
-            (void)OsalMutexDestroy(&pos->lock);
-            OsalMemFree(pos);
-            break;
+    pos = RegulatorNodeFind(manager, name);
+    if (pos != NULL) {
+        if ((pos->ops->release != NULL) && pos->ops->release(pos) != HDF_SUCCESS) {
+            HDF_LOGE("RegulatorNodeRemoveAll: release regulator[%s] fail!", pos->regulatorInfo.name);
         }
+        DListRemove(&pos->hashNode);
+        DListRemove(&pos->node);
+        (void)OsalMutexDestroy(&pos->lock);
+        OsalMemFree(pos);
     }
 
     (void)OsalMutexUnlock(&manager->lock);
@@ -327,6 +335,7 @@ int32_t RegulatorNodeRemoveAll(void)
         if ((pos->ops->release != NULL) && pos->ops->release(pos) != HDF_SUCCESS) {
             HDF_LOGE("RegulatorNodeRemoveAll: release regulator[%s] fail!", pos->regulatorInfo.name);
         }
+        DListRemove(&pos->hashNode);
         DListRemove(&pos->node);
         (void)OsalMutexDestroy(&pos->lock);
         OsalMemFree(pos);
@@ -351,9 +360,9 @@ int32_t RegulatorNodeStatusCb(struct RegulatorNode *node)
     return node->regulatorInfo.cb(&info);
 }
 
-int32_t RegulatorNodeEnable(struct RegulatorNode *node)
+// caller holds the tree lock
+static int32_t RegulatorNodeEnableLocked(struct RegulatorNode *node)
 {
-    CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
     if (node->regulatorInfo.status == REGULATOR_STATUS_ON) {
         HDF_LOGD("RegulatorNodeEnable: %s status on", node->regulatorInfo.name);
         return HDF_SUCCESS;
@@ -365,13 +374,13 @@ int32_t RegulatorNodeEnable(struct RegulatorNode *node)
     }
 
     if ((node->regulatorInfo.parentName != NULL) && (strlen(node->regulatorInfo.parentName) > 0)) {
-        struct RegulatorNode *parent = RegulatorTreeGetParent(node->regulatorInfo.name);
+        struct RegulatorNode *parent = RegulatorTreeGetParentLocked(node->regulatorInfo.name);
         if (parent == NULL) {
             (void)OsalMutexUnlock(&node->lock);
             HDF_LOGE("RegulatorNodeEnable: %s failed", node->regulatorInfo.name);
             return HDF_FAILURE;
         }
-        if (RegulatorNodeEnable(parent) != HDF_SUCCESS) {
+        if (RegulatorNodeEnableLocked(parent) != HDF_SUCCESS) {
             (void)OsalMutexUnlock(&node->lock);
             HDF_LOGE("RegulatorNodeEnable: %s failed", parent->regulatorInfo.name);
             return HDF_FAILURE;
@@ -390,9 +399,28 @@ int32_t RegulatorNodeEnable(struct RegulatorNode *node)
     return HDF_SUCCESS;
 }
 
-int32_t RegulatorNodeDisable(struct RegulatorNode *node)
+int32_t RegulatorNodeEnable(struct RegulatorNode *node)
 {
+    int32_t ret;
+
     CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
+    if (node->regulatorInfo.status == REGULATOR_STATUS_ON) {
+        HDF_LOGD("RegulatorNodeEnable: %s status on", node->regulatorInfo.name);
+        return HDF_SUCCESS;
+    }
+
+    ret = RegulatorTreeLock();
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    ret = RegulatorNodeEnableLocked(node);
+    RegulatorTreeUnlock();
+    return ret;
+}
+
+// caller holds the tree lock
+static int32_t RegulatorNodeDisableLocked(struct RegulatorNode *node)
+{
     if ((node->regulatorInfo.status == REGULATOR_STATUS_OFF) || (node->regulatorInfo.constraints.alwaysOn)) {
         HDF_LOGI("RegulatorNodeDisable: %s [%d][%d], unsatisfied closing adjusment",
             node->regulatorInfo.name, node->regulatorInfo.status, node->regulatorInfo.constraints.alwaysOn);
@@ -404,7 +432,7 @@ int32_t RegulatorNodeDisable(struct RegulatorNode *node)
         return HDF_ERR_DEVICE_BUSY;
     }
 
-    if (!RegulatorTreeIsAllChildDisable(node->regulatorInfo.name)) {
+    if (!RegulatorTreeIsAllChildDisableLocked(node->regulatorInfo.name)) {
         (void)OsalMutexUnlock(&node->lock);
         HDF_LOGE("RegulatorNodeDisable:there is %s child not disable, so disable node failed",
             node->regulatorInfo.name);
@@ -423,13 +451,13 @@ int32_t RegulatorNodeDisable(struct RegulatorNode *node)
 
     // set parent
     if ((node->regulatorInfo.parentName != NULL) && (strlen(node->regulatorInfo.parentName) > 0)) {
-        struct RegulatorNode *parent = RegulatorTreeGetParent(node->regulatorInfo.name);
+        struct RegulatorNode *parent = RegulatorTreeGetParentLocked(node->regulatorInfo.name);
         if (parent == NULL) {
             (void)OsalMutexUnlock(&node->lock);
             HDF_LOGE("RegulatorNodeDisable: %s failed", node->regulatorInfo.name);
             return HDF_FAILURE;
         }
-        if (RegulatorNodeDisable(parent) != HDF_SUCCESS) {
+        if (RegulatorNodeDisableLocked(parent) != HDF_SUCCESS) {
             (void)OsalMutexUnlock(&node->lock);
             HDF_LOGD("RegulatorNodeDisable: disable %s's parent %s failed",
                 node->regulatorInfo.name, parent->regulatorInfo.name);
@@ -441,9 +469,23 @@ int32_t RegulatorNodeDisable(struct RegulatorNode *node)
     return HDF_SUCCESS;
 }
 
-int32_t RegulatorNodeForceDisable(struct RegulatorNode *node)
+int32_t RegulatorNodeDisable(struct RegulatorNode *node)
 {
+    int32_t ret;
+
     CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
+    ret = RegulatorTreeLock();
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    ret = RegulatorNodeDisableLocked(node);
+    RegulatorTreeUnlock();
+    return ret;
+}
+
+// caller holds the tree lock
+static int32_t RegulatorNodeForceDisableLocked(struct RegulatorNode *node)
+{
     if (OsalMutexLock(&node->lock) != HDF_SUCCESS) {
         HDF_LOGE(": lock regulator %s fail!", node->regulatorInfo.name);
         return HDF_ERR_DEVICE_BUSY;
@@ -455,7 +497,7 @@ int32_t RegulatorNodeForceDisable(struct RegulatorNode *node)
     }
 
     // if the regulator force disable ,set all child node disable
-    if (RegulatorTreeChildForceDisable(node)) {
+    if (RegulatorTreeChildForceDisableLocked(node)) {
         (void)OsalMutexUnlock(&node->lock);
         HDF_LOGE("RegulatorNodeForceDisable--RegulatorTreeConsumerForceDisable: %s failed", node->regulatorInfo.name);
         return HDF_FAILURE;
@@ -478,13 +520,13 @@ int32_t RegulatorNodeForceDisable(struct RegulatorNode *node)
 
     // set parent
     if ((node->regulatorInfo.parentName != NULL) && (strlen(node->regulatorInfo.parentName) > 0)) {
-        struct RegulatorNode *parent = RegulatorTreeGetParent(node->regulatorInfo.name);
+        struct RegulatorNode *parent = RegulatorTreeGetParentLocked(node->regulatorInfo.name);
         if (parent == NULL) {
             (void)OsalMutexUnlock(&node->lock);
             HDF_LOGE(": %s failed", node->regulatorInfo.name);
             return HDF_FAILURE;
         }
-        if (RegulatorNodeDisable(parent) != HDF_SUCCESS) {
+        if (RegulatorNodeDisableLocked(parent) != HDF_SUCCESS) {
             (void)OsalMutexUnlock(&node->lock);
             HDF_LOGD("RegulatorNodeDisable: disable %s's parent %s failed",
                 node->regulatorInfo.name, parent->regulatorInfo.name);
@@ -496,6 +538,20 @@ int32_t RegulatorNodeForceDisable(struct RegulatorNode *node)
     return HDF_SUCCESS;
 }
 
+int32_t RegulatorNodeForceDisable(struct RegulatorNode *node)
+{
+    int32_t ret;
+
+    CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
+    ret = RegulatorTreeLock();
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    ret = RegulatorNodeForceDisableLocked(node);
+    RegulatorTreeUnlock();
+    return ret;
+}
+
 int32_t RegulatorNodeSetVoltage(struct RegulatorNode *node, uint32_t minUv, uint32_t maxUv)
 {
     CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
@@ -634,26 +690,126 @@ int32_t RegulatorNodeRegisterStatusChangeCb(struct RegulatorNode *node, Regulato
     return HDF_SUCCESS;
 }
 
+#define REGULATOR_BATCH_RANK_NUM ((REGULATOR_TREE_DEPTH_MAX + 1) * 3)
+
+// disables rank first from the leaves up, then rail changes and enables from the roots down
+static uint32_t RegulatorBatchRank(uint8_t op, uint32_t depth)
+{
+    switch (op) {
+        case REGULATOR_BATCH_DISABLE:
+            return REGULATOR_TREE_DEPTH_MAX - depth;
+        case REGULATOR_BATCH_SET_VOLTAGE:
+        case REGULATOR_BATCH_SET_CURRENT:
+            return REGULATOR_TREE_DEPTH_MAX + 1 + depth;
+        default:
+            return (REGULATOR_TREE_DEPTH_MAX + 1) * 2 + depth;
+    }
+}
+
+// caller holds the tree lock
+static int32_t RegulatorBatchStepApply(const struct RegulatorBatchStep *step)
+{
+    struct RegulatorNode *node = (struct RegulatorNode *)step->handle;
+
+    switch (step->op) {
+        case REGULATOR_BATCH_ENABLE:
+            return RegulatorNodeEnableLocked(node);
+        case REGULATOR_BATCH_DISABLE:
+            return RegulatorNodeDisableLocked(node);
+        case REGULATOR_BATCH_SET_VOLTAGE:
+            return RegulatorNodeSetVoltage(node, step->min, step->max);
+        case REGULATOR_BATCH_SET_CURRENT:
+            return RegulatorNodeSetCurrent(node, step->min, step->max);
+        default:
+            return HDF_ERR_NOT_SUPPORT;
+    }
+}
+
+/*
+ * The steps are ordered by a counting sort on their rank, which is stable (steps of one rank keep the
+ * caller's order) and linear in the number of steps, so a suspend sequence touching every rail stays cheap.
+ */
+int32_t RegulatorNodeBatchApply(struct RegulatorBatchStep *steps, uint32_t count)
+{
+    uint32_t i;
+    int32_t ret;
+    uint32_t *ranks = NULL;
+    uint32_t *order = NULL;
+    uint32_t start[REGULATOR_BATCH_RANK_NUM + 1] = {0};
+    struct RegulatorBatchStep *step = NULL;
+
+    CHECK_NULL_PTR_RETURN_VALUE(steps, HDF_ERR_INVALID_PARAM);
+    if (count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    for (i = 0; i < count; i++) {
+        if ((steps[i].handle == NULL) || (steps[i].op < REGULATOR_BATCH_ENABLE) ||
+            (steps[i].op > REGULATOR_BATCH_SET_CURRENT)) {
+            HDF_LOGE("RegulatorNodeBatchApply: step %u invalid!", i);
+            return HDF_ERR_INVALID_PARAM;
+        }
+        steps[i].ret = HDF_FAILURE;
+    }
+
+    ranks = (uint32_t *)OsalMemCalloc(sizeof(*ranks) * count * 2); // 2: ranks then order
+    if (ranks == NULL) {
+        HDF_LOGE("RegulatorNodeBatchApply: malloc order fail!");
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    order = ranks + count;
+
+    ret = RegulatorTreeLock();
+    if (ret != HDF_SUCCESS) {
+        OsalMemFree(ranks);
+        return ret;
+    }
+
+    for (i = 0; i < count; i++) {
+        step = &steps[i];
+        ranks[i] = RegulatorBatchRank(step->op,
+            RegulatorTreeGetDepthLocked(((struct RegulatorNode *)step->handle)->regulatorInfo.name));
+        start[ranks[i] + 1]++;
+    }
+    for (i = 1; i <= REGULATOR_BATCH_RANK_NUM; i++) {
+        start[i] += start[i - 1];
+    }
+    for (i = 0; i < count; i++) {
+        order[start[ranks[i]]++] = i;
+    }
+
+    for (i = 0; i < count; i++) {
+        step = &steps[order[i]];
+        step->ret = RegulatorBatchStepApply(step);
+        if (step->ret != HDF_SUCCESS) {
+            HDF_LOGE("RegulatorNodeBatchApply: op %u on %s fail, ret %d", step->op,
+                ((struct RegulatorNode *)step->handle)->regulatorInfo.name, step->ret);
+            ret = step->ret;
+            break;
+        }
+    }
+
+    RegulatorTreeUnlock();
+    OsalMemFree(ranks);
+    return ret;
+}
+
 int32_t RegulatorTreeInfoInit(struct RegulatorNode *node)
 {
     struct RegulatorNode *pos = NULL;
-    struct RegulatorNode *tmp = NULL;
     CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_OBJECT);
     struct RegulatorManager *manager = g_regulatorManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_ERR_INVALID_OBJECT);
 
     if ((node->regulatorInfo.parentName != NULL)
         && (strlen(node->regulatorInfo.parentName) > 0)) {
-        DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->regulatorHead, struct RegulatorNode, node) {
-            if (strcmp(node->regulatorInfo.parentName, pos->regulatorInfo.name) == 0) {
-                if (RegulatorTreeSet(node->regulatorInfo.name, node, pos) != HDF_SUCCESS) {
-                    HDF_LOGE("%s: RegulatorTreeSet failed", __func__);
-                    return HDF_FAILURE;
-                } else {
-                    HDF_LOGI("%s:regulator [%s] RegulatorTreeSet success", __func__, node->regulatorInfo.name);
-                    return HDF_SUCCESS;
-                }
+        pos = RegulatorNodeFind(manager, node->regulatorInfo.parentName);
+        if (pos != NULL) {
+            if (RegulatorTreeSet(node->regulatorInfo.name, node, pos) != HDF_SUCCESS) {
+                HDF_LOGE("%s: RegulatorTreeSet failed", __func__);
+                return HDF_FAILURE;
             }
+            HDF_LOGI("%s:regulator [%s] RegulatorTreeSet success", __func__, node->regulatorInfo.name);
+            return HDF_SUCCESS;
         }
 
         HDF_LOGE("%s: RegulatorTreeSet find %s parent %s error",
@@ -666,6 +822,7 @@ int32_t RegulatorTreeInfoInit(struct RegulatorNode *node)
 static int32_t RegulatorManagerBind(struct HdfDeviceObject *device)
 {
     int32_t ret;
+    uint32_t i;
     struct RegulatorManager *manager = NULL;
 
     HDF_LOGI("RegulatorManagerBind: Enter!");
@@ -687,6 +844,9 @@ static int32_t RegulatorManagerBind(struct HdfDeviceObject *device)
     manager->device = device;
     device->service = &manager->service;
     DListHeadInit(&manager->regulatorHead);
+    for (i = 0; i < REGULATOR_HASH_BUCKETS; i++) {
+        DListHeadInit(&manager->nodeHash[i]);
+    }
     g_regulatorManager = manager;
 
     if (RegulatorTreeManagerInit() != HDF_SUCCESS) {
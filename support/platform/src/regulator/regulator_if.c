@@ -180,3 +180,19 @@ int32_t RegulatorGetStatus(DevHandle handle, uint32_t *status)
 
     return HDF_SUCCESS;
 }
+
+int32_t RegulatorBatchApply(struct RegulatorBatchStep *steps, uint32_t count)
+{
+    if (steps == NULL || count == 0) {
+        HDF_LOGE("%s: steps is null or count is 0", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    int ret = RegulatorNodeBatchApply(steps, count);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: RegulatorNodeBatchApply fail", __func__);
+        return ret;
+    }
+
+    return HDF_SUCCESS;
+}
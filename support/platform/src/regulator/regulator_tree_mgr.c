@@ -42,66 +42,110 @@ void RegulatorChildListDestroy(struct RegulatorTreeInfo *pRegulator)
     }
 }
 
-// name:the regulator node name; fun :get the node parent struct RegulatorNode
-struct RegulatorNode *RegulatorTreeGetParent(const char *name)
+// caller holds manager->lock
+static struct RegulatorTreeInfo *RegulatorTreeFind(struct RegulatorTreeManager *manager, const char *name)
 {
-    CHECK_NULL_PTR_RETURN_VALUE(name, NULL);
-
     struct RegulatorTreeInfo *pos = NULL;
-    struct RegulatorTreeInfo *tmp = NULL;
+    struct DListHead *bucket = &manager->hashHead[RegulatorNameHash(name)];
+
+    DLIST_FOR_EACH_ENTRY(pos, bucket, struct RegulatorTreeInfo, hashNode) {
+        if (strcmp(pos->name, name) == 0) {
+            return pos;
+        }
+    }
+    return NULL;
+}
+
+int32_t RegulatorTreeLock(void)
+{
     struct RegulatorTreeManager *manager = g_regulatorTreeManager;
-    CHECK_NULL_PTR_RETURN_VALUE(manager, NULL);
+    CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
     if (OsalMutexLock(&manager->lock) != HDF_SUCCESS) {
-        HDF_LOGE("RegulatorTreeGetParent: lock regulator manager fail!");
-        return NULL;
+        HDF_LOGE("RegulatorTreeLock: lock regulator manager fail!");
+        return HDF_ERR_DEVICE_BUSY;
     }
+    return HDF_SUCCESS;
+}
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->treeMgrHead, struct RegulatorTreeInfo, node) {
-        if (strcmp(pos->name, name) == 0) {
-            if (pos->parent == NULL) {
-                (void)OsalMutexUnlock(&manager->lock);
-                HDF_LOGI("RegulatorTreeGetParent: %s no parent", name);
-                return NULL;
-            }
-            (void)OsalMutexUnlock(&manager->lock);
-            HDF_LOGI("RegulatorTreeGetParent: get %s parent %s success!",
-                name, pos->parent->regulatorInfo.name);
-            return pos->parent;
-        }
-    }
+void RegulatorTreeUnlock(void)
+{
+    struct RegulatorTreeManager *manager = g_regulatorTreeManager;
+    CHECK_NULL_PTR_RETURN(manager);
 
     (void)OsalMutexUnlock(&manager->lock);
-    HDF_LOGI("RegulatorTreeGetParent: no %s Tree node", name);
-    return NULL;
 }
 
-// next level child
-static struct DListHead *RegulatorTreeGetChild(const char *name)
+struct RegulatorNode *RegulatorTreeGetParentLocked(const char *name)
 {
     CHECK_NULL_PTR_RETURN_VALUE(name, NULL);
 
-    struct RegulatorTreeInfo *pos = NULL;
-    struct RegulatorTreeInfo *tmp = NULL;
+    struct RegulatorTreeInfo *info = NULL;
     struct RegulatorTreeManager *manager = g_regulatorTreeManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, NULL);
 
-    if (OsalMutexLock(&manager->lock) != HDF_SUCCESS) {
-        HDF_LOGE("RegulatorTreeGetChild: lock regulator manager fail!");
+    info = RegulatorTreeFind(manager, name);
+    if (info == NULL) {
+        HDF_LOGI("RegulatorTreeGetParent: no %s Tree node", name);
+        return NULL;
+    }
+    if (info->parent == NULL) {
+        HDF_LOGI("RegulatorTreeGetParent: %s no parent", name);
         return NULL;
     }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->treeMgrHead, struct RegulatorTreeInfo, node) {
-        if (strcmp(pos->name, name) == 0) {
-            (void)OsalMutexUnlock(&manager->lock);
-            HDF_LOGI("RegulatorTreeGetChild: get %s child success!", name);
-            return (&pos->childHead);
-        }
+    HDF_LOGD("RegulatorTreeGetParent: get %s parent %s success!", name, info->parent->regulatorInfo.name);
+    return info->parent;
+}
+
+// name:the regulator node name; fun :get the node parent struct RegulatorNode
+struct RegulatorNode *RegulatorTreeGetParent(const char *name)
+{
+    CHECK_NULL_PTR_RETURN_VALUE(name, NULL);
+
+    struct RegulatorNode *parent = NULL;
+
+    if (RegulatorTreeLock() != HDF_SUCCESS) {
+        return NULL;
     }
+    parent = RegulatorTreeGetParentLocked(name);
+    RegulatorTreeUnlock();
+    return parent;
+}
 
-    (void)OsalMutexUnlock(&manager->lock);
-    HDF_LOGE("RegulatorTreeGetChild: get %s child failed!", name);
-    return NULL;
+// next level child, caller holds manager->lock
+static struct DListHead *RegulatorTreeGetChildLocked(const char *name)
+{
+    CHECK_NULL_PTR_RETURN_VALUE(name, NULL);
+
+    struct RegulatorTreeInfo *info = NULL;
+    struct RegulatorTreeManager *manager = g_regulatorTreeManager;
+    CHECK_NULL_PTR_RETURN_VALUE(manager, NULL);
+
+    info = RegulatorTreeFind(manager, name);
+    if (info == NULL) {
+        HDF_LOGD("RegulatorTreeGetChild: %s has no child", name);
+        return NULL;
+    }
+    return &info->childHead;
+}
+
+uint32_t RegulatorTreeGetDepthLocked(const char *name)
+{
+    CHECK_NULL_PTR_RETURN_VALUE(name, 0);
+
+    uint32_t depth = 0;
+    struct RegulatorTreeInfo *info = NULL;
+    struct RegulatorTreeManager *manager = g_regulatorTreeManager;
+    CHECK_NULL_PTR_RETURN_VALUE(manager, 0);
+
+    // bounded, so a loop described in the config can not hang the caller
+    info = RegulatorTreeFind(manager, name);
+    while ((info != NULL) && (info->parent != NULL) && (depth < REGULATOR_TREE_DEPTH_MAX)) {
+        depth++;
+        info = RegulatorTreeFind(manager, info->parent->regulatorInfo.name);
+    }
+    return depth;
 }
 
 // name:the regulator node name
@@ -122,19 +166,26 @@ bool RegulatorTreeIsUpNodeComplete(const char *name)
 bool RegulatorTreeIsChildAlwayson(const char *name)
 {
     CHECK_NULL_PTR_RETURN_VALUE(name, false);
-    struct DListHead *pList = RegulatorTreeGetChild(name);
-    CHECK_NULL_PTR_RETURN_VALUE(pList, false);
+    if (RegulatorTreeLock() != HDF_SUCCESS) {
+        return false;
+    }
+    struct DListHead *pList = RegulatorTreeGetChildLocked(name);
+    if (pList == NULL) {
+        RegulatorTreeUnlock();
+        return false;
+    }
 
     struct RegulatorChildNode *nodeInfo = NULL;
-    struct RegulatorChildNode *tmp = NULL;
-    DLIST_FOR_EACH_ENTRY_SAFE(nodeInfo, tmp, pList, struct RegulatorChildNode, node) {
+    DLIST_FOR_EACH_ENTRY(nodeInfo, pList, struct RegulatorChildNode, node) {
         if (nodeInfo->child->regulatorInfo.constraints.alwaysOn) {
+            RegulatorTreeUnlock();
             HDF_LOGD("RegulatorTreeIsChildAlwayson:%s's child %s alwaysOn true!",
                 name, nodeInfo->child->regulatorInfo.name);
             return true;
         }
     }
 
+    RegulatorTreeUnlock();
     HDF_LOGD("RegulatorTreeIsChildAlwayson:%s's all child alwaysOn false!", name);
     return false;
 }
@@ -142,32 +193,38 @@ bool RegulatorTreeIsChildAlwayson(const char *name)
 bool RegulatorTreeIsChildStatusOn(const char *name)
 {
     CHECK_NULL_PTR_RETURN_VALUE(name, false);
-    struct DListHead *pList = RegulatorTreeGetChild(name);
-    CHECK_NULL_PTR_RETURN_VALUE(pList, false);
+    if (RegulatorTreeLock() != HDF_SUCCESS) {
+        return false;
+    }
+    struct DListHead *pList = RegulatorTreeGetChildLocked(name);
+    if (pList == NULL) {
+        RegulatorTreeUnlock();
+        return false;
+    }
 
     struct RegulatorChildNode *nodeInfo = NULL;
-    struct RegulatorChildNode *tmp = NULL;
-    DLIST_FOR_EACH_ENTRY_SAFE(nodeInfo, tmp, pList, struct RegulatorChildNode, node) {
+    DLIST_FOR_EACH_ENTRY(nodeInfo, pList, struct RegulatorChildNode, node) {
         if (nodeInfo->child->regulatorInfo.status == REGULATOR_STATUS_ON) {
+            RegulatorTreeUnlock();
             HDF_LOGD("RegulatorTreeIsChildAlwayson:%s's child %s status on!",
                 name, nodeInfo->child->regulatorInfo.name);
             return true;
         }
     }
 
+    RegulatorTreeUnlock();
     HDF_LOGD("RegulatorTreeIsChildAlwayson:%s's all child status off!", name);
     return false;
 }
 
-bool RegulatorTreeIsAllChildDisable(const char *name)
+bool RegulatorTreeIsAllChildDisableLocked(const char *name)
 {
     CHECK_NULL_PTR_RETURN_VALUE(name, true);
-    struct DListHead *pList = RegulatorTreeGetChild(name);
+    struct DListHead *pList = RegulatorTreeGetChildLocked(name);
     CHECK_NULL_PTR_RETURN_VALUE(pList, true);
 
     struct RegulatorChildNode *nodeInfo = NULL;
-    struct RegulatorChildNode *tmp = NULL;
-    DLIST_FOR_EACH_ENTRY_SAFE(nodeInfo, tmp, pList, struct RegulatorChildNode, node) {
+    DLIST_FOR_EACH_ENTRY(nodeInfo, pList, struct RegulatorChildNode, node) {
         if (nodeInfo->child->regulatorInfo.status == REGULATOR_STATUS_ON) {
             HDF_LOGI("RegulatorTreeIsAllChildDisable:%s's child %s on!", name, nodeInfo->child->regulatorInfo.name);
             return false;
@@ -178,16 +235,30 @@ bool RegulatorTreeIsAllChildDisable(const char *name)
     return true;
 }
 
-int32_t RegulatorTreeChildForceDisable(struct RegulatorNode *node)
+bool RegulatorTreeIsAllChildDisable(const char *name)
+{
+    bool ret = false;
+
+    CHECK_NULL_PTR_RETURN_VALUE(name, true);
+    if (RegulatorTreeLock() != HDF_SUCCESS) {
+        return false;
+    }
+    ret = RegulatorTreeIsAllChildDisableLocked(name);
+    RegulatorTreeUnlock();
+    return ret;
+}
+
+int32_t RegulatorTreeChildForceDisableLocked(struct RegulatorNode *node)
 {
     CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
-    struct DListHead *pList = RegulatorTreeGetChild(node->regulatorInfo.name);
-    CHECK_NULL_PTR_RETURN_VALUE(pList, HDF_SUCCESS);
-    
+    struct DListHead *pList = RegulatorTreeGetChildLocked(node->regulatorInfo.name);
+    if (pList == NULL) {
+        return HDF_SUCCESS;
+    }
+
     struct RegulatorChildNode *nodeInfo = NULL;
-    struct RegulatorChildNode *tmp = NULL;
-    DLIST_FOR_EACH_ENTRY_SAFE(nodeInfo, tmp, pList, struct RegulatorChildNode, node) {
-        if (RegulatorTreeChildForceDisable(nodeInfo->child) != HDF_SUCCESS) {
+    DLIST_FOR_EACH_ENTRY(nodeInfo, pList, struct RegulatorChildNode, node) {
+        if (RegulatorTreeChildForceDisableLocked(nodeInfo->child) != HDF_SUCCESS) {
             HDF_LOGE("RegulatorTreeChildForceDisable: %s fail!", nodeInfo->child->regulatorInfo.name);
             return HDF_FAILURE;
         }
@@ -208,14 +279,26 @@ int32_t RegulatorTreeChildForceDisable(struct RegulatorNode *node)
     return HDF_SUCCESS;
 }
 
+int32_t RegulatorTreeChildForceDisable(struct RegulatorNode *node)
+{
+    int32_t ret;
+
+    CHECK_NULL_PTR_RETURN_VALUE(node, HDF_ERR_INVALID_PARAM);
+    ret = RegulatorTreeLock();
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    ret = RegulatorTreeChildForceDisableLocked(node);
+    RegulatorTreeUnlock();
+    return ret;
+}
+
 // if Tree regulator node not exist, then add
 static int32_t RegulatorTreeManagerNodeInit(const char *name)
 {
     CHECK_NULL_PTR_RETURN_VALUE(name, HDF_FAILURE);
 
     struct RegulatorTreeInfo *nodeInfo = NULL;
-    struct RegulatorTreeInfo *pos = NULL;
-    struct RegulatorTreeInfo *tmp = NULL;
     struct RegulatorTreeManager *manager = g_regulatorTreeManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
@@ -224,21 +307,24 @@ static int32_t RegulatorTreeManagerNodeInit(const char *name)
         return HDF_ERR_DEVICE_BUSY;
     }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->treeMgrHead, struct RegulatorTreeInfo, node) {
-        if (strcmp(pos->name, name) == 0) {
-            HDF_LOGI("RegulatorTreeManagerNodeInit: node %s has exists!", name);
-            (void)OsalMutexUnlock(&manager->lock);
-            return HDF_SUCCESS;
-        }
+    if (RegulatorTreeFind(manager, name) != NULL) {
+        HDF_LOGI("RegulatorTreeManagerNodeInit: node %s has exists!", name);
+        (void)OsalMutexUnlock(&manager->lock);
+        return HDF_SUCCESS;
     }
 
     nodeInfo = (struct RegulatorTreeInfo *)OsalMemCalloc(sizeof(*nodeInfo));
-    CHECK_NULL_PTR_RETURN_VALUE(nodeInfo, HDF_FAILURE);
+    if (nodeInfo == NULL) {
+        (void)OsalMutexUnlock(&manager->lock);
+        HDF_LOGE("RegulatorTreeManagerNodeInit: OsalMemCalloc failed");
+        return HDF_FAILURE;
+    }
 
     DListHeadInit(&nodeInfo->childHead);
     nodeInfo->name = name;
 
     DListInsertTail(&nodeInfo->node, &manager->treeMgrHead);
+    DListInsertTail(&nodeInfo->hashNode, &manager->hashHead[RegulatorNameHash(name)]);
     (void)OsalMutexUnlock(&manager->lock);
     
     HDF_LOGI("RegulatorTreeManagerNodeInit: init %s node success!", name);
@@ -251,8 +337,7 @@ static int RegulatorTreeSetParent(const char *name, struct RegulatorNode *parent
     CHECK_NULL_PTR_RETURN_VALUE(name, HDF_ERR_INVALID_PARAM);
     CHECK_NULL_PTR_RETURN_VALUE(parent, HDF_ERR_INVALID_PARAM);
     
-    struct RegulatorTreeInfo *pos = NULL;
-    struct RegulatorTreeInfo *tmp = NULL;
+    struct RegulatorTreeInfo *info = NULL;
     struct RegulatorTreeManager *manager = g_regulatorTreeManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
@@ -261,13 +346,12 @@ static int RegulatorTreeSetParent(const char *name, struct RegulatorNode *parent
         return HDF_ERR_DEVICE_BUSY;
     }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->treeMgrHead, struct RegulatorTreeInfo, node) {
-        if (strcmp(pos->name, name) == 0) {
-            pos->parent = parent;
-            (void)OsalMutexUnlock(&manager->lock);
-            HDF_LOGI("RegulatorTreeSetParent: set %s parent success!", name);
-            return HDF_SUCCESS;
-        }
+    info = RegulatorTreeFind(manager, name);
+    if (info != NULL) {
+        info->parent = parent;
+        (void)OsalMutexUnlock(&manager->lock);
+        HDF_LOGI("RegulatorTreeSetParent: set %s parent success!", name);
+        return HDF_SUCCESS;
     }
 
     (void)OsalMutexUnlock(&manager->lock);
@@ -281,8 +365,7 @@ static int RegulatorTreeSetChild(const char *name, struct RegulatorNode *child)
     CHECK_NULL_PTR_RETURN_VALUE(name, HDF_ERR_INVALID_PARAM);
     CHECK_NULL_PTR_RETURN_VALUE(child, HDF_ERR_INVALID_PARAM);
 
-    struct RegulatorTreeInfo *pos = NULL;
-    struct RegulatorTreeInfo *tmp = NULL;
+    struct RegulatorTreeInfo *info = NULL;
     struct RegulatorTreeManager *manager = g_regulatorTreeManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
@@ -291,17 +374,16 @@ static int RegulatorTreeSetChild(const char *name, struct RegulatorNode *child)
         return HDF_ERR_DEVICE_BUSY;
     }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->treeMgrHead, struct RegulatorTreeInfo, node) {
-        if (strcmp(pos->name, name) == 0) {
-            if (RegulatorChildNodeAdd(pos, child) != HDF_SUCCESS) {
-                HDF_LOGE("RegulatorTreeSetChild: RegulatorChildNodeAdd fail!");
-                (void)OsalMutexUnlock(&manager->lock);
-                return HDF_FAILURE;
-            }
+    info = RegulatorTreeFind(manager, name);
+    if (info != NULL) {
+        if (RegulatorChildNodeAdd(info, child) != HDF_SUCCESS) {
+            HDF_LOGE("RegulatorTreeSetChild: RegulatorChildNodeAdd fail!");
             (void)OsalMutexUnlock(&manager->lock);
-            HDF_LOGI("RegulatorTreeSetChild: set %s child success!", name);
-            return HDF_SUCCESS;
+            return HDF_FAILURE;
         }
+        (void)OsalMutexUnlock(&manager->lock);
+        HDF_LOGI("RegulatorTreeSetChild: set %s child success!", name);
+        return HDF_SUCCESS;
     }
 
     (void)OsalMutexUnlock(&manager->lock);
@@ -396,6 +478,7 @@ int RegulatorTreeNodeRemoveAll(void)
 
     DLIST_FOR_EACH_ENTRY_SAFE(nodeInfo, tmp, &manager->treeMgrHead, struct RegulatorTreeInfo, node) {
         RegulatorChildListDestroy(nodeInfo);
+        DListRemove(&nodeInfo->hashNode);
         DListRemove(&nodeInfo->node);
         OsalMemFree(nodeInfo);
     }
@@ -420,6 +503,7 @@ int RegulatorTreeManagerDestory(void)
 
 int RegulatorTreeManagerInit(void)
 {
+    uint32_t i;
     struct RegulatorTreeManager *manager =
         (struct RegulatorTreeManager *)OsalMemCalloc(sizeof(struct RegulatorTreeManager));
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
@@ -431,6 +515,9 @@ int RegulatorTreeManagerInit(void)
     }
 
     DListHeadInit(&manager->treeMgrHead);
+    for (i = 0; i < REGULATOR_HASH_BUCKETS; i++) {
+        DListHeadInit(&manager->hashHead[i]);
+    }
     g_regulatorTreeManager = manager;
     return HDF_SUCCESS;
 }
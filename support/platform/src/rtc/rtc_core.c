@@ -9,6 +9,8 @@
 #include "rtc_core.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "platform_core.h"
+#include "rtc_base.h"
 #include "rtc_if.h"
 
 #define HDF_LOG_TAG rtc_core_c
@@ -178,6 +180,130 @@ int32_t RtcHostWriteReg(struct RtcHost *host, uint8_t usrDefIndex, uint8_t value
     return host->method->WriteReg(host, usrDefIndex, value);
 }
 
+uint64_t RtcHostMonoTimeUs(void)
+{
+    return PlatformMonoTimeUs();
+}
+
+static int32_t RtcHostBracketReadTime(struct RtcHost *host, struct RtcTimeSync *sync)
+{
+    int32_t ret;
+    uint64_t before;
+    uint64_t after;
+
+    before = RtcHostMonoTimeUs();
+    ret = host->method->ReadTime(host, &sync->time);
+    after = RtcHostMonoTimeUs();
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    // the rtc was sampled somewhere in between, so the middle is off by at most half the window
+    sync->monoUs = before + (after - before) / 2;
+    sync->errorUs = (uint32_t)((after - before + 1) / 2);
+    return HDF_SUCCESS;
+}
+
+int32_t RtcHostReadTimeSync(struct RtcHost *host, struct RtcTimeSync *sync)
+{
+    int32_t ret;
+
+    if (host == NULL || sync == NULL) {
+        HDF_LOGE("%s: host or sync is NULL!", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (host->method == NULL || (host->method->ReadTimeSync == NULL && host->method->ReadTime == NULL)) {
+        HDF_LOGE("%s: method or ReadTime is NULL", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    (void)OsalMutexLock(&host->lock);
+    if (host->method->ReadTimeSync != NULL) {
+        ret = host->method->ReadTimeSync(host, sync);
+    } else {
+        ret = RtcHostBracketReadTime(host, sync);
+    }
+    (void)OsalMutexUnlock(&host->lock);
+    return ret;
+}
+
+static int32_t RtcHostAlarmGroupCheck(const struct RtcAlarmItem *items, uint32_t count)
+{
+    uint32_t i;
+    uint32_t j;
+
+    if (count == 0 || count > RTC_ALARM_GROUP_MAX) {
+        HDF_LOGE("%s: invalid count:%u", __func__, count);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (RtcIsInvalid(&items[i].time) == RTC_TRUE) {
+            HDF_LOGE("%s: time of alarm %d invalid", __func__, items[i].alarmIndex);
+            return HDF_ERR_INVALID_PARAM;
+        }
+        for (j = 0; j < i; j++) {
+            if (items[j].alarmIndex == items[i].alarmIndex) {
+                HDF_LOGE("%s: alarm %d duplicated", __func__, items[i].alarmIndex);
+                return HDF_ERR_INVALID_PARAM;
+            }
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t RtcHostWriteAlarmEach(struct RtcHost *host, struct RtcAlarmItem *items, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        ret = host->method->WriteAlarm(host, items[i].alarmIndex, &items[i].time);
+        if (ret == HDF_SUCCESS) {
+            ret = RtcHostAlarmInterruptEnable(host, items[i].alarmIndex, items[i].enable);
+        }
+        items[i].ret = ret;
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: program alarm %d fail, ret: %d", __func__, items[i].alarmIndex, ret);
+            return ret;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t RtcHostWriteAlarmGroup(struct RtcHost *host, struct RtcAlarmItem *items, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+
+    if (host == NULL || items == NULL) {
+        HDF_LOGE("%s: host or items is NULL!", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (host->method == NULL || (host->method->WriteAlarmGroup == NULL && host->method->WriteAlarm == NULL)) {
+        HDF_LOGE("%s: method or WriteAlarm is NULL", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    for (i = 0; i < count && i < RTC_ALARM_GROUP_MAX; i++) {
+        items[i].ret = HDF_FAILURE;
+    }
+    ret = RtcHostAlarmGroupCheck(items, count);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    (void)OsalMutexLock(&host->lock);
+    if (host->method->WriteAlarmGroup != NULL) {
+        ret = host->method->WriteAlarmGroup(host, items, count);
+    } else {
+        ret = RtcHostWriteAlarmEach(host, items, count);
+    }
+    (void)OsalMutexUnlock(&host->lock);
+    return ret;
+}
+
 struct RtcHost *RtcHostCreate(struct HdfDeviceObject *device)
 {
     struct RtcHost *host = NULL;
@@ -193,6 +319,12 @@ struct RtcHost *RtcHostCreate(struct HdfDeviceObject *device)
         return NULL;
     }
 
+    if (OsalMutexInit(&host->lock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init lock fail!", __func__);
+        OsalMemFree(host);
+        return NULL;
+    }
+
     host->device = device;
     device->service = &(host->service);
     host->method = NULL;
@@ -204,6 +336,7 @@ struct RtcHost *RtcHostCreate(struct HdfDeviceObject *device)
 void RtcHostDestroy(struct RtcHost *host)
 {
     if (host != NULL) {
+        (void)OsalMutexDestroy(&host->lock);
         host->device = NULL;
         host->method = NULL;
         host->data = NULL;
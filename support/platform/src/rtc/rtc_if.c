@@ -152,4 +152,24 @@ int32_t RtcWriteReg(DevHandle handle, uint8_t usrDefIndex, uint8_t value)
     }
 
     return RtcHostWriteReg((struct RtcHost *)handle, usrDefIndex, value);
-}
\ No newline at end of file
+}
+
+int32_t RtcReadTimeSync(DevHandle handle, struct RtcTimeSync *sync)
+{
+    if (handle == NULL || sync == NULL) {
+        HDF_LOGE("%s: handle or sync is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    return RtcHostReadTimeSync((struct RtcHost *)handle, sync);
+}
+
+int32_t RtcWriteAlarmGroup(DevHandle handle, struct RtcAlarmItem *items, uint32_t count)
+{
+    if (handle == NULL || items == NULL) {
+        HDF_LOGE("%s: handle or items is null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    return RtcHostWriteAlarmGroup((struct RtcHost *)handle, items, count);
+}
@@ -11,6 +11,7 @@
 #include "hdf_log.h"
 #include "hdf_sbuf.h"
 #include "osal_mem.h"
+#include "platform_user_sbuf.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG rtc_if_u_c
@@ -54,6 +55,7 @@ int32_t RtcReadTime(DevHandle handle, struct RtcTime *time)
     int32_t ret;
     uint32_t len = 0;
     struct RtcHost *host = NULL;
+    struct HdfSBuf *data = NULL;
     struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
     struct RtcTime *temp = NULL;
@@ -65,9 +67,8 @@ int32_t RtcReadTime(DevHandle handle, struct RtcTime *time)
 
     host = (struct RtcHost *)handle;
 
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: fail to obtain reply!", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
@@ -103,7 +104,6 @@ int32_t RtcReadTime(DevHandle handle, struct RtcTime *time)
     }
 
 EXIT:
-    HdfSbufRecycle(reply);
     return ret;
 }
 
@@ -112,6 +112,7 @@ int32_t RtcWriteTime(DevHandle handle, const struct RtcTime *time)
     int32_t ret;
     struct RtcHost *host = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
     if (handle == NULL || time == NULL) {
@@ -121,33 +122,28 @@ int32_t RtcWriteTime(DevHandle handle, const struct RtcTime *time)
 
     host = (struct RtcHost *)handle;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteBuffer(data, time, sizeof(*time))) {
         HDF_LOGE("%s: write rtc time fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     service = (struct HdfIoService *)host;
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: service is invalid", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, RTC_IO_WRITETIME, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: fail, ret is %d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
 
@@ -168,16 +164,8 @@ int32_t RtcReadAlarm(DevHandle handle, enum RtcAlarmIndex alarmIndex, struct Rtc
 
     host = (struct RtcHost *)handle;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
-        return HDF_ERR_MALLOC_FAIL;
-    }
-
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: fail to obtain reply!", __func__);
-        HdfSbufRecycle(data);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
@@ -219,8 +207,6 @@ int32_t RtcReadAlarm(DevHandle handle, enum RtcAlarmIndex alarmIndex, struct Rtc
     }
 
 EXIT:
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
     return ret;
 }
 
@@ -229,6 +215,7 @@ int32_t RtcWriteAlarm(DevHandle handle, enum RtcAlarmIndex alarmIndex, const str
     int32_t ret;
     struct RtcHost *host = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
     if (handle == NULL || time == NULL) {
@@ -238,39 +225,33 @@ int32_t RtcWriteAlarm(DevHandle handle, enum RtcAlarmIndex alarmIndex, const str
 
     host = (struct RtcHost *)handle;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint32(data, (uint32_t)alarmIndex)) {
         HDF_LOGE("%s: write rtc time fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     if (!HdfSbufWriteBuffer(data, time, sizeof(*time))) {
         HDF_LOGE("%s: write rtc time fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     service = (struct HdfIoService *)host;
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: service is invalid", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, RTC_IO_WRITEALARM, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: fail, ret is %d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
 
@@ -290,6 +271,7 @@ int32_t RtcAlarmInterruptEnable(DevHandle handle, enum RtcAlarmIndex alarmIndex,
     int32_t ret;
     struct RtcHost *host = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
     if (handle == NULL) {
@@ -299,39 +281,33 @@ int32_t RtcAlarmInterruptEnable(DevHandle handle, enum RtcAlarmIndex alarmIndex,
 
     host = (struct RtcHost *)handle;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint32(data, (uint32_t)alarmIndex)) {
         HDF_LOGE("%s: write alarmIndex fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     if (!HdfSbufWriteUint8(data, enable)) {
         HDF_LOGE("%s: write enable fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     service = (struct HdfIoService *)host;
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: service is invalid", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, RTC_IO_ALARMINTERRUPTENABLE, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: fail, ret is %d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
 
@@ -339,6 +315,7 @@ int32_t RtcGetFreq(DevHandle handle, uint32_t *freq)
 {
     int32_t ret;
     struct RtcHost *host = NULL;
+    struct HdfSBuf *data = NULL;
     struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
@@ -349,9 +326,8 @@ int32_t RtcGetFreq(DevHandle handle, uint32_t *freq)
 
     host = (struct RtcHost *)handle;
 
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
@@ -374,7 +350,6 @@ int32_t RtcGetFreq(DevHandle handle, uint32_t *freq)
     }
 
 EXIT:
-    HdfSbufRecycle(reply);
     return ret;
 }
 
@@ -383,6 +358,7 @@ int32_t RtcSetFreq(DevHandle handle, uint32_t freq)
     int32_t ret;
     struct RtcHost *host = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
     if (handle == NULL) {
@@ -392,33 +368,28 @@ int32_t RtcSetFreq(DevHandle handle, uint32_t freq)
 
     host = (struct RtcHost *)handle;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint32(data, freq)) {
         HDF_LOGE("%s: write freq fail", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     service = (struct HdfIoService *)host;
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: service is invalid", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, RTC_IO_SETFREQ, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: fail, ret is %d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
 
@@ -465,16 +436,8 @@ int32_t RtcReadReg(DevHandle handle, uint8_t usrDefIndex, uint8_t *value)
 
     host = (struct RtcHost *)handle;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
-        return HDF_ERR_MALLOC_FAIL;
-    }
-
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: fail to obtain reply!", __func__);
-        HdfSbufRecycle(data);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
@@ -504,8 +467,6 @@ int32_t RtcReadReg(DevHandle handle, uint8_t usrDefIndex, uint8_t *value)
     }
 
 EXIT:
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
     return ret;
 }
 
@@ -514,6 +475,7 @@ int32_t RtcWriteReg(DevHandle handle, uint8_t usrDefIndex, uint8_t value)
     int32_t ret;
     struct RtcHost *host = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
     struct HdfIoService *service = NULL;
 
     if (handle == NULL) {
@@ -523,38 +485,131 @@ int32_t RtcWriteReg(DevHandle handle, uint8_t usrDefIndex, uint8_t value)
 
     host = (struct RtcHost *)handle;
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: fail to obtain data", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     if (!HdfSbufWriteUint8(data, usrDefIndex)) {
         HDF_LOGE("%s: write usrDefIndex fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     if (!HdfSbufWriteUint8(data, value)) {
         HDF_LOGE("%s: write value fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_IO;
     }
 
     service = (struct HdfIoService *)host;
     if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
         HDF_LOGE("%s: service is invalid", __func__);
-        HdfSbufRecycle(data);
         return HDF_ERR_MALLOC_FAIL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, RTC_IO_WRITEREG, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: fail, ret is %d", __func__, ret);
-        HdfSbufRecycle(data);
         return ret;
     }
 
-    HdfSbufRecycle(data);
     return HDF_SUCCESS;
 }
+
+int32_t RtcReadTimeSync(DevHandle handle, struct RtcTimeSync *sync)
+{
+    int32_t ret;
+    uint32_t len = 0;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+    struct RtcTimeSync *temp = NULL;
+    struct HdfIoService *service = NULL;
+
+    if (handle == NULL || sync == NULL) {
+        HDF_LOGE("%s: handle or sync is NULL.", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    service = (struct HdfIoService *)handle;
+    if (service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: service is invalid", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, RTC_IO_READTIME_SYNC, NULL, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail, ret is %d", __func__, ret);
+        return ret;
+    }
+
+    if (!HdfSbufReadBuffer(reply, (const void **)&temp, &len) || temp == NULL || len != sizeof(*sync)) {
+        HDF_LOGE("%s: read buffer fail, len: %u", __func__, len);
+        return HDF_ERR_IO;
+    }
+
+    if (memcpy_s(sync, sizeof(*sync), temp, len) != EOK) {
+        HDF_LOGE("%s: memcpy sync fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    return HDF_SUCCESS;
+}
+
+int32_t RtcWriteAlarmGroup(DevHandle handle, struct RtcAlarmItem *items, uint32_t count)
+{
+    int32_t ret;
+    uint32_t len = 0;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+    const struct RtcAlarmItem *results = NULL;
+    struct HdfIoService *service = NULL;
+
+    if (handle == NULL || items == NULL) {
+        HDF_LOGE("%s: handle or items is NULL.", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (count == 0 || count > RTC_ALARM_GROUP_MAX) {
+        HDF_LOGE("%s: invalid count:%u", __func__, count);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    service = (struct HdfIoService *)handle;
+    if (service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        HDF_LOGE("%s: service is invalid", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    if (!HdfSbufWriteBuffer(data, items, sizeof(*items) * count)) {
+        HDF_LOGE("%s: write items fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, RTC_IO_WRITEALARM_GROUP, data, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail, ret is %d", __func__, ret);
+        return ret;
+    }
+
+    if (!HdfSbufReadInt32(reply, &ret) || !HdfSbufReadBuffer(reply, (const void **)&results, &len) ||
+        results == NULL || len != sizeof(*items) * count) {
+        HDF_LOGE("%s: read reply fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    if (memcpy_s(items, sizeof(*items) * count, results, len) != EOK) {
+        HDF_LOGE("%s: memcpy items fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    return ret;
+}
@@ -11,6 +11,7 @@
 #include "osal_mem.h"
 #include "rtc_core.h"
 #include "rtc_if.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG rtc_service_c
 
@@ -237,6 +238,54 @@ static int32_t RtcServiceIoWriteReg(struct RtcHost *host, struct HdfSBuf *data)
     return HDF_SUCCESS;
 }
 
+static int32_t RtcServiceIoReadTimeSync(struct RtcHost *host, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    struct RtcTimeSync sync;
+
+    ret = RtcHostReadTimeSync(host, &sync);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: host read time sync fail! ret :%d", __func__, ret);
+        return ret;
+    }
+
+    if (!HdfSbufWriteBuffer(reply, &sync, sizeof(sync))) {
+        HDF_LOGE("%s: write buffer fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    return HDF_SUCCESS;
+}
+
+static int32_t RtcServiceIoWriteAlarmGroup(struct RtcHost *host, struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint32_t len;
+    uint32_t count;
+    const struct RtcAlarmItem *buf = NULL;
+    struct RtcAlarmItem items[RTC_ALARM_GROUP_MAX];
+
+    if (!HdfSbufReadBuffer(data, (const void **)&buf, &len) || buf == NULL ||
+        len % sizeof(*buf) != 0 || len > sizeof(items)) {
+        HDF_LOGE("%s: read buffer fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    count = len / sizeof(*buf);
+    if (memcpy_s(items, sizeof(items), buf, len) != EOK) {
+        HDF_LOGE("%s: memcpy items fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    // the result travels in the reply, so the per alarm results are not lost when the group fails
+    ret = RtcHostWriteAlarmGroup(host, items, count);
+    if (!HdfSbufWriteInt32(reply, ret) || !HdfSbufWriteBuffer(reply, items, len)) {
+        HDF_LOGE("%s: write reply fail!", __func__);
+        return HDF_ERR_IO;
+    }
+
+    return HDF_SUCCESS;
+}
+
 int32_t RtcIoDispatch(struct HdfDeviceIoClient *client, int cmd, struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     struct RtcHost *host = NULL;
@@ -281,6 +330,10 @@ int32_t RtcIoDispatch(struct HdfDeviceIoClient *client, int cmd, struct HdfSBuf
             return RtcServiceIoReadReg(host, data, reply);
         case RTC_IO_WRITEREG:
             return RtcServiceIoWriteReg(host, data);
+        case RTC_IO_READTIME_SYNC:
+            return RtcServiceIoReadTimeSync(host, reply);
+        case RTC_IO_WRITEALARM_GROUP:
+            return RtcServiceIoWriteAlarmGroup(host, data, reply);
         default:
             return HDF_ERR_NOT_SUPPORT;
     }
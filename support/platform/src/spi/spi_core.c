@@ -9,9 +9,13 @@
 #include "spi_core.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_time.h"
+#include "platform_errno.h"
+#include "securec.h"
 #include "spi_if.h"
 
 #define HDF_LOG_TAG spi_core
+#define SPI_STOP_WAIT_MS     10
 
 int32_t SpiCntlrOpen(struct SpiCntlr *cntlr, uint32_t csNum)
 {
@@ -25,10 +29,10 @@ int32_t SpiCntlrOpen(struct SpiCntlr *cntlr, uint32_t csNum)
         HDF_LOGE("%s: Open not support", __func__);
         return HDF_ERR_NOT_SUPPORT;
     }
-    (void)OsalMutexLock(&(cntlr->lock));
+    (void)PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
     cntlr->curCs = csNum;
     ret = cntlr->method->Open(cntlr);
-    (void)OsalMutexUnlock(&(cntlr->lock));
+    PlatformArbiterRelease(&cntlr->arbiter);
     return ret;
 }
 
@@ -44,10 +48,10 @@ int32_t SpiCntlrClose(struct SpiCntlr *cntlr, uint32_t csNum)
         HDF_LOGE("%s: Close not support", __func__);
         return HDF_ERR_NOT_SUPPORT;
     }
-    (void)OsalMutexLock(&(cntlr->lock));
+    (void)PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
     cntlr->curCs = csNum;
     ret = cntlr->method->Close(cntlr);
-    (void)OsalMutexUnlock(&(cntlr->lock));
+    PlatformArbiterRelease(&cntlr->arbiter);
     return ret;
 }
 
@@ -64,13 +68,250 @@ int32_t SpiCntlrTransfer(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiMsg *
         return HDF_ERR_NOT_SUPPORT;
     }
 
-    (void)OsalMutexLock(&(cntlr->lock));
+    (void)PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
     cntlr->curCs = csNum;
     ret = cntlr->method->Transfer(cntlr, msg, count);
+    PlatformArbiterRelease(&cntlr->arbiter);
+    return ret;
+}
+
+/* a segment ends with the first msg releasing the cs, or with the last msg */
+static uint32_t SpiMsgSegmentLen(const struct SpiMsg *msgs, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i + 1 < count; i++) {
+        if (msgs[i].csChange != 0) {
+            break;
+        }
+    }
+    return i + 1;
+}
+
+int32_t SpiCntlrTransferPrio(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiMsg *msgs, uint32_t count,
+    uint32_t prio)
+{
+    int32_t ret;
+    uint32_t seg;
+    uint32_t done = 0;
+
+    if (cntlr == NULL || msgs == NULL || count == 0) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cntlr->method == NULL || cntlr->method->Transfer == NULL) {
+        HDF_LOGE("%s: transfer not support", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    ret = PlatformArbiterAcquire(&cntlr->arbiter, prio, HDF_WAIT_FOREVER);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: acquire cntlr fail, ret:%d", __func__, ret);
+        return ret;
+    }
+    cntlr->curCs = csNum;
+    while (done < count) {
+        seg = count - done;
+        /* split at the cs changes only while a caller of higher priority is waiting for the bus */
+        if (PlatformArbiterHasHigherWaiter(&cntlr->arbiter)) {
+            seg = SpiMsgSegmentLen(msgs + done, seg);
+        }
+        ret = cntlr->method->Transfer(cntlr, msgs + done, seg);
+        done += seg;
+        if (ret != HDF_SUCCESS || done == count) {
+            break;
+        }
+        /* the cs is released here, so a caller of higher priority may take the bus and select another cs */
+        if (PlatformArbiterYield(&cntlr->arbiter)) {
+            cntlr->curCs = csNum;
+        }
+    }
+    PlatformArbiterRelease(&cntlr->arbiter);
+    return ret;
+}
+
+int32_t SpiCntlrGetArbiterStat(struct SpiCntlr *cntlr, struct PlatformArbiterStat *stat)
+{
+    if (cntlr == NULL) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return PlatformArbiterGetStat(&cntlr->arbiter, stat);
+}
+
+static int32_t SpiCntlrPrepareSgMsgs(struct SpiCntlr *cntlr, struct SpiSgMsg *msgs, uint32_t count,
+    uint32_t *total)
+{
+    uint32_t i;
+    uint32_t num = 0;
+    struct SpiMsg *sgMsgs = NULL;
+
+    for (i = 0; i < count; i++) {
+        if (msgs[i].segs == NULL || msgs[i].segNum == 0) {
+            HDF_LOGE("%s: msg[%u] has no segment", __func__, i);
+            return HDF_ERR_INVALID_PARAM;
+        }
+        num += msgs[i].segNum;
+    }
+    if (num > cntlr->sgMsgNum) {
+        sgMsgs = (struct SpiMsg *)OsalMemCalloc(sizeof(*sgMsgs) * num);
+        if (sgMsgs == NULL) {
+            HDF_LOGE("%s: alloc sg msgs fail", __func__);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        OsalMemFree(cntlr->sgMsgs);
+        cntlr->sgMsgs = sgMsgs;
+        cntlr->sgMsgNum = num;
+    }
+    *total = num;
+    return HDF_SUCCESS;
+}
+
+static int32_t SpiCntlrTransferSgByMsgs(struct SpiCntlr *cntlr, struct SpiSgMsg *msgs, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t j;
+    uint32_t total;
+    struct SpiMsg *msg = NULL;
+
+    ret = SpiCntlrPrepareSgMsgs(cntlr, msgs, count, &total);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    msg = cntlr->sgMsgs;
+    for (i = 0; i < count; i++) {
+        for (j = 0; j < msgs[i].segNum; j++, msg++) {
+            msg->wbuf = msgs[i].segs[j].wbuf;
+            msg->rbuf = msgs[i].segs[j].rbuf;
+            msg->len = msgs[i].segs[j].len;
+            msg->speed = msgs[i].speed;
+            /* keep the cs active between the segments of one msg */
+            msg->delayUs = 0;
+            msg->csChange = 0;
+        }
+        (msg - 1)->delayUs = msgs[i].delayUs;
+        (msg - 1)->csChange = msgs[i].csChange;
+    }
+    return cntlr->method->Transfer(cntlr, cntlr->sgMsgs, total);
+}
+
+int32_t SpiCntlrTransferSg(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiSgMsg *msgs, uint32_t count)
+{
+    int32_t ret;
+
+    if (cntlr == NULL || msgs == NULL || count == 0) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (cntlr->method == NULL || (cntlr->method->TransferSg == NULL && cntlr->method->Transfer == NULL)) {
+        HDF_LOGE("%s: transfer not support", __func__);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    (void)PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
+    cntlr->curCs = csNum;
+    if (cntlr->method->TransferSg != NULL) {
+        ret = cntlr->method->TransferSg(cntlr, msgs, count);
+    } else {
+        ret = SpiCntlrTransferSgByMsgs(cntlr, msgs, count);
+    }
+    PlatformArbiterRelease(&cntlr->arbiter);
+    return ret;
+}
+
+static int32_t SpiCntlrQueueHandle(struct PlatformQueue *queue, struct PlatformMsg *msg)
+{
+    int32_t ret;
+    bool stopping = false;
+    struct SpiTransferReq *req = (struct SpiTransferReq *)msg;
+    struct SpiCntlr *cntlr = req->cntlr;
+
+    (void)queue;
+    (void)OsalMutexLock(&(cntlr->lock));
+    stopping = cntlr->stopping;
     (void)OsalMutexUnlock(&(cntlr->lock));
+
+    ret = stopping ? HDF_PLT_ERR_NO_DEV : SpiCntlrTransferSg(cntlr, req->csNum, req->msgs, req->count);
+    if (req->callback != NULL) {
+        req->callback(req->msgs, req->count, ret, req->priv);
+    }
+    OsalMemFree(req);
+    /* the last access to cntlr, it may be destroyed right after this */
+    (void)OsalAtomicDec(&cntlr->pending);
     return ret;
 }
 
+static int32_t SpiCntlrQueueInit(struct SpiCntlr *cntlr)
+{
+    int32_t ret;
+    struct PlatformQueue *queue = NULL;
+
+    if (cntlr->queue != NULL) {
+        return HDF_SUCCESS;
+    }
+    if (snprintf_s(cntlr->queueName, sizeof(cntlr->queueName), sizeof(cntlr->queueName) - 1,
+        "spi_queue_%u", cntlr->busNum) < 0) {
+        HDF_LOGE("%s: format queue name fail", __func__);
+        return HDF_FAILURE;
+    }
+    queue = PlatformQueueCreate(SpiCntlrQueueHandle, cntlr->queueName, cntlr);
+    if (queue == NULL) {
+        HDF_LOGE("%s: create queue fail", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    ret = PlatformQueueStart(queue);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start queue fail:%d", __func__, ret);
+        PlatformQueueDestroy(queue);
+        return ret;
+    }
+    cntlr->queue = queue;
+    return HDF_SUCCESS;
+}
+
+int32_t SpiCntlrTransferAsync(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiSgMsg *msgs, uint32_t count,
+    SpiTransferCallback callback, void *priv)
+{
+    int32_t ret;
+    struct SpiTransferReq *req = NULL;
+
+    if (cntlr == NULL || msgs == NULL || count == 0) {
+        HDF_LOGE("%s: invalid parameter", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    req = (struct SpiTransferReq *)OsalMemCalloc(sizeof(*req));
+    if (req == NULL) {
+        HDF_LOGE("%s: alloc req fail", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    req->cntlr = cntlr;
+    req->csNum = csNum;
+    req->msgs = msgs;
+    req->count = count;
+    req->callback = callback;
+    req->priv = priv;
+
+    (void)OsalMutexLock(&(cntlr->lock));
+    if (cntlr->stopping) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        OsalMemFree(req);
+        return HDF_PLT_ERR_NO_DEV;
+    }
+    ret = SpiCntlrQueueInit(cntlr);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalMutexUnlock(&(cntlr->lock));
+        OsalMemFree(req);
+        return ret;
+    }
+    (void)OsalAtomicInc(&cntlr->pending);
+    (void)PlatformQueueAddMsg(cntlr->queue, &req->msg);
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    return HDF_SUCCESS;
+}
+
 int32_t SpiCntlrSetCfg(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiCfg *cfg)
 {
     int32_t ret;
@@ -85,10 +326,10 @@ int32_t SpiCntlrSetCfg(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiCfg *cf
         return HDF_ERR_NOT_SUPPORT;
     }
 
-    (void)OsalMutexLock(&(cntlr->lock));
+    (void)PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
     cntlr->curCs = csNum;
     ret = cntlr->method->SetCfg(cntlr, cfg);
-    (void)OsalMutexUnlock(&(cntlr->lock));
+    PlatformArbiterRelease(&cntlr->arbiter);
     return ret;
 }
 
@@ -106,10 +347,10 @@ int32_t SpiCntlrGetCfg(struct SpiCntlr *cntlr, uint32_t csNum, struct SpiCfg *cf
         return HDF_ERR_NOT_SUPPORT;
     }
 
-    (void)OsalMutexLock(&(cntlr->lock));
+    (void)PlatformArbiterAcquire(&cntlr->arbiter, PLATFORM_PRIORITY_NORMAL, HDF_WAIT_FOREVER);
     cntlr->curCs = csNum;
     ret = cntlr->method->GetCfg(cntlr, cfg);
-    (void)OsalMutexUnlock(&(cntlr->lock));
+    PlatformArbiterRelease(&cntlr->arbiter);
     return ret;
 }
 
@@ -299,6 +540,20 @@ void SpiCntlrDestroy(struct SpiCntlr *cntlr)
     if (cntlr == NULL) {
         return;
     }
+    (void)OsalMutexLock(&(cntlr->lock));
+    cntlr->stopping = true;
+    (void)OsalMutexUnlock(&(cntlr->lock));
+    /* queued transfers complete with HDF_PLT_ERR_NO_DEV */
+    while (OsalAtomicRead(&cntlr->pending) > 0) {
+        OsalMSleep(SPI_STOP_WAIT_MS);
+    }
+    if (cntlr->queue != NULL) {
+        PlatformQueueDestroy(cntlr->queue);
+        cntlr->queue = NULL;
+    }
+    OsalMemFree(cntlr->sgMsgs);
+    cntlr->sgMsgs = NULL;
+    PlatformArbiterUninit(&cntlr->arbiter);
     (void)OsalMutexDestroy(&(cntlr->lock));
     OsalMemFree(cntlr);
 }
@@ -317,6 +572,11 @@ struct SpiCntlr *SpiCntlrCreate(struct HdfDeviceObject *device)
         HDF_LOGE("%s: OsalMemCalloc error", __func__);
         return NULL;
     }
+    if (PlatformArbiterInit(&cntlr->arbiter) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init arbiter fail", __func__);
+        OsalMemFree(cntlr);
+        return NULL;
+    }
     cntlr->device = device;
     device->service = &(cntlr->service);
     device->service->Dispatch = SpiIoDispatch;
@@ -53,6 +53,40 @@ int32_t SpiTransfer(DevHandle handle, struct SpiMsg *msgs, uint32_t count)
     return SpiCntlrTransfer(obj->cntlr, obj->csNum, msgs, count);
 }
 
+int32_t SpiTransferSg(DevHandle handle, struct SpiSgMsg *msgs, uint32_t count)
+{
+    struct SpiObject *obj = NULL;
+
+    if (handle == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    obj = (struct SpiObject *)handle;
+    return SpiCntlrTransferSg(obj->cntlr, obj->csNum, msgs, count);
+}
+
+int32_t SpiTransferAsync(DevHandle handle, struct SpiSgMsg *msgs, uint32_t count,
+    SpiTransferCallback callback, void *priv)
+{
+    struct SpiObject *obj = NULL;
+
+    if (handle == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    obj = (struct SpiObject *)handle;
+    return SpiCntlrTransferAsync(obj->cntlr, obj->csNum, msgs, count, callback, priv);
+}
+
+int32_t SpiTransferPrio(DevHandle handle, struct SpiMsg *msgs, uint32_t count, enum PlatformPriority prio)
+{
+    struct SpiObject *obj = NULL;
+
+    if (handle == NULL || prio >= PLATFORM_PRIORITY_NUM) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    obj = (struct SpiObject *)handle;
+    return SpiCntlrTransferPrio(obj->cntlr, obj->csNum, msgs, count, (uint32_t)prio);
+}
+
 int32_t SpiRead(DevHandle handle, uint8_t *buf, uint32_t len)
 {
     struct SpiMsg msg = {0};
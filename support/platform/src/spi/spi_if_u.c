@@ -175,6 +175,48 @@ EXIT:
     return ret;
 }
 
+int32_t SpiTransferSg(DevHandle handle, struct SpiSgMsg *msgs, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t j;
+    uint32_t total = 0;
+    struct SpiMsg *flat = NULL;
+    struct SpiMsg *msg = NULL;
+
+    if (handle == NULL || msgs == NULL || count == 0) {
+        HDF_LOGE("%s: invalid handle or msgs", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    for (i = 0; i < count; i++) {
+        if (msgs[i].segs == NULL || msgs[i].segNum == 0) {
+            HDF_LOGE("%s: msg[%u] has no segment", __func__, i);
+            return HDF_ERR_INVALID_PARAM;
+        }
+        total += msgs[i].segNum;
+    }
+
+    /* segments are gathered straight into the service sbuf, so no bounce buffer is needed here */
+    flat = (struct SpiMsg *)OsalMemCalloc(sizeof(*flat) * total);
+    if (flat == NULL) {
+        HDF_LOGE("%s: failed to alloc msgs!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    for (i = 0, msg = flat; i < count; i++) {
+        for (j = 0; j < msgs[i].segNum; j++, msg++) {
+            msg->wbuf = msgs[i].segs[j].wbuf;
+            msg->rbuf = msgs[i].segs[j].rbuf;
+            msg->len = msgs[i].segs[j].len;
+            msg->speed = msgs[i].speed;
+        }
+        (msg - 1)->delayUs = msgs[i].delayUs;
+        (msg - 1)->csChange = msgs[i].csChange;
+    }
+    ret = SpiTransfer(handle, flat, total);
+    OsalMemFree(flat);
+    return ret;
+}
+
 int32_t SpiRead(DevHandle handle, uint8_t *buf, uint32_t len)
 {
     struct SpiMsg msg = {0};
@@ -9,21 +9,142 @@
 #include "timer_core.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
-#include "osal_time.h"
+#include "platform_core.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG timer_core
 
+#define TIMER_HASH_BUCKETS    16
+
 struct TimerManager {
     struct IDeviceIoService service;
     struct HdfDeviceObject *device;
     struct DListHead timerListHead;
+    struct DListHead hashHead[TIMER_HASH_BUCKETS];   /* the same controllers, keyed by number */
     struct OsalMutex lock;
 };
 
 static struct TimerManager *g_timerManager = NULL;
+static struct TimerCntrl *g_timerSlots[TIMER_EVENT_SLOT_NUM];
 #define TIMER_HANDLE_SHIFT    ((uintptr_t)(-1) << 16)
 
+// called in the timer interrupt
+static int32_t TimerCntrlExpire(struct TimerCntrl *cntrl)
+{
+    bool wake;
+    uint32_t flags;
+    TimerHandleCb cb;
+
+    if (cntrl == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    (void)OsalSpinLockIrqSave(&cntrl->event.spin, &flags);
+    cntrl->event.pending++;
+    cntrl->event.lastUs = PlatformMonoTimeUs();
+    wake = cntrl->event.waiting;
+    cntrl->event.waiting = false;
+    (void)OsalSpinUnlockIrqRestore(&cntrl->event.spin, &flags);
+    if (wake) {
+        (void)OsalSemPost(&cntrl->event.sem);
+    }
+
+    cb = cntrl->event.clientCb;
+    return (cb != NULL) ? cb() : HDF_SUCCESS;
+}
+
+#define TIMER_SLOT_CB(n) \
+static int32_t TimerSlotCb##n(void) \
+{ \
+    return TimerCntrlExpire(g_timerSlots[n]); \
+}
+
+TIMER_SLOT_CB(0)
+TIMER_SLOT_CB(1)
+TIMER_SLOT_CB(2)
+TIMER_SLOT_CB(3)
+TIMER_SLOT_CB(4)
+TIMER_SLOT_CB(5)
+TIMER_SLOT_CB(6)
+TIMER_SLOT_CB(7)
+TIMER_SLOT_CB(8)
+TIMER_SLOT_CB(9)
+TIMER_SLOT_CB(10)
+TIMER_SLOT_CB(11)
+TIMER_SLOT_CB(12)
+TIMER_SLOT_CB(13)
+TIMER_SLOT_CB(14)
+TIMER_SLOT_CB(15)
+
+static const TimerHandleCb g_timerSlotCb[TIMER_EVENT_SLOT_NUM] = {
+    TimerSlotCb0, TimerSlotCb1, TimerSlotCb2, TimerSlotCb3,
+    TimerSlotCb4, TimerSlotCb5, TimerSlotCb6, TimerSlotCb7,
+    TimerSlotCb8, TimerSlotCb9, TimerSlotCb10, TimerSlotCb11,
+    TimerSlotCb12, TimerSlotCb13, TimerSlotCb14, TimerSlotCb15,
+};
+
+// caller holds the cntrl lock; returns the callback to hand to the driver
+static TimerHandleCb TimerCntrlArm(struct TimerCntrl *cntrl, TimerHandleCb cb)
+{
+    uint32_t flags;
+
+    (void)OsalSpinLockIrqSave(&cntrl->event.spin, &flags);
+    cntrl->event.pending = 0;
+    cntrl->event.clientCb = cb;
+    (void)OsalSpinUnlockIrqRestore(&cntrl->event.spin, &flags);
+    return (cntrl->event.slot >= 0) ? g_timerSlotCb[cntrl->event.slot] : cb;
+}
+
+// caller holds manager->lock
+static int32_t TimerCntrlEventInit(struct TimerCntrl *cntrl)
+{
+    int16_t i;
+
+    if (OsalSpinInit(&cntrl->event.spin) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    if (OsalSemInit(&cntrl->event.sem, 0) != HDF_SUCCESS) {
+        (void)OsalSpinDestroy(&cntrl->event.spin);
+        return HDF_FAILURE;
+    }
+    cntrl->event.pending = 0;
+    cntrl->event.waiting = false;
+    cntrl->event.clientCb = NULL;
+    cntrl->event.slot = -1;
+    for (i = 0; i < TIMER_EVENT_SLOT_NUM; i++) {
+        if (g_timerSlots[i] == NULL) {
+            g_timerSlots[i] = cntrl;
+            cntrl->event.slot = i;
+            return HDF_SUCCESS;
+        }
+    }
+    HDF_LOGW("%s: no event slot for timer %u, it can not be waited on", __func__, cntrl->info.number);
+    return HDF_SUCCESS;
+}
+
+// caller holds manager->lock
+static void TimerCntrlEventUninit(struct TimerCntrl *cntrl)
+{
+    if (cntrl->event.slot >= 0) {
+        g_timerSlots[cntrl->event.slot] = NULL;
+        cntrl->event.slot = -1;
+    }
+    (void)OsalSemDestroy(&cntrl->event.sem);
+    (void)OsalSpinDestroy(&cntrl->event.spin);
+}
+
+// caller holds manager->lock
+static struct TimerCntrl *TimerCntrlFind(struct TimerManager *manager, uint32_t number)
+{
+    struct TimerCntrl *pos = NULL;
+
+    DLIST_FOR_EACH_ENTRY(pos, &manager->hashHead[number % TIMER_HASH_BUCKETS], struct TimerCntrl, hashNode) {
+        if (number == pos->info.number) {
+            return pos;
+        }
+    }
+    return NULL;
+}
+
 struct TimerCntrl *TimerCntrlOpen(const uint32_t number)
 {
     struct TimerCntrl *pos = NULL;
@@ -35,16 +156,12 @@ struct TimerCntrl *TimerCntrlOpen(const uint32_t number)
         return NULL;
     }
 
-    DLIST_FOR_EACH_ENTRY(pos, &manager->timerListHead, struct TimerCntrl, node) {
-        if (number == pos->info.number) {
-            (void)OsalMutexUnlock(&manager->lock);
-            return pos;
-        }
-    }
-
+    pos = TimerCntrlFind(manager, number);
     (void)OsalMutexUnlock(&manager->lock);
-    HDF_LOGE("%s: open %u failed", __func__, number);
-    return NULL;
+    if (pos == NULL) {
+        HDF_LOGE("%s: open %u failed", __func__, number);
+    }
+    return pos;
 }
 
 int32_t TimerCntrlClose(struct TimerCntrl *cntrl)
@@ -63,15 +180,19 @@ int32_t TimerCntrlClose(struct TimerCntrl *cntrl)
     return HDF_SUCCESS;
 }
 
+// a NULL cb arms the timer for TimerCntrlWaitEvent only
 int32_t TimerCntrlSet(struct TimerCntrl *cntrl, uint32_t useconds, TimerHandleCb cb)
 {
     CHECK_NULL_PTR_RETURN_VALUE(cntrl, HDF_ERR_INVALID_OBJECT);
-    CHECK_NULL_PTR_RETURN_VALUE(cb, HDF_ERR_INVALID_OBJECT);
+    if ((cb == NULL) && (cntrl->event.slot < 0)) {
+        HDF_LOGE("%s: timer %u has no event slot", __func__, cntrl->info.number);
+        return HDF_ERR_NOT_SUPPORT;
+    }
     if (OsalMutexLock(&cntrl->lock) != HDF_SUCCESS) {
         HDF_LOGE("%s: OsalMutexLock %u failed", __func__, cntrl->info.number);
         return HDF_ERR_DEVICE_BUSY;
     }
-    if ((cntrl->ops->Set != NULL) && (cntrl->ops->Set(cntrl, useconds, cb) != HDF_SUCCESS)) {
+    if ((cntrl->ops->Set != NULL) && (cntrl->ops->Set(cntrl, useconds, TimerCntrlArm(cntrl, cb)) != HDF_SUCCESS)) {
         HDF_LOGE("%s: set %u failed", __func__, cntrl->info.number);
         (void)OsalMutexUnlock(&cntrl->lock);
         return HDF_FAILURE;
@@ -84,13 +205,17 @@ int32_t TimerCntrlSet(struct TimerCntrl *cntrl, uint32_t useconds, TimerHandleCb
 int32_t TimerCntrlSetOnce(struct TimerCntrl *cntrl, uint32_t useconds, TimerHandleCb cb)
 {
     CHECK_NULL_PTR_RETURN_VALUE(cntrl, HDF_ERR_INVALID_OBJECT);
-    CHECK_NULL_PTR_RETURN_VALUE(cb, HDF_ERR_INVALID_OBJECT);
+    if ((cb == NULL) && (cntrl->event.slot < 0)) {
+        HDF_LOGE("%s: timer %u has no event slot", __func__, cntrl->info.number);
+        return HDF_ERR_NOT_SUPPORT;
+    }
 
     if (OsalMutexLock(&cntrl->lock) != HDF_SUCCESS) {
         HDF_LOGE("%s: OsalMutexLock %u failed", __func__, cntrl->info.number);
         return HDF_ERR_DEVICE_BUSY;
     }
-    if ((cntrl->ops->SetOnce != NULL) && (cntrl->ops->SetOnce(cntrl, useconds, cb) != HDF_SUCCESS)) {
+    if ((cntrl->ops->SetOnce != NULL) &&
+        (cntrl->ops->SetOnce(cntrl, useconds, TimerCntrlArm(cntrl, cb)) != HDF_SUCCESS)) {
         HDF_LOGE("%s: setOnce %u failed", __func__, cntrl->info.number);
         (void)OsalMutexUnlock(&cntrl->lock);
         return HDF_FAILURE;
@@ -151,6 +276,40 @@ int32_t TimerCntrlStop(struct TimerCntrl *cntrl)
     return HDF_SUCCESS;
 }
 
+int32_t TimerCntrlWaitEvent(struct TimerCntrl *cntrl, uint32_t timeoutMs, struct TimerEvent *event)
+{
+    int32_t ret;
+    uint32_t flags;
+
+    CHECK_NULL_PTR_RETURN_VALUE(cntrl, HDF_ERR_INVALID_OBJECT);
+    CHECK_NULL_PTR_RETURN_VALUE(event, HDF_ERR_INVALID_OBJECT);
+    if (cntrl->event.slot < 0) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    while (true) {
+        (void)OsalSpinLockIrqSave(&cntrl->event.spin, &flags);
+        if (cntrl->event.pending > 0) {
+            event->count = cntrl->event.pending;
+            event->timestampUs = cntrl->event.lastUs;
+            cntrl->event.pending = 0;
+            (void)OsalSpinUnlockIrqRestore(&cntrl->event.spin, &flags);
+            return HDF_SUCCESS;
+        }
+        cntrl->event.waiting = true;
+        (void)OsalSpinUnlockIrqRestore(&cntrl->event.spin, &flags);
+
+        // a post left over from a timed out wait only costs one more turn
+        ret = OsalSemWait(&cntrl->event.sem, timeoutMs);
+        if (ret != HDF_SUCCESS) {
+            (void)OsalSpinLockIrqSave(&cntrl->event.spin, &flags);
+            cntrl->event.waiting = false;
+            (void)OsalSpinUnlockIrqRestore(&cntrl->event.spin, &flags);
+            return ret;
+        }
+    }
+}
+
 static int32_t TimerIoOpen(struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     int16_t number;
@@ -247,11 +406,6 @@ static int32_t TimerIoStop(struct HdfSBuf *data, struct HdfSBuf *reply)
     return TimerCntrlStop(TimerCntrlOpen(number));
 }
 
-static int32_t TimerIoCb()
-{
-    return HDF_SUCCESS;
-}
-
 static int32_t TimerIoSet(struct HdfSBuf *data, struct HdfSBuf *reply)
 {
     uint32_t len;
@@ -277,7 +431,8 @@ static int32_t TimerIoSet(struct HdfSBuf *data, struct HdfSBuf *reply)
         HDF_LOGE("%s: number[%d] invalid", __func__, number);
         return HDF_ERR_INVALID_PARAM;
     }
-    return TimerCntrlSet(TimerCntrlOpen(number), cfg->useconds, TimerIoCb);
+    // user space clients take their expirations through TIMER_IO_WAIT
+    return TimerCntrlSet(TimerCntrlOpen(number), cfg->useconds, NULL);
 }
 
 static int32_t TimerIoSetOnce(struct HdfSBuf *data, struct HdfSBuf *reply)
@@ -305,7 +460,7 @@ static int32_t TimerIoSetOnce(struct HdfSBuf *data, struct HdfSBuf *reply)
         HDF_LOGE("%s: number[%d] invalid", __func__, number);
         return HDF_ERR_INVALID_PARAM;
     }
-    return TimerCntrlSetOnce(TimerCntrlOpen(number), cfg->useconds, TimerIoCb);
+    return TimerCntrlSetOnce(TimerCntrlOpen(number), cfg->useconds, NULL);
 }
 
 static int32_t TimerIoGet(struct HdfSBuf *data, struct HdfSBuf *reply)
@@ -344,6 +499,40 @@ static int32_t TimerIoGet(struct HdfSBuf *data, struct HdfSBuf *reply)
     return HDF_SUCCESS;
 }
 
+static int32_t TimerIoWait(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    uint32_t handle;
+    uint32_t timeoutMs;
+    int16_t number;
+    struct TimerEvent event;
+
+    if ((data == NULL) || (reply == NULL)) {
+        HDF_LOGE("%s: param null", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!HdfSbufReadUint32(data, &handle) || !HdfSbufReadUint32(data, &timeoutMs)) {
+        HDF_LOGE("%s: read handle or timeout failed", __func__);
+        return HDF_ERR_IO;
+    }
+
+    number = (int16_t)(handle - TIMER_HANDLE_SHIFT);
+    if (number < 0) {
+        HDF_LOGE("%s: number[%d] invalid", __func__, number);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ret = TimerCntrlWaitEvent(TimerCntrlOpen(number), timeoutMs, &event);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    if (!HdfSbufWriteBuffer(reply, &event, sizeof(event))) {
+        HDF_LOGE("%s: write buffer failed!", __func__);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
 static int32_t TimerIoDispatch(struct HdfDeviceIoClient *client, int cmd,
     struct HdfSBuf *data, struct HdfSBuf *reply)
 {
@@ -371,6 +560,9 @@ static int32_t TimerIoDispatch(struct HdfDeviceIoClient *client, int cmd,
         case  TIMER_IO_GET:
             ret = TimerIoGet(data, reply);
             break;
+        case  TIMER_IO_WAIT:
+            ret = TimerIoWait(data, reply);
+            break;
         default:
             ret = HDF_ERR_NOT_SUPPORT;
             HDF_LOGE("%s: cmd[%d] not support!", __func__, cmd);
@@ -394,6 +586,8 @@ int32_t TimerListRemoveAll(void)
         if ((pos->ops->Remove != NULL) && (pos->ops->Remove(pos) != HDF_SUCCESS)) {
             HDF_LOGE("%s: remove %u failed", __func__, pos->info.number);
         }
+        TimerCntrlEventUninit(pos);
+        DListRemove(&pos->hashNode);
         DListRemove(&pos->node);
         (void)OsalMutexDestroy(&pos->lock);
         OsalMemFree(pos);
@@ -408,18 +602,9 @@ int32_t TimerCntrlAdd(struct TimerCntrl *cntrl)
 {
     CHECK_NULL_PTR_RETURN_VALUE(cntrl, HDF_ERR_INVALID_PARAM);
     CHECK_NULL_PTR_RETURN_VALUE(cntrl->ops, HDF_ERR_INVALID_PARAM);
-    struct TimerCntrl *pos = NULL;
-    struct TimerCntrl *tmp = NULL;
     struct TimerManager *manager = g_timerManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->timerListHead, struct TimerCntrl, node) {
-        if (cntrl->info.number == pos->info.number) {
-            HDF_LOGE("%s: timer[%u] existed", __func__, cntrl->info.number);
-            return HDF_FAILURE;
-        }
-    }
-
     // init info
     if (OsalMutexInit(&cntrl->lock) != HDF_SUCCESS) {
         HDF_LOGE("%s: OsalMutexInit %u failed", __func__, cntrl->info.number);
@@ -428,9 +613,23 @@ int32_t TimerCntrlAdd(struct TimerCntrl *cntrl)
 
     if (OsalMutexLock(&manager->lock) != HDF_SUCCESS) {
         HDF_LOGE("%s: OsalMutexLock %u failed", __func__, cntrl->info.number);
+        (void)OsalMutexDestroy(&cntrl->lock);
         return HDF_ERR_DEVICE_BUSY;
     }
+    if (TimerCntrlFind(manager, cntrl->info.number) != NULL) {
+        (void)OsalMutexUnlock(&manager->lock);
+        (void)OsalMutexDestroy(&cntrl->lock);
+        HDF_LOGE("%s: timer[%u] existed", __func__, cntrl->info.number);
+        return HDF_FAILURE;
+    }
+    if (TimerCntrlEventInit(cntrl) != HDF_SUCCESS) {
+        (void)OsalMutexUnlock(&manager->lock);
+        (void)OsalMutexDestroy(&cntrl->lock);
+        HDF_LOGE("%s: event init %u failed", __func__, cntrl->info.number);
+        return HDF_FAILURE;
+    }
     DListInsertTail(&cntrl->node, &manager->timerListHead);
+    DListInsertTail(&cntrl->hashNode, &manager->hashHead[cntrl->info.number % TIMER_HASH_BUCKETS]);
     (void)OsalMutexUnlock(&manager->lock);
     HDF_LOGI("%s: add timer number[%u] success", __func__, cntrl->info.number);
 
@@ -440,7 +639,6 @@ int32_t TimerCntrlAdd(struct TimerCntrl *cntrl)
 int32_t TimerCntrlRemoveByNumber(const uint32_t number)
 {
     struct TimerCntrl *pos = NULL;
-    struct TimerCntrl *tmp = NULL;
     struct TimerManager *manager = g_timerManager;
     CHECK_NULL_PTR_RETURN_VALUE(manager, HDF_FAILURE);
 
@@ -449,16 +647,16 @@ int32_t TimerCntrlRemoveByNumber(const uint32_t number)
         return HDF_ERR_DEVICE_BUSY;
     }
 
-    DLIST_FOR_EACH_ENTRY_SAFE(pos, tmp, &manager->timerListHead, struct TimerCntrl, node) {
-        if (number == pos->info.number) {
-            if ((pos->ops->Remove != NULL) && (pos->ops->Remove(pos) != HDF_SUCCESS)) {
-                HDF_LOGE("%s: remove %u failed", __func__, pos->info.number);
-            }
-            (void)OsalMutexDestroy(&pos->lock);
-            DListRemove(&pos->node);
-            OsalMemFree(pos);
-            break;
+    pos = TimerCntrlFind(manager, number);
+    if (pos != NULL) {
+        if ((pos->ops->Remove != NULL) && (pos->ops->Remove(pos) != HDF_SUCCESS)) {
+            HDF_LOGE("%s: remove %u failed", __func__, pos->info.number);
         }
+        TimerCntrlEventUninit(pos);
+        (void)OsalMutexDestroy(&pos->lock);
+        DListRemove(&pos->hashNode);
+        DListRemove(&pos->node);
+        OsalMemFree(pos);
     }
 
     (void)OsalMutexUnlock(&manager->lock);
@@ -469,6 +667,7 @@ int32_t TimerCntrlRemoveByNumber(const uint32_t number)
 static int32_t TimerManagerBind(struct HdfDeviceObject *device)
 {
     int32_t ret;
+    uint32_t i;
     struct TimerManager *manager = NULL;
 
     CHECK_NULL_PTR_RETURN_VALUE(device, HDF_ERR_INVALID_OBJECT);
@@ -491,6 +690,9 @@ static int32_t TimerManagerBind(struct HdfDeviceObject *device)
     device->service = &manager->service;
     device->service->Dispatch = TimerIoDispatch;
     DListHeadInit(&manager->timerListHead);
+    for (i = 0; i < TIMER_HASH_BUCKETS; i++) {
+        DListHeadInit(&manager->hashHead[i]);
+    }
     g_timerManager = manager;
 
     HDF_LOGI("%s: success", __func__);
@@ -7,14 +7,52 @@
  */
 
 #include "timer_if.h"
+#include <pthread.h>
 #include "hdf_io_service_if.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_thread.h"
+#include "platform_user_sbuf.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG timer_if_u
 
 #define TIMER_SERVICE_NAME "HDF_PLATFORM_TIMER_MANAGER"
+#define TIMER_USER_MAX            16
+#define TIMER_USER_POLL_MS        100
+#define TIMER_USER_THREAD_STACK   (1024 * 16)
+
+/* one dispatcher thread per armed handle turns the kernel expiration events into callbacks */
+struct TimerUser {
+    DevHandle handle;
+    TimerHandleCb cb;
+    struct OsalThread thread;
+    struct OsalSem exitSem;
+    volatile bool running;
+};
+
+static struct TimerUser g_timerUser[TIMER_USER_MAX];
+static struct OsalMutex g_timerUserLock;
+static pthread_once_t g_timerUserOnce = PTHREAD_ONCE_INIT;
+static bool g_timerUserLockReady = false;
+
+static void TimerUserLockInit(void)
+{
+    g_timerUserLockReady = (OsalMutexInit(&g_timerUserLock) == HDF_SUCCESS);
+}
+
+static int32_t TimerUserLock(void)
+{
+    (void)pthread_once(&g_timerUserOnce, TimerUserLockInit);
+    if (!g_timerUserLockReady) {
+        HDF_LOGE("%s: init timer user lock fail", __func__);
+        return HDF_FAILURE;
+    }
+    return OsalMutexLock(&g_timerUserLock);
+}
+
 static void *TimerManagerGetService(void)
 {
     static void *manager = NULL;
@@ -25,10 +63,164 @@ static void *TimerManagerGetService(void)
     manager = (void *)HdfIoServiceBind(TIMER_SERVICE_NAME);
     if (manager == NULL) {
         HDF_LOGE("%s: fail to get timer manager!", __func__);
+        return NULL;
     }
     return manager;
 }
 
+static int32_t TimerWaitEvent(DevHandle handle, uint32_t timeoutMs, struct TimerEvent *event)
+{
+    int32_t ret;
+    uint32_t rLen;
+    const void *rBuf = NULL;
+    struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
+    struct HdfIoService *service = (struct HdfIoService *)TimerManagerGetService();
+
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ret = PlatformUserSbufGet(&data, &reply, 0);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle) || !HdfSbufWriteUint32(data, timeoutMs)) {
+        ret = HDF_ERR_IO;
+        goto __EXIT;
+    }
+
+    ret = service->dispatcher->Dispatch(&service->object, TIMER_IO_WAIT, data, reply);
+    if (ret != HDF_SUCCESS) {
+        goto __EXIT;
+    }
+    if (!HdfSbufReadBuffer(reply, &rBuf, &rLen) || rLen != sizeof(*event)) {
+        HDF_LOGE("%s: sbuf read event failed", __func__);
+        ret = HDF_ERR_IO;
+        goto __EXIT;
+    }
+    if (memcpy_s(event, sizeof(*event), rBuf, rLen) != EOK) {
+        ret = HDF_ERR_IO;
+    }
+
+__EXIT:
+    return ret;
+}
+
+static int32_t TimerUserThread(void *arg)
+{
+    int32_t ret;
+    struct TimerEvent event;
+    struct TimerUser *user = (struct TimerUser *)arg;
+
+    while (user->running) {
+        ret = TimerWaitEvent(user->handle, TIMER_USER_POLL_MS, &event);
+        if (ret == HDF_ERR_TIMEOUT) {
+            continue;
+        }
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: wait event failed:%d", __func__, ret);
+            // mark the slot dead, the next start or stop of the handle reaps it
+            user->running = false;
+            break;
+        }
+        // expirations that piled up while the callback ran arrive as one event
+        if (user->running && user->cb != NULL) {
+            (void)user->cb();
+        }
+    }
+    (void)OsalSemPost(&user->exitSem);
+    return HDF_SUCCESS;
+}
+
+// caller holds g_timerUserLock, the dispatcher must have been told to stop or have stopped by itself
+static void TimerUserReap(struct TimerUser *user)
+{
+    (void)OsalSemWait(&user->exitSem, HDF_WAIT_FOREVER);
+    (void)OsalThreadDestroy(&user->thread);
+    (void)OsalSemDestroy(&user->exitSem);
+    user->cb = NULL;
+    user->handle = NULL;
+}
+
+// caller holds g_timerUserLock
+static struct TimerUser *TimerUserFind(DevHandle handle)
+{
+    uint32_t i;
+
+    for (i = 0; i < TIMER_USER_MAX; i++) {
+        if (g_timerUser[i].handle == handle) {
+            return &g_timerUser[i];
+        }
+    }
+    return NULL;
+}
+
+static int32_t TimerUserStart(DevHandle handle, TimerHandleCb cb)
+{
+    int32_t ret;
+    struct TimerUser *user = NULL;
+    struct OsalThreadParam param;
+
+    ret = TimerUserLock();
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    user = TimerUserFind(handle);
+    if (user != NULL && user->running) {
+        user->cb = cb;
+        (void)OsalMutexUnlock(&g_timerUserLock);
+        return HDF_SUCCESS;
+    }
+    if (user != NULL) {
+        // the dispatcher quit on an error, restart it in the same slot
+        TimerUserReap(user);
+    }
+    user = TimerUserFind(NULL);
+    if (user == NULL) {
+        (void)OsalMutexUnlock(&g_timerUserLock);
+        HDF_LOGE("%s: too many armed timers", __func__);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+
+    user->handle = handle;
+    user->cb = cb;
+    user->running = true;
+    (void)OsalSemInit(&user->exitSem, 0);
+    ret = OsalThreadCreate(&user->thread, TimerUserThread, user);
+    if (ret == HDF_SUCCESS) {
+        param.name = "timer_user";
+        param.priority = OSAL_THREAD_PRI_HIGHEST;
+        param.stackSize = TIMER_USER_THREAD_STACK;
+        ret = OsalThreadStart(&user->thread, &param);
+        if (ret != HDF_SUCCESS) {
+            (void)OsalThreadDestroy(&user->thread);
+        }
+    }
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start dispatcher failed:%d", __func__, ret);
+        (void)OsalSemDestroy(&user->exitSem);
+        user->running = false;
+        user->handle = NULL;
+    }
+    (void)OsalMutexUnlock(&g_timerUserLock);
+    return ret;
+}
+
+static void TimerUserStop(DevHandle handle)
+{
+    struct TimerUser *user = NULL;
+
+    if (TimerUserLock() != HDF_SUCCESS) {
+        return;
+    }
+    user = TimerUserFind(handle);
+    if (user != NULL) {
+        user->running = false;
+        TimerUserReap(user);
+    }
+    (void)OsalMutexUnlock(&g_timerUserLock);
+}
+
 DevHandle HwTimerOpen(const uint32_t number)
 {
     int32_t ret;
@@ -43,39 +235,25 @@ DevHandle HwTimerOpen(const uint32_t number)
         return NULL;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        return NULL;
-    }
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HdfSbufRecycle(data);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
         return NULL;
     }
 
     if (!HdfSbufWriteUint16(data, (uint16_t)number)) {
         HDF_LOGE("%s: write number fail!", __func__);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return NULL;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, TIMER_IO_OPEN, data, reply);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: TIMER_IO_OPEN service process fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return NULL;
     }
 
     if (!HdfSbufReadUint32(reply, &handle)) {
         HDF_LOGE("%s: read reply fail!", __func__);
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return NULL;
     }
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
     return (DevHandle)(uintptr_t)handle;
 }
 
@@ -84,6 +262,7 @@ void HwTimerClose(DevHandle handle)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
 
     if (handle == NULL) {
         HDF_LOGE("%s: handle is invalid", __func__);
@@ -95,15 +274,14 @@ void HwTimerClose(DevHandle handle)
         HDF_LOGE("%s: service is invalid", __func__);
         return;
     }
+    TimerUserStop(handle);
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
         return;
     }
 
     if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
         HDF_LOGE("%s: write handle fail!", __func__);
-        HdfSbufRecycle(data);
         return;
     }
 
@@ -111,7 +289,6 @@ void HwTimerClose(DevHandle handle)
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: TIMER_IO_CLOSE service process fail:%d", __func__, ret);
     }
-    HdfSbufRecycle(data);
 }
 
 int32_t HwTimerStart(DevHandle handle)
@@ -119,6 +296,7 @@ int32_t HwTimerStart(DevHandle handle)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
 
     if (handle == NULL) {
         HDF_LOGE("%s: handle is invalid", __func__);
@@ -130,25 +308,21 @@ int32_t HwTimerStart(DevHandle handle)
         return HDF_ERR_INVALID_PARAM;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: HdfSBufObtainDefaultSize fail!", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_FAILURE;
     }
 
     if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
         HDF_LOGE("%s: write handle fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_FAILURE;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, TIMER_IO_START, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: TIMER_IO_START service process fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
         return HDF_FAILURE;
     }
-    HdfSbufRecycle(data);
 
     return HDF_SUCCESS;
 }
@@ -158,6 +332,7 @@ int32_t HwTimerStop(DevHandle handle)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *data = NULL;
+    struct HdfSBuf *reply = NULL;
 
     if (handle == NULL) {
         HDF_LOGE("%s: handle is invalid", __func__);
@@ -170,25 +345,21 @@ int32_t HwTimerStop(DevHandle handle)
         return HDF_ERR_INVALID_PARAM;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: HdfSbufObtainDefaultSize fail!", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_FAILURE;
     }
 
     if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
         HDF_LOGE("%s: write handle fail!", __func__);
-        HdfSbufRecycle(data);
         return HDF_FAILURE;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, TIMER_IO_STOP, data, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: TIMER_IO_STOP service process fail:%d", __func__, ret);
-        HdfSbufRecycle(data);
         return HDF_FAILURE;
     }
-    HdfSbufRecycle(data);
 
     return HDF_SUCCESS;
 }
@@ -198,6 +369,7 @@ int32_t HwTimerSet(DevHandle handle, uint32_t useconds, TimerHandleCb cb)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *buf = NULL;
+    struct HdfSBuf *reply = NULL;
     struct TimerConfig cfg;
 
     if (handle == NULL) {
@@ -218,9 +390,8 @@ int32_t HwTimerSet(DevHandle handle, uint32_t useconds, TimerHandleCb cb)
     }
     cfg.useconds = useconds;
 
-    buf = HdfSbufObtainDefaultSize();
-    if (buf == NULL) {
-        HDF_LOGE("%s: failed to obtain buf", __func__);
+    if (PlatformUserSbufGet(&buf, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
     if (!HdfSbufWriteUint32(buf, (uint32_t)(uintptr_t)handle)) {
@@ -229,19 +400,16 @@ int32_t HwTimerSet(DevHandle handle, uint32_t useconds, TimerHandleCb cb)
     }
     if (!HdfSbufWriteBuffer(buf, &cfg, sizeof(cfg))) {
         HDF_LOGE("%s: sbuf write cfg failed", __func__);
-        HdfSbufRecycle(buf);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, TIMER_IO_SET, buf, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: TIMER_IO_SET service process fail:%d", __func__, ret);
-        HdfSbufRecycle(buf);
         return HDF_FAILURE;
     }
-    HdfSbufRecycle(buf);
 
-    return HDF_SUCCESS;
+    return TimerUserStart(handle, cb);
 }
 
 int32_t HwTimerSetOnce(DevHandle handle, uint32_t useconds, TimerHandleCb cb)
@@ -249,6 +417,7 @@ int32_t HwTimerSetOnce(DevHandle handle, uint32_t useconds, TimerHandleCb cb)
     int32_t ret;
     struct HdfIoService *service = NULL;
     struct HdfSBuf *buf = NULL;
+    struct HdfSBuf *reply = NULL;
     struct TimerConfig cfg;
 
     if (handle == NULL) {
@@ -269,9 +438,8 @@ int32_t HwTimerSetOnce(DevHandle handle, uint32_t useconds, TimerHandleCb cb)
     }
     cfg.useconds = useconds;
 
-    buf = HdfSbufObtainDefaultSize();
-    if (buf == NULL) {
-        HDF_LOGE("%s: failed to obtain buf", __func__);
+    if (PlatformUserSbufGet(&buf, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_ERR_MALLOC_FAIL;
     }
     if (!HdfSbufWriteUint32(buf, (uint32_t)(uintptr_t)handle)) {
@@ -280,19 +448,16 @@ int32_t HwTimerSetOnce(DevHandle handle, uint32_t useconds, TimerHandleCb cb)
     }
     if (!HdfSbufWriteBuffer(buf, &cfg, sizeof(cfg))) {
         HDF_LOGE("%s: sbuf write cfg failed", __func__);
-        HdfSbufRecycle(buf);
         return HDF_ERR_IO;
     }
 
     ret = service->dispatcher->Dispatch(&service->object, TIMER_IO_SETONCE, buf, NULL);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s: TIMER_IO_SETONCE service process fail:%d", __func__, ret);
-        HdfSbufRecycle(buf);
         return HDF_FAILURE;
     }
-    HdfSbufRecycle(buf);
 
-    return HDF_SUCCESS;
+    return TimerUserStart(handle, cb);
 }
 
 int32_t HwTimerGet(DevHandle handle, uint32_t *useconds, bool *isPeriod)
@@ -316,19 +481,11 @@ int32_t HwTimerGet(DevHandle handle, uint32_t *useconds, bool *isPeriod)
         return HDF_ERR_INVALID_PARAM;
     }
 
-    data = HdfSbufObtainDefaultSize();
-    if (data == NULL) {
-        HDF_LOGE("%s: HdfSBufObtainDefaultSize fail!", __func__);
+    if (PlatformUserSbufGet(&data, &reply, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: fail to obtain sbuf!", __func__);
         return HDF_FAILURE;
     }
 
-    reply = HdfSbufObtainDefaultSize();
-    if (reply == NULL) {
-        HDF_LOGE("%s: failed to obtain reply", __func__);
-        ret = HDF_ERR_MALLOC_FAIL;
-        goto __EXIT;
-    }
-
     if (!HdfSbufWriteUint32(data, (uint32_t)(uintptr_t)handle)) {
         HDF_LOGE("%s: write handle fail!", __func__);
         ret =  HDF_FAILURE;
@@ -362,7 +519,5 @@ int32_t HwTimerGet(DevHandle handle, uint32_t *useconds, bool *isPeriod)
     *isPeriod = cfg.isPeriod;
 
 __EXIT:
-        HdfSbufRecycle(data);
-        HdfSbufRecycle(reply);
         return ret;
 }
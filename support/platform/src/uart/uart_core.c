@@ -9,10 +9,17 @@
 #include "uart_core.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_time.h"
+#include "platform_core.h"
+#include "securec.h"
 #include "uart_if.h"
 
 #define HDF_LOG_TAG uart_core_c
 
+#define UART_RX_RING_DRAIN_WAIT_MS 1
+
+static void UartRxRingSetStopped(struct UartHost *host, bool stopped);
+
 int32_t UartHostInit(struct UartHost *host)
 {
     int32_t ret;
@@ -34,6 +41,7 @@ int32_t UartHostInit(struct UartHost *host)
             return ret;
         }
     }
+    UartRxRingSetStopped(host, false);
     return HDF_SUCCESS;
 }
 
@@ -51,15 +59,309 @@ int32_t UartHostDeinit(struct UartHost *host)
             return ret;
         }
     }
+    UartRxRingSetStopped(host, true);
     OsalAtomicDec(&host->atom);
     return HDF_SUCCESS;
 }
 
+static inline uint32_t UartRxRingDataSize(struct UartRxRing *ring)
+{
+    return ring->writePosition - ring->readPosition;
+}
+
+/* pins the ring of the host until UartRxRingPut, so it isn't freed under a reader */
+static struct UartRxRing *UartRxRingGet(struct UartHost *host)
+{
+    struct UartRxRing *ring = NULL;
+
+    (void)OsalAtomicIncReturn(&host->rxUsers);
+    ring = *(struct UartRxRing * volatile *)&host->rxRing;
+    if (ring == NULL) {
+        (void)OsalAtomicDecReturn(&host->rxUsers);
+    }
+    return ring;
+}
+
+static inline void UartRxRingPut(struct UartHost *host)
+{
+    (void)OsalAtomicDecReturn(&host->rxUsers);
+}
+
+static void UartRxRingWake(struct UartRxRing *ring)
+{
+    PlatformMemBarrier(&ring->sync);  // pairs with the reader that sets waiting before it checks the ring
+    if (OsalAtomicRead(&ring->waiting) != 0) {
+        OsalAtomicSet(&ring->waiting, 0);
+        (void)OsalSemPost(&ring->sem);
+    }
+}
+
+static void UartRxRingSetStopped(struct UartHost *host, bool stopped)
+{
+    struct UartRxRing *ring = NULL;
+
+    ring = UartRxRingGet(host);
+    if (ring == NULL) {
+        return;
+    }
+    ring->stopped = stopped;
+    if (stopped) {
+        UartRxRingWake(ring);
+    }
+    UartRxRingPut(host);
+}
+
+int32_t UartHostRxRingInit(struct UartHost *host, uint32_t size)
+{
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (size == 0 || (size & (size - 1)) != 0) {
+        HDF_LOGE("%s: ring size %u is not a power of two", __func__, size);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (host->rxRing != NULL) {
+        HDF_LOGE("%s: ring already exists", __func__);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+
+    ring = (struct UartRxRing *)OsalMemCalloc(sizeof(*ring));
+    if (ring == NULL) {
+        HDF_LOGE("%s: alloc ring fail", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    ring->buffer = (uint8_t *)OsalMemCalloc(size);
+    if (ring->buffer == NULL) {
+        HDF_LOGE("%s: alloc ring buffer fail", __func__);
+        OsalMemFree(ring);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    if (OsalSemInit(&ring->sem, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init sem fail", __func__);
+        OsalMemFree(ring->buffer);
+        OsalMemFree(ring);
+        return HDF_FAILURE;
+    }
+    ring->sizeMask = size - 1;
+    ring->readPosition = 0;
+    ring->writePosition = 0;
+    OsalAtomicSet(&ring->sync, 0);
+    OsalAtomicSet(&ring->waiting, 0);
+    ring->block = true;
+    ring->stopped = (OsalAtomicRead(&host->atom) == 0);
+    ring->stat.ringSize = size;
+    PlatformMemBarrier(&ring->sync);  // ring set up before it is published
+    host->rxRing = ring;
+    return HDF_SUCCESS;
+}
+
+void UartHostRxRingDeinit(struct UartHost *host)
+{
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || host->rxRing == NULL) {
+        return;
+    }
+    ring = host->rxRing;
+    // the driver stopped filling, new readers find no ring, and those already in are woken up and waited for
+    host->rxRing = NULL;
+    ring->stopped = true;
+    UartRxRingWake(ring);
+    while (OsalAtomicRead(&host->rxUsers) != 0) {
+        OsalMSleep(UART_RX_RING_DRAIN_WAIT_MS);
+    }
+    (void)OsalSemDestroy(&ring->sem);
+    OsalMemFree(ring->buffer);
+    OsalMemFree(ring);
+}
+
+void UartHostRxSetNotify(struct UartHost *host, UartRxNotify notify, void *priv)
+{
+    if (host == NULL || host->rxRing == NULL) {
+        return;
+    }
+    host->rxRing->notifyPriv = priv;
+    host->rxRing->notify = notify;
+}
+
+uint32_t UartHostRxPrepare(struct UartHost *host, uint8_t **buf)
+{
+    uint32_t size;
+    uint32_t offset;
+    uint32_t space;
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || host->rxRing == NULL || buf == NULL) {
+        return 0;
+    }
+    ring = host->rxRing;
+    size = ring->sizeMask + 1;
+    space = size - UartRxRingDataSize(ring);
+    // the reader has copied the data out before it moved readPosition
+    PlatformMemBarrier(&ring->sync);
+    offset = ring->writePosition & ring->sizeMask;
+    *buf = ring->buffer + offset;
+    return (space < size - offset) ? space : (size - offset);
+}
+
+void UartHostRxCommit(struct UartHost *host, uint32_t size)
+{
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || host->rxRing == NULL || size == 0) {
+        return;
+    }
+    ring = host->rxRing;
+    PlatformMemBarrier(&ring->sync);  // data written before it is published
+    ring->writePosition += size;
+    ring->stat.pushes++;
+    ring->stat.rxBytes += size;
+    UartRxRingWake(ring);
+    if (ring->notify != NULL) {
+        ring->notify(host, ring->notifyPriv);
+    }
+}
+
+uint32_t UartHostRxPush(struct UartHost *host, const uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+    uint32_t first;
+    uint32_t offset;
+    uint32_t ringSize;
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || host->rxRing == NULL || data == NULL) {
+        return 0;
+    }
+    ring = host->rxRing;
+    ringSize = ring->sizeMask + 1;
+    len = ringSize - UartRxRingDataSize(ring);
+    PlatformMemBarrier(&ring->sync);  // the reader has copied the data out before it moved readPosition
+    len = (len < size) ? len : size;
+    offset = ring->writePosition & ring->sizeMask;
+    first = ringSize - offset;
+    first = (first < len) ? first : len;
+    (void)memcpy_s(ring->buffer + offset, ringSize - offset, data, first);
+    if (first < len) {
+        (void)memcpy_s(ring->buffer, offset, data + first, len - first);
+    }
+    ring->stat.overruns += size - len;
+    UartHostRxCommit(host, len);
+    return len;
+}
+
+uint32_t UartHostRxReadable(struct UartHost *host)
+{
+    uint32_t avail;
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || (ring = UartRxRingGet(host)) == NULL) {
+        return 0;
+    }
+    avail = UartRxRingDataSize(ring);
+    UartRxRingPut(host);
+    return avail;
+}
+
+bool UartHostRxSetBlock(struct UartHost *host, bool block)
+{
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || (ring = UartRxRingGet(host)) == NULL) {
+        return false;
+    }
+    ring->block = block;
+    if (!block) {
+        UartRxRingWake(ring);
+    }
+    UartRxRingPut(host);
+    return true;
+}
+
+static uint32_t UartRxRingWait(struct UartRxRing *ring)
+{
+    uint32_t avail;
+
+    avail = UartRxRingDataSize(ring);
+    while (avail == 0 && ring->block && !ring->stopped) {
+        OsalAtomicSet(&ring->waiting, 1);
+        PlatformMemBarrier(&ring->sync);
+        avail = UartRxRingDataSize(ring);
+        if (avail != 0 || !ring->block || ring->stopped) {
+            OsalAtomicSet(&ring->waiting, 0);
+            break;
+        }
+        (void)OsalSemWait(&ring->sem, HDF_WAIT_FOREVER);
+        // a post left over from an earlier wakeup may find nothing, then wait again
+        avail = UartRxRingDataSize(ring);
+        if (avail != 0) {
+            ring->stat.wakeups++;
+            ring->stat.wakeupBytes += avail;
+        }
+    }
+    return avail;
+}
+
+int32_t UartHostRxRingRead(struct UartHost *host, uint8_t *data, uint32_t size)
+{
+    uint32_t len;
+    uint32_t first;
+    uint32_t offset;
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || data == NULL || size == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ring = UartRxRingGet(host);
+    if (ring == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    len = UartRxRingWait(ring);
+    if (len == 0) {
+        UartRxRingPut(host);
+        return 0;
+    }
+    len = (len < size) ? len : size;
+    PlatformMemBarrier(&ring->sync);  // data read after writePosition
+    offset = ring->readPosition & ring->sizeMask;
+    first = ring->sizeMask + 1 - offset;
+    first = (first < len) ? first : len;
+    (void)memcpy_s(data, size, ring->buffer + offset, first);
+    if (first < len) {
+        (void)memcpy_s(data + first, size - first, ring->buffer, len - first);
+    }
+    PlatformMemBarrier(&ring->sync);  // data copied out before the space is given back
+    ring->readPosition += len;
+    UartRxRingPut(host);
+    return (int32_t)len;
+}
+
+int32_t UartHostGetRxStat(struct UartHost *host, struct UartRxStat *stat)
+{
+    struct UartRxRing *ring = NULL;
+
+    if (host == NULL || stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ring = UartRxRingGet(host);
+    if (ring == NULL) {
+        (void)memset_s(stat, sizeof(*stat), 0, sizeof(*stat));
+        return HDF_SUCCESS;
+    }
+    *stat = ring->stat;
+    UartRxRingPut(host);
+    return HDF_SUCCESS;
+}
+
 void UartHostDestroy(struct UartHost *host)
 {
     if (host == NULL) {
         return;
     }
+    UartHostRxRingDeinit(host);
     OsalMemFree(host);
 }
 
@@ -80,6 +382,7 @@ struct UartHost *UartHostCreate(struct HdfDeviceObject *device)
     device->service = &(host->service);
     host->device->service->Dispatch = UartIoDispatch;
     OsalAtomicSet(&host->atom, 0);
+    OsalAtomicSet(&host->rxUsers, 0);
     host->priv = NULL;
     host->method = NULL;
     return host;
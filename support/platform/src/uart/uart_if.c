@@ -105,3 +105,8 @@ int32_t UartSetTransMode(DevHandle handle, enum UartTransMode mode)
 {
     return UartHostSetTransMode((struct UartHost *)handle, mode);
 }
+
+int32_t UartGetRxStat(DevHandle handle, struct UartRxStat *stat)
+{
+    return UartHostGetRxStat((struct UartHost *)handle, stat);
+}
@@ -345,3 +345,43 @@ int32_t UartSetTransMode(DevHandle handle, enum UartTransMode mode)
     HdfSbufRecycle(data);
     return ret;
 }
+
+int32_t UartGetRxStat(DevHandle handle, struct UartRxStat *stat)
+{
+    int32_t ret;
+    struct HdfSBuf *reply = NULL;
+    uint32_t tmpLen;
+    const void *tmpBuf = NULL;
+
+    if (stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    reply = HdfSbufObtainDefaultSize();
+    if (reply == NULL) {
+        HDF_LOGE("%s: failed to obtain reply buf", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = UartDispatch(handle, UART_IO_GET_RX_STAT, NULL, reply);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: UartDispatch failed: %d", __func__, ret);
+        HdfSbufRecycle(reply);
+        return ret;
+    }
+
+    if (!HdfSbufReadBuffer(reply, &tmpBuf, &tmpLen) || tmpLen != sizeof(*stat)) {
+        HDF_LOGE("%s: sbuf read buffer failed", __func__);
+        HdfSbufRecycle(reply);
+        return HDF_ERR_IO;
+    }
+
+    if (memcpy_s(stat, sizeof(*stat), tmpBuf, tmpLen) != EOK) {
+        HDF_LOGE("%s: memcpy buf failed", __func__);
+        HdfSbufRecycle(reply);
+        return HDF_ERR_IO;
+    }
+
+    HdfSbufRecycle(reply);
+    return HDF_SUCCESS;
+}
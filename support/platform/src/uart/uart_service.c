@@ -138,6 +138,22 @@ static int32_t UartIoSetTransMode(struct UartHost *host, struct HdfSBuf *data)
     return UartHostSetTransMode(host, mode);
 }
 
+static int32_t UartIoGetRxStat(struct UartHost *host, struct HdfSBuf *reply)
+{
+    int32_t ret;
+    struct UartRxStat stat;
+
+    ret = UartHostGetRxStat(host, &stat);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    if (!HdfSbufWriteBuffer(reply, &stat, sizeof(stat))) {
+        HDF_LOGE("%s: sbuf write buffer failed", __func__);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
 int32_t UartIoDispatch(struct HdfDeviceIoClient *client, int cmd,
     struct HdfSBuf *data, struct HdfSBuf *reply)
 {
@@ -178,6 +194,8 @@ int32_t UartIoDispatch(struct HdfDeviceIoClient *client, int cmd,
             return UartIoSetAttribute(host, data);
         case UART_IO_SET_TRANSMODE:
             return UartIoSetTransMode(host, data);
+        case UART_IO_GET_RX_STAT:
+            return UartIoGetRxStat(host, reply);
         default:
             return HDF_ERR_NOT_SUPPORT;
     }
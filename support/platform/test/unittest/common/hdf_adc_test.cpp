@@ -103,3 +103,35 @@ HWTEST_F(HdfLiteAdcTest, AdcIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, AdcTestExecute(ADC_IF_PERFORMANCE_TEST));
 }
+
+/**
+  * @tc.name: AdcTestScan001
+  * @tc.desc: adc continuous scan test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteAdcTest, AdcTestScan001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_ADC_TYPE, ADC_TEST_CMD_SCAN, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    printf("%s: kernel test done, then for user...\n", __func__);
+    EXPECT_EQ(0, AdcTestExecute(ADC_TEST_CMD_SCAN));
+    printf("%s: exit!\n", __func__);
+}
+
+/**
+  * @tc.name: AdcTestScanClose001
+  * @tc.desc: adc scan is stopped when the handle starting it is closed
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteAdcTest, AdcTestScanClose001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_ADC_TYPE, ADC_TEST_CMD_SCAN_CLOSE, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    printf("%s: kernel test done, then for user...\n", __func__);
+    EXPECT_EQ(0, AdcTestExecute(ADC_TEST_CMD_SCAN_CLOSE));
+    printf("%s: exit!\n", __func__);
+}
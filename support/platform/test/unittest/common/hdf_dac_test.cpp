@@ -103,3 +103,35 @@ HWTEST_F(HdfLiteDacTest, DacIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, DacTestExecute(DAC_TEST_CMD_IF_PERFORMANCE));
 }
+
+/**
+  * @tc.name: DacTestStream001
+  * @tc.desc: dac streaming rate and underrun test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteDacTest, DacTestStream001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DAC_TYPE, DAC_TEST_CMD_STREAM, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    printf("%s: kernel test done, then for user...\n", __func__);
+    EXPECT_EQ(0, DacTestExecute(DAC_TEST_CMD_STREAM));
+    printf("%s: exit!\n", __func__);
+}
+
+/**
+  * @tc.name: DacTestStreamSoft001
+  * @tc.desc: dac streaming by the core thread, for a controller without streamStart
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteDacTest, DacTestStreamSoft001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DAC_TYPE, DAC_TEST_CMD_STREAM_SOFT, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    printf("%s: kernel test done, then for user...\n", __func__);
+    EXPECT_EQ(0, DacTestExecute(DAC_TEST_CMD_STREAM_SOFT));
+    printf("%s: exit!\n", __func__);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "hdf_uhdf_test.h"
+#include "dmac_test.h"
+
+using namespace testing::ext;
+
+class HdfDmacTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HdfDmacTest::SetUpTestCase()
+{
+    HdfTestOpenService();
+}
+
+void HdfDmacTest::TearDownTestCase()
+{
+    HdfTestCloseService();
+}
+
+void HdfDmacTest::SetUp()
+{
+}
+
+void HdfDmacTest::TearDown()
+{
+}
+
+/**
+  * @tc.name: HdfDmacTestChainM2m001
+  * @tc.desc: dmac m2m transfer through the lli chain path
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfDmacTest, HdfDmacTestChainM2m001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DMA_TYPE, DMAC_TEST_CHAIN_M2M, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfDmacTestChainEnableFail001
+  * @tc.desc: dmac chain that fails to start is reported through the callback
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfDmacTest, HdfDmacTestChainEnableFail001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_DMA_TYPE, DMAC_TEST_CHAIN_ENABLE_FAIL, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
@@ -150,4 +150,68 @@ HWTEST_F(HdfLiteGpioTest, GpioTestReliability001, TestSize.Level1)
 HWTEST_F(HdfLiteGpioTest, GpioIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, GpioTestExecute(GPIO_TEST_PERFORMANCE));
-}
\ No newline at end of file
+}
+
+/**
+  * @tc.name: GpioTestWriteReadMulti001
+  * @tc.desc: gpio vectored write and read test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteGpioTest, GpioTestWriteReadMulti001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_GPIO_TYPE, GPIO_TEST_WRITE_READ_MULTI, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+
+    EXPECT_EQ(0, GpioTestExecute(GPIO_TEST_WRITE_READ_MULTI));
+    printf("%s: exit!\n", __func__);
+}
+
+/**
+  * @tc.name: GpioTestIrqEvent001
+  * @tc.desc: gpio threaded irq event timestamp and count test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteGpioTest, GpioTestIrqEvent001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_GPIO_TYPE, GPIO_TEST_IRQ_EVENT, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+
+    EXPECT_EQ(0, GpioTestExecute(GPIO_TEST_IRQ_EVENT));
+    printf("%s: exit!\n", __func__);
+}
+
+/**
+  * @tc.name: GpioTestIrqCoalesce001
+  * @tc.desc: gpio irqs taken while the bottom half runs are merged into one event
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteGpioTest, GpioTestIrqCoalesce001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_GPIO_TYPE, GPIO_TEST_IRQ_COALESCE, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+
+    EXPECT_EQ(0, GpioTestExecute(GPIO_TEST_IRQ_COALESCE));
+    printf("%s: exit!\n", __func__);
+}
+
+/**
+  * @tc.name: GpioTestRangeTable001
+  * @tc.desc: gpio controllers are kept sorted by start, overlaps refused, and looked up at the range edges
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteGpioTest, GpioTestRangeTable001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_GPIO_TYPE, GPIO_TEST_RANGE_TABLE, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+
+    EXPECT_EQ(0, GpioTestExecute(GPIO_TEST_RANGE_TABLE));
+    printf("%s: exit!\n", __func__);
+}
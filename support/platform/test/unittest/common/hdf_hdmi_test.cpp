@@ -28,6 +28,7 @@ enum HdmiTestCmd {
     HDMI_EDID_RAW_DATA_GET_01 = 5,
     HDMI_DEEP_COLOR_SET_AND_GET_01 = 6,
     HDMI_HPD_REGISTER_AND_UNREGISTER_01 = 7,
+    HDMI_EDID_CACHE_01 = 8,
 };
 
 class HdfLiteHdmiTest : public testing::Test {
@@ -253,6 +254,18 @@ HWTEST_F(HdfLiteHdmiTest, HdmiHpdRegisterAndUngister001, TestSize.Level1)
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
 
+/**
+  * @tc.name: HdmiEdidCache001
+  * @tc.desc: test edid cache hit/miss and lazy hdr/dolby capability phase in kernel status.
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfLiteHdmiTest, HdmiEdidCache001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = { TEST_PAL_HDMI_TYPE, HDMI_EDID_CACHE_01, -1 };
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
 /**
   * @tc.name: HdmiUserTest001
   * @tc.desc: test hdmi all interface in user status.
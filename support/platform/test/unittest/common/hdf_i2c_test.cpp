@@ -133,3 +133,30 @@ HWTEST_F(HdfLiteI2cTest, HdfLiteI2cTestPeformance001, TestSize.Level1)
 {
     EXPECT_EQ(0, I2cTestExecute(I2C_TEST_CMD_PERFORMANCE));
 }
+
+/**
+  * @tc.name: HdfLiteI2cTestAsyncTransfer001
+  * @tc.desc: i2c asynchronous queued transfer test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteI2cTest, HdfLiteI2cTestAsyncTransfer001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_I2C_TYPE, I2C_TEST_CMD_ASYNC_TRANSFER, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfLiteI2cTestBufReuse001
+  * @tc.desc: i2c transfers of growing and shrinking sizes and after a failed one, on the reused buffers
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteI2cTest, HdfLiteI2cTestBufReuse001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_I2C_TYPE, I2C_TEST_CMD_BUF_REUSE, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+    EXPECT_EQ(0, I2cTestExecute(I2C_TEST_CMD_BUF_REUSE));
+    printf("%s: exit!\n", __func__);
+}
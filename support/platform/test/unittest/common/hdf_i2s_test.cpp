@@ -34,6 +34,7 @@ enum HdfLiteI2sTestCmd {
     I2S_RELIABILITY_TEST,
     I2S_RECORD_TEST,
     I2S_PLAY_TEST,
+    I2S_STREAM_TEST,
 };
 
 class HdfLiteI2sTest : public testing::Test {
@@ -171,3 +172,15 @@ HWTEST_F(HdfLiteI2sTest, I2sReliabilityTest001, TestSize.Level1)
     struct HdfTestMsg msg = {TEST_PAL_I2S_TYPE, I2S_RELIABILITY_TEST, -1};
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
+
+/**
+ * @tc.name: I2sStreamTest001
+ * @tc.desc: i2s ring buffer stream test
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfLiteI2sTest, I2sStreamTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_I2S_TYPE, I2S_STREAM_TEST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
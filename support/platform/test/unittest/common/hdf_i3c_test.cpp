@@ -109,6 +109,18 @@ HWTEST_F(HdfI3cTest, HdfI3cTestRreeIbi001, TestSize.Level1)
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
 
+/**
+  * @tc.name: HdfI3cTestIbiDispatch001
+  * @tc.desc: i3c ibi handlers are deferred to the dispatch thread
+  * @tc.type: FUNC
+  * @tc.require: N/A
+  */
+HWTEST_F(HdfI3cTest, HdfI3cTestIbiDispatch001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_I3C_TYPE, I3C_TEST_CMD_IBI_DISPATCH, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
 /**
   * @tc.name: HdfI3cTestMultiThread001
   * @tc.desc: i3c multithreading test
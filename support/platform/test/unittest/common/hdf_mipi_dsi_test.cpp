@@ -19,7 +19,8 @@ enum MipiDsiTestCmd {
     MIPI_DSI_TEST_TO_LP_TO_HS = 3,
     MIPI_DSI_TEST_ENTER_ULPS_EXIT_ULPS = 4,
     MIPI_DSI_TEST_POWER_CONTROL = 5,
-    MIPI_DSI_TEST_MAX = 6,
+    MIPI_DSI_TEST_TX_LIST = 6,
+    MIPI_DSI_TEST_MAX = 7,
 };
 
 class HdfLiteMipiDsiTest : public testing::Test {
@@ -98,3 +99,13 @@ HWTEST_F(HdfLiteMipiDsiTest, MipiDsiLpHsTest001, TestSize.Level1)
     MipiDsiTest(MIPI_DSI_TEST_TO_LP_TO_HS);
 }
 
+/**
+  * @tc.name: MipiDsiTxListTest001
+  * @tc.desc: mipi dsi command sequence test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteMipiDsiTest, MipiDsiTxListTest001, TestSize.Level1)
+{
+    MipiDsiTest(MIPI_DSI_TEST_TX_LIST);
+}
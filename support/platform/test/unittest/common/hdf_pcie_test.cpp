@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <string>
@@ -22,9 +23,14 @@ using namespace testing::ext;
 const uint32_t PCIE_DISABLE_ADDR = 0xB7;
 const uint32_t PCIE_UPPER_ADDR = 0x28;
 const uint32_t PCIE_CMD_ADDR = 0x04;
+const uint64_t PCIE_DMA_ADDR = 0x100;
+const uint32_t PCIE_DMA_LEN = 256;
+const uint32_t PCIE_DMA_USER_MAX_LEN = 64 * 1024;
 
 enum PcieTestCmd {
     PCIE_READ_AND_WRITE_01 = 0,
+    PCIE_MAP_BAR_01 = 1,
+    PCIE_DMA_TRANSFER_01 = 2,
 };
 
 class HdfPcieTest : public testing::Test {
@@ -104,6 +110,81 @@ static void PcieUserTest(void)
     PcieClose(handle);
 }
 
+static void PcieUserDmaCallback(void *priv, int32_t status)
+{
+    (void)priv;
+    (void)status;
+}
+
+static int32_t PcieUserDmaCheck(DevHandle handle)
+{
+    int32_t ret;
+    uint32_t i;
+    uint8_t wbuf[PCIE_DMA_LEN];
+    uint8_t rbuf[PCIE_DMA_LEN] = {0};
+    struct PcieDmaXfer xfer = {};
+
+    for (i = 0; i < PCIE_DMA_LEN; i++) {
+        wbuf[i] = (uint8_t)(PCIE_DMA_LEN - i);
+    }
+    xfer.dir = PCIE_DMA_TO_DEVICE;
+    xfer.devAddr = PCIE_DMA_ADDR;
+    xfer.buf = wbuf;
+    xfer.len = PCIE_DMA_LEN;
+    ret = PcieDmaTransfer(handle, &xfer);
+    if (ret != HDF_SUCCESS) {
+        printf("dma to device failed ret = %d.", ret);
+        return ret;
+    }
+    xfer.dir = PCIE_DMA_FROM_DEVICE;
+    xfer.buf = rbuf;
+    ret = PcieDmaTransfer(handle, &xfer);
+    if (ret != HDF_SUCCESS) {
+        printf("dma from device failed ret = %d.", ret);
+        return ret;
+    }
+    if (memcmp(rbuf, wbuf, PCIE_DMA_LEN) != 0) {
+        printf("dma data mismatch.");
+        return HDF_FAILURE;
+    }
+
+    // the async form needs a kernel client, so does a transfer over the size the dispatch stages
+    xfer.cb = PcieUserDmaCallback;
+    if (PcieDmaTransfer(handle, &xfer) != HDF_ERR_NOT_SUPPORT) {
+        printf("async dma accepted in user space.");
+        return HDF_FAILURE;
+    }
+    xfer.cb = nullptr;
+    uint8_t *big = static_cast<uint8_t *>(calloc(PCIE_DMA_USER_MAX_LEN + 1, 1));
+    if (big == nullptr) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    xfer.dir = PCIE_DMA_TO_DEVICE;
+    xfer.buf = big;
+    xfer.len = PCIE_DMA_USER_MAX_LEN + 1;
+    ret = PcieDmaTransfer(handle, &xfer);
+    free(big);
+    if (ret == HDF_SUCCESS) {
+        printf("oversized dma accepted.");
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t PcieUserDmaTest(void)
+{
+    int32_t ret;
+    DevHandle handle = PcieOpen(0);
+
+    if (handle == NULL) {
+        printf("PcieOpen fail.");
+        return HDF_FAILURE;
+    }
+    ret = PcieUserDmaCheck(handle);
+    PcieClose(handle);
+    return ret;
+}
+
 /**
   * @tc.name: PcieReadAndWrite001
   * @tc.desc: test PcieRead/PcieWrite interface in kernel status.
@@ -116,6 +197,30 @@ HWTEST_F(HdfPcieTest, PcieReadAndWrite001, TestSize.Level1)
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
 
+/**
+  * @tc.name: PcieMapBar001
+  * @tc.desc: test PcieMapBar/PcieUnmapBar interface in kernel status.
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfPcieTest, PcieMapBar001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = { TEST_PAL_PCIE_TYPE, PCIE_MAP_BAR_01, -1 };
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: PcieDmaTransfer001
+  * @tc.desc: test PcieDmaTransfer interface in kernel status.
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfPcieTest, PcieDmaTransfer001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = { TEST_PAL_PCIE_TYPE, PCIE_DMA_TRANSFER_01, -1 };
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
 /**
   * @tc.name: PcieUserTest001
   * @tc.desc: test pcie all interface in user status.
@@ -126,3 +231,14 @@ HWTEST_F(HdfPcieTest, PcieUserTest001, TestSize.Level1)
 {
     PcieUserTest();
 }
+
+/**
+  * @tc.name: PcieUserDmaTransfer001
+  * @tc.desc: test PcieDmaTransfer interface in user status.
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPcieTest, PcieUserDmaTransfer001, TestSize.Level1)
+{
+    EXPECT_EQ(HDF_SUCCESS, PcieUserDmaTest());
+}
@@ -95,3 +95,27 @@ HWTEST_F(HdfPinTest, PinReliabilityTest001, TestSize.Level1)
     struct HdfTestMsg msg = {TEST_PAL_PIN_TYPE, PIN_TEST_CMD_RELIABILITY, -1};
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
+
+/**
+ * @tc.name: PinIndexTest001
+ * @tc.desc: Pin lookup by name on a controller of thousands of pins
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfPinTest, PinIndexTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_PIN_TYPE, PIN_TEST_CMD_INDEX, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: PinBatchTest001
+ * @tc.desc: Pin batch configuration test
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfPinTest, PinBatchTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_PIN_TYPE, PIN_TEST_CMD_BATCH, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
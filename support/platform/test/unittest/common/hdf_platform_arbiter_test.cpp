@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "hdf_uhdf_test.h"
+#include "platform_arbiter_test.h"
+
+using namespace testing::ext;
+
+class HdfPlatformArbiterTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HdfPlatformArbiterTest::SetUpTestCase()
+{
+    HdfTestOpenService();
+}
+
+void HdfPlatformArbiterTest::TearDownTestCase()
+{
+    HdfTestCloseService();
+}
+
+void HdfPlatformArbiterTest::SetUp()
+{
+}
+
+void HdfPlatformArbiterTest::TearDown()
+{
+}
+
+/**
+  * @tc.name: HdfPlatformArbiterTestPriorityOrder001
+  * @tc.desc: platform arbiter function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformArbiterTest, HdfPlatformArbiterTestPriorityOrder001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_ARBITER_TYPE, PLAT_ARBITER_TEST_PRIORITY_ORDER, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformArbiterTestTimeout001
+  * @tc.desc: platform arbiter function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformArbiterTest, HdfPlatformArbiterTestTimeout001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_ARBITER_TYPE, PLAT_ARBITER_TEST_TIMEOUT, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformArbiterTestYield001
+  * @tc.desc: platform arbiter function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformArbiterTest, HdfPlatformArbiterTestYield001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_ARBITER_TYPE, PLAT_ARBITER_TEST_YIELD, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+  * @tc.name: HdfPlatformArbiterTestReliability001
+  * @tc.desc: platform arbiter function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformArbiterTest, HdfPlatformArbiterTestReliability001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_ARBITER_TYPE, PLAT_ARBITER_TEST_RELIABILITY, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
@@ -92,3 +92,15 @@ HWTEST_F(HdfPlatformEventTest, HdfPlatformEventTestReliability001, TestSize.Leve
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
 
+/**
+  * @tc.name: HdfPlatformEventTestBroadcast001
+  * @tc.desc: platform event function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformEventTest, HdfPlatformEventTestBroadcast001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_EVENT_TYPE, PLAT_EVENT_TEST_BROADCAST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
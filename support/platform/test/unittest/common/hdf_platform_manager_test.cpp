@@ -80,3 +80,15 @@ HWTEST_F(HdfPlatformManagerTest, HdfPlatformManagerTestReliability001, TestSize.
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
 
+/**
+  * @tc.name: HdfPlatformManagerTestNumberIndex001
+  * @tc.desc: platform manager function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformManagerTest, HdfPlatformManagerTestNumberIndex001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_MANAGER_TYPE, PLAT_MANAGER_TEST_NUMBER_INDEX, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
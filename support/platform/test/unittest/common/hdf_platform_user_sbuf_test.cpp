@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include "hdf_base.h"
+#include "platform_user_sbuf.h"
+
+using namespace testing::ext;
+
+const size_t PLATFORM_USER_SBUF_TEST_LOOP = 16;
+const size_t PLATFORM_USER_SBUF_TEST_BIG_SIZE = 4096;
+
+struct PlatformUserSbufTestPair {
+    struct HdfSBuf *data;
+    struct HdfSBuf *reply;
+};
+
+class HdfPlatformUserSbufTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HdfPlatformUserSbufTest::SetUpTestCase()
+{
+}
+
+void HdfPlatformUserSbufTest::TearDownTestCase()
+{
+}
+
+void HdfPlatformUserSbufTest::SetUp()
+{
+}
+
+void HdfPlatformUserSbufTest::TearDown()
+{
+}
+
+static void *PlatformUserSbufTestThread(void *arg)
+{
+    struct PlatformUserSbufTestPair *pair = static_cast<struct PlatformUserSbufTestPair *>(arg);
+
+    if (PlatformUserSbufGet(&pair->data, &pair->reply, 0) != HDF_SUCCESS) {
+        pair->data = nullptr;
+        pair->reply = nullptr;
+    }
+    return nullptr;
+}
+
+/**
+  * @tc.name: HdfPlatformUserSbufTestReuse001
+  * @tc.desc: repeated calls on one thread get the same flushed sbuf pair, another thread gets its own
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformUserSbufTest, HdfPlatformUserSbufTestReuse001, TestSize.Level1)
+{
+    struct HdfSBuf *data = nullptr;
+    struct HdfSBuf *reply = nullptr;
+    struct HdfSBuf *firstData = nullptr;
+    struct HdfSBuf *firstReply = nullptr;
+    struct PlatformUserSbufTestPair other = {nullptr, nullptr};
+    pthread_t tid;
+
+    ASSERT_EQ(HDF_SUCCESS, PlatformUserSbufGet(&firstData, &firstReply, 0));
+    ASSERT_NE(nullptr, firstData);
+    ASSERT_NE(nullptr, firstReply);
+    for (size_t i = 0; i < PLATFORM_USER_SBUF_TEST_LOOP; i++) {
+        EXPECT_TRUE(HdfSbufWriteUint32(firstData, static_cast<uint32_t>(i)));
+        EXPECT_TRUE(HdfSbufWriteUint32(firstReply, static_cast<uint32_t>(i)));
+        ASSERT_EQ(HDF_SUCCESS, PlatformUserSbufGet(&data, &reply, 0));
+        EXPECT_EQ(firstData, data);
+        EXPECT_EQ(firstReply, reply);
+        EXPECT_EQ(0u, HdfSbufGetDataSize(data));
+        EXPECT_EQ(0u, HdfSbufGetDataSize(reply));
+    }
+
+    ASSERT_EQ(0, pthread_create(&tid, nullptr, PlatformUserSbufTestThread, &other));
+    ASSERT_EQ(0, pthread_join(tid, nullptr));
+    EXPECT_NE(nullptr, other.data);
+    EXPECT_NE(nullptr, other.reply);
+    EXPECT_NE(firstData, other.data);
+    EXPECT_NE(firstReply, other.reply);
+}
+
+/**
+  * @tc.name: HdfPlatformUserSbufTestReplyGrow001
+  * @tc.desc: the reply is replaced only when a call needs more room than it has, and never shrinks
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfPlatformUserSbufTest, HdfPlatformUserSbufTestReplyGrow001, TestSize.Level1)
+{
+    struct HdfSBuf *data = nullptr;
+    struct HdfSBuf *reply = nullptr;
+    struct HdfSBuf *firstData = nullptr;
+    struct HdfSBuf *bigReply = nullptr;
+    size_t capacity;
+
+    ASSERT_EQ(HDF_SUCCESS, PlatformUserSbufGet(&firstData, &reply, 0));
+    capacity = HdfSbufGetCapacity(reply);
+    EXPECT_GE(capacity, static_cast<size_t>(PLATFORM_USER_SBUF_REPLY_SIZE));
+
+    // anything the current reply can hold keeps it
+    ASSERT_EQ(HDF_SUCCESS, PlatformUserSbufGet(&data, &bigReply, capacity));
+    EXPECT_EQ(reply, bigReply);
+    EXPECT_EQ(capacity, HdfSbufGetCapacity(bigReply));
+
+    ASSERT_EQ(HDF_SUCCESS, PlatformUserSbufGet(&data, &bigReply, capacity + PLATFORM_USER_SBUF_TEST_BIG_SIZE));
+    EXPECT_EQ(firstData, data);
+    EXPECT_GE(HdfSbufGetCapacity(bigReply), capacity + PLATFORM_USER_SBUF_TEST_BIG_SIZE);
+
+    // a later small call takes the grown reply as it is
+    for (size_t i = 0; i < PLATFORM_USER_SBUF_TEST_LOOP; i++) {
+        ASSERT_EQ(HDF_SUCCESS, PlatformUserSbufGet(&data, &reply, 0));
+        EXPECT_EQ(firstData, data);
+        EXPECT_EQ(bigReply, reply);
+    }
+}
@@ -133,3 +133,55 @@ HWTEST_F(HdfLitePwmTest, PwmIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, PwmTestExecute(PWM_IF_PERFORMANCE_TEST));
 }
+
+/**
+  * @tc.name: PwmSetConfigGroupTest001
+  * @tc.desc: pwm grouped config function test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLitePwmTest, PwmSetConfigGroupTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_PWM_TYPE, PWM_SET_CONFIG_GROUP_TEST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    EXPECT_EQ(0, PwmTestExecute(PWM_SET_CONFIG_GROUP_TEST));
+}
+
+/**
+  * @tc.name: PwmSetConfigGroupHookTest001
+  * @tc.desc: pwm grouped config of several devices through the driver's group hook
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLitePwmTest, PwmSetConfigGroupHookTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_PWM_TYPE, PWM_SET_CONFIG_GROUP_HOOK_TEST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    EXPECT_EQ(0, PwmTestExecute(PWM_SET_CONFIG_GROUP_HOOK_TEST));
+}
+
+/**
+  * @tc.name: PwmSetConfigGroupRollbackTest001
+  * @tc.desc: pwm grouped config set device by device is rolled back when one fails
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLitePwmTest, PwmSetConfigGroupRollbackTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_PWM_TYPE, PWM_SET_CONFIG_GROUP_ROLLBACK_TEST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    EXPECT_EQ(0, PwmTestExecute(PWM_SET_CONFIG_GROUP_ROLLBACK_TEST));
+}
+
+/**
+  * @tc.name: PwmSetConfigGroupOwnerTest001
+  * @tc.desc: pwm grouped config takes only the devices their openers joined to the carrier's open
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLitePwmTest, PwmSetConfigGroupOwnerTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_PWM_TYPE, PWM_SET_CONFIG_GROUP_OWNER_TEST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    EXPECT_EQ(0, PwmTestExecute(PWM_SET_CONFIG_GROUP_OWNER_TEST));
+}
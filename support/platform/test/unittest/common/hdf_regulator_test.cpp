@@ -29,6 +29,7 @@ enum RegulatorTestCmd {
     REGULATOR_GET_STATUS_TEST,
     REGULATOR_MULTI_THREAD_TEST,
     REGULATOR_RELIABILITY_TEST,
+    REGULATOR_BATCH_TEST,
 };
 
 class HdfLiteRegulatorTest : public testing::Test {
@@ -166,3 +167,15 @@ HWTEST_F(HdfLiteRegulatorTest, RegulatorTestReliability001, TestSize.Level1)
     struct HdfTestMsg msg = {TEST_PAL_REGULATOR_TYPE, REGULATOR_RELIABILITY_TEST, -1};
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
+
+/**
+  * @tc.name: RegulatorTestBatch001
+  * @tc.desc: regulator batch apply test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteRegulatorTest, RegulatorTestBatch001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_REGULATOR_TYPE, REGULATOR_BATCH_TEST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
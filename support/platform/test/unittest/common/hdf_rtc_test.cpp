@@ -286,4 +286,46 @@ HWTEST_F(HdfRtcTest, testRtcModule001, TestSize.Level1)
 
     EXPECT_EQ(0, RtcTestExecute(RTC_TEST_CMD_RTC_FUNCTION_TEST));
 }
-#endif
\ No newline at end of file
+#endif
+
+/**
+  * @tc.name: testRtcTimeSync001
+  * @tc.desc: rtc read time correlated with the monotonic clock test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfRtcTest, testRtcTimeSync001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = { TEST_PAL_RTC_TYPE, RTC_TEST_CMD_RTC_TIME_SYNC, -1 };
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    EXPECT_EQ(0, RtcTestExecute(RTC_TEST_CMD_RTC_TIME_SYNC));
+}
+
+/**
+  * @tc.name: testRtcTimeSyncBracket001
+  * @tc.desc: rtc read time correlated by bracketing ReadTime, for hardware without ReadTimeSync
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfRtcTest, testRtcTimeSyncBracket001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = { TEST_PAL_RTC_TYPE, RTC_TEST_CMD_RTC_TIME_SYNC_BRACKET, -1 };
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    EXPECT_EQ(0, RtcTestExecute(RTC_TEST_CMD_RTC_TIME_SYNC_BRACKET));
+}
+
+/**
+  * @tc.name: testRtcAlarmGroup001
+  * @tc.desc: rtc alarm group programming test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfRtcTest, testRtcAlarmGroup001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = { TEST_PAL_RTC_TYPE, RTC_TEST_CMD_RTC_ALARM_GROUP, -1 };
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    EXPECT_EQ(0, RtcTestExecute(RTC_TEST_CMD_RTC_ALARM_GROUP));
+}
@@ -127,3 +127,17 @@ HWTEST_F(HdfLiteSpiTest, SpiIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, SpiTestExecute(SPI_PERFORMANCE_TEST));
 }
+
+/**
+  * @tc.name: SpiSgTransferTest001
+  * @tc.desc: spi scatter-gather and asynchronous transfer test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteSpiTest, SpiSgTransferTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_SPI_TYPE, SPI_SG_TRANSFER_TEST, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+
+    EXPECT_EQ(0, SpiTestExecute(SPI_SG_TRANSFER_TEST));
+}
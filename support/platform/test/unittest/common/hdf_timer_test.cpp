@@ -146,3 +146,16 @@ HWTEST_F(HdfLiteTimerTest, TimerTestIfPerformance001, TestSize.Level1)
 {
     EXPECT_EQ(0, TimerTestExecute(TIMER_IF_PERFORMANCE_TEST));
 }
+
+/**
+  * @tc.name: TimerTestEvent001
+  * @tc.desc: timer expiration delivery and jitter test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteTimerTest, TimerTestEvent001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_TIMER_TYPE, TIMER_TEST_EVENT, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    EXPECT_EQ(0, TimerTestExecute(TIMER_TEST_EVENT));
+}
@@ -183,3 +183,19 @@ HWTEST_F(HdfLiteUartTest, UartIfPerformanceTest001, TestSize.Level1)
 {
     EXPECT_EQ(0, UartTestExecute(UART_TEST_CMD_PERFORMANCE));
 }
+
+/**
+  * @tc.name: UartRxStatTest001
+  * @tc.desc: uart receive ring statistics test
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(HdfLiteUartTest, UartRxStatTest001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_PAL_UART_TYPE, UART_TEST_CMD_RX_STAT, -1};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+    printf("%s: kernel test done, then for user...\n", __func__);
+
+    EXPECT_EQ(0, UartTestExecute(UART_TEST_CMD_RX_STAT));
+    printf("%s: exit!\n", __func__);
+}
@@ -81,7 +81,7 @@ void OsalUSleep(uint32_t us)
     struct timespec ts;
 
     ts.tv_sec = (time_t)us / ((long)HDF_KILO_UNIT * HDF_KILO_UNIT);
-    ts.tv_nsec = (time_t)HDF_KILO_UNIT * ((long)(us % HDF_KILO_UNIT));
+    ts.tv_nsec = (time_t)HDF_KILO_UNIT * ((long)(us % ((long)HDF_KILO_UNIT * HDF_KILO_UNIT)));
     result = nanosleep(&ts, &ts);
     if (result != 0) {
         HDF_LOGE("%s OsalUSleep failed %d", __func__, errno);
@@ -845,6 +845,56 @@ HWTEST_F(OsalTest, OsalGetWork009, TestSize.Level3)
 {
     OSAL_TEST_FUNC_DEFINE(OSAL_DELAY_WORK_CANCEL);
 }
+/**
+  * @tc.name: OsalGetWorkPool001
+  * @tc.desc: work pool runs a work of a class without workers on the other class
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(OsalTest, OsalGetWorkPool001, TestSize.Level3)
+{
+    OSAL_TEST_FUNC_DEFINE(OSAL_WORK_POOL_CLASS_FALLBACK);
+}
+/**
+  * @tc.name: OsalGetWorkPool002
+  * @tc.desc: work pool queues a work re-added while running instead of running it twice at once
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(OsalTest, OsalGetWorkPool002, TestSize.Level3)
+{
+    OSAL_TEST_FUNC_DEFINE(OSAL_WORK_POOL_READD);
+}
+/**
+  * @tc.name: OsalGetWorkPool003
+  * @tc.desc: work pool cancel of a queued work
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(OsalTest, OsalGetWorkPool003, TestSize.Level3)
+{
+    OSAL_TEST_FUNC_DEFINE(OSAL_WORK_POOL_CANCEL_QUEUED);
+}
+/**
+  * @tc.name: OsalGetWorkPool004
+  * @tc.desc: work pool cancel of a running work waits for the run
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(OsalTest, OsalGetWorkPool004, TestSize.Level3)
+{
+    OSAL_TEST_FUNC_DEFINE(OSAL_WORK_POOL_CANCEL_RUNNING);
+}
+/**
+  * @tc.name: OsalGetWorkPool005
+  * @tc.desc: work pool destroy with a running and a pending work
+  * @tc.type: FUNC
+  * @tc.require: NA
+  */
+HWTEST_F(OsalTest, OsalGetWorkPool005, TestSize.Level3)
+{
+    OSAL_TEST_FUNC_DEFINE(OSAL_WORK_POOL_DESTROY_PENDING);
+}
 
 /**
   * @tc.name: OsalGetAtomic001
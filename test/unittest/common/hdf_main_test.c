@@ -73,6 +73,9 @@
 #if defined(LOSCFG_DRIVERS_HDF_PLATFORM_TIMER) || defined(CONFIG_DRIVERS_HDF_PLATFORM_TIMER)
 #include "hdf_timer_entry_test.h"
 #endif
+#if defined(LOSCFG_DRIVERS_HDF_PLATFORM_DMAC)
+#include "hdf_dmac_entry_test.h"
+#endif
 #endif
 #if defined(LOSCFG_DRIVERS_HDF_WIFI) || defined(CONFIG_DRIVERS_HDF_WIFI)
 #include "hdf_wifi_test.h"
@@ -97,6 +100,7 @@ HdfTestFuncList g_hdfTestFuncList[] = {
     { TEST_PAL_QUEUE_TYPE, HdfPlatformQueueTestEntry },
     { TEST_PAL_DEVICE_TYPE, HdfPlatformDeviceTestEntry },
     { TEST_PAL_MANAGER_TYPE, HdfPlatformManagerTestEntry },
+    { TEST_PAL_ARBITER_TYPE, HdfPlatformArbiterTestEntry },
 #if defined(LOSCFG_DRIVERS_HDF_PLATFORM_GPIO) || defined(CONFIG_DRIVERS_HDF_PLATFORM_GPIO)
     { TEST_PAL_GPIO_TYPE, HdfGpioTestEntry },
 #endif
@@ -155,6 +159,9 @@ HdfTestFuncList g_hdfTestFuncList[] = {
 #if defined(LOSCFG_DRIVERS_HDF_PLATFORM_TIMER) || defined(CONFIG_DRIVERS_HDF_PLATFORM_TIMER)
         { TEST_PAL_TIMER_TYPE, HdfTimerUnitTestEntry },
 #endif
+#if defined(LOSCFG_DRIVERS_HDF_PLATFORM_DMAC)
+    { TEST_PAL_DMA_TYPE, HdfDmacTestEntry },
+#endif
 #endif
     { TEST_CONFIG_TYPE, HdfConfigEntry },
     { TEST_OSAL_ITEM, HdfOsalEntry },
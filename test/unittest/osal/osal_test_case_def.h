@@ -89,6 +89,11 @@ enum HdfOsalTestCaseCmd {
     OSAL_DELAY_WORK_RUN_CHECK,
     OSAL_WORK_CANCEL,
     OSAL_DELAY_WORK_CANCEL,
+    OSAL_WORK_POOL_CLASS_FALLBACK,
+    OSAL_WORK_POOL_READD,
+    OSAL_WORK_POOL_CANCEL_QUEUED,
+    OSAL_WORK_POOL_CANCEL_RUNNING,
+    OSAL_WORK_POOL_DESTROY_PENDING,
     OSAL_ATOMIC_SET,
     OSAL_ATOMIC_READ,
     OSAL_ATOMIC_INC,
@@ -8,6 +8,7 @@
 
 #include "securec.h"
 #include "hdf_log.h"
+#include "hdf_work_pool.h"
 #include "hdf_workqueue.h"
 #include "osal_atomic.h"
 #include "osal_file.h"
@@ -98,6 +99,200 @@ void TestAddRoute(int cnt)
     }
 }
 
+#define WORK_POOL_BLOCK_MS 20
+#define WORK_POOL_WAIT_MS 1000
+#define WORK_POOL_POLL_MS 1
+
+struct WorkPoolTestWork {
+    struct HdfPoolWork work;
+    OsalAtomic runs;
+    OsalAtomic active;
+    OsalAtomic overlaps;    /* runs that started while another one of the same work was in progress */
+    uint32_t blockMs;
+};
+
+static void WorkPoolTestEntry(void *arg)
+{
+    struct WorkPoolTestWork *test = (struct WorkPoolTestWork *)arg;
+
+    if (OsalAtomicIncReturn(&test->active) > 1) {
+        OsalAtomicInc(&test->overlaps);
+    }
+    if (test->blockMs != 0) {
+        OsalMSleep(test->blockMs);
+    }
+    OsalAtomicDec(&test->active);
+    OsalAtomicInc(&test->runs);
+}
+
+static void WorkPoolTestWorkInit(struct WorkPoolTestWork *test, enum HdfWorkClass workClass, uint32_t blockMs)
+{
+    OsalAtomicSet(&test->runs, 0);
+    OsalAtomicSet(&test->active, 0);
+    OsalAtomicSet(&test->overlaps, 0);
+    test->blockMs = blockMs;
+    (void)HdfPoolWorkInit(&test->work, WorkPoolTestEntry, test, workClass);
+}
+
+static bool WorkPoolTestPoolStart(struct HdfWorkPool *pool, uint16_t realtimeNum, uint16_t backgroundNum, int cmd)
+{
+    struct HdfWorkPoolConfig config;
+    int32_t ret;
+
+    (void)memset_s(&config, sizeof(config), 0, sizeof(config));
+    config.name = "osal_pool";
+    config.classes[HDF_WORK_CLASS_REALTIME].workerNum = realtimeNum;
+    config.classes[HDF_WORK_CLASS_BACKGROUND].workerNum = backgroundNum;
+    ret = HdfWorkPoolInit(pool, &config);
+    UT_TEST_CHECK_RET(ret != HDF_SUCCESS, cmd);
+    return ret == HDF_SUCCESS;
+}
+
+static bool WorkPoolTestWaitRuns(struct WorkPoolTestWork *test, int32_t runs)
+{
+    uint32_t waited;
+
+    for (waited = 0; waited < WORK_POOL_WAIT_MS; waited += WORK_POOL_POLL_MS) {
+        if (OsalAtomicRead(&test->runs) >= runs) {
+            return true;
+        }
+        OsalMSleep(WORK_POOL_POLL_MS);
+    }
+    return false;
+}
+
+static bool WorkPoolTestWaitActive(struct WorkPoolTestWork *test)
+{
+    uint32_t waited;
+
+    for (waited = 0; waited < WORK_POOL_WAIT_MS; waited += WORK_POOL_POLL_MS) {
+        if (OsalAtomicRead(&test->active) > 0) {
+            return true;
+        }
+        OsalMSleep(WORK_POOL_POLL_MS);
+    }
+    return false;
+}
+
+static void OsalTestWorkPoolClassFallback(void)
+{
+    struct HdfWorkPool pool;
+    struct WorkPoolTestWork test;
+
+    if (!WorkPoolTestPoolStart(&pool, 0, 1, OSAL_WORK_POOL_CLASS_FALLBACK)) {
+        return;
+    }
+    WorkPoolTestWorkInit(&test, HDF_WORK_CLASS_REALTIME, 0);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &test.work), OSAL_WORK_POOL_CLASS_FALLBACK);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitRuns(&test, 1), OSAL_WORK_POOL_CLASS_FALLBACK);
+    UT_TEST_CHECK_RET(test.work.workClass != HDF_WORK_CLASS_BACKGROUND, OSAL_WORK_POOL_CLASS_FALLBACK);
+    HdfWorkPoolDestroy(&pool);
+}
+
+static void OsalTestWorkPoolReadd(void)
+{
+    struct HdfWorkPool pool;
+    struct WorkPoolTestWork test;
+    unsigned int status;
+
+    if (!WorkPoolTestPoolStart(&pool, 0, 2, OSAL_WORK_POOL_READD)) {
+        return;
+    }
+    WorkPoolTestWorkInit(&test, HDF_WORK_CLASS_BACKGROUND, WORK_POOL_BLOCK_MS);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &test.work), OSAL_WORK_POOL_READD);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitActive(&test), OSAL_WORK_POOL_READD);
+    // re-added while running, it's queued once more and not run on the idle second worker
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &test.work), OSAL_WORK_POOL_READD);
+    UT_TEST_CHECK_RET(HdfWorkPoolAdd(&pool, &test.work), OSAL_WORK_POOL_READD);
+    status = HdfPoolWorkBusy(&test.work);
+    UT_TEST_CHECK_RET((status & HDF_WORK_BUSY_PENDING) == 0, OSAL_WORK_POOL_READD);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitRuns(&test, 2), OSAL_WORK_POOL_READD);
+    UT_TEST_CHECK_RET(OsalAtomicRead(&test.overlaps) != 0, OSAL_WORK_POOL_READD);
+    OsalMSleep(WORK_POOL_BLOCK_MS);
+    UT_TEST_CHECK_RET(OsalAtomicRead(&test.runs) != 2, OSAL_WORK_POOL_READD);
+    HdfWorkPoolDestroy(&pool);
+}
+
+static void OsalTestWorkPoolCancelQueued(void)
+{
+    struct HdfWorkPool pool;
+    struct WorkPoolTestWork blocker;
+    struct WorkPoolTestWork test;
+
+    if (!WorkPoolTestPoolStart(&pool, 0, 1, OSAL_WORK_POOL_CANCEL_QUEUED)) {
+        return;
+    }
+    WorkPoolTestWorkInit(&blocker, HDF_WORK_CLASS_BACKGROUND, WORK_POOL_BLOCK_MS);
+    WorkPoolTestWorkInit(&test, HDF_WORK_CLASS_BACKGROUND, 0);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &blocker.work), OSAL_WORK_POOL_CANCEL_QUEUED);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitActive(&blocker), OSAL_WORK_POOL_CANCEL_QUEUED);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &test.work), OSAL_WORK_POOL_CANCEL_QUEUED);
+    UT_TEST_CHECK_RET(!HdfPoolWorkCancelSync(&test.work), OSAL_WORK_POOL_CANCEL_QUEUED);
+    UT_TEST_CHECK_RET(test.work.pool != NULL, OSAL_WORK_POOL_CANCEL_QUEUED);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitRuns(&blocker, 1), OSAL_WORK_POOL_CANCEL_QUEUED);
+    OsalMSleep(WORK_POOL_BLOCK_MS);
+    UT_TEST_CHECK_RET(OsalAtomicRead(&test.runs) != 0, OSAL_WORK_POOL_CANCEL_QUEUED);
+    HdfWorkPoolDestroy(&pool);
+}
+
+static void OsalTestWorkPoolCancelRunning(void)
+{
+    struct HdfWorkPool pool;
+    struct WorkPoolTestWork test;
+
+    if (!WorkPoolTestPoolStart(&pool, 1, 0, OSAL_WORK_POOL_CANCEL_RUNNING)) {
+        return;
+    }
+    WorkPoolTestWorkInit(&test, HDF_WORK_CLASS_REALTIME, WORK_POOL_BLOCK_MS);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &test.work), OSAL_WORK_POOL_CANCEL_RUNNING);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitActive(&test), OSAL_WORK_POOL_CANCEL_RUNNING);
+    // nothing pending to cancel, but it returns only once the run is over
+    UT_TEST_CHECK_RET(HdfPoolWorkCancelSync(&test.work), OSAL_WORK_POOL_CANCEL_RUNNING);
+    UT_TEST_CHECK_RET(OsalAtomicRead(&test.active) != 0, OSAL_WORK_POOL_CANCEL_RUNNING);
+    UT_TEST_CHECK_RET(OsalAtomicRead(&test.runs) != 1, OSAL_WORK_POOL_CANCEL_RUNNING);
+    UT_TEST_CHECK_RET(HdfPoolWorkBusy(&test.work) != 0, OSAL_WORK_POOL_CANCEL_RUNNING);
+    HdfWorkPoolDestroy(&pool);
+}
+
+static void OsalTestWorkPoolDestroyPending(void)
+{
+    struct HdfWorkPool pool;
+    struct WorkPoolTestWork idle;
+    struct WorkPoolTestWork blocker;
+    struct WorkPoolTestWork test;
+
+    if (!WorkPoolTestPoolStart(&pool, 0, 1, OSAL_WORK_POOL_DESTROY_PENDING)) {
+        return;
+    }
+    WorkPoolTestWorkInit(&idle, HDF_WORK_CLASS_BACKGROUND, 0);
+    WorkPoolTestWorkInit(&blocker, HDF_WORK_CLASS_BACKGROUND, WORK_POOL_BLOCK_MS);
+    WorkPoolTestWorkInit(&test, HDF_WORK_CLASS_BACKGROUND, 0);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &idle.work), OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitRuns(&idle, 1), OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &blocker.work), OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(!WorkPoolTestWaitActive(&blocker), OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(!HdfWorkPoolAdd(&pool, &test.work), OSAL_WORK_POOL_DESTROY_PENDING);
+
+    // the running work completes, the pending one is dropped, and no work points at the pool any more
+    HdfWorkPoolDestroy(&pool);
+    UT_TEST_CHECK_RET(OsalAtomicRead(&blocker.runs) != 1, OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(OsalAtomicRead(&test.runs) != 0, OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(test.work.status != 0, OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(idle.work.pool != NULL || blocker.work.pool != NULL || test.work.pool != NULL,
+        OSAL_WORK_POOL_DESTROY_PENDING);
+    UT_TEST_CHECK_RET(HdfPoolWorkCancelSync(&test.work), OSAL_WORK_POOL_DESTROY_PENDING);
+}
+
+static void OsalTestWorkPool(void)
+{
+    HDF_LOGE("%s test begin", __func__);
+    OsalTestWorkPoolClassFallback();
+    OsalTestWorkPoolReadd();
+    OsalTestWorkPoolCancelQueued();
+    OsalTestWorkPoolCancelRunning();
+    OsalTestWorkPoolDestroyPending();
+}
+
 #define ATOMIC_INC_VALUE 2
 static void OsalTestAtomic(void)
 {
@@ -211,6 +406,7 @@ static void OsalTestFile(int flag)
 void OsalTestWork(int flag)
 {
     TestWorkInit();
+    OsalTestWorkPool();
     OsalTestAtomic();
     OsalTestFile(flag);
 }
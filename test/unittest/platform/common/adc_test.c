@@ -22,6 +22,9 @@
 #define TEST_ADC_VAL_NUM           50
 #define ADC_TEST_WAIT_TIMES      100
 #define ADC_TEST_STACK_SIZE        (1024 * 64)
+#define ADC_TEST_SCAN_RATE         200
+#define ADC_TEST_SCAN_FRAMES       64
+#define ADC_TEST_SCAN_WAIT_MS      200
 
 static int32_t AdcTestGetConfig(struct AdcTestConfig *config)
 {
@@ -251,6 +254,104 @@ static int32_t AdcIfPerformanceTest(void)
     return HDF_FAILURE;
 }
 
+static int32_t AdcTestScanCheck(struct AdcTester *tester, const uint32_t *vals, const uint64_t *timestamps,
+    int32_t frames)
+{
+    int32_t i;
+
+    for (i = 0; i < frames; i++) {
+        if (vals[i] >= (1U << tester->config.dataWidth)) {
+            HDF_LOGE("%s: frame %d value %u out of range", __func__, i, vals[i]);
+            return HDF_FAILURE;
+        }
+        if (i > 0 && timestamps[i] < timestamps[i - 1]) {
+            HDF_LOGE("%s: frame %d timestamp goes back", __func__, i);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t AdcTestScan(void)
+{
+    int32_t ret;
+    int32_t frames;
+    struct AdcTester *tester = NULL;
+    struct AdcScanCfg cfg;
+    uint32_t vals[ADC_TEST_SCAN_FRAMES];
+    uint64_t timestamps[ADC_TEST_SCAN_FRAMES];
+
+    HDF_LOGI("%s: enter", __func__);
+    tester = AdcTesterGet();
+    if (tester == NULL || tester->handle == NULL) {
+        HDF_LOGE("%s: get tester failed", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    cfg.chanMask = 1U << tester->config.channel;
+    cfg.rateHz = ADC_TEST_SCAN_RATE;
+    cfg.frameNum = ADC_TEST_SCAN_FRAMES;
+    ret = AdcScanStart(tester->handle, &cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: scan start failed, ret:%d", __func__, ret);
+        return ret;
+    }
+    OsalMSleep(ADC_TEST_SCAN_WAIT_MS);
+    // one call drains every frame sampled so far
+    frames = AdcScanRead(tester->handle, vals, timestamps, ADC_TEST_SCAN_FRAMES);
+    (void)AdcScanStop(tester->handle);
+    if (frames <= 0) {
+        HDF_LOGE("%s: no frame scanned, ret:%d", __func__, frames);
+        return HDF_FAILURE;
+    }
+    HDF_LOGI("%s: %d frames in %u ms", __func__, frames, ADC_TEST_SCAN_WAIT_MS);
+    return AdcTestScanCheck(tester, vals, timestamps, frames);
+}
+
+static int32_t AdcTestScanClose(void)
+{
+#ifndef __USER__
+    // a kernel handle is the device itself, a scan is left to whoever started it
+    return HDF_SUCCESS;
+#else
+    int32_t ret;
+    DevHandle handle = NULL;
+    struct AdcTester *tester = NULL;
+    struct AdcScanCfg cfg;
+
+    tester = AdcTesterGet();
+    if (tester == NULL || tester->handle == NULL) {
+        HDF_LOGE("%s: get tester failed", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    handle = AdcOpen(tester->config.devNum);
+    if (handle == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    cfg.chanMask = 1U << tester->config.channel;
+    cfg.rateHz = ADC_TEST_SCAN_RATE;
+    cfg.frameNum = ADC_TEST_SCAN_FRAMES;
+    ret = AdcScanStart(handle, &cfg);
+    // closed while scanning, the scan goes with the handle
+    AdcClose(handle);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: scan start failed, ret:%d", __func__, ret);
+        return ret;
+    }
+    // the device is free for another scan, and the old handle's scan is not readable through this one
+    if (AdcScanRead(tester->handle, &cfg.chanMask, NULL, 1) != HDF_ERR_NOT_SUPPORT) {
+        HDF_LOGE("%s: read a scan this handle didn't start", __func__);
+        return HDF_FAILURE;
+    }
+    ret = AdcScanStart(tester->handle, &cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: scan left running after close, ret:%d", __func__, ret);
+        return HDF_FAILURE;
+    }
+    return AdcScanStop(tester->handle);
+#endif
+}
+
 struct AdcTestEntry {
     int cmd;
     int32_t (*func)(void);
@@ -262,6 +363,8 @@ static struct AdcTestEntry g_entry[] = {
     { ADC_TEST_CMD_MULTI_THREAD, AdcTestMultiThread, "AdcTestMultiThread" },
     { ADC_TEST_CMD_RELIABILITY, AdcTestReliability, "AdcTestReliability" },
     { ADC_IF_PERFORMANCE_TEST, AdcIfPerformanceTest, "AdcIfPerformanceTest" },
+    { ADC_TEST_CMD_SCAN, AdcTestScan, "AdcTestScan" },
+    { ADC_TEST_CMD_SCAN_CLOSE, AdcTestScanClose, "AdcTestScanClose" },
 };
 
 int32_t AdcTestExecute(int cmd)
@@ -35,6 +35,8 @@ enum AdcTestCmd {
     ADC_TEST_CMD_MULTI_THREAD,
     ADC_TEST_CMD_RELIABILITY,
     ADC_IF_PERFORMANCE_TEST,
+    ADC_TEST_CMD_SCAN,
+    ADC_TEST_CMD_SCAN_CLOSE,
     ADC_TEST_CMD_MAX,
 };
 
@@ -12,12 +12,33 @@
 #include "osal_thread.h"
 #include "osal_time.h"
 #include "securec.h"
+#ifndef __USER__
+#include "dac_core.h"
+#include "osal_mem.h"
+#include "virtual/dac_virtual.h"
+#endif
 
 #define HDF_LOG_TAG dac_test_c
 #define DAC_TEST_WAIT_TIMES        100
 #define TEST_DAC_VAL_NUM           50
 #define DAC_TEST_STACK_SIZE        (1024 * 64)
 #define DAC_TEST_WAIT_TIMEOUT      20
+#define DAC_TEST_STREAM_RATE       1000
+#define DAC_TEST_STREAM_SAMPLES    256
+#define DAC_TEST_STREAM_LOW        64
+#define DAC_TEST_STREAM_MS         500
+#define DAC_TEST_STREAM_WAIT_MS    1000
+#define DAC_TEST_STREAM_TOLERANCE  10  // played may be off the count due by the elapsed time by a tenth
+#define DAC_TEST_STREAM_GAP_MAX_US 20000
+#define DAC_TEST_SOFT_RATE         250
+#define DAC_TEST_SOFT_SAMPLES      64
+#define DAC_TEST_SOFT_LOW          16
+
+struct DacTestStreamResult {
+    uint32_t written;
+    uint64_t elapsedMs;  /* from the start of the feeding to the last status */
+    struct DacStreamStatus status;
+};
 
 static int32_t DacTestGetConfig(struct DacTestConfig *config)
 {
@@ -260,6 +281,249 @@ static int32_t DacIfPerformanceTest(void)
     return HDF_SUCCESS;
 }
 
+static int32_t DacTestStreamFeed(DevHandle handle, uint32_t samples, struct DacTestStreamResult *result)
+{
+    int32_t ret;
+    uint32_t i;
+    uint64_t startMs;
+    uint32_t ramp[DAC_TEST_STREAM_SAMPLES];
+
+    // sample n has the value n, so what the controller received can be checked for gaps and reordering
+    startMs = OsalGetSysTimeMs();
+    while (OsalGetSysTimeMs() - startMs < DAC_TEST_STREAM_MS) {
+        for (i = 0; i < samples; i++) {
+            ramp[i] = result->written + i;
+        }
+        ret = DacStreamWrite(handle, ramp, samples);
+        if (ret < 0) {
+            HDF_LOGE("%s: stream write failed:%d", __func__, ret);
+            return ret;
+        }
+        result->written += (uint32_t)ret;
+        ret = DacStreamWait(handle, DAC_TEST_STREAM_WAIT_MS, &result->status);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: stream wait failed:%d", __func__, ret);
+            return ret;
+        }
+        result->elapsedMs = OsalGetSysTimeMs() - startMs;
+    }
+    return HDF_SUCCESS;
+}
+
+// refilled at every low watermark the ring must never run dry, and it drains at the configured rate
+static int32_t DacTestStreamCheck(const char *name, const struct DacTestStreamResult *result, uint32_t rateHz)
+{
+    uint64_t expected;
+    uint64_t played = result->status.played;
+
+    expected = result->elapsedMs * rateHz / 1000; // 1000: ms per second
+    HDF_LOGI("%s: written:%u, played:%llu in %llu ms, expected:%llu, underruns:%u", name, result->written,
+        (unsigned long long)played, (unsigned long long)result->elapsedMs, (unsigned long long)expected,
+        result->status.underruns);
+    if (result->status.underruns != 0 || played > result->written ||
+        played + expected / DAC_TEST_STREAM_TOLERANCE < expected ||
+        played > expected + expected / DAC_TEST_STREAM_TOLERANCE) {
+        HDF_LOGE("%s: stream not stable", name);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+#ifndef __USER__
+// the dma of the virtual dac received the ramp in order, and no tick of it was starved
+static int32_t DacTestStreamCheckRecord(uint32_t devNum, const struct DacTestStreamResult *result)
+{
+    int32_t ret;
+    uint64_t n;
+    struct VirtualDacStreamRecord *record = NULL;
+
+    record = (struct VirtualDacStreamRecord *)OsalMemCalloc(sizeof(*record));
+    if (record == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    ret = VirtualDacGetStreamRecord(devNum, record);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: dac %u is not the virtual one:%d", __func__, devNum, ret);
+        OsalMemFree(record);
+        return ret;
+    }
+    HDF_LOGI("%s: received:%llu, max tick gap:%llu us", __func__,
+        (unsigned long long)record->received, (unsigned long long)record->maxGapUs);
+    if (record->received < result->status.played || record->received > result->written ||
+        record->maxGapUs > DAC_TEST_STREAM_GAP_MAX_US) {
+        HDF_LOGE("%s: stream record not match", __func__);
+        OsalMemFree(record);
+        return HDF_FAILURE;
+    }
+    n = (record->received > VIRTUAL_DAC_CAPTURE_MAX) ? (record->received - VIRTUAL_DAC_CAPTURE_MAX) : 0;
+    for (; n < record->received; n++) {
+        if (record->capture[n % VIRTUAL_DAC_CAPTURE_MAX] != (uint32_t)n) {
+            HDF_LOGE("%s: sample %llu is %u", __func__, (unsigned long long)n,
+                record->capture[n % VIRTUAL_DAC_CAPTURE_MAX]);
+            OsalMemFree(record);
+            return HDF_FAILURE;
+        }
+    }
+    OsalMemFree(record);
+    return HDF_SUCCESS;
+}
+#endif
+
+static int32_t DacTestStream(void)
+{
+    int32_t ret;
+    struct DacTester *tester = NULL;
+    struct DacTestStreamResult result = {0};
+    struct DacStreamCfg cfg = {0};
+
+    tester = DacTesterGet();
+    if (tester == NULL || tester->handle == NULL) {
+        HDF_LOGE("%s: get tester failed", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    cfg.channel = tester->config.channel;
+    cfg.rateHz = DAC_TEST_STREAM_RATE;
+    cfg.sampleNum = DAC_TEST_STREAM_SAMPLES;
+    cfg.lowWatermark = DAC_TEST_STREAM_LOW;
+    ret = DacStreamStart(tester->handle, &cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: stream start failed:%d", __func__, ret);
+        DacTesterPut(tester);
+        return ret;
+    }
+
+    ret = DacTestStreamFeed(tester->handle, DAC_TEST_STREAM_SAMPLES, &result);
+    (void)DacStreamStop(tester->handle);
+    if (ret == HDF_SUCCESS) {
+        ret = DacTestStreamCheck(__func__, &result, DAC_TEST_STREAM_RATE);
+    }
+#ifndef __USER__
+    if (ret == HDF_SUCCESS) {
+        ret = DacTestStreamCheckRecord(tester->config.devNum, &result);
+    }
+#endif
+    DacTesterPut(tester);
+    return ret;
+}
+
+#ifndef __USER__
+/* a controller without streamStart, the core outputs the stream through write from its own thread */
+struct DacTestSoft {
+    struct DacDevice device;
+    uint32_t writes;
+    uint32_t disorders;  /* writes of another value than the next one of the ramp */
+    uint64_t lastUs;
+    uint64_t maxGapUs;
+};
+
+static struct DacTestSoft g_dacSoft;
+
+static int32_t DacTestSoftWrite(struct DacDevice *device, uint32_t channel, uint32_t val)
+{
+    uint64_t now = PlatformMonoTimeUs();
+
+    (void)device;
+    (void)channel;
+    if (val != g_dacSoft.writes) {
+        g_dacSoft.disorders++;
+    }
+    if (g_dacSoft.writes != 0 && now - g_dacSoft.lastUs > g_dacSoft.maxGapUs) {
+        g_dacSoft.maxGapUs = now - g_dacSoft.lastUs;
+    }
+    g_dacSoft.lastUs = now;
+    g_dacSoft.writes++;
+    return HDF_SUCCESS;
+}
+
+static int32_t DacTestSoftStartStop(struct DacDevice *device)
+{
+    (void)device;
+    return HDF_SUCCESS;
+}
+
+static const struct DacMethod g_dacSoftMethod = {
+    .write = DacTestSoftWrite,
+    .start = DacTestSoftStartStop,
+    .stop = DacTestSoftStartStop,
+};
+
+static int32_t DacTestSoftAdd(void)
+{
+    uint32_t num;
+
+    (void)memset_s(&g_dacSoft, sizeof(g_dacSoft), 0, sizeof(g_dacSoft));
+    g_dacSoft.device.ops = &g_dacSoftMethod;
+    g_dacSoft.device.chanNum = 1;
+    // the fake takes the last free number, after the real controllers
+    for (num = DAC_DEVICES_MAX; num > 0; num--) {
+        if (DacDeviceGet(num - 1) == NULL) {
+            g_dacSoft.device.devNum = num - 1;
+            return DacDeviceAdd(&g_dacSoft.device);
+        }
+    }
+    return HDF_ERR_DEVICE_BUSY;
+}
+
+static int32_t DacTestStreamSoftRun(DevHandle handle, struct DacTestStreamResult *result)
+{
+    int32_t ret;
+    struct DacStreamCfg cfg = {0};
+
+    cfg.channel = 0;
+    cfg.rateHz = DAC_TEST_SOFT_RATE;
+    cfg.sampleNum = DAC_TEST_SOFT_SAMPLES;
+    cfg.lowWatermark = DAC_TEST_SOFT_LOW;
+    ret = DacStreamStart(handle, &cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: stream start failed:%d", __func__, ret);
+        return ret;
+    }
+    ret = DacTestStreamFeed(handle, DAC_TEST_SOFT_SAMPLES, result);
+    (void)DacStreamStop(handle);
+    return ret;
+}
+#endif
+
+static int32_t DacTestStreamSoft(void)
+{
+#ifdef __USER__
+    // the controller is a fake device, only reachable in kernel
+    HDF_LOGI("%s: skipped in user space", __func__);
+    return HDF_SUCCESS;
+#else
+    int32_t ret;
+    DevHandle handle = NULL;
+    struct DacTestStreamResult result = {0};
+
+    ret = DacTestSoftAdd();
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: add fake dac failed:%d", __func__, ret);
+        return ret;
+    }
+    handle = DacOpen(g_dacSoft.device.devNum);
+    if (handle == NULL) {
+        HDF_LOGE("%s: open fake dac %u failed", __func__, g_dacSoft.device.devNum);
+        DacDeviceRemove(&g_dacSoft.device);
+        return HDF_FAILURE;
+    }
+    ret = DacTestStreamSoftRun(handle, &result);
+    DacClose(handle);
+    DacDeviceRemove(&g_dacSoft.device);
+    if (ret == HDF_SUCCESS) {
+        ret = DacTestStreamCheck(__func__, &result, DAC_TEST_SOFT_RATE);
+    }
+    // the core thread wrote the ramp in order, a sample per period, and stopped writing on stop
+    HDF_LOGI("%s: writes:%u, disorders:%u, max gap:%llu us", __func__, g_dacSoft.writes, g_dacSoft.disorders,
+        (unsigned long long)g_dacSoft.maxGapUs);
+    if (ret == HDF_SUCCESS && (g_dacSoft.disorders != 0 || g_dacSoft.writes < result.status.played ||
+        g_dacSoft.writes > result.written || g_dacSoft.maxGapUs > DAC_TEST_STREAM_GAP_MAX_US)) {
+        HDF_LOGE("%s: soft stream output not match", __func__);
+        ret = HDF_FAILURE;
+    }
+    return ret;
+#endif
+}
+
 struct DacTestEntry {
     int cmd;
     int32_t (*func)(void);
@@ -270,6 +534,8 @@ static struct DacTestEntry g_entry[] = {
     { DAC_TEST_CMD_MULTI_THREAD, DacTestMultiThread, "DacTestMultiThread" },
     { DAC_TEST_CMD_RELIABILITY, DacTestReliability, "DacTestReliability" },
     { DAC_TEST_CMD_IF_PERFORMANCE, DacIfPerformanceTest, "DacIfPerformanceTest" },
+    { DAC_TEST_CMD_STREAM, DacTestStream, "DacTestStream" },
+    { DAC_TEST_CMD_STREAM_SOFT, DacTestStreamSoft, "DacTestStreamSoft" },
 };
 
 int32_t DacTestExecute(int cmd)
@@ -35,6 +35,8 @@ enum DacTestCmd {
     DAC_TEST_CMD_MULTI_THREAD,
     DAC_TEST_CMD_RELIABILITY,
     DAC_TEST_CMD_IF_PERFORMANCE,
+    DAC_TEST_CMD_STREAM,
+    DAC_TEST_CMD_STREAM_SOFT,
     DAC_TEST_CMD_MAX,
 };
 
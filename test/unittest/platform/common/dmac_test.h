@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef DMAC_TEST_H
+#define DMAC_TEST_H
+
+#include "hdf_base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum DmacTestCmd {
+    DMAC_TEST_CHAIN_M2M = 0,
+    DMAC_TEST_CHAIN_ENABLE_FAIL = 1,
+    DMAC_TEST_CMD_MAX,
+};
+
+int32_t DmacTestExecute(int cmd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMAC_TEST_H */
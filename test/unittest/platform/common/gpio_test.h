@@ -9,6 +9,7 @@
 #ifndef GPIO_TEST_H
 #define GPIO_TEST_H
 
+#include "gpio_if.h"
 #include "hdf_base.h"
 
 #ifdef __cplusplus
@@ -25,7 +26,11 @@ enum GpioTestCmd {
     GPIO_TEST_IRQ_THREAD = 4,
     GPIO_TEST_RELIABILITY = 5,
     GPIO_TEST_PERFORMANCE = 6,
-    GPIO_TEST_MAX = 7,
+    GPIO_TEST_WRITE_READ_MULTI = 7,
+    GPIO_TEST_IRQ_EVENT = 8,
+    GPIO_TEST_IRQ_COALESCE = 9,
+    GPIO_TEST_RANGE_TABLE = 10,
+    GPIO_TEST_MAX = 11,
 };
 
 struct GpioTestConfig {
@@ -42,6 +47,7 @@ struct GpioTester {
     uint16_t total;
     uint16_t fails;
     uint32_t irqTimeout;
+    struct GpioIrqEvent irqEvent;
 };
 
 #ifdef __cplusplus
@@ -10,8 +10,11 @@
 #include "device_resource_if.h"
 #include "hdf_base.h"
 #include "hdf_log.h"
+#include "hdmi_core.h"
 #include "hdmi_if.h"
+#include "osal_mem.h"
 #include "osal_time.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG hdmi_test_c
 
@@ -185,6 +188,172 @@ static int32_t TestHdmiHpdRegisterAndUnregister(struct HdmiTester *tester)
     return ret;
 }
 
+/*
+ * EDID cache test: a fake ddc serves a canned block0 plus one CTA block carrying an HDR SMDB
+ * and a dolby VSVDB, and counts the bytes read.
+ */
+#define HDMI_TEST_EDID_SIZE      (HDMI_EDID_SINGLE_BLOCK_SIZE * 2)
+#define HDMI_TEST_EDID_DTD_START 24
+#define HDMI_TEST_EDID_MAX_LUM   8    /* ext block offset of the HDR SMDB max luminance */
+
+static uint8_t g_testEdid[HDMI_TEST_EDID_SIZE];
+static uint32_t g_testEdidReadBytes;
+
+static const uint8_t g_testEdidBlock0[] = {
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00,    /* header */
+    0x4C, 0x2D, 0x34, 0x12, 0x01, 0x00, 0x00, 0x00,    /* vendor, product code, serial number */
+    0x10, 0x1E, 0x01, 0x03,                            /* week, year, version, revision */
+};
+
+static const uint8_t g_testEdidExtBlock[] = {
+    HDMI_EDID_CTA_EXTENSION_TAG, HDMI_EDID_CTA_EXTENSION3_REVISION, HDMI_TEST_EDID_DTD_START, 0x00,
+    0xE4, HDMI_EDID_EXT_HDR_SMDB, 0x05, 0x01, 0x80,    /* HDR SMDB: sdr and smpte st2084, type1 */
+    0xEE, HDMI_EDID_EXT_VSVDB, 0x46, 0xD0, 0x00, 0x20, /* dolby VSVDB version 1 */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static void TestHdmiEdidFixCheckSum(uint8_t *block)
+{
+    uint32_t i;
+    uint8_t sum = 0;
+
+    for (i = 0; i < HDMI_EDID_CHECKSUM_ADDR; i++) {
+        sum += block[i];
+    }
+    block[HDMI_EDID_CHECKSUM_ADDR] = (uint8_t)(0x100 - sum);
+}
+
+static int32_t TestHdmiEdidBuild(void)
+{
+    uint8_t *ext = g_testEdid + HDMI_EDID_SINGLE_BLOCK_SIZE;
+
+    if (memset_s(g_testEdid, sizeof(g_testEdid), 0, sizeof(g_testEdid)) != EOK ||
+        memcpy_s(g_testEdid, sizeof(g_testEdid), g_testEdidBlock0, sizeof(g_testEdidBlock0)) != EOK ||
+        memcpy_s(ext, HDMI_EDID_SINGLE_BLOCK_SIZE, g_testEdidExtBlock, sizeof(g_testEdidExtBlock)) != EOK) {
+        return HDF_ERR_IO;
+    }
+    g_testEdid[HDMI_EDID_EXTENSION_BLOCK_ADDR] = 1;
+    TestHdmiEdidFixCheckSum(g_testEdid);
+    TestHdmiEdidFixCheckSum(ext);
+    return HDF_SUCCESS;
+}
+
+static int32_t TestHdmiFakeDdcTransfer(struct HdmiCntlr *cntlr, struct HdmiDdcCfg *ddcCfg)
+{
+    uint32_t addr = ddcCfg->segment * HDMI_EDID_SINGLE_BLOCK_SIZE * HDMI_EDID_BLOCKS_PER_SEGMENT + ddcCfg->offset;
+    (void)cntlr;
+
+    if (ddcCfg->data == NULL || addr + ddcCfg->dataLen > HDMI_EDID_TOTAL_SIZE) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    /* blocks the fake sink does not have read back as zero */
+    (void)memset_s(ddcCfg->data, ddcCfg->dataLen, 0, ddcCfg->dataLen);
+    if (addr < HDMI_TEST_EDID_SIZE) {
+        (void)memcpy_s(ddcCfg->data, ddcCfg->dataLen, g_testEdid + addr,
+            (ddcCfg->dataLen < HDMI_TEST_EDID_SIZE - addr) ? ddcCfg->dataLen : HDMI_TEST_EDID_SIZE - addr);
+    }
+    g_testEdidReadBytes += ddcCfg->dataLen;
+    return HDF_SUCCESS;
+}
+
+static struct HdmiCntlrOps g_testHdmiFakeOps = {
+    .ddcTransfer = TestHdmiFakeDdcTransfer,
+};
+
+static int32_t TestHdmiEdidCacheRead(struct HdmiCntlr *cntlr, struct HdmiEdid *edid, uint32_t *bytes)
+{
+    int32_t ret;
+
+    g_testEdidReadBytes = 0;
+    ret = HdmiEdidReset(edid);
+    if (ret == HDF_SUCCESS) {
+        ret = HdmiEdidCachedRead(edid, &(cntlr->ddc), &(cntlr->edidCache));
+    }
+    *bytes = g_testEdidReadBytes;
+    return ret;
+}
+
+static int32_t TestHdmiEdidCacheCheck(struct HdmiCntlr *cntlr, struct HdmiEdid *edid)
+{
+    uint32_t missBytes;
+    uint32_t hitBytes;
+    uint8_t *ext = g_testEdid + HDMI_EDID_SINGLE_BLOCK_SIZE;
+
+    if (TestHdmiEdidCacheRead(cntlr, edid, &missBytes) != HDF_SUCCESS || cntlr->edidCache.hits != 0) {
+        HDF_LOGE("%s: first read fail!", __func__);
+        return HDF_FAILURE;
+    }
+    /* a miss reads every block once, plus the checksum probe of the extension block */
+    if (missBytes != HDMI_TEST_EDID_SIZE + 1) {
+        HDF_LOGE("%s: miss read %u bytes!", __func__, missBytes);
+        return HDF_FAILURE;
+    }
+    if (TestHdmiEdidCacheRead(cntlr, edid, &hitBytes) != HDF_SUCCESS || cntlr->edidCache.hits != 1 ||
+        hitBytes >= missBytes || memcmp(edid->raw, g_testEdid, HDMI_TEST_EDID_SIZE) != 0 ||
+        edid->sinkCap.vendorInfo.productCode != 0x1234) {
+        HDF_LOGE("%s: cached read fail, bytes %u/%u!", __func__, hitBytes, missBytes);
+        return HDF_FAILURE;
+    }
+    if (HdmiEdidGetHdrCap(edid)->eotf.sdr != true || HdmiEdidGetHdrCap(edid)->smType1 != true ||
+        HdmiEdidGetHdrCap(edid)->maxLuminancedata != 0x80 ||
+        HdmiEdidGetDolbyCap(edid)->oui != HDMI_EDID_VSVDB_DOLBY_OUI) {
+        HDF_LOGE("%s: lazy hdr/dolby cap fail!", __func__);
+        return HDF_FAILURE;
+    }
+
+    /* the same sink with a changed extension block must be read again */
+    ext[HDMI_TEST_EDID_MAX_LUM] = 0x90;
+    TestHdmiEdidFixCheckSum(ext);
+    if (TestHdmiEdidCacheRead(cntlr, edid, &missBytes) != HDF_SUCCESS || cntlr->edidCache.hits != 1 ||
+        HdmiEdidGetHdrCap(edid)->maxLuminancedata != 0x90) {
+        HDF_LOGE("%s: changed sink hit the cache!", __func__);
+        return HDF_FAILURE;
+    }
+
+    /* an extension block that fails to phase still reads, but is not cached */
+    ext[HDMI_EDID_CHECKSUM_ADDR]++;
+    if (TestHdmiEdidCacheRead(cntlr, edid, &missBytes) != HDF_SUCCESS || edid->edidPhase ||
+        memcmp(edid->raw, g_testEdid, HDMI_TEST_EDID_SIZE) != 0 ||
+        TestHdmiEdidCacheRead(cntlr, edid, &missBytes) != HDF_SUCCESS || cntlr->edidCache.hits != 1) {
+        HDF_LOGE("%s: unphased edid fail or cached!", __func__);
+        return HDF_FAILURE;
+    }
+    TestHdmiEdidFixCheckSum(ext);
+    HDF_LOGI("%s: miss %u bytes, hit %u bytes.", __func__, missBytes, hitBytes);
+    return HDF_SUCCESS;
+}
+
+static int32_t TestHdmiEdidCache(struct HdmiTester *tester)
+{
+    int32_t ret;
+    struct HdmiCntlr *cntlr = NULL;
+    struct HdmiEdid *edid = NULL;
+    (void)tester;
+
+    if (TestHdmiEdidBuild() != HDF_SUCCESS) {
+        return HDF_ERR_IO;
+    }
+    cntlr = (struct HdmiCntlr *)OsalMemCalloc(sizeof(*cntlr));
+    edid = (struct HdmiEdid *)OsalMemCalloc(sizeof(*edid));
+    if (cntlr == NULL || edid == NULL) {
+        OsalMemFree(cntlr);
+        OsalMemFree(edid);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    cntlr->ops = &g_testHdmiFakeOps;
+    cntlr->ddc.priv = cntlr;
+    (void)OsalMutexInit(&(cntlr->mutex));
+    (void)OsalMutexInit(&(cntlr->ddc.ddcMutex));
+
+    ret = TestHdmiEdidCacheCheck(cntlr, edid);
+
+    (void)OsalMutexDestroy(&(cntlr->ddc.ddcMutex));
+    (void)OsalMutexDestroy(&(cntlr->mutex));
+    OsalMemFree(edid);
+    OsalMemFree(cntlr);
+    return ret;
+}
+
 struct HdmiTestFunc g_hdmiTestFunc[] = {
     { HDMI_START_AND_STOP_01, TestHdmiStartAndStop },
     { HDMI_SET_AUDIO_ATTR_01, TestHdmiSetAudioAttr },
@@ -194,6 +363,7 @@ struct HdmiTestFunc g_hdmiTestFunc[] = {
     { HDMI_EDID_RAW_DATA_GET_01, TestHdmiEdidRawDataGet },
     { HDMI_DEEP_COLOR_SET_AND_GET_01, TestHdmiDeepColorSetAndGet },
     { HDMI_HPD_REGISTER_AND_UNREGISTER_01, TestHdmiHpdRegisterAndUnregister },
+    { HDMI_EDID_CACHE_01, TestHdmiEdidCache },
 };
 
 static int32_t HdmiTestEntry(struct HdmiTester *tester, int32_t cmd)
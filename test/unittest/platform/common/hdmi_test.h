@@ -21,6 +21,7 @@ enum HdmiTestCmd {
     HDMI_EDID_RAW_DATA_GET_01 = 5,
     HDMI_DEEP_COLOR_SET_AND_GET_01 = 6,
     HDMI_HPD_REGISTER_AND_UNREGISTER_01 = 7,
+    HDMI_EDID_CACHE_01 = 8,
 };
 
 struct HdmiTester {
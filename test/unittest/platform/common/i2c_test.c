@@ -15,6 +15,10 @@
 #include "osal_thread.h"
 #include "osal_time.h"
 #include "securec.h"
+#ifndef __USER__
+#include "i2c_core.h"
+#include "osal_sem.h"
+#endif
 
 #define HDF_LOG_TAG i2c_test
 
@@ -25,6 +29,11 @@
 #define I2C_TEST_MLTTHD_TIMES  1000
 #define I2C_TEST_STACK_SIZE    (1024 * 100)
 #define I2C_TEST_WAIT_TIMES    200
+#define I2C_TEST_ASYNC_NUM     8
+#define I2C_TEST_ASYNC_TIMEOUT 1000
+#define I2C_TEST_GUARD_LEN     16
+#define I2C_TEST_GUARD_BYTE    0xA5
+#define I2C_TEST_REUSE_STEPS   5
 
 static struct I2cMsg g_msgs[I2C_TEST_MSG_NUM];
 static uint8_t *g_buf;
@@ -352,6 +361,187 @@ int32_t I2cTestPeformance(void)
     return HDF_FAILURE;
 }
 
+#ifndef __USER__
+static void I2cTestAsyncCallback(struct I2cTransfer *xfer)
+{
+    (void)OsalSemPost((struct OsalSem *)xfer->priv);
+}
+
+static int32_t I2cTestAsyncCheck(struct I2cCntlr *cntlr, struct I2cTransfer *xfers, int32_t submitted)
+{
+    int32_t i;
+    struct I2cQueueStat stat;
+
+    for (i = 0; i < submitted; i++) {
+        if (xfers[i].result != I2C_TEST_MSG_NUM) {
+            HDF_LOGE("I2cTestAsyncTransfer: xfer[%d] err:%d", i, xfers[i].result);
+            return HDF_FAILURE;
+        }
+    }
+
+    if (I2cCntlrGetQueueStat(cntlr, &stat) != HDF_SUCCESS) {
+        HDF_LOGE("I2cTestAsyncTransfer: get queue stat fail!");
+        return HDF_FAILURE;
+    }
+    HDF_LOGI("I2cTestAsyncTransfer: depth:%u, depthMax:%u, completed:%u, latency last:%u(us) max:%u(us)",
+        stat.depth, stat.depthMax, stat.completed, stat.latencyLastUs, stat.latencyMaxUs);
+    if (stat.depth != 0 || stat.completed < (uint32_t)submitted) {
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+#endif
+
+int32_t I2cTestAsyncTransfer(void)
+{
+#ifdef __USER__
+    // asynchronous transfer is only available in kernel
+    return HDF_SUCCESS;
+#else
+    int32_t i;
+    int32_t ret = HDF_SUCCESS;
+    int32_t submitted = 0;
+    struct OsalSem sem;
+    struct I2cTransfer xfers[I2C_TEST_ASYNC_NUM];
+    struct I2cTester *tester = NULL;
+    struct I2cCntlr *cntlr = NULL;
+
+    tester = I2cTesterGet();
+    if (tester == NULL || tester->handle == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    cntlr = (struct I2cCntlr *)tester->handle;
+
+    if (OsalSemInit(&sem, 0) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    /* queue a burst of transfers without waiting, they are dispatched back-to-back */
+    for (i = 0; i < I2C_TEST_ASYNC_NUM; i++) {
+        xfers[i].msgs = g_msgs;
+        xfers[i].count = I2C_TEST_MSG_NUM;
+        xfers[i].callback = I2cTestAsyncCallback;
+        xfers[i].priv = &sem;
+        ret = I2cCntlrTransferAsync(cntlr, &xfers[i]);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("I2cTestAsyncTransfer: submit xfer[%d] fail:%d", i, ret);
+            break;
+        }
+        submitted++;
+    }
+    for (i = 0; i < submitted; i++) {
+        if (OsalSemWait(&sem, I2C_TEST_ASYNC_TIMEOUT) != HDF_SUCCESS) {
+            HDF_LOGE("I2cTestAsyncTransfer: wait xfer timeout!");
+            // the transfers on stack may be still in queue, wait them out
+            (void)OsalSemWait(&sem, HDF_WAIT_FOREVER);
+            ret = HDF_ERR_TIMEOUT;
+        }
+    }
+    (void)OsalSemDestroy(&sem);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    return I2cTestAsyncCheck(cntlr, xfers, submitted);
+#endif
+}
+
+static int32_t I2cTestReadWithGuard(struct I2cTester *tester, uint8_t *buf, uint16_t len)
+{
+    int32_t ret;
+    uint16_t i;
+    uint16_t untouched = 0;
+    struct I2cMsg msgs[I2C_TEST_MSG_NUM];
+
+    (void)memset_s(buf, tester->config.bufSize + I2C_TEST_GUARD_LEN, I2C_TEST_GUARD_BYTE,
+        tester->config.bufSize + I2C_TEST_GUARD_LEN);
+    msgs[0] = g_msgs[0];
+    msgs[1] = g_msgs[1];
+    msgs[1].buf = buf;
+    msgs[1].len = len;
+    ret = I2cTransfer(tester->handle, msgs, I2C_TEST_MSG_NUM);
+    if (ret != I2C_TEST_MSG_NUM) {
+        HDF_LOGE("I2cTestBufReuse: read len:%u err:%d", len, ret);
+        return HDF_FAILURE;
+    }
+    /* a reply left by an earlier transfer would be short or long for this read */
+    for (i = 1; i < len; i++) {
+        untouched += (buf[i] == I2C_TEST_GUARD_BYTE) ? 1 : 0;
+    }
+    if (len > 1 && untouched == len - 1) {
+        HDF_LOGE("I2cTestBufReuse: read len:%u not filled", len);
+        return HDF_FAILURE;
+    }
+    for (i = len; i < tester->config.bufSize + I2C_TEST_GUARD_LEN; i++) {
+        if (buf[i] != I2C_TEST_GUARD_BYTE) {
+            HDF_LOGE("I2cTestBufReuse: read len:%u overran at %u", len, i);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+#ifdef __USER__
+static int32_t I2cTestFailWithReplyLeft(struct I2cTester *tester, uint8_t *buf)
+{
+    struct I2cMsg msgs[I2C_TEST_MSG_NUM + 1];
+
+    /* the first read can't be copied out, so the reply of the second one is left unread in the handle */
+    msgs[0] = g_msgs[0];
+    msgs[1] = g_msgs[1];
+    msgs[1].buf = NULL;
+    msgs[1].len = 1;
+    msgs[2] = g_msgs[1]; // 2: the second read
+    msgs[2].buf = buf;
+    if (I2cTransfer(tester->handle, msgs, I2C_TEST_MSG_NUM + 1) == I2C_TEST_MSG_NUM + 1) {
+        HDF_LOGE("I2cTestBufReuse: read into null buf should fail!");
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+#endif
+
+int32_t I2cTestBufReuse(void)
+{
+    int32_t i;
+    int32_t ret = HDF_SUCCESS;
+    uint8_t *buf = NULL;
+    uint16_t lens[I2C_TEST_REUSE_STEPS];
+    struct I2cTester *tester = NULL;
+
+    tester = I2cTesterGet();
+    if (tester == NULL || tester->handle == NULL || tester->config.bufSize == 0) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    buf = (uint8_t *)OsalMemCalloc(tester->config.bufSize + I2C_TEST_GUARD_LEN);
+    if (buf == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    /* back-to-back transfers growing and then shrinking, the buffers of the handle are reused in between */
+    lens[0] = 1;
+    lens[1] = (tester->config.bufSize + 1) / 2; // 2: half of the buffer
+    lens[2] = tester->config.bufSize;           // 2: grow to the full buffer
+    lens[3] = lens[1];                          // 3: back to half
+    lens[4] = lens[0];                          // 4: back to the smallest
+    for (i = 0; i < I2C_TEST_REUSE_STEPS && ret == HDF_SUCCESS; i++) {
+        ret = I2cTestReadWithGuard(tester, buf, lens[i]);
+    }
+#ifdef __USER__
+    if (ret == HDF_SUCCESS) {
+        ret = I2cTestFailWithReplyLeft(tester, buf);
+    }
+#endif
+    /* the reads after the failed one are not disturbed by what it left behind */
+    if (ret == HDF_SUCCESS) {
+        ret = I2cTestReadWithGuard(tester, buf, 1);
+    }
+    if (ret == HDF_SUCCESS) {
+        ret = I2cTestReadWithGuard(tester, buf, tester->config.bufSize);
+    }
+    OsalMemFree(buf);
+    return ret;
+}
+
 struct I2cTestEntry {
     int cmd;
     int32_t (*func)(void);
@@ -368,6 +558,8 @@ static struct I2cTestEntry g_entry[] = {
     { I2C_TEST_CMD_TEARDOWN_ALL, I2cTestTearDownAll, "I2cTestTearDownAll" },
     { I2C_TEST_CMD_SETUP_SINGLE, I2cTestSetUpSingle, "I2cTestSetUpSingle" },
     { I2C_TEST_CMD_TEARDOWN_SINGLE, I2cTestTearDownSingle, "I2cTestTearDownSingle" },
+    { I2C_TEST_CMD_ASYNC_TRANSFER, I2cTestAsyncTransfer, "I2cTestAsyncTransfer" },
+    { I2C_TEST_CMD_BUF_REUSE, I2cTestBufReuse, "I2cTestBufReuse" },
 };
 
 int32_t I2cTestExecute(int cmd)
@@ -28,7 +28,9 @@ enum I2cTestCmd {
     I2C_TEST_CMD_TEARDOWN_ALL = 6,
     I2C_TEST_CMD_SETUP_SINGLE = 7,
     I2C_TEST_CMD_TEARDOWN_SINGLE = 8,
-    I2C_TEST_CMD_MAX = 9,
+    I2C_TEST_CMD_ASYNC_TRANSFER = 9,
+    I2C_TEST_CMD_BUF_REUSE = 10,
+    I2C_TEST_CMD_MAX = 11,
 };
 
 struct I2cTestConfig {
@@ -290,6 +290,55 @@ static int32_t I2sReadStopTest(struct I2sTest *test)
     return HDF_SUCCESS;
 }
 
+#define STREAM_TEST_PERIOD_NUM 4
+#define STREAM_TEST_LOOP_NUM   50
+
+static int32_t I2sStreamTest(struct I2sTest *test)
+{
+    int32_t i;
+    int32_t ret;
+    uint32_t len;
+    uint32_t total = 0;
+    struct I2sStreamStat stat;
+    struct I2sStreamCfg cfg = {I2S_DATA_BUF_SIZE / STREAM_TEST_PERIOD_NUM, STREAM_TEST_PERIOD_NUM, NULL, NULL};
+
+    if (test == NULL || test->handle == NULL || test->rbuf == NULL) {
+        HDF_LOGE("%s: test null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    ret = I2sSetStream(test->handle, I2S_STREAM_READ, &cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: set stream fail:%d", __func__, ret);
+        return ret;
+    }
+    I2sStartRead(test->handle);
+    for (i = 0; i < STREAM_TEST_LOOP_NUM; i++) {
+        OsalMSleep(I2S_DATA_TRANSFER_PERIOD);
+        ret = I2sStreamRead(test->handle, test->rbuf, I2S_DATA_BUF_SIZE, &len);
+        if (ret != HDF_SUCCESS) {
+            break;
+        }
+        total += len;
+    }
+    I2sStopRead(test->handle);
+    if (ret == HDF_SUCCESS) {
+        ret = I2sGetStreamStat(test->handle, I2S_STREAM_READ, &stat);
+    }
+    (void)I2sSetStream(test->handle, I2S_STREAM_READ, NULL);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: stream read fail:%d", __func__, ret);
+        return ret;
+    }
+    HDF_LOGI("%s: read %u bytes, periods:%llu, xruns:%u", __func__, total,
+        (unsigned long long)stat.periods, stat.xruns);
+    if (total == 0 || stat.periods == 0) {
+        HDF_LOGE("%s: the stream didn't run, total:%u", __func__, total);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
 static int32_t I2sReliabilityTest(struct I2sTest *test)
 {
     if (test == NULL || test->handle == NULL) {
@@ -321,6 +370,7 @@ static struct I2sTestFunc g_i2sTestFunc[] = {
     {I2S_RELIABILITY_TEST, I2sReliabilityTest},
     {I2S_RECORD_TEST, I2sRecordTest},
     {I2S_PLAY_TEST, I2sPlayTest},
+    {I2S_STREAM_TEST, I2sStreamTest},
 };
 
 static int32_t I2sTestEntry(struct I2sTest *test, int32_t cmd)
@@ -28,6 +28,7 @@ enum I2sTestCmd {
     I2S_RELIABILITY_TEST,
     I2S_RECORD_TEST,
     I2S_PLAY_TEST,
+    I2S_STREAM_TEST,
 };
 
 struct I2sTest {
@@ -15,6 +15,10 @@
 #include "osal_thread.h"
 #include "osal_time.h"
 #include "securec.h"
+#ifndef __USER__
+#include "i3c_core.h"
+#include "osal_sem.h"
+#endif
 
 #define HDF_LOG_TAG i3c_test_c
 
@@ -25,6 +29,7 @@
 #define I3C_TEST_STACK_SIZE        (1024 * 256)
 #define I3C_TEST_IBI_PAYLOAD       16
 #define I3C_TEST_REG_LEN           2
+#define I3C_TEST_IBI_WAIT_MS       1000
 
 static struct I3cMsg g_msgs[I3C_TEST_MSG_NUM];
 static uint8_t *g_buf;
@@ -354,6 +359,136 @@ int32_t I3cTestFreeIbi(void *param)
     return HDF_SUCCESS;
 }
 
+#ifndef __USER__
+struct I3cTestIbiDispatch {
+    struct OsalSem gate;
+    struct OsalSem done;
+    volatile uint32_t count;
+    uint8_t seq[I3C_IBI_SLOT_NUM];
+};
+
+static struct I3cTestIbiDispatch g_ibiDispatch;
+
+static int32_t TestI3cIbiDeferFunc(DevHandle handle, uint16_t addr, struct I3cIbiData data)
+{
+    (void)handle;
+    (void)addr;
+    /* held back until the test has queued every slot */
+    (void)OsalSemWait(&g_ibiDispatch.gate, I3C_TEST_IBI_WAIT_MS);
+    if (g_ibiDispatch.count < I3C_IBI_SLOT_NUM) {
+        g_ibiDispatch.seq[g_ibiDispatch.count] = (data.buf == NULL) ? 0 : data.buf[0];
+    }
+    g_ibiDispatch.count++;
+    (void)OsalSemPost(&g_ibiDispatch.done);
+    return HDF_SUCCESS;
+}
+
+static int32_t I3cTestIbiFill(struct I3cDevice *device)
+{
+    uint8_t i;
+    int32_t ret;
+
+    /* play the controller's interrupt handler: fill the current slot, then hand it over */
+    for (i = 0; i < I3C_IBI_SLOT_NUM; i++) {
+        if (device->ibi->data == NULL) {
+            HDF_LOGE("%s: no free slot for ibi %u", __func__, i);
+            return HDF_FAILURE;
+        }
+        device->ibi->data[0] = i + 1;
+        ret = I3cCntlrIbiCallback(device);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: ibi %u callback fail:%d", __func__, i, ret);
+            return HDF_FAILURE;
+        }
+    }
+    if (g_ibiDispatch.count != 0) {
+        HDF_LOGE("%s: handler ran in the callback, count:%u", __func__, g_ibiDispatch.count);
+        return HDF_FAILURE;
+    }
+    /* every slot is pending on the held back handlers */
+    ret = I3cCntlrIbiCallback(device);
+    if (ret != HDF_ERR_DEVICE_BUSY) {
+        HDF_LOGE("%s: ibi accepted with all slots pending:%d", __func__, ret);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t I3cTestIbiDrain(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < I3C_IBI_SLOT_NUM; i++) {
+        (void)OsalSemPost(&g_ibiDispatch.gate);
+    }
+    for (i = 0; i < I3C_IBI_SLOT_NUM; i++) {
+        if (OsalSemWait(&g_ibiDispatch.done, I3C_TEST_IBI_WAIT_MS) != HDF_SUCCESS) {
+            HDF_LOGE("%s: only %u handlers ran", __func__, g_ibiDispatch.count);
+            return HDF_ERR_TIMEOUT;
+        }
+    }
+    for (i = 0; i < I3C_IBI_SLOT_NUM; i++) {
+        if (g_ibiDispatch.seq[i] != i + 1) {
+            HDF_LOGE("%s: ibi %u carried %u", __func__, i, g_ibiDispatch.seq[i]);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+#endif
+
+int32_t I3cTestIbiDispatch(void *param)
+{
+#ifdef __USER__
+    // the ibi callback is raised by the controller driver, only reachable in kernel
+    HDF_LOGI("%s: skipped in user space", __func__);
+    *((int32_t *)param) = 1;
+    return HDF_SUCCESS;
+#else
+    int32_t ret;
+    struct I3cTester *tester = NULL;
+    struct I3cCntlr *cntlr = NULL;
+    struct I3cDevice *device = NULL;
+
+    *((int32_t *)param) = 1;
+    tester = I3cTesterGet();
+    if (tester == NULL || tester->handle == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    cntlr = (struct I3cCntlr *)tester->handle;
+    device = GetDeviceByAddr(cntlr, tester->config.devAddr);
+    if (device == NULL) {
+        HDF_LOGE("%s: no device at 0x%x", __func__, tester->config.devAddr);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    (void)memset_s(&g_ibiDispatch, sizeof(g_ibiDispatch), 0, sizeof(g_ibiDispatch));
+    (void)OsalSemInit(&g_ibiDispatch.gate, 0);
+    (void)OsalSemInit(&g_ibiDispatch.done, 0);
+    ret = I3cRequestIbi(tester->handle, tester->config.devAddr, TestI3cIbiDeferFunc, I3C_TEST_IBI_PAYLOAD);
+    if (ret == HDF_SUCCESS) {
+        ret = I3cTestIbiFill(device);
+        if (ret == HDF_SUCCESS) {
+            ret = I3cTestIbiDrain();
+        } else {
+            // let the handlers already queued run out before the ibi is freed
+            (void)OsalSemPost(&g_ibiDispatch.gate);
+        }
+        if (I3cFreeIbi(tester->handle, tester->config.devAddr) != HDF_SUCCESS && ret == HDF_SUCCESS) {
+            ret = HDF_FAILURE;
+        }
+    }
+    if (ret == HDF_SUCCESS && I3cCntlrIbiCallback(device) != HDF_ERR_NOT_SUPPORT) {
+        HDF_LOGE("%s: ibi still accepted after free", __func__);
+        ret = HDF_FAILURE;
+    }
+    (void)OsalSemDestroy(&g_ibiDispatch.gate);
+    (void)OsalSemDestroy(&g_ibiDispatch.done);
+    HDF_LOGD("%s: done, ret:%d", __func__, ret);
+    return ret;
+#endif
+}
+
 int32_t I3cTestThreadFunc(OsalThreadEntry func)
 {
     int32_t ret;
@@ -483,6 +618,7 @@ static struct I3cTestEntry g_entry[] = {
     { I3C_TEST_CMD_GET_CONFIG, I3cTestGetConfig, "I3cTestGetConfig" },
     { I3C_TEST_CMD_REQUEST_IBI, I3cTestRequestIbi, "I3cTestRequestIbi" },
     { I3C_TEST_CMD_FREE_IBI, I3cTestFreeIbi, "I3cTestFreeIbi" },
+    { I3C_TEST_CMD_IBI_DISPATCH, I3cTestIbiDispatch, "I3cTestIbiDispatch" },
     { I3C_TEST_CMD_MULTI_THREAD, I3cTestMultiThread, "I3cTestMultiThread" },
     { I3C_TEST_CMD_RELIABILITY, I3cTestReliability, "I3cTestReliability" },
     { I3C_TEST_CMD_SETUP_ALL, I3cTestSetUpAll, "I3cTestSetUpAll" },
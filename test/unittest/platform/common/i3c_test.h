@@ -38,6 +38,7 @@ enum I3cTestCmd {
     I3C_TEST_CMD_GET_CONFIG,
     I3C_TEST_CMD_REQUEST_IBI,
     I3C_TEST_CMD_FREE_IBI,
+    I3C_TEST_CMD_IBI_DISPATCH,
     I3C_TEST_CMD_MULTI_THREAD,
     I3C_TEST_CMD_RELIABILITY,
     I3C_TEST_CMD_SETUP_ALL,
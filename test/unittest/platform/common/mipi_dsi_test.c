@@ -114,6 +114,26 @@ static int32_t MipiDsiTxRxTest(struct MipiDsiTest *test)
     return HDF_FAILURE;
 }
 
+static int32_t MipiDsiTxListTest(struct MipiDsiTest *test)
+{
+    int32_t ret;
+    static uint8_t exitSleep = 0x11;  /* 0x11: exit sleep mode */
+    static uint8_t displayOn = 0x29;  /* 0x29: display on */
+    struct DsiCmdDesc cmds[] = {
+        { .dataType = 0x05, .dataLen = 1, .delay = 5, .payload = &exitSleep },   /* 0x05: dcs write, 5: ms */
+        { .dataType = 0x05, .dataLen = 1, .delay = 0, .payload = &displayOn },
+        { .dataType = 0x05, .dataLen = 1, .delay = 0, .payload = &test->msgs.payload[0] },
+    };
+
+    /* controllers without setCmdList fall back to setCmd, so the list must always go through */
+    ret = MipiDsiTxList(test->handle, cmds, sizeof(cmds) / sizeof(cmds[0]));
+    if (ret == HDF_SUCCESS) {
+        return HDF_SUCCESS;
+    }
+    HDF_LOGE("%s: fail, ret %d", __func__, ret);
+    return HDF_FAILURE;
+}
+
 static int32_t MipiDsiToLpToHsTest(struct MipiDsiTest *test)
 {
     MipiDsiSetHsMode(test->handle);
@@ -138,6 +158,9 @@ static int32_t MipiDsiTestByCmd(struct MipiDsiTest *test, int32_t cmd)
         case MIPI_DSI_TEST_TO_LP_TO_HS:
             ret = MipiDsiToLpToHsTest(test);
             break;
+        case MIPI_DSI_TEST_TX_LIST:
+            ret = MipiDsiTxListTest(test);
+            break;
         default:
             HDF_LOGE("%s: not support", __func__);
             break;
@@ -161,6 +184,9 @@ static int32_t MipiDsiTestDoTest(struct MipiDsiTest *test, int32_t cmd)
 #ifdef MIPI_DSI_TEST_ON_INIT
     int32_t i;
     for (i = 0; i < test->total; i++) {
+        if (i == MIPI_DSI_TEST_ENTER_ULPS_EXIT_ULPS || i == MIPI_DSI_TEST_POWER_CONTROL) {
+            continue;
+        }
         if (MipiDsiTestByCmd(test, i) != HDF_SUCCESS) {
             test->fails++;
         }
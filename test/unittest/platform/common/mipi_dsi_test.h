@@ -17,7 +17,10 @@ enum MipiDsiTestCmd {
     MIPI_DSI_TEST_GET_CFG = 1,
     MIPI_DSI_TEST_TX_RX = 2,
     MIPI_DSI_TEST_TO_LP_TO_HS = 3,
-    MIPI_DSI_TEST_MAX = 4,
+    MIPI_DSI_TEST_ENTER_ULPS_EXIT_ULPS = 4,   /* numbered like the hdf side, no case here yet */
+    MIPI_DSI_TEST_POWER_CONTROL = 5,
+    MIPI_DSI_TEST_TX_LIST = 6,
+    MIPI_DSI_TEST_MAX = 7,
 };
 
 struct MipiDsiTest {
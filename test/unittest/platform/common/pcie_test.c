@@ -9,6 +9,7 @@
 #include "device_resource_if.h"
 #include "hdf_base.h"
 #include "hdf_log.h"
+#include "osal_io.h"
 #include "osal_time.h"
 #include "pcie_if.h"
 #include "pcie_test.h"
@@ -18,6 +19,9 @@
 #define PCIE_TEST_DISABLE_ADDR 0xB7
 #define PCIE_TEST_UPPER_ADDR 0x28
 #define PCIE_TEST_CMD_ADDR 0x04
+#define PCIE_TEST_BAR_PATTERN 0x5AA55AA5
+#define PCIE_TEST_DMA_ADDR 0x100
+#define PCIE_TEST_DMA_LEN 256
 
 struct PcieTestFunc {
     enum PcieTestCmd type;
@@ -86,8 +90,109 @@ static int32_t TestPcieReadAndWrite(struct PcieTester *tester)
     return ret;
 }
 
+static int32_t TestPcieMapBar(struct PcieTester *tester)
+{
+    int32_t ret;
+    uint32_t size;
+    uint32_t size2;
+    volatile uint8_t *addr = NULL;
+    volatile uint8_t *addr2 = NULL;
+
+    ret = PcieMapBar(tester->handle, 0, &addr, &size);
+    if (ret != HDF_SUCCESS || size < sizeof(uint32_t)) {
+        HDF_LOGE("%s: PcieMapBar failed ret = %d.", __func__, ret);
+        return HDF_FAILURE;
+    }
+    /* a second user shares the mapping */
+    ret = PcieMapBar(tester->handle, 0, &addr2, &size2);
+    if (ret != HDF_SUCCESS || addr2 != addr || size2 != size) {
+        HDF_LOGE("%s: second PcieMapBar failed ret = %d.", __func__, ret);
+        PcieUnmapBar(tester->handle, 0);
+        return HDF_FAILURE;
+    }
+    PcieUnmapBar(tester->handle, 0);
+
+    OSAL_WRITEL(PCIE_TEST_BAR_PATTERN, addr);
+    if (OSAL_READL(addr) != PCIE_TEST_BAR_PATTERN) {
+        HDF_LOGE("%s: bar read back mismatch", __func__);
+        ret = HDF_FAILURE;
+    }
+    PcieUnmapBar(tester->handle, 0);
+    if (PcieMapBar(tester->handle, PCIE_BAR_NUM, &addr, &size) == HDF_SUCCESS) {
+        HDF_LOGE("%s: invalid bar mapped", __func__);
+        PcieUnmapBar(tester->handle, PCIE_BAR_NUM);
+        ret = HDF_FAILURE;
+    }
+    return ret;
+}
+
+struct PcieTestDmaDone {
+    int32_t status;
+    uint32_t count;
+};
+
+static void TestPcieDmaCallback(void *priv, int32_t status)
+{
+    struct PcieTestDmaDone *done = (struct PcieTestDmaDone *)priv;
+
+    done->status = status;
+    done->count++;
+}
+
+static int32_t TestPcieDmaTransfer(struct PcieTester *tester)
+{
+    int32_t ret;
+    uint32_t i;
+    uint8_t wbuf[PCIE_TEST_DMA_LEN];
+    uint8_t rbuf[PCIE_TEST_DMA_LEN] = {0};
+    struct PcieTestDmaDone done = {0};
+    struct PcieDmaXfer xfer = {0};
+
+    for (i = 0; i < PCIE_TEST_DMA_LEN; i++) {
+        wbuf[i] = (uint8_t)i;
+    }
+    xfer.dir = PCIE_DMA_TO_DEVICE;
+    xfer.devAddr = PCIE_TEST_DMA_ADDR;
+    xfer.buf = wbuf;
+    xfer.len = PCIE_TEST_DMA_LEN;
+    ret = PcieDmaTransfer(tester->handle, &xfer);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: dma to device failed ret = %d.", __func__, ret);
+        return ret;
+    }
+
+    /* read back asynchronously */
+    xfer.dir = PCIE_DMA_FROM_DEVICE;
+    xfer.buf = rbuf;
+    xfer.cb = TestPcieDmaCallback;
+    xfer.priv = &done;
+    ret = PcieDmaTransfer(tester->handle, &xfer);
+    for (i = 0; ret == HDF_SUCCESS && done.count == 0 && i < PCIE_TEST_DMA_LEN; i++) {
+        OsalMSleep(1);
+    }
+    if (ret != HDF_SUCCESS || done.count != 1 || done.status != HDF_SUCCESS) {
+        HDF_LOGE("%s: dma from device failed ret = %d, count %u.", __func__, ret, done.count);
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < PCIE_TEST_DMA_LEN; i++) {
+        if (rbuf[i] != wbuf[i]) {
+            HDF_LOGE("%s: data mismatch at %u", __func__, i);
+            return HDF_FAILURE;
+        }
+    }
+
+    xfer.len = 0;
+    if (PcieDmaTransfer(tester->handle, &xfer) == HDF_SUCCESS) {
+        HDF_LOGE("%s: empty dma accepted", __func__);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
 struct PcieTestFunc g_pcieTestFunc[] = {
     { PCIE_READ_AND_WRITE_01, TestPcieReadAndWrite },
+    { PCIE_MAP_BAR_01, TestPcieMapBar },
+    { PCIE_DMA_TRANSFER_01, TestPcieDmaTransfer },
 };
 
 static int32_t PcieTestEntry(struct PcieTester *tester, int32_t cmd)
@@ -14,6 +14,8 @@
 
 enum PcieTestCmd {
     PCIE_READ_AND_WRITE_01 = 0,
+    PCIE_MAP_BAR_01 = 1,
+    PCIE_DMA_TRANSFER_01 = 2,
 };
 
 struct PcieTester {
@@ -11,8 +11,8 @@
 #include "hdf_io_service_if.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
-#include "osal_time.h"
 #include "pin_if.h"
+#include "platform_core.h"
 #include "securec.h"
 
 #define HDF_LOG_TAG pin_test_c
@@ -319,6 +319,128 @@ int32_t PinTestReliability(void)
     return HDF_SUCCESS;
 }
 
+static DevHandle PinTestGetVirtual(uint32_t num)
+{
+    char name[PIN_TEST_VIRTUAL_NAME_LEN];
+
+    if (snprintf_s(name, sizeof(name), sizeof(name) - 1, "vpin%u", num) < 0) {
+        return NULL;
+    }
+    return PinGet(name);
+}
+
+// the index and batch tests need the virtual_pin_driver of the test config
+static bool PinTestVirtualLoaded(const char *caller)
+{
+    DevHandle handle = PinTestGetVirtual(0);
+
+    if (handle == NULL) {
+        HDF_LOGE("%s: vpin0 not found, the virtual pin controller must be loaded to run this test", caller);
+        return false;
+    }
+    PinPut(handle);
+    return true;
+}
+
+static int32_t PinTestIndex(void)
+{
+    uint32_t i;
+    uint64_t start;
+    uint64_t cost;
+
+    if (!PinTestVirtualLoaded(__func__)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    // the last pins were the worst case of the linear scan
+    start = PlatformMonoTimeUs();
+    for (i = 0; i < PIN_TEST_VIRTUAL_PIN_NUM; i++) {
+        if (PinTestGetVirtual(PIN_TEST_VIRTUAL_PIN_NUM - 1 - i) == NULL) {
+            HDF_LOGE("%s: get vpin%u failed", __func__, PIN_TEST_VIRTUAL_PIN_NUM - 1 - i);
+            return HDF_FAILURE;
+        }
+    }
+    cost = PlatformMonoTimeUs() - start;
+    if (PinGet("vpin_none") != NULL) {
+        HDF_LOGE("%s: get an absent pin succeeded", __func__);
+        return HDF_FAILURE;
+    }
+    HDF_LOGI("%s: %u lookups cost %llu us", __func__, PIN_TEST_VIRTUAL_PIN_NUM, (unsigned long long)cost);
+    return HDF_SUCCESS;
+}
+
+static int32_t PinTestBatchCheck(const struct PinCfg *cfgs, uint32_t count)
+{
+    uint32_t i;
+    uint32_t strength;
+    const char *funcName = NULL;
+    enum PinPullType pullType;
+
+    for (i = 0; i < count; i++) {
+        if (PinGetPull(cfgs[i].handle, &pullType) != HDF_SUCCESS ||
+            PinGetStrength(cfgs[i].handle, &strength) != HDF_SUCCESS ||
+            PinGetFunc(cfgs[i].handle, &funcName) != HDF_SUCCESS) {
+            HDF_LOGE("%s: get vpin%u failed", __func__, i);
+            return HDF_FAILURE;
+        }
+        if (pullType != cfgs[i].pullType || strength != cfgs[i].strength || strcmp(funcName, cfgs[i].funcName) != 0) {
+            HDF_LOGE("%s: vpin%u is %d/%u/%s", __func__, i, pullType, strength, funcName);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t PinTestBatch(void)
+{
+    int32_t ret;
+    uint32_t i;
+    uint64_t start;
+    uint64_t cost;
+    struct PinCfg *cfgs = NULL;
+
+    if (!PinTestVirtualLoaded(__func__)) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    cfgs = (struct PinCfg *)OsalMemCalloc(sizeof(*cfgs) * PIN_TEST_VIRTUAL_PIN_NUM);
+    if (cfgs == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    for (i = 0; i < PIN_TEST_VIRTUAL_PIN_NUM; i++) {
+        cfgs[i].handle = PinTestGetVirtual(i);
+        cfgs[i].mask = PIN_CFG_PULL | PIN_CFG_STRENGTH | PIN_CFG_FUNC;
+        cfgs[i].pullType = (enum PinPullType)(i % (PIN_PULL_DOWN + 1));
+        cfgs[i].strength = i % 8;    /* 8: strength levels used */
+        cfgs[i].funcName = ((i & 1) == 0) ? "uart" : "i2c";
+    }
+
+    start = PlatformMonoTimeUs();
+    ret = PinSetCfgBatch(cfgs, PIN_TEST_VIRTUAL_PIN_NUM);
+    cost = PlatformMonoTimeUs() - start;
+    if (ret == HDF_SUCCESS) {
+        ret = PinTestBatchCheck(cfgs, PIN_TEST_VIRTUAL_PIN_NUM);
+    }
+    if (ret == HDF_SUCCESS) {
+        // a bad entry stops the batch without touching the pins after it
+        cfgs[1].strength = (uint32_t)-1;
+        cfgs[2].strength = 0;
+        if (PinSetCfgBatch(cfgs, 3) == HDF_SUCCESS) {    /* 3: good, bad, untouched */
+            HDF_LOGE("%s: invalid strength accepted", __func__);
+            ret = HDF_FAILURE;
+        } else if (PinGetStrength(cfgs[2].handle, &i) != HDF_SUCCESS || i != 2) {    /* 2: set by the first batch */
+            HDF_LOGE("%s: batch went on after a failure", __func__);
+            ret = HDF_FAILURE;
+        }
+    }
+    HDF_LOGI("%s: batch of %u pins cost %llu us, ret %d", __func__, PIN_TEST_VIRTUAL_PIN_NUM,
+        (unsigned long long)cost, ret);
+    for (i = 0; i < PIN_TEST_VIRTUAL_PIN_NUM; i++) {
+        PinPut(cfgs[i].handle);
+    }
+    OsalMemFree(cfgs);
+    return ret;
+}
+
 static struct PinTestEntry g_entry[] = {
     { PIN_TEST_CMD_SETGETPULL, PinSetGetPullTest, "PinSetGetPullTest" },
     { PIN_TEST_CMD_SETGETSTRENGTH, PinSetGetStrengthTest, "PinSetGetStrengthTest" },
@@ -326,6 +448,8 @@ static struct PinTestEntry g_entry[] = {
     { PIN_TEST_CMD_RELIABILITY, PinTestReliability, "PinTestReliability" },
     { PIN_TEST_CMD_SETUP_ALL, PinTestSetUpAll, "PinTestSetUpAll" },
     { PIN_TEST_CMD_TEARDOWN_ALL, PinTestTearDownAll, "PinTestTearDownAll" },
+    { PIN_TEST_CMD_INDEX, PinTestIndex, "PinTestIndex" },
+    { PIN_TEST_CMD_BATCH, PinTestBatch, "PinTestBatch" },
 };
 
 int32_t PinTestExecute(int cmd)
@@ -41,9 +41,15 @@ enum PinTestCmd {
     PIN_TEST_CMD_TEARDOWN_ALL = 5,
     PIN_TEST_CMD_SETUP_SINGLE = 6,
     PIN_TEST_CMD_TEARDOWN_SINGLE = 7,
-    PIN_TEST_CMD_MAX = 8,
+    PIN_TEST_CMD_INDEX = 8,
+    PIN_TEST_CMD_BATCH = 9,
+    PIN_TEST_CMD_MAX = 10,
 };
 
+/* pins of the synthetic controller in virtual/pin_virtual.c */
+#define PIN_TEST_VIRTUAL_PIN_NUM   4096
+#define PIN_TEST_VIRTUAL_NAME_LEN  16
+
 int32_t PinTestExecute(int cmd);
 
 #ifdef __cplusplus
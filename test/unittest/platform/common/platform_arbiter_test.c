@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "platform_arbiter_test.h"
+#include "osal_thread.h"
+#include "osal_time.h"
+#include "platform_arbiter.h"
+#include "platform_assert.h"
+
+#define HDF_LOG_TAG platform_arbiter_test
+
+#define PLAT_ARBITER_TEST_WAIT_TIMEOUT  20
+#define PLAT_ARBITER_TEST_WAIT_MS       10
+#define PLAT_ARBITER_TEST_WAIT_TIMES    100
+#define PLAT_ARBITER_TEST_STACK_SIZE    10000
+#define PLAT_ARBITER_TEST_WORKER_NUM    3
+
+struct PlatformArbiterTestWorker {
+    struct PlatformArbiter *arbiter;
+    uint32_t prio;
+    struct OsalThread thread;
+    uint32_t *order;          /* the priorities in granting order, written by the holder only */
+    uint32_t *orderNum;
+    int32_t ret;
+    bool done;
+};
+
+static int32_t PlatformArbiterTestWorkerFunc(void *data)
+{
+    struct PlatformArbiterTestWorker *worker = (struct PlatformArbiterTestWorker *)data;
+
+    worker->ret = PlatformArbiterAcquire(worker->arbiter, worker->prio, HDF_WAIT_FOREVER);
+    if (worker->ret == HDF_SUCCESS) {
+        worker->order[(*worker->orderNum)++] = worker->prio;
+        PlatformArbiterRelease(worker->arbiter);
+    }
+    worker->done = true;
+    return HDF_SUCCESS;
+}
+
+static uint32_t PlatformArbiterTestWaiting(struct PlatformArbiter *arbiter)
+{
+    uint32_t i;
+    uint32_t num = 0;
+
+    (void)OsalSpinLock(&arbiter->spin);
+    for (i = 0; i < PLATFORM_PRIORITY_NUM; i++) {
+        num += arbiter->waiting[i];
+    }
+    (void)OsalSpinUnlock(&arbiter->spin);
+    return num;
+}
+
+static int32_t PlatformArbiterTestWaitFor(struct PlatformArbiter *arbiter, uint32_t waiting)
+{
+    uint32_t i;
+
+    for (i = 0; i < PLAT_ARBITER_TEST_WAIT_TIMES; i++) {
+        if (PlatformArbiterTestWaiting(arbiter) == waiting) {
+            return HDF_SUCCESS;
+        }
+        OsalMSleep(PLAT_ARBITER_TEST_WAIT_MS);
+    }
+    PLAT_LOGE("%s: %u waiters expected, but got %u", __func__, waiting, PlatformArbiterTestWaiting(arbiter));
+    return HDF_ERR_TIMEOUT;
+}
+
+static int32_t PlatformArbiterTestWorkerStart(struct PlatformArbiterTestWorker *worker)
+{
+    int32_t ret;
+    struct OsalThreadParam cfg;
+
+    worker->done = false;
+    worker->ret = HDF_FAILURE;
+    ret = OsalThreadCreate(&worker->thread, (OsalThreadEntry)PlatformArbiterTestWorkerFunc, worker);
+    if (ret != HDF_SUCCESS) {
+        PLAT_LOGE("%s: create thread fail:%d", __func__, ret);
+        return ret;
+    }
+    cfg.name = "PlatArbiterTest";
+    cfg.priority = OSAL_THREAD_PRI_DEFAULT;
+    cfg.stackSize = PLAT_ARBITER_TEST_STACK_SIZE;
+    ret = OsalThreadStart(&worker->thread, &cfg);
+    if (ret != HDF_SUCCESS) {
+        PLAT_LOGE("%s: start thread fail:%d", __func__, ret);
+        (void)OsalThreadDestroy(&worker->thread);
+        worker->done = true;
+    }
+    return ret;
+}
+
+static void PlatformArbiterTestWorkerStop(struct PlatformArbiterTestWorker *worker)
+{
+    uint32_t i;
+
+    for (i = 0; i < PLAT_ARBITER_TEST_WAIT_TIMES && !worker->done; i++) {
+        OsalMSleep(PLAT_ARBITER_TEST_WAIT_MS);
+    }
+    (void)OsalThreadDestroy(&worker->thread);
+}
+
+static int32_t PlatformArbiterTestPriorityOrder(struct PlatformArbiter *arbiter)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t started = 0;
+    uint32_t order[PLAT_ARBITER_TEST_WORKER_NUM] = {0};
+    uint32_t orderNum = 0;
+    struct PlatformArbiterTestWorker workers[PLAT_ARBITER_TEST_WORKER_NUM];
+    const uint32_t prios[PLAT_ARBITER_TEST_WORKER_NUM] = {
+        PLATFORM_PRIORITY_BULK, PLATFORM_PRIORITY_RT, PLATFORM_PRIORITY_HIGH,
+    };
+    const uint32_t expected[PLAT_ARBITER_TEST_WORKER_NUM] = {
+        PLATFORM_PRIORITY_RT, PLATFORM_PRIORITY_HIGH, PLATFORM_PRIORITY_BULK,
+    };
+
+    PLAT_LOGD("%s: enter", __func__);
+    ret = PlatformArbiterAcquire(arbiter, PLATFORM_PRIORITY_NORMAL, PLAT_ARBITER_TEST_WAIT_TIMEOUT);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+
+    // queue the workers one by one while the bus is held, lowest priority first
+    for (i = 0; i < PLAT_ARBITER_TEST_WORKER_NUM; i++) {
+        workers[i].arbiter = arbiter;
+        workers[i].prio = prios[i];
+        workers[i].order = order;
+        workers[i].orderNum = &orderNum;
+        ret = PlatformArbiterTestWorkerStart(&workers[i]);
+        if (ret != HDF_SUCCESS) {
+            break;
+        }
+        started++;
+        ret = PlatformArbiterTestWaitFor(arbiter, started);
+        if (ret != HDF_SUCCESS) {
+            break;
+        }
+    }
+    PlatformArbiterRelease(arbiter);
+    for (i = 0; i < started; i++) {
+        PlatformArbiterTestWorkerStop(&workers[i]);
+    }
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+
+    // the waiters must be granted from the highest priority down
+    CHECK_EQ_RETURN(orderNum, PLAT_ARBITER_TEST_WORKER_NUM, HDF_FAILURE);
+    for (i = 0; i < PLAT_ARBITER_TEST_WORKER_NUM; i++) {
+        CHECK_EQ_RETURN(workers[i].ret, HDF_SUCCESS, workers[i].ret);
+        CHECK_EQ_RETURN(order[i], expected[i], HDF_FAILURE);
+    }
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformArbiterTestTimeout(struct PlatformArbiter *arbiter)
+{
+    int32_t ret;
+    struct PlatformArbiterStat stat;
+
+    PLAT_LOGD("%s: enter", __func__);
+    ret = PlatformArbiterAcquire(arbiter, PLATFORM_PRIORITY_NORMAL, PLAT_ARBITER_TEST_WAIT_TIMEOUT);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+
+    // should time out while the bus is held, and leave no waiter behind
+    ret = PlatformArbiterAcquire(arbiter, PLATFORM_PRIORITY_RT, PLAT_ARBITER_TEST_WAIT_TIMEOUT);
+    PlatformArbiterRelease(arbiter);
+    CHECK_EQ_RETURN(ret, HDF_ERR_TIMEOUT, HDF_FAILURE);
+    CHECK_EQ_RETURN(PlatformArbiterTestWaiting(arbiter), 0, HDF_FAILURE);
+
+    // should be granted at once after the release
+    ret = PlatformArbiterAcquire(arbiter, PLATFORM_PRIORITY_RT, PLAT_ARBITER_TEST_WAIT_TIMEOUT);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    PlatformArbiterRelease(arbiter);
+
+    ret = PlatformArbiterGetStat(arbiter, &stat);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    CHECK_EQ_RETURN(stat.timeouts, 1, HDF_FAILURE);
+    CHECK_EQ_RETURN(stat.grants[PLATFORM_PRIORITY_NORMAL], 1, HDF_FAILURE);
+    CHECK_EQ_RETURN(stat.grants[PLATFORM_PRIORITY_RT], 1, HDF_FAILURE);
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformArbiterTestYield(struct PlatformArbiter *arbiter)
+{
+    int32_t ret;
+    bool started = false;
+    bool yielded = false;
+    uint32_t order[1] = {0};
+    uint32_t orderNum = 0;
+    struct PlatformArbiterTestWorker worker;
+    struct PlatformArbiterStat stat;
+
+    PLAT_LOGD("%s: enter", __func__);
+    ret = PlatformArbiterAcquire(arbiter, PLATFORM_PRIORITY_BULK, PLAT_ARBITER_TEST_WAIT_TIMEOUT);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+
+    // nobody waits, should keep the bus
+    if (!CHECK(!PlatformArbiterYield(arbiter))) {
+        PlatformArbiterRelease(arbiter);
+        return HDF_FAILURE;
+    }
+
+    worker.arbiter = arbiter;
+    worker.prio = PLATFORM_PRIORITY_HIGH;
+    worker.order = order;
+    worker.orderNum = &orderNum;
+    ret = PlatformArbiterTestWorkerStart(&worker);
+    if (ret == HDF_SUCCESS) {
+        started = true;
+        ret = PlatformArbiterTestWaitFor(arbiter, 1);
+    }
+    if (ret == HDF_SUCCESS) {
+        // should hand the bus over, and get it back after the worker is done
+        yielded = PlatformArbiterYield(arbiter);
+    }
+    PlatformArbiterRelease(arbiter);
+    if (started) {
+        PlatformArbiterTestWorkerStop(&worker);
+    }
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    CHECK_EQ_RETURN(yielded, true, HDF_FAILURE);
+    CHECK_EQ_RETURN(orderNum, 1, HDF_FAILURE);
+
+    ret = PlatformArbiterGetStat(arbiter, &stat);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    CHECK_EQ_RETURN(stat.yields, 1, HDF_FAILURE);
+    CHECK_EQ_RETURN(stat.grants[PLATFORM_PRIORITY_HIGH], 1, HDF_FAILURE);
+    CHECK_EQ_RETURN(stat.waitTotalUs[PLATFORM_PRIORITY_HIGH], stat.waitLastUs[PLATFORM_PRIORITY_HIGH], HDF_FAILURE);
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
+static int32_t PlatformArbiterTestReliability(struct PlatformArbiter *arbiter)
+{
+    int32_t ret;
+    struct PlatformArbiterStat stat;
+
+    PLAT_LOGD("%s: enter", __func__);
+    ret = PlatformArbiterAcquire(NULL, PLATFORM_PRIORITY_NORMAL, PLAT_ARBITER_TEST_WAIT_TIMEOUT);
+    CHECK_NE_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+
+    ret = PlatformArbiterAcquire(arbiter, PLATFORM_PRIORITY_NUM, PLAT_ARBITER_TEST_WAIT_TIMEOUT);
+    CHECK_NE_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+
+    ret = PlatformArbiterGetStat(arbiter, NULL);
+    CHECK_NE_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+
+    ret = PlatformArbiterGetStat(NULL, &stat);
+    CHECK_NE_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+
+    PlatformArbiterRelease(NULL);
+    CHECK_EQ_RETURN(PlatformArbiterYield(NULL), false, HDF_FAILURE);
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
+struct PlatformArbiterTestEntry {
+    int cmd;
+    int32_t (*func)(struct PlatformArbiter *arbiter);
+    const char *name;
+};
+
+static struct PlatformArbiterTestEntry g_entry[] = {
+    { PLAT_ARBITER_TEST_PRIORITY_ORDER, PlatformArbiterTestPriorityOrder, "PlatformArbiterTestPriorityOrder" },
+    { PLAT_ARBITER_TEST_TIMEOUT, PlatformArbiterTestTimeout, "PlatformArbiterTestTimeout" },
+    { PLAT_ARBITER_TEST_YIELD, PlatformArbiterTestYield, "PlatformArbiterTestYield" },
+    { PLAT_ARBITER_TEST_RELIABILITY, PlatformArbiterTestReliability, "PlatformArbiterTestReliability" },
+};
+
+int PlatformArbiterTestExecute(int cmd)
+{
+    uint32_t i;
+    int32_t ret;
+    struct PlatformArbiter arbiter;
+    struct PlatformArbiterTestEntry *entry = NULL;
+
+    if (cmd < 0 || cmd >= PLAT_ARBITER_TEST_CMD_MAX) {
+        PLAT_LOGE("PlatformArbiterTestExecute: invalid cmd:%d", cmd);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    for (i = 0; i < sizeof(g_entry) / sizeof(g_entry[0]); i++) {
+        if (g_entry[i].cmd != cmd || g_entry[i].func == NULL) {
+            continue;
+        }
+        entry = &g_entry[i];
+        break;
+    }
+
+    if (entry == NULL) {
+        PLAT_LOGE("%s: no entry matched, cmd = %d", __func__, cmd);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    ret = PlatformArbiterInit(&arbiter);
+    if (ret != HDF_SUCCESS) {
+        PLAT_LOGE("%s: init arbiter failed, ret = %d", __func__, ret);
+        return ret;
+    }
+
+    ret = entry->func(&arbiter);
+    PlatformArbiterUninit(&arbiter);
+
+    PLAT_LOGE("[PlatformArbiterTestExecute][======cmd:%d====ret:%d======]", cmd, ret);
+    return ret;
+}
+
+void PlatformArbiterTestExecuteAll(void)
+{
+    int32_t i;
+    int32_t ret;
+    int32_t fails = 0;
+
+    for (i = 0; i < PLAT_ARBITER_TEST_CMD_MAX; i++) {
+        ret = PlatformArbiterTestExecute(i);
+        fails += (ret != HDF_SUCCESS) ? 1 : 0;
+    }
+
+    PLAT_LOGE("PlatformArbiterTestExecuteALL: **********PASS:%d  FAIL:%d************\n\n",
+        PLAT_ARBITER_TEST_CMD_MAX - fails, fails);
+}
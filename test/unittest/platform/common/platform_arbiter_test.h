@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef PLATFORM_ARBITER_TEST_H
+#define PLATFORM_ARBITER_TEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum PlatformArbiterTestCmd {
+    PLAT_ARBITER_TEST_PRIORITY_ORDER = 0,
+    PLAT_ARBITER_TEST_TIMEOUT = 1,
+    PLAT_ARBITER_TEST_YIELD = 2,
+    PLAT_ARBITER_TEST_RELIABILITY = 3,
+    PLAT_ARBITER_TEST_CMD_MAX,
+};
+
+int PlatformArbiterTestExecute(int cmd);
+void PlatformArbiterTestExecuteAll(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PLATFORM_ARBITER_TEST_H */
@@ -10,6 +10,7 @@
 #include "device_resource_if.h"
 #include "hdf_base.h"
 #include "hdf_device_desc.h"
+#include "platform_arbiter_test.h"
 #include "platform_device_test.h"
 #include "platform_event_test.h"
 #include "platform_log.h"
@@ -23,6 +24,7 @@ static void DoAllPlatformTest(void)
     PlatformQueueTestExecuteAll();
     PlatformManagerTestExecuteAll();
     PlatformDeviceTestExecuteAll();
+    PlatformArbiterTestExecuteAll();
 #ifdef LOSCFG_DRIVERS_HDF_PLATFORM_I2C
     PLAT_LOGE("DoAllPlatformTest: do i2c test ...");
     I2cTestExecuteAll();
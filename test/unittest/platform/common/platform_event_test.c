@@ -147,6 +147,68 @@ static int32_t PlatformEventTestListenAndUnliten(struct PlatformEvent *pe)
     return HDF_SUCCESS;
 }
 
+static int32_t PlatformEventTestBroadcast(struct PlatformEvent *pe)
+{
+    int32_t ret;
+    uint32_t eventsA = 0;
+    uint32_t eventsB = 0;
+    uint32_t eventsAB = 0;
+    struct PlatformEventListener listenerA = { &eventsA, PLAT_TEST_EVENT_A, PlatformEventListenTestCb };
+    struct PlatformEventListener listenerB = { &eventsB, PLAT_TEST_EVENT_A, PlatformEventListenTestCb };
+    struct PlatformEventListener listenerAB = {
+        &eventsAB, PLAT_TEST_EVENT_A | PLAT_TEST_EVENT_B, PlatformEventListenTestCb
+    };
+
+    PLAT_LOGD("%s: enter", __func__);
+    ret = PlatformEventListen(pe, &listenerA);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+    ret = PlatformEventListen(pe, &listenerB);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+    ret = PlatformEventListen(pe, &listenerAB);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+
+    // only one listener got the events by default
+    ret = PlatformEventPost(pe, PLAT_TEST_EVENT_A);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+    OsalMSleep(PLAT_EVENT_TEST_TIMEOUT);
+    CHECK_EQ_RETURN(eventsA | eventsB | eventsAB, PLAT_TEST_EVENT_A, HDF_FAILURE);
+    CHECK_EQ_RETURN((eventsA != 0) + (eventsB != 0) + (eventsAB != 0), 1, HDF_FAILURE);
+
+    // all the matching listeners got the events on broadcast
+    eventsA = eventsB = eventsAB = 0;
+    ret = PlatformEventBroadcast(pe, PLAT_TEST_EVENT_A);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+    OsalMSleep(PLAT_EVENT_TEST_TIMEOUT);
+    CHECK_EQ_RETURN(eventsA, PLAT_TEST_EVENT_A, HDF_FAILURE);
+    CHECK_EQ_RETURN(eventsB, PLAT_TEST_EVENT_A, HDF_FAILURE);
+    CHECK_EQ_RETURN(eventsAB, PLAT_TEST_EVENT_A, HDF_FAILURE);
+
+    // not interested listeners are not woken, even under wake all policy
+    eventsA = eventsB = eventsAB = 0;
+    ret = PlatformEventSetWakePolicy(pe, PLAT_EVENT_WAKE_ALL);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+    ret = PlatformEventPost(pe, PLAT_TEST_EVENT_B);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+    OsalMSleep(PLAT_EVENT_TEST_TIMEOUT);
+    CHECK_EQ_RETURN(eventsA, 0, HDF_FAILURE);
+    CHECK_EQ_RETURN(eventsB, 0, HDF_FAILURE);
+    CHECK_EQ_RETURN(eventsAB, PLAT_TEST_EVENT_B, HDF_FAILURE);
+
+    // the events are consumed after delivered
+    CHECK_EQ_RETURN(pe->eventsWord, 0, HDF_FAILURE);
+
+    ret = PlatformEventSetWakePolicy(pe, PLAT_EVENT_WAKE_ALL + 1);
+    CHECK_NE_RETURN(ret, HDF_SUCCESS, HDF_FAILURE);
+
+    PlatformEventUnlisten(pe, &listenerA);
+    PlatformEventUnlisten(pe, &listenerB);
+    PlatformEventUnlisten(pe, &listenerAB);
+    CHECK_EQ_RETURN(pe->waiterCnt, 0, HDF_FAILURE);
+
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
 static int32_t PlatformEventTestReliability(struct PlatformEvent *pe)
 {
     int32_t ret;
@@ -193,6 +255,7 @@ static struct PlatformEventTestEntry g_entry[] = {
     { PLAT_EVENT_TEST_POST_AND_WAIT, PlatformEventTestPostAndWait, "PlatformEventTestPostAndWait" },
     { PLAT_EVENT_TEST_LISTEN_AND_UNLISTEN, PlatformEventTestListenAndUnliten, "PlatformEventTestListenAndUnliten" },
     { PLAT_EVENT_TEST_RELIABILITY, PlatformEventTestReliability, "PlatformEventTestReliability" },
+    { PLAT_EVENT_TEST_BROADCAST, PlatformEventTestBroadcast, "PlatformEventTestBroadcast" },
 };
 
 int PlatformEventTestExecute(int cmd)
@@ -18,6 +18,7 @@ enum PlatformEventTestCmd {
     PLAT_EVENT_TEST_POST_AND_WAIT = 1,
     PLAT_EVENT_TEST_LISTEN_AND_UNLISTEN = 2,
     PLAT_EVENT_TEST_RELIABILITY = 3,
+    PLAT_EVENT_TEST_BROADCAST = 4,
     PLAT_EVENT_TEST_CMD_MAX,
 };
 
@@ -18,6 +18,8 @@
 #define PLAT_DEV_NUMBER_0               0
 #define PLAT_DEV_NUMBER_1               1
 #define PLAT_DEV_NUMBER_2               2
+#define PLAT_DEV_NUMBER_GROW            600
+#define PLAT_DEV_NUMBER_UNINDEXED       0x10000
 
 static struct PlatformDevice *g_platDevices[PLAT_MGR_TEST_DEV_NUM];
 
@@ -219,6 +221,60 @@ static int32_t PlatformManagerTestReliability(struct PlatformManager *manager)
     return HDF_SUCCESS;
 }
 
+static int32_t PlatformManagerTestNumberIndex(struct PlatformManager *manager)
+{
+    int32_t ret;
+    int32_t number;
+    struct PlatformDevice *device0 = g_platDevices[PLAT_DEV_NUMBER_0];
+    struct PlatformDevice *device1 = g_platDevices[PLAT_DEV_NUMBER_1];
+    struct PlatformDevice *device2 = g_platDevices[PLAT_DEV_NUMBER_2];
+    struct PlatformDevice *deviceGet = NULL;
+
+    PLAT_LOGD("%s: enter", __func__);
+    number = device2->number;
+    ret = PlatformManagerAddDevice(manager, device0);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+
+    // should still find the devices added before the index grows
+    device1->number = PLAT_DEV_NUMBER_GROW;
+    ret = PlatformManagerAddDevice(manager, device1);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    deviceGet = PlatformManagerGetDeviceByNumber(manager, device0->number);
+    CHECK_EQ_RETURN(deviceGet, device0, HDF_FAILURE);
+    PlatformDevicePut(deviceGet);
+    deviceGet = PlatformManagerGetDeviceByNumber(manager, device1->number);
+    CHECK_EQ_RETURN(deviceGet, device1, HDF_FAILURE);
+    PlatformDevicePut(deviceGet);
+
+    // should find the device whose number is out of the index
+    device2->number = PLAT_DEV_NUMBER_UNINDEXED;
+    ret = PlatformManagerAddDevice(manager, device2);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    deviceGet = PlatformManagerGetDeviceByNumber(manager, device2->number);
+    CHECK_EQ_RETURN(deviceGet, device2, HDF_FAILURE);
+    PlatformDevicePut(deviceGet);
+
+    // should not find the device removed, and find it again after added back
+    ret = PlatformManagerDelDevice(manager, device1);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    deviceGet = PlatformManagerGetDeviceByNumber(manager, device1->number);
+    CHECK_EQ_RETURN(deviceGet, NULL, HDF_FAILURE);
+    ret = PlatformManagerAddDevice(manager, device1);
+    CHECK_EQ_RETURN(ret, HDF_SUCCESS, ret);
+    deviceGet = PlatformManagerGetDeviceByNumber(manager, device1->number);
+    CHECK_EQ_RETURN(deviceGet, device1, HDF_FAILURE);
+    PlatformDevicePut(deviceGet);
+
+    // should not find a number never added
+    deviceGet = PlatformManagerGetDeviceByNumber(manager, PLAT_DEV_NUMBER_GROW + 1);
+    CHECK_EQ_RETURN(deviceGet, NULL, HDF_FAILURE);
+
+    device1->number = PLAT_DEV_NUMBER_1 + PLAT_MGR_TEST_DEV_NUM_START;
+    device2->number = number;
+    PLAT_LOGD("%s: exit", __func__);
+    return HDF_SUCCESS;
+}
+
 struct PlatformManagerTestEntry {
     int cmd;
     int32_t (*func)(struct PlatformManager *manager);
@@ -229,6 +285,7 @@ static struct PlatformManagerTestEntry g_entry[] = {
     { PLAT_MANAGER_TEST_ADD_DEVICE, PlatformManagerTestAddAndDel, "PlatformManagerTestAddAndDel" },
     { PLAT_MANAGER_TEST_GET_DEVICE, PlatformManagerTestGetDevice, "PlatformManagerTestGetDevice" },
     { PLAT_MANAGER_TEST_RELIABILITY, PlatformManagerTestReliability, "PlatformManagerTestReliability" },
+    { PLAT_MANAGER_TEST_NUMBER_INDEX, PlatformManagerTestNumberIndex, "PlatformManagerTestNumberIndex" },
 };
 
 int PlatformManagerTestExecute(int cmd)
@@ -17,6 +17,7 @@ enum PlatformManagerTestCmd {
     PLAT_MANAGER_TEST_ADD_DEVICE = 0,
     PLAT_MANAGER_TEST_GET_DEVICE  = 1,
     PLAT_MANAGER_TEST_RELIABILITY = 2,
+    PLAT_MANAGER_TEST_NUMBER_INDEX = 3,
     PLAT_MANAGER_TEST_CMD_MAX,
 };
 
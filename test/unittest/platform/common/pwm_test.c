@@ -13,11 +13,20 @@
 #include "osal_mem.h"
 #include "osal_time.h"
 #include "securec.h"
+#ifndef __USER__
+#include "devsvc_manager_clnt.h"
+#include "pwm_core.h"
+#endif
 
 #define HDF_LOG_TAG           pwm_test
 #define SEQ_OUTPUT_DELAY      100 /* Delay time of sequential output, unit: ms */
 #define OUTPUT_WAVES_DELAY    1 /* Delay time of waves output, unit: second */
 #define TEST_WAVES_NUMBER     10 /* The number of waves for test. */
+#define PWM_TEST_GROUP_NUM    3  /* The number of fake devices in a group test. */
+#define PWM_TEST_GROUP_PERIOD 1000
+#define PWM_TEST_OWNER_NUM    240 /* The first fake device of the owner test, clear of the real ones. */
+#define PWM_TEST_OWNER_DEVS   2
+#define PWM_TEST_NAME_LEN     32
 
 static int32_t PwmTesterGetConfig(struct PwmTestConfig *config)
 {
@@ -352,6 +361,392 @@ static int32_t PwmIfPerformanceTest(struct PwmTester *tester)
     return HDF_SUCCESS;
 }
 
+static int32_t PwmSetConfigGroupTest(struct PwmTester *tester)
+{
+    int32_t ret;
+    struct PwmConfig cfg = {0};
+    struct PwmConfig origin = {0};
+    struct PwmGroupItem items[2];
+
+    ret = PwmGetConfig(tester->handle, &origin);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: [PwmGetConfig] failed, ret %d.", __func__, ret);
+        return ret;
+    }
+
+    items[0].handle = tester->handle;
+    items[0].config = tester->config.cfg;
+    items[0].config.duty = tester->config.cfg.period / 2; // 2: half of the period
+    ret = PwmSetConfigGroup(items, 1);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: [PwmSetConfigGroup] failed, ret %d.", __func__, ret);
+        return ret;
+    }
+    ret = PwmGetConfig(tester->handle, &cfg);
+    if (ret != HDF_SUCCESS || memcmp(&cfg, &items[0].config, sizeof(cfg)) != 0) {
+        HDF_LOGE("%s: group config not applied, ret %d.", __func__, ret);
+        (void)PwmSetConfig(tester->handle, &origin);
+        return HDF_FAILURE;
+    }
+
+    // a device may appear only once in a group
+    items[1] = items[0];
+    ret = PwmSetConfigGroup(items, 2); // 2: the same device twice
+    (void)PwmSetConfig(tester->handle, &origin);
+    if (ret == HDF_SUCCESS) {
+        HDF_LOGE("%s: duplicated device accepted.", __func__);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+#ifndef __USER__
+/* fake devices of one controller, their registers are g_pwmGroup.hw */
+struct PwmTestGroup {
+    struct PwmDev devs[PWM_TEST_GROUP_NUM];
+    struct PwmConfig hw[PWM_TEST_GROUP_NUM];
+    struct PwmConfig origin[PWM_TEST_GROUP_NUM];
+    uint32_t setCalls;
+    uint32_t groupCalls;
+    uint32_t groupCount;
+    uint32_t failNum;      /* setConfig of this device fails, PWM_TEST_GROUP_NUM for none */
+    bool groupSupported;
+};
+
+static struct PwmTestGroup g_pwmGroup;
+
+static int32_t PwmTestGroupSetConfig(struct PwmDev *pwm, struct PwmConfig *config)
+{
+    g_pwmGroup.setCalls++;
+    if (pwm->num == g_pwmGroup.failNum) {
+        return HDF_ERR_IO;
+    }
+    g_pwmGroup.hw[pwm->num] = *config;
+    return HDF_SUCCESS;
+}
+
+static int32_t PwmTestGroupSetConfigGroup(struct PwmDev **pwms, struct PwmConfig *configs, uint32_t count)
+{
+    uint32_t i;
+
+    if (!g_pwmGroup.groupSupported) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    g_pwmGroup.groupCalls++;
+    g_pwmGroup.groupCount = count;
+    for (i = 0; i < count; i++) {
+        g_pwmGroup.hw[pwms[i]->num] = configs[i];
+    }
+    return HDF_SUCCESS;
+}
+
+static struct PwmMethod g_pwmGroupMethod = {
+    .setConfig = PwmTestGroupSetConfig,
+    .setConfigGroup = PwmTestGroupSetConfigGroup,
+};
+
+static void PwmTestGroupInit(bool groupSupported, uint32_t failNum)
+{
+    uint32_t i;
+
+    (void)memset_s(&g_pwmGroup, sizeof(g_pwmGroup), 0, sizeof(g_pwmGroup));
+    for (i = 0; i < PWM_TEST_GROUP_NUM; i++) {
+        g_pwmGroup.devs[i].num = i;
+        g_pwmGroup.devs[i].method = &g_pwmGroupMethod;
+        g_pwmGroup.devs[i].busy = true;
+        g_pwmGroup.devs[i].cfg.period = PWM_TEST_GROUP_PERIOD;
+        g_pwmGroup.devs[i].cfg.status = PWM_ENABLE_STATUS;
+        (void)OsalSpinInit(&g_pwmGroup.devs[i].lock);
+        g_pwmGroup.hw[i] = g_pwmGroup.devs[i].cfg;
+        g_pwmGroup.origin[i] = g_pwmGroup.devs[i].cfg;
+    }
+    g_pwmGroup.groupSupported = groupSupported;
+    g_pwmGroup.failNum = failNum;
+}
+
+static void PwmTestGroupDeinit(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < PWM_TEST_GROUP_NUM; i++) {
+        (void)OsalSpinDestroy(&g_pwmGroup.devs[i].lock);
+    }
+}
+
+static int32_t PwmTestGroupApply(struct PwmConfig *configs)
+{
+    uint32_t i;
+    struct PwmDev *pwms[PWM_TEST_GROUP_NUM];
+
+    for (i = 0; i < PWM_TEST_GROUP_NUM; i++) {
+        pwms[i] = &g_pwmGroup.devs[i];
+    }
+    return PwmDeviceSetConfigGroup(pwms, configs, PWM_TEST_GROUP_NUM);
+}
+
+// both the registers and the cached config of every device hold the expected one
+static bool PwmTestGroupMatch(const struct PwmConfig *expected)
+{
+    uint32_t i;
+
+    for (i = 0; i < PWM_TEST_GROUP_NUM; i++) {
+        if (memcmp(&g_pwmGroup.hw[i], &expected[i], sizeof(expected[i])) != 0 ||
+            memcmp(&g_pwmGroup.devs[i].cfg, &expected[i], sizeof(expected[i])) != 0) {
+            HDF_LOGE("%s: pwm%u holds duty %u, expected %u", __func__, i, g_pwmGroup.hw[i].duty, expected[i].duty);
+            return false;
+        }
+    }
+    return true;
+}
+
+static int32_t PwmTestOwnerSetConfig(struct PwmDev *pwm, struct PwmConfig *config)
+{
+    (void)pwm;
+    (void)config;
+    return HDF_SUCCESS;
+}
+
+static struct PwmMethod g_pwmOwnerMethod = {
+    .setConfig = PwmTestOwnerSetConfig,
+};
+
+/* clients of the fake device nodes, each one stands for a separate opener */
+enum PwmTestOwnerClient {
+    PWM_TEST_OWNER_CARRIER = 0,    /* opens the first device and carries the group */
+    PWM_TEST_OWNER_MEMBER,         /* opens the second device */
+    PWM_TEST_OWNER_OTHER,          /* a client of the second device that did not open it */
+    PWM_TEST_OWNER_REOPEN,         /* opens the first device again after the carrier closed it */
+    PWM_TEST_OWNER_CLIENTS,
+};
+
+/* fake devices reachable by number, so the group goes through the dispatch of the core */
+struct PwmTestOwner {
+    struct PwmDev devs[PWM_TEST_OWNER_DEVS];
+    struct HdfDeviceObject objs[PWM_TEST_OWNER_DEVS];
+    struct HdfDeviceIoClient clients[PWM_TEST_OWNER_CLIENTS];
+    struct HdfSBuf *data;
+};
+
+static struct PwmTestOwner g_pwmOwner;
+
+static void PwmTestOwnerName(uint32_t i, char *name)
+{
+    (void)snprintf_s(name, PWM_TEST_NAME_LEN + 1, PWM_TEST_NAME_LEN, "HDF_PLATFORM_PWM_%u", PWM_TEST_OWNER_NUM + i);
+}
+
+static int32_t PwmTestOwnerInit(void)
+{
+    uint32_t i;
+    char name[PWM_TEST_NAME_LEN + 1] = {0};
+
+    (void)memset_s(&g_pwmOwner, sizeof(g_pwmOwner), 0, sizeof(g_pwmOwner));
+    for (i = 0; i < PWM_TEST_OWNER_DEVS; i++) {
+        g_pwmOwner.devs[i].num = PWM_TEST_OWNER_NUM + i;
+        g_pwmOwner.devs[i].method = &g_pwmOwnerMethod;
+        g_pwmOwner.devs[i].cfg.period = PWM_TEST_GROUP_PERIOD;
+        (void)PwmDeviceAdd(&g_pwmOwner.objs[i], &g_pwmOwner.devs[i]);
+        PwmTestOwnerName(i, name);
+        (void)DevSvcManagerClntAddService(name, DEVICE_CLASS_PLAT, &g_pwmOwner.objs[i], NULL);
+    }
+    g_pwmOwner.data = HdfSbufObtainDefaultSize();
+    if (g_pwmOwner.data == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    g_pwmOwner.clients[PWM_TEST_OWNER_CARRIER].device = &g_pwmOwner.objs[0];
+    g_pwmOwner.clients[PWM_TEST_OWNER_MEMBER].device = &g_pwmOwner.objs[1];
+    g_pwmOwner.clients[PWM_TEST_OWNER_OTHER].device = &g_pwmOwner.objs[1];
+    g_pwmOwner.clients[PWM_TEST_OWNER_REOPEN].device = &g_pwmOwner.objs[0];
+    for (i = 0; i < PWM_TEST_OWNER_CLIENTS; i++) {
+        if (g_pwmOwner.clients[i].device->service->Open(&g_pwmOwner.clients[i]) != HDF_SUCCESS) {
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static void PwmTestOwnerDeinit(void)
+{
+    uint32_t i;
+    char name[PWM_TEST_NAME_LEN + 1] = {0};
+
+    for (i = 0; i < PWM_TEST_OWNER_CLIENTS; i++) {
+        if (g_pwmOwner.clients[i].device != NULL) {
+            g_pwmOwner.clients[i].device->service->Release(&g_pwmOwner.clients[i]);
+        }
+    }
+    for (i = 0; i < PWM_TEST_OWNER_DEVS; i++) {
+        PwmTestOwnerName(i, name);
+        DevSvcManagerClntRemoveService(name);
+        PwmDeviceRemove(&g_pwmOwner.objs[i], &g_pwmOwner.devs[i]);
+    }
+    HdfSbufRecycle(g_pwmOwner.data);
+}
+
+static int32_t PwmTestOwnerCall(enum PwmTestOwnerClient id, int cmd)
+{
+    struct HdfDeviceIoClient *client = &g_pwmOwner.clients[id];
+
+    return client->device->service->Dispatch(client, cmd, g_pwmOwner.data, NULL);
+}
+
+static int32_t PwmTestOwnerJoin(enum PwmTestOwnerClient id)
+{
+    HdfSbufFlush(g_pwmOwner.data);
+    (void)HdfSbufWriteUint32(g_pwmOwner.data, PWM_TEST_OWNER_NUM);
+    return PwmTestOwnerCall(id, PWM_IO_JOIN_GROUP);
+}
+
+// both devices in one group carried through the client, the second one set to the given duty
+static int32_t PwmTestOwnerGroup(enum PwmTestOwnerClient id, uint32_t duty)
+{
+    uint32_t i;
+    struct PwmConfig cfg;
+
+    HdfSbufFlush(g_pwmOwner.data);
+    (void)HdfSbufWriteUint32(g_pwmOwner.data, PWM_TEST_OWNER_DEVS);
+    for (i = 0; i < PWM_TEST_OWNER_DEVS; i++) {
+        cfg = g_pwmOwner.devs[i].cfg;
+        cfg.duty = (i == 0) ? cfg.duty : duty;
+        (void)HdfSbufWriteUint32(g_pwmOwner.data, g_pwmOwner.devs[i].num);
+        (void)HdfSbufWriteBuffer(g_pwmOwner.data, &cfg, sizeof(cfg));
+    }
+    return PwmTestOwnerCall(id, PWM_IO_SET_CONFIG_GROUP);
+}
+
+static int32_t PwmTestOwnerRun(void)
+{
+    uint32_t duty = PWM_TEST_GROUP_PERIOD / 2; // 2: half of the period
+
+    if (PwmTestOwnerCall(PWM_TEST_OWNER_CARRIER, PWM_IO_GET) != HDF_SUCCESS ||
+        PwmTestOwnerCall(PWM_TEST_OWNER_MEMBER, PWM_IO_GET) != HDF_SUCCESS ||
+        PwmTestOwnerCall(PWM_TEST_OWNER_OTHER, PWM_IO_GET) == HDF_SUCCESS) {
+        HDF_LOGE("%s: open of the fake devices not as expected", __func__);
+        return HDF_FAILURE;
+    }
+    // a device its opener did not join, or one a client that did not open it tried to join, stays out
+    if (PwmTestOwnerGroup(PWM_TEST_OWNER_CARRIER, duty) == HDF_SUCCESS ||
+        PwmTestOwnerJoin(PWM_TEST_OWNER_OTHER) == HDF_SUCCESS ||
+        PwmTestOwnerGroup(PWM_TEST_OWNER_CARRIER, duty) == HDF_SUCCESS ||
+        PwmTestOwnerCall(PWM_TEST_OWNER_OTHER, PWM_IO_PUT) == HDF_SUCCESS) {
+        HDF_LOGE("%s: device of another opener accepted", __func__);
+        return HDF_FAILURE;
+    }
+    if (PwmTestOwnerJoin(PWM_TEST_OWNER_MEMBER) != HDF_SUCCESS ||
+        PwmTestOwnerGroup(PWM_TEST_OWNER_CARRIER, duty) != HDF_SUCCESS || g_pwmOwner.devs[1].cfg.duty != duty) {
+        HDF_LOGE("%s: joined group not applied, duty %u", __func__, g_pwmOwner.devs[1].cfg.duty);
+        return HDF_FAILURE;
+    }
+    // the join holds for that open of the carrier only
+    if (PwmTestOwnerCall(PWM_TEST_OWNER_CARRIER, PWM_IO_PUT) != HDF_SUCCESS ||
+        PwmTestOwnerCall(PWM_TEST_OWNER_REOPEN, PWM_IO_GET) != HDF_SUCCESS ||
+        PwmTestOwnerGroup(PWM_TEST_OWNER_REOPEN, duty / 2) == HDF_SUCCESS) { // 2: another duty
+        HDF_LOGE("%s: join carried over to a later open", __func__);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+#endif
+
+static int32_t PwmSetConfigGroupHookTest(struct PwmTester *tester)
+{
+#ifdef __USER__
+    // the group is made of fake devices, only reachable in kernel
+    (void)tester;
+    HDF_LOGI("%s: skipped in user space", __func__);
+    return HDF_SUCCESS;
+#else
+    int32_t ret;
+    uint32_t i;
+    struct PwmConfig configs[PWM_TEST_GROUP_NUM];
+
+    (void)tester;
+    PwmTestGroupInit(true, PWM_TEST_GROUP_NUM);
+    for (i = 0; i < PWM_TEST_GROUP_NUM; i++) {
+        configs[i] = g_pwmGroup.origin[i];
+        configs[i].duty = PWM_TEST_GROUP_PERIOD / (i + 2); // 2: at most half of the period
+    }
+    configs[1] = g_pwmGroup.origin[1];  // left as it is, so not handed to the driver
+
+    ret = PwmTestGroupApply(configs);
+    if (ret != HDF_SUCCESS || g_pwmGroup.groupCalls != 1 || g_pwmGroup.groupCount != PWM_TEST_GROUP_NUM - 1 ||
+        g_pwmGroup.setCalls != 0 || !PwmTestGroupMatch(configs)) {
+        HDF_LOGE("%s: ret %d, group calls %u of %u devices, set calls %u", __func__, ret,
+            g_pwmGroup.groupCalls, g_pwmGroup.groupCount, g_pwmGroup.setCalls);
+        PwmTestGroupDeinit();
+        return HDF_FAILURE;
+    }
+    PwmTestGroupDeinit();
+    return HDF_SUCCESS;
+#endif
+}
+
+static int32_t PwmSetConfigGroupRollbackTest(struct PwmTester *tester)
+{
+#ifdef __USER__
+    // the group is made of fake devices, only reachable in kernel
+    (void)tester;
+    HDF_LOGI("%s: skipped in user space", __func__);
+    return HDF_SUCCESS;
+#else
+    int32_t ret;
+    uint32_t i;
+    struct PwmConfig configs[PWM_TEST_GROUP_NUM];
+
+    (void)tester;
+    // no group hook, the devices are set one by one and the last one fails
+    PwmTestGroupInit(false, PWM_TEST_GROUP_NUM - 1);
+    for (i = 0; i < PWM_TEST_GROUP_NUM; i++) {
+        configs[i] = g_pwmGroup.origin[i];
+        configs[i].duty = PWM_TEST_GROUP_PERIOD / (i + 2); // 2: at most half of the period
+    }
+
+    ret = PwmTestGroupApply(configs);
+    // every device tried once, then the ones set before the failure restored
+    if (ret == HDF_SUCCESS || g_pwmGroup.setCalls != PWM_TEST_GROUP_NUM + PWM_TEST_GROUP_NUM - 1 ||
+        !PwmTestGroupMatch(g_pwmGroup.origin)) {
+        HDF_LOGE("%s: failed group not rolled back, ret %d, set calls %u", __func__, ret, g_pwmGroup.setCalls);
+        PwmTestGroupDeinit();
+        return HDF_FAILURE;
+    }
+
+    g_pwmGroup.failNum = PWM_TEST_GROUP_NUM;
+    g_pwmGroup.setCalls = 0;
+    ret = PwmTestGroupApply(configs);
+    if (ret != HDF_SUCCESS || g_pwmGroup.setCalls != PWM_TEST_GROUP_NUM || !PwmTestGroupMatch(configs)) {
+        HDF_LOGE("%s: group not applied one by one, ret %d, set calls %u", __func__, ret, g_pwmGroup.setCalls);
+        PwmTestGroupDeinit();
+        return HDF_FAILURE;
+    }
+    PwmTestGroupDeinit();
+    return HDF_SUCCESS;
+#endif
+}
+
+static int32_t PwmSetConfigGroupOwnerTest(struct PwmTester *tester)
+{
+#ifdef __USER__
+    // the devices are fake, only reachable in kernel
+    (void)tester;
+    HDF_LOGI("%s: skipped in user space", __func__);
+    return HDF_SUCCESS;
+#else
+    int32_t ret;
+
+    (void)tester;
+    ret = PwmTestOwnerInit();
+    if (ret == HDF_SUCCESS) {
+        ret = PwmTestOwnerRun();
+    }
+    PwmTestOwnerDeinit();
+    // releasing the clients closes what they left open
+    if (ret == HDF_SUCCESS && (g_pwmOwner.devs[0].busy || g_pwmOwner.devs[1].busy)) {
+        HDF_LOGE("%s: device left open after its client went away", __func__);
+        ret = HDF_FAILURE;
+    }
+    return ret;
+#endif
+}
+
 struct PwmTestEntry {
     int cmd;
     int32_t (*func)(struct PwmTester *tester);
@@ -366,6 +761,10 @@ static struct PwmTestEntry g_entry[] = {
     { PWM_SET_GET_CONFIG_TEST, PwmSetGetConfigTest },
     { PWM_RELIABILITY_TEST, PwmReliabilityTest },
     { PWM_IF_PERFORMANCE_TEST, PwmIfPerformanceTest },
+    { PWM_SET_CONFIG_GROUP_TEST, PwmSetConfigGroupTest },
+    { PWM_SET_CONFIG_GROUP_HOOK_TEST, PwmSetConfigGroupHookTest },
+    { PWM_SET_CONFIG_GROUP_ROLLBACK_TEST, PwmSetConfigGroupRollbackTest },
+    { PWM_SET_CONFIG_GROUP_OWNER_TEST, PwmSetConfigGroupOwnerTest },
 };
 
 int32_t PwmTestExecute(int cmd)
@@ -26,6 +26,10 @@ enum PwmTestCmd {
     PWM_SET_GET_CONFIG_TEST,
     PWM_RELIABILITY_TEST,
     PWM_IF_PERFORMANCE_TEST,
+    PWM_SET_CONFIG_GROUP_TEST,
+    PWM_SET_CONFIG_GROUP_HOOK_TEST,
+    PWM_SET_CONFIG_GROUP_ROLLBACK_TEST,
+    PWM_SET_CONFIG_GROUP_OWNER_TEST,
     PWM_TEST_CMD_MAX,
 };
 
@@ -9,9 +9,11 @@
 #include "regulator_test.h"
 #include "device_resource_if.h"
 #include "hdf_log.h"
+#include "osal_mem.h"
 #include "osal_thread.h"
 #include "osal_time.h"
 #include "regulator_if.h"
+#include "regulator/regulator_core.h"
 #if defined(CONFIG_DRIVERS_HDF_PLATFORM_REGULATOR)
 #include "virtual/regulator_linux_voltage_virtual_driver.h"
 #include "virtual/regulator_linux_current_virtual_driver.h"
@@ -250,6 +252,249 @@ int32_t RegulatorTestReliability(struct RegulatorTest *test)
     return HDF_SUCCESS;
 }
 
+#define REGULATOR_BATCH_TEST_PARENT "regulator_batch_test_parent"
+#define REGULATOR_BATCH_TEST_CHILD  "regulator_batch_test_child"
+#define REGULATOR_BATCH_TEST_LOG_MAX 8
+
+struct RegulatorBatchTestRecord {
+    struct RegulatorNode *node;
+    uint8_t op;
+};
+
+static struct RegulatorBatchTestRecord g_batchTestLog[REGULATOR_BATCH_TEST_LOG_MAX];
+static uint32_t g_batchTestLogCnt;
+
+static void RegulatorBatchTestRecord(struct RegulatorNode *node, uint8_t op)
+{
+    if (g_batchTestLogCnt < REGULATOR_BATCH_TEST_LOG_MAX) {
+        g_batchTestLog[g_batchTestLogCnt].node = node;
+        g_batchTestLog[g_batchTestLogCnt].op = op;
+    }
+    g_batchTestLogCnt++;
+}
+
+static int32_t RegulatorBatchTestEnable(struct RegulatorNode *node)
+{
+    node->regulatorInfo.status = REGULATOR_STATUS_ON;
+    RegulatorBatchTestRecord(node, REGULATOR_BATCH_ENABLE);
+    return HDF_SUCCESS;
+}
+
+static int32_t RegulatorBatchTestDisable(struct RegulatorNode *node)
+{
+    node->regulatorInfo.status = REGULATOR_STATUS_OFF;
+    RegulatorBatchTestRecord(node, REGULATOR_BATCH_DISABLE);
+    return HDF_SUCCESS;
+}
+
+static int32_t RegulatorBatchTestSetVoltage(struct RegulatorNode *node, uint32_t minUv, uint32_t maxUv)
+{
+    (void)minUv;
+    (void)maxUv;
+    RegulatorBatchTestRecord(node, REGULATOR_BATCH_SET_VOLTAGE);
+    return HDF_SUCCESS;
+}
+
+static int32_t RegulatorBatchTestGetStatus(struct RegulatorNode *node, uint32_t *status)
+{
+    *status = node->regulatorInfo.status;
+    return HDF_SUCCESS;
+}
+
+static struct RegulatorMethod g_batchTestMethod = {
+    .enable = RegulatorBatchTestEnable,
+    .disable = RegulatorBatchTestDisable,
+    .setVoltage = RegulatorBatchTestSetVoltage,
+    .getStatus = RegulatorBatchTestGetStatus,
+};
+
+// the pair is added on the first run and stays with the manager, which frees it on remove
+static DevHandle RegulatorBatchTestNodeGet(const char *name, const char *parentName)
+{
+    struct RegulatorNode *node = NULL;
+    DevHandle handle = RegulatorOpen(name);
+
+    if (handle != NULL) {
+        return handle;
+    }
+    node = (struct RegulatorNode *)OsalMemCalloc(sizeof(*node));
+    if (node == NULL) {
+        HDF_LOGE("%s: malloc %s fail", __func__, name);
+        return NULL;
+    }
+    node->regulatorInfo.name = name;
+    node->regulatorInfo.parentName = parentName;
+    node->regulatorInfo.constraints.mode = REGULATOR_CHANGE_VOLTAGE;
+    node->regulatorInfo.constraints.minUv = VOLTAGE_50_UV;
+    node->regulatorInfo.constraints.maxUv = VOLTAGE_2500_UV;
+    node->ops = &g_batchTestMethod;
+    if (RegulatorNodeAdd(node) != HDF_SUCCESS) {
+        HDF_LOGE("%s: add %s fail", __func__, name);
+        if (RegulatorOpen(name) != (DevHandle)node) {
+            OsalMemFree(node);
+        }
+        return NULL;
+    }
+    return RegulatorOpen(name);
+}
+
+static int32_t RegulatorBatchTestCheckLog(const struct RegulatorBatchTestRecord *expect, uint32_t count)
+{
+    uint32_t i;
+
+    if (g_batchTestLogCnt != count) {
+        HDF_LOGE("RegulatorBatchTestCheckLog: %u ops applied, expect %u", g_batchTestLogCnt, count);
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < count; i++) {
+        if (g_batchTestLog[i].node != expect[i].node || g_batchTestLog[i].op != expect[i].op) {
+            HDF_LOGE("RegulatorBatchTestCheckLog: op %u is %u on %s, expect %u on %s", i, g_batchTestLog[i].op,
+                g_batchTestLog[i].node->regulatorInfo.name, expect[i].op, expect[i].node->regulatorInfo.name);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+/*
+ * Both rails start on. Applied in the caller's order the parent disable would fail with its child still
+ * on, so this only passes when the child goes down first and comes up after its parent.
+ */
+static int32_t RegulatorBatchTreeOrderTest(DevHandle parent, DevHandle child)
+{
+    uint32_t i;
+    uint32_t status = REGULATOR_STATUS_OFF;
+    struct RegulatorBatchStep steps[] = {
+        {child, REGULATOR_BATCH_ENABLE, 0, 0, HDF_FAILURE},
+        {parent, REGULATOR_BATCH_DISABLE, 0, 0, HDF_FAILURE},
+        {child, REGULATOR_BATCH_SET_VOLTAGE, VOLTAGE_250_UV, VOLTAGE_2500_UV, HDF_FAILURE},
+        {child, REGULATOR_BATCH_DISABLE, 0, 0, HDF_FAILURE},
+    };
+    const struct RegulatorBatchTestRecord expect[] = {
+        {(struct RegulatorNode *)child, REGULATOR_BATCH_DISABLE},
+        {(struct RegulatorNode *)parent, REGULATOR_BATCH_DISABLE},
+        {(struct RegulatorNode *)child, REGULATOR_BATCH_SET_VOLTAGE},
+        {(struct RegulatorNode *)parent, REGULATOR_BATCH_ENABLE},
+        {(struct RegulatorNode *)child, REGULATOR_BATCH_ENABLE},
+    };
+    uint32_t count = sizeof(steps) / sizeof(steps[0]);
+
+    if (RegulatorBatchApply(steps, count) != HDF_SUCCESS) {
+        HDF_LOGE("%s: batch apply fail", __func__);
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < count; i++) {
+        if (steps[i].ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: step %u ret %d", __func__, i, steps[i].ret);
+            return HDF_FAILURE;
+        }
+    }
+    if (RegulatorBatchTestCheckLog(expect, sizeof(expect) / sizeof(expect[0])) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    if (RegulatorGetStatus(child, &status) != HDF_SUCCESS || status != REGULATOR_STATUS_ON) {
+        HDF_LOGE("%s: child status %u after batch, expect on", __func__, status);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+// the invalid voltage ranks between the disables and the enable, which must not be applied
+static int32_t RegulatorBatchTreeFailTest(DevHandle parent, DevHandle child)
+{
+    uint32_t status = REGULATOR_STATUS_ON;
+    struct RegulatorBatchStep steps[] = {
+        {child, REGULATOR_BATCH_ENABLE, 0, 0, HDF_FAILURE},
+        {child, REGULATOR_BATCH_SET_VOLTAGE, VOLTAGE_2500_UV, VOLTAGE_50_UV, HDF_FAILURE},
+        {parent, REGULATOR_BATCH_DISABLE, 0, 0, HDF_FAILURE},
+        {child, REGULATOR_BATCH_DISABLE, 0, 0, HDF_FAILURE},
+    };
+    const struct RegulatorBatchTestRecord expect[] = {
+        {(struct RegulatorNode *)child, REGULATOR_BATCH_DISABLE},
+        {(struct RegulatorNode *)parent, REGULATOR_BATCH_DISABLE},
+    };
+
+    if (RegulatorBatchApply(steps, sizeof(steps) / sizeof(steps[0])) == HDF_SUCCESS) {
+        HDF_LOGE("%s: batch with an invalid voltage succeeded", __func__);
+        return HDF_FAILURE;
+    }
+    if (steps[1].ret == HDF_SUCCESS || steps[2].ret != HDF_SUCCESS || steps[3].ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: step ret %d %d %d", __func__, steps[1].ret, steps[2].ret, steps[3].ret);
+        return HDF_FAILURE;
+    }
+    if (RegulatorBatchTestCheckLog(expect, sizeof(expect) / sizeof(expect[0])) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    if (RegulatorGetStatus(child, &status) != HDF_SUCCESS || status != REGULATOR_STATUS_OFF) {
+        HDF_LOGE("%s: child status %u after failed batch, expect off", __func__, status);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t RegulatorBatchTreeTest(void)
+{
+    int32_t ret;
+    DevHandle parent = RegulatorBatchTestNodeGet(REGULATOR_BATCH_TEST_PARENT, NULL);
+    DevHandle child = RegulatorBatchTestNodeGet(REGULATOR_BATCH_TEST_CHILD, REGULATOR_BATCH_TEST_PARENT);
+
+    if (parent == NULL || child == NULL) {
+        return HDF_FAILURE;
+    }
+    // enabling the child brings its parent up, the voltage goes back so the batch has to set it again
+    if (RegulatorEnable(child) != HDF_SUCCESS ||
+        RegulatorSetVoltage(child, VOLTAGE_50_UV, VOLTAGE_2500_UV) != HDF_SUCCESS) {
+        HDF_LOGE("%s: prepare rails fail", __func__);
+        return HDF_FAILURE;
+    }
+
+    g_batchTestLogCnt = 0;
+    ret = RegulatorBatchTreeOrderTest(parent, child);
+    if (ret == HDF_SUCCESS) {
+        g_batchTestLogCnt = 0;
+        ret = RegulatorBatchTreeFailTest(parent, child);
+    }
+    RegulatorClose(child);
+    RegulatorClose(parent);
+    return ret;
+}
+
+// enable is listed first but must be applied last, after the disable
+static int32_t RegulatorBatchTest(struct RegulatorTest *test)
+{
+    uint32_t i;
+    uint32_t status = 0;
+    struct RegulatorBatchStep steps[] = {
+        {test->handle, REGULATOR_BATCH_ENABLE, 0, 0, HDF_FAILURE},
+        {test->handle, REGULATOR_BATCH_DISABLE, 0, 0, HDF_FAILURE},
+        {test->handle, REGULATOR_BATCH_SET_VOLTAGE, test->minUv, test->maxUv, HDF_FAILURE},
+    };
+    uint32_t count = sizeof(steps) / sizeof(steps[0]);
+
+    if (test->mode != REGULATOR_CHANGE_VOLTAGE) {
+        steps[count - 1].op = REGULATOR_BATCH_SET_CURRENT;
+        steps[count - 1].min = test->minUa;
+        steps[count - 1].max = test->maxUa;
+    }
+
+    if (RegulatorBatchApply(steps, count) != HDF_SUCCESS) {
+        HDF_LOGE("%s: batch apply fail", __func__);
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < count; i++) {
+        if (steps[i].ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: step %u ret %d", __func__, i, steps[i].ret);
+            return HDF_FAILURE;
+        }
+    }
+
+    if (RegulatorGetStatus(test->handle, &status) != HDF_SUCCESS || status != REGULATOR_STATUS_ON) {
+        HDF_LOGE("%s: status %u after batch, expect on", __func__, status);
+        return HDF_FAILURE;
+    }
+    return RegulatorBatchTreeTest();
+}
+
 static struct RegulatorTestFunc g_regulatorTestFunc[] = {
     {REGULATOR_ENABLE_TEST, RegulatorEnableTest},
     {REGULATOR_DISABLE_TEST, RegulatorDisableTest},
@@ -261,6 +506,7 @@ static struct RegulatorTestFunc g_regulatorTestFunc[] = {
     {REGULATOR_GET_STATUS_TEST, RegulatorGetStatusTest},
     {REGULATOR_MULTI_THREAD_TEST, RegulatorTestMultiThread},
     {REGULATOR_RELIABILITY_TEST, RegulatorTestReliability},
+    {REGULATOR_BATCH_TEST, RegulatorBatchTest},
 };
 
 static int32_t RegulatorTestEntry(struct RegulatorTest *test, int32_t cmd)
@@ -36,6 +36,7 @@ enum RegulatorTestCmd {
     REGULATOR_GET_STATUS_TEST,
     REGULATOR_MULTI_THREAD_TEST,
     REGULATOR_RELIABILITY_TEST,
+    REGULATOR_BATCH_TEST,
 };
 
 #define REGULATOR_TEST_STACK_SIZE    (1024 * 100)
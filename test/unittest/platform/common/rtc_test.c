@@ -15,8 +15,13 @@
 #include "rtc_base.h"
 #include "rtc_if.h"
 #include "securec.h"
+#ifndef __USER__
+#include "platform_core.h"
+#include "rtc_core.h"
+#endif
 
 #define HDF_LOG_TAG rtc_test_c
+#define RTC_TEST_BRACKET_DELAY_US 200
 
 static int32_t RtcTestGetConfig(struct RtcTestConfig *config)
 {
@@ -612,6 +617,193 @@ static int32_t RtcReadWriteReliability(struct RtcTester *tester)
     return HDF_SUCCESS;
 }
 
+// the correlated point must lie within the call, checked in kernel where the clock of monoUs is at hand
+static int32_t RtcTestReadTimeSyncWithin(DevHandle handle, struct RtcTimeSync *sync)
+{
+#ifndef __USER__
+    int32_t ret;
+    uint64_t before;
+    uint64_t after;
+
+    before = PlatformMonoTimeUs();
+    ret = RtcReadTimeSync(handle, sync);
+    after = PlatformMonoTimeUs();
+    if (ret == HDF_SUCCESS && (sync->monoUs + sync->errorUs < before || sync->monoUs > after + sync->errorUs)) {
+        HDF_LOGE("%s: monoUs %llu out of the call", __func__, (unsigned long long)sync->monoUs);
+        return HDF_FAILURE;
+    }
+    return ret;
+#else
+    return RtcReadTimeSync(handle, sync);
+#endif
+}
+
+static int32_t RtcTimeSyncTest(struct RtcTester *tester)
+{
+    int32_t ret;
+    struct RtcTimeSync first = {0};
+    struct RtcTimeSync second = {0};
+
+    ret = RtcReadWriteTimeTest(tester);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    ret = RtcTestReadTimeSyncWithin(tester->handle, &first);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read time sync fail, ret :%d", __func__, ret);
+        return ret;
+    }
+    if (IsSameRtcTestTime(&first.time, &tester->time) != HDF_SUCCESS) {
+        HDF_LOGE("%s: different time", __func__);
+        return HDF_FAILURE;
+    }
+
+    OsalMSleep(tester->config.writeWaitMillisecond);
+    ret = RtcReadTimeSync(tester->handle, &second);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read time sync again fail, ret :%d", __func__, ret);
+        return ret;
+    }
+    if (second.monoUs <= first.monoUs || IsSameRtcTestTime(&second.time, &first.time) != HDF_SUCCESS) {
+        HDF_LOGE("%s: time went backwards", __func__);
+        return HDF_FAILURE;
+    }
+    HDF_LOGI("%s: errorUs %u, %u", __func__, first.errorUs, second.errorUs);
+    return HDF_SUCCESS;
+}
+
+#ifndef __USER__
+static uint64_t g_rtcBracketSampledUs;
+
+/* an rtc without ReadTimeSync, its counter is sampled halfway through a slow bus access */
+static int32_t RtcTestBracketReadTime(struct RtcHost *host, struct RtcTime *time)
+{
+    struct RtcTester *tester = (struct RtcTester *)host->data;
+
+    OsalUSleep(RTC_TEST_BRACKET_DELAY_US / 2); // 2: half of the access before the sampling
+    g_rtcBracketSampledUs = PlatformMonoTimeUs();
+    OsalUSleep(RTC_TEST_BRACKET_DELAY_US / 2); // 2: and half after it
+    *time = tester->time;
+    return HDF_SUCCESS;
+}
+
+static struct RtcMethod g_rtcBracketMethod = {
+    .ReadTime = RtcTestBracketReadTime,
+};
+#endif
+
+static int32_t RtcTimeSyncBracketTest(struct RtcTester *tester)
+{
+#ifdef __USER__
+    // the rtc is a fake host, only reachable in kernel
+    (void)tester;
+    HDF_LOGI("%s: skipped in user space", __func__);
+    return HDF_SUCCESS;
+#else
+    int32_t ret;
+    struct RtcHost host;
+    struct RtcTimeSync sync = {0};
+
+    (void)memset_s(&host, sizeof(host), 0, sizeof(host));
+    if (OsalMutexInit(&host.lock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init lock fail", __func__);
+        return HDF_FAILURE;
+    }
+    host.method = &g_rtcBracketMethod;
+    host.data = tester;
+    tester->time.year = tester->config.year;
+    tester->time.month = tester->config.month;
+    tester->time.day = tester->config.day;
+    tester->time.hour = tester->config.hour;
+    tester->time.minute = tester->config.minute;
+    tester->time.second = tester->config.second;
+    tester->time.millisecond = 0;
+    tester->time.weekday = RtcGetWeekDay(&tester->time);
+
+    ret = RtcHostReadTimeSync(&host, &sync);
+    (void)OsalMutexDestroy(&host.lock);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: read time sync fail, ret :%d", __func__, ret);
+        return ret;
+    }
+    HDF_LOGI("%s: monoUs %llu, errorUs %u, sampled at %llu", __func__, (unsigned long long)sync.monoUs,
+        sync.errorUs, (unsigned long long)g_rtcBracketSampledUs);
+    // the error covers the whole access, and the sampling point lies within it of the midpoint
+    if (IsSameRtcTestTime(&sync.time, &tester->time) != HDF_SUCCESS ||
+        sync.errorUs < RTC_TEST_BRACKET_DELAY_US / 2 || // 2: the error is half of the bracket
+        sync.monoUs + sync.errorUs < g_rtcBracketSampledUs || sync.monoUs > g_rtcBracketSampledUs + sync.errorUs) {
+        HDF_LOGE("%s: bracket does not hold the sampling point", __func__);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+#endif
+}
+
+static int32_t RtcAlarmGroupCheck(struct RtcTester *tester, const struct RtcAlarmItem *items, uint32_t count)
+{
+    int32_t ret;
+    uint32_t i;
+    struct RtcTime readTime = {0};
+
+    for (i = 0; i < count; i++) {
+        ret = RtcReadAlarm(tester->handle, items[i].alarmIndex, &readTime);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: read alarm %d fail, ret :%d", __func__, items[i].alarmIndex, ret);
+            return ret;
+        }
+        if (IsSameRtcTestTime(&readTime, &items[i].time) != HDF_SUCCESS) {
+            HDF_LOGE("%s: different time of alarm %d", __func__, items[i].alarmIndex);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t RtcAlarmGroupTest(struct RtcTester *tester)
+{
+    int32_t ret;
+    struct RtcAlarmItem items[] = {
+        { .alarmIndex = RTC_ALARM_INDEX_A, .enable = 0 },
+        { .alarmIndex = RTC_ALARM_INDEX_B, .enable = 0 },
+    };
+    uint32_t count = sizeof(items) / sizeof(items[0]);
+
+    /* 2020-08-08 Saturday 10:08:08 and 11:08:08 */
+    tester->time.year = tester->config.year;
+    tester->time.month = tester->config.month;
+    tester->time.day = tester->config.day;
+    tester->time.hour = tester->config.hour + RTC_UNIT_DIFF;
+    tester->time.minute = tester->config.minute;
+    tester->time.second = tester->config.second;
+    tester->time.millisecond = 0;
+    tester->time.weekday = RtcGetWeekDay(&tester->time);
+    items[0].time = tester->time;
+    items[1].time = tester->time;
+    items[1].time.hour += RTC_UNIT_DIFF;
+
+    ret = RtcWriteAlarmGroup(tester->handle, items, count);
+    if (ret != HDF_SUCCESS || items[0].ret != HDF_SUCCESS || items[1].ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: write alarm group fail, ret :%d", __func__, ret);
+        return HDF_FAILURE;
+    }
+    ret = RtcAlarmGroupCheck(tester, items, count);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    // a duplicated alarm rejects the whole group before any alarm is written
+    items[1].alarmIndex = RTC_ALARM_INDEX_A;
+    items[0].time.minute = tester->config.minute + RTC_UNIT_DIFF;
+    ret = RtcWriteAlarmGroup(tester->handle, items, count);
+    if (ret == HDF_SUCCESS || items[0].ret != HDF_FAILURE) {
+        HDF_LOGE("%s: duplicated alarm not rejected", __func__);
+        return HDF_FAILURE;
+    }
+    items[0].time = tester->time;
+    return RtcAlarmGroupCheck(tester, items, 1);
+}
+
 struct RtcTestEntry {
     int cmd;
     int32_t (*func)(struct RtcTester *tester);
@@ -637,6 +829,9 @@ static struct RtcTestEntry g_entry[] = {
     { RTC_TEST_CMD_RTC_WR_USER_REG_MAX_INDEX, RtcReadWriteMaxUserIndexTest, "RtcReadWriteMaxUserIndexTest"},
     { RTC_TEST_CMD_RTC_FUNCTION_TEST, RtcTestSample, "RtcTestSample"},
     { RTC_TEST_CMD_RTC_WR_RELIABILITY, RtcReadWriteReliability, "RtcReadWriteReliability"},
+    { RTC_TEST_CMD_RTC_TIME_SYNC, RtcTimeSyncTest, "RtcTimeSyncTest"},
+    { RTC_TEST_CMD_RTC_ALARM_GROUP, RtcAlarmGroupTest, "RtcAlarmGroupTest"},
+    { RTC_TEST_CMD_RTC_TIME_SYNC_BRACKET, RtcTimeSyncBracketTest, "RtcTimeSyncBracketTest"},
 };
 
 int32_t RtcTestExecute(int cmd)
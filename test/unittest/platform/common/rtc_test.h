@@ -59,6 +59,9 @@ enum RtcTestCmd {
     RTC_TEST_CMD_RTC_WR_USER_REG_MAX_INDEX,
     RTC_TEST_CMD_RTC_WR_RELIABILITY,
     RTC_TEST_CMD_RTC_FUNCTION_TEST,
+    RTC_TEST_CMD_RTC_TIME_SYNC,
+    RTC_TEST_CMD_RTC_ALARM_GROUP,
+    RTC_TEST_CMD_RTC_TIME_SYNC_BRACKET,
     RTC_TEST_CMD_MAX,
 };
 
@@ -15,7 +15,9 @@
 #include "osal_mem.h"
 #include "osal_time.h"
 #include "spi_if.h"
-
+#ifndef __USER__
+#include "osal_sem.h"
+#endif
 
 #define HDF_LOG_TAG spi_test_c
 
@@ -500,6 +502,105 @@ static int32_t SpiIfPerformanceTest(struct SpiTester *tester)
     return HDF_FAILURE;
 }
 
+#define SPI_TEST_SEG_NUM         2
+#define SPI_TEST_ASYNC_TIMEOUT   1000
+
+#ifndef __USER__
+struct SpiTestAsyncDone {
+    struct OsalSem sem;
+    int32_t result;
+};
+
+static void SpiTestAsyncCallback(struct SpiSgMsg *msgs, uint32_t count, int32_t result, void *priv)
+{
+    struct SpiTestAsyncDone *done = (struct SpiTestAsyncDone *)priv;
+
+    (void)msgs;
+    (void)count;
+    done->result = result;
+    (void)OsalSemPost(&done->sem);
+}
+
+static int32_t SpiAsyncTransferTest(struct SpiTester *tester, struct SpiSgMsg *msg)
+{
+    int32_t ret;
+    struct SpiTestAsyncDone done;
+
+    if (OsalSemInit(&done.sem, 0) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    done.result = HDF_FAILURE;
+    ret = SpiTransferAsync(tester->handle, msg, 1, SpiTestAsyncCallback, &done);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: submit fail:%d", __func__, ret);
+        (void)OsalSemDestroy(&done.sem);
+        return ret;
+    }
+    if (OsalSemWait(&done.sem, SPI_TEST_ASYNC_TIMEOUT) != HDF_SUCCESS) {
+        HDF_LOGE("%s: wait transfer timeout!", __func__);
+        // the msg on stack may be still in queue, wait it out
+        (void)OsalSemWait(&done.sem, HDF_WAIT_FOREVER);
+        done.result = HDF_ERR_TIMEOUT;
+    }
+    (void)OsalSemDestroy(&done.sem);
+    return done.result;
+}
+#endif
+
+static int32_t SpiSgTransferTest(struct SpiTester *tester)
+{
+    int32_t ret;
+    uint32_t half = tester->config.len / SPI_TEST_SEG_NUM;
+    struct SpiSgSeg segs[SPI_TEST_SEG_NUM];
+    struct SpiSgMsg msg;
+
+    g_spiCfg.bitsPerWord = BITS_PER_WORD_8BITS;
+    g_spiCfg.transferMode = SPI_POLLING_TRANSFER;
+    ret = SpiSetCfg(tester->handle, &g_spiCfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: set config fail", __func__);
+        return ret;
+    }
+
+    /* one frame from two separate pieces, sent back to back with the cs kept active */
+    segs[0].wbuf = tester->config.wbuf;
+    segs[0].rbuf = tester->config.rbuf;
+    segs[0].len = half;
+    segs[1].wbuf = tester->config.wbuf + half;
+    segs[1].rbuf = tester->config.rbuf + half;
+    segs[1].len = tester->config.len - half;
+    msg.segs = segs;
+    msg.segNum = SPI_TEST_SEG_NUM;
+    msg.speed = 0;    // use default speed
+    msg.delayUs = 0;
+    msg.csChange = 1; // switch off the CS after transfer
+
+    ret = SpiTransferSg(tester->handle, &msg, 1);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: spi sg transfer err:%d", __func__, ret);
+        return ret;
+    }
+    ret = SpiCmpMemByBits(tester->config.wbuf, tester->config.rbuf, tester->config.len, g_spiCfg.bitsPerWord);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+#ifndef __USER__
+    (void)memset_s(tester->config.rbuf, tester->config.len, 0, tester->config.len);
+    ret = SpiAsyncTransferTest(tester, &msg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: spi async transfer err:%d", __func__, ret);
+        return ret;
+    }
+    ret = SpiCmpMemByBits(tester->config.wbuf, tester->config.rbuf, tester->config.len, g_spiCfg.bitsPerWord);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+#endif
+    HDF_LOGE("%s: success", __func__);
+    return HDF_SUCCESS;
+}
+
 struct SpiTestFunc {
     int cmd;
     int32_t (*func)(struct SpiTester *tester);
@@ -514,6 +615,7 @@ static struct SpiTestFunc g_spiTestEntry[] = {
     {SPI_RELIABILITY_TEST, SpiReliabilityTest, "SpiReliabilityTest"},
     {SPI_PERFORMANCE_TEST, SpiIfPerformanceTest, "SpiIfPerformanceTest"},
     {SPI_TEST_ALL, SpiTestAll, "SpiTestAll"},
+    {SPI_SG_TRANSFER_TEST, SpiSgTransferTest, "SpiSgTransferTest"},
 };
 
 int32_t SpiTestExecute(int cmd)
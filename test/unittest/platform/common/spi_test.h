@@ -25,6 +25,7 @@ enum SpiTestCmd {
     SPI_RELIABILITY_TEST,
     SPI_PERFORMANCE_TEST,
     SPI_TEST_ALL,
+    SPI_SG_TRANSFER_TEST,
     SPI_TEST_CMD_MAX,
 };
 
@@ -13,6 +13,7 @@
 #include "osal_thread.h"
 #include "osal_mem.h"
 #include "osal_time.h"
+#include "platform_core.h"
 #include "securec.h"
 #include "timer_if.h"
 
@@ -364,6 +365,74 @@ static int32_t TimerIfPerformanceTest(struct TimerTest *test)
     return HDF_SUCCESS;
 }
 
+static volatile uint32_t g_eventCount = 0;
+static uint64_t g_eventLastUs = 0;
+static uint64_t g_eventJitterMaxUs = 0;
+static uint64_t g_eventJitterSumUs = 0;
+static uint32_t g_eventPeriodUs = 0;
+
+static int32_t TimerTestEventCb(void)
+{
+    uint64_t now = PlatformMonoTimeUs();
+    uint64_t delta;
+    uint64_t jitter;
+
+    if (g_eventCount > 0) {
+        delta = now - g_eventLastUs;
+        jitter = (delta > g_eventPeriodUs) ? (delta - g_eventPeriodUs) : (g_eventPeriodUs - delta);
+        g_eventJitterSumUs += jitter;
+        g_eventJitterMaxUs = (jitter > g_eventJitterMaxUs) ? jitter : g_eventJitterMaxUs;
+    }
+    g_eventLastUs = now;
+    g_eventCount++;
+    return HDF_SUCCESS;
+}
+
+static int32_t TimerEventTest(struct TimerTest *test)
+{
+    uint32_t waitMs = 0;
+    uint32_t timeoutMs;
+    uint64_t jitterAvgUs;
+
+    if (test == NULL || test->handle == NULL) {
+        HDF_LOGE("%s: test null", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    g_eventCount = 0;
+    g_eventJitterMaxUs = 0;
+    g_eventJitterSumUs = 0;
+    g_eventPeriodUs = test->uSecond;
+    // twice the nominal run time leaves room for a loaded system
+    timeoutMs = (test->uSecond / 1000 + 1) * TIMER_TEST_JITTER_TIMES * 2;
+
+    if (HwTimerSet(test->handle, test->uSecond, TimerTestEventCb) != HDF_SUCCESS ||
+        HwTimerStart(test->handle) != HDF_SUCCESS) {
+        HDF_LOGE("%s: arm timer failed", __func__);
+        return HDF_FAILURE;
+    }
+    while (g_eventCount < TIMER_TEST_JITTER_TIMES && waitMs < timeoutMs) {
+        OsalMSleep(TIMER_TEST_JITTER_WAIT_MS);
+        waitMs += TIMER_TEST_JITTER_WAIT_MS;
+    }
+    (void)HwTimerStop(test->handle);
+
+    if (g_eventCount < TIMER_TEST_JITTER_TIMES) {
+        HDF_LOGE("%s: only %u expirations in %u ms", __func__, g_eventCount, timeoutMs);
+        return HDF_FAILURE;
+    }
+    jitterAvgUs = g_eventJitterSumUs / (g_eventCount - 1);
+    HDF_LOGI("%s: period %u us, jitter max %llu us, avg %llu us", __func__, test->uSecond,
+        (unsigned long long)g_eventJitterMaxUs, (unsigned long long)jitterAvgUs);
+    // single late wakeups are up to the scheduler, a drifting average means the events come at the wrong rate
+    if (jitterAvgUs > test->uSecond / TIMER_TEST_JITTER_AVG_DIV) {
+        HDF_LOGE("%s: average jitter %llu us over 1/%u of the period", __func__,
+            (unsigned long long)jitterAvgUs, TIMER_TEST_JITTER_AVG_DIV);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
 static struct TimerTestFunc g_timerTestFunc[] = {
     {TIMER_TEST_SET, TimerSetTest},
     {TIMER_TEST_SETONCE, TimerSetOnceTest},
@@ -373,6 +442,7 @@ static struct TimerTestFunc g_timerTestFunc[] = {
     {TIMER_MULTI_THREAD_TEST, TimerTestMultiThread},
     {TIMER_RELIABILITY_TEST, TimerTestReliability},
     {TIMER_IF_PERFORMANCE_TEST, TimerIfPerformanceTest},
+    {TIMER_TEST_EVENT, TimerEventTest},
 };
 
 int32_t TimerTestExecute(int cmd)
@@ -25,6 +25,7 @@ enum TimerTestCmd {
     TIMER_MULTI_THREAD_TEST,
     TIMER_RELIABILITY_TEST,
     TIMER_IF_PERFORMANCE_TEST,
+    TIMER_TEST_EVENT,
     TIMER_TEST_MAX_CMD,
 };
 
@@ -37,6 +38,10 @@ enum TimerTestCmd {
 #define TIMER_TEST_TIME_ID_THREAD2  5
 #define TIMER_TEST_TIME_USECONDS    5000
 
+#define TIMER_TEST_JITTER_TIMES     20
+#define TIMER_TEST_JITTER_WAIT_MS   10
+#define TIMER_TEST_JITTER_AVG_DIV   2
+
 struct TimerTestConfig {
     uint32_t number;
     uint32_t uSecond;
@@ -13,6 +13,10 @@
 #include "osal_mem.h"
 #include "osal_time.h"
 #include "securec.h"
+#ifndef __USER__
+#include "osal_thread.h"
+#include "uart_core.h"
+#endif
 #include "uart_if.h"
 
 #define HDF_LOG_TAG uart_test
@@ -281,6 +285,177 @@ static int32_t UartIfPerformanceTest(struct UartTester *tester)
     return HDF_SUCCESS;
 }
 
+#ifndef __USER__
+#define UART_TEST_RX_RING_SIZE  64
+#define UART_TEST_RX_PUSH_LEN   40
+#define UART_TEST_STACK_SIZE    (1024 * 64)
+#define UART_TEST_WAIT_MS       10
+#define UART_TEST_WAIT_TIMES    100
+
+struct UartRxTestReader {
+    struct UartHost *host;
+    struct OsalThread thread;
+    volatile bool done;
+    int32_t ret;
+};
+
+static int32_t UartRxTestReaderFunc(void *arg)
+{
+    uint8_t byte;
+    struct UartRxTestReader *reader = (struct UartRxTestReader *)arg;
+
+    reader->ret = UartHostRead(reader->host, &byte, 1);
+    reader->done = true;
+    return HDF_SUCCESS;
+}
+
+static int32_t UartRxTestReaderStart(struct UartRxTestReader *reader)
+{
+    int32_t ret;
+    struct OsalThreadParam cfg;
+
+    reader->done = false;
+    reader->ret = HDF_FAILURE;
+    ret = OsalThreadCreate(&reader->thread, (OsalThreadEntry)UartRxTestReaderFunc, reader);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: create thread fail:%d", __func__, ret);
+        return ret;
+    }
+    cfg.name = "UartRxTest";
+    cfg.priority = OSAL_THREAD_PRI_DEFAULT;
+    cfg.stackSize = UART_TEST_STACK_SIZE;
+    ret = OsalThreadStart(&reader->thread, &cfg);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start thread fail:%d", __func__, ret);
+        (void)OsalThreadDestroy(&reader->thread);
+    }
+    return ret;
+}
+
+static bool UartRxTestReaderWait(struct UartRxTestReader *reader)
+{
+    uint32_t i;
+
+    for (i = 0; i < UART_TEST_WAIT_TIMES && !reader->done; i++) {
+        OsalMSleep(UART_TEST_WAIT_MS);
+    }
+    return reader->done;
+}
+
+/* a blocked reader must be woken, with no data, by switching to nonblock */
+static int32_t UartRxRingWakeTest(struct UartHost *host)
+{
+    struct UartRxTestReader reader;
+
+    reader.host = host;
+    (void)UartHostSetTransMode(host, UART_MODE_RD_BLOCK);
+    if (UartRxTestReaderStart(&reader) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    OsalMSleep(UART_TEST_WAIT_MS);
+    (void)UartHostSetTransMode(host, UART_MODE_RD_NONBLOCK);
+    if (!UartRxTestReaderWait(&reader)) {
+        HDF_LOGE("%s: blocked reader not woken by nonblock", __func__);
+        // the reader can't be left on the ring, let data finish it
+        (void)UartHostRxPush(host, (const uint8_t *)"w", 1);
+        (void)UartRxTestReaderWait(&reader);
+        (void)OsalThreadDestroy(&reader.thread);
+        return HDF_FAILURE;
+    }
+    (void)OsalThreadDestroy(&reader.thread);
+    if (reader.ret != 0) {
+        HDF_LOGE("%s: woken reader got %d, but no data pushed", __func__, reader.ret);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+/* drives a ring set up by the test on a host which reads through its own driver */
+static int32_t UartRxRingTest(struct UartHost *host)
+{
+    uint32_t i;
+    int32_t ret;
+    uint8_t data[UART_TEST_RX_RING_SIZE + UART_TEST_RX_PUSH_LEN];
+    uint8_t rbuf[UART_TEST_RX_RING_SIZE];
+    struct UartRxStat stat;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+    (void)UartHostSetTransMode(host, UART_MODE_RD_NONBLOCK);
+    if (UartHostRead(host, rbuf, sizeof(rbuf)) != 0) {
+        HDF_LOGE("%s: read from an empty ring", __func__);
+        return HDF_FAILURE;
+    }
+    if (UartHostRxPush(host, data, UART_TEST_RX_PUSH_LEN) != UART_TEST_RX_PUSH_LEN ||
+        UartHostRxReadable(host) != UART_TEST_RX_PUSH_LEN) {
+        HDF_LOGE("%s: push fail", __func__);
+        return HDF_FAILURE;
+    }
+    ret = UartHostRead(host, rbuf, sizeof(rbuf));
+    if (ret != UART_TEST_RX_PUSH_LEN || memcmp(rbuf, data, UART_TEST_RX_PUSH_LEN) != 0) {
+        HDF_LOGE("%s: read %d bytes, expect %d", __func__, ret, UART_TEST_RX_PUSH_LEN);
+        return HDF_FAILURE;
+    }
+    // wraps around the end of the ring, and what doesn't fit is counted as overrun
+    if (UartHostRxPush(host, data, sizeof(data)) != UART_TEST_RX_RING_SIZE ||
+        UartHostRead(host, rbuf, sizeof(rbuf)) != UART_TEST_RX_RING_SIZE || memcmp(rbuf, data, sizeof(rbuf)) != 0) {
+        HDF_LOGE("%s: wrapped read mismatch", __func__);
+        return HDF_FAILURE;
+    }
+    if (UartRxRingWakeTest(host) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+
+    (void)UartHostGetRxStat(host, &stat);
+    HDF_LOGI("%s: ring:%u, pushes:%u, rxBytes:%u, overruns:%u, wakeups:%u", __func__,
+        stat.ringSize, stat.pushes, stat.rxBytes, stat.overruns, stat.wakeups);
+    if (stat.ringSize != UART_TEST_RX_RING_SIZE || stat.pushes != 2 ||  // 2: pushes done above
+        stat.rxBytes != UART_TEST_RX_PUSH_LEN + UART_TEST_RX_RING_SIZE ||
+        stat.overruns != UART_TEST_RX_PUSH_LEN || stat.wakeups != 0) {
+        HDF_LOGE("%s: unexpected rx stat", __func__);
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+#endif
+
+static int32_t UartRxStatTest(struct UartTester *tester)
+{
+    int32_t ret;
+    struct UartRxStat stat;
+
+    ret = UartGetRxStat(tester->handle, &stat);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: get rx stat failed", __func__);
+        return HDF_FAILURE;
+    }
+    HDF_LOGI("%s: ring:%u, pushes:%u, rxBytes:%u, overruns:%u, wakeups:%u, wakeupBytes:%u", __func__,
+        stat.ringSize, stat.pushes, stat.rxBytes, stat.overruns, stat.wakeups, stat.wakeupBytes);
+    if (stat.ringSize == 0) {
+#ifndef __USER__
+        // the driver reads by itself, check the ring on a temporary one
+        if (UartHostRxRingInit((struct UartHost *)tester->handle, UART_TEST_RX_RING_SIZE) != HDF_SUCCESS) {
+            return HDF_FAILURE;
+        }
+        ret = UartRxRingTest((struct UartHost *)tester->handle);
+        UartHostRxRingDeinit((struct UartHost *)tester->handle);
+        return ret;
+#else
+        HDF_LOGW("%s: skipped, port %u has no rx ring, the kernel test checks a temporary one", __func__,
+            tester->config.port);
+        return HDF_SUCCESS;
+#endif
+    }
+    if ((stat.ringSize & (stat.ringSize - 1)) != 0 || stat.wakeupBytes > stat.rxBytes || stat.pushes > stat.rxBytes ||
+        stat.wakeupBytes < stat.wakeups) {
+        HDF_LOGE("%s: invalid rx stat", __func__);
+        return HDF_FAILURE;
+    }
+    HDF_LOGD("%s: success", __func__);
+    return HDF_SUCCESS;
+}
+
 struct UartTestEntry {
     int cmd;
     int32_t (*func)(struct UartTester *tester);
@@ -297,6 +472,7 @@ static struct UartTestEntry g_entry[] = {
     { UART_TEST_CMD_SET_TRANSMODE, UartSetTransModeTest, "UartSetTransModeTest" },
     { UART_TEST_CMD_RELIABILITY, UartReliabilityTest, "UartReliabilityTest" },
     { UART_TEST_CMD_PERFORMANCE, UartIfPerformanceTest, "UartIfPerformanceTest" },
+    { UART_TEST_CMD_RX_STAT, UartRxStatTest, "UartRxStatTest" },
 };
 
 int32_t UartTestExecute(int cmd)
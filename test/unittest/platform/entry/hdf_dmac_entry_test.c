@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_dmac_entry_test.h"
+#include "dmac_test.h"
+#include "hdf_log.h"
+
+#define HDF_LOG_TAG hdf_dmac_entry_test
+
+int32_t HdfDmacTestEntry(HdfTestMsg *msg)
+{
+    if (msg == NULL) {
+        return HDF_FAILURE;
+    }
+
+    msg->result = DmacTestExecute(msg->subCmd);
+    return msg->result;
+}
@@ -8,6 +8,7 @@
 
 #include "hdf_platform_core_entry_test.h"
 #include "hdf_log.h"
+#include "platform_arbiter_test.h"
 #include "platform_event_test.h"
 #include "platform_queue_test.h"
 
@@ -41,3 +42,11 @@ int32_t HdfPlatformManagerTestEntry(HdfTestMsg *msg)
     return HDF_SUCCESS;
 }
 
+int32_t HdfPlatformArbiterTestEntry(HdfTestMsg *msg)
+{
+    if (msg != NULL) {
+        msg->result = PlatformArbiterTestExecute(msg->subCmd);
+    }
+    return HDF_SUCCESS;
+}
+
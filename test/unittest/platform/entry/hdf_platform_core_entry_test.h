@@ -19,4 +19,6 @@ int32_t HdfPlatformDeviceTestEntry(HdfTestMsg *msg);
 
 int32_t HdfPlatformManagerTestEntry(HdfTestMsg *msg);
 
+int32_t HdfPlatformArbiterTestEntry(HdfTestMsg *msg);
+
 #endif // HDF_PLATFORM_CORE_ENTRY_TEST_H
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "adc/adc_core.h"
+#include "device_resource_if.h"
+#include "hdf_device_desc.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "osal_thread.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG adc_virtual
+
+#define VIRTUAL_ADC_SCAN_TICK_MS   1
+#define VIRTUAL_ADC_THREAD_STACK   (1024 * 16)
+#define VIRTUAL_ADC_US_PER_SECOND  1000000
+#define VIRTUAL_ADC_SAW_STEP       7
+#define VIRTUAL_ADC_DATA_WIDTH_MAX 24
+
+/*
+ * Synthetic waveforms: channel n is a sawtooth advancing (n + 1) * VIRTUAL_ADC_SAW_STEP per sample,
+ * wrapped at the data width, so a reader can check the continuity of the frames it gets.
+ */
+struct VirtualAdcDevice {
+    struct AdcDevice device;
+    uint32_t deviceNum;
+    uint32_t validChannel;
+    uint32_t dataWidth;
+    uint32_t rate;
+    uint32_t sample[ADC_SCAN_CHANNEL_MAX];
+    struct AdcScanCfg scanCfg;
+    struct OsalThread thread;
+    struct OsalSem exitSem;
+    volatile bool scanning;
+};
+
+static inline uint32_t VirtualAdcNext(struct VirtualAdcDevice *virtual, uint32_t channel)
+{
+    uint32_t val = virtual->sample[channel];
+
+    virtual->sample[channel] = (val + (channel + 1) * VIRTUAL_ADC_SAW_STEP) & ((1U << virtual->dataWidth) - 1);
+    return val;
+}
+
+static int32_t VirtualAdcRead(struct AdcDevice *device, uint32_t channel, uint32_t *val)
+{
+    struct VirtualAdcDevice *virtual = (struct VirtualAdcDevice *)device;
+
+    if (channel >= virtual->validChannel || channel >= ADC_SCAN_CHANNEL_MAX || val == NULL) {
+        HDF_LOGE("%s: invalid channel:%u", __func__, channel);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *val = VirtualAdcNext(virtual, channel);
+    return HDF_SUCCESS;
+}
+
+static inline int32_t VirtualAdcStart(struct AdcDevice *device)
+{
+    (void)device;
+    HDF_LOGI("%s: done!", __func__);
+    return HDF_SUCCESS;
+}
+
+static inline int32_t VirtualAdcStop(struct AdcDevice *device)
+{
+    (void)device;
+    HDF_LOGI("%s: done!", __func__);
+    return HDF_SUCCESS;
+}
+
+static void VirtualAdcFill(struct VirtualAdcDevice *virtual, uint32_t *vals, uint32_t frames)
+{
+    uint32_t i;
+    uint32_t ch;
+
+    for (i = 0; i < frames; i++) {
+        for (ch = 0; ch < ADC_SCAN_CHANNEL_MAX; ch++) {
+            if ((virtual->scanCfg.chanMask & (1U << ch)) != 0) {
+                *vals++ = VirtualAdcNext(virtual, ch);
+            }
+        }
+    }
+}
+
+/* plays the dma: every tick the frames due by the rate are written in place and committed in one go */
+static int32_t VirtualAdcScanThread(void *data)
+{
+    uint32_t due;
+    uint32_t len;
+    uint64_t start;
+    uint64_t target;
+    uint64_t produced = 0;
+    uint32_t *vals = NULL;
+    struct VirtualAdcDevice *virtual = (struct VirtualAdcDevice *)data;
+
+    start = AdcScanTimeUs();
+    while (virtual->scanning) {
+        OsalMSleep(VIRTUAL_ADC_SCAN_TICK_MS);
+        target = (AdcScanTimeUs() - start) * virtual->scanCfg.rateHz / VIRTUAL_ADC_US_PER_SECOND;
+        due = (uint32_t)(target - produced);
+        produced = target;
+        while (due > 0) {
+            len = AdcDeviceScanPrepare(&virtual->device, &vals);
+            if (len == 0) {
+                break;  // ring full, the rest of this tick is lost like a real overrun
+            }
+            len = (len < due) ? len : due;
+            VirtualAdcFill(virtual, vals, len);
+            AdcDeviceScanCommit(&virtual->device, len, AdcScanTimeUs());
+            due -= len;
+        }
+    }
+    (void)OsalSemPost(&virtual->exitSem);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualAdcScanStart(struct AdcDevice *device, const struct AdcScanCfg *cfg)
+{
+    int32_t ret;
+    struct OsalThreadParam param;
+    struct VirtualAdcDevice *virtual = (struct VirtualAdcDevice *)device;
+
+    virtual->scanCfg = *cfg;
+    virtual->scanning = true;
+    (void)OsalSemInit(&virtual->exitSem, 0);
+    ret = OsalThreadCreate(&virtual->thread, VirtualAdcScanThread, virtual);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalSemDestroy(&virtual->exitSem);
+        return ret;
+    }
+    param.name = "virtual_adc_scan";
+    param.priority = OSAL_THREAD_PRI_DEFAULT;
+    param.stackSize = VIRTUAL_ADC_THREAD_STACK;
+    ret = OsalThreadStart(&virtual->thread, &param);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalThreadDestroy(&virtual->thread);
+        (void)OsalSemDestroy(&virtual->exitSem);
+    }
+    return ret;
+}
+
+static int32_t VirtualAdcScanStop(struct AdcDevice *device)
+{
+    struct VirtualAdcDevice *virtual = (struct VirtualAdcDevice *)device;
+
+    virtual->scanning = false;
+    (void)OsalSemWait(&virtual->exitSem, HDF_WAIT_FOREVER);
+    (void)OsalThreadDestroy(&virtual->thread);
+    (void)OsalSemDestroy(&virtual->exitSem);
+    HDF_LOGI("%s: done!", __func__);
+    return HDF_SUCCESS;
+}
+
+static const struct AdcMethod g_method = {
+    .read = VirtualAdcRead,
+    .stop = VirtualAdcStop,
+    .start = VirtualAdcStart,
+    .scanStart = VirtualAdcScanStart,
+    .scanStop = VirtualAdcScanStop,
+};
+
+static int32_t VirtualAdcReadDrs(struct VirtualAdcDevice *virtual, const struct DeviceResourceNode *node)
+{
+    struct DeviceResourceIface *drsOps = NULL;
+
+    drsOps = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (drsOps == NULL || drsOps->GetUint32 == NULL) {
+        HDF_LOGE("%s: Invalid drs ops fail!", __func__);
+        return HDF_FAILURE;
+    }
+    if (drsOps->GetUint32(node, "deviceNum", &virtual->deviceNum, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read deviceNum fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (drsOps->GetUint32(node, "validChannel", &virtual->validChannel, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read validChannel fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (drsOps->GetUint32(node, "dataWidth", &virtual->dataWidth, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read dataWidth fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (drsOps->GetUint32(node, "rate", &virtual->rate, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read rate fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    if (virtual->dataWidth == 0 || virtual->dataWidth > VIRTUAL_ADC_DATA_WIDTH_MAX) {
+        HDF_LOGE("%s: invalid dataWidth:%u", __func__, virtual->dataWidth);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualAdcParseAndInit(struct HdfDeviceObject *device, const struct DeviceResourceNode *node)
+{
+    int32_t ret;
+    struct VirtualAdcDevice *virtual = NULL;
+    (void)device;
+
+    virtual = (struct VirtualAdcDevice *)OsalMemCalloc(sizeof(*virtual));
+    if (virtual == NULL) {
+        HDF_LOGE("%s: Malloc virtual fail!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = VirtualAdcReadDrs(virtual, node);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: Read drs fail! ret:%d", __func__, ret);
+        OsalMemFree(virtual);
+        return ret;
+    }
+
+    virtual->device.priv = (void *)node;
+    virtual->device.devNum = virtual->deviceNum;
+    virtual->device.chanNum = virtual->validChannel;
+    virtual->device.ops = &g_method;
+    ret = AdcDeviceAdd(&virtual->device);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: add adc device failed! ret = %d", __func__, ret);
+        OsalMemFree(virtual);
+        return ret;
+    }
+    HDF_LOGI("%s: device:%u init done!", __func__, virtual->deviceNum);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualAdcInit(struct HdfDeviceObject *device)
+{
+    int32_t ret;
+    const struct DeviceResourceNode *childNode = NULL;
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    ret = HDF_SUCCESS;
+    DEV_RES_NODE_FOR_EACH_CHILD_NODE(device->property, childNode) {
+        ret = VirtualAdcParseAndInit(device, childNode);
+        if (ret != HDF_SUCCESS) {
+            break;
+        }
+    }
+    return ret;
+}
+
+static void VirtualAdcRemoveByNode(const struct DeviceResourceNode *node)
+{
+    uint32_t devNum;
+    struct AdcDevice *device = NULL;
+    struct DeviceResourceIface *drsOps = NULL;
+
+    drsOps = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (drsOps == NULL || drsOps->GetUint32 == NULL) {
+        HDF_LOGE("%s: invalid drs ops fail!", __func__);
+        return;
+    }
+
+    if (drsOps->GetUint32(node, "deviceNum", &devNum, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: read deviceNum fail!", __func__);
+        return;
+    }
+
+    device = AdcDeviceGet(devNum);
+    if (device != NULL && device->priv == node) {
+        AdcDevicePut(device);
+        AdcDeviceRemove(device);
+        OsalMemFree((struct VirtualAdcDevice *)device);
+    }
+}
+
+static void VirtualAdcRelease(struct HdfDeviceObject *device)
+{
+    const struct DeviceResourceNode *childNode = NULL;
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property is NULL", __func__);
+        return;
+    }
+
+    DEV_RES_NODE_FOR_EACH_CHILD_NODE(device->property, childNode) {
+        VirtualAdcRemoveByNode(childNode);
+    }
+}
+
+struct HdfDriverEntry g_virtualAdcDriverEntry = {
+    .moduleVersion = 1,
+    .Init = VirtualAdcInit,
+    .Release = VirtualAdcRelease,
+    .moduleName = "virtual_adc_driver",
+};
+HDF_INIT(g_virtualAdcDriverEntry);
@@ -6,6 +6,7 @@
  * See the LICENSE file in the root of this repository for complete details.
  */
 
+#include "dac_virtual.h"
 #include "dac/dac_core.h"
 #include "asm/platform.h"
 #include "device_resource_if.h"
@@ -14,24 +15,131 @@
 #include "los_hwi.h"
 #include "osal_io.h"
 #include "osal_mem.h"
+#include "osal_thread.h"
 #include "osal_time.h"
 
 #define HDF_LOG_TAG dac_virtual
 
+#define VIRTUAL_DAC_STREAM_TICK_MS   1
+#define VIRTUAL_DAC_THREAD_STACK     (1024 * 16)
+#define VIRTUAL_DAC_US_PER_SECOND    1000000
+
+/* records what it is fed: the last value written, and for a stream the last samples and the tick gaps */
 struct VirtualDacDevice {
     struct DacDevice device;
     uint32_t deviceNum;
     uint32_t validChannel;
     uint32_t rate;
+    uint32_t lastVal;
+    struct VirtualDacStreamRecord record;
+    struct DacStreamCfg streamCfg;
+    struct OsalThread thread;
+    struct OsalSem exitSem;
+    volatile bool streaming;
 };
 
 static int32_t VirtualDacWrite(struct DacDevice *device, uint32_t channel, uint32_t val)
 {
-    (void)device;
+    struct VirtualDacDevice *virtual = (struct VirtualDacDevice *)device;
+
     (void)channel;
-    (void)val;
-    HDF_LOGI("%s: done!", __func__);
+    virtual->lastVal = val;
+    return HDF_SUCCESS;
+}
+
+static void VirtualDacRecord(struct VirtualDacDevice *virtual, const uint32_t *vals, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        virtual->record.capture[(virtual->record.received + i) % VIRTUAL_DAC_CAPTURE_MAX] = vals[i];
+    }
+    virtual->record.received += len;
+    virtual->lastVal = vals[len - 1];
+}
+
+/* plays the dma: every tick the samples due by the rate are taken in place and given back in one go */
+static int32_t VirtualDacStreamThread(void *data)
+{
+    uint32_t due;
+    uint32_t len;
+    uint64_t now;
+    uint64_t last;
+    uint64_t start;
+    uint64_t target;
+    uint64_t consumed = 0;
+    const uint32_t *vals = NULL;
+    struct VirtualDacDevice *virtual = (struct VirtualDacDevice *)data;
 
+    start = PlatformMonoTimeUs();
+    last = start;
+    while (virtual->streaming) {
+        OsalMSleep(VIRTUAL_DAC_STREAM_TICK_MS);
+        now = PlatformMonoTimeUs();
+        if (now - last > virtual->record.maxGapUs) {
+            virtual->record.maxGapUs = now - last;
+        }
+        last = now;
+        target = (now - start) * virtual->streamCfg.rateHz / VIRTUAL_DAC_US_PER_SECOND;
+        due = (uint32_t)(target - consumed);
+        consumed = target;
+        while (due > 0) {
+            len = DacDeviceStreamPrepare(&virtual->device, &vals);
+            if (len == 0) {
+                DacDeviceStreamCommit(&virtual->device, 0, due);  // ring empty, the rest of this tick is missed
+                break;
+            }
+            len = (len < due) ? len : due;
+            VirtualDacRecord(virtual, vals, len);
+            DacDeviceStreamCommit(&virtual->device, len, 0);
+            due -= len;
+        }
+    }
+    (void)OsalSemPost(&virtual->exitSem);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualDacStreamStart(struct DacDevice *device, const struct DacStreamCfg *cfg)
+{
+    int32_t ret;
+    struct OsalThreadParam param;
+    struct VirtualDacDevice *virtual = (struct VirtualDacDevice *)device;
+
+    virtual->streamCfg = *cfg;
+    virtual->record.received = 0;
+    virtual->record.maxGapUs = 0;
+    ret = OsalSemInit(&virtual->exitSem, 0);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    virtual->streaming = true;
+    ret = OsalThreadCreate(&virtual->thread, VirtualDacStreamThread, virtual);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalSemDestroy(&virtual->exitSem);
+        return ret;
+    }
+    param.name = "virtual_dac_stream";
+    param.priority = OSAL_THREAD_PRI_DEFAULT;
+    param.stackSize = VIRTUAL_DAC_THREAD_STACK;
+    ret = OsalThreadStart(&virtual->thread, &param);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalThreadDestroy(&virtual->thread);
+        (void)OsalSemDestroy(&virtual->exitSem);
+    }
+    return ret;
+}
+
+static int32_t VirtualDacStreamStop(struct DacDevice *device)
+{
+    struct VirtualDacDevice *virtual = (struct VirtualDacDevice *)device;
+
+    virtual->streaming = false;
+    (void)OsalSemWait(&virtual->exitSem, HDF_WAIT_FOREVER);
+    (void)OsalThreadDestroy(&virtual->thread);
+    (void)OsalSemDestroy(&virtual->exitSem);
+    HDF_LOGI("%s: received %llu samples, last:%u, max tick gap:%llu us", __func__,
+        (unsigned long long)virtual->record.received, virtual->lastVal,
+        (unsigned long long)virtual->record.maxGapUs);
     return HDF_SUCCESS;
 }
 
@@ -58,8 +166,21 @@ static const struct DacMethod g_method = {
     .write = VirtualDacWrite,
     .stop = VirtualDacStop,
     .start = VirtualDacStart,
+    .streamStart = VirtualDacStreamStart,
+    .streamStop = VirtualDacStreamStop,
 };
 
+int32_t VirtualDacGetStreamRecord(uint32_t devNum, struct VirtualDacStreamRecord *record)
+{
+    struct DacDevice *device = DacDeviceGet(devNum);
+
+    if (device == NULL || device->ops != &g_method || record == NULL) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    *record = ((struct VirtualDacDevice *)device)->record;
+    return HDF_SUCCESS;
+}
+
 static int32_t VirtualDacReadDrs(struct VirtualDacDevice *virtual, const struct DeviceResourceNode *node)
 {
     struct DeviceResourceIface *drsOps = NULL;
@@ -105,6 +226,7 @@ static int32_t VirtualDacParseAndInit(struct HdfDeviceObject *device, const stru
     VirtualDacDeviceInit(virtual);
     virtual->device.priv = (void *)node;
     virtual->device.devNum = virtual->deviceNum;
+    virtual->device.chanNum = virtual->validChannel;
     virtual->device.ops = &g_method;
     ret = DacDeviceAdd(&virtual->device);
     if (ret != HDF_SUCCESS) {
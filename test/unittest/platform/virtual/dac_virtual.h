@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef DAC_VIRTUAL_H
+#define DAC_VIRTUAL_H
+#include "hdf_base.h"
+
+#define VIRTUAL_DAC_CAPTURE_MAX 1024
+
+/* what a virtual dac received by its last stream, sample n is at capture[n % VIRTUAL_DAC_CAPTURE_MAX] */
+struct VirtualDacStreamRecord {
+    uint64_t received;
+    uint64_t maxGapUs;  /* longest gap between two ticks of the dma */
+    uint32_t capture[VIRTUAL_DAC_CAPTURE_MAX];
+};
+
+/* only stable while the device isn't streaming */
+int32_t VirtualDacGetStreamRecord(uint32_t devNum, struct VirtualDacStreamRecord *record);
+
+#endif /* DAC_VIRTUAL_H */
@@ -251,7 +251,11 @@ static int32_t I3cIbiHandle(uint32_t irq, void *data)
             HDF_LOGE("func:%s device is NULL!", __func__);
             return HDF_ERR_MALLOC_FAIL;
         }
-        if (device->ibi->payload > VIRTUAL_I3C_TEST_STR_LEN) {
+        if (device->ibi == NULL) {
+            HDF_LOGE("func:%s no ibi requested!", __func__);
+            return HDF_ERR_NOT_SUPPORT;
+        }
+        if (device->ibi->data != NULL && device->ibi->payload > VIRTUAL_I3C_TEST_STR_LEN) {
             /* Put the string "Hello I3C!" into IBI buffer */
             *device->ibi->data = *testStr;
         }
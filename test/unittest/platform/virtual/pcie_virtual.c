@@ -10,6 +10,7 @@
 #include "hdf_log.h"
 #include "osal_mem.h"
 #include "pcie_core.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG pcie_virtual_c
 
@@ -19,9 +20,12 @@
 #define PCIE_VIRTUAL_ADAPTER_READ_DATA_1 0x95
 #define PCIE_VIRTUAL_ADAPTER_READ_DATA_2 0x27
 #define PCIE_VIRTUAL_ADAPTER_READ_DATA_3 0x89
+#define PCIE_VIRTUAL_ADAPTER_MEM_SIZE 0x1000
 
+/* the emulated endpoint has one memory region, exposed as BAR0 and as the dma target */
 struct PcieVirtualAdapterHost {
     struct PcieCntlr cntlr;
+    uint8_t *mem;
 };
 
 static int32_t PcieVirtualAdapterRead(struct PcieCntlr *cntlr, uint32_t pos, uint8_t *data, uint32_t len)
@@ -55,9 +59,51 @@ static int32_t PcieVirtualAdapterWrite(struct PcieCntlr *cntlr, uint32_t pos, ui
     return HDF_SUCCESS;
 }
 
+static int32_t PcieVirtualAdapterMapBar(struct PcieCntlr *cntlr, uint32_t bar, volatile uint8_t **addr,
+    uint32_t *size)
+{
+    struct PcieVirtualAdapterHost *host = (struct PcieVirtualAdapterHost *)cntlr;
+
+    if (bar != 0) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    *addr = host->mem;
+    *size = PCIE_VIRTUAL_ADAPTER_MEM_SIZE;
+    return HDF_SUCCESS;
+}
+
+static void PcieVirtualAdapterUnmapBar(struct PcieCntlr *cntlr, uint32_t bar, volatile uint8_t *addr)
+{
+    (void)cntlr;
+    (void)bar;
+    (void)addr;
+}
+
+/* the copy is done right away, so the completion comes before dmaTransfer returns */
+static int32_t PcieVirtualAdapterDmaTransfer(struct PcieCntlr *cntlr, const struct PcieDmaXfer *xfer)
+{
+    struct PcieVirtualAdapterHost *host = (struct PcieVirtualAdapterHost *)cntlr;
+    int32_t ret;
+
+    if (xfer->devAddr >= PCIE_VIRTUAL_ADAPTER_MEM_SIZE ||
+        xfer->len > PCIE_VIRTUAL_ADAPTER_MEM_SIZE - xfer->devAddr) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (xfer->dir == PCIE_DMA_TO_DEVICE) {
+        ret = memcpy_s(host->mem + xfer->devAddr, PCIE_VIRTUAL_ADAPTER_MEM_SIZE - xfer->devAddr, xfer->buf, xfer->len);
+    } else {
+        ret = memcpy_s(xfer->buf, xfer->len, host->mem + xfer->devAddr, xfer->len);
+    }
+    PcieCntlrDmaDone(cntlr, (ret == EOK) ? HDF_SUCCESS : HDF_ERR_IO);
+    return HDF_SUCCESS;
+}
+
 static struct PcieCntlrOps g_pcieVirtualAdapterHostOps = {
     .read = PcieVirtualAdapterRead,
     .write = PcieVirtualAdapterWrite,
+    .mapBar = PcieVirtualAdapterMapBar,
+    .unmapBar = PcieVirtualAdapterUnmapBar,
+    .dmaTransfer = PcieVirtualAdapterDmaTransfer,
 };
 
 static int32_t PcieVirtualAdapterBind(struct HdfDeviceObject *obj)
@@ -75,6 +121,12 @@ static int32_t PcieVirtualAdapterBind(struct HdfDeviceObject *obj)
         HDF_LOGE("PcieVirtualAdapterBind: no mem for PcieAdapterHost.");
         return HDF_ERR_MALLOC_FAIL;
     }
+    host->mem = (uint8_t *)OsalMemCalloc(PCIE_VIRTUAL_ADAPTER_MEM_SIZE);
+    if (host->mem == NULL) {
+        HDF_LOGE("PcieVirtualAdapterBind: no mem for device memory.");
+        OsalMemFree(host);
+        return HDF_ERR_MALLOC_FAIL;
+    }
     host->cntlr.ops = &g_pcieVirtualAdapterHostOps;
     host->cntlr.hdfDevObj = obj;
     obj->service = &(host->cntlr.service);
@@ -93,6 +145,7 @@ static int32_t PcieVirtualAdapterBind(struct HdfDeviceObject *obj)
     return HDF_SUCCESS;
 ERR:
     PcieCntlrRemove(&(host->cntlr));
+    OsalMemFree(host->mem);
     OsalMemFree(host);
     HDF_LOGD("PcieAdapterBind: fail, err = %d.", ret);
     return ret;
@@ -121,6 +174,7 @@ static void PcieVirtualAdapterRelease(struct HdfDeviceObject *obj)
     }
     PcieCntlrRemove(cntlr);
     host = (struct PcieVirtualAdapterHost *)cntlr;
+    OsalMemFree(host->mem);
     OsalMemFree(host);
     HDF_LOGD("PcieAdapterRelease: success.");
 }
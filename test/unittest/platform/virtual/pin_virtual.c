@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "pin/pin_core.h"
+#include "device_resource_if.h"
+#include "hdf_device_desc.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG pin_virtual
+
+#define VIRTUAL_PIN_NAME_LEN       16
+#define VIRTUAL_PIN_COUNT_DEFAULT  4096
+#define VIRTUAL_PIN_STRENGTH_MAX   15
+
+/* a synthetic controller of thousands of pins named "vpin<n>", keeping the settings in memory */
+struct VirtualPinState {
+    char name[VIRTUAL_PIN_NAME_LEN];
+    enum PinPullType pullType;
+    uint32_t strength;
+    const char *funcName;
+};
+
+struct VirtualPinCntlr {
+    struct PinCntlr cntlr;
+    struct VirtualPinState *states;
+};
+
+static int32_t VirtualPinSetPull(struct PinCntlr *cntlr, uint32_t index, enum PinPullType pullType)
+{
+    struct VirtualPinCntlr *virtual = (struct VirtualPinCntlr *)cntlr;
+
+    if (pullType > PIN_PULL_DOWN) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    virtual->states[index].pullType = pullType;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualPinGetPull(struct PinCntlr *cntlr, uint32_t index, enum PinPullType *pullType)
+{
+    struct VirtualPinCntlr *virtual = (struct VirtualPinCntlr *)cntlr;
+
+    *pullType = virtual->states[index].pullType;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualPinSetStrength(struct PinCntlr *cntlr, uint32_t index, uint32_t strength)
+{
+    struct VirtualPinCntlr *virtual = (struct VirtualPinCntlr *)cntlr;
+
+    if (strength > VIRTUAL_PIN_STRENGTH_MAX) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    virtual->states[index].strength = strength;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualPinGetStrength(struct PinCntlr *cntlr, uint32_t index, uint32_t *strength)
+{
+    struct VirtualPinCntlr *virtual = (struct VirtualPinCntlr *)cntlr;
+
+    *strength = virtual->states[index].strength;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualPinSetFunc(struct PinCntlr *cntlr, uint32_t index, const char *funcName)
+{
+    struct VirtualPinCntlr *virtual = (struct VirtualPinCntlr *)cntlr;
+
+    virtual->states[index].funcName = funcName;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualPinGetFunc(struct PinCntlr *cntlr, uint32_t index, const char **funcName)
+{
+    struct VirtualPinCntlr *virtual = (struct VirtualPinCntlr *)cntlr;
+
+    *funcName = virtual->states[index].funcName;
+    return HDF_SUCCESS;
+}
+
+static struct PinCntlrMethod g_method = {
+    .SetPinPull = VirtualPinSetPull,
+    .GetPinPull = VirtualPinGetPull,
+    .SetPinStrength = VirtualPinSetStrength,
+    .GetPinStrength = VirtualPinGetStrength,
+    .SetPinFunc = VirtualPinSetFunc,
+    .GetPinFunc = VirtualPinGetFunc,
+};
+
+static int32_t VirtualPinReadDrs(struct VirtualPinCntlr *virtual, const struct DeviceResourceNode *node)
+{
+    struct DeviceResourceIface *drsOps = NULL;
+
+    drsOps = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (drsOps == NULL || drsOps->GetUint16 == NULL) {
+        HDF_LOGE("%s: invalid drs ops fail!", __func__);
+        return HDF_FAILURE;
+    }
+    if (drsOps->GetUint16(node, "number", &virtual->cntlr.number, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: read number fail!", __func__);
+        return HDF_ERR_IO;
+    }
+    (void)drsOps->GetUint16(node, "pinCount", &virtual->cntlr.pinCount, VIRTUAL_PIN_COUNT_DEFAULT);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualPinInitPins(struct VirtualPinCntlr *virtual)
+{
+    uint16_t i;
+
+    virtual->cntlr.pins = (struct PinDesc *)OsalMemCalloc(sizeof(struct PinDesc) * virtual->cntlr.pinCount);
+    virtual->states = (struct VirtualPinState *)OsalMemCalloc(sizeof(struct VirtualPinState) *
+        virtual->cntlr.pinCount);
+    if (virtual->cntlr.pins == NULL || virtual->states == NULL) {
+        HDF_LOGE("%s: alloc %u pins fail!", __func__, virtual->cntlr.pinCount);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    for (i = 0; i < virtual->cntlr.pinCount; i++) {
+        if (snprintf_s(virtual->states[i].name, VIRTUAL_PIN_NAME_LEN, VIRTUAL_PIN_NAME_LEN - 1, "vpin%u", i) < 0) {
+            return HDF_FAILURE;
+        }
+        virtual->states[i].funcName = "gpio";
+        virtual->cntlr.pins[i].pinName = virtual->states[i].name;
+        virtual->cntlr.pins[i].priv = &virtual->states[i];
+    }
+    return HDF_SUCCESS;
+}
+
+static void VirtualPinFree(struct VirtualPinCntlr *virtual)
+{
+    OsalMemFree(virtual->cntlr.pins);
+    OsalMemFree(virtual->states);
+    OsalMemFree(virtual);
+}
+
+static int32_t VirtualPinInit(struct HdfDeviceObject *device)
+{
+    int32_t ret;
+    struct VirtualPinCntlr *virtual = NULL;
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    virtual = (struct VirtualPinCntlr *)OsalMemCalloc(sizeof(*virtual));
+    if (virtual == NULL) {
+        HDF_LOGE("%s: malloc virtual fail!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = VirtualPinReadDrs(virtual, device->property);
+    if (ret == HDF_SUCCESS) {
+        ret = VirtualPinInitPins(virtual);
+    }
+    if (ret != HDF_SUCCESS) {
+        VirtualPinFree(virtual);
+        return ret;
+    }
+
+    virtual->cntlr.method = &g_method;
+    virtual->cntlr.device = device;
+    ret = PinCntlrAdd(&virtual->cntlr);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: add pin cntlr failed! ret = %d", __func__, ret);
+        VirtualPinFree(virtual);
+        return ret;
+    }
+    device->priv = virtual;
+    HDF_LOGI("%s: cntlr:%u with %u pins init done!", __func__, virtual->cntlr.number, virtual->cntlr.pinCount);
+    return HDF_SUCCESS;
+}
+
+static void VirtualPinRelease(struct HdfDeviceObject *device)
+{
+    struct VirtualPinCntlr *virtual = NULL;
+
+    if (device == NULL || device->priv == NULL) {
+        HDF_LOGE("%s: device or priv is NULL", __func__);
+        return;
+    }
+
+    virtual = (struct VirtualPinCntlr *)device->priv;
+    PinCntlrRemove(&virtual->cntlr);
+    VirtualPinFree(virtual);
+    device->priv = NULL;
+}
+
+struct HdfDriverEntry g_virtualPinDriverEntry = {
+    .moduleVersion = 1,
+    .Init = VirtualPinInit,
+    .Release = VirtualPinRelease,
+    .moduleName = "virtual_pin_driver",
+};
+HDF_INIT(g_virtualPinDriverEntry);
@@ -0,0 +1,493 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "rtc/rtc_core.h"
+#include "device_resource_if.h"
+#include "hdf_device_desc.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_thread.h"
+#include "osal_time.h"
+#include "rtc_base.h"
+
+#define HDF_LOG_TAG rtc_virtual
+
+#define VIRTUAL_RTC_ALARM_NUM      2
+#define VIRTUAL_RTC_USER_REG_NUM   8
+#define VIRTUAL_RTC_FREQ_DEFAULT   32768
+#define VIRTUAL_RTC_FREQ_MIN       32700
+#define VIRTUAL_RTC_FREQ_MAX       32800
+#define VIRTUAL_RTC_TICK_MS        10
+#define VIRTUAL_RTC_THREAD_STACK   (1024 * 16)
+#define VIRTUAL_RTC_MS_PER_SECOND  1000
+#define VIRTUAL_RTC_US_PER_MS      1000
+#define VIRTUAL_RTC_DAY_SECONDS    86400U
+#define VIRTUAL_RTC_HOUR_SECONDS   3600U
+#define VIRTUAL_RTC_MINUTE_SECONDS 60U
+#define VIRTUAL_RTC_YEAR_MAX       2105 /* the seconds counter is 32 bits wide, as on most rtc parts */
+#define VIRTUAL_RTC_DIV_BITS       16
+#define VIRTUAL_RTC_DIV_MASK       0xFFFFU
+
+/*
+ * A counter running on the monotonic clock: the wall time was baseMs at baseUs and advances with it.
+ * Every register access costs accessDelayUs, to stand for the bus a real rtc sits behind, and an
+ * alarm fires when the wall time passes over it, as a match register would.
+ */
+struct VirtualRtcAlarm {
+    struct RtcTime time;
+    uint64_t ms;
+    uint8_t enable;
+    RtcAlarmCallback cb;
+};
+
+struct VirtualRtc {
+    struct RtcHost *host;
+    uint64_t baseMs;
+    uint64_t baseUs;
+    uint64_t checkedMs;
+    uint32_t freq;
+    uint32_t accessDelayUs;
+    uint8_t regs[VIRTUAL_RTC_USER_REG_NUM];
+    struct VirtualRtcAlarm alarms[VIRTUAL_RTC_ALARM_NUM];
+    struct OsalMutex lock;
+    struct OsalThread thread;
+    struct OsalSem exitSem;
+    volatile bool running;
+};
+
+static inline void VirtualRtcAccess(const struct VirtualRtc *virtual)
+{
+    if (virtual->accessDelayUs != 0) {
+        OsalUDelay(virtual->accessDelayUs);
+    }
+}
+
+/*
+ * The 64-bit values here only meet divisors below 2^16, so they are divided 16 bits at a time
+ * and a 32-bit kernel needs no 64-bit division helper.
+ */
+static uint64_t VirtualRtcDiv(uint64_t value, uint32_t divisor, uint32_t *rem)
+{
+    uint32_t i;
+    uint32_t part;
+    uint32_t left = 0;
+    uint64_t quot = 0;
+    uint32_t high = (uint32_t)(value >> 32); // 32: the high word
+    uint32_t low = (uint32_t)value;
+    uint32_t parts[] = {
+        high >> VIRTUAL_RTC_DIV_BITS, high & VIRTUAL_RTC_DIV_MASK,
+        low >> VIRTUAL_RTC_DIV_BITS, low & VIRTUAL_RTC_DIV_MASK,
+    };
+
+    for (i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        part = (left << VIRTUAL_RTC_DIV_BITS) | parts[i];
+        quot = (quot << VIRTUAL_RTC_DIV_BITS) | (part / divisor);
+        left = part % divisor;
+    }
+    if (rem != NULL) {
+        *rem = left;
+    }
+    return quot;
+}
+
+static inline uint64_t VirtualRtcWallMs(const struct VirtualRtc *virtual, uint64_t monoUs)
+{
+    return virtual->baseMs + VirtualRtcDiv(monoUs - virtual->baseUs, VIRTUAL_RTC_US_PER_MS, NULL);
+}
+
+static inline bool VirtualRtcTimeInRange(const struct RtcTime *time)
+{
+    return time->year <= VIRTUAL_RTC_YEAR_MAX;
+}
+
+static uint64_t VirtualRtcTimeToMs(const struct RtcTime *time)
+{
+    uint16_t year;
+    uint8_t month;
+    uint32_t seconds;
+    uint32_t days = time->day - RTC_UNIT_DIFF;
+
+    for (month = RTC_JANUARY; month < time->month; month++) {
+        days += RtcGetMonthDays(IS_LEAP_YEAR(time->year), month);
+    }
+    for (year = RTC_BEGIN_YEAR; year < time->year; year++) {
+        days += RTC_YEAR_DAYS(year);
+    }
+    seconds = days * VIRTUAL_RTC_DAY_SECONDS + time->hour * VIRTUAL_RTC_HOUR_SECONDS +
+        time->minute * VIRTUAL_RTC_MINUTE_SECONDS + time->second;
+    return (uint64_t)seconds * VIRTUAL_RTC_MS_PER_SECOND + time->millisecond;
+}
+
+static void VirtualRtcMsToTime(uint64_t ms, struct RtcTime *time)
+{
+    uint32_t msPart;
+    uint32_t seconds = (uint32_t)VirtualRtcDiv(ms, VIRTUAL_RTC_MS_PER_SECOND, &msPart);
+    uint32_t days = seconds / VIRTUAL_RTC_DAY_SECONDS;
+    uint32_t daySeconds = seconds % VIRTUAL_RTC_DAY_SECONDS;
+
+    time->year = RTC_BEGIN_YEAR;
+    while (days >= RTC_YEAR_DAYS(time->year)) {
+        days -= RTC_YEAR_DAYS(time->year);
+        time->year++;
+    }
+    time->month = RTC_JANUARY;
+    while (days >= RtcGetMonthDays(IS_LEAP_YEAR(time->year), time->month)) {
+        days -= RtcGetMonthDays(IS_LEAP_YEAR(time->year), time->month);
+        time->month++;
+    }
+    time->day = (uint8_t)(days + RTC_UNIT_DIFF);
+    time->hour = (uint8_t)(daySeconds / VIRTUAL_RTC_HOUR_SECONDS);
+    time->minute = (uint8_t)(daySeconds % VIRTUAL_RTC_HOUR_SECONDS / VIRTUAL_RTC_MINUTE_SECONDS);
+    time->second = (uint8_t)(daySeconds % VIRTUAL_RTC_MINUTE_SECONDS);
+    time->millisecond = (uint16_t)msPart;
+    time->weekday = RtcGetWeekDay(time);
+}
+
+static int32_t VirtualRtcReadTime(struct RtcHost *host, struct RtcTime *time)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    VirtualRtcAccess(virtual);
+    (void)OsalMutexLock(&virtual->lock);
+    VirtualRtcMsToTime(VirtualRtcWallMs(virtual, RtcHostMonoTimeUs()), time);
+    (void)OsalMutexUnlock(&virtual->lock);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcWriteTime(struct RtcHost *host, const struct RtcTime *time)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if (!VirtualRtcTimeInRange(time)) {
+        HDF_LOGE("%s: year %u out of range", __func__, time->year);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualRtcAccess(virtual);
+    (void)OsalMutexLock(&virtual->lock);
+    virtual->baseUs = RtcHostMonoTimeUs();
+    virtual->baseMs = VirtualRtcTimeToMs(time);
+    virtual->checkedMs = virtual->baseMs;
+    (void)OsalMutexUnlock(&virtual->lock);
+    return HDF_SUCCESS;
+}
+
+/* the counter and the timestamp are latched together, so the correlation is exact */
+static int32_t VirtualRtcReadTimeSync(struct RtcHost *host, struct RtcTimeSync *sync)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    VirtualRtcAccess(virtual);
+    (void)OsalMutexLock(&virtual->lock);
+    sync->monoUs = RtcHostMonoTimeUs();
+    VirtualRtcMsToTime(VirtualRtcWallMs(virtual, sync->monoUs), &sync->time);
+    (void)OsalMutexUnlock(&virtual->lock);
+    sync->errorUs = 0;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcReadAlarm(struct RtcHost *host, enum RtcAlarmIndex alarmIndex, struct RtcTime *time)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if ((uint32_t)alarmIndex >= VIRTUAL_RTC_ALARM_NUM) {
+        HDF_LOGE("%s: invalid alarm index:%d", __func__, alarmIndex);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualRtcAccess(virtual);
+    *time = virtual->alarms[alarmIndex].time;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcWriteAlarm(struct RtcHost *host, enum RtcAlarmIndex alarmIndex, const struct RtcTime *time)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if ((uint32_t)alarmIndex >= VIRTUAL_RTC_ALARM_NUM) {
+        HDF_LOGE("%s: invalid alarm index:%d", __func__, alarmIndex);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!VirtualRtcTimeInRange(time)) {
+        HDF_LOGE("%s: year %u out of range", __func__, time->year);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualRtcAccess(virtual);
+    (void)OsalMutexLock(&virtual->lock);
+    virtual->alarms[alarmIndex].time = *time;
+    virtual->alarms[alarmIndex].ms = VirtualRtcTimeToMs(time);
+    (void)OsalMutexUnlock(&virtual->lock);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcRegisterAlarmCallback(struct RtcHost *host, enum RtcAlarmIndex alarmIndex,
+    RtcAlarmCallback cb)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if ((uint32_t)alarmIndex >= VIRTUAL_RTC_ALARM_NUM) {
+        HDF_LOGE("%s: invalid alarm index:%d", __func__, alarmIndex);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    (void)OsalMutexLock(&virtual->lock);
+    virtual->alarms[alarmIndex].cb = cb;
+    (void)OsalMutexUnlock(&virtual->lock);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcAlarmInterruptEnable(struct RtcHost *host, enum RtcAlarmIndex alarmIndex, uint8_t enable)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if ((uint32_t)alarmIndex >= VIRTUAL_RTC_ALARM_NUM) {
+        HDF_LOGE("%s: invalid alarm index:%d", __func__, alarmIndex);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualRtcAccess(virtual);
+    virtual->alarms[alarmIndex].enable = enable;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcGetFreq(struct RtcHost *host, uint32_t *freq)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    VirtualRtcAccess(virtual);
+    *freq = virtual->freq;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcSetFreq(struct RtcHost *host, uint32_t freq)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if (freq < VIRTUAL_RTC_FREQ_MIN || freq > VIRTUAL_RTC_FREQ_MAX) {
+        HDF_LOGE("%s: invalid freq:%u", __func__, freq);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualRtcAccess(virtual);
+    virtual->freq = freq;
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcReset(struct RtcHost *host)
+{
+    uint32_t i;
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    VirtualRtcAccess(virtual);
+    (void)OsalMutexLock(&virtual->lock);
+    for (i = 0; i < VIRTUAL_RTC_USER_REG_NUM; i++) {
+        virtual->regs[i] = 0;
+    }
+    for (i = 0; i < VIRTUAL_RTC_ALARM_NUM; i++) {
+        virtual->alarms[i].enable = 0;
+    }
+    virtual->freq = VIRTUAL_RTC_FREQ_DEFAULT;
+    (void)OsalMutexUnlock(&virtual->lock);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcReadReg(struct RtcHost *host, uint8_t usrDefIndex, uint8_t *value)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if (usrDefIndex >= VIRTUAL_RTC_USER_REG_NUM) {
+        HDF_LOGE("%s: invalid index:%u", __func__, usrDefIndex);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualRtcAccess(virtual);
+    *value = virtual->regs[usrDefIndex];
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcWriteReg(struct RtcHost *host, uint8_t usrDefIndex, uint8_t value)
+{
+    struct VirtualRtc *virtual = (struct VirtualRtc *)host->data;
+
+    if (usrDefIndex >= VIRTUAL_RTC_USER_REG_NUM) {
+        HDF_LOGE("%s: invalid index:%u", __func__, usrDefIndex);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    VirtualRtcAccess(virtual);
+    virtual->regs[usrDefIndex] = value;
+    return HDF_SUCCESS;
+}
+
+static struct RtcMethod g_method = {
+    .ReadTime = VirtualRtcReadTime,
+    .WriteTime = VirtualRtcWriteTime,
+    .ReadAlarm = VirtualRtcReadAlarm,
+    .WriteAlarm = VirtualRtcWriteAlarm,
+    .RegisterAlarmCallback = VirtualRtcRegisterAlarmCallback,
+    .AlarmInterruptEnable = VirtualRtcAlarmInterruptEnable,
+    .GetFreq = VirtualRtcGetFreq,
+    .SetFreq = VirtualRtcSetFreq,
+    .Reset = VirtualRtcReset,
+    .ReadReg = VirtualRtcReadReg,
+    .WriteReg = VirtualRtcWriteReg,
+    .ReadTimeSync = VirtualRtcReadTimeSync,
+};
+
+/* plays the match interrupt: an enabled alarm fires once when the wall time of a tick passes over it */
+static int32_t VirtualRtcAlarmThread(void *data)
+{
+    uint32_t i;
+    uint64_t now;
+    RtcAlarmCallback fired[VIRTUAL_RTC_ALARM_NUM];
+    struct VirtualRtc *virtual = (struct VirtualRtc *)data;
+
+    while (virtual->running) {
+        OsalMSleep(VIRTUAL_RTC_TICK_MS);
+        (void)OsalMutexLock(&virtual->lock);
+        now = VirtualRtcWallMs(virtual, RtcHostMonoTimeUs());
+        for (i = 0; i < VIRTUAL_RTC_ALARM_NUM; i++) {
+            fired[i] = NULL;
+            if (virtual->alarms[i].enable != 0 && virtual->alarms[i].ms > virtual->checkedMs &&
+                virtual->alarms[i].ms <= now) {
+                fired[i] = virtual->alarms[i].cb;
+            }
+        }
+        virtual->checkedMs = now;
+        (void)OsalMutexUnlock(&virtual->lock);
+        for (i = 0; i < VIRTUAL_RTC_ALARM_NUM; i++) {
+            if (fired[i] != NULL) {
+                (void)fired[i]((enum RtcAlarmIndex)i);
+            }
+        }
+    }
+    (void)OsalSemPost(&virtual->exitSem);
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcStartThread(struct VirtualRtc *virtual)
+{
+    int32_t ret;
+    struct OsalThreadParam param;
+
+    virtual->running = true;
+    (void)OsalSemInit(&virtual->exitSem, 0);
+    ret = OsalThreadCreate(&virtual->thread, VirtualRtcAlarmThread, virtual);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalSemDestroy(&virtual->exitSem);
+        return ret;
+    }
+    param.name = "virtual_rtc_alarm";
+    param.priority = OSAL_THREAD_PRI_DEFAULT;
+    param.stackSize = VIRTUAL_RTC_THREAD_STACK;
+    ret = OsalThreadStart(&virtual->thread, &param);
+    if (ret != HDF_SUCCESS) {
+        (void)OsalThreadDestroy(&virtual->thread);
+        (void)OsalSemDestroy(&virtual->exitSem);
+    }
+    return ret;
+}
+
+static void VirtualRtcStopThread(struct VirtualRtc *virtual)
+{
+    virtual->running = false;
+    (void)OsalSemWait(&virtual->exitSem, HDF_WAIT_FOREVER);
+    (void)OsalThreadDestroy(&virtual->thread);
+    (void)OsalSemDestroy(&virtual->exitSem);
+}
+
+static void VirtualRtcReadDrs(struct VirtualRtc *virtual, const struct DeviceResourceNode *node)
+{
+    struct DeviceResourceIface *drsOps = NULL;
+
+    virtual->freq = VIRTUAL_RTC_FREQ_DEFAULT;
+    virtual->accessDelayUs = 0;
+    drsOps = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (node == NULL || drsOps == NULL || drsOps->GetUint32 == NULL) {
+        return;
+    }
+    (void)drsOps->GetUint32(node, "freq", &virtual->freq, VIRTUAL_RTC_FREQ_DEFAULT);
+    (void)drsOps->GetUint32(node, "accessDelayUs", &virtual->accessDelayUs, 0);
+}
+
+static int32_t VirtualRtcBind(struct HdfDeviceObject *device)
+{
+    struct RtcHost *host = NULL;
+
+    host = RtcHostCreate(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: create host fail!", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t VirtualRtcInit(struct HdfDeviceObject *device)
+{
+    int32_t ret;
+    struct RtcHost *host = NULL;
+    struct VirtualRtc *virtual = NULL;
+
+    host = RtcHostFromDevice(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    virtual = (struct VirtualRtc *)OsalMemCalloc(sizeof(*virtual));
+    if (virtual == NULL) {
+        HDF_LOGE("%s: malloc virtual fail!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    VirtualRtcReadDrs(virtual, device->property);
+    virtual->baseUs = RtcHostMonoTimeUs();
+    virtual->host = host;
+
+    ret = OsalMutexInit(&virtual->lock);
+    if (ret != HDF_SUCCESS) {
+        OsalMemFree(virtual);
+        return ret;
+    }
+    host->data = virtual;
+    host->method = &g_method;
+    ret = VirtualRtcStartThread(virtual);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start alarm thread fail! ret:%d", __func__, ret);
+        host->method = NULL;
+        host->data = NULL;
+        (void)OsalMutexDestroy(&virtual->lock);
+        OsalMemFree(virtual);
+        return ret;
+    }
+    HDF_LOGI("%s: freq:%u accessDelayUs:%u init done!", __func__, virtual->freq, virtual->accessDelayUs);
+    return HDF_SUCCESS;
+}
+
+static void VirtualRtcRelease(struct HdfDeviceObject *device)
+{
+    struct RtcHost *host = NULL;
+    struct VirtualRtc *virtual = NULL;
+
+    host = RtcHostFromDevice(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return;
+    }
+
+    virtual = (struct VirtualRtc *)host->data;
+    if (virtual != NULL) {
+        VirtualRtcStopThread(virtual);
+        (void)OsalMutexDestroy(&virtual->lock);
+        OsalMemFree(virtual);
+    }
+    RtcHostDestroy(host);
+}
+
+struct HdfDriverEntry g_virtualRtcDriverEntry = {
+    .moduleVersion = 1,
+    .Bind = VirtualRtcBind,
+    .Init = VirtualRtcInit,
+    .Release = VirtualRtcRelease,
+    .moduleName = "virtual_rtc_driver",
+};
+HDF_INIT(g_virtualRtcDriverEntry);
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HDF_WORK_POOL_H
+#define HDF_WORK_POOL_H
+
+#include "hdf_dlist.h"
+#include "hdf_workqueue.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+#include "osal_thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define HDF_WORK_POOL_WORKER_MAX 8
+#define HDF_WORK_POOL_NAME_LEN   32
+
+enum HdfWorkClass {
+    HDF_WORK_CLASS_REALTIME = 0,   /* served by highest priority workers, e.g. sensor sampling */
+    HDF_WORK_CLASS_BACKGROUND,     /* served by low priority workers, e.g. housekeeping */
+    HDF_WORK_CLASS_MAX,
+};
+
+struct HdfWorkPool;
+struct HdfWorkPoolClass;
+
+struct HdfPoolWork {
+    struct DListHead node;
+    struct DListHead poolNode;     /* on the works of the pool while bound to it */
+    HdfWorkFunc func;
+    void *arg;
+    enum HdfWorkClass workClass;
+    unsigned int status;
+    struct HdfWorkPool *pool;
+};
+
+struct HdfWorkClassConfig {
+    uint16_t workerNum;            /* 0 means works of this class fall back to the other class */
+    uint32_t cpuMask;              /* workers are pinned round-robin to the set bits, 0 means no pinning */
+};
+
+struct HdfWorkPoolConfig {
+    const char *name;
+    size_t stackSize;
+    struct HdfWorkClassConfig classes[HDF_WORK_CLASS_MAX];
+};
+
+struct HdfWorkPoolWorker {
+    struct OsalThread thread;
+    struct HdfWorkPoolClass *owner;
+    char name[HDF_WORK_POOL_NAME_LEN];
+};
+
+struct HdfWorkPoolClass {
+    struct DListHead head;
+    struct OsalSem sem;
+    struct HdfWorkPool *pool;
+    uint16_t workerNum;
+    struct HdfWorkPoolWorker workers[HDF_WORK_POOL_WORKER_MAX];
+};
+
+struct HdfWorkPool {
+    OsalSpinlock spin;
+    struct OsalSem exitSem;
+    bool running;
+    const char *name;
+    struct DListHead works;        /* every work bound to the pool, unbound again by cancel and destroy */
+    struct HdfWorkPoolClass classes[HDF_WORK_CLASS_MAX];
+};
+
+int32_t HdfWorkPoolInit(struct HdfWorkPool *pool, const struct HdfWorkPoolConfig *config);
+void HdfWorkPoolDestroy(struct HdfWorkPool *pool);
+int32_t HdfPoolWorkInit(struct HdfPoolWork *work, HdfWorkFunc func, void *arg, enum HdfWorkClass workClass);
+bool HdfWorkPoolAdd(struct HdfWorkPool *pool, struct HdfPoolWork *work);
+unsigned int HdfPoolWorkBusy(struct HdfPoolWork *work);
+/* unbinds the work from its pool, a work must be cancelled before it's freed */
+bool HdfPoolWorkCancelSync(struct HdfPoolWork *work);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HDF_WORK_POOL_H */
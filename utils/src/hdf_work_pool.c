@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_work_pool.h"
+#include "hdf_log.h"
+#include "osal_time.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG hdf_work_pool
+
+#define HDF_WORK_POOL_CANCEL_POLL_MS 1
+#define HDF_WORK_POOL_CPU_MAX        32
+
+static const OSAL_THREAD_PRIORITY g_workClassPriority[HDF_WORK_CLASS_MAX] = {
+    [HDF_WORK_CLASS_REALTIME] = OSAL_THREAD_PRI_HIGHEST,
+    [HDF_WORK_CLASS_BACKGROUND] = OSAL_THREAD_PRI_LOW,
+};
+
+static struct HdfPoolWork *HdfWorkPoolDequeue(struct HdfWorkPoolClass *workClass)
+{
+    struct HdfPoolWork *work = NULL;
+
+    if (!DListIsEmpty(&workClass->head)) {
+        work = DLIST_FIRST_ENTRY(&workClass->head, struct HdfPoolWork, node);
+        DListRemove(&work->node);
+    }
+
+    return work;
+}
+
+static void HdfWorkPoolRunOne(struct HdfWorkPool *pool, struct HdfPoolWork *work, uint32_t *flags)
+{
+    work->status = (work->status & ~HDF_WORK_BUSY_PENDING) | HDF_WORK_BUSY_RUNNING;
+    (void)OsalSpinUnlockIrqRestore(&pool->spin, flags);
+
+    work->func(work->arg);
+
+    (void)OsalSpinLockIrqSave(&pool->spin, flags);
+    work->status &= ~HDF_WORK_BUSY_RUNNING;
+    if ((work->status & HDF_WORK_BUSY_PENDING) != 0) {
+        /* re-added while running, queue it again instead of running it concurrently on another worker */
+        DListInsertTail(&work->node, &pool->classes[work->workClass].head);
+        (void)OsalSemPost(&pool->classes[work->workClass].sem);
+    }
+}
+
+static int32_t HdfWorkPoolWorkerEntry(void *data)
+{
+    struct HdfWorkPoolWorker *worker = (struct HdfWorkPoolWorker *)data;
+    struct HdfWorkPoolClass *workClass = worker->owner;
+    struct HdfWorkPool *pool = workClass->pool;
+    struct HdfPoolWork *work = NULL;
+    uint32_t flags = 0;
+
+    while (true) {
+        if (OsalSemWait(&workClass->sem, HDF_WAIT_FOREVER) != HDF_SUCCESS) {
+            /* a wait forever only fails on a broken sem, retrying would spin the cpu */
+            HDF_LOGE("%s: worker %s wait fail", __func__, worker->name);
+            break;
+        }
+        (void)OsalSpinLockIrqSave(&pool->spin, &flags);
+        if (!pool->running) {
+            (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+            break;
+        }
+        work = HdfWorkPoolDequeue(workClass);
+        if (work != NULL) {
+            HdfWorkPoolRunOne(pool, work, &flags);
+        }
+        (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+    }
+
+    HDF_LOGI("%s: worker %s exit", __func__, worker->name);
+    (void)OsalSemPost(&pool->exitSem);
+    return HDF_SUCCESS;
+}
+
+static int32_t HdfWorkPoolPickCpu(uint32_t cpuMask, uint16_t index)
+{
+    uint16_t setBits = 0;
+    uint16_t nth;
+    int32_t cpu;
+
+    for (cpu = 0; cpu < HDF_WORK_POOL_CPU_MAX; cpu++) {
+        if ((cpuMask & (1U << (uint32_t)cpu)) != 0) {
+            setBits++;
+        }
+    }
+    if (setBits == 0) {
+        return -1;
+    }
+
+    nth = index % setBits;
+    for (cpu = 0; cpu < HDF_WORK_POOL_CPU_MAX; cpu++) {
+        if ((cpuMask & (1U << (uint32_t)cpu)) == 0) {
+            continue;
+        }
+        if (nth == 0) {
+            return cpu;
+        }
+        nth--;
+    }
+    return -1;
+}
+
+static int32_t HdfWorkPoolStartWorker(struct HdfWorkPool *pool, struct HdfWorkPoolClass *workClass,
+    const struct HdfWorkPoolConfig *config, enum HdfWorkClass classId, uint16_t index)
+{
+    int32_t ret;
+    int32_t cpu;
+    struct OsalThreadParam param;
+    struct HdfWorkPoolWorker *worker = &workClass->workers[index];
+
+    worker->owner = workClass;
+    if (sprintf_s(worker->name, sizeof(worker->name), "%s_%s%u", pool->name,
+        (classId == HDF_WORK_CLASS_REALTIME) ? "rt" : "bg", index) < 0) {
+        HDF_LOGE("%s: format worker name fail", __func__);
+        return HDF_FAILURE;
+    }
+
+    ret = OsalThreadCreate(&worker->thread, HdfWorkPoolWorkerEntry, worker);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: create worker %s fail, ret: %d", __func__, worker->name, ret);
+        return ret;
+    }
+
+    (void)memset_s(&param, sizeof(param), 0, sizeof(param));
+    param.name = worker->name;
+    param.stackSize = config->stackSize;
+    param.priority = g_workClassPriority[classId];
+    ret = OsalThreadStart(&worker->thread, &param);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: start worker %s fail, ret: %d", __func__, worker->name, ret);
+        (void)OsalThreadDestroy(&worker->thread);
+        return ret;
+    }
+
+    cpu = HdfWorkPoolPickCpu(config->classes[classId].cpuMask, index);
+    if (cpu >= 0 && OsalThreadBind(&worker->thread, (unsigned int)cpu) != HDF_SUCCESS) {
+        /* affinity is a hint, an unpinned worker still serves the queue */
+        HDF_LOGW("%s: bind worker %s to cpu %d fail", __func__, worker->name, cpu);
+    }
+    return HDF_SUCCESS;
+}
+
+static void HdfWorkPoolStopWorkers(struct HdfWorkPool *pool)
+{
+    uint16_t total = 0;
+    uint16_t i;
+    int32_t classId;
+    uint32_t flags = 0;
+
+    (void)OsalSpinLockIrqSave(&pool->spin, &flags);
+    pool->running = false;
+    (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+
+    for (classId = 0; classId < HDF_WORK_CLASS_MAX; classId++) {
+        for (i = 0; i < pool->classes[classId].workerNum; i++) {
+            (void)OsalSemPost(&pool->classes[classId].sem);
+            total++;
+        }
+    }
+    for (i = 0; i < total; i++) {
+        (void)OsalSemWait(&pool->exitSem, HDF_WAIT_FOREVER);
+    }
+    for (classId = 0; classId < HDF_WORK_CLASS_MAX; classId++) {
+        for (i = 0; i < pool->classes[classId].workerNum; i++) {
+            (void)OsalThreadDestroy(&pool->classes[classId].workers[i].thread);
+        }
+        pool->classes[classId].workerNum = 0;
+    }
+}
+
+static void HdfWorkPoolUninitSync(struct HdfWorkPool *pool, int32_t classNum)
+{
+    int32_t classId;
+
+    for (classId = 0; classId < classNum; classId++) {
+        (void)OsalSemDestroy(&pool->classes[classId].sem);
+    }
+    (void)OsalSemDestroy(&pool->exitSem);
+    (void)OsalSpinDestroy(&pool->spin);
+}
+
+static int32_t HdfWorkPoolInitSync(struct HdfWorkPool *pool)
+{
+    int32_t classId;
+
+    if (OsalSpinInit(&pool->spin) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init spinlock fail", __func__);
+        return HDF_FAILURE;
+    }
+    if (OsalSemInit(&pool->exitSem, 0) != HDF_SUCCESS) {
+        HDF_LOGE("%s: init exit sem fail", __func__);
+        (void)OsalSpinDestroy(&pool->spin);
+        return HDF_FAILURE;
+    }
+    DListHeadInit(&pool->works);
+    for (classId = 0; classId < HDF_WORK_CLASS_MAX; classId++) {
+        DListHeadInit(&pool->classes[classId].head);
+        pool->classes[classId].pool = pool;
+        if (OsalSemInit(&pool->classes[classId].sem, 0) != HDF_SUCCESS) {
+            HDF_LOGE("%s: init class %d sem fail", __func__, classId);
+            HdfWorkPoolUninitSync(pool, classId);
+            return HDF_FAILURE;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t HdfWorkPoolInit(struct HdfWorkPool *pool, const struct HdfWorkPoolConfig *config)
+{
+    int32_t ret;
+    int32_t classId;
+    uint16_t i;
+
+    if (pool == NULL || config == NULL || config->name == NULL) {
+        HDF_LOGE("%s: invalid param", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (config->classes[HDF_WORK_CLASS_REALTIME].workerNum == 0 &&
+        config->classes[HDF_WORK_CLASS_BACKGROUND].workerNum == 0) {
+        HDF_LOGE("%s: pool %s has no worker", __func__, config->name);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    for (classId = 0; classId < HDF_WORK_CLASS_MAX; classId++) {
+        if (config->classes[classId].workerNum > HDF_WORK_POOL_WORKER_MAX) {
+            HDF_LOGE("%s: class %d worker num %u exceed max", __func__, classId, config->classes[classId].workerNum);
+            return HDF_ERR_INVALID_PARAM;
+        }
+    }
+
+    (void)memset_s(pool, sizeof(*pool), 0, sizeof(*pool));
+    pool->name = config->name;
+    ret = HdfWorkPoolInitSync(pool);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    pool->running = true;
+    for (classId = 0; classId < HDF_WORK_CLASS_MAX; classId++) {
+        for (i = 0; i < config->classes[classId].workerNum; i++) {
+            ret = HdfWorkPoolStartWorker(pool, &pool->classes[classId], config, (enum HdfWorkClass)classId, i);
+            if (ret != HDF_SUCCESS) {
+                HdfWorkPoolStopWorkers(pool);
+                HdfWorkPoolUninitSync(pool, HDF_WORK_CLASS_MAX);
+                return ret;
+            }
+            pool->classes[classId].workerNum++;
+        }
+    }
+
+    return HDF_SUCCESS;
+}
+
+void HdfWorkPoolDestroy(struct HdfWorkPool *pool)
+{
+    int32_t classId;
+    struct HdfPoolWork *work = NULL;
+    struct HdfPoolWork *tmp = NULL;
+
+    if (pool == NULL || !pool->running) {
+        return;
+    }
+
+    HdfWorkPoolStopWorkers(pool);
+    for (classId = 0; classId < HDF_WORK_CLASS_MAX; classId++) {
+        /* the pending works are all on the works list too, they are dropped with it */
+        DListHeadInit(&pool->classes[classId].head);
+    }
+    /* the owners of the works may outlive the pool, they must not reach it through the works any more */
+    DLIST_FOR_EACH_ENTRY_SAFE(work, tmp, &pool->works, struct HdfPoolWork, poolNode) {
+        DListRemove(&work->poolNode);
+        work->status = 0;
+        work->pool = NULL;
+    }
+    HdfWorkPoolUninitSync(pool, HDF_WORK_CLASS_MAX);
+}
+
+int32_t HdfPoolWorkInit(struct HdfPoolWork *work, HdfWorkFunc func, void *arg, enum HdfWorkClass workClass)
+{
+    if (work == NULL || func == NULL || workClass >= HDF_WORK_CLASS_MAX) {
+        HDF_LOGE("%s: invalid param", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    DListHeadInit(&work->node);
+    DListHeadInit(&work->poolNode);
+    work->func = func;
+    work->arg = arg;
+    work->workClass = workClass;
+    work->status = 0;
+    work->pool = NULL;
+    return HDF_SUCCESS;
+}
+
+bool HdfWorkPoolAdd(struct HdfWorkPool *pool, struct HdfPoolWork *work)
+{
+    enum HdfWorkClass classId;
+    uint32_t flags = 0;
+
+    if (pool == NULL || work == NULL || work->func == NULL) {
+        HDF_LOGE("%s: invalid param", __func__);
+        return false;
+    }
+
+    (void)OsalSpinLockIrqSave(&pool->spin, &flags);
+    if (!pool->running || (work->pool != NULL && work->pool != pool) ||
+        (work->status & HDF_WORK_BUSY_PENDING) != 0) {
+        (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+        return false;
+    }
+
+    classId = work->workClass;
+    if (pool->classes[classId].workerNum == 0) {
+        classId = (classId == HDF_WORK_CLASS_REALTIME) ? HDF_WORK_CLASS_BACKGROUND : HDF_WORK_CLASS_REALTIME;
+        work->workClass = classId;
+    }
+    if (work->pool == NULL) {
+        DListInsertTail(&work->poolNode, &pool->works);
+        work->pool = pool;
+    }
+    work->status |= HDF_WORK_BUSY_PENDING;
+    if ((work->status & HDF_WORK_BUSY_RUNNING) == 0) {
+        DListInsertTail(&work->node, &pool->classes[classId].head);
+        (void)OsalSemPost(&pool->classes[classId].sem);
+    }
+    (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+    return true;
+}
+
+unsigned int HdfPoolWorkBusy(struct HdfPoolWork *work)
+{
+    unsigned int status;
+    uint32_t flags = 0;
+    struct HdfWorkPool *pool = NULL;
+
+    if (work == NULL || work->pool == NULL) {
+        return 0;
+    }
+
+    pool = work->pool;
+    (void)OsalSpinLockIrqSave(&pool->spin, &flags);
+    status = work->status;
+    (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+    return status;
+}
+
+bool HdfPoolWorkCancelSync(struct HdfPoolWork *work)
+{
+    bool pending = false;
+    uint32_t flags = 0;
+    struct HdfWorkPool *pool = NULL;
+
+    if (work == NULL || work->pool == NULL) {
+        return false;
+    }
+
+    pool = work->pool;
+    (void)OsalSpinLockIrqSave(&pool->spin, &flags);
+    if ((work->status & HDF_WORK_BUSY_PENDING) != 0) {
+        pending = true;
+        work->status &= ~HDF_WORK_BUSY_PENDING;
+        if ((work->status & HDF_WORK_BUSY_RUNNING) == 0) {
+            DListRemove(&work->node);
+        }
+    }
+    while ((work->status & HDF_WORK_BUSY_RUNNING) != 0) {
+        (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+        OsalMSleep(HDF_WORK_POOL_CANCEL_POLL_MS);
+        (void)OsalSpinLockIrqSave(&pool->spin, &flags);
+    }
+    if (work->status == 0) {
+        DListRemove(&work->poolNode);
+        work->pool = NULL;
+    }
+    (void)OsalSpinUnlockIrqRestore(&pool->spin, &flags);
+    return pending;
+}